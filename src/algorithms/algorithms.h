@@ -12,4 +12,5 @@
 #include "./detect_cycle.h"
 #include "./longest_path.h"
 #include "./all_neighbors.h"
+#include "./reachable_nodes.h"
 
@@ -0,0 +1,148 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "reachable_nodes.h"
+#include "LAGraph_bfs_pushpull.h"
+#include "../util/rmalloc.h"
+
+// determine if src is on a cycle of at most ctx->maxLen hops
+// that is, if one of src's in-neighbors is reachable
+// within ctx->maxLen - 1 hops
+static bool _ReachableNodesCtx_SourceOnCycle
+(
+	ReachableNodesCtx *ctx
+) {
+	GrB_Info    info;
+	GrB_Index   nrows;
+	GrB_Vector  in_neighbors;
+
+	GrB_Matrix_nrows(&nrows, ctx->M);
+	info = GrB_Vector_new(&in_neighbors, GrB_BOOL, nrows);
+	UNUSED(info);
+	ASSERT(info == GrB_SUCCESS);
+
+	// in_neighbors<V> = M(:, src), reachable in-neighbors of src
+	info = GrB_Col_extract(in_neighbors, ctx->V, NULL, ctx->M, GrB_ALL, nrows,
+			ctx->src, GrB_DESC_S);
+	ASSERT(info == GrB_SUCCESS);
+
+	bool        depleted  =  false;
+	bool        on_cycle  =  false;
+	GrB_Index   id;
+	GxB_MatrixTupleIter *it;
+
+	GxB_Vector_Option_set(in_neighbors, GxB_SPARSITY_CONTROL, GxB_SPARSE);
+	GxB_MatrixTupleIter_new(&it, (GrB_Matrix)in_neighbors);
+	GxB_MatrixTupleIter_next(it, NULL, &id, NULL, &depleted);
+
+	while(!depleted) {
+		// BFS levels are 1-based, level L is reached by L - 1 hops
+		uint64_t level;
+		GrB_Vector_extractElement_UINT64(&level, ctx->V, id);
+		if(level <= ctx->maxLen) {
+			on_cycle = true;
+			break;
+		}
+		GxB_MatrixTupleIter_next(it, NULL, &id, NULL, &depleted);
+	}
+
+	GxB_MatrixTupleIter_free(it);
+	GrB_Vector_free(&in_neighbors);
+
+	return on_cycle;
+}
+
+static void _ReachableNodesCtx_Traverse
+(
+	ReachableNodesCtx *ctx
+) {
+	// LAGraph's max_level counts nodes rather than edges
+	int64_t max_level = (int64_t)ctx->maxLen + 1;
+	GrB_Info info = LAGraph_bfs_pushpull(&ctx->V, NULL, ctx->M, ctx->MT,
+			ctx->src, NULL, max_level, true);
+	UNUSED(info);
+	ASSERT(info == GrB_SUCCESS);
+
+	// src is at level 1, it is reachable if either no hops are required
+	// or if it closes a cycle
+	ctx->emit_src = (ctx->minLen == 0 || (ctx->maxLen > 0 &&
+				_ReachableNodesCtx_SourceOnCycle(ctx)));
+
+	// matrix iterator requires vector format to be sparse
+	GxB_Vector_Option_set(ctx->V, GxB_SPARSITY_CONTROL, GxB_SPARSE);
+	if(ctx->iter == NULL) GxB_MatrixTupleIter_new(&ctx->iter, (GrB_Matrix)ctx->V);
+	else GxB_MatrixTupleIter_reuse(ctx->iter, (GrB_Matrix)ctx->V);
+}
+
+ReachableNodesCtx *ReachableNodesCtx_New
+(
+	EntityID src,   // source node from which to traverse
+	GrB_Matrix M,   // matrix describing connections
+	GrB_Matrix MT,  // transpose of M, optional
+	uint minLen,    // minimum traversal depth, at most 1
+	uint maxLen     // maximum traversal depth
+) {
+	ReachableNodesCtx *ctx = rm_calloc(1, sizeof(ReachableNodesCtx));
+	ReachableNodesCtx_Reset(ctx, src, M, MT, minLen, maxLen);
+	return ctx;
+}
+
+void ReachableNodesCtx_Reset
+(
+	ReachableNodesCtx *ctx,  // reachable nodes context to reset
+	EntityID src,            // source node from which to traverse
+	GrB_Matrix M,            // matrix describing connections
+	GrB_Matrix MT,           // transpose of M, optional
+	uint minLen,             // minimum traversal depth, at most 1
+	uint maxLen              // maximum traversal depth
+) {
+	ASSERT(M      != NULL);
+	ASSERT(ctx    != NULL);
+	ASSERT(src    != INVALID_ENTITY_ID);
+	ASSERT(minLen <= 1);
+
+	ctx->M       =  M;
+	ctx->MT      =  MT;
+	ctx->src     =  src;
+	ctx->minLen  =  minLen;
+	ctx->maxLen  =  maxLen;
+
+	if(ctx->V != GrB_NULL) GrB_Vector_free(&ctx->V);
+
+	_ReachableNodesCtx_Traverse(ctx);
+}
+
+EntityID ReachableNodesCtx_NextNode
+(
+	ReachableNodesCtx *ctx
+) {
+	if(!ctx) return INVALID_ENTITY_ID;
+
+	bool       depleted;
+	GrB_Index  id;
+
+	while(true) {
+		GxB_MatrixTupleIter_next(ctx->iter, NULL, &id, NULL, &depleted);
+		if(depleted) return INVALID_ENTITY_ID;
+
+		// src is produced only if required
+		if(id != ctx->src || ctx->emit_src) return id;
+	}
+}
+
+void ReachableNodesCtx_Free
+(
+	ReachableNodesCtx *ctx
+) {
+	if(!ctx) return;
+
+	if(ctx->iter) GxB_MatrixTupleIter_free(ctx->iter);
+	if(ctx->V != GrB_NULL) GrB_Vector_free(&ctx->V);
+
+	rm_free(ctx);
+}
+
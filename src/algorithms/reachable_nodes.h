@@ -0,0 +1,62 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+#include "../graph/entities/node.h"
+
+// computes the set of nodes reachable from 'src' within 'maxLen' hops
+// using a push-pull BFS, expanding an entire frontier with a single masked
+// matrix-vector multiplication per level
+//
+// unlike AllNeighborsCtx, each reachable node is produced exactly once
+// regardless of the number of paths leading to it
+// the reachable set is identical to the one produced by AllNeighborsCtx
+// as long as 'minLen' is at most 1, nodes reachable by a longer walk
+// may not be reachable by a longer path
+
+typedef struct {
+	EntityID src;                // traverse begin here
+	GrB_Matrix M;                // adjacency matrix
+	GrB_Matrix MT;               // transpose of M, optional, enables pull steps
+	uint minLen;                 // minimum required depth, at most 1
+	uint maxLen;                 // maximum allowed depth
+	bool emit_src;               // src should be produced
+	GrB_Vector V;                // BFS level of each reachable node
+	GxB_MatrixTupleIter *iter;   // iterator over V
+} ReachableNodesCtx;
+
+ReachableNodesCtx *ReachableNodesCtx_New
+(
+	EntityID src,   // source node from which to traverse
+	GrB_Matrix M,   // matrix describing connections
+	GrB_Matrix MT,  // transpose of M, optional
+	uint minLen,    // minimum traversal depth, at most 1
+	uint maxLen     // maximum traversal depth
+);
+
+void ReachableNodesCtx_Reset
+(
+	ReachableNodesCtx *ctx,  // reachable nodes context to reset
+	EntityID src,            // source node from which to traverse
+	GrB_Matrix M,            // matrix describing connections
+	GrB_Matrix MT,           // transpose of M, optional
+	uint minLen,             // minimum traversal depth, at most 1
+	uint maxLen              // maximum traversal depth
+);
+
+// produce next reachable destination node
+EntityID ReachableNodesCtx_NextNode
+(
+	ReachableNodesCtx *ctx
+);
+
+void ReachableNodesCtx_Free
+(
+	ReachableNodesCtx *ctx
+);
+
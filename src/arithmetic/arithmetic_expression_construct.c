@@ -60,12 +60,42 @@ static AR_ExpNode *AR_EXP_NewOpNodeFromAST(AST_Operator op, uint child_count) {
 	return AR_EXP_NewOpNode(func_name, child_count);
 }
 
+// size((n)-[:R1|R2]->()) is the number of edges connected to 'n'
+// reduce it to a degree lookup: outdegree(n, 'R1', 'R2')
+static AR_ExpNode *_AR_EXP_FromDegreePattern(const cypher_astnode_t *path,
+		const char *alias, bool outgoing) {
+	const cypher_astnode_t *edge = cypher_ast_pattern_path_get_element(path, 1);
+	uint reltype_count = cypher_ast_rel_pattern_nreltypes(edge);
+
+	AR_ExpNode *op = AR_EXP_NewOpNode(outgoing ? "outdegree" : "indegree",
+			1 + reltype_count);
+	op->op.children[0] = AR_EXP_NewVariableOperandNode(alias);
+	for(uint i = 0; i < reltype_count; i++) {
+		const cypher_astnode_t *reltype = cypher_ast_rel_pattern_get_reltype(edge, i);
+		const char *name = cypher_ast_reltype_get_name(reltype);
+		op->op.children[1 + i] = AR_EXP_NewConstOperandNode(SI_ConstStringVal((char *)name));
+	}
+
+	return op;
+}
+
 static AR_ExpNode *_AR_EXP_FromApplyExpression(const cypher_astnode_t *expr) {
 	AR_ExpNode *op;
 	bool distinct = cypher_ast_apply_operator_get_distinct(expr);
 	unsigned int arg_count = cypher_ast_apply_operator_narguments(expr);
 	const cypher_astnode_t *func_node = cypher_ast_apply_operator_get_func_name(expr);
 	const char *func_name = cypher_ast_function_name_get_value(func_node);
+
+	// size() of a degree pattern, avoid materializing the pattern
+	if(arg_count == 1 && strcasecmp(func_name, "size") == 0) {
+		bool outgoing;
+		const char *alias;
+		const cypher_astnode_t *arg = cypher_ast_apply_operator_get_argument(expr, 0);
+		if(AST_PathIsDegreePattern(arg, &alias, &outgoing)) {
+			return _AR_EXP_FromDegreePattern(arg, alias, outgoing);
+		}
+	}
+
 	bool aggregate = AR_FuncIsAggregate(func_name);
 	op = AR_EXP_NewOpNode(func_name, arg_count);
 
@@ -90,9 +90,11 @@ SIValue AR_EXISTS(SIValue *argv, int argc) {
 SIValue _AR_NodeDegree(SIValue *argv, int argc, GRAPH_EDGE_DIR dir) {
 	if(SI_TYPE(argv[0]) == T_NULL) return SI_NullVal();
 	Node *n = (Node *)argv[0].ptrval;
-	Edge *edges = array_new(Edge, 0);
+	NodeID id = ENTITY_GET_ID(n);
 	GraphContext *gc = QueryCtx_GetGraphCtx();
+	uint64_t degree = 0;
 
+	// degrees are maintained by the graph, no need to collect edges
 	if(argc > 1) {
 		// We're interested in specific relationship type(s).
 		for(int i = 1; i < argc; i++) {
@@ -102,17 +104,15 @@ SIValue _AR_NodeDegree(SIValue *argv, int argc, GRAPH_EDGE_DIR dir) {
 			Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_EDGE);
 			if(!s) continue;
 
-			// Accumulate edges.
-			Graph_GetNodeEdges(gc->g, n, dir, s->id, &edges);
+			// Accumulate degree.
+			degree += Graph_GetNodeDegree(gc->g, id, dir, s->id);
 		}
 	} else {
 		// Get all relations, regardless of their type.
-		Graph_GetNodeEdges(gc->g, n, dir, GRAPH_NO_RELATION, &edges);
+		degree = Graph_GetNodeDegree(gc->g, id, dir, GRAPH_NO_RELATION);
 	}
 
-	SIValue res = SI_LongVal(array_len(edges));
-	array_free(edges);
-	return res;
+	return SI_LongVal(degree);
 }
 
 /* Returns the number of incoming edges for given node. */
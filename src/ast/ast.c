@@ -8,6 +8,7 @@
 #include <pthread.h>
 
 #include "../RG.h"
+#include "xxhash.h"
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/qsort.h"
@@ -145,6 +146,51 @@ bool AST_TreeContainsType(const cypher_astnode_t *root, cypher_astnode_type_t se
 	return false;
 }
 
+// Node pattern without an alias, labels or properties, e.g. ()
+static inline bool _AST_NodePatternIsAnonymous(const cypher_astnode_t *node) {
+	return (cypher_ast_node_pattern_get_identifier(node) == NULL &&
+			cypher_ast_node_pattern_nlabels(node) == 0 &&
+			cypher_ast_node_pattern_get_properties(node) == NULL);
+}
+
+bool AST_PathIsDegreePattern(const cypher_astnode_t *path, const char **alias,
+							 bool *outgoing) {
+	if(cypher_astnode_type(path) != CYPHER_AST_PATTERN_PATH) return false;
+	if(cypher_ast_pattern_path_nelements(path) != 3) return false;
+
+	const cypher_astnode_t *src = cypher_ast_pattern_path_get_element(path, 0);
+	const cypher_astnode_t *edge = cypher_ast_pattern_path_get_element(path, 1);
+	const cypher_astnode_t *dest = cypher_ast_pattern_path_get_element(path, 2);
+
+	// edge must be an anonymous, unfiltered, single hop, directed edge
+	if(cypher_ast_rel_pattern_get_identifier(edge) != NULL ||
+	   cypher_ast_rel_pattern_get_properties(edge) != NULL ||
+	   cypher_ast_rel_pattern_get_varlength(edge) != NULL) return false;
+
+	enum cypher_rel_direction dir = cypher_ast_rel_pattern_get_direction(edge);
+	if(dir == CYPHER_REL_BIDIRECTIONAL) return false;
+
+	// one end is the named node, the other is anonymous
+	const cypher_astnode_t *named;
+	if(_AST_NodePatternIsAnonymous(dest)) {
+		named = src;
+		*outgoing = (dir == CYPHER_REL_OUTBOUND);
+	} else if(_AST_NodePatternIsAnonymous(src)) {
+		named = dest;
+		*outgoing = (dir == CYPHER_REL_INBOUND);
+	} else {
+		return false;
+	}
+
+	const cypher_astnode_t *identifier = cypher_ast_node_pattern_get_identifier(named);
+	if(identifier == NULL ||
+	   cypher_ast_node_pattern_nlabels(named) != 0 ||
+	   cypher_ast_node_pattern_get_properties(named) != NULL) return false;
+
+	*alias = cypher_ast_identifier_get_name(identifier);
+	return true;
+}
+
 // Recursively collect the names of all function calls beneath a node
 void AST_ReferredFunctions(const cypher_astnode_t *root, rax *referred_funcs) {
 	cypher_astnode_type_t root_type = cypher_astnode_type(root);
@@ -558,3 +604,41 @@ void parse_result_free(cypher_parse_result_t *parse_result) {
 	if(parse_result) cypher_parse_result_free(parse_result);
 }
 
+static void _AST_FingerprintNode(const cypher_astnode_t *node,
+		XXH64_state_t *state) {
+	cypher_astnode_type_t type = cypher_astnode_type(node);
+	XXH64_update(state, &type, sizeof(type));
+
+	// node details, e.g. identifier names, literal values and operators
+	char buf[256];
+	size_t len = cypher_astnode_detailstr(node, buf, sizeof(buf));
+	if(len < sizeof(buf)) {
+		XXH64_update(state, buf, len);
+	} else {
+		char *details = rm_malloc(len + 1);
+		cypher_astnode_detailstr(node, details, len + 1);
+		XXH64_update(state, details, len);
+		rm_free(details);
+	}
+
+	uint child_count = cypher_astnode_nchildren(node);
+	XXH64_update(state, &child_count, sizeof(child_count));
+	for(uint i = 0; i < child_count; i++) {
+		_AST_FingerprintNode(cypher_astnode_get_child(node, i), state);
+	}
+}
+
+uint64_t AST_Fingerprint(const cypher_parse_result_t *parse_result) {
+	ASSERT(parse_result != NULL);
+
+	XXH64_state_t state;
+	XXH_errorcode res = XXH64_reset(&state, 0);
+	UNUSED(res);
+	ASSERT(res != XXH_ERROR);
+
+	const cypher_astnode_t *statement = _AST_parse_result_root(parse_result);
+	_AST_FingerprintNode(statement, &state);
+
+	return XXH64_digest(&state);
+}
+
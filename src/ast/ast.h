@@ -49,6 +49,13 @@ bool AST_ContainsClause(const AST *ast, cypher_astnode_type_t clause);
 // Checks to see if an AST tree contains specified node type.
 bool AST_TreeContainsType(const cypher_astnode_t *root, cypher_astnode_type_t clause);
 
+// Checks if path is a single hop, directed pattern between a named node
+// and an anonymous node, e.g. (n)-[:R]->(), neither filtered by labels or
+// properties, the number of matches of such pattern is the named node degree
+// 'alias' is set to the named node and 'outgoing' is set if edges leave it.
+bool AST_PathIsDegreePattern(const cypher_astnode_t *path, const char **alias,
+							 bool *outgoing);
+
 // Returns all function (aggregated & none aggregated) mentioned in query.
 void AST_ReferredFunctions(const cypher_astnode_t *root, rax *referred_funcs);
 
@@ -131,6 +138,10 @@ cypher_parse_result_t *parse_params(const char *query, const char **query_body);
 // Free the immutable AST generated by the parser.
 void parse_result_free(cypher_parse_result_t *parse_result);
 
+// Hash a parsed query, queries which differ only in
+// whitespace and comments share the same fingerprint.
+uint64_t AST_Fingerprint(const cypher_parse_result_t *parse_result);
+
 // Returns the ast annotation context collection of the AST.
 AST_AnnotationCtxCollection *AST_GetAnnotationCtxCollection(AST *ast);
 
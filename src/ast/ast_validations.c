@@ -315,8 +315,23 @@ cleanup:
 	return res;
 }
 
+/* Checks if 'apply' is a call to size() over a path which is resolved by
+ * a node degree lookup, e.g. size((n)-[:R]->()) */
+static bool _Validate_DegreePattern(const cypher_astnode_t *apply,
+									const cypher_astnode_t *path) {
+	const cypher_astnode_t *func_node = cypher_ast_apply_operator_get_func_name(apply);
+	const char *func_name = cypher_ast_function_name_get_value(func_node);
+	if(strcasecmp(func_name, "size") != 0) return false;
+	if(cypher_ast_apply_operator_narguments(apply) != 1) return false;
+
+	bool outgoing;
+	const char *alias;
+	return AST_PathIsDegreePattern(path, &alias, &outgoing);
+}
+
 /* While Cypher allows paths to appear in a number of places, RedisGraph
- * only supports them in the appropriate clauses and in path filters. */
+ * only supports them in the appropriate clauses, in path filters
+ * and as the argument of size() when they count a node's edges. */
 static AST_Validation _Validate_Path_Locations(const cypher_astnode_t *root) {
 	uint nchildren = cypher_astnode_nchildren(root);
 	const cypher_astnode_type_t root_type = cypher_astnode_type(root);
@@ -331,7 +346,9 @@ static AST_Validation _Validate_Path_Locations(const cypher_astnode_t *root) {
 			   root_type != CYPHER_AST_WITH &&
 			   root_type != CYPHER_AST_NAMED_PATH &&
 			   root_type != CYPHER_AST_UNARY_OPERATOR &&
-			   root_type != CYPHER_AST_BINARY_OPERATOR) {
+			   root_type != CYPHER_AST_BINARY_OPERATOR &&
+			   !(root_type == CYPHER_AST_APPLY_OPERATOR &&
+				 _Validate_DegreePattern(root, child))) {
 				ErrorCtx_SetError("Encountered path traversal in unsupported location '%s'",
 								  cypher_astnode_typestr(child_type));
 				return AST_INVALID;
@@ -10,6 +10,7 @@
 #include "../util/rmalloc.h"
 #include "../schema/schema.h"
 #include "../datatypes/array.h"
+#include "../serializers/entity_staging.h"
 
 // The first byte of each property in the binary stream
 // is used to indicate the type of the subsequent SIValue
@@ -22,6 +23,25 @@ typedef enum {
 	BI_ARRAY = 5,
 } TYPE;
 
+// entities created by a bulk insert batch
+// label and relation matrices are updated once every stream is processed
+// entity properties are attached concurrently on the task pool
+typedef struct {
+	NodeID **labeled;           // per label, IDs of created nodes
+	EdgeTriplet **connections;  // per relation, created edges
+	EntityStaging *staging;     // properties of created entities
+} BulkBatch;
+
+// returns the array held by 'arrays' at position 'idx', extending 'arrays'
+// with empty arrays as needed
+#define BULK_BATCH_SLOT(arrays, T, idx)                    \
+	({                                                     \
+		while(array_len(arrays) <= (uint)(idx)) {          \
+			array_append(arrays, array_new(T, 0));         \
+		}                                                  \
+		&(arrays)[idx];                                    \
+	})
+
 // read the header of a data stream to parse its property keys
 // and update schemas
 static Attribute_ID *_BulkInsert_ReadHeader(GraphContext *gc, SchemaType t,
@@ -138,8 +158,8 @@ static SIValue _BulkInsert_ReadProperty(const char *data, size_t *data_idx) {
 	return v;
 }
 
-static int _BulkInsert_ProcessFile(GraphContext *gc, const char *data,
-								   size_t data_len, SchemaType type) {
+static int _BulkInsert_ProcessFile(GraphContext *gc, BulkBatch *batch,
+		const char *data, size_t data_len, SchemaType type) {
 
 	int label_id;
 	uint prop_count;
@@ -150,12 +170,22 @@ static int _BulkInsert_ProcessFile(GraphContext *gc, const char *data,
 	Attribute_ID *prop_indices = _BulkInsert_ReadHeader(gc, type, data,
 			&data_idx, &label_id, &prop_count);
 
+	NodeID **labeled = NULL;
+	EdgeTriplet **connections = NULL;
+	if(type == SCHEMA_NODE) {
+		labeled = BULK_BATCH_SLOT(batch->labeled, NodeID, label_id);
+	} else {
+		connections = BULK_BATCH_SLOT(batch->connections, EdgeTriplet, label_id);
+	}
+
 	while(data_idx < data_len) {
 		Node n;
 		Edge e;
 		GraphEntity *ge;
 		if(type == SCHEMA_NODE) {
-			Graph_CreateNode(gc->g, label_id, &n);
+			// label matrix is updated once all streams are processed
+			Graph_CreateNodeEntity(gc->g, label_id, &n);
+			array_append(*labeled, ENTITY_GET_ID(&n));
 			ge = (GraphEntity *)&n;
 		} else if(type == SCHEMA_EDGE) {
 			// next 8 bytes are source ID
@@ -165,18 +195,25 @@ static int _BulkInsert_ProcessFile(GraphContext *gc, const char *data,
 			NodeID dest = *(NodeID *)&data[data_idx];
 			data_idx += sizeof(NodeID);
 
-			Graph_ConnectNodes(gc->g, src, dest, label_id, &e);
+			// connection is formed once all streams are processed
+			Graph_CreateEdgeEntity(gc->g, src, dest, label_id, &e);
+			EdgeTriplet t = {.src = src, .dest = dest, .id = ENTITY_GET_ID(&e)};
+			array_append(*connections, t);
 			ge = (GraphEntity *)&e;
 		} else {
 			ASSERT(false);
 		}
 
+		// nodes sharing a label share property columns
+		EntityStaging_AddEntity(batch->staging, ge,
+				(type == SCHEMA_NODE) ? label_id : 0);
+
 		// process entity attributes
 		for(uint i = 0; i < prop_count; i++) {
 			SIValue value = _BulkInsert_ReadProperty(data, &data_idx);
 			// skip invalid attribute values
 			if(!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE)) continue;
-			GraphEntity_AddProperty(ge, prop_indices[i], value);
+			EntityStaging_AddProperty(batch->staging, prop_indices[i], value);
 		}
 	}
 
@@ -184,13 +221,13 @@ static int _BulkInsert_ProcessFile(GraphContext *gc, const char *data,
 	return BULK_OK;
 }
 
-static int _BulkInsert_ProcessTokens(GraphContext *gc, int token_count,
-		RedisModuleString **argv, SchemaType type) {
+static int _BulkInsert_ProcessTokens(GraphContext *gc, BulkBatch *batch,
+		int token_count, RedisModuleString **argv, SchemaType type) {
 	for(int i = 0; i < token_count; i ++) {
 		size_t len;
 		// retrieve a pointer to the next binary stream and record its length
 		const char *data = RedisModule_StringPtrLen(argv[i], &len);
-		int rc = _BulkInsert_ProcessFile(gc, data, len, type);
+		int rc = _BulkInsert_ProcessFile(gc, batch, data, len, type);
 		UNUSED(rc);
 		ASSERT(rc == BULK_OK);
 	}
@@ -198,6 +235,31 @@ static int _BulkInsert_ProcessTokens(GraphContext *gc, int token_count,
 	return BULK_OK;
 }
 
+// attach staged properties, then update label and relation matrices
+// each matrix is built from the batch tuples in a single pass
+static void _BulkInsert_Commit(Graph *g, BulkBatch *batch) {
+	EntityStaging_Flush(batch->staging);
+
+	uint label_count = array_len(batch->labeled);
+	for(uint i = 0; i < label_count; i++) {
+		NodeID *ids = batch->labeled[i];
+		Graph_LabelNodes(g, i, ids, array_len(ids));
+	}
+
+	uint relation_count = array_len(batch->connections);
+	for(uint i = 0; i < relation_count; i++) {
+		EdgeTriplet *edges = batch->connections[i];
+		Graph_ConnectEdges(g, i, edges, array_len(edges));
+	}
+}
+
+static void _BulkBatch_Free(BulkBatch *batch) {
+	// staged properties refer to the streams, release them first
+	EntityStaging_Free(batch->staging);
+	array_free_ex(batch->labeled, array_free(*(NodeID **)ptr));
+	array_free_ex(batch->connections, array_free(*(EdgeTriplet **)ptr));
+}
+
 int BulkInsert(RedisModuleCtx *ctx, GraphContext *gc, RedisModuleString **argv,
 			   int argc, uint node_count, uint edge_count) {
 
@@ -213,6 +275,11 @@ int BulkInsert(RedisModuleCtx *ctx, GraphContext *gc, RedisModuleString **argv,
 
 	Graph *g = gc->g;
 	int res = BULK_OK;
+	BulkBatch batch = {
+		.labeled      =  array_new(NodeID *, 0),
+		.connections  =  array_new(EdgeTriplet *, 0),
+		.staging      =  EntityStaging_New(node_count + edge_count),
+	};
 
 	// lock graph under write lock
 	// allocate space for new nodes and edges
@@ -246,7 +313,7 @@ int BulkInsert(RedisModuleCtx *ctx, GraphContext *gc, RedisModuleString **argv,
 	if(node_token_count > 0) {
 		ASSERT(argc >= node_token_count);
 		// process all node files
-		if(_BulkInsert_ProcessTokens(gc, node_token_count, argv,
+		if(_BulkInsert_ProcessTokens(gc, &batch, node_token_count, argv,
 					SCHEMA_NODE) != BULK_OK) {
 			res = BULK_FAIL;
 			goto cleanup;
@@ -258,7 +325,7 @@ int BulkInsert(RedisModuleCtx *ctx, GraphContext *gc, RedisModuleString **argv,
 	if(relation_token_count > 0) {
 		ASSERT(argc >= relation_token_count);
 		// Process all relationship files
-		if(_BulkInsert_ProcessTokens(gc, relation_token_count, argv,
+		if(_BulkInsert_ProcessTokens(gc, &batch, relation_token_count, argv,
 					SCHEMA_EDGE) != BULK_OK) {
 			res = BULK_FAIL;
 			goto cleanup;
@@ -269,9 +336,14 @@ int BulkInsert(RedisModuleCtx *ctx, GraphContext *gc, RedisModuleString **argv,
 
 	ASSERT(argc == 0);
 
+	_BulkInsert_Commit(g, &batch);
+
 cleanup:
+	_BulkBatch_Free(&batch);
 	// reset graph sync policy
 	Graph_SetMatrixPolicy(g, SYNC_AND_MINIMIZE_SPACE);
+	// fold pending changes before readers regain access to the graph
+	Graph_ApplyAllPending(g);
 	Graph_ReleaseLock(g);
 	return res;
 }
@@ -8,6 +8,7 @@
 #include "RG.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
 #include "../util/thpool/pools.h"
 #include "../slow_log/slow_log.h"
 
@@ -39,6 +40,9 @@ CommandCtx *CommandCtx_New
 	context->graph_ctx = graph_ctx;
 	context->replicated_command = replicated_command;
 
+	// command is about to be queued for execution
+	simple_tic(context->timer);
+
 	if(cmd_name) {
 		// Make a copy of command name.
 		const char *command_name = RedisModule_StringPtrLen(cmd_name, NULL);
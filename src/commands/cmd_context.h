@@ -28,6 +28,7 @@ typedef struct {
 	bool compact;                   // Whether this query was issued with the compact flag.
 	ExecutorThread thread;          // Which thread executes this command
 	long long timeout;              // The query timeout, if specified.
+	double timer[2];                // Time at which the command was last queued.
 } CommandCtx;
 
 // Create a new command context.
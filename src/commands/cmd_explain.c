@@ -32,7 +32,7 @@ void Graph_Explain(void *args) {
 	 * 2. Whether these items were cached or not */
 	bool           cached     =  false;
 	ExecutionPlan  *plan      =  NULL;
-	ExecutionCtx   *exec_ctx  =  ExecutionCtx_FromQuery(command_ctx->query);
+	ExecutionCtx   *exec_ctx  =  ExecutionCtx_FromQuery(command_ctx->query, false);
 	if(exec_ctx == NULL) goto cleanup;
 
 	plan = exec_ctx->plan;
@@ -0,0 +1,64 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../redismodule.h"
+#include "../graph/graphcontext.h"
+
+static void _ReplyWithCount(RedisModuleCtx *ctx, const char *name,
+		long long value) {
+	RedisModule_ReplyWithArray(ctx, 2);
+	RedisModule_ReplyWithCString(ctx, name);
+	RedisModule_ReplyWithLongLong(ctx, value);
+}
+
+// reply with execution plan cache usage
+static void _ReplyWithCacheStats(RedisModuleCtx *ctx, const Cache *cache) {
+	CacheStats stats;
+	Cache_GetStats(cache, &stats);
+
+	RedisModule_ReplyWithArray(ctx, 5);
+	_ReplyWithCount(ctx, "Plan cache capacity", cache->cap);
+	_ReplyWithCount(ctx, "Plan cache hits", stats.hits);
+	_ReplyWithCount(ctx, "Plan cache misses", stats.misses);
+	_ReplyWithCount(ctx, "Plan cache evictions", stats.evictions);
+
+	// time saved, in milliseconds
+	char saved[32];
+	int len = snprintf(saved, sizeof(saved), "%.3f", stats.saved_us / 1000.0);
+	RedisModule_ReplyWithArray(ctx, 2);
+	RedisModule_ReplyWithCString(ctx, "Plan cache compile time saved");
+	RedisModule_ReplyWithStringBuffer(ctx, saved, len);
+}
+
+// GRAPH.INFO <graph> [CACHE | OPSTATS | LATENCY]
+// replies with runtime statistics of the given graph
+int Graph_Info(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc < 2 || argc > 3) return RedisModule_WrongArity(ctx);
+
+	// plan cache statistics are reported by default
+	const char *section = (argc == 3) ?
+		RedisModule_StringPtrLen(argv[2], NULL) : "CACHE";
+	bool cache = (strcasecmp(section, "CACHE") == 0);
+	bool opstats = (strcasecmp(section, "OPSTATS") == 0);
+	bool latency = (strcasecmp(section, "LATENCY") == 0);
+	if(!cache && !opstats && !latency) {
+		RedisModule_ReplyWithError(ctx, "Unknown GRAPH.INFO section");
+		return REDISMODULE_OK;
+	}
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+	// if GraphContext is null, key access failed and an error been emitted
+	if(!gc) return REDISMODULE_ERR;
+
+	if(cache) _ReplyWithCacheStats(ctx, GraphContext_GetCache(gc));
+	else if(opstats) PlanStats_Replay(GraphContext_GetPlanStats(gc), ctx);
+	else LatencyStats_Replay(GraphContext_GetLatencyStats(gc), ctx);
+
+	GraphContext_Release(gc);
+	return REDISMODULE_OK;
+}
+
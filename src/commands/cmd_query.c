@@ -13,8 +13,10 @@
 #include "../query_ctx.h"
 #include "../graph/graph.h"
 #include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
 #include "../util/cache/cache.h"
 #include "../util/thpool/pools.h"
+#include "../configuration/config.h"
 #include "../execution_plan/execution_plan.h"
 #include "execution_ctx.h"
 
@@ -26,6 +28,7 @@ typedef struct {
 	ExecutionCtx *exec_ctx;   // execution context
 	CommandCtx *command_ctx;  // command context
 	bool readonly_query;      // read only query
+	double queue_time;        // time spent queued for a worker thread, in ms
 } GraphQueryCtx;
 
 static GraphQueryCtx *GraphQueryCtx_New
@@ -34,7 +37,8 @@ static GraphQueryCtx *GraphQueryCtx_New
 	RedisModuleCtx *rm_ctx,
 	ExecutionCtx *exec_ctx,
 	CommandCtx *command_ctx,
-	bool readonly_query
+	bool readonly_query,
+	double queue_time
 ) {
 	GraphQueryCtx *ctx = rm_malloc(sizeof(GraphQueryCtx));
 
@@ -44,6 +48,7 @@ static GraphQueryCtx *GraphQueryCtx_New
 	ctx->query_ctx       =  QueryCtx_GetQueryCtx();
 	ctx->command_ctx     =  command_ctx;
 	ctx->readonly_query  =  readonly_query;
+	ctx->queue_time      =  queue_time;
 
 	return ctx;
 }
@@ -68,10 +73,15 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 		for(unsigned int i = 0; i < nprops; i++) {
 			const char *prop = cypher_ast_prop_name_get_value(cypher_ast_create_node_props_index_get_prop_name(
 																index_op, i));
-			index_added |= (GraphContext_AddIndex(&idx, gc, label, prop, IDX_EXACT_MATCH) == INDEX_OK);
+			index_added |= (GraphContext_AddIndex(&idx, gc, label, prop, IDX_EXACT_MATCH, SCHEMA_NODE) == INDEX_OK);
 		}
 		// populate the index only when at least one attribute was introduced
-		if(index_added) Index_Construct(idx);
+		if(index_added) {
+			bool async_build;
+			Config_Option_get(Config_ASYNC_INDEX_BUILD, &async_build);
+			if(async_build) Index_ConstructAsync(idx);
+			else Index_Construct(idx);
+		}
 		QueryCtx_UnlockCommit(NULL);
 	} else if(exec_type == EXECUTION_TYPE_INDEX_DROP) {
 		// Retrieve strings from AST node
@@ -79,7 +89,7 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 		const char *prop = cypher_ast_prop_name_get_value(cypher_ast_drop_node_props_index_get_prop_name(
 															  index_op, 0));
 		QueryCtx_LockForCommit();
-		int res = GraphContext_DeleteIndex(gc, label, prop, IDX_EXACT_MATCH);
+		int res = GraphContext_DeleteIndex(gc, label, prop, IDX_EXACT_MATCH, SCHEMA_NODE);
 		QueryCtx_UnlockCommit(NULL);
 
 		if(res != INDEX_OK) {
@@ -117,6 +127,52 @@ void Query_SetTimeOut(uint timeout, ExecutionPlan *plan) {
 	Cron_AddTask(timeout, QueryTimedOut, plan);
 }
 
+// number of queries considered for sampling
+static uint64_t sample_counter = 0;
+
+// returns true if query should collect operation statistics
+// queries are sampled evenly, according to the configured rate
+static bool _SampleQuery(void) {
+	uint rate;
+	Config_Option_get(Config_OP_STATS_SAMPLE_RATE, &rate);
+	if(rate == 0) return false;
+
+	uint64_t n = __atomic_fetch_add(&sample_counter, 1, __ATOMIC_RELAXED);
+	return (n % 100) < rate;
+}
+
+// log query to the graph's slowlog if it ran longer than the configured threshold
+static void _SlowLogQuery(GraphContext *gc, CommandCtx *command_ctx,
+		const ExecutionCtx *exec_ctx, const ResultSet *result_set,
+		double lock_wait) {
+	double latency = QueryCtx_GetExecutionTime();
+	uint64_t log_slower_than;
+	Config_Option_get(Config_SLOWLOG_LOG_SLOWER_THAN, &log_slower_than);
+	if(latency * 1000 < log_slower_than) return;
+
+	SlowLogItem item = {0};
+	item.cmd          =  command_ctx->command_name;
+	item.query        =  command_ctx->query;
+	item.latency      =  latency;
+	item.fingerprint  =  exec_ctx->fingerprint;
+	item.params_hash  =  exec_ctx->params_hash;
+	item.rows         =  ResultSet_RowCount(result_set);
+	item.peak_memory  =  rm_thread_peak_alloced();
+	item.lock_wait    =  lock_wait;
+
+	// most expensive operations, as seen by sampled executions of the query
+	const char *names[SLOWLOG_TOP_OPS];
+	double exec_times[SLOWLOG_TOP_OPS];
+	item.op_count = PlanStats_TopOps(GraphContext_GetPlanStats(gc),
+			exec_ctx->fingerprint, SLOWLOG_TOP_OPS, names, exec_times);
+	for(uint i = 0; i < item.op_count; i++) {
+		item.ops[i].name = names[i];
+		item.ops[i].exec_time = exec_times[i];
+	}
+
+	SlowLog_Add(GraphContext_GetSlowLog(gc), &item);
+}
+
 inline static bool _readonly_cmd_mode(CommandCtx *ctx) {
 	return strcasecmp(CommandCtx_GetCommandName(ctx), "graph.RO_QUERY") == 0;
 }
@@ -141,6 +197,8 @@ static void _ExecuteQuery(void *args) {
 	// if we have migrated to a writer thread,
 	// update thread-local storage and track the CommandCtx
 	if(command_ctx->thread == EXEC_THREAD_WRITER) {
+		// add time spent queued for the writer thread
+		gq_ctx->queue_time += simple_toc(command_ctx->timer) * 1000;
 		QueryCtx_SetTLS(query_ctx);
 		CommandCtx_TrackCtx(command_ctx);
 	}
@@ -154,6 +212,8 @@ static void _ExecuteQuery(void *args) {
 	QueryCtx_SetResultSet(result_set);
 
 	// acquire the appropriate lock
+	double tic[2];
+	simple_tic(tic);
 	if(readonly) {
 		Graph_AcquireReadLock(gc->g);
 	} else {
@@ -167,20 +227,58 @@ static void _ExecuteQuery(void *args) {
 		CommandCtx_ThreadSafeContextUnlock(command_ctx);
 		Graph_WriterEnter(gc->g);  // single writer
 	}
+	double lock_wait = simple_toc(tic) * 1000;
+	simple_tic(tic);
+
+	bool recycle = false;  // hand the execution context back to the cache
+	uint64_t epoch = 0;    // graph epoch the query executes under
 
 	if(exec_type == EXECUTION_TYPE_QUERY) {  // query operation
 		// set policy after lock acquisition,
 		// avoid resetting policies between readers and writers
 		Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
 
-		ExecutionPlan_PreparePlan(plan);
-		result_set = ExecutionPlan_Execute(plan);
+		// sampled queries are profiled
+		bool sampled = _SampleQuery();
+		epoch = Graph_GetEpoch(gc->g);
+
+		if(plan->prepared) {
+			// recycled plan, renew it if the graph was modified since
+			// it was executed, or if it is about to be profiled
+			if(sampled || exec_ctx->epoch != epoch) {
+				ExecutionCtx_RenewPlan(exec_ctx);
+				plan = exec_ctx->plan;
+				ExecutionPlan_PreparePlan(plan);
+			} else {
+				ExecutionPlan_Reset(plan);
+			}
+		} else {
+			ExecutionPlan_PreparePlan(plan);
+		}
+
+		if(sampled) result_set = ExecutionPlan_Profile(plan);
+		else result_set = ExecutionPlan_Execute(plan);
 
 		// Emit error if query timed out.
-		if(ExecutionPlan_Drained(plan)) ErrorCtx_SetError("Query timed out");
+		bool drained = ExecutionPlan_Drained(plan);
+		if(drained) ErrorCtx_SetError("Query timed out");
+
+		// record operation statistics of successful sampled executions
+		if(sampled && !ErrorCtx_EncounteredError()) {
+			PlanStats_Add(GraphContext_GetPlanStats(gc), exec_ctx->fingerprint,
+					plan);
+		}
+
+		// keep the executed plan of a successful read-only query,
+		// for an identical query to execute it again
+		recycle = readonly && !sampled && !drained &&
+				  command_ctx->timeout == 0 && exec_ctx->template != NULL &&
+				  !ErrorCtx_EncounteredError();
 
-		ExecutionPlan_Free(plan);
-		exec_ctx->plan = NULL;
+		if(!recycle) {
+			ExecutionPlan_Free(plan);
+			exec_ctx->plan = NULL;
+		}
 	} else if(exec_type == EXECUTION_TYPE_INDEX_CREATE ||
 			  exec_type == EXECUTION_TYPE_INDEX_DROP) {
 		_index_operation(rm_ctx, gc, ast, exec_type);
@@ -189,20 +287,34 @@ static void _ExecuteQuery(void *args) {
 	}
 
 	QueryCtx_ForceUnlockCommit();
+	double exec_time = simple_toc(tic) * 1000;
 
 	// send result-set back to client
+	simple_tic(tic);
 	ResultSet_Reply(result_set);
+	double reply_time = simple_toc(tic) * 1000;
 
 	if(readonly) Graph_ReleaseLock(gc->g); // release read lock
 	else Graph_WriterLeave(gc->g);
 
+	// record query latency breakdown
+	LatencyStats *latency_stats = GraphContext_GetLatencyStats(gc);
+	QueryClass query_class = readonly ? QUERY_CLASS_READ : QUERY_CLASS_WRITE;
+	LatencyStats_Record(latency_stats, query_class, LATENCY_STAGE_QUEUE,
+			gq_ctx->queue_time);
+	LatencyStats_Record(latency_stats, query_class, LATENCY_STAGE_LOCK,
+			lock_wait);
+	LatencyStats_Record(latency_stats, query_class, LATENCY_STAGE_EXECUTION,
+			exec_time);
+	LatencyStats_Record(latency_stats, query_class, LATENCY_STAGE_REPLY,
+			reply_time);
+
 	// log query to slowlog
-	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
-	SlowLog_Add(slowlog, command_ctx->command_name, command_ctx->query,
-				QueryCtx_GetExecutionTime(), NULL);
+	_SlowLogQuery(gc, command_ctx, exec_ctx, result_set, lock_wait);
 
 	// clean up
-	ExecutionCtx_Free(exec_ctx);
+	if(recycle) ExecutionCtx_Recycle(exec_ctx, command_ctx->query, epoch);
+	else ExecutionCtx_Free(exec_ctx);
 	GraphContext_Release(gc);
 	CommandCtx_Free(command_ctx);
 	QueryCtx_Free(); // reset the QueryCtx and free its allocations
@@ -229,6 +341,9 @@ static void _DelegateWriter(GraphQueryCtx *gq_ctx) {
 	// update execution thread to writer
 	gq_ctx->command_ctx->thread = EXEC_THREAD_WRITER;
 
+	// start timing the wait for the writer thread
+	simple_tic(gq_ctx->command_ctx->timer);
+
 	// dispatch work to the writer thread
 	int res = ThreadPools_AddWorkWriter(_ExecuteQuery, gq_ctx);
 	ASSERT(res == 0);
@@ -244,8 +359,13 @@ void Graph_Query(void *args) {
 
 	QueryCtx_BeginTimer(); // start query timing
 
+	// time spent queued for a reader thread
+	double queue_time = simple_toc(command_ctx->timer) * 1000;
+
 	// parse query parameters and build an execution plan or retrieve it from the cache
-	ExecutionCtx *exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+	// recycled plans are not timed
+	ExecutionCtx *exec_ctx = ExecutionCtx_FromQuery(command_ctx->query,
+			command_ctx->timeout == 0);
 	if(exec_ctx == NULL) goto cleanup;
 
 	bool readonly = AST_ReadOnly(exec_ctx->ast->root);
@@ -264,7 +384,7 @@ void Graph_Query(void *args) {
 
 	// populate the container struct for invoking _ExecuteQuery.
 	GraphQueryCtx *gq_ctx = GraphQueryCtx_New(gc, ctx, exec_ctx, command_ctx,
-											  readonly);
+											  readonly, queue_time);
 
 	// if 'thread' is redis main thread, continue running
 	// if readonly is true we're executing on a worker thread from
@@ -0,0 +1,207 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "../RG.h"
+#include "../query_ctx.h"
+#include "../redismodule.h"
+#include "../util/rmalloc.h"
+#include "../util/thpool/pools.h"
+#include "../graph/graphcontext.h"
+#include "../serializers/graph_snapshot.h"
+
+extern RedisModuleType *GraphContextRedisModuleType;
+
+// snapshot context object
+typedef struct {
+	bool save;                     // SAVE or LOAD
+	RedisModuleString *graph;      // graph name
+	RedisModuleString *path;       // snapshot file path
+	RedisModuleBlockedClient *bc;  // blocked client
+} SnapshotCtx;
+
+static void _ReplyWithError(RedisModuleCtx *ctx, char *err) {
+	RedisModule_ReplyWithError(ctx, err);
+	free(err);
+}
+
+// snapshot paths are resolved relative to the server's working directory
+// which Redis sets to its configured 'dir'
+// absolute paths and paths containing a '..' component are rejected
+static bool _Snapshot_ValidPath(const char *path) {
+	if(path[0] == '\0' || path[0] == '/') return false;
+
+	const char *component = path;
+	while(component != NULL) {
+		const char *end = strchr(component, '/');
+		size_t len = (end) ? (size_t)(end - component) : strlen(component);
+		if(len == 2 && component[0] == '.' && component[1] == '.') return false;
+		component = (end) ? end + 1 : NULL;
+	}
+
+	return true;
+}
+
+// returns true if writes are propagated to replicas or to the AOF
+// a loaded graph would be missing from both, as LOAD isn't propagated
+// and the snapshot file is only available on this node
+static bool _Snapshot_WritesPropagated(RedisModuleCtx *ctx) {
+	if(RedisModule_GetContextFlags(ctx) & REDISMODULE_CTX_FLAGS_AOF) return true;
+
+	RedisModuleCallReply *reply = RedisModule_Call(ctx, "info", "c",
+			"replication");
+	if(reply == NULL) return false;
+
+	size_t len;
+	const char *info = RedisModule_CallReplyStringPtr(reply, &len);
+	const char *field = "connected_slaves:";
+	const char *pos = memmem(info, len, field, strlen(field));
+
+	long long replicas = 0;
+	if(pos != NULL) {
+		pos += strlen(field);
+		while(pos < info + len && *pos >= '0' && *pos <= '9') {
+			replicas = replicas * 10 + (*pos - '0');
+			pos++;
+		}
+	}
+	RedisModule_FreeCallReply(reply);
+
+	return replicas > 0;
+}
+
+// write graph to a snapshot file, the graph is read-locked for the duration
+static void _Snapshot_Save(RedisModuleCtx *ctx, SnapshotCtx *snapshot_ctx) {
+	GraphContext *gc;
+	RedisModule_ThreadSafeContextLock(ctx);
+	{
+		gc = GraphContext_Retrieve(ctx, snapshot_ctx->graph, true, false);
+	}
+	RedisModule_ThreadSafeContextUnlock(ctx);
+
+	// failed to retrieve GraphContext; an error has been emitted
+	if(gc == NULL) return;
+
+	char *err = NULL;
+	const char *path = RedisModule_StringPtrLen(snapshot_ctx->path, NULL);
+
+	Graph_AcquireReadLock(gc->g);
+	bool saved = GraphSnapshot_Save(gc, path, &err);
+	Graph_ReleaseLock(gc->g);
+	GraphContext_Release(gc);
+
+	if(saved) RedisModule_ReplyWithSimpleString(ctx, "OK");
+	else _ReplyWithError(ctx, err);
+}
+
+// build graph from a snapshot file, fails if graph key already exists
+static void _Snapshot_Load(RedisModuleCtx *ctx, SnapshotCtx *snapshot_ctx) {
+	char *err = NULL;
+	const char *graphname = RedisModule_StringPtrLen(snapshot_ctx->graph, NULL);
+	const char *path = RedisModule_StringPtrLen(snapshot_ctx->path, NULL);
+
+	// the key is verified to be empty both before and after loading
+	// as the GIL isn't held while loading
+	RedisModuleKey *key = NULL;
+	RedisModule_ThreadSafeContextLock(ctx);
+	{
+		key = RedisModule_OpenKey(ctx, snapshot_ctx->graph, REDISMODULE_READ);
+		RedisModule_CloseKey(key);
+	}
+	RedisModule_ThreadSafeContextUnlock(ctx);
+
+	if(key == NULL) {
+		GraphContext *gc = GraphSnapshot_Load(graphname, path, &err);
+		if(gc == NULL) {
+			_ReplyWithError(ctx, err);
+			return;
+		}
+
+		RedisModule_ThreadSafeContextLock(ctx);
+		{
+			key = RedisModule_OpenKey(ctx, snapshot_ctx->graph, REDISMODULE_WRITE);
+			if(RedisModule_KeyType(key) == REDISMODULE_KEYTYPE_EMPTY) {
+				RedisModule_ModuleTypeSetValue(key, GraphContextRedisModuleType, gc);
+				// register graph context for BGSave
+				GraphContext_RegisterWithModule(gc);
+				gc = NULL;
+			}
+			RedisModule_CloseKey(key);
+		}
+		RedisModule_ThreadSafeContextUnlock(ctx);
+
+		if(gc == NULL) {
+			RedisModule_ReplyWithSimpleString(ctx, "OK");
+			return;
+		}
+
+		// key was created while loading
+		GraphContext_Delete(gc);
+	}
+
+	asprintf(&err, "Graph with name '%s' cannot be loaded, \
+			as key '%s' already exists.", graphname, graphname);
+	_ReplyWithError(ctx, err);
+}
+
+static void _Graph_Snapshot(void *args) {
+	ASSERT(args != NULL);
+
+	SnapshotCtx *snapshot_ctx     = (SnapshotCtx *)args;
+	RedisModuleBlockedClient *bc  = snapshot_ctx->bc;
+	RedisModuleCtx *ctx           = RedisModule_GetThreadSafeContext(bc);
+
+	if(snapshot_ctx->save) _Snapshot_Save(ctx, snapshot_ctx);
+	else _Snapshot_Load(ctx, snapshot_ctx);
+
+	RedisModule_FreeString(ctx, snapshot_ctx->graph);
+	RedisModule_FreeString(ctx, snapshot_ctx->path);
+	rm_free(snapshot_ctx);
+	RedisModule_FreeThreadSafeContext(ctx);
+	RedisModule_UnblockClient(bc, NULL);
+}
+
+// GRAPH.SNAPSHOT SAVE <graph> <path>
+// GRAPH.SNAPSHOT LOAD <graph> <path>
+int Graph_Snapshot(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc != 4) return RedisModule_WrongArity(ctx);
+
+	const char *action = RedisModule_StringPtrLen(argv[1], NULL);
+	bool save = strcasecmp(action, "SAVE") == 0;
+	if(!save && strcasecmp(action, "LOAD") != 0) {
+		RedisModule_ReplyWithError(ctx, "Unknown GRAPH.SNAPSHOT subcommand, \
+				expecting SAVE or LOAD");
+		return REDISMODULE_OK;
+	}
+
+	const char *path = RedisModule_StringPtrLen(argv[3], NULL);
+	if(!_Snapshot_ValidPath(path)) {
+		RedisModule_ReplyWithError(ctx, "Snapshot path must be relative to "
+				"the server's directory and must not contain '..'");
+		return REDISMODULE_OK;
+	}
+
+	if(!save && _Snapshot_WritesPropagated(ctx)) {
+		RedisModule_ReplyWithError(ctx, "GRAPH.SNAPSHOT LOAD is not "
+				"supported when replicas are connected or AOF is enabled");
+		return REDISMODULE_OK;
+	}
+
+	// retain strings
+	RedisModule_RetainString(ctx, argv[2]);
+	RedisModule_RetainString(ctx, argv[3]);
+
+	// create snapshot context object
+	SnapshotCtx *snapshot_ctx = rm_malloc(sizeof(SnapshotCtx));
+	snapshot_ctx->save = save;
+	snapshot_ctx->graph = argv[2];
+	snapshot_ctx->path = argv[3];
+	snapshot_ctx->bc = RedisModule_BlockClient(ctx, NULL, NULL, NULL, 0);
+
+	// file IO takes place on a reader thread
+	ThreadPools_AddWorkReader(_Graph_Snapshot, snapshot_ctx);
+
+	return REDISMODULE_OK;
+}
@@ -22,7 +22,9 @@ typedef enum {
 	CMD_PROFILE        = 6,
 	CMD_BULK_INSERT    = 7,
 	CMD_SLOWLOG        = 8,
-	CMD_LIST           = 9
+	CMD_LIST           = 9,
+	CMD_SNAPSHOT       = 10,
+	CMD_INFO           = 11
 } GRAPH_Commands;
 
 //------------------------------------------------------------------------------
@@ -36,5 +38,7 @@ void Graph_Explain(void *args);
 int Graph_List(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Delete(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Config(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Snapshot(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Info(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 
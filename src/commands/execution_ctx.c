@@ -8,7 +8,18 @@
 #include "RG.h"
 #include "../errors.h"
 #include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../arithmetic/arithmetic_expression.h"
+#include "../util/simple_timer.h"
+#include "xxhash.h"
 #include "../execution_plan/execution_plan_clone.h"
+#include <inttypes.h>
+
+/* cached execution contexts are keyed by both their query string and
+ * their AST fingerprint, fingerprint keys start with a character
+ * which never leads a valid query */
+#define FINGERPRINT_PREFIX '\x01'
+#define FINGERPRINT_KEY_LEN 18  // prefix, 16 hex digits and terminator
 
 static ExecutionType _GetExecutionTypeFromAST(AST *ast) {
 	const cypher_astnode_type_t root_type = cypher_astnode_type(ast->root);
@@ -23,10 +34,18 @@ static ExecutionCtx *_ExecutionCtx_New(AST *ast, ExecutionPlan *plan,
 									   ExecutionType exec_type) {
 	ExecutionCtx *exec_ctx = rm_malloc(sizeof(ExecutionCtx));
 
-	exec_ctx->ast       = ast;
-	exec_ctx->plan      = plan;
-	exec_ctx->cached    = false;
-	exec_ctx->exec_type = exec_type;
+	exec_ctx->ast          = ast;
+	exec_ctx->plan         = plan;
+	exec_ctx->cached       = false;
+	exec_ctx->exec_type    = exec_type;
+	exec_ctx->compile_time = 0;
+	exec_ctx->fingerprint  = 0;
+	exec_ctx->params_hash  = 0;
+	exec_ctx->params_len   = 0;
+	exec_ctx->params       = NULL;
+	exec_ctx->params_values = NULL;
+	exec_ctx->epoch        = 0;
+	exec_ctx->template     = NULL;
 
 	return exec_ctx;
 }
@@ -38,30 +57,102 @@ ExecutionCtx *ExecutionCtx_Clone(ExecutionCtx *orig) {
 	// set the AST copy in thread local storage
 	QueryCtx_SetAST(execution_ctx->ast);
 
-	execution_ctx->plan      = ExecutionPlan_Clone(orig->plan);
-	execution_ctx->cached    = orig->cached;
-	execution_ctx->exec_type = orig->exec_type;
+	execution_ctx->plan         = ExecutionPlan_Clone(orig->plan);
+	execution_ctx->cached       = orig->cached;
+	execution_ctx->exec_type    = orig->exec_type;
+	execution_ctx->compile_time = orig->compile_time;
+	execution_ctx->fingerprint  = orig->fingerprint;
+	execution_ctx->params_hash  = orig->params_hash;
+	execution_ctx->params_len   = 0;
+	execution_ctx->params       = NULL;
+	execution_ctx->params_values = NULL;
+	execution_ctx->epoch        = 0;
+
+	// keep the cached plan, for the copy to be renewed from once recycled
+	execution_ctx->template = orig->plan;
+	ExecutionPlan_IncreaseRefCount(orig->plan);
 
 	return execution_ctx;
 }
 
-static AST *_ExecutionCtx_ParseAST(const char *query_string,
-								   cypher_parse_result_t *params_parse_result) {
-	cypher_parse_result_t *query_parse_result = parse_query(query_string);
-	// If no output from the parser, the query is not valid.
-	if(!query_parse_result) {
-		parse_result_free(params_parse_result);
+// key cached execution contexts by the fingerprint of their parsed query
+static void _ExecutionCtx_FingerprintKey(uint64_t fingerprint, char *key) {
+	snprintf(key, FINGERPRINT_KEY_LEN, "%c%016" PRIx64, FINGERPRINT_PREFIX,
+			fingerprint);
+}
+
+// hash the parameters prefix of query, 0 if query has no parameters
+static uint64_t _ExecutionCtx_ParamsHash(const char *query, size_t params_len) {
+	if(params_len == 0) return 0;
+	return XXH64(query, params_len, 0);
+}
+
+// recycled contexts are tagged by their parameters and graph epoch
+static uint64_t _ExecutionCtx_RecycleTag(uint64_t params_hash, uint64_t epoch) {
+	return XXH64(&epoch, sizeof(epoch), params_hash);
+}
+
+// rax callback routine for freeing recycled parameter values
+static void _ExecutionCtx_FreeParam(void *param_val) {
+	AR_EXP_Free(param_val);
+}
+
+// retrieve a recycled context executed with the exact same parameters
+static ExecutionCtx *_ExecutionCtx_GetRecycled(Cache *cache, const char *key,
+		const char *query, size_t params_len, uint64_t params_hash) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	uint64_t tag = _ExecutionCtx_RecycleTag(params_hash,
+			Graph_GetEpoch(gc->g));
+
+	ExecutionCtx *ctx = Cache_GetRecycledValue(cache, key, tag);
+	if(ctx == NULL) return NULL;
+
+	// guard against tag collisions
+	if(ctx->params_len != params_len ||
+	   (params_len > 0 && memcmp(ctx->params, query, params_len) != 0)) {
+		ExecutionCtx_Free(ctx);
 		return NULL;
 	}
 
-	// Prepare the constructed AST.
-	AST *ast = AST_Build(query_parse_result);
-	// Set parameters parse result in the execution ast.
-	AST_SetParamsParseResult(ast, params_parse_result);
-	return ast;
+	return ctx;
+}
+
+static ExecutionCtx *_ExecutionCtx_CacheHit(Cache *cache, ExecutionCtx *ctx,
+		cypher_parse_result_t *params_parse_result, uint64_t params_hash,
+		size_t params_len) {
+	if(ctx->plan->prepared) {
+		// recycled context, its plan refers to its own parameter values
+		// which are identical to the ones just parsed
+		QueryCtx_SetAST(ctx->ast);
+		QueryCtx_SetParams(ctx->params_values);
+		ctx->params_values = NULL;
+		parse_result_free(params_parse_result);
+	} else {
+		// Set parameters parse result in the execution ast.
+		AST_SetParamsParseResult(ctx->ast, params_parse_result);
+	}
+
+	ctx->cached = true;
+	ctx->params_hash = params_hash;
+	ctx->params_len = params_len;
+	Cache_CountHit(cache, ctx->compile_time);
+	return ctx;
+}
+
+// look up key, preferring a recycled context if allowed
+static ExecutionCtx *_ExecutionCtx_Lookup(Cache *cache, const char *key,
+		const char *query, size_t params_len, uint64_t params_hash,
+		bool recycled) {
+	ExecutionCtx *ctx = NULL;
+	if(recycled) {
+		ctx = _ExecutionCtx_GetRecycled(cache, key, query, params_len,
+				params_hash);
+	}
+	if(ctx == NULL) ctx = Cache_GetValue(cache, key);
+	return ctx;
 }
 
-ExecutionCtx *ExecutionCtx_FromQuery(const char *query) {
+ExecutionCtx *ExecutionCtx_FromQuery(const char *query, bool recycled) {
 	ASSERT(query != NULL);
 
 	ExecutionCtx *ret;
@@ -75,26 +166,53 @@ ExecutionCtx *ExecutionCtx_FromQuery(const char *query) {
 	// Parameter parsing failed, return NULL.
 	if(params_parse_result == NULL) return NULL;
 
+	size_t params_len = strlen(query) - strlen(query_string);
+	uint64_t params_hash = _ExecutionCtx_ParamsHash(query, params_len);
+
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Cache *cache = GraphContext_GetCache(gc);
 
 	// Check the cache to see if we already have a cached context for this query.
-	ret = Cache_GetValue(cache, query_string);
-	if(ret) {
-		// Set parameters parse result in the execution ast.
-		AST_SetParamsParseResult(ret->ast, params_parse_result);
-		ret->cached = true;
-		return ret;
+	if(query_string[0] != FINGERPRINT_PREFIX) {
+		ret = _ExecutionCtx_Lookup(cache, query_string, query, params_len,
+				params_hash, recycled);
+		if(ret) return _ExecutionCtx_CacheHit(cache, ret, params_parse_result,
+				params_hash, params_len);
 	}
 
+	double tic[2];
+	simple_tic(tic);
+
 	// No cached execution plan, try to parse the query.
-	AST *ast = _ExecutionCtx_ParseAST(query_string, params_parse_result);
-	// If query parsing failed, return NULL.
-	if(!ast) return NULL;
+	cypher_parse_result_t *query_parse_result = parse_query(query_string);
+	// If no output from the parser, the query is not valid.
+	if(!query_parse_result) {
+		parse_result_free(params_parse_result);
+		return NULL;
+	}
+
+	// Check the cache for an equivalent query,
+	// e.g. one which differs only in whitespace.
+	uint64_t fingerprint = AST_Fingerprint(query_parse_result);
+	char fingerprint_key[FINGERPRINT_KEY_LEN];
+	_ExecutionCtx_FingerprintKey(fingerprint, fingerprint_key);
+	ret = _ExecutionCtx_Lookup(cache, fingerprint_key, query, params_len,
+			params_hash, recycled);
+	if(ret) {
+		parse_result_free(query_parse_result);
+		// Have future lookups of this query string skip parsing.
+		Cache_SetAlias(cache, fingerprint_key, query_string);
+		return _ExecutionCtx_CacheHit(cache, ret, params_parse_result,
+				params_hash, params_len);
+	}
+
+	// Prepare the constructed AST.
+	AST *ast = AST_Build(query_parse_result);
 
 	ExecutionType exec_type = _GetExecutionTypeFromAST(ast);
 	// In case of valid query, create execution plan, and cache it and the AST.
 	if(exec_type == EXECUTION_TYPE_QUERY) {
+		Cache_CountMiss(cache);
 		ExecutionPlan *plan = NewExecutionPlan();
 
 		// TODO: there must be a better way to understand if the execution-plan
@@ -104,23 +222,70 @@ ExecutionCtx *ExecutionCtx_FromQuery(const char *query) {
 		if(ErrorCtx_EncounteredError()) {
 			// Encountered an error in ExecutionPlan construction,
 			// clean up and return NULL.
+			parse_result_free(params_parse_result);
 			AST_Free(ast);
 			ExecutionPlan_Free(plan);
 			return NULL;
 		}
 		ExecutionCtx *exec_ctx_to_cache = _ExecutionCtx_New(ast, plan,
 															exec_type);
+		exec_ctx_to_cache->compile_time = simple_toc(tic) * 1000;
+		exec_ctx_to_cache->fingerprint  = fingerprint;
 		ExecutionCtx *exec_ctx_from_cache = Cache_SetGetValue(cache,
-															  query_string, exec_ctx_to_cache);
+															  fingerprint_key, exec_ctx_to_cache);
+		Cache_SetAlias(cache, fingerprint_key, query_string);
+		// Set parameters parse result in the execution ast, rather than in
+		// the cached one, which outlives this execution.
+		AST_SetParamsParseResult(exec_ctx_from_cache->ast, params_parse_result);
+		exec_ctx_from_cache->params_hash = params_hash;
+		exec_ctx_from_cache->params_len  = params_len;
 		return exec_ctx_from_cache;
 	} else {
-		return _ExecutionCtx_New(ast, NULL, exec_type);
+		// Set parameters parse result in the execution ast.
+		AST_SetParamsParseResult(ast, params_parse_result);
+		ExecutionCtx *exec_ctx = _ExecutionCtx_New(ast, NULL, exec_type);
+		exec_ctx->params_hash = params_hash;
+		return exec_ctx;
+	}
+}
+
+void ExecutionCtx_RenewPlan(ExecutionCtx *ctx) {
+	ASSERT(ctx != NULL);
+	ASSERT(ctx->template != NULL);
+
+	// the context's AST is already set in thread local storage
+	ExecutionPlan_Free(ctx->plan);
+	ctx->plan = ExecutionPlan_Clone(ctx->template);
+}
+
+void ExecutionCtx_Recycle(ExecutionCtx *ctx, const char *query,
+		uint64_t epoch) {
+	ASSERT(ctx != NULL);
+	ASSERT(ctx->template != NULL);
+
+	// the executed plan refers to the parameter values, retain them
+	ctx->params_values = QueryCtx_DetachParams();
+	ctx->epoch = epoch;
+	if(ctx->params == NULL && ctx->params_len > 0) {
+		ctx->params = rm_strndup(query, ctx->params_len);
 	}
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Cache *cache = GraphContext_GetCache(gc);
+	char fingerprint_key[FINGERPRINT_KEY_LEN];
+	_ExecutionCtx_FingerprintKey(ctx->fingerprint, fingerprint_key);
+	Cache_Recycle(cache, fingerprint_key,
+			_ExecutionCtx_RecycleTag(ctx->params_hash, epoch), ctx);
 }
 
 void ExecutionCtx_Free(ExecutionCtx *ctx) {
 	if(ctx == NULL) return;
 	if(ctx->plan != NULL) ExecutionPlan_Free(ctx->plan);
+	if(ctx->template != NULL) ExecutionPlan_Free(ctx->template);
+	if(ctx->params_values != NULL) {
+		raxFreeWithCallback(ctx->params_values, _ExecutionCtx_FreeParam);
+	}
+	if(ctx->params != NULL) rm_free(ctx->params);
 	if(ctx->ast != NULL) AST_Free(ctx->ast);
 
 	rm_free(ctx);
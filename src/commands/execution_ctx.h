@@ -26,15 +26,24 @@ typedef struct {
 	bool cached;                // cache hit/miss
 	ExecutionPlan *plan;        // execution plan
 	ExecutionType exec_type;    // execution type: query, index create/delete
+	double compile_time;        // time spent parsing and planning, in milliseconds
+	uint64_t fingerprint;       // fingerprint of the parsed query
+	uint64_t params_hash;       // hash of the query parameters, 0 if there are none
+	size_t params_len;          // length of the query parameters prefix
+	char *params;               // query parameters prefix of a recycled context
+	rax *params_values;         // parameters map of a recycled context
+	uint64_t epoch;             // graph epoch the plan was last executed under
+	ExecutionPlan *template;    // cached plan this context's plan was copied from
 } ExecutionCtx;
 
 /**
  * @brief  Returns the objects and information required for query execution.
  * @note   If the query contains error, a ExecutionCtx struct with the AST and Execution plan objects will be NULL and EXECUTION_TYPE_INVALID is returned.
  * @param  *query: String representing the query.
+ * @param  recycled: Accept a recycled context, whose plan was already executed.
  * @retval ExecutionCtx populated with the current execution relevant objects.
  */
-ExecutionCtx *ExecutionCtx_FromQuery(const char *query);
+ExecutionCtx *ExecutionCtx_FromQuery(const char *query, bool recycled);
 
 /**
  * @brief  Clone the execution ctx and return it (shallow copy for the ast, deep copy for the execution plan).
@@ -42,6 +51,24 @@ ExecutionCtx *ExecutionCtx_FromQuery(const char *query);
  */
 ExecutionCtx *ExecutionCtx_Clone(ExecutionCtx *ctx);
 
+/**
+ * @brief  Replaces the plan of a recycled context by a fresh copy of the cached plan.
+ * @note   Required once the graph was modified since the plan was executed,
+ *         or if the plan is about to be profiled.
+ * @param  *ctx: A recycled ExecutionCTX struct
+ */
+void ExecutionCtx_RenewPlan(ExecutionCtx *ctx);
+
+/**
+ * @brief  Hands an executed context back to the cache, for an identical query
+ *         to execute it again. The context is freed if it can't be recycled.
+ * @note   The context takes ownership of the query parameters map.
+ * @param  *ctx: ExecutionCTX struct whose plan was executed and reset
+ * @param  *query: String representing the executed query.
+ * @param  epoch: Graph epoch the plan was executed under.
+ */
+void ExecutionCtx_Recycle(ExecutionCtx *ctx, const char *query, uint64_t epoch);
+
 /**
  * @brief  Free an ExecutionCTX struct and its inner fields.
  * @param  *ctx: ExecutionCTX struct
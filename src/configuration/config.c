@@ -46,6 +46,24 @@
 // Max mem(bytes) that query/thread can utilize at any given time
 #define QUERY_MEM_CAPACITY "QUERY_MEM_CAPACITY"
 
+// whether labeled node properties are stored in per label columns
+#define NODE_PROPERTY_COLUMNS "NODE_PROPERTY_COLUMNS"
+
+// config param, number of threads executing parallel scans
+#define PARALLEL_SCAN_THREAD_COUNT "PARALLEL_SCAN_THREAD_COUNT"
+
+// whether indices are built concurrently with writers
+#define ASYNC_INDEX_BUILD "ASYNC_INDEX_BUILD"
+
+// config param, percentage of queries collecting operation statistics
+#define OP_STATS_SAMPLE_RATE "OP_STATS_SAMPLE_RATE"
+
+// config param, number of entries in each graph's slowlog
+#define SLOWLOG_MAX_LEN "SLOWLOG_MAX_LEN"
+
+// config param, minimal latency in microseconds of logged queries
+#define SLOWLOG_LOG_SLOWER_THAN "SLOWLOG_LOG_SLOWER_THAN"
+
 //------------------------------------------------------------------------------
 // Configuration defaults
 //------------------------------------------------------------------------------
@@ -53,6 +71,8 @@
 #define CACHE_SIZE_DEFAULT            25
 #define QUEUED_QUERIES_UNLIMITED      UINT64_MAX
 #define VKEY_MAX_ENTITY_COUNT_DEFAULT 100000
+#define SLOWLOG_MAX_LEN_DEFAULT       128
+#define SLOWLOG_LOG_SLOWER_THAN_DEFAULT 10000
 
 // configuration object
 typedef struct {
@@ -66,6 +86,12 @@ typedef struct {
 	bool maintain_transposed_matrices; // If true, maintain a transposed version of each relationship matrix.
 	uint64_t max_queued_queries;       // max number of queued queries
 	int64_t query_mem_capacity;        // Max mem(bytes) that query/thread can utilize at any given time
+	bool node_property_columns;        // If true, labeled node properties are stored in columns.
+	uint parallel_scan_threads;        // Thread count for parallel scan pool, 0 disables parallel scans.
+	bool async_index_build;            // If true, indices are built concurrently with writers.
+	uint op_stats_sample_rate;         // Percentage of queries collecting operation statistics.
+	uint64_t slowlog_max_len;          // Number of entries in each graph's slowlog.
+	uint64_t slowlog_log_slower_than;  // Minimal latency in microseconds of logged queries.
 	Config_on_change cb;               // callback function which being called when config param changed
 } RG_Config;
 
@@ -242,6 +268,74 @@ uint64_t Config_query_mem_capacity_get(void)
 	return config.query_mem_capacity;
 }
 
+//------------------------------------------------------------------------------
+// node property columns
+//------------------------------------------------------------------------------
+
+void Config_node_property_columns_set(bool columns) {
+	config.node_property_columns = columns;
+}
+
+bool Config_node_property_columns_get(void) {
+	return config.node_property_columns;
+}
+
+//------------------------------------------------------------------------------
+// parallel scan thread count
+//------------------------------------------------------------------------------
+
+void Config_parallel_scan_threads_set(uint nthreads) {
+	config.parallel_scan_threads = nthreads;
+}
+
+uint Config_parallel_scan_threads_get(void) {
+	return config.parallel_scan_threads;
+}
+
+//------------------------------------------------------------------------------
+// async index build
+//------------------------------------------------------------------------------
+
+void Config_async_index_build_set(bool async_index_build) {
+	config.async_index_build = async_index_build;
+}
+
+bool Config_async_index_build_get(void) {
+	return config.async_index_build;
+}
+
+//------------------------------------------------------------------------------
+// operation statistics sample rate
+//------------------------------------------------------------------------------
+
+void Config_op_stats_sample_rate_set(uint rate) {
+	config.op_stats_sample_rate = rate;
+}
+
+uint Config_op_stats_sample_rate_get(void) {
+	return config.op_stats_sample_rate;
+}
+
+//------------------------------------------------------------------------------
+// slowlog
+//------------------------------------------------------------------------------
+
+void Config_slowlog_max_len_set(uint64_t max_len) {
+	config.slowlog_max_len = max_len;
+}
+
+uint64_t Config_slowlog_max_len_get(void) {
+	return config.slowlog_max_len;
+}
+
+void Config_slowlog_log_slower_than_set(uint64_t latency) {
+	config.slowlog_log_slower_than = latency;
+}
+
+uint64_t Config_slowlog_log_slower_than_get(void) {
+	return config.slowlog_log_slower_than;
+}
+
 bool Config_Contains_field(const char *field_str, Config_Option_Field *field)
 {
 	ASSERT(field_str != NULL);
@@ -266,6 +360,18 @@ bool Config_Contains_field(const char *field_str, Config_Option_Field *field)
 		f = Config_MAX_QUEUED_QUERIES;
 	} else if (!(strcasecmp(field_str, QUERY_MEM_CAPACITY))) {
 		f = Config_QUERY_MEM_CAPACITY;
+	} else if (!(strcasecmp(field_str, NODE_PROPERTY_COLUMNS))) {
+		f = Config_NODE_PROPERTY_COLUMNS;
+	} else if (!(strcasecmp(field_str, PARALLEL_SCAN_THREAD_COUNT))) {
+		f = Config_PARALLEL_SCAN_THREADS;
+	} else if (!(strcasecmp(field_str, ASYNC_INDEX_BUILD))) {
+		f = Config_ASYNC_INDEX_BUILD;
+	} else if (!(strcasecmp(field_str, OP_STATS_SAMPLE_RATE))) {
+		f = Config_OP_STATS_SAMPLE_RATE;
+	} else if (!(strcasecmp(field_str, SLOWLOG_MAX_LEN))) {
+		f = Config_SLOWLOG_MAX_LEN;
+	} else if (!(strcasecmp(field_str, SLOWLOG_LOG_SLOWER_THAN))) {
+		f = Config_SLOWLOG_LOG_SLOWER_THAN;
 	} else {
 		return false;
 	}
@@ -318,6 +424,30 @@ const char *Config_Field_name(Config_Option_Field field) {
 			name = QUERY_MEM_CAPACITY;
 			break;
 
+		case Config_NODE_PROPERTY_COLUMNS:
+			name = NODE_PROPERTY_COLUMNS;
+			break;
+
+		case Config_PARALLEL_SCAN_THREADS:
+			name = PARALLEL_SCAN_THREAD_COUNT;
+			break;
+
+		case Config_ASYNC_INDEX_BUILD:
+			name = ASYNC_INDEX_BUILD;
+			break;
+
+		case Config_OP_STATS_SAMPLE_RATE:
+			name = OP_STATS_SAMPLE_RATE;
+			break;
+
+		case Config_SLOWLOG_MAX_LEN:
+			name = SLOWLOG_MAX_LEN;
+			break;
+
+		case Config_SLOWLOG_LOG_SLOWER_THAN:
+			name = SLOWLOG_LOG_SLOWER_THAN;
+			break;
+
         //----------------------------------------------------------------------
         // invalid option
         //----------------------------------------------------------------------
@@ -336,6 +466,9 @@ void _Config_SetToDefaults(void) {
 	int CPUCount = sysconf(_SC_NPROCESSORS_ONLN);
 	config.thread_pool_size = (CPUCount != -1) ? CPUCount : 1;
 
+	// parallel scans are opt-in, no parallel scan pool by default
+	config.parallel_scan_threads = 0;
+
 	// use the GraphBLAS-defined number of OpenMP threads by default
 	GxB_get(GxB_NTHREADS, &config.omp_thread_count);
 
@@ -367,6 +500,19 @@ void _Config_SetToDefaults(void) {
 
 	// no limit on query memory capacity
 	config.query_mem_capacity = QUERY_MEM_CAPACITY_UNLIMITED;
+
+	// node properties are kept in a per entity property bag by default
+	config.node_property_columns = false;
+
+	// indices are built while holding the graph's write lock by default
+	config.async_index_build = false;
+
+	// operation statistics are collected by GRAPH.PROFILE only by default
+	config.op_stats_sample_rate = 0;
+
+	// log the most recent queries which took over 10ms
+	config.slowlog_max_len = SLOWLOG_MAX_LEN_DEFAULT;
+	config.slowlog_log_slower_than = SLOWLOG_LOG_SLOWER_THAN_DEFAULT;
 }
 
 int Config_Init(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
@@ -570,6 +716,96 @@ bool Config_Option_get(Config_Option_Field field, ...) {
 			}
 			break;
 
+		//----------------------------------------------------------------------
+		// node property columns
+		//----------------------------------------------------------------------
+
+		case Config_NODE_PROPERTY_COLUMNS:
+			{
+				va_start(ap, field);
+				bool *node_property_columns = va_arg(ap, bool*);
+				va_end(ap);
+
+				ASSERT(node_property_columns != NULL);
+				(*node_property_columns) = Config_node_property_columns_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// parallel scan thread count
+		//----------------------------------------------------------------------
+
+		case Config_PARALLEL_SCAN_THREADS:
+			{
+				va_start(ap, field);
+				uint *parallel_scan_threads = va_arg(ap, uint*);
+				va_end(ap);
+
+				ASSERT(parallel_scan_threads != NULL);
+				(*parallel_scan_threads) = Config_parallel_scan_threads_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// async index build
+		//----------------------------------------------------------------------
+
+		case Config_ASYNC_INDEX_BUILD:
+			{
+				va_start(ap, field);
+				bool *async_index_build = va_arg(ap, bool*);
+				va_end(ap);
+
+				ASSERT(async_index_build != NULL);
+				(*async_index_build) = Config_async_index_build_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// operation statistics sample rate
+		//----------------------------------------------------------------------
+
+		case Config_OP_STATS_SAMPLE_RATE:
+			{
+				va_start(ap, field);
+				uint *op_stats_sample_rate = va_arg(ap, uint*);
+				va_end(ap);
+
+				ASSERT(op_stats_sample_rate != NULL);
+				(*op_stats_sample_rate) = Config_op_stats_sample_rate_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// slowlog max len
+		//----------------------------------------------------------------------
+
+		case Config_SLOWLOG_MAX_LEN:
+			{
+				va_start(ap, field);
+				uint64_t *slowlog_max_len = va_arg(ap, uint64_t*);
+				va_end(ap);
+
+				ASSERT(slowlog_max_len != NULL);
+				(*slowlog_max_len) = Config_slowlog_max_len_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// slowlog log slower than
+		//----------------------------------------------------------------------
+
+		case Config_SLOWLOG_LOG_SLOWER_THAN:
+			{
+				va_start(ap, field);
+				uint64_t *slowlog_log_slower_than = va_arg(ap, uint64_t*);
+				va_end(ap);
+
+				ASSERT(slowlog_log_slower_than != NULL);
+				(*slowlog_log_slower_than) = Config_slowlog_log_slower_than_get();
+			}
+			break;
+
         //----------------------------------------------------------------------
         // invalid option
         //----------------------------------------------------------------------
@@ -718,6 +954,90 @@ bool Config_Option_set(Config_Option_Field field, const char *val) {
 			}
 			break;
 
+		//----------------------------------------------------------------------
+		// node property columns
+		//----------------------------------------------------------------------
+
+		case Config_NODE_PROPERTY_COLUMNS:
+			{
+				bool node_property_columns;
+				if(!_Config_ParseYesNo(val, &node_property_columns)) return false;
+
+				Config_node_property_columns_set(node_property_columns);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// parallel scan thread count
+		//----------------------------------------------------------------------
+
+		case Config_PARALLEL_SCAN_THREADS:
+			{
+				long long parallel_scan_threads;
+				if(!_Config_ParseInteger(val, &parallel_scan_threads)) return false;
+				// zero disables parallel scans
+				if(parallel_scan_threads < 0) return false;
+
+				Config_parallel_scan_threads_set(parallel_scan_threads);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// async index build
+		//----------------------------------------------------------------------
+
+		case Config_ASYNC_INDEX_BUILD:
+			{
+				bool async_index_build;
+				if(!_Config_ParseYesNo(val, &async_index_build)) return false;
+
+				Config_async_index_build_set(async_index_build);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// operation statistics sample rate
+		//----------------------------------------------------------------------
+
+		case Config_OP_STATS_SAMPLE_RATE:
+			{
+				long long op_stats_sample_rate;
+				if(!_Config_ParseInteger(val, &op_stats_sample_rate)) return false;
+				// percentage of sampled queries
+				if(op_stats_sample_rate < 0 || op_stats_sample_rate > 100) return false;
+
+				Config_op_stats_sample_rate_set(op_stats_sample_rate);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// slowlog max len
+		//----------------------------------------------------------------------
+
+		case Config_SLOWLOG_MAX_LEN:
+			{
+				long long slowlog_max_len;
+				if(!_Config_ParsePositiveInteger(val, &slowlog_max_len)) return false;
+
+				Config_slowlog_max_len_set(slowlog_max_len);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// slowlog log slower than
+		//----------------------------------------------------------------------
+
+		case Config_SLOWLOG_LOG_SLOWER_THAN:
+			{
+				long long slowlog_log_slower_than;
+				if(!_Config_ParseInteger(val, &slowlog_log_slower_than)) return false;
+				// zero logs every query
+				if(slowlog_log_slower_than < 0) return false;
+
+				Config_slowlog_log_slower_than_set(slowlog_log_slower_than);
+			}
+			break;
+
 	//----------------------------------------------------------------------
 	// invalid option
 	//----------------------------------------------------------------------
@@ -25,7 +25,13 @@ typedef enum {
 	Config_VKEY_MAX_ENTITY_COUNT    = 7,  // max number of elements in vkey
 	Config_MAX_QUEUED_QUERIES       = 8,  // max number of queued queries
 	Config_QUERY_MEM_CAPACITY       = 9,  // max mem(bytes) that query/thread can utilize at any given time
-	Config_END_MARKER               = 10
+	Config_NODE_PROPERTY_COLUMNS    = 10, // store labeled node properties in columns
+	Config_PARALLEL_SCAN_THREADS    = 11, // number of threads in parallel scan pool
+	Config_ASYNC_INDEX_BUILD        = 12, // build indices concurrently with writers
+	Config_OP_STATS_SAMPLE_RATE     = 13, // percentage of queries collecting operation statistics
+	Config_SLOWLOG_MAX_LEN          = 14, // number of entries in each graph's slowlog
+	Config_SLOWLOG_LOG_SLOWER_THAN  = 15, // minimal latency(microseconds) of logged queries
+	Config_END_MARKER               = 16
 } Config_Option_Field;
 
 // callback function, invoked once configuration changes as a result of
@@ -33,13 +39,15 @@ typedef enum {
 typedef void (*Config_on_change)(Config_Option_Field type);
 
 // Run-time configurable fields
-#define RUNTIME_CONFIG_COUNT 4
+#define RUNTIME_CONFIG_COUNT 6
 static const Config_Option_Field RUNTIME_CONFIGS[] =
 {
 	Config_RESULTSET_MAX_SIZE,
 	Config_TIMEOUT,
 	Config_MAX_QUEUED_QUERIES,
-	Config_QUERY_MEM_CAPACITY
+	Config_QUERY_MEM_CAPACITY,
+	Config_OP_STATS_SAMPLE_RATE,
+	Config_SLOWLOG_LOG_SLOWER_THAN
 };
 
 // Set module-level configurations to defaults or to user arguments where provided.
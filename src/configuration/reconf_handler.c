@@ -39,6 +39,20 @@ void reconf_handler(Config_Option_Field type) {
 			}
 			break;
 
+		//----------------------------------------------------------------------
+		// operation statistics sample rate
+		//----------------------------------------------------------------------
+
+		case Config_OP_STATS_SAMPLE_RATE:
+			{
+				uint op_stats_sample_rate;
+				bool res = Config_Option_get(type, &op_stats_sample_rate);
+				ASSERT(res);
+				// sampled queries report bytes allocated by each operation
+				rm_track_allocations(op_stats_sample_rate > 0);
+			}
+			break;
+
         //----------------------------------------------------------------------
         // all other options
         //----------------------------------------------------------------------
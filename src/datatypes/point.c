@@ -6,6 +6,9 @@
 
 #include "RG.h"
 #include "point.h"
+#include <math.h>
+
+#define DegreeToRadians(d) ((d) * M_PI / 180.0)
 
 float Point_lat(SIValue point) {
 	ASSERT(SI_TYPE(point) == T_POINT);
@@ -19,3 +22,33 @@ float Point_lon(SIValue point) {
 	return point.point.longitude;
 }
 
+float Point_Distance(SIValue a, SIValue b) {
+	ASSERT(SI_TYPE(a) == T_POINT);
+	ASSERT(SI_TYPE(b) == T_POINT);
+
+	// compute distance between two points
+	// a = sin²(Δφ/2) + cos φ1 ⋅ cos φ2 ⋅ sin²(Δλ/2)
+	// c = 2 * atan2( √a, √(1−a) )
+	// d = R * c
+	// where φ represent the latitudes, and λ represent the longitudes
+
+	float lat[2] = { DegreeToRadians(a.point.latitude),
+					 DegreeToRadians(b.point.latitude)
+				   };
+
+	float lon[2] = { DegreeToRadians(a.point.longitude),
+					 DegreeToRadians(b.point.longitude)
+				   };
+
+	float dlat = lat[1] - lat[0];
+	float dlon = lon[1] - lon[0];
+
+	// a = sin²(Δφ/2) + cos φ1 ⋅ cos φ2 ⋅ sin²(Δλ/2)
+	float h = pow(sin(dlat / 2), 2) + cos(lat[0]) * cos(lat[1]) * pow(sin(dlon / 2), 2);
+
+	// c = 2 * atan2( √a, √(1−a) )
+	float c = 2 * atan2(sqrt(h), sqrt(1 - h));
+
+	// d = R * c
+	return EARTH_RADIUS * c;
+}
@@ -8,9 +8,13 @@
 
 #include "../value.h"
 
+#define EARTH_RADIUS 6378140.0  // meters
+
 // returns latitude of given point
 float Point_lat(SIValue point);
 
 // returns longitude of given point
 float Point_lon(SIValue point);
 
+// returns the distance in meters between two points
+float Point_Distance(SIValue a, SIValue b);
@@ -9,10 +9,13 @@
 #include <pthread.h>
 #include <sys/types.h>
 #include "RG.h"
+#include "util/arr.h"
 #include "util/thpool/pools.h"
 #include "commands/cmd_context.h"
+#include "latency_stats/latency_stats.h"
 
 extern CommandCtx **command_ctxs;
+extern GraphContext **graphs_in_keyspace;
 
 static struct sigaction old_act;
 
@@ -37,9 +40,31 @@ static void logCommands(void) {
 	}
 }
 
+// report thread pool queues and query latency, aggregated over all graphs
+static void _InfoLatency(RedisModuleInfoCtx *ctx) {
+	RedisModule_InfoAddSection(ctx, "latency");
+
+	RedisModule_InfoAddFieldULongLong(ctx, "readers_queue_length",
+			ThreadPools_ReadersQueueLength());
+	RedisModule_InfoAddFieldULongLong(ctx, "writers_queue_length",
+			ThreadPools_WritersQueueLength());
+
+	LatencyStats *total = LatencyStats_New();
+	uint graph_count = array_len(graphs_in_keyspace);
+	for(uint i = 0; i < graph_count; i++) {
+		LatencyStats_Merge(total,
+				GraphContext_GetLatencyStats(graphs_in_keyspace[i]));
+	}
+	LatencyStats_AddInfoFields(total, ctx);
+	LatencyStats_Free(total);
+}
+
 void InfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report) {
-	// make sure information is requested for crash report
-	if(!for_crash_report) return;
+	// report latency on regular INFO requests
+	if(!for_crash_report) {
+		_InfoLatency(ctx);
+		return;
+	}
 
 	// pause all working threads
 	// NOTE: pausing is not an atomic action;
@@ -80,7 +105,8 @@ void crashHandler(int sig, siginfo_t *info, void *ucontext) {
 
 void setupCrashHandlers(RedisModuleCtx *ctx) {
 	// if RedisModule_RegisterInfoFunc is available use it
-	// to report RedisGraph additional information in case of a crash
+	// to report query latency and, in case of a crash,
+	// RedisGraph additional information
 	// otherwise overwrite Redis signal handler
 
 	if(RedisModule_RegisterInfoFunc) {
@@ -351,8 +351,9 @@ static void _ExecutionPlanInit(OpBase *root) {
 	// If the ExecutionPlan associated with this op hasn't built a record pool yet, do so now.
 	_ExecutionPlan_InitRecordPool((ExecutionPlan *)root->plan);
 
-	// Initialize the operation if necessary.
-	if(root->init) root->init(root);
+	// Initialize the operation if necessary, a reset plan is initialized once.
+	if(root->init && !root->op_initialized) root->init(root);
+	root->op_initialized = true;
 
 	// Continue initializing downstream operations.
 	for(int i = 0; i < root->childCount; i++) {
@@ -376,13 +377,24 @@ ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan) {
 
 	ExecutionPlan_Init(plan);
 
-	Record r = NULL;
-	// Execute the root operation and free the processed Record until the data stream is depleted.
-	while((r = OpBase_Consume(plan->root)) != NULL) ExecutionPlan_ReturnRecord(r->owner, r);
+	RecordBatch batch;
+	/* Execute the root operation in batches and free the processed Records
+	 * until the data stream is depleted. */
+	while(OpBase_ConsumeBatch(plan->root, &batch) > 0) {
+		for(uint i = 0; i < batch.count; i++) {
+			Record r = batch.records[i];
+			ExecutionPlan_ReturnRecord(r->owner, r);
+		}
+	}
 
 	return QueryCtx_GetResultSet();
 }
 
+void ExecutionPlan_Reset(ExecutionPlan *plan) {
+	ASSERT(plan && plan->root);
+	OpBase_PropagateReset(plan->root);
+}
+
 //------------------------------------------------------------------------------
 // Execution plan draining
 //------------------------------------------------------------------------------
@@ -402,6 +414,8 @@ bool ExecutionPlan_Drained(ExecutionPlan *plan) {
 
 static void _ExecutionPlan_Drain(OpBase *root) {
 	root->consume = deplete_consume;
+	// Fall back to per-record consumption, which is now depleted.
+	root->consume_batch = NULL;
 	for(int i = 0; i < root->childCount; i++) {
 		_ExecutionPlan_Drain(root->children[i]);
 	}
@@ -435,9 +449,9 @@ int ExecutionPlan_DecRefCount(ExecutionPlan *plan) {
 static void _ExecutionPlan_InitProfiling(OpBase *root) {
 	root->profile = root->consume;
 	root->consume = OpBase_Profile;
-	root->stats = rm_malloc(sizeof(OpStats));
-	root->stats->profileExecTime = 0;
-	root->stats->profileRecordCount = 0;
+	root->profile_batch = root->consume_batch;
+	root->consume_batch = OpBase_ProfileBatch;
+	root->stats = rm_calloc(1, sizeof(OpStats));
 
 	if(root->childCount) {
 		for(int i = 0; i < root->childCount; i++) {
@@ -452,10 +466,12 @@ static void _ExecutionPlan_FinalizeProfiling(OpBase *root) {
 		for(int i = 0; i < root->childCount; i++) {
 			OpBase *child = root->children[i];
 			root->stats->profileExecTime -= child->stats->profileExecTime;
+			root->stats->profileBytesAllocated -= child->stats->profileBytesAllocated;
 			_ExecutionPlan_FinalizeProfiling(child);
 		}
 	}
 	root->stats->profileExecTime *= 1000;   // Milliseconds.
+	root->stats->profileMatrixTime *= 1000; // Milliseconds.
 }
 
 ResultSet *ExecutionPlan_Profile(ExecutionPlan *plan) {
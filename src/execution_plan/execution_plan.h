@@ -59,6 +59,10 @@ void ExecutionPlan_Init(ExecutionPlan *plan);
 /* Executes plan */
 ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan);
 
+/* Resets an executed plan, such that it can be executed again.
+ * Operations are not initialized again. */
+void ExecutionPlan_Reset(ExecutionPlan *plan);
+
 /* Checks if execution plan been drained */
 bool ExecutionPlan_Drained(ExecutionPlan *plan);
 
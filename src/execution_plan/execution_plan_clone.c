@@ -79,3 +79,18 @@ ExecutionPlan *ExecutionPlan_Clone(const ExecutionPlan *template) {
 	return clone;
 }
 
+
+/* Clones the op tree rooted at 'root' along with the ExecutionPlan segments it spans,
+ * unlike ExecutionPlan_Clone, 'root' may be part of a prepared ExecutionPlan.
+ * The returned ExecutionPlan is the segment of the cloned root. */
+ExecutionPlan *ExecutionPlan_CloneOpTree(const OpBase *root) {
+	ASSERT(root != NULL);
+	// Store the original AST pointer.
+	AST *master_ast = QueryCtx_GetAST();
+	OpBase *clone_root = _CloneOpTree(NULL, (OpBase *)root, NULL);
+	ExecutionPlan *clone = (ExecutionPlan *)clone_root->plan;
+	clone->root = clone_root;
+	// Restore the original AST pointer.
+	QueryCtx_SetAST(master_ast);
+	return clone;
+}
@@ -11,3 +11,6 @@
 /* Clones an execution plan */
 ExecutionPlan *ExecutionPlan_Clone(const ExecutionPlan *plan);
 
+
+/* Clones an op tree into a new execution plan, root may belong to a prepared plan */
+ExecutionPlan *ExecutionPlan_CloneOpTree(const OpBase *root);
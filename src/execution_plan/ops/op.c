@@ -39,12 +39,35 @@ void OpBase_Init(OpBase *op, OPType type, const char *name, fpInit init, fpConsu
 	op->clone = clone;
 	op->free = free;
 	op->profile = NULL;
+	op->consume_batch = NULL;
+	op->profile_batch = NULL;
+	op->depleted = false;
 }
 
 inline Record OpBase_Consume(OpBase *op) {
 	return op->consume(op);
 }
 
+// Fill batch by consuming op record by record.
+static uint _OpBase_ConsumeRecords(OpBase *op, RecordBatch *batch) {
+	uint count = 0;
+	/* Once depleted, op must not be consumed again
+	 * until it is reset, as it previously returned NULL. */
+	while(!op->depleted && count < RECORD_BATCH_CAP) {
+		Record r = OpBase_Consume(op);
+		if(r == NULL) op->depleted = true;
+		else batch->records[count++] = r;
+	}
+
+	batch->count = count;
+	return count;
+}
+
+uint OpBase_ConsumeBatch(OpBase *op, RecordBatch *batch) {
+	if(op->consume_batch) return op->consume_batch(op, batch);
+	return _OpBase_ConsumeRecords(op, batch);
+}
+
 int OpBase_Modifies(OpBase *op, const char *alias) {
 	if(!op->modifies) op->modifies = array_new(const char *, 1);
 	array_append(op->modifies, alias);
@@ -92,6 +115,7 @@ void OpBase_PropagateReset(OpBase *op) {
 		OpResult res = op->reset(op);
 		ASSERT(res == OP_OK);
 	}
+	op->depleted = false;
 	for(int i = 0; i < op->childCount; i++) OpBase_PropagateReset(op->children[i]);
 }
 
@@ -119,15 +143,43 @@ int OpBase_ToString(const OpBase *op, char *buff, uint buff_len) {
 
 Record OpBase_Profile(OpBase *op) {
 	double tic [2];
+	uint64_t alloced = rm_thread_alloced();
 	// Start timer.
 	simple_tic(tic);
 	Record r = op->profile(op);
 	// Stop timer and accumulate.
 	op->stats->profileExecTime += simple_toc(tic);
+	op->stats->profileBytesAllocated += rm_thread_alloced() - alloced;
 	if(r) op->stats->profileRecordCount++;
 	return r;
 }
 
+uint OpBase_ProfileBatch(OpBase *op, RecordBatch *batch) {
+	// Records consumed one by one are profiled by OpBase_Profile.
+	if(op->profile_batch == NULL) return _OpBase_ConsumeRecords(op, batch);
+
+	double tic [2];
+	uint64_t alloced = rm_thread_alloced();
+	// Start timer.
+	simple_tic(tic);
+	uint count = op->profile_batch(op, batch);
+	// Stop timer and accumulate.
+	op->stats->profileExecTime += simple_toc(tic);
+	op->stats->profileBytesAllocated += rm_thread_alloced() - alloced;
+	op->stats->profileRecordCount += count;
+	if(count > 0) op->stats->profileBatchCount++;
+	return count;
+}
+
+void OpBase_ProfileMatrix(OpBase *op, double elapsed, GrB_Matrix M) {
+	ASSERT(op->stats != NULL);
+	GrB_Index nnz;
+	GrB_Matrix_nvals(&nnz, M);
+	op->stats->profileMatrixTime += elapsed;
+	op->stats->profileMatrixNNZ += nnz;
+	op->stats->profileBatchCount++;
+}
+
 bool OpBase_IsWriter(OpBase *op) {
 	return op->writer;
 }
@@ -140,7 +192,16 @@ void OpBase_UpdateConsume(OpBase *op, fpConsume consume) {
 	else op->consume = consume;
 }
 
+void OpBase_UpdateConsumeBatch(OpBase *op, fpConsumeBatch consume_batch) {
+	ASSERT(op != NULL);
+	/* If Operation is profiled, update profiled function.
+	 * otherwise update batch consume function. */
+	if(op->stats != NULL) op->profile_batch = consume_batch;
+	else op->consume_batch = consume_batch;
+}
+
 inline Record OpBase_CreateRecord(const OpBase *op) {
+	if(op->stats) op->stats->profileRecordsCreated++;
 	return ExecutionPlan_BorrowRecord((struct ExecutionPlan *)op->plan);
 }
 
@@ -16,10 +16,15 @@
 
 #define OP_REQUIRE_NEW_DATA(opRes) (opRes & (OP_DEPLETED | OP_REFRESH)) > 0
 
+// Maximum number of records passed between operations in a single batch.
+#define RECORD_BATCH_CAP 1024
+
 typedef enum {
 	OPType_ALL_NODE_SCAN,
 	OPType_NODE_BY_LABEL_SCAN,
 	OPType_INDEX_SCAN,
+	OPType_COMPOSITE_INDEX_SCAN,
+	OPType_EDGE_INDEX_SCAN,
 	OPType_NODE_BY_ID_SEEK,
 	OPType_NODE_BY_LABEL_AND_ID_SCAN,
 	OPType_EXPAND_INTO,
@@ -51,6 +56,7 @@ typedef enum {
 	OPType_OR_APPLY_MULTIPLEXER,
 	OPType_AND_APPLY_MULTIPLEXER,
 	OPType_OPTIONAL,
+	OPType_GATHER,
 } OPType;
 
 typedef enum {
@@ -69,8 +75,8 @@ static const OPType PROJECT_OPS[] = {OPType_PROJECT, OPType_AGGREGATE};
 #define TRAVERSE_OP_COUNT 2
 static const OPType TRAVERSE_OPS[] = {OPType_CONDITIONAL_TRAVERSE, OPType_CONDITIONAL_VAR_LEN_TRAVERSE};
 
-#define SCAN_OP_COUNT 5
-static const OPType SCAN_OPS[] = {OPType_ALL_NODE_SCAN, OPType_NODE_BY_LABEL_SCAN, OPType_INDEX_SCAN, OPType_NODE_BY_ID_SEEK, OPType_NODE_BY_LABEL_AND_ID_SCAN};
+#define SCAN_OP_COUNT 6
+static const OPType SCAN_OPS[] = {OPType_ALL_NODE_SCAN, OPType_NODE_BY_LABEL_SCAN, OPType_INDEX_SCAN, OPType_COMPOSITE_INDEX_SCAN, OPType_NODE_BY_ID_SEEK, OPType_NODE_BY_LABEL_AND_ID_SCAN};
 
 #define BLACKLIST_OP_COUNT 2
 static const OPType FILTER_RECURSE_BLACKLIST[] = {OPType_APPLY, OPType_MERGE};
@@ -81,9 +87,17 @@ static const OPType EAGER_OPERATIONS[] = {OPType_AGGREGATE, OPType_CREATE, OPTyp
 struct OpBase;
 struct ExecutionPlan;
 
+// Records produced by a single batch consume call,
+// records are owned by the holder of the batch.
+typedef struct {
+	uint count;                         // Number of records in batch.
+	Record records[RECORD_BATCH_CAP];   // Batched records.
+} RecordBatch;
+
 typedef void (*fpFree)(struct OpBase *);
 typedef OpResult(*fpInit)(struct OpBase *);
 typedef Record(*fpConsume)(struct OpBase *);
+typedef uint(*fpConsumeBatch)(struct OpBase *, RecordBatch *);
 typedef OpResult(*fpReset)(struct OpBase *);
 typedef int (*fpToString)(const struct OpBase *, char *, uint);
 typedef struct OpBase *(*fpClone)(const struct ExecutionPlan *, const struct OpBase *);
@@ -92,6 +106,11 @@ typedef struct OpBase *(*fpClone)(const struct ExecutionPlan *, const struct OpB
 typedef struct {
 	int profileRecordCount;     // Number of records generated.
 	double profileExecTime;     // Operation total execution time in ms.
+	uint profileBatchCount;     // Number of batches generated.
+	uint profileRecordsCreated; // Number of records borrowed from the record pool.
+	int64_t profileBytesAllocated; // Number of bytes allocated.
+	double profileMatrixTime;   // Time spent evaluating matrices in ms.
+	uint64_t profileMatrixNNZ;  // Number of entries in evaluated matrices.
 }  OpStats;
 
 struct OpBase {
@@ -102,6 +121,9 @@ struct OpBase {
 	fpClone clone;              // Operation clone.
 	fpConsume consume;          // Produce next record.
 	fpConsume profile;          // Profiled version of consume.
+	fpConsumeBatch consume_batch; // Produce next batch of records, NULL if unsupported.
+	fpConsumeBatch profile_batch; // Profiled version of consume_batch.
+	bool depleted;              // Per-record consume returned NULL while batching.
 	fpToString toString;        // Operation string representation.
 	const char *name;           // Operation name.
 	int childCount;             // Number of children.
@@ -123,6 +145,17 @@ void OpBase_Free(OpBase *op);       // Free op.
 Record OpBase_Consume(OpBase *op);  // Consume op.
 Record OpBase_Profile(OpBase *op);  // Profile op.
 
+/* Consume a batch of records from op, returns number of records in batch.
+ * 0 indicates op is depleted, fewer than RECORD_BATCH_CAP records does not.
+ * Operations without a batch consume function are consumed record by record. */
+uint OpBase_ConsumeBatch(OpBase *op, RecordBatch *batch);
+uint OpBase_ProfileBatch(OpBase *op, RecordBatch *batch);  // Profile op batch.
+
+/* Accumulate the time a profiled op spent evaluating matrix M,
+ * along with the number of entries in M.
+ * Each evaluation counts as a batch, as it covers a batch of input records. */
+void OpBase_ProfileMatrix(OpBase *op, double elapsed, GrB_Matrix M);
+
 int OpBase_ToString(const OpBase *op, char *buff, uint buff_len);
 
 OpBase *OpBase_Clone(const struct ExecutionPlan *plan, const OpBase *op);
@@ -151,6 +184,9 @@ bool OpBase_IsWriter(OpBase *op);
 // Update operation consume function.
 void OpBase_UpdateConsume(OpBase *op, fpConsume consume);
 
+// Update operation batch consume function, NULL reverts to per-record consumption.
+void OpBase_UpdateConsumeBatch(OpBase *op, fpConsumeBatch consume_batch);
+
 // Creates a new record that will be populated during execution.
 Record OpBase_CreateRecord(const OpBase *op);
 
@@ -7,6 +7,8 @@
 #include "op_aggregate.h"
 #include "RG.h"
 #include "op_sort.h"
+#include "op_gather.h"
+#include "../../errors.h"
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
 #include "../../util/rmalloc.h"
@@ -38,24 +40,88 @@ static void _migrate_expressions(OpAggregate *op, AR_ExpNode **exps) {
 	op->key_count = array_len(op->key_exps);
 }
 
-/* Clone all aggregate expression templates to associate with a new Group. */
+/* Determine which aggregations are maintained as flat states. */
+static void _classify_aggregations(OpAggregate *op) {
+	op->flat = true;
+	op->state_types = rm_malloc(sizeof(AggregateStateType) * op->aggregate_count);
+	for(uint i = 0; i < op->aggregate_count; i++) {
+		op->state_types[i] = AggregateState_TypeOf(op->aggregate_exps[i]);
+		if(op->state_types[i] == AGG_STATE_NONE) op->flat = false;
+	}
+}
+
+/* Initialize a group builder, clone expressions if the builder is private to a thread. */
+static void _GroupBuilder_Init(OpAggregate *op, GroupBuilder *b, bool clone) {
+	b->group = NULL;
+	b->group_keys = NULL;
+	b->owns_exps = clone;
+	b->groups = GroupTable_New();
+	b->key_exps = rm_malloc(sizeof(AR_ExpNode *) * op->key_count);
+	b->arg_exps = rm_malloc(sizeof(AR_ExpNode *) * op->aggregate_count);
+
+	// Allocate memory for group keys if we have any non-aggregate expressions.
+	if(op->key_count) b->group_keys = rm_malloc(op->key_count * sizeof(SIValue));
+
+	for(uint i = 0; i < op->key_count; i++) {
+		AR_ExpNode *exp = op->key_exps[i];
+		b->key_exps[i] = (clone) ? AR_EXP_Clone(exp) : exp;
+	}
+
+	for(uint i = 0; i < op->aggregate_count; i++) {
+		b->arg_exps[i] = NULL;
+		if(op->state_types[i] == AGG_STATE_NONE) continue;
+		AR_ExpNode *arg = op->aggregate_exps[i]->op.children[0];
+		b->arg_exps[i] = (clone) ? AR_EXP_Clone(arg) : arg;
+	}
+}
+
+static void _GroupBuilder_Free(OpAggregate *op, GroupBuilder *b) {
+	if(b->groups) {
+		GroupTable_Free(b->groups);
+		b->groups = NULL;
+	}
+
+	if(b->owns_exps) {
+		for(uint i = 0; i < op->key_count; i++) AR_EXP_Free(b->key_exps[i]);
+		for(uint i = 0; i < op->aggregate_count; i++) {
+			if(b->arg_exps[i]) AR_EXP_Free(b->arg_exps[i]);
+		}
+	}
+
+	if(b->group_keys) {
+		rm_free(b->group_keys);
+		b->group_keys = NULL;
+	}
+
+	rm_free(b->key_exps);
+	rm_free(b->arg_exps);
+	b->key_exps = NULL;
+	b->arg_exps = NULL;
+	b->group = NULL;
+}
+
+/* Clone aggregate expression templates not maintained as flat states
+ * to associate with a new Group. */
 static inline AR_ExpNode **_build_aggregate_exps(OpAggregate *op) {
+	if(op->flat) return NULL;
+
 	AR_ExpNode **agg_exps = rm_malloc(op->aggregate_count * sizeof(AR_ExpNode *));
 
 	for(uint i = 0; i < op->aggregate_count; i++) {
-		agg_exps[i] = AR_EXP_Clone(op->aggregate_exps[i]);
+		agg_exps[i] = (op->state_types[i] == AGG_STATE_NONE) ?
+					  AR_EXP_Clone(op->aggregate_exps[i]) : NULL;
 	}
 
 	return agg_exps;
 }
 
 // build a new group key from the SIValue results of non-aggregate expressions
-static inline SIValue *_build_group_key(OpAggregate *op) {
+static inline SIValue *_build_group_key(OpAggregate *op, GroupBuilder *b) {
 	// TODO: might be expensive incase we're generating lots of groups
 	SIValue *group_keys = rm_malloc(sizeof(SIValue) * op->key_count);
 
 	for(uint i = 0; i < op->key_count; i++) {
-		SIValue key = SI_TransferOwnership(&op->group_keys[i]);
+		SIValue key = SI_TransferOwnership(&b->group_keys[i]);
 		SIValue_Persist(&key);
 		group_keys[i] = key;
 	}
@@ -63,25 +129,25 @@ static inline SIValue *_build_group_key(OpAggregate *op) {
 	return group_keys;
 }
 
-static Group *_CreateGroup(OpAggregate *op, Record r) {
+static Group *_CreateGroup(OpAggregate *op, GroupBuilder *b, Record r) {
 	// create a new group, clone group keys
-	SIValue *group_keys = _build_group_key(op);
+	SIValue *group_keys = _build_group_key(op, b);
 
 	// get a fresh copy of aggregation functions
 	AR_ExpNode **agg_exps = _build_aggregate_exps(op);
 
 	// There's no need to keep a reference to record if we're not sorting groups
 	Record cache_record = (op->should_cache_records) ? r : NULL;
-	op->group = NewGroup(group_keys, op->key_count, agg_exps,
+	b->group = NewGroup(group_keys, op->key_count, agg_exps,
 			op->aggregate_count, cache_record);
 
-	return op->group;
+	return b->group;
 }
 
-static void _ComputeGroupKey(OpAggregate *op, Record r) {
+static void _ComputeGroupKey(OpAggregate *op, GroupBuilder *b, Record r) {
 	for(uint i = 0; i < op->key_count; i++) {
-		AR_ExpNode *exp = op->key_exps[i];
-		op->group_keys[i] = AR_EXP_Evaluate(exp, r);
+		AR_ExpNode *exp = b->key_exps[i];
+		b->group_keys[i] = AR_EXP_Evaluate(exp, r);
 	}
 }
 
@@ -101,18 +167,18 @@ static XXH64_hash_t _HashCode(const SIValue *v, size_t n) {
 
 // retrieves group under which given record belongs to,
 // creates group if one doesn't exists
-static Group *_GetGroup(OpAggregate *op, Record r) {
+static Group *_GetGroup(OpAggregate *op, GroupBuilder *b, Record r) {
 	XXH64_hash_t hash;
 	bool free_key_exps = true;
 
 	// construct group key
-	_ComputeGroupKey(op, r);
+	_ComputeGroupKey(op, b, r);
 
 	// first group created
-	if(!op->group) {
-		op->group = _CreateGroup(op, r);
-		hash = _HashCode(op->group_keys, op->key_count);
-		CacheGroupAdd(op->groups, hash, op->group);
+	if(!b->group) {
+		hash = _HashCode(b->group_keys, op->key_count);
+		b->group = _CreateGroup(op, b, r);
+		GroupTable_Add(b->groups, hash, b->group);
 		// key expressions are owned by the new group and don't need to be freed
 		free_key_exps = false;
 		goto cleanup;
@@ -122,19 +188,19 @@ static Group *_GetGroup(OpAggregate *op, Record r) {
 	bool reuseLastAccessedGroup = true;
 	for(uint i = 0; reuseLastAccessedGroup && i < op->key_count; i++) {
 		reuseLastAccessedGroup =
-			(SIValue_Compare(op->group->keys[i], op->group_keys[i], NULL) == 0);
+			(SIValue_Compare(b->group->keys[i], b->group_keys[i], NULL) == 0);
 	}
 
 	// see if we can reuse last accessed group
 	if(reuseLastAccessedGroup) goto cleanup;
 
-	// can't reuse last accessed group, lookup group by identifier key
-	hash = _HashCode(op->group_keys, op->key_count);
-	op->group = CacheGroupGet(op->groups, hash);
-	if(!op->group) {
+	// can't reuse last accessed group, lookup group by key
+	hash = _HashCode(b->group_keys, op->key_count);
+	b->group = GroupTable_Get(b->groups, hash, b->group_keys);
+	if(!b->group) {
 		// Group does not exists, create it.
-		op->group = _CreateGroup(op, r);
-		CacheGroupAdd(op->groups, hash, op->group);
+		b->group = _CreateGroup(op, b, r);
+		GroupTable_Add(b->groups, hash, b->group);
 		// key expressions are owned by the new group and don't need to be freed
 		free_key_exps = false;
 	}
@@ -143,31 +209,114 @@ cleanup:
 	// free the keys that have been computed during this function
 	// if they have not been used to build a new group
 	if(free_key_exps) {
-		for(uint i = 0; i < op->key_count; i++) SIValue_Free(op->group_keys[i]);
+		for(uint i = 0; i < op->key_count; i++) SIValue_Free(b->group_keys[i]);
 	}
 
-	return op->group;
+	return b->group;
 }
 
-static void _aggregateRecord(OpAggregate *op, Record r) {
+static void _aggregateRecord(OpAggregate *op, GroupBuilder *b, Record r) {
 	// get group
-	Group *group = _GetGroup(op, r);
+	Group *group = _GetGroup(op, b, r);
 	ASSERT(group != NULL);
 
 	// aggregate group exps
 	for(uint i = 0; i < op->aggregate_count; i++) {
-		AR_ExpNode *exp = group->aggregationFunctions[i];
-		AR_EXP_Aggregate(exp, r);
+		AggregateStateType type = op->state_types[i];
+		if(type == AGG_STATE_NONE) {
+			AR_EXP_Aggregate(group->aggregationFunctions[i], r);
+			continue;
+		}
+
+		// flat aggregation, validate argument as the aggregate function would
+		SIValue v = AR_EXP_Evaluate(b->arg_exps[i], r);
+		SIType expected = op->aggregate_exps[i]->op.f->types[0];
+		if(!(SI_TYPE(v) & expected)) {
+			Error_SITypeMismatch(v, expected);
+			SIValue_Free(v);
+			ErrorCtx_RaiseRuntimeException(NULL);
+		}
+		AggregateState_Update(group->states + i, type, v);
+		SIValue_Free(v);
 	}
 
 	// free record
 	OpBase_DeleteRecord(r);
 }
 
+//------------------------------------------------------------------------------
+// Parallel pre-aggregation
+//------------------------------------------------------------------------------
+
+// creates a group builder private to a Gather worker
+static void *_NewPartial(void *arg) {
+	OpAggregate *op = (OpAggregate *)arg;
+	GroupBuilder *b = rm_malloc(sizeof(GroupBuilder));
+	_GroupBuilder_Init(op, b, true);
+	return b;
+}
+
+static void _FreePartials(OpAggregate *op) {
+	if(op->partials == NULL) return;
+	uint count = array_len(op->partials);
+	for(uint i = 0; i < count; i++) {
+		_GroupBuilder_Free(op, op->partials[i]);
+		rm_free(op->partials[i]);
+	}
+	array_free(op->partials);
+	op->partials = NULL;
+}
+
+// pre-aggregate batch within the thread owning the builder
+static void _ConsumePartial(void *arg, void *sink, RecordBatch *batch) {
+	OpAggregate *op = (OpAggregate *)arg;
+	GroupBuilder *b = (GroupBuilder *)sink;
+	for(uint i = 0; i < batch->count; i++) _aggregateRecord(op, b, batch->records[i]);
+}
+
+// combine the flat states of two groups sharing a key
+static void _MergeGroups(Group *dest, Group *src, void *ctx) {
+	OpAggregate *op = (OpAggregate *)ctx;
+	for(uint i = 0; i < op->aggregate_count; i++) {
+		AggregateState_Merge(dest->states + i, src->states + i, op->state_types[i]);
+	}
+}
+
+// pre-aggregation is possible when all aggregations can be merged
+// and aggregated records aren't retained
+static inline bool _PreAggregate(const OpAggregate *op) {
+	return (op->flat &&
+			!op->should_cache_records &&
+			op->op.childCount == 1 &&
+			op->op.children[0]->type == OPType_GATHER);
+}
+
+/* Have each thread executing Gather's pipeline aggregate into a private
+ * group table, then merge tables into the executing thread's table.
+ * Tables are merged partition by partition, such that merging touches a
+ * single partition of the destination table at a time. */
+static void _ParallelAggregate(OpAggregate *op) {
+	OpGather *gather = (OpGather *)op->op.children[0];
+	GatherSink sink = {.arg = op, .new_sink = _NewPartial, .consume = _ConsumePartial};
+
+	op->partials = array_new(GroupBuilder *, 1);
+	GatherOp_Drain(gather, &sink, &op->builder, (void ***)&op->partials);
+
+	uint count = array_len(op->partials);
+	for(uint p = 0; p < GROUP_TABLE_PARTITION_COUNT; p++) {
+		for(uint i = 0; i < count; i++) {
+			GroupTable_MergePartition(op->builder.groups, op->partials[i]->groups, p,
+									  _MergeGroups, op);
+		}
+	}
+
+	_FreePartials(op);
+}
+
 // returns a record populated with group data
 static Record _handoff(OpAggregate *op) {
-	Group *group;
-	if(!CacheGroupIterNext(op->group_iter, &group)) return NULL;
+	Group *group = GroupTableIterator_Next(&op->group_iter);
+	if(!group) return NULL;
 
 	Record r = OpBase_CreateRecord((OpBase *)op);
 
@@ -184,9 +333,11 @@ static Record _handoff(OpAggregate *op) {
 	// Compute the final value of all aggregating expressions and add to the Record.
 	for(uint i = 0; i < op->aggregate_count; i++) {
 		int rec_idx = op->record_offsets[i + op->key_count];
-		AR_ExpNode *exp = group->aggregationFunctions[i];
+		AggregateStateType type = op->state_types[i];
 
-		SIValue res = AR_EXP_Finalize(exp, r);
+		SIValue res;
+		if(type == AGG_STATE_NONE) res = AR_EXP_Finalize(group->aggregationFunctions[i], r);
+		else res = AggregateState_Finalize(group->states + i, type);
 		Record_AddScalar(r, rec_idx, res);
 	}
 
@@ -195,18 +346,16 @@ static Record _handoff(OpAggregate *op) {
 
 OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should_cache_records) {
 	OpAggregate *op = rm_malloc(sizeof(OpAggregate));
-	op->group = NULL;
-	op->group_iter = NULL;
-	op->group_keys = NULL;
-	op->groups = CacheGroupNew();
+	op->partials = NULL;
+	op->iterating = false;
 	op->should_cache_records = should_cache_records;
 
 	// Migrate each expression to the keys array or the aggregations array as appropriate.
 	_migrate_expressions(op, exps);
 	array_free(exps);
 
-	// Allocate memory for group keys if we have any non-aggregate expressions.
-	if(op->key_count) op->group_keys = rm_malloc(op->key_count * sizeof(SIValue));
+	_classify_aggregations(op);
+	_GroupBuilder_Init(op, &op->builder, false);
 
 	OpBase_Init((OpBase *)op, OPType_AGGREGATE, "Aggregate", NULL, AggregateConsume,
 				AggregateReset, NULL, AggregateClone, AggregateFree, false, plan);
@@ -230,35 +379,39 @@ OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should
 
 static Record AggregateConsume(OpBase *opBase) {
 	OpAggregate *op = (OpAggregate *)opBase;
-	if(op->group_iter) return _handoff(op);
+	if(op->iterating) return _handoff(op);
 
 	Record r;
 	if(op->op.childCount == 0) {
 		/* RETURN max (1)
 		 * Create a 'fake' record. */
 		r = OpBase_CreateRecord(opBase);
-		_aggregateRecord(op, r);
+		_aggregateRecord(op, &op->builder, r);
+	} else if(_PreAggregate(op)) {
+		_ParallelAggregate(op);
 	} else {
+		RecordBatch batch;
 		OpBase *child = op->op.children[0];
-		while((r = OpBase_Consume(child))) _aggregateRecord(op, r);
+		while(OpBase_ConsumeBatch(child, &batch) > 0) {
+			for(uint i = 0; i < batch.count; i++) {
+				_aggregateRecord(op, &op->builder, batch.records[i]);
+			}
+		}
 	}
 
-	op->group_iter = CacheGroupIter(op->groups);
+	op->iterating = true;
+	GroupTable_Iter(op->builder.groups, &op->group_iter);
 	return _handoff(op);
 }
 
 static OpResult AggregateReset(OpBase *opBase) {
 	OpAggregate *op = (OpAggregate *)opBase;
 
-	FreeGroupCache(op->groups);
-	op->groups = CacheGroupNew();
-
-	if(op->group_iter) {
-		CacheGroupIterator_Free(op->group_iter);
-		op->group_iter = NULL;
-	}
-
-	op->group = NULL;
+	_FreePartials(op);
+	GroupTable_Free(op->builder.groups);
+	op->builder.groups = GroupTable_New();
+	op->builder.group = NULL;
+	op->iterating = false;
 
 	return OP_OK;
 }
@@ -280,15 +433,8 @@ static void AggregateFree(OpBase *opBase) {
 	OpAggregate *op = (OpAggregate *)opBase;
 	if(!op) return;
 
-	if(op->group_keys) {
-		rm_free(op->group_keys);
-		op->group_keys = NULL;
-	}
-
-	if(op->group_iter) {
-		CacheGroupIterator_Free(op->group_iter);
-		op->group_iter = NULL;
-	}
+	_FreePartials(op);
+	if(op->builder.key_exps) _GroupBuilder_Free(op, &op->builder);
 
 	if(op->key_exps) {
 		for(uint i = 0; i < op->key_count; i ++) AR_EXP_Free(op->key_exps[i]);
@@ -302,9 +448,9 @@ static void AggregateFree(OpBase *opBase) {
 		op->aggregate_exps = NULL;
 	}
 
-	if(op->groups) {
-		FreeGroupCache(op->groups);
-		op->groups = NULL;
+	if(op->state_types) {
+		rm_free(op->state_types);
+		op->state_types = NULL;
 	}
 
 	if(op->record_offsets) {
@@ -312,6 +458,6 @@ static void AggregateFree(OpBase *opBase) {
 		op->record_offsets = NULL;
 	}
 
-	op->group = NULL;
+	op->iterating = false;
 }
 
@@ -8,22 +8,36 @@
 
 #include "op.h"
 #include "../execution_plan.h"
-#include "../../grouping/group_cache.h"
+#include "../../grouping/group_table.h"
+#include "../../grouping/aggregate_state.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+/* Groups records, aggregating the records of each group.
+ * When fed by a Gather operation, each thread pre-aggregates the records it
+ * produces into a private builder, builders are merged once Gather is depleted. */
+typedef struct {
+	GroupTable *groups;                 /* Groups built so far. */
+	Group *group;                       /* Last accessed group. */
+	SIValue *group_keys;                /* Array of values that represent a key associated with a Group of aggregations. */
+	AR_ExpNode **key_exps;              /* Expressions used to calculate the group key. */
+	AR_ExpNode **arg_exps;              /* Arguments of flat aggregations, NULL for other aggregations. */
+	bool owns_exps;                     /* Expressions are private clones. */
+} GroupBuilder;
+
 typedef struct {
 	OpBase op;
 	uint *record_offsets;               /* Record IDs for key and aggregate exps. */
 	AR_ExpNode **key_exps;              /* Array of expressions used to calculate the group key. */
 	AR_ExpNode **aggregate_exps;        /* Array of expressions that aggregate data for each key. */
-	rax *groups;                        /* Map of all groups built by this operation. */
-	Group *group;                       /* Last accessed group. */
-	SIValue *group_keys;                /* Array of values that represent a key associated with a Group of aggregations. */
-	CacheGroupIterator *group_iter;     /* Iterator for walking all groups. */
+	AggregateStateType *state_types;    /* Flat state of each aggregate exp, AGG_STATE_NONE if evaluated by expression. */
+	bool flat;                          /* All aggregations are maintained as flat states. */
+	GroupBuilder builder;               /* Groups built by the executing thread. */
+	GroupBuilder **partials;            /* Groups pre-aggregated by parallel workers. */
+	GroupTableIterator group_iter;      /* Iterator for walking all groups. */
+	bool iterating;                     /* Groups have been built and are being handed off. */
 	uint key_count;                     /* Number of key expressions. */
 	uint aggregate_count;               /* Number of aggregating expressions. */
 	bool should_cache_records;          /* Records should be cached if we're sorting after aggregation. */
 } OpAggregate;
 
 OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should_cache_records);
-
@@ -12,6 +12,7 @@
 static OpResult AllNodeScanInit(OpBase *opBase);
 static Record AllNodeScanConsume(OpBase *opBase);
 static Record AllNodeScanConsumeFromChild(OpBase *opBase);
+static uint AllNodeScanConsumeBatch(OpBase *opBase, RecordBatch *batch);
 static OpResult AllNodeScanReset(OpBase *opBase);
 static OpBase *AllNodeScanClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void AllNodeScanFree(OpBase *opBase);
@@ -34,10 +35,20 @@ OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias) {
 	return (OpBase *)op;
 }
 
+void AllNodeScanOp_SetRange(AllNodeScan *op, NodeID start, NodeID end) {
+	ASSERT(op->op.childCount == 0);
+	if(op->iter) DataBlockIterator_Free(op->iter);
+	op->iter = Graph_ScanNodesRange(QueryCtx_GetGraph(), start, end);
+}
+
 static OpResult AllNodeScanInit(OpBase *opBase) {
 	AllNodeScan *op = (AllNodeScan *)opBase;
-	if(opBase->childCount > 0) OpBase_UpdateConsume(opBase, AllNodeScanConsumeFromChild);
-	else op->iter = Graph_ScanNodes(QueryCtx_GetGraph());
+	if(opBase->childCount > 0) {
+		OpBase_UpdateConsume(opBase, AllNodeScanConsumeFromChild);
+	} else {
+		op->iter = Graph_ScanNodes(QueryCtx_GetGraph());
+		OpBase_UpdateConsumeBatch(opBase, AllNodeScanConsumeBatch);
+	}
 	return OP_OK;
 }
 
@@ -89,9 +100,31 @@ static Record AllNodeScanConsume(OpBase *opBase) {
 	return r;
 }
 
+static uint AllNodeScanConsumeBatch(OpBase *opBase, RecordBatch *batch) {
+	AllNodeScan *op = (AllNodeScan *)opBase;
+
+	uint count = 0;
+	Node n = GE_NEW_NODE();
+	while(count < RECORD_BATCH_CAP) {
+		n.entity = (Entity *)DataBlockIterator_Next(op->iter, &n.id);
+		if(n.entity == NULL) break;
+
+		Record r = OpBase_CreateRecord(opBase);
+		Record_AddNode(r, op->nodeRecIdx, n);
+		batch->records[count++] = r;
+	}
+
+	batch->count = count;
+	return count;
+}
+
 static OpResult AllNodeScanReset(OpBase *op) {
 	AllNodeScan *allNodeScan = (AllNodeScan *)op;
 	if(allNodeScan->iter) DataBlockIterator_Reset(allNodeScan->iter);
+	if(allNodeScan->child_record) {
+		OpBase_DeleteRecord(allNodeScan->child_record); // Free old record.
+		allNodeScan->child_record = NULL;
+	}
 	return OP_OK;
 }
 
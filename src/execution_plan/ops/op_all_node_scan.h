@@ -25,3 +25,7 @@ typedef struct {
 
 OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias);
 
+/* Restrict scan to nodes with an ID within [start, end),
+ * scanning restarts from the beginning of the new range. */
+void AllNodeScanOp_SetRange(AllNodeScan *op, NodeID start, NodeID end);
+
@@ -0,0 +1,244 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "op_composite_index_scan.h"
+#include "../../query_ctx.h"
+#include "shared/print_functions.h"
+
+// forward declarations
+static OpResult CompositeIndexScanInit(OpBase *opBase);
+static Record CompositeIndexScanConsume(OpBase *opBase);
+static Record CompositeIndexScanConsumeFromChild(OpBase *opBase);
+static OpResult CompositeIndexScanReset(OpBase *opBase);
+static void CompositeIndexScanFree(OpBase *opBase);
+
+static int CompositeIndexScanToString(const OpBase *ctx, char *buf,
+		uint buf_len) {
+	CompositeIndexScan *op = (CompositeIndexScan *)ctx;
+	return ScanToString(ctx, buf, buf_len, op->n.alias, op->n.label);
+}
+
+OpBase *NewCompositeIndexScanOp(const ExecutionPlan *plan, Graph *g,
+		NodeScanCtx n, CompositeIndex *idx, AR_ExpNode **eq, AR_ExpNode *min,
+		bool include_min, AR_ExpNode *max, bool include_max,
+		FT_FilterNode *filter, bool covering) {
+	// validate inputs
+	ASSERT(g      != NULL);
+	ASSERT(eq     != NULL);
+	ASSERT(idx    != NULL);
+	ASSERT(plan   != NULL);
+	ASSERT(filter != NULL);
+
+	CompositeIndexScan *op = rm_malloc(sizeof(CompositeIndexScan));
+	op->g             =  g;
+	op->n             =  n;
+	op->eq            =  eq;
+	op->idx           =  idx;
+	op->min           =  min;
+	op->max           =  max;
+	op->iter          =  NULL;
+	op->filter        =  filter;
+	op->verify        =  false;
+	op->rebuild       =  false;
+	op->covering      =  covering;
+	op->include_min   =  include_min;
+	op->include_max   =  include_max;
+	op->child_record  =  NULL;
+
+	// Set our Op operations
+	OpBase_Init((OpBase *)op, OPType_COMPOSITE_INDEX_SCAN,
+			covering ? "Covering Index Scan" : "Composite Index Scan",
+			CompositeIndexScanInit, CompositeIndexScanConsume,
+			CompositeIndexScanReset, CompositeIndexScanToString, NULL,
+			CompositeIndexScanFree, false, plan);
+
+	op->nodeRecIdx = OpBase_Modifies((OpBase *)op, n.alias);
+	return (OpBase *)op;
+}
+
+static OpResult CompositeIndexScanInit(OpBase *opBase) {
+	CompositeIndexScan *op = (CompositeIndexScan *)opBase;
+
+	if(opBase->childCount > 0) {
+		// scan values which refer to other entities
+		// must be re-evaluated for every input record
+		rax *entities = raxNew();
+		uint eq_count = array_len(op->eq);
+		for(uint i = 0; i < eq_count; i++) {
+			AR_EXP_CollectEntities(op->eq[i], entities);
+		}
+		if(op->min) AR_EXP_CollectEntities(op->min, entities);
+		if(op->max) AR_EXP_CollectEntities(op->max, entities);
+		op->rebuild = raxSize(entities) > 0;
+		raxFree(entities);
+
+		OpBase_UpdateConsume(opBase, CompositeIndexScanConsumeFromChild);
+	}
+
+	// resolve label ID now if it is still unknown
+	if(op->n.label_id == GRAPH_UNKNOWN_LABEL) {
+		GraphContext *gc = QueryCtx_GetGraphCtx();
+		Schema *schema = GraphContext_GetSchema(gc, op->n.label, SCHEMA_NODE);
+		ASSERT(schema != NULL);
+		op->n.label_id = schema->id;
+	}
+
+	return OP_OK;
+}
+
+// evaluate scan values against record and create an iterator
+static void _BuildIterator(CompositeIndexScan *op, Record r) {
+	uint eq_count = array_len(op->eq);
+	SIValue eq[eq_count];
+	SIValue min = SI_NullVal();
+	SIValue max = SI_NullVal();
+
+	for(uint i = 0; i < eq_count; i++) eq[i] = AR_EXP_Evaluate(op->eq[i], r);
+	if(op->min) min = AR_EXP_Evaluate(op->min, r);
+	if(op->max) max = AR_EXP_Evaluate(op->max, r);
+
+	bool supported;
+	op->iter = CompositeIndex_Scan(op->idx, eq, eq_count,
+			op->min ? &min : NULL, op->include_min,
+			op->max ? &max : NULL, op->include_max, &supported);
+	op->verify = !supported;
+
+	// index scan keeps its own copy of the encoded values
+	for(uint i = 0; i < eq_count; i++) SIValue_Free(eq[i]);
+	SIValue_Free(min);
+	SIValue_Free(max);
+}
+
+// populate the Record with matched node
+// returns false if node didn't pass verification
+static inline bool _UpdateRecord(CompositeIndexScan *op, Record r) {
+	NodeID node_id;
+	Entity *covered;
+
+	while(CompositeIndexIter_Next(op->iter, &node_id, &covered)) {
+		Node n = GE_NEW_LABELED_NODE(op->n.label, op->n.label_id);
+		if(op->covering) {
+			// answer query from the index's copy of node properties
+			n.id = node_id;
+			n.entity = covered;
+		} else {
+			int res = Graph_GetNode(op->g, node_id, &n);
+			ASSERT(res != 0);
+		}
+		Record_AddNode(r, op->nodeRecIdx, n);
+
+		// scan was widened, verify match
+		if(!op->verify ||
+		   FilterTree_applyFilters(op->filter, r) == FILTER_PASS) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static Record CompositeIndexScanConsumeFromChild(OpBase *opBase) {
+	CompositeIndexScan *op = (CompositeIndexScan *)opBase;
+
+	while(true) {
+		// pull from index
+		if(op->child_record != NULL && _UpdateRecord(op, op->child_record)) {
+			// clone the held Record, as it will be freed upstream
+			return OpBase_CloneRecord(op->child_record);
+		}
+
+		// index depleted, free input record
+		if(op->child_record != NULL) {
+			OpBase_DeleteRecord(op->child_record);
+			op->child_record = NULL;
+		}
+
+		// pull from child
+		op->child_record = OpBase_Consume(op->op.children[0]);
+		if(op->child_record == NULL) return NULL; // depleted
+
+		// reset index iterator
+		if(op->rebuild && op->iter != NULL) {
+			CompositeIndexIter_Free(op->iter);
+			op->iter = NULL;
+		}
+
+		if(op->iter == NULL) _BuildIterator(op, op->child_record);
+		else CompositeIndexIter_Reset(op->iter);
+	}
+}
+
+static Record CompositeIndexScanConsume(OpBase *opBase) {
+	CompositeIndexScan *op = (CompositeIndexScan *)opBase;
+
+	Record r = OpBase_CreateRecord((OpBase *)op);
+
+	// create iterator on first call
+	if(op->iter == NULL) _BuildIterator(op, r);
+
+	if(!_UpdateRecord(op, r)) {
+		OpBase_DeleteRecord(r);
+		return NULL;
+	}
+
+	return r;
+}
+
+static OpResult CompositeIndexScanReset(OpBase *opBase) {
+	CompositeIndexScan *op = (CompositeIndexScan *)opBase;
+
+	if(op->child_record != NULL) {
+		OpBase_DeleteRecord(op->child_record);
+		op->child_record = NULL;
+	}
+
+	if(op->iter == NULL) return OP_OK;
+
+	if(op->rebuild) {
+		CompositeIndexIter_Free(op->iter);
+		op->iter = NULL;
+	} else {
+		CompositeIndexIter_Reset(op->iter);
+	}
+
+	return OP_OK;
+}
+
+static void CompositeIndexScanFree(OpBase *opBase) {
+	CompositeIndexScan *op = (CompositeIndexScan *)opBase;
+	if(op->iter) {
+		CompositeIndexIter_Free(op->iter);
+		op->iter = NULL;
+	}
+
+	if(op->child_record) {
+		OpBase_DeleteRecord(op->child_record);
+		op->child_record = NULL;
+	}
+
+	if(op->eq) {
+		uint eq_count = array_len(op->eq);
+		for(uint i = 0; i < eq_count; i++) AR_EXP_Free(op->eq[i]);
+		array_free(op->eq);
+		op->eq = NULL;
+	}
+
+	if(op->min) {
+		AR_EXP_Free(op->min);
+		op->min = NULL;
+	}
+
+	if(op->max) {
+		AR_EXP_Free(op->max);
+		op->max = NULL;
+	}
+
+	if(op->filter) {
+		FilterTree_Free(op->filter);
+		op->filter = NULL;
+	}
+}
+
@@ -0,0 +1,46 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "op.h"
+#include "../execution_plan.h"
+#include "../../graph/graph.h"
+#include "../../index/composite_index.h"
+#include "../../filter_tree/filter_tree.h"
+#include "../../arithmetic/arithmetic_expression.h"
+#include "shared/scan_functions.h"
+
+// CompositeIndexScan resolves equality predicates on a prefix of a composite
+// index key fields, optionally followed by a range on the next key field
+// when 'covering' is set, matched nodes are populated from the index's copy
+// of their properties, avoiding any access to the nodes themselves
+typedef struct {
+	OpBase op;
+	Graph *g;
+	CompositeIndex *idx;         // index to scan
+	NodeScanCtx n;               // label data of node being scanned
+	uint nodeRecIdx;             // index of the node being scanned in the Record
+	bool covering;               // index holds every property accessed by the query
+	AR_ExpNode **eq;             // values of leading key fields
+	AR_ExpNode *min;             // lower bound of next key field, NULL if unbounded
+	AR_ExpNode *max;             // upper bound of next key field, NULL if unbounded
+	bool include_min;            // lower bound is inclusive
+	bool include_max;            // upper bound is inclusive
+	FT_FilterNode *filter;       // predicates resolved by the scan
+	bool verify;                 // scan was widened, matches must pass 'filter'
+	bool rebuild;                // values depend on input record, rescan per record
+	CompositeIndexIter *iter;    // iterator over matching nodes
+	Record child_record;         // the Record this op acts on if it is not a tap
+} CompositeIndexScan;
+
+// creates a new CompositeIndexScan operation
+// takes ownership over 'eq', 'min', 'max' and 'filter'
+OpBase *NewCompositeIndexScanOp(const ExecutionPlan *plan, Graph *g,
+		NodeScanCtx n, CompositeIndex *idx, AR_ExpNode **eq, AR_ExpNode *min,
+		bool include_min, AR_ExpNode *max, bool include_max,
+		FT_FilterNode *filter, bool covering);
+
@@ -12,6 +12,8 @@
 #include "../../graph/graphcontext.h"
 #include "../../algorithms/all_paths.h"
 #include "../../algorithms/all_neighbors.h"
+#include "../../algorithms/reachable_nodes.h"
+#include "../../configuration/config.h"
 #include "../../query_ctx.h"
 
 /* Forward declarations. */
@@ -98,11 +100,13 @@ OpBase *NewCondVarLenTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicEx
 	op->g                  =  g;
 	op->r                  =  NULL;
 	op->M                  =  GrB_NULL;
+	op->MT                 =  GrB_NULL;
 	op->ae                 =  ae;
 	op->ft                 =  NULL;
 	op->expandInto         =  false;
 	op->allPathsCtx        =  NULL;
 	op->collect_paths      =  true;
+	op->reachable_only     =  false;
 	op->allNeighborsCtx    =  NULL;
 	op->edgeRelationTypes  =  NULL;
 
@@ -125,6 +129,43 @@ OpBase *NewCondVarLenTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicEx
 	return (OpBase *)op;
 }
 
+// returns true if op's output is consumed in a way which is insensitive
+// to duplicate records, in which case each destination can be produced once
+// this is the case when op is followed by a DISTINCT operation, or when op
+// resides within an apply branch which only checks for the existence of
+// a record, with only record-to-record operations in between
+static bool _DuplicateInsensitive(const OpBase *op) {
+	const OpBase *child = op;
+	const OpBase *parent = op->parent;
+
+	while(parent != NULL) {
+		switch(parent->type) {
+			case OPType_DISTINCT:
+				return true;
+			case OPType_SEMI_APPLY:
+			case OPType_ANTI_SEMI_APPLY:
+			case OPType_OR_APPLY_MULTIPLEXER:
+			case OPType_AND_APPLY_MULTIPLEXER:
+				// the first child is the bound branch, whose records are emitted
+				return parent->children[0] != child;
+			case OPType_FILTER:
+			case OPType_PROJECT:
+			case OPType_EXPAND_INTO:
+			case OPType_CONDITIONAL_TRAVERSE:
+			case OPType_CONDITIONAL_VAR_LEN_TRAVERSE:
+			case OPType_CONDITIONAL_VAR_LEN_TRAVERSE_EXPAND_INTO:
+				// duplicate input records map to duplicate output records
+				break;
+			default:
+				return false;
+		}
+		child = parent;
+		parent = parent->parent;
+	}
+
+	return false;
+}
+
 static OpResult CondVarLenTraverseInit(OpBase *opBase) {
 	CondVarLenTraverse *op = (CondVarLenTraverse *)opBase;
 
@@ -169,19 +210,42 @@ static OpResult CondVarLenTraverseInit(OpBase *opBase) {
 		ASSERT(op->ae->type == AL_OPERAND);
 		op->collect_paths = false;
 		OpBase_UpdateConsume(opBase, CondVarLenTraverseOptimizedConsume);
+
+		// in case destinations need not be repeated per path
+		// compute the reachable set using a BFS over matrix frontiers
+		// the reachable set of walks and paths only agree
+		// when at most a single hop is required
+		op->reachable_only = (op->minHops <= 1 && _DuplicateInsensitive(opBase));
 	}
 
 	return OP_OK;
 }
 
+// retrieve the transpose of the traversed matrix if it is maintained
+static GrB_Matrix _TransposedMatrix(CondVarLenTraverse *op) {
+	bool maintain_transpose;
+	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
+	if(!maintain_transpose || op->edgeRelationCount != 1) return GrB_NULL;
+
+	int rel_id = op->edgeRelationTypes[0];
+	if(op->traverseDir == GRAPH_EDGE_DIR_OUTGOING) {
+		return Graph_GetTransposedRelationMatrix(op->g, rel_id);
+	}
+	return Graph_GetRelationMatrix(op->g, rel_id);
+}
+
+static inline EntityID _NextDestination(CondVarLenTraverse *op) {
+	if(op->reachable_only) return ReachableNodesCtx_NextNode(op->reachableCtx);
+	return AllNeighborsCtx_NextNeighbor(op->allNeighborsCtx);
+}
+
 static Record CondVarLenTraverseOptimizedConsume(OpBase *opBase) {
 	CondVarLenTraverse  *op     = (CondVarLenTraverse *)opBase;
 	OpBase              *child  =  op->op.children[0];
 	Node                dest    =  GE_NEW_NODE();
 	EntityID            dest_id =  INVALID_ENTITY_ID;
 
-	while ((dest_id = AllNeighborsCtx_NextNeighbor(op->allNeighborsCtx)) ==
-			INVALID_ENTITY_ID) {
+	while ((dest_id = _NextDestination(op)) == INVALID_ENTITY_ID) {
 		Record childRecord = OpBase_Consume(child);
 		if(!childRecord) return NULL;
 
@@ -209,9 +273,18 @@ static Record CondVarLenTraverseOptimizedConsume(OpBase *opBase) {
 			if(op->edgeRelationCount == 0 && op->minHops > 0) return NULL;
 
 			op->M = op->ae->operand.matrix;
+			if(op->reachable_only) op->MT = _TransposedMatrix(op);
 		}
 
-		if(op->allNeighborsCtx == NULL) {
+		if(op->reachable_only) {
+			if(op->reachableCtx == NULL) {
+				op->reachableCtx = ReachableNodesCtx_New(srcNode->id, op->M,
+						op->MT, op->minHops, op->maxHops);
+			} else {
+				ReachableNodesCtx_Reset(op->reachableCtx, srcNode->id, op->M,
+						op->MT, op->minHops, op->maxHops);
+			}
+		} else if(op->allNeighborsCtx == NULL) {
 			op->allNeighborsCtx = AllNeighborsCtx_New(srcNode->id, op->M,
 					op->minHops, op->maxHops);
 		} else {
@@ -309,6 +382,11 @@ static OpResult CondVarLenTraverseReset(OpBase *ctx) {
 			AllPathsCtx_Free(op->allPathsCtx);
 			op->allPathsCtx = NULL;
 		}
+	} else if(op->reachable_only) {
+		if(op->reachableCtx) {
+			ReachableNodesCtx_Free(op->reachableCtx);
+			op->reachableCtx = NULL;
+		}
 	} else {
 		if(op->allNeighborsCtx) {
 			AllNeighborsCtx_Free(op->allNeighborsCtx);
@@ -350,6 +428,11 @@ static void CondVarLenTraverseFree(OpBase *ctx) {
 			AllPathsCtx_Free(op->allPathsCtx);
 			op->allPathsCtx = NULL;
 		}
+	} else if(op->reachable_only) {
+		if(op->reachableCtx) {
+			ReachableNodesCtx_Free(op->reachableCtx);
+			op->reachableCtx = NULL;
+		}
 	} else {
 		if(op->allNeighborsCtx) {
 			AllNeighborsCtx_Free(op->allNeighborsCtx);
@@ -18,6 +18,7 @@ typedef struct {
 	Graph *g;
 	Record r;
 	GrB_Matrix M;                          /* Traversed matrix if using the SimpleConsume routine. */
+	GrB_Matrix MT;                         /* Transpose of M if available, used for reachability traversals. */
 	int edgesIdx;                          /* Edges set by operation. */
 	int srcNodeIdx;                        /* Node set by operation. */
 	int destNodeIdx;                       /* Node set by operation. */
@@ -31,8 +32,10 @@ typedef struct {
 	union {
 		AllPathsCtx *allPathsCtx;          /* Context for collecting all paths. */
 		AllNeighborsCtx *allNeighborsCtx;  /* Context for collecting all neighbors . */
+		ReachableNodesCtx *reachableCtx;   /* Context for collecting distinct reachable nodes. */
 	};
 	bool collect_paths;                    /* Whether we must populate the entire path. */
+	bool reachable_only;                   /* Whether each reachable destination is produced once. */
 	GRAPH_EDGE_DIR traverseDir;            /* Traverse direction. */
 } CondVarLenTraverse;
 
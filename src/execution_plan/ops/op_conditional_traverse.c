@@ -7,11 +7,24 @@
 #include "op_conditional_traverse.h"
 #include "RG.h"
 #include "shared/print_functions.h"
+#include "shared/cardinality_functions.h"
 #include "../../query_ctx.h"
+#include "../../util/simple_timer.h"
 
-// default number of records to accumulate before traversing
+// initial number of records to accumulate before traversing
 #define BATCH_SIZE 16
 
+// maximum number of records to accumulate before traversing
+#define BATCH_SIZE_MAX 4096
+
+// number of traversed tuples a single batch should produce
+// batches grow geometrically as long as their output stays below this target
+#define BATCH_TUPLES_TARGET 65536
+
+// number of evaluations a large input with a known cardinality is split into
+// by the initial batch size
+#define BATCH_INITIAL_EVALS 64
+
 /* Forward declarations. */
 static OpResult CondTraverseInit(OpBase *opBase);
 static Record CondTraverseConsume(OpBase *opBase);
@@ -61,7 +74,11 @@ void _traverse(OpCondTraverse *op) {
 	_populate_filter_matrix(op);
 
 	// Evaluate expression.
+	double tic[2];
+	OpBase *base = (OpBase *)op;
+	if(base->stats) simple_tic(tic);
 	AlgebraicExpression_Eval(op->ae, op->M);
+	if(base->stats) OpBase_ProfileMatrix(base, simple_toc(tic), op->M);
 
 	if(op->iter == NULL) GxB_MatrixTupleIter_new(&op->iter, op->M);
 	else GxB_MatrixTupleIter_reuse(op->iter, op->M);
@@ -82,7 +99,8 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 	op->record_count = 0;
 	op->edge_ctx = NULL;
 	op->dest_label = NULL;
-	op->record_cap = BATCH_SIZE;
+	op->record_cap = UNLIMITED;
+	op->batch_size = BATCH_SIZE;
 	op->dest_label_id = GRAPH_NO_LABEL;
 
 	// Set our Op operations
@@ -113,14 +131,47 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 	return (OpBase *)op;
 }
 
+/* Determine the number of records to accumulate for the next traversal
+ * according to the fan-out observed in the last traversal.
+ * Batch size doubles as long as the expected number of traversed tuples
+ * is below BATCH_TUPLES_TARGET, and shrinks once it's exceeded. */
+static void _UpdateBatchSize(OpCondTraverse *op) {
+	GrB_Index nvals;
+	GrB_Matrix_nvals(&nvals, op->M);
+
+	// Average number of destinations per source, rounded up.
+	uint64_t fan_out = (nvals + op->record_count - 1) / op->record_count;
+	uint64_t target = BATCH_TUPLES_TARGET / MAX(fan_out, 1);
+	uint64_t batch_size = MIN((uint64_t)op->batch_size * 2, target);
+
+	op->batch_size = MAX(MIN(batch_size, op->record_cap), 1);
+}
+
 static OpResult CondTraverseInit(OpBase *opBase) {
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
 	// Create 'records' with this Init function as 'record_cap'
 	// might be set during optimization time (applyLimit)
-	// If cap greater than BATCH_SIZE is specified,
-	// use BATCH_SIZE as the value.
-	if(op->record_cap > BATCH_SIZE) op->record_cap = BATCH_SIZE;
+	// If cap greater than BATCH_SIZE_MAX is specified,
+	// use BATCH_SIZE_MAX as the value.
+	bool limited = (op->record_cap != UNLIMITED);
+	if(op->record_cap > BATCH_SIZE_MAX) op->record_cap = BATCH_SIZE_MAX;
 	op->records = rm_calloc(op->record_cap, sizeof(Record));
+
+	// A limited query might be satisfied by its first few sources,
+	// start small and grow according to the observed fan-out only.
+	// Otherwise start with batches large enough to cover a large input
+	// in a bounded number of evaluations, as long as the first evaluation
+	// is expected to stay within BATCH_TUPLES_TARGET.
+	uint64_t batch_size = BATCH_SIZE;
+	uint64_t estimate = (limited) ? CARDINALITY_UNKNOWN :
+		EstimateCardinality(opBase->children[0], op->graph);
+	if(estimate != CARDINALITY_UNKNOWN) {
+		uint64_t fan_out = EstimateTraverseFanOut(opBase, op->graph);
+		batch_size = MIN(estimate / BATCH_INITIAL_EVALS,
+				BATCH_TUPLES_TARGET / MAX(fan_out, 1));
+		batch_size = MAX(batch_size, BATCH_SIZE);
+	}
+	op->batch_size = MIN(batch_size, op->record_cap);
 	return OP_OK;
 }
 
@@ -152,7 +203,7 @@ static Record CondTraverseConsume(OpBase *opBase) {
 		for(uint i = 0; i < op->record_count; i++) OpBase_DeleteRecord(op->records[i]);
 
 		// Ask child operations for data.
-		for(op->record_count = 0; op->record_count < op->record_cap; op->record_count++) {
+		for(op->record_count = 0; op->record_count < op->batch_size; op->record_count++) {
 			Record childRecord = OpBase_Consume(child);
 			// If the Record is NULL, the child has been depleted.
 			if(!childRecord) break;
@@ -173,6 +224,7 @@ static Record CondTraverseConsume(OpBase *opBase) {
 		if(op->record_count == 0) return NULL;
 
 		_traverse(op);
+		_UpdateBatchSize(op);
 	}
 
 	/* Get node from current column. */
@@ -217,7 +269,11 @@ static OpResult CondTraverseReset(OpBase *ctx) {
 static inline OpBase *CondTraverseClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_CONDITIONAL_TRAVERSE);
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
-	return NewCondTraverseOp(plan, QueryCtx_GetGraph(), AlgebraicExpression_Clone(op->ae));
+	OpCondTraverse *clone = (OpCondTraverse *)NewCondTraverseOp(plan,
+			QueryCtx_GetGraph(), AlgebraicExpression_Clone(op->ae));
+	// Retain the limit applied at optimization time.
+	clone->record_cap = op->record_cap;
+	return (OpBase *)clone;
 }
 
 /* Frees CondTraverse */
@@ -27,6 +27,7 @@ typedef struct {
 	int destNodeIdx;            // Destination node index into record.
 	uint record_count;          // Number of held records.
 	uint record_cap;            // Max number of records to process.
+	uint batch_size;            // Number of records to process in the next traversal.
 	Record *records;            // Array of records.
 	Record r;                   // Currently selected record.
 } OpCondTraverse;
@@ -16,6 +16,37 @@ static OpResult DeleteInit(OpBase *opBase);
 static OpBase *DeleteClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void DeleteFree(OpBase *opBase);
 
+// remove edges, both explicitly deleted and implicitly deleted
+// alongside their endpoints, from relationship-type indices
+static void _DeleteEdgesFromIndices(OpDelete *op, uint node_count,
+		uint edge_count) {
+	GraphContext *gc = op->gc;
+	Edge *edges = array_new(Edge, 0);
+
+	for(uint i = 0; i < edge_count; i++) {
+		GraphContext_DeleteEdgeFromIndices(gc, op->deleted_edges + i);
+	}
+
+	uint relation_count = array_len(gc->relation_schemas);
+	for(uint i = 0; i < relation_count; i++) {
+		Schema *s = gc->relation_schemas[i];
+		if(!Schema_HasIndices(s)) continue;
+
+		for(uint j = 0; j < node_count; j++) {
+			Node *n = op->deleted_nodes + j;
+			Graph_GetNodeEdges(gc->g, n, GRAPH_EDGE_DIR_BOTH, s->id, &edges);
+		}
+
+		uint implicit_count = array_len(edges);
+		for(uint j = 0; j < implicit_count; j++) {
+			Schema_RemoveEdgeFromIndices(s, edges + j);
+		}
+		array_clear(edges);
+	}
+
+	array_free(edges);
+}
+
 void _DeleteEntities(OpDelete *op) {
 	Graph  *g                     =  op->gc->g;
 	uint   node_deleted           =  0;
@@ -35,6 +66,7 @@ void _DeleteEntities(OpDelete *op) {
 			Node *n = op->deleted_nodes + i;
 			GraphContext_DeleteNodeFromIndices(op->gc, n);
 		}
+		_DeleteEdgesFromIndices(op, node_count, edge_count);
 	}
 
 	if(edge_count <= EDGE_BULK_DELETE_THRESHOLD) {
@@ -14,6 +14,7 @@
 /* Forward declarations. */
 static OpResult DistinctInit(OpBase *opBase);
 static Record DistinctConsume(OpBase *opBase);
+static OpResult DistinctReset(OpBase *opBase);
 static OpBase *DistinctClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void DistinctFree(OpBase *opBase);
 
@@ -108,7 +109,7 @@ OpBase *NewDistinctOp(const ExecutionPlan *plan) {
 	op->offset_count    =  0;
 
 	OpBase_Init((OpBase *)op, OPType_DISTINCT, "Distinct", DistinctInit, DistinctConsume,
-				NULL, NULL, DistinctClone, DistinctFree, false, plan);
+				DistinctReset, NULL, DistinctClone, DistinctFree, false, plan);
 
 	return (OpBase *)op;
 }
@@ -148,6 +149,14 @@ static Record DistinctConsume(OpBase *opBase) {
 	}
 }
 
+static OpResult DistinctReset(OpBase *opBase) {
+	OpDistinct *op = (OpDistinct *)opBase;
+	// forget previously encountered values
+	raxFree(op->found);
+	op->found = raxNew();
+	return OP_OK;
+}
+
 static inline OpBase *DistinctClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_DISTINCT);
 	return NewDistinctOp(plan);
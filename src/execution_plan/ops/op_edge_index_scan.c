@@ -0,0 +1,179 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "op_edge_index_scan.h"
+#include "../../query_ctx.h"
+#include "shared/print_functions.h"
+#include "../../filter_tree/ft_to_index_query.h"
+
+// forward declarations
+static OpResult EdgeIndexScanInit(OpBase *opBase);
+static Record EdgeIndexScanConsume(OpBase *opBase);
+static OpResult EdgeIndexScanReset(OpBase *opBase);
+static void EdgeIndexScanFree(OpBase *opBase);
+
+static int EdgeIndexScanToString(const OpBase *ctx, char *buf, uint buf_len) {
+	return TraversalToString(ctx, buf, buf_len, ((const EdgeIndexScan *)ctx)->ae);
+}
+
+OpBase *NewEdgeIndexScanOp(const ExecutionPlan *plan, Graph *g, Index *idx,
+		AlgebraicExpression *ae, const char *edge, const char *relation,
+		int relation_id, GRAPH_EDGE_DIR direction, NodeScanCtx src,
+		NodeScanCtx dest, FT_FilterNode *filter) {
+	// validate inputs
+	ASSERT(g      != NULL);
+	ASSERT(ae     != NULL);
+	ASSERT(idx    != NULL);
+	ASSERT(edge   != NULL);
+	ASSERT(plan   != NULL);
+	ASSERT(filter != NULL);
+	ASSERT(direction != GRAPH_EDGE_DIR_BOTH);
+
+	EdgeIndexScan *op = rm_malloc(sizeof(EdgeIndexScan));
+	op->g            =  g;
+	op->ae           =  ae;
+	op->idx          =  idx;
+	op->src          =  src;
+	op->dest         =  dest;
+	op->iter         =  NULL;
+	op->filter       =  filter;
+	op->relation     =  relation;
+	op->direction    =  direction;
+	op->relation_id  =  relation_id;
+
+	// Set our Op operations
+	OpBase_Init((OpBase *)op, OPType_EDGE_INDEX_SCAN, "Edge Index Scan",
+			EdgeIndexScanInit, EdgeIndexScanConsume, EdgeIndexScanReset,
+			EdgeIndexScanToString, NULL, EdgeIndexScanFree, false, plan);
+
+	op->srcRecIdx = OpBase_Modifies((OpBase *)op, src.alias);
+	op->destRecIdx = OpBase_Modifies((OpBase *)op, dest.alias);
+	op->edgeRecIdx = OpBase_Modifies((OpBase *)op, edge);
+	return (OpBase *)op;
+}
+
+// resolve label ID if it is still unknown
+static void _ResolveLabel(GraphContext *gc, NodeScanCtx *n) {
+	if(n->label == NULL || n->label_id != GRAPH_UNKNOWN_LABEL) return;
+
+	Schema *s = GraphContext_GetSchema(gc, n->label, SCHEMA_NODE);
+	if(s != NULL) n->label_id = s->id;
+}
+
+static OpResult EdgeIndexScanInit(OpBase *opBase) {
+	EdgeIndexScan *op = (EdgeIndexScan *)opBase;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	_ResolveLabel(gc, &op->src);
+	_ResolveLabel(gc, &op->dest);
+
+	// resolve relationship type ID now if it is still unknown
+	if(op->relation_id == GRAPH_UNKNOWN_RELATION) {
+		Schema *s = GraphContext_GetSchema(gc, op->relation, SCHEMA_EDGE);
+		ASSERT(s != NULL);
+		op->relation_id = s->id;
+	}
+
+	return OP_OK;
+}
+
+// fetch node 'id' into 'n' if it satisfies the label constraint of 'ctx'
+static inline bool _GetNode(const EdgeIndexScan *op, const NodeScanCtx *ctx,
+		NodeID id, Node *n) {
+	if(ctx->label != NULL) {
+		// label was never created, no node can satisfy it
+		if(ctx->label_id == GRAPH_UNKNOWN_LABEL) return false;
+		if(Graph_GetNodeLabel(op->g, id) != ctx->label_id) return false;
+	}
+
+	*n = GE_NEW_LABELED_NODE(ctx->label, ctx->label_id);
+	int res = Graph_GetNode(op->g, id, n);
+	ASSERT(res != 0);
+	return true;
+}
+
+// populate the Record with the matched edge and its endpoints
+// returns false if either endpoint doesn't satisfy its label
+static bool _UpdateRecord(EdgeIndexScan *op, Record r, EdgeID edge_id) {
+	NodeID edge_src;
+	NodeID edge_dest;
+	bool found = Index_GetEdgeEndpoints(op->idx, edge_id, &edge_src,
+			&edge_dest);
+	ASSERT(found == true);
+
+	// map edge endpoints onto the traversal's source and destination
+	NodeID src_id   =  edge_src;
+	NodeID dest_id  =  edge_dest;
+	if(op->direction == GRAPH_EDGE_DIR_INCOMING) {
+		src_id   =  edge_dest;
+		dest_id  =  edge_src;
+	}
+
+	Node src;
+	Node dest;
+	if(!_GetNode(op, &op->src, src_id, &src)) return false;
+	if(!_GetNode(op, &op->dest, dest_id, &dest)) return false;
+
+	Edge e = {0};
+	int res = Graph_GetEdge(op->g, edge_id, &e);
+	ASSERT(res != 0);
+	e.srcNodeID   =  edge_src;
+	e.destNodeID  =  edge_dest;
+	e.relationID  =  op->relation_id;
+
+	Record_AddNode(r, op->srcRecIdx, src);
+	Record_AddNode(r, op->destRecIdx, dest);
+	Record_AddEdge(r, op->edgeRecIdx, e);
+	return true;
+}
+
+static Record EdgeIndexScanConsume(OpBase *opBase) {
+	EdgeIndexScan *op = (EdgeIndexScan *)opBase;
+
+	// create iterator on first call
+	if(op->iter == NULL) {
+		FT_FilterNode *unresolved_filters = NULL;
+		IndexQuery *query = FilterTreeToIndexQuery(&unresolved_filters,
+				op->filter);
+		ASSERT(unresolved_filters == NULL);
+
+		op->iter = Index_Scan(op->idx, query);
+	}
+
+	EdgeID edge_id;
+	Record r = OpBase_CreateRecord((OpBase *)op);
+	while(IndexIter_Next(op->iter, &edge_id)) {
+		if(_UpdateRecord(op, r, edge_id)) return r;
+	}
+
+	// index depleted
+	OpBase_DeleteRecord(r);
+	return NULL;
+}
+
+static OpResult EdgeIndexScanReset(OpBase *opBase) {
+	EdgeIndexScan *op = (EdgeIndexScan *)opBase;
+	if(op->iter != NULL) IndexIter_Reset(op->iter);
+	return OP_OK;
+}
+
+static void EdgeIndexScanFree(OpBase *opBase) {
+	EdgeIndexScan *op = (EdgeIndexScan *)opBase;
+	if(op->iter) {
+		IndexIter_Free(op->iter);
+		op->iter = NULL;
+	}
+
+	if(op->ae) {
+		AlgebraicExpression_Free(op->ae);
+		op->ae = NULL;
+	}
+
+	if(op->filter) {
+		FilterTree_Free(op->filter);
+		op->filter = NULL;
+	}
+}
@@ -0,0 +1,42 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "op.h"
+#include "../execution_plan.h"
+#include "../../graph/graph.h"
+#include "../../index/index.h"
+#include "../../filter_tree/filter_tree.h"
+#include "../../arithmetic/algebraic_expression.h"
+#include "shared/scan_functions.h"
+
+// EdgeIndexScan resolves predicates on a relationship-type index
+// each matching edge seeds the traversal it replaces, populating the Record
+// with the edge and both of its endpoints
+typedef struct {
+	OpBase op;
+	Graph *g;
+	Index *idx;                  // relationship-type index to query
+	FT_FilterNode *filter;       // filter from which to compose index query
+	IndexIter *iter;             // iterator over matching edges
+	AlgebraicExpression *ae;     // expression of the replaced traversal
+	const char *relation;        // relationship type of scanned edges
+	int relation_id;             // relationship type ID of scanned edges
+	GRAPH_EDGE_DIR direction;    // outgoing if edges lead from 'src' to 'dest'
+	NodeScanCtx src;             // label data of the traversal's source node
+	NodeScanCtx dest;            // label data of the traversal's destination node
+	uint srcRecIdx;              // index of the source node in the Record
+	uint destRecIdx;             // index of the destination node in the Record
+	uint edgeRecIdx;             // index of the edge in the Record
+} EdgeIndexScan;
+
+// creates a new EdgeIndexScan operation
+// takes ownership over 'ae' and 'filter'
+OpBase *NewEdgeIndexScanOp(const ExecutionPlan *plan, Graph *g, Index *idx,
+		AlgebraicExpression *ae, const char *edge, const char *relation,
+		int relation_id, GRAPH_EDGE_DIR direction, NodeScanCtx src,
+		NodeScanCtx dest, FT_FilterNode *filter);
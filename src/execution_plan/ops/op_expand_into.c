@@ -7,6 +7,7 @@
 #include "op_expand_into.h"
 #include "shared/print_functions.h"
 #include "../../query_ctx.h"
+#include "../../util/simple_timer.h"
 
 // default number of records to accumulate before traversing
 #define BATCH_SIZE 16
@@ -58,7 +59,11 @@ static void _traverse(OpExpandInto *op) {
 	_populate_filter_matrix(op);
 
 	// Evaluate expression.
+	double tic[2];
+	OpBase *base = (OpBase *)op;
+	if(base->stats) simple_tic(tic);
 	AlgebraicExpression_Eval(op->ae, op->M);
+	if(base->stats) OpBase_ProfileMatrix(base, simple_toc(tic), op->M);
 
 	// Clear filter matrix.
 	GrB_Matrix_clear(op->F);
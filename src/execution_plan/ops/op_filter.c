@@ -9,6 +9,7 @@
 
 /* Forward declarations. */
 static Record FilterConsume(OpBase *opBase);
+static uint FilterConsumeBatch(OpBase *opBase, RecordBatch *batch);
 static OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void FilterFree(OpBase *opBase);
 
@@ -19,6 +20,7 @@ OpBase *NewFilterOp(const ExecutionPlan *plan, FT_FilterNode *filterTree) {
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", NULL, FilterConsume,
 				NULL, NULL, FilterClone, FilterFree, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, FilterConsumeBatch);
 
 	return (OpBase *)op;
 }
@@ -42,6 +44,33 @@ static Record FilterConsume(OpBase *opBase) {
 	return r;
 }
 
+/* FilterConsumeBatch next batch of records
+ * records failing the filter tree are removed from the batch. */
+static uint FilterConsumeBatch(OpBase *opBase, RecordBatch *batch) {
+	OpFilter *filter = (OpFilter *)opBase;
+	OpBase *child = filter->op.children[0];
+
+	// Pull batches until a record passes or child is depleted.
+	while(OpBase_ConsumeBatch(child, batch) > 0) {
+		uint passed = 0;
+		for(uint i = 0; i < batch->count; i++) {
+			Record r = batch->records[i];
+			/* Pass record through filter tree,
+			 * compact passing records to the front of the batch. */
+			if(FilterTree_applyFilters(filter->filterTree, r) == FILTER_PASS) {
+				batch->records[passed++] = r;
+			} else {
+				OpBase_DeleteRecord(r);
+			}
+		}
+
+		batch->count = passed;
+		if(passed > 0) break;
+	}
+
+	return batch->count;
+}
+
 static inline OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_FILTER);
 	OpFilter *op = (OpFilter *)opBase;
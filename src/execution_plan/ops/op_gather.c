@@ -0,0 +1,593 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "op_gather.h"
+#include "RG.h"
+#include <string.h>
+#include "op_all_node_scan.h"
+#include "op_node_by_label_scan.h"
+#include "../../errors.h"
+#include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+#include "../../util/thpool/pools.h"
+#include "../execution_plan_clone.h"
+
+/* Forward declarations. */
+static OpResult GatherInit(OpBase *opBase);
+static Record GatherConsume(OpBase *opBase);
+static uint GatherConsumeBatch(OpBase *opBase, RecordBatch *batch);
+static OpResult GatherReset(OpBase *opBase);
+static OpBase *GatherClone(const ExecutionPlan *plan, const OpBase *opBase);
+static void GatherFree(OpBase *opBase);
+
+OpBase *NewGatherOp(const ExecutionPlan *plan) {
+	OpGather *op = rm_malloc(sizeof(OpGather));
+	op->scan = NULL;
+	op->shared = NULL;
+	op->active = false;
+	op->started = false;
+	op->buffer_idx = 0;
+	op->buffer.count = 0;
+	op->sink = NULL;
+	op->sinks = NULL;
+
+	// Set our Op operations
+	OpBase_Init((OpBase *)op, OPType_GATHER, "Gather", GatherInit, GatherConsume,
+				GatherReset, NULL, GatherClone, GatherFree, false, plan);
+
+	return (OpBase *)op;
+}
+
+//------------------------------------------------------------------------------
+// Pipeline utilities
+//------------------------------------------------------------------------------
+
+// Locate the scan operation at the bottom of a pipeline.
+static OpBase *_LocateScan(OpBase *root) {
+	OpBase *op = root;
+	while(op->childCount > 0) {
+		ASSERT(op->childCount == 1);
+		op = op->children[0];
+	}
+	return op;
+}
+
+// Restrict scan to nodes with an ID within [start, end).
+static void _SetScanRange(OpBase *scan, NodeID start, NodeID end) {
+	switch(scan->type) {
+		case OPType_ALL_NODE_SCAN:
+			AllNodeScanOp_SetRange((AllNodeScan *)scan, start, end);
+			break;
+		case OPType_NODE_BY_LABEL_SCAN:
+		case OPType_NODE_BY_LABEL_AND_ID_SCAN:
+			NodeByLabelScanOp_SetRange((NodeByLabelScan *)scan, start, end);
+			break;
+		default:
+			ASSERT(false && "Gather: unsupported scan operation");
+			break;
+	}
+}
+
+// Returns an upper bound on the number of nodes produced by scan.
+static uint64_t _ScanSize(const OpBase *scan) {
+	Graph *g = QueryCtx_GetGraph();
+	if(scan->type == OPType_ALL_NODE_SCAN) return Graph_NodeCount(g);
+
+	const NodeByLabelScan *label_scan = (const NodeByLabelScan *)scan;
+	// Label scan without an iterator produces no records.
+	if(label_scan->iter == NULL) return 0;
+	return Graph_LabeledNodeCount(g, label_scan->n.label_id);
+}
+
+// Restart pipeline over the next unclaimed morsel,
+// returns false if all morsels have been claimed.
+static bool _RestartPipeline(GatherShared *shared, OpBase *root, OpBase *scan) {
+	if(__atomic_load_n(&shared->abort, __ATOMIC_RELAXED)) return false;
+
+	uint64_t morsel = __atomic_fetch_add(&shared->next_morsel, 1, __ATOMIC_RELAXED);
+	NodeID start = morsel * GATHER_MORSEL_SIZE;
+	if(start >= shared->id_count) return false;
+
+	_SetScanRange(scan, start, start + GATHER_MORSEL_SIZE);
+	OpBase_PropagateReset(root);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Shared state
+//------------------------------------------------------------------------------
+
+static GatherShared *_Shared_New(uint worker_count) {
+	GatherShared *shared = rm_malloc(sizeof(GatherShared));
+	pthread_mutex_init(&shared->lock, NULL);
+	pthread_cond_init(&shared->cond, NULL);
+
+	shared->abort = false;
+	shared->error = NULL;
+	shared->sink.consume = NULL;
+	shared->ref_count = 1;
+	shared->id_count = 0;
+	shared->next_morsel = 0;
+	shared->ready_head = 0;
+	shared->ready_count = 0;
+	shared->running = worker_count;
+	shared->worker_count = worker_count;
+	shared->query_ctx = QueryCtx_GetQueryCtx();
+	shared->mem = rm_thread_mem_counter();
+	shared->ready = rm_malloc(sizeof(GatherBatch *) * worker_count * GATHER_WORKER_BATCHES);
+	shared->workers = rm_malloc(sizeof(GatherWorker) * worker_count);
+
+	return shared;
+}
+
+// Drop a reference to the shared state, freeing it once unreferenced.
+static void _Shared_Release(GatherShared *shared) {
+	pthread_mutex_lock(&shared->lock);
+	uint ref_count = --shared->ref_count;
+	pthread_mutex_unlock(&shared->lock);
+
+	if(ref_count > 0) return;
+
+	if(shared->error) free(shared->error);
+	pthread_mutex_destroy(&shared->lock);
+	pthread_cond_destroy(&shared->cond);
+	rm_free(shared->workers);
+	rm_free(shared->ready);
+	rm_free(shared);
+}
+
+// Cancel workers which have not started, must be called holding the lock.
+static void _Shared_CancelPending(GatherShared *shared) {
+	for(uint i = 0; i < shared->worker_count; i++) {
+		GatherWorker *w = shared->workers + i;
+		if(w->state != GATHER_WORKER_PENDING) continue;
+		w->state = GATHER_WORKER_CANCELLED;
+		shared->running--;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Worker
+//------------------------------------------------------------------------------
+
+// Wait for an available batch, returns NULL once Gather is aborted.
+static GatherBatch *_Worker_AcquireBatch(GatherWorker *w) {
+	GatherShared *shared = w->shared;
+	GatherBatch *b = NULL;
+
+	pthread_mutex_lock(&shared->lock);
+	while(w->free_count == 0 && !shared->abort) {
+		pthread_cond_wait(&shared->cond, &shared->lock);
+	}
+	if(!shared->abort) b = w->free[--w->free_count];
+	pthread_mutex_unlock(&shared->lock);
+
+	// Return records previously merged by Gather to the worker's pool.
+	if(b != NULL && b->pending) {
+		for(uint i = 0; i < b->batch.count; i++) OpBase_DeleteRecord(b->batch.records[i]);
+		b->pending = false;
+	}
+
+	return b;
+}
+
+static void _Worker_ReleaseBatch(GatherWorker *w, GatherBatch *b, bool publish) {
+	GatherShared *shared = w->shared;
+	uint cap = shared->worker_count * GATHER_WORKER_BATCHES;
+
+	pthread_mutex_lock(&shared->lock);
+	if(publish) {
+		b->pending = true;
+		shared->ready[(shared->ready_head + shared->ready_count) % cap] = b;
+		shared->ready_count++;
+		pthread_cond_broadcast(&shared->cond);
+	} else {
+		w->free[w->free_count++] = b;
+	}
+	pthread_mutex_unlock(&shared->lock);
+}
+
+/* Errors set without raising, e.g. exceeding the query's memory capacity,
+ * are raised such that they're reported to Gather. */
+static inline void _Worker_RaiseError(void) {
+	if(ErrorCtx_EncounteredError()) ErrorCtx_RaiseRuntimeException(NULL);
+}
+
+static void _Worker_Exit(GatherWorker *w) {
+	GatherShared *shared = w->shared;
+
+	// Stop charging the query before it can complete.
+	rm_charge_mem_counter(NULL);
+
+	pthread_mutex_lock(&shared->lock);
+	w->state = GATHER_WORKER_DONE;
+	shared->running--;
+	pthread_cond_broadcast(&shared->cond);
+	pthread_mutex_unlock(&shared->lock);
+
+	ErrorCtx_Clear();
+	QueryCtx_RemoveFromTLS();
+	_Shared_Release(shared);
+}
+
+static void _Worker_Run(void *arg) {
+	GatherWorker *w = (GatherWorker *)arg;
+	GatherShared *shared = w->shared;
+
+	pthread_mutex_lock(&shared->lock);
+	bool cancelled = (w->state == GATHER_WORKER_CANCELLED);
+	if(!cancelled) w->state = GATHER_WORKER_RUNNING;
+	pthread_mutex_unlock(&shared->lock);
+
+	// Gather is done, worker's pipeline has already been freed.
+	if(cancelled) {
+		_Shared_Release(shared);
+		return;
+	}
+
+	/* Workers evaluate the query on behalf of the executing thread,
+	 * their allocations are charged to the query's memory counter. */
+	QueryCtx_SetTLS(shared->query_ctx);
+	rm_reset_n_alloced();
+	rm_charge_mem_counter(shared->mem);
+
+	/* Set an exception-handling breakpoint to capture run-time errors,
+	 * errors are reported to Gather, which raises them on the executing thread. */
+	int encountered_error = SET_EXCEPTION_HANDLER();
+	if(encountered_error) {
+		rm_charge_mem_counter(NULL);
+		ErrorCtx *ctx = ErrorCtx_Get();
+		pthread_mutex_lock(&shared->lock);
+		if(shared->error == NULL) {
+			shared->error = (ctx->error) ? ctx->error : strdup("Parallel scan failed");
+			ctx->error = NULL;
+		}
+		shared->abort = true;
+		pthread_mutex_unlock(&shared->lock);
+		/* The batch being populated is abandoned,
+		 * its records are released along with the worker's pool. */
+		_Worker_Exit(w);
+		return;
+	}
+
+	OpBase *root = w->plan->root;
+	const GatherSink *sink = &shared->sink;
+	if(sink->consume != NULL) {
+		// Records are consumed by the worker's sink.
+		RecordBatch batch;
+		while(_RestartPipeline(shared, root, w->scan)) {
+			while(OpBase_ConsumeBatch(root, &batch) > 0) {
+				sink->consume(sink->arg, w->sink, &batch);
+				_Worker_RaiseError();
+			}
+		}
+		_Worker_Exit(w);
+		return;
+	}
+
+	while(_RestartPipeline(shared, root, w->scan)) {
+		while(true) {
+			GatherBatch *b = _Worker_AcquireBatch(w);
+			if(b == NULL) break;  // Aborted.
+
+			// Morsel depleted, hand back batch and claim the next morsel.
+			bool depleted = (OpBase_ConsumeBatch(root, &b->batch) == 0);
+			_Worker_RaiseError();
+			_Worker_ReleaseBatch(w, b, !depleted);
+			if(depleted) break;
+		}
+	}
+
+	_Worker_Exit(w);
+}
+
+//------------------------------------------------------------------------------
+// Gather
+//------------------------------------------------------------------------------
+
+static OpResult GatherInit(OpBase *opBase) {
+	OpBase_UpdateConsumeBatch(opBase, GatherConsumeBatch);
+	return OP_OK;
+}
+
+// Clone the child pipeline for each worker and dispatch workers.
+static void _StartWorkers(OpGather *op, uint worker_count, NodeID id_count) {
+	OpBase *child = op->op.children[0];
+	GatherShared *shared = _Shared_New(worker_count);
+	shared->id_count = id_count;
+	if(op->sink) shared->sink = *op->sink;
+	op->shared = shared;
+
+	/* Pipelines are cloned and initialized by the executing thread,
+	 * as cloning sets the thread-local AST. */
+	for(uint i = 0; i < worker_count; i++) {
+		GatherWorker *w = shared->workers + i;
+		w->shared = shared;
+		w->state = GATHER_WORKER_PENDING;
+		w->plan = ExecutionPlan_CloneOpTree(child);
+		ExecutionPlan_Init(w->plan);
+		w->scan = _LocateScan(w->plan->root);
+		w->batches = rm_malloc(sizeof(GatherBatch) * GATHER_WORKER_BATCHES);
+		w->free = rm_malloc(sizeof(GatherBatch *) * GATHER_WORKER_BATCHES);
+		w->free_count = GATHER_WORKER_BATCHES;
+		w->sink = NULL;
+		if(op->sink) {
+			w->sink = op->sink->new_sink(op->sink->arg);
+			array_append(*op->sinks, w->sink);
+		}
+		for(uint j = 0; j < GATHER_WORKER_BATCHES; j++) {
+			w->batches[j].worker = w;
+			w->batches[j].pending = false;
+			w->batches[j].batch.count = 0;
+			w->free[j] = w->batches + j;
+		}
+	}
+
+	for(uint i = 0; i < worker_count; i++) {
+		GatherWorker *w = shared->workers + i;
+		pthread_mutex_lock(&shared->lock);
+		shared->ref_count++;
+		pthread_mutex_unlock(&shared->lock);
+
+		if(ThreadPools_AddWorkParallel(_Worker_Run, w) != 0) {
+			// Failed to dispatch worker, the executing thread claims its morsels.
+			pthread_mutex_lock(&shared->lock);
+			w->state = GATHER_WORKER_CANCELLED;
+			shared->running--;
+			shared->ref_count--;
+			pthread_mutex_unlock(&shared->lock);
+		}
+	}
+}
+
+// Determine execution mode, dispatching workers for large scans.
+static void _Start(OpGather *op) {
+	op->started = true;
+	op->active = false;
+	op->buffer_idx = 0;
+	op->buffer.count = 0;
+	op->scan = _LocateScan(op->op.children[0]);
+
+	uint thread_count = ThreadPools_ParallelCount();
+	if(thread_count == 0) return;
+	if(_ScanSize(op->scan) < GATHER_MIN_SCAN_SIZE) return;
+
+	NodeID id_count = Graph_UncompactedNodeCount(QueryCtx_GetGraph());
+	uint64_t morsel_count = (id_count + GATHER_MORSEL_SIZE - 1) / GATHER_MORSEL_SIZE;
+	// The executing thread claims morsels as well.
+	uint64_t worker_count = morsel_count - 1;
+	if(worker_count > thread_count) worker_count = thread_count;
+	if(worker_count == 0) return;
+
+	_StartWorkers(op, worker_count, id_count);
+}
+
+// Abort workers, wait for running workers to exit and release their resources.
+static void _StopWorkers(OpGather *op) {
+	GatherShared *shared = op->shared;
+	if(shared == NULL) return;
+
+	pthread_mutex_lock(&shared->lock);
+	shared->abort = true;
+	_Shared_CancelPending(shared);
+	pthread_cond_broadcast(&shared->cond);
+	while(shared->running > 0) pthread_cond_wait(&shared->cond, &shared->lock);
+	pthread_mutex_unlock(&shared->lock);
+
+	/* Workers have either exited or been cancelled,
+	 * return outstanding records to their pools. */
+	for(uint i = 0; i < shared->worker_count; i++) {
+		GatherWorker *w = shared->workers + i;
+		for(uint j = 0; j < GATHER_WORKER_BATCHES; j++) {
+			GatherBatch *b = w->batches + j;
+			if(!b->pending) continue;
+			for(uint k = 0; k < b->batch.count; k++) OpBase_DeleteRecord(b->batch.records[k]);
+		}
+		ExecutionPlan_Free(w->plan);
+		rm_free(w->batches);
+		rm_free(w->free);
+		w->plan = NULL;
+	}
+
+	op->shared = NULL;
+	_Shared_Release(shared);
+}
+
+// Raise an error encountered by a worker on the executing thread.
+static void _RaiseWorkerError(GatherShared *shared) {
+	pthread_mutex_lock(&shared->lock);
+	char *error = shared->error;
+	shared->error = NULL;
+	pthread_mutex_unlock(&shared->lock);
+
+	ErrorCtx_SetError("%s", error);
+	free(error);
+	ErrorCtx_RaiseRuntimeException(NULL);
+}
+
+void GatherOp_Drain(OpGather *op, const GatherSink *sink, void *local, void ***sinks) {
+	ASSERT(!op->started);
+	OpBase *child = op->op.children[0];
+
+	// Workers are handed sinks as they're started.
+	op->sink = sink;
+	op->sinks = sinks;
+	_Start(op);
+	op->sink = NULL;
+	op->sinks = NULL;
+
+	RecordBatch batch;
+	GatherShared *shared = op->shared;
+	if(shared == NULL) {
+		while(OpBase_ConsumeBatch(child, &batch) > 0) sink->consume(sink->arg, local, &batch);
+		return;
+	}
+
+	while(_RestartPipeline(shared, child, op->scan)) {
+		while(OpBase_ConsumeBatch(child, &batch) > 0) sink->consume(sink->arg, local, &batch);
+	}
+
+	// All morsels have been claimed, wait for running workers.
+	pthread_mutex_lock(&shared->lock);
+	_Shared_CancelPending(shared);
+	while(shared->running > 0 && shared->error == NULL) {
+		pthread_cond_wait(&shared->cond, &shared->lock);
+	}
+	char *error = shared->error;
+	shared->error = NULL;
+	pthread_mutex_unlock(&shared->lock);
+
+	if(error) {
+		// Sinks are owned by the caller, make sure workers are done with them.
+		_StopWorkers(op);
+		_SetScanRange(op->scan, 0, UINT64_MAX);
+		ErrorCtx_SetError("%s", error);
+		free(error);
+		ErrorCtx_RaiseRuntimeException(NULL);
+	}
+}
+
+// Move records of a worker's batch into Gather's output batch.
+static uint _MergeBatch(OpGather *op, GatherBatch *b, RecordBatch *batch) {
+	uint count = b->batch.count;
+	for(uint i = 0; i < count; i++) {
+		Record r = OpBase_CreateRecord((OpBase *)op);
+		Record_TransferEntries(&r, b->batch.records[i]);
+		batch->records[i] = r;
+	}
+	batch->count = count;
+
+	/* Hand batch back to its worker, transferred records are returned
+	 * to the worker's pool by the worker itself. */
+	GatherWorker *w = b->worker;
+	GatherShared *shared = op->shared;
+	pthread_mutex_lock(&shared->lock);
+	w->free[w->free_count++] = b;
+	pthread_cond_broadcast(&shared->cond);
+	pthread_mutex_unlock(&shared->lock);
+
+	return count;
+}
+
+static uint _ParallelConsumeBatch(OpGather *op, RecordBatch *batch) {
+	OpBase *child = op->op.children[0];
+	GatherShared *shared = op->shared;
+	uint cap = shared->worker_count * GATHER_WORKER_BATCHES;
+
+	while(true) {
+		// Merge a batch produced by a worker, if one is ready.
+		GatherBatch *b = NULL;
+		pthread_mutex_lock(&shared->lock);
+		bool failed = (shared->error != NULL);
+		if(!failed && shared->ready_count > 0) {
+			b = shared->ready[shared->ready_head];
+			shared->ready_head = (shared->ready_head + 1) % cap;
+			shared->ready_count--;
+		}
+		pthread_mutex_unlock(&shared->lock);
+
+		if(failed) _RaiseWorkerError(shared);
+		if(b != NULL) return _MergeBatch(op, b, batch);
+
+		// Consume a morsel on the executing thread.
+		if(op->active) {
+			uint count = OpBase_ConsumeBatch(child, batch);
+			if(count > 0) return count;
+			op->active = false;
+		}
+
+		if(_RestartPipeline(shared, child, op->scan)) {
+			op->active = true;
+			continue;
+		}
+
+		/* All morsels have been claimed, workers yet to start
+		 * have nothing left to do, wait for running workers. */
+		pthread_mutex_lock(&shared->lock);
+		_Shared_CancelPending(shared);
+		while(shared->ready_count == 0 && shared->running > 0 && shared->error == NULL) {
+			pthread_cond_wait(&shared->cond, &shared->lock);
+		}
+		bool depleted = (shared->ready_count == 0 && shared->running == 0 &&
+						 shared->error == NULL);
+		pthread_mutex_unlock(&shared->lock);
+
+		if(depleted) {
+			batch->count = 0;
+			return 0;
+		}
+	}
+}
+
+static uint GatherConsumeBatch(OpBase *opBase, RecordBatch *batch) {
+	OpGather *op = (OpGather *)opBase;
+	if(!op->started) _Start(op);
+
+	if(op->shared == NULL) return OpBase_ConsumeBatch(opBase->children[0], batch);
+
+	// Hand over records buffered by record by record consumption first.
+	if(op->buffer_idx < op->buffer.count) {
+		uint count = 0;
+		for(; op->buffer_idx < op->buffer.count; op->buffer_idx++) {
+			batch->records[count++] = op->buffer.records[op->buffer_idx];
+		}
+		batch->count = count;
+		return count;
+	}
+
+	return _ParallelConsumeBatch(op, batch);
+}
+
+static Record GatherConsume(OpBase *opBase) {
+	OpGather *op = (OpGather *)opBase;
+	if(!op->started) _Start(op);
+
+	if(op->shared == NULL) return OpBase_Consume(opBase->children[0]);
+
+	if(op->buffer_idx == op->buffer.count) {
+		op->buffer_idx = 0;
+		op->buffer.count = 0;
+		if(_ParallelConsumeBatch(op, &op->buffer) == 0) return NULL;
+	}
+
+	return op->buffer.records[op->buffer_idx++];
+}
+
+// Free merged records which have not been consumed.
+static void _FreeBuffer(OpGather *op) {
+	for(; op->buffer_idx < op->buffer.count; op->buffer_idx++) {
+		OpBase_DeleteRecord(op->buffer.records[op->buffer_idx]);
+	}
+	op->buffer_idx = 0;
+	op->buffer.count = 0;
+}
+
+static OpResult GatherReset(OpBase *opBase) {
+	OpGather *op = (OpGather *)opBase;
+
+	if(op->shared != NULL) {
+		_StopWorkers(op);
+		// Lift morsel restriction from the child pipeline, which is reset next.
+		_SetScanRange(op->scan, 0, UINT64_MAX);
+	}
+	_FreeBuffer(op);
+
+	op->started = false;
+	op->active = false;
+	return OP_OK;
+}
+
+static OpBase *GatherClone(const ExecutionPlan *plan, const OpBase *opBase) {
+	ASSERT(opBase->type == OPType_GATHER);
+	return NewGatherOp(plan);
+}
+
+static void GatherFree(OpBase *opBase) {
+	OpGather *op = (OpGather *)opBase;
+	_StopWorkers(op);
+	_FreeBuffer(op);
+}
+
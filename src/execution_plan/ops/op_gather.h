@@ -0,0 +1,112 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <pthread.h>
+#include "op.h"
+#include "../execution_plan.h"
+#include "../../query_ctx.h"
+#include "../../util/rmalloc.h"
+
+/* Gather executes its child pipeline, a chain of streaming operations
+ * starting at a node scan, in parallel.
+ * The scanned node ID range is split into fixed size morsels, which are
+ * claimed by the executing thread and by workers of the parallel scan pool.
+ * Each worker runs a private clone of the pipeline, batches produced by
+ * workers are merged into Gather's output stream.
+ * Small scans, or scans while the parallel scan pool is disabled,
+ * simply pass through the child pipeline. */
+
+// Number of node IDs in a single morsel.
+#define GATHER_MORSEL_SIZE 16384
+
+// Minimal number of scanned nodes for a scan to execute in parallel.
+#define GATHER_MIN_SCAN_SIZE (GATHER_MORSEL_SIZE * 4)
+
+// Number of batches each worker may have in flight.
+#define GATHER_WORKER_BATCHES 2
+
+typedef struct GatherShared GatherShared;
+typedef struct GatherWorker GatherWorker;
+
+/* A sink consumes the records produced by a single thread,
+ * allowing operations above Gather to pre-aggregate in parallel. */
+typedef struct {
+	void *arg;                                              // Passed to sink routines.
+	void *(*new_sink)(void *arg);                           // Creates a sink, invoked by the executing thread.
+	void (*consume)(void *arg, void *sink, RecordBatch *batch); // Consumes and frees a batch, invoked by the sink's thread.
+} GatherSink;
+
+typedef enum {
+	GATHER_WORKER_PENDING,      // Dispatched, yet to start.
+	GATHER_WORKER_RUNNING,      // Executing its pipeline.
+	GATHER_WORKER_DONE,         // Exited.
+	GATHER_WORKER_CANCELLED,    // Cancelled before it started.
+} GatherWorkerState;
+
+typedef struct {
+	RecordBatch batch;          // Records produced by the worker.
+	GatherWorker *worker;       // Producing worker.
+	bool pending;               // Batch holds records yet to be returned to the worker's pool.
+} GatherBatch;
+
+struct GatherWorker {
+	GatherShared *shared;       // State shared with Gather.
+	GatherWorkerState state;    // Worker state.
+	ExecutionPlan *plan;        // Worker's clone of the child pipeline.
+	OpBase *scan;               // Scan operation within the cloned pipeline.
+	GatherBatch *batches;       // Batches owned by the worker.
+	GatherBatch **free;         // Batches available to the worker.
+	uint free_count;            // Number of available batches.
+	void *sink;                 // Sink consuming the worker's records, NULL when merging.
+};
+
+/* State shared between Gather and its workers.
+ * Workers which have not started by the time Gather is done are cancelled,
+ * as the thread pool may still hold them, the shared state is released
+ * by whoever holds the last reference to it. */
+struct GatherShared {
+	pthread_mutex_t lock;       // Guards shared state.
+	pthread_cond_t cond;        // Signaled whenever shared state changes.
+	uint ref_count;             // Number of references, Gather and dispatched workers.
+	QueryCtx *query_ctx;        // Query context, workers act on its behalf.
+	rm_mem_counter *mem;        // Query's memory counter, charged for worker allocations.
+	NodeID id_count;            // Number of node IDs to scan.
+	uint64_t next_morsel;       // Next morsel to claim.
+	GatherWorker *workers;      // Workers.
+	uint worker_count;          // Number of workers.
+	uint running;               // Number of workers neither exited nor cancelled.
+	GatherBatch **ready;        // Ring of batches ready to be merged.
+	uint ready_head;            // Position of the first ready batch.
+	uint ready_count;           // Number of ready batches.
+	bool abort;                 // Workers should stop.
+	GatherSink sink;            // Sink consuming worker records, no consume routine when merging.
+	char *error;                // Error encountered by a worker.
+};
+
+typedef struct {
+	OpBase op;
+	OpBase *scan;               // Scan operation at the bottom of the child pipeline.
+	bool started;               // Execution mode has been determined.
+	bool active;                // Executing thread is consuming a morsel of its own.
+	GatherShared *shared;       // State shared with workers, NULL if executing serially.
+	RecordBatch buffer;         // Merged records not yet consumed record by record.
+	uint buffer_idx;            // Position of the next buffered record.
+	const GatherSink *sink;     // Sink for workers being started, NULL when merging.
+	void ***sinks;              // Array to which worker sinks are appended.
+} OpGather;
+
+/* Creates a new Gather operation. */
+OpBase *NewGatherOp(const ExecutionPlan *plan);
+
+/* Executes Gather's pipeline to completion, records produced by each thread
+ * are consumed by a sink private to that thread instead of being merged into
+ * Gather's output. local is the executing thread's sink, sinks created for
+ * workers are appended to the sinks array, which is owned by the caller.
+ * Errors encountered by workers are raised once all workers have stopped. */
+void GatherOp_Drain(OpGather *op, const GatherSink *sink, void *local, void ***sinks);
+
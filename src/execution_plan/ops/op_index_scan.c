@@ -7,7 +7,7 @@
 #include "op_index_scan.h"
 #include "../../query_ctx.h"
 #include "shared/print_functions.h"
-#include "../../filter_tree/ft_to_rsq.h"
+#include "../../filter_tree/ft_to_index_query.h"
 
 // forward declarations
 static OpResult IndexScanInit(OpBase *opBase);
@@ -22,7 +22,7 @@ static int IndexScanToString(const OpBase *ctx, char *buf, uint buf_len) {
 }
 
 OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx n,
-		RSIndex *idx, FT_FilterNode *filter) {
+		Index *idx, FT_FilterNode *filter) {
 	// validate inputs
 	ASSERT(g      != NULL);
 	ASSERT(idx    != NULL);
@@ -89,18 +89,17 @@ static inline bool _PassUnresolvedFilters(const IndexScan *op, Record r) {
 
 static Record IndexScanConsumeFromChild(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
-	const EntityID *nodeId = NULL;
+	NodeID nodeId;
 
 pull_index:
 	//--------------------------------------------------------------------------
 	// pull from index
 	//--------------------------------------------------------------------------
 
-	if(op->iter != NULL) {
-		while((nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-				!= NULL) {
+	if(op->iter != NULL && op->child_record != NULL) {
+		while(IndexIter_Next(op->iter, &nodeId)) {
 			// populate record with node
-			_UpdateRecord(op, op->child_record, *nodeId);
+			_UpdateRecord(op, op->child_record, nodeId);
 			// apply unresolved filters
 			if(_PassUnresolvedFilters(op, op->child_record)) {
 				// clone the held Record, as it will be freed upstream
@@ -133,7 +132,7 @@ pull_index:
 	if(op->rebuild_index_query) {
 		// free previous iterator
 		if(op->iter != NULL) {
-			RediSearch_ResultsIteratorFree(op->iter);
+			IndexIter_Free(op->iter);
 			op->iter = NULL;
 		}
 
@@ -157,26 +156,27 @@ pull_index:
 		}
 		#endif
 
-		// convert filter into a RediSearch query
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				filter, op->idx);
+		// convert filter into an index query
+		IndexQuery *query = FilterTreeToIndexQuery(&op->unresolved_filters,
+				filter);
 		FilterTree_Free(filter);
 
 		// create iterator
-		ASSERT(rs_query_node != NULL);
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+		ASSERT(query != NULL);
+		op->iter = Index_Scan(op->idx, query);
 	} else {
 		// build index query only once (first call)
 		// reset it if already initialized
 		if(op->iter == NULL) {
 			// first call to consume, create query and iterator
-			RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters, op->filter, op->idx);
-			ASSERT(rs_query_node != NULL);
+			IndexQuery *query = FilterTreeToIndexQuery(&op->unresolved_filters,
+					op->filter);
+			ASSERT(query != NULL);
 			ASSERT(op->unresolved_filters == NULL);
-			op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+			op->iter = Index_Scan(op->idx, query);
 		} else {
 			// reset existing iterator
-			RediSearch_ResultsIteratorReset(op->iter);
+			IndexIter_Reset(op->iter);
 		}
 	}
 
@@ -189,20 +189,19 @@ static Record IndexScanConsume(OpBase *opBase) {
 
 	// create iterator on first call
 	if(op->iter == NULL) {
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				op->filter, op->idx);
+		IndexQuery *query = FilterTreeToIndexQuery(&op->unresolved_filters,
+				op->filter);
 		ASSERT(op->unresolved_filters == NULL);
 
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+		op->iter = Index_Scan(op->idx, query);
 	}
 
-	const EntityID *nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx,
-			NULL);
-	if(!nodeId) return NULL;
+	NodeID nodeId;
+	if(!IndexIter_Next(op->iter, &nodeId)) return NULL;
 
 	// populate the Record with the actual node
 	Record r = OpBase_CreateRecord((OpBase *)op);
-	_UpdateRecord(op, r, *nodeId);
+	_UpdateRecord(op, r, nodeId);
 
 	return r;
 }
@@ -210,11 +209,18 @@ static Record IndexScanConsume(OpBase *opBase) {
 static OpResult IndexScanReset(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
+	if(op->child_record != NULL) {
+		OpBase_DeleteRecord(op->child_record);
+		op->child_record = NULL;
+	}
+
+	if(op->iter == NULL) return OP_OK;
+
 	if(op->rebuild_index_query) {
-		RediSearch_ResultsIteratorFree(op->iter);
+		IndexIter_Free(op->iter);
 		op->iter = NULL;
 	} else {
-		RediSearch_ResultsIteratorReset(op->iter);
+		IndexIter_Reset(op->iter);
 	}
 
 	return OP_OK;
@@ -222,12 +228,8 @@ static OpResult IndexScanReset(OpBase *opBase) {
 
 static void IndexScanFree(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
-	/* As long as this Index iterator is alive the index is
-	 * read locked, if this index scan operation is part of
-	 * a query which will modified this index we'll be stuck in
-	 * a dead lock, as we're unable to acquire index write lock. */
 	if(op->iter) {
-		RediSearch_ResultsIteratorFree(op->iter);
+		IndexIter_Free(op->iter);
 		op->iter = NULL;
 	}
 
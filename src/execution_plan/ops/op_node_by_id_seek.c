@@ -63,6 +63,11 @@ static OpResult NodeByIdSeekInit(OpBase *opBase) {
 	return OP_OK;
 }
 
+// Restart the scan from the beginning of the range.
+static inline void _RewindSeek(NodeByIdSeek *op) {
+	op->currentId = op->minId;
+}
+
 static inline Node _SeekNextNode(NodeByIdSeek *op) {
 	Node n = GE_NEW_NODE();
 
@@ -85,7 +90,7 @@ static Record NodeByIdSeekConsumeFromChild(OpBase *opBase) {
 	if(op->child_record == NULL) {
 		op->child_record = OpBase_Consume(op->op.children[0]);
 		if(op->child_record == NULL) return NULL;
-		else NodeByIdSeekReset(opBase);
+		else _RewindSeek(op);
 	}
 
 	Node n = _SeekNextNode(op);
@@ -97,7 +102,7 @@ static Record NodeByIdSeekConsumeFromChild(OpBase *opBase) {
 		if(op->child_record == NULL) return NULL; // Child depleted.
 
 		// Reset iterator and evaluate again.
-		NodeByIdSeekReset(opBase);
+		_RewindSeek(op);
 		n = _SeekNextNode(op);
 		if(n.entity == NULL) return NULL; // Empty iterator; return immediately.
 	}
@@ -128,7 +133,11 @@ static Record NodeByIdSeekConsume(OpBase *opBase) {
 
 static OpResult NodeByIdSeekReset(OpBase *ctx) {
 	NodeByIdSeek *op = (NodeByIdSeek *)ctx;
-	op->currentId = op->minId;
+	_RewindSeek(op);
+	if(op->child_record) {
+		OpBase_DeleteRecord(op->child_record); // Free old record.
+		op->child_record = NULL;
+	}
 	return OP_OK;
 }
 
@@ -14,6 +14,7 @@
 static OpResult NodeByLabelScanInit(OpBase *opBase);
 static Record NodeByLabelScanConsume(OpBase *opBase);
 static Record NodeByLabelScanConsumeFromChild(OpBase *opBase);
+static uint NodeByLabelScanConsumeBatch(OpBase *opBase, RecordBatch *batch);
 static Record NodeByLabelScanNoOp(OpBase *opBase);
 static OpResult NodeByLabelScanReset(OpBase *opBase);
 static OpBase *NodeByLabelScanClone(const ExecutionPlan *plan, const OpBase *opBase);
@@ -33,6 +34,8 @@ OpBase *NewNodeByLabelScanOp(const ExecutionPlan *plan, NodeScanCtx n) {
 	op->child_record = NULL;
 	// Defaults to [0...UINT64_MAX].
 	op->id_range = UnsignedRange_New();
+	op->range_start = 0;
+	op->range_end = UINT64_MAX;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_NODE_BY_LABEL_SCAN, "Node By Label Scan", NodeByLabelScanInit,
@@ -52,14 +55,28 @@ void NodeByLabelScanOp_SetIDRange(NodeByLabelScan *op, UnsignedRange *id_range)
 	op->op.name = "Node By Label and ID Scan";
 }
 
-static GrB_Info _ConstructIterator(NodeByLabelScan *op, Schema *schema) {
-	GraphContext *gc = QueryCtx_GetGraphCtx();
-	GxB_MatrixTupleIter_new(&op->iter, Graph_GetLabelMatrix(gc->g, schema->id));
+void NodeByLabelScanOp_SetRange(NodeByLabelScan *op, NodeID start, NodeID end) {
+	op->range_start = start;
+	op->range_end = end;
+}
+
+// Iterate over id_range, restricted to [range_start, range_end).
+static GrB_Info _IterateRange(NodeByLabelScan *op) {
 	NodeID minId = op->id_range->include_min ? op->id_range->min : op->id_range->min + 1;
 	NodeID maxId = op->id_range->include_max ? op->id_range->max : op->id_range->max - 1;
+	// An empty restriction depletes the iterator.
+	if(op->range_end == 0) return GxB_MatrixTupleIter_iterate_range(op->iter, 1, 0);
+	if(minId < op->range_start) minId = op->range_start;
+	if(maxId > op->range_end - 1) maxId = op->range_end - 1;
 	return GxB_MatrixTupleIter_iterate_range(op->iter, minId, maxId);
 }
 
+static GrB_Info _ConstructIterator(NodeByLabelScan *op, Schema *schema) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	GxB_MatrixTupleIter_new(&op->iter, Graph_GetLabelMatrix(gc->g, schema->id));
+	return _IterateRange(op);
+}
+
 static OpResult NodeByLabelScanInit(OpBase *opBase) {
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 	OpBase_UpdateConsume(opBase, NodeByLabelScanConsume); // Default consume function.
@@ -89,6 +106,7 @@ static OpResult NodeByLabelScanInit(OpBase *opBase) {
 		return OP_OK;
 	}
 
+	OpBase_UpdateConsumeBatch(opBase, NodeByLabelScanConsumeBatch);
 	return OP_OK;
 }
 
@@ -100,9 +118,7 @@ static inline void _UpdateRecord(NodeByLabelScan *op, Record r, GrB_Index node_i
 }
 
 static inline void _ResetIterator(NodeByLabelScan *op) {
-	NodeID minId = op->id_range->include_min ? op->id_range->min : op->id_range->min + 1;
-	NodeID maxId = op->id_range->include_max ? op->id_range->max : op->id_range->max - 1 ;
-	GxB_MatrixTupleIter_iterate_range(op->iter, minId, maxId);
+	_IterateRange(op);
 }
 
 static Record NodeByLabelScanConsumeFromChild(OpBase *opBase) {
@@ -165,6 +181,26 @@ static Record NodeByLabelScanConsume(OpBase *opBase) {
 	return r;
 }
 
+static uint NodeByLabelScanConsumeBatch(OpBase *opBase, RecordBatch *batch) {
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
+
+	uint count = 0;
+	GrB_Index nodeId;
+	bool depleted = false;
+	while(count < RECORD_BATCH_CAP) {
+		GxB_MatrixTupleIter_next(op->iter, NULL, &nodeId, NULL, &depleted);
+		if(depleted) break;
+
+		Record r = OpBase_CreateRecord((OpBase *)op);
+		// Populate the Record with the actual node.
+		_UpdateRecord(op, r, nodeId);
+		batch->records[count++] = r;
+	}
+
+	batch->count = count;
+	return count;
+}
+
 /* This function is invoked when the op has no children and no valid label is requested (either no label, or non existing label).
  * The op simply needs to return NULL */
 static Record NodeByLabelScanNoOp(OpBase *opBase) {
@@ -182,9 +218,14 @@ static OpResult NodeByLabelScanReset(OpBase *ctx) {
 }
 
 static OpBase *NodeByLabelScanClone(const ExecutionPlan *plan, const OpBase *opBase) {
-	ASSERT(opBase->type == OPType_NODE_BY_LABEL_SCAN);
+	ASSERT(opBase->type == OPType_NODE_BY_LABEL_SCAN ||
+		   opBase->type == OPType_NODE_BY_LABEL_AND_ID_SCAN);
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 	OpBase *clone = NewNodeByLabelScanOp(plan, op->n);
+	// Retain ID range of a label and ID scan.
+	if(opBase->type == OPType_NODE_BY_LABEL_AND_ID_SCAN) {
+		NodeByLabelScanOp_SetIDRange((NodeByLabelScan *)clone, op->id_range);
+	}
 	return clone;
 }
 
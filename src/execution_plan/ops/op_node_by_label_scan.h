@@ -22,6 +22,8 @@ typedef struct {
 	NodeScanCtx n;           /* Label data of node being scanned. */
 	unsigned int nodeRecIdx;    /* Node position within record. */
 	UnsignedRange *id_range;    /* ID range to iterate over. */
+	NodeID range_start;         /* Restricts id_range to IDs >= range_start. */
+	NodeID range_end;           /* Restricts id_range to IDs < range_end. */
 	GxB_MatrixTupleIter *iter;
 	Record child_record;        /* The Record this op acts on if it is not a tap. */
 } NodeByLabelScan;
@@ -32,3 +34,7 @@ OpBase *NewNodeByLabelScanOp(const ExecutionPlan *plan, NodeScanCtx n);
 /* Transform a simple label scan to perform additional range query over the label  matrix. */
 void NodeByLabelScanOp_SetIDRange(NodeByLabelScan *op, UnsignedRange *id_range);
 
+/* Restrict scan to nodes with an ID within [start, end),
+ * takes effect once the operation is reset. */
+void NodeByLabelScanOp_SetRange(NodeByLabelScan *op, NodeID start, NodeID end);
+
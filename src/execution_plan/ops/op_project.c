@@ -13,6 +13,8 @@
 
 /* Forward declarations. */
 static Record ProjectConsume(OpBase *opBase);
+static uint ProjectConsumeBatch(OpBase *opBase, RecordBatch *batch);
+static OpResult ProjectReset(OpBase *opBase);
 static OpBase *ProjectClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ProjectFree(OpBase *opBase);
 
@@ -27,7 +29,8 @@ OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps) {
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_PROJECT, "Project", NULL, ProjectConsume,
-				NULL, NULL, ProjectClone, ProjectFree, false, plan);
+				ProjectReset, NULL, ProjectClone, ProjectFree, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, ProjectConsumeBatch);
 
 	for(uint i = 0; i < op->exp_count; i ++) {
 		// The projected record will associate values with their resolved name
@@ -39,22 +42,9 @@ OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps) {
 	return (OpBase *)op;
 }
 
-static Record ProjectConsume(OpBase *opBase) {
-	OpProject *op = (OpProject *)opBase;
-
-	if(op->op.childCount) {
-		OpBase *child = op->op.children[0];
-		op->r = OpBase_Consume(child);
-		if(!op->r) return NULL;
-	} else {
-		// QUERY: RETURN 1+2
-		// Return a single record followed by NULL on the second call.
-		if(op->singleResponse) return NULL;
-		op->singleResponse = true;
-		op->r = OpBase_CreateRecord(opBase);
-	}
-
-	op->projection = OpBase_CreateRecord(opBase);
+// Project op->r into a new record, op->r is released.
+static Record _ProjectRecord(OpProject *op) {
+	op->projection = OpBase_CreateRecord((OpBase *)op);
 
 	for(uint i = 0; i < op->exp_count; i++) {
 		AR_ExpNode *exp = op->exps[i];
@@ -82,6 +72,53 @@ static Record ProjectConsume(OpBase *opBase) {
 	return projection;
 }
 
+static Record ProjectConsume(OpBase *opBase) {
+	OpProject *op = (OpProject *)opBase;
+
+	if(op->op.childCount) {
+		OpBase *child = op->op.children[0];
+		op->r = OpBase_Consume(child);
+		if(!op->r) return NULL;
+	} else {
+		// QUERY: RETURN 1+2
+		// Return a single record followed by NULL on the second call.
+		if(op->singleResponse) return NULL;
+		op->singleResponse = true;
+		op->r = OpBase_CreateRecord(opBase);
+	}
+
+	return _ProjectRecord(op);
+}
+
+static uint ProjectConsumeBatch(OpBase *opBase, RecordBatch *batch) {
+	OpProject *op = (OpProject *)opBase;
+
+	if(op->op.childCount == 0) {
+		// QUERY: RETURN 1+2
+		// A single record, nothing to batch.
+		Record r = ProjectConsume(opBase);
+		batch->count = 0;
+		if(r) batch->records[batch->count++] = r;
+		return batch->count;
+	}
+
+	// Project each record in place.
+	OpBase *child = op->op.children[0];
+	uint count = OpBase_ConsumeBatch(child, batch);
+	for(uint i = 0; i < count; i++) {
+		op->r = batch->records[i];
+		batch->records[i] = _ProjectRecord(op);
+	}
+
+	return count;
+}
+
+static OpResult ProjectReset(OpBase *opBase) {
+	OpProject *op = (OpProject *)opBase;
+	op->singleResponse = false;
+	return OP_OK;
+}
+
 static OpBase *ProjectClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_PROJECT);
 	OpProject *op = (OpProject *)opBase;
@@ -13,7 +13,9 @@
 
 /* Forward declarations. */
 static Record ResultsConsume(OpBase *opBase);
+static uint ResultsConsumeBatch(OpBase *opBase, RecordBatch *batch);
 static OpResult ResultsInit(OpBase *opBase);
+static OpResult ResultsReset(OpBase *opBase);
 static OpBase *ResultsClone(const ExecutionPlan *plan, const OpBase *opBase);
 
 OpBase *NewResultsOp(const ExecutionPlan *plan) {
@@ -21,7 +23,8 @@ OpBase *NewResultsOp(const ExecutionPlan *plan) {
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_RESULTS, "Results", ResultsInit, ResultsConsume,
-				NULL, NULL, ResultsClone, NULL, false, plan);
+				ResultsReset, NULL, ResultsClone, NULL, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, ResultsConsumeBatch);
 
 	return (OpBase *)op;
 }
@@ -33,6 +36,12 @@ static OpResult ResultsInit(OpBase *opBase) {
 	return OP_OK;
 }
 
+/* A reset plan is executed again, possibly on behalf of another query,
+ * bind to the current query's result set. */
+static OpResult ResultsReset(OpBase *opBase) {
+	return ResultsInit(opBase);
+}
+
 /* Results consume operation
  * called each time a new result record is required */
 static Record ResultsConsume(OpBase *opBase) {
@@ -52,6 +61,36 @@ static Record ResultsConsume(OpBase *opBase) {
 	return r;
 }
 
+/* Results consume batch operation
+ * called each time a new batch of result records is required */
+static uint ResultsConsumeBatch(OpBase *opBase, RecordBatch *batch) {
+	Results *op = (Results *)opBase;
+
+	// enforce result-set size limit
+	batch->count = 0;
+	if(op->result_set_size_limit == 0) return 0;
+
+	OpBase *child = op->op.children[0];
+	uint count = OpBase_ConsumeBatch(child, batch);
+
+	// discard records exceeding the result-set size limit
+	if(count > op->result_set_size_limit) {
+		for(uint i = op->result_set_size_limit; i < count; i++) {
+			OpBase_DeleteRecord(batch->records[i]);
+		}
+		count = op->result_set_size_limit;
+		batch->count = count;
+	}
+	op->result_set_size_limit -= count;
+
+	// append to final result set
+	for(uint i = 0; i < count; i++) {
+		ResultSet_AddRecord(op->result_set, batch->records[i]);
+	}
+
+	return count;
+}
+
 static inline OpBase *ResultsClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_RESULTS);
 	return NewResultsOp(plan);
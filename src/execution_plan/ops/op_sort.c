@@ -178,6 +178,12 @@ static OpResult SortReset(OpBase *ctx) {
 			Record r = array_pop(op->buffer);
 			OpBase_DeleteRecord(r);
 		}
+
+		// When using a heap, the buffer is recreated from the heap.
+		if(op->heap) {
+			array_free(op->buffer);
+			op->buffer = NULL;
+		}
 	}
 
 	return OP_OK;
@@ -7,8 +7,9 @@
 #include "op_value_hash_join.h"
 #include "../../value.h"
 #include "../../util/arr.h"
+#include "../../query_ctx.h"
 #include "../../util/rmalloc.h"
-#include "../../util/qsort.h"
+#include "shared/cardinality_functions.h"
 
 /* Forward declarations. */
 static OpResult ValueHashJoinInit(OpBase *opBase);
@@ -17,155 +18,212 @@ static OpResult ValueHashJoinReset(OpBase *opBase);
 static OpBase *ValueHashJoinClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ValueHashJoinFree(OpBase *opBase);
 
-/* Determins order between two records by inspecting
- * element stored at postion idx. */
-static bool _record_islt(Record l, Record r, uint idx) {
-	SIValue lv = Record_Get(l, idx);
-	SIValue rv = Record_Get(r, idx);
-	return SIValue_Compare(lv, rv, NULL) < 0;
+/* Returns the expression evaluated on records of the given child. */
+static inline AR_ExpNode *_join_exp(const OpValueHashJoin *op, uint child_idx) {
+	return (child_idx == 0) ? op->lhs_exp : op->rhs_exp;
 }
 
-/* `idx` is an actual variable in the caller function.
- * Using it in a macro like this is rather ugly,
- * but the macro passed to QSORT must accept only 2 arguments. */
-#define RECORD_SORT_ON_ENTRY(a, b) (_record_islt((*a), (*b), idx))
-
-// Performs binary search, returns the leftmost index of a match.
-static bool _binarySearchLeftmost(uint *idx, Record *array, uint array_len,
-								  int join_key_idx, SIValue v) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(x, v, NULL) < 0) left = pos + 1;
-		else right = pos;
-	}
+/* Returns the partition holding entries of the given hash. */
+static inline HashJoinPartition *_partition(const OpValueHashJoin *op,
+		XXH64_hash_t hash) {
+	if(op->partition_bits == 0) return op->partitions;
+	return op->partitions + (hash >> (64 - op->partition_bits));
+}
+
+/* Choose which child's records are cached,
+ * the child estimated to produce fewer records is preferred. */
+static void _select_build_side(OpValueHashJoin *op) {
+	Graph *g = QueryCtx_GetGraph();
+	uint64_t lhs = EstimateCardinality(op->op.children[0], g);
+	uint64_t rhs = EstimateCardinality(op->op.children[1], g);
+
+	// Unless both sides are estimated cache the left hand side.
+	bool estimated = (lhs != CARDINALITY_UNKNOWN && rhs != CARDINALITY_UNKNOWN);
+	op->build_idx = (estimated && rhs < lhs) ? 1 : 0;
+}
 
-	// Make sure value was found.
-	*idx = left;
+/* Caches all records coming from the build side child. */
+static void _cache_records(OpValueHashJoin *op) {
+	ASSERT(op->entries == NULL);
 
-	if(left == array_len) return false;
+	OpBase *child = op->op.children[op->build_idx];
+	AR_ExpNode *exp = _join_exp(op, op->build_idx);
+	op->entries = array_new(HashJoinEntry, 32);
 
-	x = Record_Get(array[*idx], join_key_idx);
-	// Return false if the value wasn't found or evaluated to NULL.
-	int disjointOrNull = 0;
-	return (SIValue_Compare(x, v, &disjointOrNull) == 0 &&
-			disjointOrNull != COMPARED_NULL);
+	Record r;
+	// As long as there's data coming in from the build side.
+	while((r = child->consume(child))) {
+		// Evaluate joined expression.
+		SIValue v = AR_EXP_Evaluate(exp, r);
+
+		// If the joined value is NULL, it cannot be compared to other values - skip this record.
+		if(SIValue_IsNull(v)) {
+			OpBase_DeleteRecord(r);
+			continue;
+		}
+
+		// Add joined value to record.
+		Record_AddScalar(r, op->join_value_rec_idx, v);
+
+		// Cache the record.
+		HashJoinEntry e = {.hash = SIValue_HashCode(v), .next = HASH_JOIN_NIL, .r = r};
+		array_append(op->entries, e);
+	}
 }
 
-// Performs binary search, returns the rightmost index of a match.
-// assuming 'v' exists in 'array'
-static bool _binarySearchRightmost(uint *idx, Record *array, uint array_len, int join_key_idx,
-								   SIValue v) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(v, x, NULL) < 0) right = pos;
-		else left = pos + 1;
+/* Reorders entries such that entries of the same partition are adjacent,
+ * sets each partition's first entry position in offsets. */
+static void _partition_entries(OpValueHashJoin *op, uint *offsets) {
+	uint entry_count = array_len(op->entries);
+	uint partition_count = 1 << op->partition_bits;
+
+	// Count entries per partition.
+	memset(offsets, 0, sizeof(uint) * (partition_count + 1));
+	for(uint i = 0; i < entry_count; i++) {
+		offsets[_partition(op, op->entries[i].hash) - op->partitions + 1]++;
 	}
+	for(uint i = 0; i < partition_count; i++) offsets[i + 1] += offsets[i];
 
-	*idx = right - 1;
-	return true;
-}
+	if(partition_count == 1) return;
 
-/* Retrive the next intersecting record
- * if such exists, otherwise returns NULL. */
-static Record _get_intersecting_record(OpValueHashJoin *op) {
-	// No more intersecting records.
-	if(op->intersect_idx == -1 ||
-	   op->number_of_intersections == 0) return NULL;
+	// Scatter entries into their partitions.
+	uint *positions = rm_malloc(sizeof(uint) * partition_count);
+	memcpy(positions, offsets, sizeof(uint) * partition_count);
 
-	Record cr = op->cached_records[op->intersect_idx];
+	HashJoinEntry *entries = array_newlen(HashJoinEntry, entry_count);
+	for(uint i = 0; i < entry_count; i++) {
+		uint p = _partition(op, op->entries[i].hash) - op->partitions;
+		entries[positions[p]++] = op->entries[i];
+	}
+
+	array_free(op->entries);
+	op->entries = entries;
+	rm_free(positions);
+}
 
-	// Update intersection trackers.
-	op->intersect_idx++;
-	op->number_of_intersections--;
+/* Builds partition's hash table over entries [start, end),
+ * entries sharing a hash are chained. */
+static void _build_partition(OpValueHashJoin *op, HashJoinPartition *p,
+		uint start, uint end) {
+	uint entry_count = end - start;
+	if(entry_count == 0) return;
+
+	// Keep the table at most half full.
+	uint64_t slot_count = 2;
+	while(slot_count < (uint64_t)entry_count * 2) slot_count <<= 1;
+
+	p->mask = slot_count - 1;
+	p->slots = rm_malloc(sizeof(uint) * slot_count);
+	memset(p->slots, 0xFF, sizeof(uint) * slot_count);
+
+	for(uint i = start; i < end; i++) {
+		HashJoinEntry *e = op->entries + i;
+		uint64_t slot = e->hash & p->mask;
+
+		// Linear probe for either an empty slot or a chain of the same hash.
+		while(p->slots[slot] != HASH_JOIN_NIL &&
+			  op->entries[p->slots[slot]].hash != e->hash) {
+			slot = (slot + 1) & p->mask;
+		}
 
-	return cr;
+		e->next = p->slots[slot];
+		p->slots[slot] = i;
+	}
 }
 
-/* Look up first intersecting cached record CR position.
- * Returns false if no intersecting record is found. */
-static bool _set_intersection_idx(OpValueHashJoin *op, SIValue v) {
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
-	uint record_count = array_len(op->cached_records);
+/* Builds a hash table over the cached records.
+ * Large builds are split into partitions by the hash's high bits,
+ * such that each partition's table remains small. */
+static void _build_hash_table(OpValueHashJoin *op) {
+	uint entry_count = array_len(op->entries);
+
+	op->partition_bits = 0;
+	while(((uint64_t)entry_count >> op->partition_bits) > HASH_JOIN_PARTITION_CAP) {
+		op->partition_bits++;
+	}
+
+	uint partition_count = 1 << op->partition_bits;
+	op->partitions = rm_calloc(partition_count, sizeof(HashJoinPartition));
 
-	uint leftmost_idx = 0;
-	uint rightmost_idx = 0;
+	uint *offsets = rm_malloc(sizeof(uint) * (partition_count + 1));
+	_partition_entries(op, offsets);
 
-	if(!_binarySearchLeftmost(&leftmost_idx, op->cached_records,
-							  array_len(op->cached_records), op->join_value_rec_idx, v)) {
-		return false;
+	for(uint i = 0; i < partition_count; i++) {
+		_build_partition(op, op->partitions + i, offsets[i], offsets[i + 1]);
 	}
 
-	/* Value was found
-	 * idx points to the first intersecting record.
-	 * update number_of_intersections to count how many
-	 * records share the same value. */
-	op->intersect_idx = leftmost_idx;
-
-	/* Count how many records share the same node.
-	 * reduce search space by truncating left bound */
-	bool found = _binarySearchRightmost(&rightmost_idx, op->cached_records +
-								  leftmost_idx, record_count - leftmost_idx,
-								  op->join_value_rec_idx, v);
-	UNUSED(found);
-	ASSERT(found == true);
-
-	// Compensate index.
-	rightmost_idx += leftmost_idx;
-	// +1 consider rightmost_idx == leftmost_idx.
-	op->number_of_intersections = rightmost_idx - leftmost_idx + 1;
-	ASSERT(op->number_of_intersections > 0);
-
-	return true;
+	rm_free(offsets);
 }
 
-/* Sorts cached records by joined value. */
-void _sort_cached_records(OpValueHashJoin *op) {
-	uint idx = op->join_value_rec_idx;
-	QSORT(Record, op->cached_records,
-		  array_len(op->cached_records), RECORD_SORT_ON_ENTRY);
+/* Locate the chain of cached records which share v's hash. */
+static void _probe(OpValueHashJoin *op, SIValue v) {
+	op->match_idx = HASH_JOIN_NIL;
+
+	XXH64_hash_t hash = SIValue_HashCode(v);
+	HashJoinPartition *p = _partition(op, hash);
+	if(p->slots == NULL) return;
+
+	uint64_t slot = hash & p->mask;
+	while(p->slots[slot] != HASH_JOIN_NIL) {
+		if(op->entries[p->slots[slot]].hash == hash) {
+			op->match_idx = p->slots[slot];
+			return;
+		}
+		slot = (slot + 1) & p->mask;
+	}
 }
 
-/* Caches all records coming from left branch. */
-void _cache_records(OpValueHashJoin *op) {
-	ASSERT(op->cached_records == NULL);
+/* Retrive the next cached record intersecting with the probe record
+ * if such exists, otherwise returns NULL. */
+static Record _get_intersecting_record(OpValueHashJoin *op) {
+	while(op->match_idx != HASH_JOIN_NIL) {
+		HashJoinEntry *e = op->entries + op->match_idx;
+		op->match_idx = e->next;
+
+		// Entries of the same hash may hold different values.
+		int disjointOrNull = 0;
+		SIValue x = Record_Get(e->r, op->join_value_rec_idx);
+		if(SIValue_Compare(x, op->probe_value, &disjointOrNull) == 0 &&
+		   disjointOrNull != COMPARED_NULL) {
+			return e->r;
+		}
+	}
 
-	OpBase *left_child = op->op.children[0];
-	op->cached_records = array_new(Record, 32);
+	return NULL;
+}
 
-	Record r = left_child->consume(left_child);
-	if(!r) return;
+/* Release the current probe record. */
+static void _clear_probe(OpValueHashJoin *op) {
+	op->match_idx = HASH_JOIN_NIL;
 
-	// As long as there's data coming in from left branch.
-	do {
-		// Evaluate joined expression.
-		SIValue v = AR_EXP_Evaluate(op->lhs_exp, r);
+	SIValue_Free(op->probe_value);
+	op->probe_value = SI_NullVal();
 
-		// If the joined value is NULL, it cannot be compared to other values - skip this record.
-		if(SIValue_IsNull(v)) continue;
+	if(op->probe_rec) {
+		OpBase_DeleteRecord(op->probe_rec);
+		op->probe_rec = NULL;
+	}
+}
 
-		// Add joined value to record.
-		Record_AddScalar(r, op->join_value_rec_idx, v);
+/* Frees cached records and the hash table. */
+static void _free_hash_table(OpValueHashJoin *op) {
+	if(op->partitions) {
+		uint partition_count = 1 << op->partition_bits;
+		for(uint i = 0; i < partition_count; i++) {
+			if(op->partitions[i].slots) rm_free(op->partitions[i].slots);
+		}
+		rm_free(op->partitions);
+		op->partitions = NULL;
+	}
 
-		// Cache the record.
-		array_append(op->cached_records, r);
-	} while((r = left_child->consume(left_child)));
+	if(op->entries) {
+		uint record_count = array_len(op->entries);
+		for(uint i = 0; i < record_count; i++) {
+			OpBase_DeleteRecord(op->entries[i].r);
+		}
+		array_free(op->entries);
+		op->entries = NULL;
+	}
 }
 
 /* String representation of operation */
@@ -192,18 +250,29 @@ static int ValueHashJoinToString(const OpBase *ctx, char *buff, uint buff_len) {
 	offset += snprintf(buff + offset, buff_len - offset, "%s", exp_str);
 	rm_free(exp_str);
 
+	// Once records are cached, report which side they came from.
+	if(op->entries) {
+		AR_EXP_ToString(_join_exp(op, op->build_idx), &exp_str);
+		offset += snprintf(buff + offset, buff_len - offset, " | Cached: %s",
+				exp_str);
+		rm_free(exp_str);
+	}
+
 	return offset;
 }
 
 /* Creates a new valueHashJoin operation */
 OpBase *NewValueHashJoin(const ExecutionPlan *plan, AR_ExpNode *lhs_exp, AR_ExpNode *rhs_exp) {
 	OpValueHashJoin *op = rm_malloc(sizeof(OpValueHashJoin));
-	op->rhs_rec = NULL;
+	op->entries = NULL;
 	op->lhs_exp = lhs_exp;
 	op->rhs_exp = rhs_exp;
-	op->intersect_idx = -1;
-	op->cached_records = NULL;
-	op->number_of_intersections = 0;
+	op->build_idx = 0;
+	op->probe_rec = NULL;
+	op->partitions = NULL;
+	op->probe_value = SI_NullVal();
+	op->partition_bits = 0;
+	op->match_idx = HASH_JOIN_NIL;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_VALUE_HASH_JOIN, "Value Hash Join", ValueHashJoinInit,
@@ -216,6 +285,7 @@ OpBase *NewValueHashJoin(const ExecutionPlan *plan, AR_ExpNode *lhs_exp, AR_ExpN
 
 static OpResult ValueHashJoinInit(OpBase *ctx) {
 	ASSERT(ctx->childCount == 2);
+	_select_build_side((OpValueHashJoin *)ctx);
 	return OP_OK;
 }
 
@@ -224,88 +294,63 @@ static OpResult ValueHashJoinInit(OpBase *ctx) {
  * of this operation. */
 static Record ValueHashJoinConsume(OpBase *opBase) {
 	OpValueHashJoin *op = (OpValueHashJoin *)opBase;
-	OpBase *right_child = op->op.children[1];
+	uint probe_idx = 1 - op->build_idx;
+	OpBase *probe_child = op->op.children[probe_idx];
 
-	// Eager, pull from left branch until depleted.
-	if(op->cached_records == NULL) {
+	// Eager, pull from build side until depleted.
+	if(op->entries == NULL) {
 		_cache_records(op);
-		// Sort cache on intersect node ID.
-		_sort_cached_records(op);
+		// Index cache on joined value.
+		_build_hash_table(op);
 	}
 
+	// No cached records, nothing to join with.
+	if(array_len(op->entries) == 0) return NULL;
+
 	/* Try to produce a record:
-	 * given a right hand side record R,
+	 * given a probe side record R,
 	 * evaluate V = exp on R,
 	 * see if there are any cached records
-	 * which V evaluated to V:
-	 * X in cached_records and X[idx] = V
+	 * which evaluated to V:
+	 * X in cached records and X[idx] = V
 	 * return merged record:
 	 * X merged with R. */
 
 	Record l;
-	if(op->number_of_intersections > 0) {
-		while((l = _get_intersecting_record(op))) {
-			// Clone cached record before merging rhs.
+	while(true) {
+		if(op->probe_rec && (l = _get_intersecting_record(op))) {
+			// Clone cached record before merging probe record.
 			Record c = OpBase_CloneRecord(l);
-			Record_Merge(c, op->rhs_rec);
+			Record_Merge(c, op->probe_rec);
 			return c;
 		}
-	}
 
-	/* If we're here there are no more
-	 * left hand side records which intersect with R
-	 * discard R. */
-	if(op->rhs_rec) OpBase_DeleteRecord(op->rhs_rec);
+		/* If we're here there are no more
+		 * cached records which intersect with R
+		 * discard R. */
+		_clear_probe(op);
 
-	/* Try to get new right hand side record
-	 * which intersect with a left hand side record. */
-	while(true) {
-		// Pull from right branch.
-		op->rhs_rec = right_child->consume(right_child);
-		if(!op->rhs_rec) return NULL;
+		// Pull from probe side.
+		op->probe_rec = probe_child->consume(probe_child);
+		if(!op->probe_rec) return NULL;
 
 		// Get value on which we're intersecting.
-		SIValue v = AR_EXP_Evaluate(op->rhs_exp, op->rhs_rec);
+		op->probe_value = AR_EXP_Evaluate(_join_exp(op, probe_idx), op->probe_rec);
 
-		bool found_intersection = _set_intersection_idx(op, v);
-		SIValue_Free(v);
-		// No intersection, discard R.
-		if(!found_intersection) {
-			OpBase_DeleteRecord(op->rhs_rec);
-			continue;
-		}
-
-		// Found atleast one intersecting record.
-		l = _get_intersecting_record(op);
-
-		// Clone cached record before merging rhs.
-		Record c = OpBase_CloneRecord(l);
-		Record_Merge(c, op->rhs_rec);
+		// NULL values do not intersect with any value.
+		if(SIValue_IsNull(op->probe_value)) continue;
 
-		return c;
+		_probe(op, op->probe_value);
 	}
 }
 
 static OpResult ValueHashJoinReset(OpBase *ctx) {
 	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
 
-	// Clear cached records.
-	if(op->rhs_rec) {
-		OpBase_DeleteRecord(op->rhs_rec);
-		op->rhs_rec = NULL;
-	}
+	_clear_probe(op);
 
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	// Clear cached records.
+	_free_hash_table(op);
 
 	return OP_OK;
 }
@@ -319,21 +364,11 @@ static inline OpBase *ValueHashJoinClone(const ExecutionPlan *plan, const OpBase
 /* Frees ValueHashJoin */
 static void ValueHashJoinFree(OpBase *ctx) {
 	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
-	// Free cached records.
-	if(op->rhs_rec) {
-		OpBase_DeleteRecord(op->rhs_rec);
-		op->rhs_rec = NULL;
-	}
 
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	_clear_probe(op);
+
+	// Free cached records.
+	_free_hash_table(op);
 
 	if(op->lhs_exp) {
 		AR_EXP_Free(op->lhs_exp);
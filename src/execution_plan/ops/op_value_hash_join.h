@@ -10,16 +10,37 @@
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+// Marks an empty hash table slot and the end of an entries chain.
+#define HASH_JOIN_NIL UINT_MAX
+
+// Maximum number of cached records per partition of the hash table.
+#define HASH_JOIN_PARTITION_CAP 65536
+
+typedef struct {
+	XXH64_hash_t hash;                  // Hash of the joined value.
+	uint next;                          // Next entry of the same hash, HASH_JOIN_NIL if last.
+	Record r;                           // Cached record.
+} HashJoinEntry;
+
+typedef struct {
+	uint *slots;                        // Open addressing table of chain heads.
+	uint64_t mask;                      // Number of slots - 1.
+} HashJoinPartition;
+
 typedef struct {
 	OpBase op;
-	Record rhs_rec;                     // Right hand side record.
+	Record probe_rec;                   // Current probe side record.
+	SIValue probe_value;                // Joined value of the current probe side record.
 	AR_ExpNode *lhs_exp;                // Left hand side expression to join on.
 	AR_ExpNode *rhs_exp;                // Right hand side expression to join on.
-	int64_t intersect_idx;              // Current intersection, < number_of_intersections
-	Record *cached_records;             // Cached left hand side records.
+	uint build_idx;                     // Index of the child whose records are cached.
+	HashJoinEntry *entries;             // Cached build side records, grouped by partition.
+	HashJoinPartition *partitions;      // Hash table partitions.
+	uint partition_bits;                // Number of hash bits selecting a partition.
+	uint match_idx;                     // Next entry to inspect for a match.
 	uint join_value_rec_idx;            // position on joined expression within record.
-	int64_t number_of_intersections;    // Number of intersections located.
 } OpValueHashJoin;
 
 /* Creates a new ValueHashJoin operation */
 OpBase *NewValueHashJoin(const ExecutionPlan *plan, AR_ExpNode *lhs_exp, AR_ExpNode *rhs_exp);
+
@@ -14,6 +14,8 @@
 #include "op_filter.h"
 #include "op_node_by_label_scan.h"
 #include "op_index_scan.h"
+#include "op_composite_index_scan.h"
+#include "op_edge_index_scan.h"
 #include "op_update.h"
 #include "op_conditional_traverse.h"
 #include "op_cartesian_product.h"
@@ -37,4 +39,5 @@
 #include "op_semi_apply.h"
 #include "op_apply_multiplexer.h"
 #include "op_optional.h"
+#include "op_gather.h"
 
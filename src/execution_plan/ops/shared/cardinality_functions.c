@@ -0,0 +1,116 @@
+/*
+ * Copyright 2018-2021 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include <math.h>
+#include <string.h>
+#include "cardinality_functions.h"
+#include "../op_node_by_label_scan.h"
+#include "../op_index_scan.h"
+#include "../op_composite_index_scan.h"
+#include "../op_edge_index_scan.h"
+#include "../op_conditional_traverse.h"
+#include "../../../util/arr.h"
+
+static uint64_t _LabelCardinality(const Graph *g, int label_id) {
+	// Label doesn't exist, no nodes carry it.
+	if(label_id < 0) return 0;
+	return Graph_LabeledNodeCount(g, label_id);
+}
+
+// A scan which isn't a tap is performed once per input record.
+static uint64_t _ScanCardinality(const OpBase *op, const Graph *g, uint64_t scanned) {
+	if(op->childCount == 0) return scanned;
+
+	uint64_t child = EstimateCardinality(op->children[0], g);
+	if(child == CARDINALITY_UNKNOWN) return CARDINALITY_UNKNOWN;
+	return child * scanned;
+}
+
+double EstimateFanOut(const Graph *g, const QGEdge *e, bool outgoing) {
+	GRAPH_EDGE_DIR dir = outgoing ? GRAPH_EDGE_DIR_OUTGOING : GRAPH_EDGE_DIR_INCOMING;
+	if(e->bidirectional) dir = GRAPH_EDGE_DIR_BOTH;
+
+	uint reltype_count = array_len(e->reltypeIDs);
+	if(reltype_count == 0) {
+		// Any relationship type, average over all nodes.
+		uint64_t nodes = Graph_NodeCount(g);
+		if(nodes == 0) return 0;
+		double degree = (double)Graph_EdgeCount(g) / nodes;
+		return (dir == GRAPH_EDGE_DIR_BOTH) ? degree * 2 : degree;
+	}
+
+	double degree = 0;
+	for(uint i = 0; i < reltype_count; i++) {
+		// Relationship type doesn't exist, no edges carry it.
+		if(e->reltypeIDs[i] < 0) continue;
+		degree += Graph_RelationAvgDegree(g, e->reltypeIDs[i], dir);
+	}
+	return degree;
+}
+
+uint64_t EstimateTraverseFanOut(const OpBase *base, const Graph *g) {
+	ASSERT(base->type == OPType_CONDITIONAL_TRAVERSE);
+	const OpCondTraverse *op = (const OpCondTraverse *)base;
+
+	const char *edge = AlgebraicExpression_Edge(op->ae);
+	QueryGraph *qg = op->op.plan->query_graph;
+	QGEdge *e = (edge && qg) ? QueryGraph_GetEdgeByAlias(qg, edge) : NULL;
+
+	// Fall back to the graph's average degree
+	// when the traversed edge can't be resolved.
+	if(e == NULL) {
+		uint64_t nodes = Graph_NodeCount(g);
+		if(nodes == 0) return 0;
+		return (Graph_EdgeCount(g) + nodes - 1) / nodes;
+	}
+
+	const char *src = AlgebraicExpression_Source(op->ae);
+	bool outgoing = strcmp(src, e->src->alias) == 0;
+	return ceil(EstimateFanOut(g, e, outgoing));
+}
+
+uint64_t EstimateCardinality(const OpBase *op, const Graph *g) {
+	switch(op->type) {
+		case OPType_ALL_NODE_SCAN:
+			return _ScanCardinality(op, g, Graph_NodeCount(g));
+		case OPType_NODE_BY_LABEL_SCAN:
+			return _ScanCardinality(op, g,
+					_LabelCardinality(g, ((const NodeByLabelScan *)op)->n.label_id));
+		case OPType_INDEX_SCAN:
+			return _ScanCardinality(op, g,
+					_LabelCardinality(g, ((const IndexScan *)op)->n.label_id));
+		case OPType_COMPOSITE_INDEX_SCAN:
+			return _ScanCardinality(op, g,
+					_LabelCardinality(g, ((const CompositeIndexScan *)op)->n.label_id));
+		case OPType_EDGE_INDEX_SCAN: {
+			// Bounded by the number of edges of the scanned relationship type.
+			int relation_id = ((const EdgeIndexScan *)op)->relation_id;
+			if(relation_id < 0) return 0;
+			return Graph_RelationEdgeCount(g, relation_id);
+		}
+		case OPType_ARGUMENT:
+			return 1;
+		case OPType_FILTER:
+		case OPType_PROJECT:
+		case OPType_SORT:
+		case OPType_DISTINCT:
+		case OPType_GATHER:
+			// Operations which never produce more records than they consume.
+			return EstimateCardinality(op->children[0], g);
+		case OPType_CONDITIONAL_TRAVERSE: {
+			// Each record is expanded by the average degree
+			// of the traversed relationship types.
+			uint64_t child = EstimateCardinality(op->children[0], g);
+			if(child == CARDINALITY_UNKNOWN) return CARDINALITY_UNKNOWN;
+			if(Graph_NodeCount(g) == 0) return 0;
+			uint64_t degree = EstimateTraverseFanOut(op, g);
+			return child * MAX(degree, 1);
+		}
+		default:
+			return CARDINALITY_UNKNOWN;
+	}
+}
+
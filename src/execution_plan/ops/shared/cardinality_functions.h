@@ -0,0 +1,29 @@
+/*
+ * Copyright 2018-2021 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include "../op.h"
+#include "../../../graph/graph.h"
+#include "../../../graph/entities/qg_edge.h"
+
+// Returned when the number of records produced by an operation is unknown.
+#define CARDINALITY_UNKNOWN UINT64_MAX
+
+/* Estimates an upper bound on the number of records produced by op
+ * from the graph's node and edge counts, returns CARDINALITY_UNKNOWN
+ * if no estimation can be made. */
+uint64_t EstimateCardinality(const OpBase *op, const Graph *g);
+
+/* Estimates the number of edges reached from a single node traversing 'e'
+ * out of the average degree of its relationship types,
+ * 'outgoing' is set if traversal follows the edge direction. */
+double EstimateFanOut(const Graph *g, const QGEdge *e, bool outgoing);
+
+/* Estimates the number of records a Conditional Traverse operation
+ * produces out of every record it consumes, rounded up. */
+uint64_t EstimateTraverseFanOut(const OpBase *op, const Graph *g);
+
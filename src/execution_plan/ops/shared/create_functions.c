@@ -117,6 +117,8 @@ static void _CommitEdges(PendingCreations *pending) {
 
 		if(pending->edge_properties[i]) _AddProperties(pending->stats, (GraphEntity *)e,
 														   pending->edge_properties[i]);
+
+		if(Schema_HasIndices(schema)) Schema_AddEdgeToIndices(schema, e);
 	}
 }
 
@@ -42,7 +42,7 @@ static int _UpdateEntity(PendingUpdateCtx *update) {
 }
 
 static PendingUpdateCtx _PreparePendingUpdate(GraphContext *gc, SIType accepted_properties,
-											  int label_id, GraphEntity *entity,
+											  int label_id, SchemaType t, GraphEntity *entity,
 											  Attribute_ID attr_id, SIValue new_value) {
 	//--------------------------------------------------------------------------
 	// validate value type
@@ -60,18 +60,33 @@ static PendingUpdateCtx _PreparePendingUpdate(GraphContext *gc, SIType accepted_
 	if(label_id != GRAPH_NO_LABEL) {
 		// if the (label:attribute) combination has an index, take note
 		update_index = GraphContext_GetIndexByID(gc, label_id, &attr_id,
-												 IDX_ANY) != NULL;
+												 IDX_ANY, t) != NULL;
+		// composite indices hold a copy of both key and included attributes
+		if(!update_index && t == SCHEMA_NODE) {
+			Schema *s = GraphContext_GetSchemaByID(gc, label_id, SCHEMA_NODE);
+			update_index = Schema_CompositeIndexCovers(s, attr_id);
+		}
 	}
 
 	return (PendingUpdateCtx) {
 		.ge            =  entity,
 		.attr_id       =  attr_id,
+		.t             =  t,
 		.label_id      =  label_id,
 		.new_value     =  new_value,
 		.update_index  =  update_index,
 	};
 }
 
+// introduce an updated entity to the indices of its schema
+static void _ReindexEntity(GraphContext *gc, const PendingUpdateCtx *update) {
+	Schema *s = GraphContext_GetSchemaByID(gc, update->label_id, update->t);
+	ASSERT(s != NULL);
+
+	if(update->t == SCHEMA_NODE) Schema_AddNodeToIndices(s, (Node *)update->ge);
+	else Schema_AddEdgeToIndices(s, (Edge *)update->ge);
+}
+
 // commits delayed updates
 void CommitUpdates(GraphContext *gc, ResultSetStatistics *stats,
 				   PendingUpdateCtx *updates) {
@@ -80,7 +95,6 @@ void CommitUpdates(GraphContext *gc, ResultSetStatistics *stats,
 	ASSERT(updates != NULL);
 
 	uint    properties_set  =  0;
-	Schema  *s              =  NULL;
 	bool    reindex         =  false;
 	uint    update_count    =  array_len(updates);
 
@@ -96,13 +110,8 @@ void CommitUpdates(GraphContext *gc, ResultSetStatistics *stats,
 		// following updates apply to a new graph entity
 		// index previous entity if we're required to
 		if(ge != updates[i].ge) {
-			if(reindex) {
-				s = GraphContext_GetSchemaByID(gc, updates[i - 1].label_id,
-											   SCHEMA_NODE);
-				ASSERT(s != NULL);
-				// introduce updated entity to index
-				Schema_AddNodeToIndices(s, (Node *)ge);
-			}
+			// introduce updated entity to index
+			if(reindex) _ReindexEntity(gc, updates + i - 1);
 
 			// update state
 			reindex  =  false;
@@ -120,20 +129,15 @@ void CommitUpdates(GraphContext *gc, ResultSetStatistics *stats,
 	}
 
 	// handle last updated entity
-	if(reindex) {
-		s = GraphContext_GetSchemaByID(gc, updates[i - 1].label_id, SCHEMA_NODE);
-		ASSERT(s != NULL);
-		// introduce updated entity to index
-		Schema_AddNodeToIndices(s, (Node *)ge);
-	}
+	if(reindex) _ReindexEntity(gc, updates + i - 1);
 
 	if(stats) stats->properties_set += properties_set;
 }
 
 void EvalEntityUpdates(GraphContext *gc, PendingUpdateCtx **updates,
 		const Record r, const EntityUpdateEvalCtx *ctx, bool allow_null) {
-	Schema *s         = NULL;
 	int label_id      = GRAPH_NO_LABEL;
+	SchemaType st     = SCHEMA_NODE;
 	bool node_update  = false;
 
 	//--------------------------------------------------------------------------
@@ -160,6 +164,16 @@ void EvalEntityUpdates(GraphContext *gc, PendingUpdateCtx **updates,
 		Node *n = (Node *)entity;
 		// retrieve the node's Label ID from a local member or the graph
 		label_id = NODE_GET_LABEL_ID(n, gc->g);
+	} else {
+		// edges are reindexed only if their relationship type is indexed
+		Edge *e = (Edge *)entity;
+		int relation_id = Edge_GetRelationID(e);
+		if(relation_id < 0) relation_id = Graph_GetEdgeRelation(gc->g, e);
+		Schema *s = GraphContext_GetSchemaByID(gc, relation_id, SCHEMA_EDGE);
+		if(s != NULL && Schema_HasIndices(s)) {
+			st = SCHEMA_EDGE;
+			label_id = relation_id;
+		}
 	}
 
 	// if this update replaces all existing properties
@@ -167,6 +181,7 @@ void EvalEntityUpdates(GraphContext *gc, PendingUpdateCtx **updates,
 	if(ctx->mode == UPDATE_REPLACE) {
 		PendingUpdateCtx update = {
 			.ge            = entity,
+			.t             = st,
 			.label_id      = label_id,
 			.update_index  = (label_id != GRAPH_NO_LABEL),
 			.attr_id       = ATTRIBUTE_ALL,
@@ -205,7 +220,7 @@ void EvalEntityUpdates(GraphContext *gc, PendingUpdateCtx **updates,
 						key.stringval);
 
 				update = _PreparePendingUpdate(gc, accepted_properties,
-						label_id, entity, attr_id, value);
+						label_id, st, entity, attr_id, value);
 				// enqueue the current update
 				array_append(*updates, update);
 			}
@@ -213,7 +228,7 @@ void EvalEntityUpdates(GraphContext *gc, PendingUpdateCtx **updates,
 		}
 
 		update = _PreparePendingUpdate(gc, accepted_properties, label_id,
-				entity, attr_id, new_value);
+				st, entity, attr_id, new_value);
 		// enqueue the current update
 		array_append(*updates, update);
 	}
@@ -11,7 +11,8 @@
 // context representing a single update to perform on an entity
 typedef struct {
 	GraphEntity *ge;       // entity to be updated
-	int label_id;          // label ID if the updated entity is a node
+	int label_id;          // label or relationship type ID of the updated entity
+	SchemaType t;          // whether 'label_id' refers to a label or a relationship type
 	bool update_index;     // whether an index is affected by update
 	SIValue new_value;     // constant value to set
 	Attribute_ID attr_id;  // ID of attribute to update
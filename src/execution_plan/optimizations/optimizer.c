@@ -47,10 +47,17 @@ void optimizePlan(ExecutionPlan *plan) {
 	// Try to reduce execution plan incase it perform node or edge counting.
 	reduceCount(plan);
 
+	// Try to replace per node edge counting with degree lookups.
+	reduceDegreeCount(plan);
+
 	// Let operations know about specified limit(s)
 	applyLimit(plan);
 
 	// Let operations know about specified skip(s)
 	applySkip(plan);
+
+	// Execute scan pipelines over large graphs in parallel,
+	// performed last as it relies on the final shape of the pipelines.
+	parallelizeScans(plan);
 }
 
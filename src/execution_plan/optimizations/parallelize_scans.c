@@ -0,0 +1,82 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "../ops/ops.h"
+#include "../../util/arr.h"
+#include "../../query_ctx.h"
+#include "../../util/thpool/pools.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+/* The parallelizeScans optimization looks for pipelines of streaming
+ * operations (filters, projections and traversals) fed by a node scan
+ * and consumed by an operation which accumulates its input
+ * (aggregation, sort, distinct or results).
+ * Such pipelines can process disjoint ranges of the scan independently,
+ * in which case a Gather operation is placed at the top of the pipeline
+ * to execute it in parallel and merge its output. */
+
+static inline bool _StreamingOp(const OpBase *op, const ExecutionPlan *plan) {
+	if(op->childCount != 1 || op->plan != plan) return false;
+	switch(op->type) {
+		case OPType_FILTER:
+		case OPType_PROJECT:
+		case OPType_CONDITIONAL_TRAVERSE:
+			return true;
+		default:
+			return false;
+	}
+}
+
+static inline bool _AccumulatingOp(const OpBase *op) {
+	switch(op->type) {
+		case OPType_AGGREGATE:
+		case OPType_SORT:
+		case OPType_DISTINCT:
+		case OPType_RESULTS:
+			return true;
+		default:
+			return false;
+	}
+}
+
+static void _ParallelizeScan(OpBase *scan) {
+	// Scan must be a pipeline's source.
+	if(scan->childCount != 0) return;
+
+	// Climb up the pipeline.
+	OpBase *top = scan;
+	while(top->parent && _StreamingOp(top->parent, scan->plan)) top = top->parent;
+
+	if(top->parent == NULL || !_AccumulatingOp(top->parent)) return;
+
+	ExecutionPlan_PushBelow(top, NewGatherOp(top->plan));
+}
+
+void parallelizeScans(ExecutionPlan *plan) {
+	ASSERT(plan != NULL);
+
+	// Parallel scans are disabled.
+	if(ThreadPools_ParallelCount() == 0) return;
+
+	// Workers only read the graph.
+	AST *ast = QueryCtx_GetAST();
+	if(ast == NULL || !AST_ReadOnly(ast->root)) return;
+
+	// Graph is too small to benefit from parallel scans.
+	Graph *g = QueryCtx_GetGraph();
+	if(g == NULL || Graph_NodeCount(g) < GATHER_MIN_SCAN_SIZE) return;
+
+	const OPType types[] = {OPType_ALL_NODE_SCAN, OPType_NODE_BY_LABEL_SCAN,
+							OPType_NODE_BY_LABEL_AND_ID_SCAN
+						   };
+	OpBase **scan_ops = ExecutionPlan_CollectOpsMatchingType(plan->root, types, 3);
+
+	for(int i = 0; i < array_len(scan_ops); i++) {
+		_ParallelizeScan(scan_ops[i]);
+	}
+
+	array_free(scan_ops);
+}
@@ -0,0 +1,195 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../ops/ops.h"
+#include "../../util/arr.h"
+#include "../../arithmetic/aggregate_funcs/agg_funcs.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+/* The reduceDegreeCount optimization looks for aggregations counting
+ * the edges connected to each node, e.g.
+ * MATCH (n)-[e:R]->() RETURN n, count(e)
+ * in which case both the traversal and the aggregation are replaced by
+ * a lookup of each node's degree, maintained by the graph:
+ * "Scan -> Conditional Traverse -> Aggregate" becomes
+ * "Scan -> Filter (degree > 0) -> Project (n, degree)"
+ *
+ * the rewrite is applied only when:
+ * 1. the traversal is fed by a scan producing each node once,
+ *    otherwise the aggregation sums the records of a repeated node
+ * 2. the traversed edge is referenced, in which case the traversal produces
+ *    a record per edge; an unreferenced edge produces a record per distinct
+ *    neighbour, which differs from the node's degree on multi-edges */
+
+// checks if 'exp' is a variable referring to 'alias'
+static inline bool _IsVariable(const AR_ExpNode *exp, const char *alias) {
+	return (AR_EXP_IsVariadic(exp) &&
+			strcmp(exp->operand.variadic.entity_alias, alias) == 0);
+}
+
+// checks if aggregation counts the records of each 'src' node
+// count(*), count(src), count(dest) or count(edge)
+static bool _CountsTraversedRecords(const OpAggregate *aggregate,
+		const char *src, const char *dest, const char *edge) {
+	// expecting a single key, the source node
+	if(aggregate->key_count != 1 || aggregate->aggregate_count != 1) return false;
+	if(!_IsVariable(aggregate->key_exps[0], src)) return false;
+
+	// make sure aggregation performs counting
+	AR_ExpNode *exp = aggregate->aggregate_exps[0];
+	if(exp->type != AR_EXP_OP ||
+	   exp->op.f->aggregate != true ||
+	   strcasecmp(exp->op.func_name, "count") ||
+	   Aggregate_PerformsDistinct(exp->op.f->privdata) ||
+	   exp->op.child_count != 1) return false;
+
+	// counted value must be present in every record
+	AR_ExpNode *arg = exp->op.children[0];
+	if(AR_EXP_IsConstant(arg)) return SI_TYPE(arg->operand.constant) != T_NULL;
+	return (_IsVariable(arg, src) || _IsVariable(arg, dest) ||
+			_IsVariable(arg, edge));
+}
+
+// locates the single query graph edge connecting 'src' to 'dest'
+// 'outgoing' is set if the edge leaves 'src'
+static QGEdge *_TraversedEdge(const QueryGraph *qg, const char *src,
+		const char *dest, bool *outgoing) {
+	QGNode *n = QueryGraph_GetNodeByAlias(qg, src);
+	if(n == NULL) return NULL;
+
+	QGEdge *edge = NULL;
+	uint edge_count = 0;
+
+	uint out_count = array_len(n->outgoing_edges);
+	for(uint i = 0; i < out_count; i++) {
+		QGEdge *e = n->outgoing_edges[i];
+		if(strcmp(e->dest->alias, dest) != 0) continue;
+		edge = e;
+		*outgoing = true;
+		edge_count++;
+	}
+
+	uint in_count = array_len(n->incoming_edges);
+	for(uint i = 0; i < in_count; i++) {
+		QGEdge *e = n->incoming_edges[i];
+		if(strcmp(e->src->alias, dest) != 0) continue;
+		edge = e;
+		*outgoing = false;
+		edge_count++;
+	}
+
+	return (edge_count == 1) ? edge : NULL;
+}
+
+// checks if 'op' produces each 'alias' node exactly once
+// filters are skipped, as they only discard records
+static bool _ScansEachNodeOnce(const OpBase *op, const char *alias) {
+	while(op->type == OPType_FILTER && op->childCount == 1) {
+		op = op->children[0];
+	}
+
+	switch(op->type) {
+		case OPType_ALL_NODE_SCAN:
+		case OPType_NODE_BY_LABEL_SCAN:
+		case OPType_INDEX_SCAN:
+		case OPType_NODE_BY_ID_SEEK:
+		case OPType_NODE_BY_LABEL_AND_ID_SCAN:
+			break;
+		default:
+			return false;
+	}
+
+	// scan must not be fed by other operations, e.g. an UNWIND
+	if(op->childCount != 0) return false;
+	return (array_len(op->modifies) == 1 &&
+			strcmp(op->modifies[0], alias) == 0);
+}
+
+// build degree(src, reltypes...) expression
+static AR_ExpNode *_DegreeExp(const char *src, const QGEdge *e, bool outgoing) {
+	uint reltype_count = array_len(e->reltypes);
+	AR_ExpNode *exp = AR_EXP_NewOpNode(outgoing ? "outdegree" : "indegree",
+			1 + reltype_count);
+
+	exp->op.children[0] = AR_EXP_NewVariableOperandNode(src);
+	for(uint i = 0; i < reltype_count; i++) {
+		SIValue reltype = SI_ConstStringVal((char *)e->reltypes[i]);
+		exp->op.children[1 + i] = AR_EXP_NewConstOperandNode(reltype);
+	}
+
+	return exp;
+}
+
+static void _reduceDegreeCount(ExecutionPlan *plan, OpAggregate *aggregate) {
+	OpBase *op = (OpBase *)aggregate;
+	if(op->childCount != 1) return;
+
+	OpBase *child = op->children[0];
+	if(child->type != OPType_CONDITIONAL_TRAVERSE) return;
+	OpCondTraverse *traverse = (OpCondTraverse *)child;
+
+	AlgebraicExpression *ae = traverse->ae;
+	const char *src = AlgebraicExpression_Source(ae);
+	const char *dest = AlgebraicExpression_Destination(ae);
+	const char *edge = AlgebraicExpression_Edge(ae);
+	// a record per traversed edge is only produced for a referenced edge
+	if(edge == NULL) return;
+	if(!_CountsTraversedRecords(aggregate, src, dest, edge)) return;
+
+	// each source node must reach the aggregation once
+	if(child->childCount != 1) return;
+	if(!_ScansEachNodeOnce(child->children[0], src)) return;
+
+	// traversal must follow a single, directed, single hop edge
+	bool outgoing;
+	const QueryGraph *qg = child->plan->query_graph;
+	QGEdge *e = _TraversedEdge(qg, src, dest, &outgoing);
+	if(e == NULL || e->bidirectional || QGEdge_VariableLength(e)) return;
+
+	// neither endpoint may be filtered by a label within the traversal
+	// an operand is expected for each relationship type
+	uint reltype_count = array_len(e->reltypes);
+	if(AlgebraicExpression_OperandCount(ae) != MAX(reltype_count, 1)) return;
+	if(QueryGraph_GetNodeByAlias(qg, dest)->label != NULL) return;
+
+	// nodes without edges produce no records
+	AR_ExpNode *degree = _DegreeExp(src, e, outgoing);
+	FT_FilterNode *has_edges = FilterTree_CreatePredicateFilter(OP_GT,
+			AR_EXP_Clone(degree), AR_EXP_NewConstOperandNode(SI_LongVal(0)));
+	OpBase *filter = NewFilterOp(op->plan, has_edges);
+
+	// project the source node alongside its degree
+	AR_ExpNode *key = AR_EXP_Clone(aggregate->key_exps[0]);
+	key->resolved_name = aggregate->key_exps[0]->resolved_name;
+	degree->resolved_name = aggregate->aggregate_exps[0]->resolved_name;
+	AR_ExpNode **exps = array_new(AR_ExpNode *, 2);
+	array_append(exps, key);
+	array_append(exps, degree);
+	OpBase *project = NewProjectOp(op->plan, exps);
+
+	// new execution plan: "... -> Filter -> Project"
+	OpBase *input = child->children[0];
+	ExecutionPlan_RemoveOp(plan, child);
+	OpBase_Free(child);
+
+	ExecutionPlan_PushBelow(input, filter);
+	ExecutionPlan_ReplaceOp(plan, op, project);
+	OpBase_Free(op);
+}
+
+void reduceDegreeCount(ExecutionPlan *plan) {
+	OpBase **aggregations = ExecutionPlan_CollectOps(plan->root,
+			OPType_AGGREGATE);
+
+	uint count = array_len(aggregations);
+	for(uint i = 0; i < count; i++) {
+		_reduceDegreeCount(plan, (OpAggregate *)aggregations[i]);
+	}
+
+	array_free(aggregations);
+}
+
@@ -9,6 +9,7 @@
 #include "../../util/qsort.h"
 #include "../../util/strcmp.h"
 #include "../../util/rmalloc.h"
+#include "../../query_ctx.h"
 #include "traverse_order_utils.h"
 
 // having chosen which algebraic expression will be evaluated first
@@ -201,6 +202,9 @@ static void _order_expressions
 /* Given a set of algebraic expressions representing a graph traversal
  * we pick the order in which the expressions will be evaluated
  * taking into account filters and transposes.
+ * once the graph is populated expressions are ordered by the estimated
+ * number of rows they produce, computed out of label counts, relationship
+ * degrees and index statistics, otherwise by a fixed set of heuristics.
  * 'exps' will be reordered. */
 void orderExpressions
 (
@@ -233,10 +237,25 @@ void orderExpressions
 	TraverseOrder_ScoreExpressions(scored_exps, exps, exp_count, bound_vars,
 								   filtered_entities, qg);
 
-	// Sort scored_exps on score in descending order.
-	// Compare macro used to sort scored expressions.
+	// statistics are meaningless for an empty graph
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	bool cost_based = Graph_NodeCount(gc->g) > 0;
+
+	if(cost_based) {
+		// estimate rows produced by each expression
+		TraverseOrder_CostExpressions(scored_exps, exp_count, gc, bound_vars,
+				filtered_entities, ft, qg);
+
+		// Sort scored_exps on cost in ascending order, breaking ties by score.
+#define cost_cmp(a,b) ((*a).cost < (*b).cost || \
+		((*a).cost == (*b).cost && (*a).score > (*b).score))
+		QSORT(ScoredExp, scored_exps, exp_count, cost_cmp);
+	} else {
+		// Sort scored_exps on score in descending order.
+		// Compare macro used to sort scored expressions.
 #define score_cmp(a,b) ((*a).score > (*b).score)
-	QSORT(ScoredExp, scored_exps, exp_count, score_cmp);
+		QSORT(ScoredExp, scored_exps, exp_count, score_cmp);
+	}
 
 	//--------------------------------------------------------------------------
 	// Find the highest-scoring valid arrangement
@@ -253,10 +272,18 @@ void orderExpressions
 
 	// transpose the winning expression if the destination node is a more
 	// efficient starting point
-	if(_should_transpose_entry_point(qg, exps[0], filtered_entities,
-									 bound_vars)) {
-		AlgebraicExpression_Transpose(exps);
+	bool transpose;
+	if(cost_based) {
+		double src_cost = TraverseOrder_EntryCost(exps[0], false, gc,
+				bound_vars, filtered_entities, ft, qg);
+		double dest_cost = TraverseOrder_EntryCost(exps[0], true, gc,
+				bound_vars, filtered_entities, ft, qg);
+		transpose = dest_cost < src_cost;
+	} else {
+		transpose = _should_transpose_entry_point(qg, exps[0],
+				filtered_entities, bound_vars);
 	}
+	if(transpose) AlgebraicExpression_Transpose(exps);
 
 	if(filtered_entities) {
 		raxFree(filtered_entities);
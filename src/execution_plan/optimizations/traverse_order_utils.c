@@ -5,10 +5,16 @@
  */
 
 #include "RG.h"
+#include <math.h>
 #include "../../util/arr.h"
 #include "../../util/strcmp.h"
+#include "../ops/shared/cardinality_functions.h"
 #include "traverse_order_utils.h"
 
+// fraction of nodes assumed to pass a filter
+// for which no index statistics are available
+#define DEFAULT_FILTER_SELECTIVITY (1.0 / 3.0)
+
 //------------------------------------------------------------------------------
 // Scoring functions
 //------------------------------------------------------------------------------
@@ -207,6 +213,7 @@ void TraverseOrder_ScoreExpressions
 
 		score = TraverseOrder_LabelsScore(exp, qg);
 		scored_exp->exp = exp;
+		scored_exp->cost = 0;
 		scored_exp->score = score;
 
 		max = MAX(max, score);
@@ -254,3 +261,175 @@ void TraverseOrder_ScoreExpressions
 	}
 }
 
+//------------------------------------------------------------------------------
+// Cost functions
+//------------------------------------------------------------------------------
+
+// estimated number of nodes passing predicate 't' if it is an equality
+// on an indexed attribute of 'alias', e.g. 'n.v = 1'
+// estimation = indexed nodes / distinct indexed values
+// returns a negative value if the predicate can't be estimated
+static double _IndexedEqualityRows
+(
+	const GraphContext *gc,
+	const char *alias,
+	const char *label,
+	const FT_FilterNode *t
+) {
+	if(t->t != FT_N_PRED || t->pred.op != OP_EQUAL) return -1;
+
+	// locate the attribute side of the predicate
+	char *attr = NULL;
+	AR_ExpNode *attr_exp = NULL;
+	if(AR_EXP_IsAttribute(t->pred.lhs, &attr) &&
+	   AR_EXP_IsConstant(t->pred.rhs)) {
+		attr_exp = t->pred.lhs;
+	} else if(AR_EXP_IsAttribute(t->pred.rhs, &attr) &&
+			  AR_EXP_IsConstant(t->pred.lhs)) {
+		attr_exp = t->pred.rhs;
+	}
+	if(attr_exp == NULL) return -1;
+
+	// attribute must belong to 'alias'
+	AR_ExpNode *entity = attr_exp->op.children[0];
+	if(entity->type != AR_EXP_OPERAND ||
+	   entity->operand.type != AR_EXP_VARIADIC ||
+	   strcmp(entity->operand.variadic.entity_alias, alias) != 0) return -1;
+
+	Attribute_ID attr_id = GraphContext_GetAttributeID((GraphContext *)gc, attr);
+	if(attr_id == ATTRIBUTE_NOTFOUND) return -1;
+
+	Index *idx = GraphContext_GetIndex(gc, label, &attr_id, IDX_EXACT_MATCH,
+			SCHEMA_NODE);
+	if(idx == NULL) return -1;
+
+	uint64_t ndv = Index_DistinctValues(idx, attr_id);
+	if(ndv == 0) return -1;
+
+	return (double)Index_EntityCount(idx) / ndv;
+}
+
+// estimated number of nodes passing the most selective indexed equality
+// predicate applied to 'alias', negative if there's no such predicate
+static double _FilteredRows
+(
+	const GraphContext *gc,
+	const char *alias,
+	const char *label,
+	const FT_FilterNode *ft
+) {
+	double rows = -1;
+
+	// clone input filter-tree as breaking it down to sub-trees modifies it
+	FT_FilterNode  *tree           =  FilterTree_Clone(ft);
+	FT_FilterNode  **sub_trees     =  FilterTree_SubTrees(tree);
+	uint           sub_tree_count  =  array_len(sub_trees);
+
+	for(uint i = 0; i < sub_tree_count; i++) {
+		FT_FilterNode *t = sub_trees[i];
+		double estimate = _IndexedEqualityRows(gc, alias, label, t);
+		if(estimate >= 0) rows = (rows < 0) ? estimate : MIN(rows, estimate);
+		FilterTree_Free(t);
+	}
+
+	array_free(sub_trees);
+	return rows;
+}
+
+// estimated number of nodes 'alias' resolves to ahead of any traversal
+static double _NodeRows
+(
+	const GraphContext *gc,
+	const char *alias,
+	rax *bound_vars,
+	rax *filtered_entities,
+	const FT_FilterNode *ft,
+	const QueryGraph *qg
+) {
+	// bound node, resolved by a previous operation
+	if(bound_vars != NULL &&
+	   raxFind(bound_vars, (unsigned char *)alias, strlen(alias)) !=
+	   raxNotFound) {
+		return 1;
+	}
+
+	double rows;
+	QGNode *n = QueryGraph_GetNodeByAlias(qg, alias);
+	if(n->label == NULL) {
+		rows = Graph_NodeCount(gc->g);
+	} else {
+		Schema *s = GraphContext_GetSchema(gc, n->label, SCHEMA_NODE);
+		// label doesn't exist, no nodes carry it
+		if(s == NULL) return 0;
+		rows = Graph_LabeledNodeCount(gc->g, s->id);
+	}
+
+	if(filtered_entities == NULL) return rows;
+
+	// only independent filters narrow down the scan
+	// e.g. 'n.v = 1' but not 'n.v = m.v'
+	void *frequency = raxFind(filtered_entities, (unsigned char *)alias,
+			strlen(alias));
+	if(frequency == raxNotFound || frequency == NULL) return rows;
+
+	int64_t independent = (int64_t)frequency;
+	if(n->label != NULL) {
+		double eq_rows = _FilteredRows(gc, alias, n->label, ft);
+		if(eq_rows >= 0) {
+			rows = MIN(rows, eq_rows);
+			independent--;
+		}
+	}
+
+	return rows * pow(DEFAULT_FILTER_SELECTIVITY, independent);
+}
+
+double TraverseOrder_EntryCost
+(
+	AlgebraicExpression *exp,
+	bool transpose,
+	const GraphContext *gc,
+	rax *bound_vars,
+	rax *filtered_entities,
+	const FT_FilterNode *ft,
+	const QueryGraph *qg
+) {
+	ASSERT(gc  != NULL);
+	ASSERT(qg  != NULL);
+	ASSERT(exp != NULL);
+
+	const char *src = (transpose) ? AlgebraicExpression_Destination(exp) :
+		AlgebraicExpression_Source(exp);
+	double rows = _NodeRows(gc, src, bound_vars, filtered_entities, ft, qg);
+
+	// expression doesn't traverse an edge, e.g. a label filter
+	const char *edge = AlgebraicExpression_Edge(exp);
+	QGEdge *e = (edge) ? QueryGraph_GetEdgeByAlias(qg, edge) : NULL;
+	if(e == NULL) return rows;
+
+	bool outgoing = RG_STRCMP(src, e->src->alias) == 0;
+	return rows * (1 + EstimateFanOut(gc->g, e, outgoing));
+}
+
+void TraverseOrder_CostExpressions
+(
+	ScoredExp *scored_exps,
+	uint nexp,
+	const GraphContext *gc,
+	rax *bound_vars,
+	rax *filtered_entities,
+	const FT_FilterNode *ft,
+	const QueryGraph *qg
+) {
+	for(uint i = 0; i < nexp; i++) {
+		ScoredExp *scored_exp = scored_exps + i;
+		AlgebraicExpression *exp = scored_exp->exp;
+
+		double src_cost = TraverseOrder_EntryCost(exp, false, gc, bound_vars,
+				filtered_entities, ft, qg);
+		double dest_cost = TraverseOrder_EntryCost(exp, true, gc, bound_vars,
+				filtered_entities, ft, qg);
+
+		scored_exp->cost = MIN(src_cost, dest_cost);
+	}
+}
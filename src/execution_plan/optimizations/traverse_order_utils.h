@@ -7,12 +7,14 @@
 #pragma once
 
 #include "../../filter_tree/filter_tree.h"
+#include "../../graph/graphcontext.h"
 #include "../../arithmetic/algebraic_expression.h"
 #include "../../../deps/rax/rax.h"
 
 // algebraic expression associated with a score
 typedef struct {
 	int score;                 // score given to expression
+	double cost;               // estimated rows produced starting at expression
 	AlgebraicExpression *exp;  // algebraic expression
 } ScoredExp;
 
@@ -39,3 +41,30 @@ void TraverseOrder_ScoreExpressions
 	const QueryGraph *qg         // query graph
 );
 
+// estimated number of rows produced by evaluating 'exp' first
+// scanning its source, or its destination if 'transpose' is set
+// and expanding each scanned node by the traversal fan-out
+double TraverseOrder_EntryCost
+(
+	AlgebraicExpression *exp,    // expression to estimate
+	bool transpose,              // start at expression's destination
+	const GraphContext *gc,      // graph context
+	rax *bound_vars,             // map of bounded entities
+	rax *filtered_entities,      // map of filtered entities
+	const FT_FilterNode *ft,     // filters applied to the traversal
+	const QueryGraph *qg         // query graph
+);
+
+// associates each expression with the estimated number of rows
+// it produces when evaluated first, from its cheaper end
+void TraverseOrder_CostExpressions
+(
+	ScoredExp *scored_exps,      // scored expressions
+	uint nexp,                   // number of expressions
+	const GraphContext *gc,      // graph context
+	rax *bound_vars,             // map of bounded entities
+	rax *filtered_entities,      // map of filtered entities
+	const FT_FilterNode *ft,     // filters applied to the traversal
+	const QueryGraph *qg         // query graph
+);
+
@@ -10,6 +10,10 @@
 #include "../../query_ctx.h"
 #include "../ops/op_filter.h"
 #include "../ops/op_index_scan.h"
+#include "../ops/op_composite_index_scan.h"
+#include "../ops/op_edge_index_scan.h"
+#include "../ops/op_all_node_scan.h"
+#include "../ops/op_conditional_traverse.h"
 #include "../ops/op_node_by_label_scan.h"
 #include "../../ast/ast_shared.h"
 #include "../../datatypes/array.h"
@@ -267,17 +271,297 @@ static FT_FilterNode *_Concat_Filters(OpFilter **filter_ops) {
 	return root;
 }
 
+//------------------------------------------------------------------------------
+// Composite indices
+//------------------------------------------------------------------------------
+
+// a single predicate of the form: alias.attr OP exp
+typedef struct {
+	OpFilter *filter;     // filter operation holding predicate
+	Attribute_ID attr;    // filtered attribute
+	AST_Operator op;      // comparison operator
+	bool consumed;        // predicate is resolved by the index
+} CompositePredicate;
+
+// collects predicates directly above scan which compare a single attribute
+// of the scanned entity against a value
+static CompositePredicate *_compositePredicates(NodeByLabelScan *scan) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	const char *alias = scan->n.alias;
+	CompositePredicate *preds = array_new(CompositePredicate, 0);
+
+	OpBase *current = scan->op.parent;
+	while(current->type == OPType_FILTER) {
+		OpFilter *filter = (OpFilter *)current;
+		FT_FilterNode *tree = filter->filterTree;
+		current = current->parent;
+
+		if(tree->t != FT_N_PRED) continue;
+		if(!_applicable_predicate(alias, tree)) continue;
+
+		AST_Operator op = tree->pred.op;
+		if(op != OP_EQUAL && op != OP_LT && op != OP_LE && op != OP_GT &&
+		   op != OP_GE) continue;
+
+		_normalize_filter(alias, &filter->filterTree);
+		tree = filter->filterTree;
+
+		// left hand side must access an attribute of the scanned entity
+		char *attr;
+		AR_ExpNode *lhs = tree->pred.lhs;
+		if(!AR_EXP_IsAttribute(lhs, &attr)) continue;
+		AR_ExpNode *entity = lhs->op.children[0];
+		if(entity->type != AR_EXP_OPERAND ||
+		   entity->operand.type != AR_EXP_VARIADIC ||
+		   strcmp(entity->operand.variadic.entity_alias, alias) != 0) continue;
+
+		Attribute_ID attr_id = GraphContext_GetAttributeID(gc, attr);
+		if(attr_id == ATTRIBUTE_NOTFOUND) continue;
+
+		CompositePredicate pred = {filter, attr_id, tree->pred.op, false};
+		array_append(preds, pred);
+	}
+
+	return preds;
+}
+
+// finds an unconsumed predicate on attribute, matching one of two operators
+static int _findPredicate(CompositePredicate *preds, Attribute_ID attr,
+		AST_Operator a, AST_Operator b) {
+	uint count = array_len(preds);
+	for(uint i = 0; i < count; i++) {
+		CompositePredicate *pred = preds + i;
+		if(pred->consumed || pred->attr != attr) continue;
+		if(pred->op == a || pred->op == b) return i;
+	}
+	return -1;
+}
+
+// match predicates against index key fields
+// equalities on leading key fields, followed by a range on the next key field
+// sets 'eq_count', 'min' and 'max' and returns number of consumed predicates
+static uint _matchCompositeIndex(const CompositeIndex *idx,
+		CompositePredicate *preds, int *eq, uint *eq_count, int *min,
+		int *max) {
+	uint consumed = 0;
+	uint count = array_len(preds);
+	for(uint i = 0; i < count; i++) preds[i].consumed = false;
+
+	*eq_count = 0;
+	*min = -1;
+	*max = -1;
+
+	for(uint i = 0; i < idx->fields_count; i++) {
+		Attribute_ID attr = idx->fields_ids[i];
+		int pos = _findPredicate(preds, attr, OP_EQUAL, OP_EQUAL);
+		if(pos != -1) {
+			preds[pos].consumed = true;
+			eq[(*eq_count)++] = pos;
+			consumed++;
+			continue;
+		}
+
+		// no equality on key field, try a range and stop
+		*min = _findPredicate(preds, attr, OP_GT, OP_GE);
+		if(*min != -1) {
+			preds[*min].consumed = true;
+			consumed++;
+		}
+		*max = _findPredicate(preds, attr, OP_LT, OP_LE);
+		if(*max != -1) {
+			preds[*max].consumed = true;
+			consumed++;
+		}
+		break;
+	}
+
+	return consumed;
+}
+
+// checks if every access to 'alias' within the query reads
+// a property covered by the index
+static bool _aliasCovered(const GraphContext *gc, const AST *ast,
+		const cypher_astnode_t *node, const char *alias,
+		const CompositeIndex *idx, bool in_path) {
+	cypher_astnode_type_t type = cypher_astnode_type(node);
+
+	if(type == CYPHER_AST_PROPERTY_OPERATOR) {
+		const cypher_astnode_t *exp =
+			cypher_ast_property_operator_get_expression(node);
+		if(cypher_astnode_type(exp) == CYPHER_AST_IDENTIFIER &&
+		   strcmp(cypher_ast_identifier_get_name(exp), alias) == 0) {
+			const char *prop = cypher_ast_prop_name_get_value(
+					cypher_ast_property_operator_get_prop_name(node));
+			Attribute_ID attr_id = GraphContext_GetAttributeID(
+					(GraphContext *)gc, prop);
+			return CompositeIndex_Covers(idx, attr_id);
+		}
+	} else if(type == CYPHER_AST_IDENTIFIER) {
+		// entity is accessed as a whole
+		return strcmp(cypher_ast_identifier_get_name(node), alias) != 0;
+	} else if(type == CYPHER_AST_NODE_PATTERN) {
+		if(strcmp(AST_GetEntityName(ast, node), alias) == 0) {
+			// paths hold entire nodes
+			if(in_path) return false;
+
+			// inline filters must refer to covered properties
+			const cypher_astnode_t *props =
+				cypher_ast_node_pattern_get_properties(node);
+			if(props != NULL) {
+				if(cypher_astnode_type(props) != CYPHER_AST_MAP) return false;
+				uint nelems = cypher_ast_map_nentries(props);
+				for(uint i = 0; i < nelems; i++) {
+					const char *prop = cypher_ast_prop_name_get_value(
+							cypher_ast_map_get_key(props, i));
+					Attribute_ID attr_id = GraphContext_GetAttributeID(
+							(GraphContext *)gc, prop);
+					if(!CompositeIndex_Covers(idx, attr_id)) return false;
+					if(!_aliasCovered(gc, ast, cypher_ast_map_get_value(props, i),
+								alias, idx, in_path)) return false;
+				}
+			}
+			return true;
+		}
+	} else if(type == CYPHER_AST_NAMED_PATH || type == CYPHER_AST_SHORTEST_PATH) {
+		in_path = true;
+	} else if(type == CYPHER_AST_WITH) {
+		if(cypher_ast_with_has_include_existing(node)) return false;
+	} else if(type == CYPHER_AST_RETURN) {
+		if(cypher_ast_return_has_include_existing(node)) return false;
+	}
+
+	uint child_count = cypher_astnode_nchildren(node);
+	for(uint i = 0; i < child_count; i++) {
+		const cypher_astnode_t *child = cypher_astnode_get_child(node, i);
+		if(!_aliasCovered(gc, ast, child, alias, idx, in_path)) return false;
+	}
+
+	return true;
+}
+
+// checks if query can be answered from the index without accessing nodes
+static bool _coveringScan(const CompositeIndex *idx, const char *alias) {
+	const AST *ast = QueryCtx_GetAST();
+	// covered properties are read-only copies
+	if(ast == NULL || !AST_ReadOnly(ast->root)) return false;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	return _aliasCovered(gc, ast, ast->root, alias, idx, false);
+}
+
+// try to replace given Label Scan operation and a set of Filter operations with
+// a single Composite Index Scan operation, returns true on success
+static bool _reduceCompositeScan(ExecutionPlan *plan, NodeByLabelScan *scan,
+		bool exact_match) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchema(gc, scan->n.label, SCHEMA_NODE);
+	if(s == NULL) return false;
+
+	uint idx_count = array_len(s->composite_indices);
+	if(idx_count == 0) return false;
+
+	CompositePredicate *preds = _compositePredicates(scan);
+	uint preds_count = array_len(preds);
+	if(preds_count == 0) {
+		array_free(preds);
+		return false;
+	}
+
+	// pick the index resolving the largest number of predicates
+	CompositeIndex *best = NULL;
+	uint best_consumed = 0;
+	for(uint i = 0; i < idx_count; i++) {
+		int eq[preds_count];
+		uint eq_count;
+		int min;
+		int max;
+		uint consumed = _matchCompositeIndex(s->composite_indices[i], preds, eq,
+				&eq_count, &min, &max);
+		if(consumed > best_consumed) {
+			best = s->composite_indices[i];
+			best_consumed = consumed;
+		}
+	}
+
+	bool covering = (best != NULL && _coveringScan(best, scan->n.alias));
+
+	// a single predicate is better served by an exact-match index
+	if(best == NULL || (best_consumed == 1 && exact_match && !covering)) {
+		array_free(preds);
+		return false;
+	}
+
+	int eq_pos[preds_count];
+	uint eq_count;
+	int min;
+	int max;
+	_matchCompositeIndex(best, preds, eq_pos, &eq_count, &min, &max);
+
+	AR_ExpNode **eq = array_new(AR_ExpNode *, eq_count);
+	for(uint i = 0; i < eq_count; i++) {
+		OpFilter *filter = preds[eq_pos[i]].filter;
+		array_append(eq, AR_EXP_Clone(filter->filterTree->pred.rhs));
+	}
+
+	AR_ExpNode *min_exp = NULL;
+	AR_ExpNode *max_exp = NULL;
+	bool include_min = false;
+	bool include_max = false;
+	if(min != -1) {
+		min_exp = AR_EXP_Clone(preds[min].filter->filterTree->pred.rhs);
+		include_min = preds[min].op == OP_GE;
+	}
+	if(max != -1) {
+		max_exp = AR_EXP_Clone(preds[max].filter->filterTree->pred.rhs);
+		include_max = preds[max].op == OP_LE;
+	}
+
+	// consumed filters are kept to verify matches of widened scans
+	OpFilter **filters = array_new(OpFilter *, best_consumed);
+	for(uint i = 0; i < preds_count; i++) {
+		if(preds[i].consumed) array_append(filters, preds[i].filter);
+	}
+
+	FT_FilterNode *root = _Concat_Filters(filters);
+	OpBase *indexOp = NewCompositeIndexScanOp(scan->op.plan, scan->g, scan->n,
+			best, eq, min_exp, include_min, max_exp, include_max, root,
+			covering);
+
+	// replace the redundant scan op with the newly-constructed index scan
+	ExecutionPlan_ReplaceOp(plan, (OpBase *)scan, indexOp);
+	OpBase_Free((OpBase *)scan);
+
+	// remove and free all consumed filter ops
+	for(uint i = 0; i < best_consumed; i++) {
+		OpFilter *filter = filters[i];
+		ExecutionPlan_RemoveOp(plan, (OpBase *)filter);
+		OpBase_Free((OpBase *)filter);
+	}
+
+	array_free(filters);
+	array_free(preds);
+	return true;
+}
+
 // try to replace given Label Scan operation and a set of Filter operations with
 // a single Index Scan operation
 void reduce_scan_op(ExecutionPlan *plan, NodeByLabelScan *scan) {
 	// make sure there's an index for scanned label
 	const char *label = scan->n.label;
 	GraphContext *gc = QueryCtx_GetGraphCtx();
-	Index *idx = GraphContext_GetIndex(gc, label, NULL, IDX_EXACT_MATCH);
+	Index *idx = GraphContext_GetIndex(gc, label, NULL, IDX_EXACT_MATCH, SCHEMA_NODE);
+
+	// prefer a composite index when it resolves multiple predicates
+	// or is able to answer the query on its own
+	bool exact_match = (idx != NULL && Index_Operational(idx));
+	if(_reduceCompositeScan(plan, scan, exact_match)) return;
+
 	if(idx == NULL) return;
 
+	// index is still being populated
+	if(!Index_Operational(idx)) return;
+
 	// get all applicable filter for index
-	RSIndex *rs_idx = idx->idx;
 	OpFilter **filters = _applicableFilters(scan, idx);
 
 	// no filters, return
@@ -285,7 +569,7 @@ void reduce_scan_op(ExecutionPlan *plan, NodeByLabelScan *scan) {
 	if(filters_count == 0) goto cleanup;
 
 	FT_FilterNode *root = _Concat_Filters(filters);
-	OpBase *indexOp = NewIndexScanOp(scan->op.plan, scan->g, scan->n, rs_idx,
+	OpBase *indexOp = NewIndexScanOp(scan->op.plan, scan->g, scan->n, idx,
 			root);
 
 	// replace the redundant scan op with the newly-constructed Index Scan
@@ -306,6 +590,143 @@ cleanup:
 	array_free(filters);
 }
 
+//------------------------------------------------------------------------------
+// Relationship-type indices
+//------------------------------------------------------------------------------
+
+// returns the node scan tap feeding 'traverse' through a chain of filters
+// NULL if there's no such scan
+static OpBase *_traverseSourceScan(OpCondTraverse *traverse) {
+	OpBase *child = traverse->op.children[0];
+	while(child->type == OPType_FILTER) child = child->children[0];
+
+	// scan must be a tap, introducing the traversal's source node
+	if(child->childCount != 0) return NULL;
+
+	const char *alias = NULL;
+	if(child->type == OPType_ALL_NODE_SCAN) {
+		alias = ((AllNodeScan *)child)->alias;
+	} else if(child->type == OPType_NODE_BY_LABEL_SCAN) {
+		alias = ((NodeByLabelScan *)child)->n.alias;
+	} else {
+		return NULL;
+	}
+
+	if(strcmp(alias, AlgebraicExpression_Source(traverse->ae)) != 0) return NULL;
+	return child;
+}
+
+// returns the relationship-type index applicable to traversal
+// NULL if traversal can't be seeded from an edge index
+static Index *_traverseEdgeIndex(OpCondTraverse *traverse, QGEdge **edge) {
+	AlgebraicExpression *ae = traverse->ae;
+	if(traverse->edge_ctx == NULL) return NULL;
+	if(traverse->edge_ctx->direction == GRAPH_EDGE_DIR_BOTH) return NULL;
+
+	// traversal should be a single hop over a single relationship type
+	// optionally filtered by the labels of its endpoints
+	uint operand_count = AlgebraicExpression_OperandCount(ae);
+	uint relation_operands = 0;
+	for(uint i = 0; i < operand_count; i++) {
+		if(!AlgebraicExpression_DiagonalOperand(ae, i)) relation_operands++;
+	}
+	if(relation_operands != 1) return NULL;
+
+	const char *src = AlgebraicExpression_Source(ae);
+	const char *dest = AlgebraicExpression_Destination(ae);
+	if(strcmp(src, dest) == 0) return NULL;
+
+	QueryGraph *qg = traverse->op.plan->query_graph;
+	QGEdge *e = QueryGraph_GetEdgeByAlias(qg, AlgebraicExpression_Edge(ae));
+	if(QGEdge_VariableLength(e) || QGEdge_RelationCount(e) != 1) return NULL;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Index *idx = GraphContext_GetIndex(gc, e->reltypes[0], NULL,
+			IDX_EXACT_MATCH, SCHEMA_EDGE);
+	if(idx == NULL || !Index_Operational(idx)) return NULL;
+
+	*edge = e;
+	return idx;
+}
+
+// returns an array of filter operations placed right above 'traverse'
+// which can be reduced into a single edge index scan
+static OpFilter **_applicableEdgeFilters(OpCondTraverse *traverse,
+		const char *edge, Index *idx) {
+	OpFilter **filters = array_new(OpFilter *, 0);
+
+	OpBase *current = traverse->op.parent;
+	while(current != NULL && current->type == OPType_FILTER) {
+		OpFilter *filter = (OpFilter *)current;
+
+		// filter should refer to the traversed edge only
+		rax *entities = FilterTree_CollectModified(filter->filterTree);
+		bool edge_only = (raxSize(entities) == 1 &&
+			raxFind(entities, (unsigned char *)edge, strlen(edge)) != raxNotFound);
+		raxFree(entities);
+
+		if(edge_only && _applicableFilter(edge, idx, &filter->filterTree)) {
+			array_append(filters, filter);
+		}
+
+		// advance to the next operation
+		current = current->parent;
+	}
+
+	return filters;
+}
+
+// try to replace a node scan, the traversal it feeds and a set of filters
+// on the traversed edge with a single Edge Index Scan operation
+static void _reduceTraversal(ExecutionPlan *plan, OpCondTraverse *traverse) {
+	OpBase *scan = _traverseSourceScan(traverse);
+	if(scan == NULL) return;
+
+	QGEdge *e = NULL;
+	Index *idx = _traverseEdgeIndex(traverse, &e);
+	if(idx == NULL) return;
+
+	const char *edge = AlgebraicExpression_Edge(traverse->ae);
+	OpFilter **filters = _applicableEdgeFilters(traverse, edge, idx);
+
+	// no filters, return
+	uint filters_count = array_len(filters);
+	if(filters_count == 0) goto cleanup;
+
+	QueryGraph *qg = traverse->op.plan->query_graph;
+	QGNode *src = QueryGraph_GetNodeByAlias(qg,
+			AlgebraicExpression_Source(traverse->ae));
+	QGNode *dest = QueryGraph_GetNodeByAlias(qg,
+			AlgebraicExpression_Destination(traverse->ae));
+
+	// edge index scan takes over the traversal's algebraic expression
+	AlgebraicExpression *ae = traverse->ae;
+	traverse->ae = NULL;
+
+	FT_FilterNode *root = _Concat_Filters(filters);
+	OpBase *edgeIndexOp = NewEdgeIndexScanOp(traverse->op.plan, traverse->graph,
+			idx, ae, edge, e->reltypes[0], QGEdge_RelationID(e, 0),
+			traverse->edge_ctx->direction,
+			NODE_CTX_NEW(src->alias, src->label, src->labelID),
+			NODE_CTX_NEW(dest->alias, dest->label, dest->labelID), root);
+
+	// seed the traversal from the index, traversal itself is redundant
+	ExecutionPlan_ReplaceOp(plan, scan, edgeIndexOp);
+	OpBase_Free(scan);
+	ExecutionPlan_RemoveOp(plan, (OpBase *)traverse);
+	OpBase_Free((OpBase *)traverse);
+
+	// remove and free all redundant filter ops
+	for(uint i = 0; i < filters_count; i++) {
+		OpFilter *filter = filters[i];
+		ExecutionPlan_RemoveOp(plan, (OpBase *)filter);
+		OpBase_Free((OpBase *)filter);
+	}
+
+cleanup:
+	array_free(filters);
+}
+
 void utilizeIndices(ExecutionPlan *plan) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	// return immediately if the graph has no indices
@@ -324,4 +745,15 @@ void utilizeIndices(ExecutionPlan *plan) {
 
 	// cleanup
 	array_free(scanOps);
+
+	// seed traversals from relationship-type indices
+	OpBase **traverseOps = ExecutionPlan_CollectOps(plan->root,
+			OPType_CONDITIONAL_TRAVERSE);
+
+	int traverseOpCount = array_len(traverseOps);
+	for(int i = 0; i < traverseOpCount; i++) {
+		_reduceTraversal(plan, (OpCondTraverse *)traverseOps[i]);
+	}
+
+	array_free(traverseOps);
 }
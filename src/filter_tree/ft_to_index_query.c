@@ -4,12 +4,14 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
-#include "ft_to_rsq.h"
+#include "ft_to_index_query.h"
 #include "RG.h"
+#include "../query_ctx.h"
 #include "../util/arr.h"
 #include "filter_tree_utils.h"
 #include "../datatypes/point.h"
 #include "../datatypes/array.h"
+#include "../graph/graphcontext.h"
 #include "../util/range/string_range.h"
 #include "../util/range/numeric_range.h"
 
@@ -18,63 +20,60 @@
 //------------------------------------------------------------------------------
 
 // returns true if 'tree' been converted into an index query, false otherwise
-static bool _FilterTreeToQueryNode
+static bool _FilterTreeToIndexQuery
 (
-	RSQNode**root,       // array of query nodes to populate
-	FT_FilterNode *tree, // filter to convert into an index query
-	RSIndex *idx         // queried index
+	IndexQuery **root,   // [output] index query
+	FT_FilterNode *tree  // filter to convert into an index query
 );
 
 //------------------------------------------------------------------------------
-// To RediSearch query node
+// To index query
 //------------------------------------------------------------------------------
 
-// create a RediSearch query node out of a numeric range object
-static RSQNode *_NumericRangeToQueryNode
+// resolve queried attribute name to its ID
+static inline Attribute_ID _AttributeID
+(
+	const char *field  // queried field
+) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	return GraphContext_GetAttributeID(gc, field);
+}
+
+// create an index query out of a numeric range object
+static IndexQuery *_NumericRangeToIndexQuery
 (
-	RSIndex *idx,              // queried index
 	const char *field,         // queried field
 	const NumericRange *range  // range to query
 ) {
-	double max = (range->max == INFINITY) ? RSRANGE_INF : range->max;
-	double min = (range->min == -INFINITY) ? RSRANGE_NEG_INF : range->min;
-	return RediSearch_CreateNumericNode(idx, field, max, min, range->include_max, range->include_min);
+	return IndexQuery_NewNumericRange(_AttributeID(field), range->min,
+			range->include_min, range->max, range->include_max);
 }
 
-// create a RediSearch query node out of a string range object
-static RSQNode *_StringRangeToQueryNode
+// create an index query out of a boolean range object
+// booleans are indexed apart from numbers, false as 0 and true as 1
+static IndexQuery *_BooleanRangeToIndexQuery
+(
+	const char *field,         // queried field
+	const NumericRange *range  // range to query
+) {
+	return IndexQuery_NewBooleanRange(_AttributeID(field), range->min,
+			range->include_min, range->max, range->include_max);
+}
+
+// create an index query out of a string range object
+static IndexQuery *_StringRangeToIndexQuery
 (
-	RSIndex *idx,             // queried index
 	const char *field,        // queried field
 	const StringRange *range  // range to query
 ) {
-	RSQNode *root = RediSearch_CreateTagNode(idx, field);
-	RSQNode *child = NULL;
-	const char *max = range->max;
-	const char *min = range->min;
-
-	if(max != NULL && min != NULL && strcmp(max, min) == 0) {
-		// exact match
-		child = RediSearch_CreateTokenNode(idx, field, max);
-	} else {
-		// range search
-		max = (max == NULL) ? RSLECRANGE_INF     : max;
-		min = (min == NULL) ? RSLEXRANGE_NEG_INF : min;
-
-		child = RediSearch_CreateLexRangeNode(idx, field, min, max,
-				range->include_min, range->include_max);
-	}
-
-	RediSearch_QueryNodeAddChild(root, child);
-
-	return root;
+	return IndexQuery_NewStringRange(_AttributeID(field), range->min,
+			range->include_min, range->max, range->include_max);
 }
 
-// creates a RediSearch distance query from given filter
-static RSQNode *_FilterTreeToDistanceQueryNode
+// creates an index distance query from given filter
+static IndexQuery *_FilterTreeToDistanceIndexQuery
 (
-	FT_FilterNode *filter,  // filter to convert
-	RSIndex *idx            // queried index
+	FT_FilterNode *filter  // filter to convert
 ) {
 	char     *field  =  NULL;         // field being filtered
 	SIValue  origin  =  SI_NullVal(); // center of circle
@@ -82,22 +81,22 @@ static RSQNode *_FilterTreeToDistanceQueryNode
 
 	extractOriginAndRadius(filter, &origin, &radius, &field);
 
-	return RediSearch_CreateGeoNode(idx, field, Point_lat(origin),
-									Point_lon(origin), SI_GET_NUMERIC(radius), RS_GEO_DISTANCE_M);
+	// distance(point, origin) <= radius
+	bool include_radius = (filter->pred.op == OP_LE);
+	return IndexQuery_NewDistance(_AttributeID(field), origin,
+			SI_GET_NUMERIC(radius), include_radius);
 }
 
-// creates a RediSearch query node out of given IN filter
-static RSQNode *_FilterTreeToInQueryNode
+// creates an index query out of given IN filter
+static IndexQuery *_FilterTreeToInIndexQuery
 (
-	FT_FilterNode *filter,  // filter to convert
-	RSIndex *idx            // queried index
+	FT_FilterNode *filter  // filter to convert
 ) {
-	ASSERT(idx    != NULL);
 	ASSERT(filter != NULL);
 	ASSERT(isInFilter(filter));
 
 	// n.v IN [1,2,3]
-	// a single union node should hold a number of token/numeric nodes
+	// a single union node should hold a number of exact match queries
 	// one for each element in the array.
 
 	// extract both field name and list from expression
@@ -112,34 +111,35 @@ static RSQNode *_FilterTreeToInQueryNode
 
 	if(list_len == 0) {
 		// Special case: "WHERE a.v in []"
-		return RediSearch_CreateEmptyNode(idx);
+		return IndexQuery_NewEmpty();
 	}
 
-	RSQNode *node = NULL;
-	RSQNode *parent = NULL;
-	RSQNode *U = RediSearch_CreateUnionNode(idx);
+	IndexQuery    *node  =  NULL;
+	IndexQuery    *U     =  IndexQuery_NewUnion();
+	Attribute_ID  attr   =  _AttributeID(field);
 
 	for(uint i = 0; i < list_len; i ++) {
 		double d;
 		SIValue v = SIArray_Get(list, i);
 		switch(SI_TYPE(v)) {
 		case T_STRING:
-			parent = RediSearch_CreateTagNode(idx, field);
-			node = RediSearch_CreateTokenNode(idx, field, v.stringval);
-			RediSearch_QueryNodeAddChild(parent, node);
-			node = parent;
+			node = IndexQuery_NewStringRange(attr, v.stringval, true,
+					v.stringval, true);
 			break;
 		case T_DOUBLE:
 		case T_INT64:
+			d = SI_GET_NUMERIC(v);
+			node = IndexQuery_NewNumericRange(attr, d, true, d, true);
+			break;
 		case T_BOOL:
 			d = SI_GET_NUMERIC(v);
-			node = RediSearch_CreateNumericNode(idx, field, d, d, true, true);
+			node = IndexQuery_NewBooleanRange(attr, d, true, d, true);
 			break;
 		default:
 			ASSERT(false && "unexpected conditional operation");
 			break;
 		}
-		RediSearch_QueryNodeAddChild(U, node);
+		IndexQuery_AddChild(U, node);
 	}
 
 	return U;
@@ -171,14 +171,16 @@ static bool _predicateTreeToRange
 	// make sure constant is an indexable type
 	if(!(t & SI_INDEXABLE)) return false;
 
+	// booleans are queried on their own, see _FilterTreePredicateToIndexQuery
+	if(t == T_BOOL) return false;
+
 	int           op        =  tree->pred.op;
 	StringRange   *sr       =  NULL;
 	NumericRange  *nr       =  NULL;
 	uint          prop_len  =  strlen(prop);
 
 	// get or create range object for alias.prop
-	// constant is either numeric or boolean
-	if(t & SI_NUMERIC || t == T_BOOL) {
+	if(t & SI_NUMERIC) {
 		nr = raxFind(numeric_ranges, (unsigned char *)prop, prop_len);
 		// create if doesn't exists
 		if(nr == raxNotFound) {
@@ -200,12 +202,11 @@ static bool _predicateTreeToRange
 	return true;
 }
 
-// connect all RediSearch query nodes
-static RSQNode *_concat_query_nodes
+// connect all index queries
+static IndexQuery *_concat_index_queries
 (
-	RSIndex *idx,     // queried index
-	RSQNode **nodes,  // query nodes to concat
-	uint count        // number of nodes
+	IndexQuery **nodes,  // queries to concat
+	uint count           // number of queries
 ) {
 	// no nodes, can not utilize the index
 	if(count == 0) return NULL;
@@ -214,34 +215,31 @@ static RSQNode *_concat_query_nodes
 	if(count == 1) return nodes[0];
 
 	// multiple filters, combine using AND
-	RSQNode *root = RediSearch_CreateIntersectNode(idx, false);
+	IndexQuery *root = IndexQuery_NewIntersection();
 	for(uint i = 0; i < count; i++) {
-		RSQNode *qnode = nodes[i];
-		RediSearch_QueryNodeAddChild(root, qnode);
+		IndexQuery_AddChild(root, nodes[i]);
 	}
 
 	return root;
 }
 
 // compose index query from ranges
-static RSQNode *_ranges_to_query_nodes
+static IndexQuery *_ranges_to_index_queries
 (
-	RSIndex *idx,        // index to query
 	rax *string_ranges,  // string ranges
 	rax *numeric_ranges  // numerical ranges
 ) {
 	ASSERT(string_ranges  != NULL);
 	ASSERT(numeric_ranges != NULL);
 
-	// build RediSearch query tree
-	// convert each range object to RediSearch query node
+	// convert each range object to an index query
 	raxIterator it;
 	bool valid = true;  // false if there's a range conflict
 
 	//--------------------------------------------------------------------------
 	// validate ranges
 	//--------------------------------------------------------------------------
-	
+
 	// validate string ranges
 	raxStart(&it, string_ranges);
 	raxSeek(&it, "^", NULL, 0);
@@ -249,7 +247,7 @@ static RSQNode *_ranges_to_query_nodes
 	while(raxNext(&it)) {
 		/* make sure each property is bound to either numeric or string type
 		 * but not to both, e.g. a.v = 1 AND a.v = 'a'
-		 * in which case use an empty RSQueryNode. */
+		 * in which case use an empty index query. */
 		char *field = (char *)it.key;
 		if(raxFind(numeric_ranges, (unsigned char *)field, (int)it.key_len) != raxNotFound) {
 			valid = false;
@@ -263,8 +261,8 @@ static RSQNode *_ranges_to_query_nodes
 		}
 	}
 	raxStop(&it);
-	
-	if(valid == false) return RediSearch_CreateEmptyNode(idx);
+
+	if(valid == false) return IndexQuery_NewEmpty();
 
 	// validate numeric ranges
 	raxStart(&it, numeric_ranges);
@@ -279,7 +277,7 @@ static RSQNode *_ranges_to_query_nodes
 	}
 	raxStop(&it);
 
-	if(valid == false) return RediSearch_CreateEmptyNode(idx);
+	if(valid == false) return IndexQuery_NewEmpty();
 
 	//--------------------------------------------------------------------------
 	// construct index range queries
@@ -289,8 +287,9 @@ static RSQNode *_ranges_to_query_nodes
 	uint i = 0;
 	char query_field_name[1024];
 	uint range_count = raxSize(numeric_ranges) + raxSize(string_ranges);
-	RSQNode *rsqnodes[range_count];
+	IndexQuery *queries[range_count];
 
+	raxStart(&it, numeric_ranges);
 	raxSeek(&it, "^", NULL, 0);
 	while(raxNext(&it)) {
 		char *field = (char *)it.key;
@@ -298,8 +297,7 @@ static RSQNode *_ranges_to_query_nodes
 		NumericRange *nr = (NumericRange *) it.data;
 
 		snprintf(query_field_name, 1024, "%.*s", (int)it.key_len, field);
-		RSQNode *rsqn = _NumericRangeToQueryNode(idx, query_field_name, nr);
-		rsqnodes[i++] = rsqn;
+		queries[i++] = _NumericRangeToIndexQuery(query_field_name, nr);
 	}
 	raxStop(&it);
 
@@ -311,13 +309,11 @@ static RSQNode *_ranges_to_query_nodes
 		StringRange *sr = (StringRange *) it.data;
 
 		snprintf(query_field_name, 1024, "%.*s", (int)it.key_len, field);
-		RSQNode *rsqn = _StringRangeToQueryNode(idx, query_field_name, sr);
-		rsqnodes[i++] = rsqn;
+		queries[i++] = _StringRangeToIndexQuery(query_field_name, sr);
 	}
 	raxStop(&it);
 
-	RSQNode *root = _concat_query_nodes(idx, rsqnodes, range_count);
-	return root;
+	return _concat_index_queries(queries, range_count);
 }
 
 // reduce filters into ranges
@@ -347,17 +343,14 @@ static void _compose_ranges
 	}
 }
 
-// tries to convert filter tree to a RediSearch query
+// tries to convert filter tree to an index query
 // return true if tree was converted, false otherwise
 // a conversion might fail if tree contains a none indexable type e.g. array
-static bool _FilterTreeConditionToQueryNode
+static bool _FilterTreeConditionToIndexQuery
 (
-	RSQNode **root,      // [output] query node
-	FT_FilterNode *tree, // filter to convert
-	RSIndex *idx         // queried index
+	IndexQuery **root,   // [output] index query
+	FT_FilterNode *tree  // filter to convert
 ) {
-
-	ASSERT(idx != NULL);
 	ASSERT(root != NULL);
 	ASSERT(tree != NULL);
 	ASSERT(tree->t == FT_N_COND);
@@ -368,39 +361,36 @@ static bool _FilterTreeConditionToQueryNode
 	AST_Operator op = tree->cond.op;
 	ASSERT(op == OP_OR || op == OP_AND);
 
-	RSQNode  *node   =  NULL;
-	RSQNode  *left   =  NULL;
-	RSQNode  *right  =  NULL;
+	IndexQuery  *node   =  NULL;
+	IndexQuery  *left   =  NULL;
+	IndexQuery  *right  =  NULL;
 
 	// create root node
-	if(op == OP_OR) node = RediSearch_CreateUnionNode(idx);
-	else node = RediSearch_CreateIntersectNode(idx, false);
+	if(op == OP_OR) node = IndexQuery_NewUnion();
+	else node = IndexQuery_NewIntersection();
 
 	//--------------------------------------------------------------------------
 	// convert left and right hand sides
 	//--------------------------------------------------------------------------
 
 	// process left branch
-	bool res = _FilterTreeToQueryNode(&left, tree->cond.left, idx);
+	bool res = _FilterTreeToIndexQuery(&left, tree->cond.left);
 	// process right branch
-	res &= _FilterTreeToQueryNode(&right, tree->cond.right, idx);
+	res &= _FilterTreeToIndexQuery(&right, tree->cond.right);
 
-	RediSearch_QueryNodeAddChild(node, left);
-	RediSearch_QueryNodeAddChild(node, right);
+	IndexQuery_AddChild(node, left);
+	IndexQuery_AddChild(node, right);
 
 	*root = node;
 	return res;
 }
 
 // returns true if predicate filter been converted to an index query
-static bool _FilterTreePredicateToQueryNode
+static bool _FilterTreePredicateToIndexQuery
 (
-	RSQNode **root,      // [output] query node
-	FT_FilterNode *tree, // filter to convert
-	RSIndex *idx         // queried index
+	IndexQuery **root,   // [output] index query
+	FT_FilterNode *tree  // filter to convert
 ) {
-
-	ASSERT(idx  != NULL);
 	ASSERT(root != NULL);
 	ASSERT(tree != NULL);
 	ASSERT(tree->t == FT_N_PRED);
@@ -409,23 +399,20 @@ static bool _FilterTreePredicateToQueryNode
 	*root = NULL;
 
 	// expecting left hand side to be an attribute access
-	RSQNode  *node      =  NULL;
-	char     *field     =  NULL;
-	bool     attribute  =  AR_EXP_IsAttribute(tree->pred.lhs,  &field);
+	IndexQuery  *node      =  NULL;
+	char        *field     =  NULL;
+	bool        attribute  =  AR_EXP_IsAttribute(tree->pred.lhs,  &field);
 	ASSERT(attribute == true);
 
+	Attribute_ID attr = _AttributeID(field);
+
 	// validate const type
 	ASSERT(AR_EXP_IsConstant(tree->pred.rhs));
 	SIValue v = tree->pred.rhs->operand.constant;
 	SIType t = SI_TYPE(v);
 	if(!(t & SI_INDEXABLE)) {
-		// none indexable type, consult with the none indexed field
-		node = RediSearch_CreateTagNode(idx, INDEX_FIELD_NONE_INDEXED);
-		RSQNode *child = RediSearch_CreateTokenNode(idx,
-				INDEX_FIELD_NONE_INDEXED, field);
-
-		RediSearch_QueryNodeAddChild(node, child);
-		*root = node;
+		// none indexable type, consult with the none indexed entities
+		*root = IndexQuery_NewNoneIndexed(attr);
 		return false;
 	}
 
@@ -438,51 +425,24 @@ static bool _FilterTreePredicateToQueryNode
 		   op == OP_EQUAL);
 
 	if(t == T_STRING) {
-		switch(tree->pred.op) {
-			case OP_LT:    // <
-				node = RediSearch_CreateLexRangeNode(idx, field, RSLEXRANGE_NEG_INF, v.stringval, 0, 0);
-				break;
-			case OP_LE:    // <=
-				node = RediSearch_CreateLexRangeNode(idx, field, RSLEXRANGE_NEG_INF, v.stringval, 0, 1);
-				break;
-			case OP_GT:    // >
-				node = RediSearch_CreateLexRangeNode(idx, field, v.stringval, RSLECRANGE_INF, 0, 0);
-				break;
-			case OP_GE:    // >=
-				node = RediSearch_CreateLexRangeNode(idx, field, v.stringval, RSLECRANGE_INF, 1, 0);
-				break;
-			case OP_EQUAL:  // ==
-				node = RediSearch_CreateTokenNode(idx, field, v.stringval);
-				break;
-			default:
-				ASSERT(false && "unexpected operation");
-		}
-
-		RSQNode *parent = RediSearch_CreateTagNode(idx, field);
-		RediSearch_QueryNodeAddChild(parent, node);
-		node = parent;
+		StringRange *sr = StringRange_New();
+		StringRange_TightenRange(sr, op, v.stringval);
+		if(StringRange_IsValid(sr)) node = _StringRangeToIndexQuery(field, sr);
+		else node = IndexQuery_NewEmpty();
+		StringRange_Free(sr);
+	} else if(t == T_BOOL) {
+		NumericRange *nr = NumericRange_New();
+		NumericRange_TightenRange(nr, op, SI_GET_NUMERIC(v));
+		if(NumericRange_IsValid(nr)) node = _BooleanRangeToIndexQuery(field, nr);
+		else node = IndexQuery_NewEmpty();
+		NumericRange_Free(nr);
 	} else {
-		ASSERT(t & SI_NUMERIC || t == T_BOOL);
-		double d = SI_GET_NUMERIC(v);
-		switch(tree->pred.op) {
-			case OP_LT:    // <
-				node = RediSearch_CreateNumericNode(idx, field, d, RSRANGE_NEG_INF, false, false);
-				break;
-			case OP_LE:    // <=
-				node = RediSearch_CreateNumericNode(idx, field, d, RSRANGE_NEG_INF, true, false);
-				break;
-			case OP_GT:    // >
-				node = RediSearch_CreateNumericNode(idx, field, RSRANGE_INF, d, false, false);
-				break;
-			case OP_GE:    // >=
-				node = RediSearch_CreateNumericNode(idx, field, RSRANGE_INF, d, false, true);
-				break;
-			case OP_EQUAL:  // ==
-				node = RediSearch_CreateNumericNode(idx, field, d, d, true, true);
-				break;
-			default:
-				ASSERT(false && "unexpected operation");
-		}
+		ASSERT(t & SI_NUMERIC);
+		NumericRange *nr = NumericRange_New();
+		NumericRange_TightenRange(nr, op, SI_GET_NUMERIC(v));
+		if(NumericRange_IsValid(nr)) node = _NumericRangeToIndexQuery(field, nr);
+		else node = IndexQuery_NewEmpty();
+		NumericRange_Free(nr);
 	}
 
 	*root = node;
@@ -490,13 +450,11 @@ static bool _FilterTreePredicateToQueryNode
 }
 
 // returns true if 'tree' been converted into an index query, false otherwise
-static bool _FilterTreeToQueryNode
+static bool _FilterTreeToIndexQuery
 (
-	RSQNode **root,      // [output] query node
-	FT_FilterNode *tree, // filter to convert into an index query
-	RSIndex *idx         // queried index
+	IndexQuery **root,   // [output] index query
+	FT_FilterNode *tree  // filter to convert into an index query
 ) {
-	ASSERT(idx  != NULL);
 	ASSERT(root != NULL);
 	ASSERT(tree != NULL);
 
@@ -504,42 +462,40 @@ static bool _FilterTreeToQueryNode
 	*root = NULL;
 
 	if(isInFilter(tree)) {
-		*root = _FilterTreeToInQueryNode(tree, idx);
+		*root = _FilterTreeToInIndexQuery(tree);
 		return true;
 	}
 
 	if(isDistanceFilter(tree)) {
-		*root = _FilterTreeToDistanceQueryNode(tree, idx);
+		*root = _FilterTreeToDistanceIndexQuery(tree);
 		return true;
 	}
 
 	FT_FilterNodeType t = tree->t;
 
 	if(t == FT_N_COND) {
-		return _FilterTreeConditionToQueryNode(root, tree, idx);
+		return _FilterTreeConditionToIndexQuery(root, tree);
 	} else if(t == FT_N_PRED) {
-		return _FilterTreePredicateToQueryNode(root, tree, idx);
+		return _FilterTreePredicateToIndexQuery(root, tree);
 	} else {
 		ASSERT("unknown filter tree node type");
 		return false;
 	}
 }
 
-// creates a RediSearch query node out of given filter tree
-RSQNode *FilterTreeToQueryNode
+// creates an exact-match index query out of given filter tree
+IndexQuery *FilterTreeToIndexQuery
 (
 	FT_FilterNode **none_converted_filters, // [output] none convertable filters
-	const FT_FilterNode *tree,              // filter tree to convert
-	RSIndex *idx                            // index to query
+	const FT_FilterNode *tree               // filter tree to convert
 ) {
-	ASSERT(idx != NULL);
 	ASSERT(tree != NULL);
 	ASSERT(none_converted_filters != NULL);
 
 	// clone filter tree, as it is about to be modified
 	FT_FilterNode  *t       =  FilterTree_Clone(tree);
-	RSQNode        **nodes  =  array_new(RSQNode*, 1);  // intermidate nodes
-	FT_FilterNode  **trees  =  FilterTree_SubTrees(t);  // individual subtrees
+	IndexQuery     **nodes  =  array_new(IndexQuery*, 1);  // intermidate nodes
+	FT_FilterNode  **trees  =  FilterTree_SubTrees(t);     // individual subtrees
 
 	//--------------------------------------------------------------------------
 	// convert filters to numeric and string ranges
@@ -549,19 +505,19 @@ RSQNode *FilterTreeToQueryNode
 	rax *numeric_ranges = raxNew();
 	_compose_ranges(trees, string_ranges, numeric_ranges);
 	if(raxSize(string_ranges) > 0 || raxSize(numeric_ranges) > 0) {
-		RSQNode *ranges = _ranges_to_query_nodes(idx, string_ranges, numeric_ranges);
-		// TODO: check for empty node RediSearch_CreateEmptyNode
+		IndexQuery *ranges = _ranges_to_index_queries(string_ranges,
+				numeric_ranges);
 		array_append(nodes, ranges);
 	}
 
 	//--------------------------------------------------------------------------
-	// convert remaining filters into RediSearch query nodes
+	// convert remaining filters into index queries
 	//--------------------------------------------------------------------------
 
 	uint tree_count = array_len(trees);
 	for(uint i = 0; i < tree_count; i++) {
-		RSQNode *node = NULL;
-		bool resolved_filter = _FilterTreeToQueryNode(&node, trees[i], idx);
+		IndexQuery *node = NULL;
+		bool resolved_filter = _FilterTreeToIndexQuery(&node, trees[i]);
 		ASSERT(node != NULL);
 		array_append(nodes, node);
 		if(resolved_filter) {
@@ -583,11 +539,11 @@ RSQNode *FilterTreeToQueryNode
 	// none indexable type e.g. array
 	*none_converted_filters = FilterTree_Combine(trees, tree_count);
 
-	RSQNode  *root       =  NULL;
-	uint     node_count  =  array_len(nodes);
+	IndexQuery  *root       =  NULL;
+	uint        node_count  =  array_len(nodes);
 
-	// compose root query node by intersecting individual query nodes
-	root = _concat_query_nodes(idx, nodes, node_count);
+	// compose root query by intersecting individual queries
+	root = _concat_index_queries(nodes, node_count);
 
 	//--------------------------------------------------------------------------
 	// clean up
@@ -0,0 +1,15 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "filter_tree.h"
+#include "../index/index_query.h"
+
+// construct an exact-match index query from filter tree
+IndexQuery *FilterTreeToIndexQuery(FT_FilterNode **none_converted_filters,
+		const FT_FilterNode *tree);
+
@@ -7,6 +7,7 @@
 #include "graph_entity.h"
 #include "node.h"
 #include "edge.h"
+#include "property_columns.h"
 #include "../../RG.h"
 #include "../../errors.h"
 #include "../../query_ctx.h"
@@ -22,6 +23,10 @@ static bool _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_
 	// Quick return if attribute is missing.
 	if(attr_id == ATTRIBUTE_NOTFOUND) return false;
 
+	if(ENTITY_IS_COLUMNAR(e->entity)) {
+		return PropertyColumns_Remove(e->entity->columns, attr_id, e->id);
+	}
+
 	// Locate attribute position.
 	int prop_count = e->entity->prop_count;
 	for(int i = 0; i < prop_count; i++) {
@@ -51,6 +56,10 @@ static bool _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_
 int GraphEntity_ClearProperties(GraphEntity *e) {
 	ASSERT(e);
 
+	if(ENTITY_IS_COLUMNAR(e->entity)) {
+		return PropertyColumns_ClearRow(e->entity->columns, e->id);
+	}
+
 	int prop_count = e->entity->prop_count;
 	for(int i = 0; i < prop_count; i++) {
 		// free all allocated properties
@@ -65,10 +74,12 @@ int GraphEntity_ClearProperties(GraphEntity *e) {
 	return prop_count;
 }
 
-/* Add a new property to entity */
-bool GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value) {
-	ASSERT(e);
-	if(!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE)) return false;
+/* Add a new property to entity, entity owns 'value' */
+static void _GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value) {
+	if(ENTITY_IS_COLUMNAR(e->entity)) {
+		PropertyColumns_Set(e->entity->columns, attr_id, e->id, value);
+		return;
+	}
 
 	if(e->entity->properties == NULL) {
 		e->entity->properties = rm_malloc(sizeof(EntityProperty));
@@ -79,9 +90,27 @@ bool GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value
 
 	int prop_idx = e->entity->prop_count;
 	e->entity->properties[prop_idx].id = attr_id;
-	e->entity->properties[prop_idx].value = SI_CloneValue(value);
+	e->entity->properties[prop_idx].value = value;
 	e->entity->prop_count++;
+}
+
+/* Add a new property to entity */
+bool GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value) {
+	ASSERT(e);
+	if(!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE)) return false;
+
+	_GraphEntity_AddProperty(e, attr_id, SI_CloneValue(value));
+	return true;
+}
+
+/* Add a new property to entity, moving rather than cloning an owned value */
+bool GraphEntity_MoveProperty(GraphEntity *e, Attribute_ID attr_id, SIValue *value) {
+	ASSERT(e && value);
+	if(!(SI_TYPE(*value) & SI_VALID_PROPERTY_VALUE)) return false;
 
+	SIValue v = (value->allocation == M_SELF) ? SI_TransferOwnership(value) :
+				SI_CloneValue(*value);
+	_GraphEntity_AddProperty(e, attr_id, v);
 	return true;
 }
 
@@ -96,6 +125,12 @@ SIValue *GraphEntity_GetProperty(const GraphEntity *e, Attribute_ID attr_id) {
 		return PROPERTY_NOTFOUND;
 	}
 
+	if(ENTITY_IS_COLUMNAR(e->entity)) {
+		// Note, cell address is stable for the lifetime of the columns.
+		SIValue *v = PropertyColumns_Get(e->entity->columns, attr_id, e->id);
+		return (v != NULL) ? v : PROPERTY_NOTFOUND;
+	}
+
 	for(int i = 0; i < e->entity->prop_count; i++) {
 		if(attr_id == e->entity->properties[i].id) {
 			// Note, unsafe as entity properties can get reallocated.
@@ -125,6 +160,33 @@ bool GraphEntity_SetProperty(const GraphEntity *e, Attribute_ID attr_id, SIValue
 	return true;
 }
 
+int GraphEntity_PropertyCount(const GraphEntity *e) {
+	ASSERT(e);
+
+	if(ENTITY_IS_COLUMNAR(e->entity)) {
+		return PropertyColumns_RowPropertyCount(e->entity->columns, e->id);
+	}
+
+	return e->entity->prop_count;
+}
+
+bool GraphEntity_NextProperty(const GraphEntity *e, uint *cursor, Attribute_ID *attr_id,
+							  SIValue **value) {
+	ASSERT(e && cursor && attr_id && value);
+
+	if(ENTITY_IS_COLUMNAR(e->entity)) {
+		return PropertyColumns_NextProperty(e->entity->columns, e->id, cursor, attr_id, value);
+	}
+
+	if(*cursor >= e->entity->prop_count) return false;
+
+	EntityProperty *prop = e->entity->properties + *cursor;
+	*attr_id = prop->id;
+	*value = &prop->value;
+	(*cursor)++;
+	return true;
+}
+
 size_t GraphEntity_PropertiesToString(const GraphEntity *e, char **buffer, size_t *bufferLen,
 									  size_t *bytesWritten) {
 	// make sure there is enough space for "{...}\0"
@@ -135,10 +197,12 @@ size_t GraphEntity_PropertiesToString(const GraphEntity *e, char **buffer, size_
 	*bytesWritten += snprintf(*buffer, *bufferLen, "{");
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	int propCount = ENTITY_PROP_COUNT(e);
-	EntityProperty *properties = ENTITY_PROPS(e);
-	for(int i = 0; i < propCount; i++) {
+	uint cursor = 0;
+	SIValue *value;
+	Attribute_ID attr_id;
+	for(int i = 0; GraphEntity_NextProperty(e, &cursor, &attr_id, &value); i++) {
 		// print key
-		const char *key = GraphContext_GetAttributeString(gc, properties[i].id);
+		const char *key = GraphContext_GetAttributeString(gc, attr_id);
 		// check for enough space
 		size_t keyLen = strlen(key);
 		if(*bufferLen - *bytesWritten < keyLen) {
@@ -148,7 +212,7 @@ size_t GraphEntity_PropertiesToString(const GraphEntity *e, char **buffer, size_
 		*bytesWritten += snprintf(*buffer + *bytesWritten, *bufferLen, "%s:", key);
 
 		// print value
-		SIValue_ToString(properties[i].value, buffer, bufferLen, bytesWritten);
+		SIValue_ToString(*value, buffer, bufferLen, bytesWritten);
 
 		// if not the last element print ", "
 		if(i != propCount - 1) *bytesWritten = snprintf(*buffer + *bytesWritten, *bufferLen, ", ");
@@ -243,6 +307,8 @@ inline bool GraphEntity_IsDeleted(const GraphEntity *e) {
 
 void FreeEntity(Entity *e) {
 	ASSERT(e);
+	// columnar properties are cleared by the graph, which knows the entity's ID
+	if(ENTITY_IS_COLUMNAR(e)) return;
 	if(e->properties != NULL) {
 		for(int i = 0; i < e->prop_count; i++) SIValue_Free(e->properties[i].value);
 		rm_free(e->properties);
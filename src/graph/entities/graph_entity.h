@@ -17,8 +17,11 @@
 #define INVALID_ENTITY_ID -1l
 
 #define ENTITY_GET_ID(graphEntity) (graphEntity)->id
-#define ENTITY_PROP_COUNT(graphEntity) ((graphEntity)->entity->prop_count)
-#define ENTITY_PROPS(graphEntity) ((graphEntity)->entity->properties)
+#define ENTITY_PROP_COUNT(graphEntity) GraphEntity_PropertyCount((const GraphEntity *)(graphEntity))
+
+// prop_count marker of entities whose properties are stored in columns
+#define ENTITY_COLUMNAR -1
+#define ENTITY_IS_COLUMNAR(entity) ((entity)->prop_count == ENTITY_COLUMNAR)
 
 // Defined in graph_entity.c
 extern SIValue *PROPERTY_NOTFOUND;
@@ -49,11 +52,16 @@ typedef struct {
 	SIValue value;
 } EntityProperty;
 
+struct PropertyColumns;
+
 // Essence of a graph entity.
 // TODO: see if pragma pack 0 will cause memory access violation on ARM.
 typedef struct {
-	int prop_count;             // Number of properties.
-	EntityProperty *properties; // Key value pair of attributes.
+	int prop_count;                       // Number of properties, ENTITY_COLUMNAR if stored in columns.
+	union {
+		EntityProperty *properties;       // Key value pair of attributes.
+		struct PropertyColumns *columns;  // Columns holding entity's attributes, row = entity ID.
+	};
 } Entity;
 
 // Common denominator between nodes and edges.
@@ -70,6 +78,11 @@ int GraphEntity_ClearProperties(GraphEntity *e);
  * returns - reference to newly added property. */
 bool GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value);
 
+/* Adds property to entity, transferring ownership of 'value' to the entity
+ * rather than cloning it, 'value' is left volatile.
+ * Returns false and leaves 'value' untouched if it isn't a valid property value. */
+bool GraphEntity_MoveProperty(GraphEntity *e, Attribute_ID attr_id, SIValue *value);
+
 /* Retrieves entity's property
  * NOTE: If the key does not exist, we return the special
  * constant value PROPERTY_NOTFOUND. */
@@ -78,6 +91,14 @@ SIValue *GraphEntity_GetProperty(const GraphEntity *e, Attribute_ID attr_id);
 /* Updates existing attribute value, return true if property been updated. */
 bool GraphEntity_SetProperty(const GraphEntity *e, Attribute_ID attr_id, SIValue value);
 
+/* Returns number of properties set on entity. */
+int GraphEntity_PropertyCount(const GraphEntity *e);
+
+/* Iterates over entity's properties, '*cursor' should be set to 0 before the first call.
+ * returns false once all properties have been visited. */
+bool GraphEntity_NextProperty(const GraphEntity *e, uint *cursor, Attribute_ID *attr_id,
+							  SIValue **value);
+
 /* Prints the graph entity into a buffer, returns what is the string length, buffer can be re-allocated at need. */
 void GraphEntity_ToString(const GraphEntity *e, char **buffer, size_t *bufferLen,
 						  size_t *bytesWritten,
@@ -0,0 +1,222 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "property_columns.h"
+#include "RG.h"
+#include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+
+#define BLOCK_IDX(row) ((row) / PROPERTY_COLUMN_BLOCK_CAP)
+#define CELL_IDX(row)  ((row) % PROPERTY_COLUMN_BLOCK_CAP)
+
+static PropertyColumn *_PropertyColumn_New(void) {
+	PropertyColumn *col = rm_malloc(sizeof(PropertyColumn));
+	col->count  = 0;
+	col->blocks = array_new(SIValue *, 1);
+	return col;
+}
+
+// returns row's cell, NULL if row's block is not allocated
+static inline SIValue *_PropertyColumn_Cell(const PropertyColumn *col,
+		EntityID row) {
+	uint64_t block_idx = BLOCK_IDX(row);
+	if(block_idx >= array_len(col->blocks)) return NULL;
+
+	SIValue *block = col->blocks[block_idx];
+	if(block == NULL) return NULL;
+
+	return block + CELL_IDX(row);
+}
+
+// returns row's cell, allocating row's block if missing
+static SIValue *_PropertyColumn_ReserveCell(PropertyColumn *col,
+		EntityID row) {
+	uint64_t block_idx = BLOCK_IDX(row);
+	while(array_len(col->blocks) <= block_idx) {
+		array_append(col->blocks, NULL);
+	}
+
+	SIValue *block = col->blocks[block_idx];
+	if(block == NULL) {
+		block = rm_malloc(sizeof(SIValue) * PROPERTY_COLUMN_BLOCK_CAP);
+		for(uint i = 0; i < PROPERTY_COLUMN_BLOCK_CAP; i++) {
+			block[i] = SI_NullVal();
+		}
+		col->blocks[block_idx] = block;
+	}
+
+	return block + CELL_IDX(row);
+}
+
+static void _PropertyColumn_Free(PropertyColumn *col) {
+	uint block_count = array_len(col->blocks);
+	for(uint i = 0; i < block_count; i++) {
+		SIValue *block = col->blocks[i];
+		if(block == NULL) continue;
+		if(col->count > 0) {
+			for(uint j = 0; j < PROPERTY_COLUMN_BLOCK_CAP; j++) {
+				SIValue_Free(block[j]);
+			}
+		}
+		rm_free(block);
+	}
+	array_free(col->blocks);
+	rm_free(col);
+}
+
+static inline const PropertyColumn *_PropertyColumns_GetColumn
+(
+	const PropertyColumns *pc,
+	Attribute_ID attr_id
+) {
+	if(attr_id >= array_len(pc->columns)) return NULL;
+	return pc->columns[attr_id];
+}
+
+PropertyColumns *PropertyColumns_New(void) {
+	PropertyColumns *pc = rm_malloc(sizeof(PropertyColumns));
+	pc->columns = array_new(PropertyColumn *, 0);
+	return pc;
+}
+
+SIValue *PropertyColumns_Get
+(
+	const PropertyColumns *pc,
+	Attribute_ID attr_id,
+	EntityID row
+) {
+	ASSERT(pc != NULL);
+
+	const PropertyColumn *col = _PropertyColumns_GetColumn(pc, attr_id);
+	if(col == NULL) return NULL;
+
+	SIValue *cell = _PropertyColumn_Cell(col, row);
+	if(cell == NULL || SIValue_IsNull(*cell)) return NULL;
+
+	return cell;
+}
+
+void PropertyColumns_Set
+(
+	PropertyColumns *pc,
+	Attribute_ID attr_id,
+	EntityID row,
+	SIValue v
+) {
+	ASSERT(pc != NULL);
+	ASSERT(!SIValue_IsNull(v));
+
+	// introduce missing columns
+	while(array_len(pc->columns) <= attr_id) {
+		array_append(pc->columns, NULL);
+	}
+
+	PropertyColumn *col = pc->columns[attr_id];
+	if(col == NULL) {
+		col = _PropertyColumn_New();
+		pc->columns[attr_id] = col;
+	}
+
+	SIValue *cell = _PropertyColumn_ReserveCell(col, row);
+	if(SIValue_IsNull(*cell)) col->count++;
+	else SIValue_Free(*cell);
+
+	*cell = v;
+}
+
+bool PropertyColumns_Remove
+(
+	PropertyColumns *pc,
+	Attribute_ID attr_id,
+	EntityID row
+) {
+	ASSERT(pc != NULL);
+
+	SIValue *cell = PropertyColumns_Get(pc, attr_id, row);
+	if(cell == NULL) return false;
+
+	SIValue_Free(*cell);
+	*cell = SI_NullVal();
+	pc->columns[attr_id]->count--;
+
+	return true;
+}
+
+int PropertyColumns_ClearRow
+(
+	PropertyColumns *pc,
+	EntityID row
+) {
+	ASSERT(pc != NULL);
+
+	int removed = 0;
+	uint column_count = array_len(pc->columns);
+	for(Attribute_ID i = 0; i < column_count; i++) {
+		if(PropertyColumns_Remove(pc, i, row)) removed++;
+	}
+
+	return removed;
+}
+
+int PropertyColumns_RowPropertyCount
+(
+	const PropertyColumns *pc,
+	EntityID row
+) {
+	ASSERT(pc != NULL);
+
+	int count = 0;
+	uint column_count = array_len(pc->columns);
+	for(Attribute_ID i = 0; i < column_count; i++) {
+		if(PropertyColumns_Get(pc, i, row) != NULL) count++;
+	}
+
+	return count;
+}
+
+bool PropertyColumns_NextProperty
+(
+	const PropertyColumns *pc,
+	EntityID row,
+	uint *cursor,
+	Attribute_ID *attr_id,
+	SIValue **value
+) {
+	ASSERT(pc != NULL);
+	ASSERT(value != NULL);
+	ASSERT(cursor != NULL);
+	ASSERT(attr_id != NULL);
+
+	uint column_count = array_len(pc->columns);
+	while(*cursor < column_count) {
+		Attribute_ID id = *cursor;
+		(*cursor)++;
+
+		SIValue *cell = PropertyColumns_Get(pc, id, row);
+		if(cell == NULL) continue;
+
+		*attr_id = id;
+		*value = cell;
+		return true;
+	}
+
+	return false;
+}
+
+void PropertyColumns_Free
+(
+	PropertyColumns *pc
+) {
+	ASSERT(pc != NULL);
+
+	uint column_count = array_len(pc->columns);
+	for(uint i = 0; i < column_count; i++) {
+		if(pc->columns[i] != NULL) _PropertyColumn_Free(pc->columns[i]);
+	}
+	array_free(pc->columns);
+	rm_free(pc);
+}
+
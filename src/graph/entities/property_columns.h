@@ -0,0 +1,96 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "graph_entity.h"
+
+// PropertyColumns holds the properties of every node sharing a label
+// in a columnar layout, one column per attribute
+//
+// a column is an array of SIValue cells indexed by node ID, cells are
+// grouped into fixed size blocks which are allocated on first write
+// such that sparse node IDs do not inflate memory consumption
+// an empty cell holds a NULL value, as NULL is never a valid property value
+//
+// cell addresses are stable for the lifetime of the columns object
+
+// number of cells in a column block
+#define PROPERTY_COLUMN_BLOCK_CAP 1024
+
+typedef struct {
+	uint64_t count;                // number of non empty cells
+	SIValue **blocks;              // array of blocks, NULL for unallocated blocks
+} PropertyColumn;
+
+typedef struct PropertyColumns {
+	PropertyColumn **columns;      // attribute ID to column, NULL if missing
+} PropertyColumns;
+
+// create a new empty set of columns
+PropertyColumns *PropertyColumns_New(void);
+
+// returns cell holding attribute 'attr_id' of row 'row'
+// NULL if row does not have this attribute
+SIValue *PropertyColumns_Get
+(
+	const PropertyColumns *pc,
+	Attribute_ID attr_id,
+	EntityID row
+);
+
+// sets attribute 'attr_id' of row 'row' to 'v'
+// columns take ownership over 'v', replaced value is freed
+void PropertyColumns_Set
+(
+	PropertyColumns *pc,
+	Attribute_ID attr_id,
+	EntityID row,
+	SIValue v
+);
+
+// removes attribute 'attr_id' from row 'row'
+// returns true if attribute was removed
+bool PropertyColumns_Remove
+(
+	PropertyColumns *pc,
+	Attribute_ID attr_id,
+	EntityID row
+);
+
+// removes every attribute of row 'row'
+// returns number of removed attributes
+int PropertyColumns_ClearRow
+(
+	PropertyColumns *pc,
+	EntityID row
+);
+
+// returns number of attributes set on row 'row'
+int PropertyColumns_RowPropertyCount
+(
+	const PropertyColumns *pc,
+	EntityID row
+);
+
+// iterates over row's attributes, in attribute ID order
+// '*cursor' should be set to 0 prior to the first call
+// returns false once all attributes have been visited
+bool PropertyColumns_NextProperty
+(
+	const PropertyColumns *pc,
+	EntityID row,
+	uint *cursor,
+	Attribute_ID *attr_id,
+	SIValue **value
+);
+
+void PropertyColumns_Free
+(
+	PropertyColumns *pc
+);
+
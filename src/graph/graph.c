@@ -13,120 +13,15 @@
 #include "../GraphBLASExt/GxB_Delete.h"
 #include "../util/datablock/oo_datablock.h"
 
-static GrB_BinaryOp _graph_edge_accum = NULL;
-// GraphBLAS binary operator for freeing edges
-static GrB_BinaryOp _binary_op_delete_edges = NULL;
+// Max number of relation entries the writer stages before folding
+// relation matrices deltas.
+#define GRAPH_STAGED_CONNECTIONS_CAP 262144
 
 //------------------------------------------------------------------------------
 // Forward declarations
 //------------------------------------------------------------------------------
 void _MatrixResizeToCapacity(const Graph *g, RG_Matrix m);
-
-//------------------------------------------------------------------------------
-// GraphBLAS functions
-//------------------------------------------------------------------------------
-void _edge_accum(void *_z, const void *_x, const void *_y) {
-	EdgeID *z = (EdgeID *)_z;
-	const EdgeID *x = (const EdgeID *)_x;
-	const EdgeID *y = (const EdgeID *)_y;
-
-	EdgeID *ids;
-	/* Single edge ID,
-	 * switching from single edge ID to multiple IDs. */
-	if(SINGLE_EDGE(*x)) {
-		ids = array_new(EdgeID, 2);
-		array_append(ids, SINGLE_EDGE_ID(*x));
-		array_append(ids, SINGLE_EDGE_ID(*y));
-		// TODO: Make sure MSB of ids isn't on.
-		*z = (EdgeID)ids;
-	} else {
-		// Multiple edges, adding another edge.
-		ids = (EdgeID *)(*x);
-		array_append(ids, SINGLE_EDGE_ID(*y));
-		*z = (EdgeID)ids;
-	}
-}
-
-void _binary_op_free_edge(void *z, const void *x, const void *y) {
-	const Graph *g = (const Graph *) * ((uint64_t *)x);
-	const EdgeID *id = (const EdgeID *)y;
-
-	if((SINGLE_EDGE(*id))) {
-		DataBlock_DeleteItem(g->edges, SINGLE_EDGE_ID(*id));
-	} else {
-		EdgeID *ids = (EdgeID *)(*id);
-		uint id_count = array_len(ids);
-		for(uint i = 0; i < id_count; i++) {
-			DataBlock_DeleteItem(g->edges, ids[i]);
-		}
-		array_free(ids);
-	}
-}
-
-/* ========================= RG_Matrix functions =============================== */
-
-// Creates a new matrix
-static RG_Matrix RG_Matrix_New(const Graph *g, GrB_Type data_type) {
-	GrB_Info info;
-	UNUSED(info);
-
-	RG_Matrix matrix = rm_calloc(1, sizeof(_RG_Matrix));
-	matrix->dirty             =  true;
-	matrix->allow_multi_edge  =  true;
-
-	GrB_Index n = Graph_RequiredMatrixDim(g);
-	info = GrB_Matrix_new(&matrix->grb_matrix, data_type, n, n);
-	ASSERT(info == GrB_SUCCESS);
-
-	// matrix iterator requires matrix format to be sparse
-	// to avoid future conversion from HYPER-SPARSE, BITMAP, FULL to SPARSE
-	// we set matrix format at creation time
-	info = GxB_set(matrix->grb_matrix, GxB_SPARSITY_CONTROL, GxB_SPARSE);
-	ASSERT(info == GrB_SUCCESS);
-
-	int mutex_res = pthread_mutex_init(&matrix->mutex, NULL);
-	ASSERT(mutex_res == 0);
-
-	return matrix;
-}
-
-// Returns underlying GraphBLAS matrix.
-static inline GrB_Matrix RG_Matrix_Get_GrB_Matrix(RG_Matrix matrix) {
-	return matrix->grb_matrix;
-}
-
-static inline bool RG_Matrix_IsDirty(RG_Matrix matrix) {
-	return matrix->dirty;
-}
-
-static inline void RG_Matrix_SetDirty(RG_Matrix matrix) {
-	matrix->dirty = true;
-}
-
-static inline void RG_Matrix_SetUnDirty(RG_Matrix matrix) {
-	matrix->dirty = false;
-}
-
-// Locks the matrix.
-static inline void RG_Matrix_Lock(RG_Matrix matrix) {
-	pthread_mutex_lock(&matrix->mutex);
-}
-
-// Unlocks the matrix.
-static inline void _RG_Matrix_Unlock(RG_Matrix matrix) {
-	pthread_mutex_unlock(&matrix->mutex);
-}
-
-static inline bool _RG_Matrix_MultiEdgeEnabled(const RG_Matrix matrix) {
-	return matrix->allow_multi_edge;
-}
-
-// Free RG_Matrix.
-static void RG_Matrix_Free(RG_Matrix matrix) {
-	GrB_Matrix_free(&matrix->grb_matrix);
-	pthread_mutex_destroy(&matrix->mutex);
-	rm_free(matrix);
-}
+static void _MatrixResize(const Graph *g, RG_Matrix m);
 
 /* ========================= Synchronization functions ========================= */
 
@@ -139,6 +34,7 @@ void Graph_AcquireReadLock(Graph *g) {
 void Graph_AcquireWriteLock(Graph *g) {
 	pthread_rwlock_wrlock(&g->_rwlock);
 	g->_writelocked = true;
+	__atomic_add_fetch(&g->_epoch, 1, __ATOMIC_RELAXED);
 }
 
 /* Release the held lock */
@@ -154,6 +50,10 @@ void Graph_ReleaseLock(Graph *g) {
 	pthread_rwlock_unlock(&g->_rwlock);
 }
 
+uint64_t Graph_GetEpoch(const Graph *g) {
+	return __atomic_load_n(&g->_epoch, __ATOMIC_RELAXED);
+}
+
 /* Writer request access to graph. */
 void Graph_WriterEnter(Graph *g) {
 	pthread_mutex_lock(&g->_writers_mutex);
@@ -164,12 +64,6 @@ void Graph_WriterLeave(Graph *g) {
 	pthread_mutex_unlock(&g->_writers_mutex);
 }
 
-/* Force execution of all pending operations on a matrix. */
-static inline void _Graph_ApplyPending(GrB_Matrix m) {
-	GrB_Info res = GrB_wait(&m);
-	ASSERT(res == GrB_SUCCESS);
-}
-
 /* ========================= Graph utility functions ========================= */
 
 // Return number of nodes graph can contain.
@@ -182,6 +76,136 @@ static inline size_t _Graph_EdgeCap(const Graph *g) {
 	return g->edges->itemCap;
 }
 
+/* ========================= Staged connections ============================ */
+
+/* Relation matrix entries introduced by the writer are staged within the
+ * matrix delta-plus, looking up such an entry would force GraphBLAS to
+ * assemble every pending tuple of delta-plus. To avoid this the writer keeps
+ * an index of the entries it had staged: (r, src, dest) -> entry value.
+ * Every relation entry held by delta-plus is present within the index,
+ * relations which disallow multi-edge entries are the exception, these are
+ * populated only while decoding where no lookups are performed. */
+
+typedef struct {
+	uint64_t r;
+	NodeID src;
+	NodeID dest;
+} _StagedKey;
+
+// retrieves relation r entry at position [src, dest]
+// sets 'staged' to true if the entry is staged within the matrix delta-plus
+static GrB_Info _Graph_GetConnection
+(
+	const Graph *g,
+	int r,
+	NodeID src,
+	NodeID dest,
+	EdgeID *x,
+	bool *staged
+) {
+	_StagedKey key = {r, src, dest};
+	void *v = raxFind(g->_staged_connections, (unsigned char *)&key,
+			sizeof(key));
+
+	if(staged != NULL) *staged = (v != raxNotFound);
+	if(v != raxNotFound) {
+		*x = (EdgeID)v;
+		return GrB_SUCCESS;
+	}
+
+	// entry is not staged, consult the main matrix
+	return RG_Matrix_extractMainElement_UINT64(x, g->relations[r], src, dest);
+}
+
+// sets relation r entry at position [src, dest] and its transpose to x
+// a relation matrix and its transpose share the same multi-edge lists
+static void _Graph_SetConnection
+(
+	Graph *g,
+	int r,
+	NodeID src,
+	NodeID dest,
+	EdgeID x,
+	bool staged  // entry isn't part of the main matrix
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	info = RG_Matrix_setElement_UINT64(g->relations[r], x, src, dest);
+	ASSERT(info == GrB_SUCCESS);
+
+	bool maintain_transpose;
+	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
+	if(maintain_transpose) {
+		info = RG_Matrix_setElement_UINT64(g->t_relations[r], x, dest, src);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	if(staged) {
+		_StagedKey key = {r, src, dest};
+		raxInsert(g->_staged_connections, (unsigned char *)&key, sizeof(key),
+				(void *)x, NULL);
+	}
+}
+
+// removes relation r entry at position [src, dest] and its transpose
+static void _Graph_RemoveConnection
+(
+	Graph *g,
+	int r,
+	NodeID src,
+	NodeID dest
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	info = RG_Matrix_removeElement(g->relations[r], src, dest);
+	ASSERT(info == GrB_SUCCESS);
+
+	bool maintain_transpose;
+	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
+	if(maintain_transpose) {
+		info = RG_Matrix_removeElement(g->t_relations[r], dest, src);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	_StagedKey key = {r, src, dest};
+	raxRemove(g->_staged_connections, (unsigned char *)&key, sizeof(key), NULL);
+}
+
+// discard staged index, only valid once relation matrices deltas are folded
+static void _Graph_ClearStagedConnections(Graph *g) {
+	if(raxSize(g->_staged_connections) == 0) return;
+
+	uint relation_count = Graph_RelationTypeCount(g);
+	for(uint i = 0; i < relation_count; i++) {
+		if(RG_Matrix_IsDirty(g->relations[i])) return;
+	}
+
+	raxFree(g->_staged_connections);
+	g->_staged_connections = raxNew();
+}
+
+// fold relation matrices deltas and discard the staged index
+static void _Graph_FlushStagedConnections(Graph *g) {
+	if(raxSize(g->_staged_connections) == 0) return;
+
+	bool maintain_transpose;
+	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
+
+	uint relation_count = Graph_RelationTypeCount(g);
+	for(uint i = 0; i < relation_count; i++) {
+		RG_Matrix R = g->relations[i];
+		if(RG_Matrix_IsDirty(R)) RG_Matrix_Sync(R);
+		if(maintain_transpose) {
+			RG_Matrix TR = g->t_relations[i];
+			if(RG_Matrix_IsDirty(TR)) RG_Matrix_Sync(TR);
+		}
+	}
+
+	_Graph_ClearStagedConnections(g);
+}
+
 static void _CollectEdgesFromEntry
 (
 	const Graph *g,
@@ -206,11 +230,12 @@ static void _CollectEdgesFromEntry
 		array_append(*edges, e);
 	} else {
 		// multiple edges connecting src to dest,
-		// entry is a pointer to an array of edge IDs
-		EdgeID *edgeIds = (EdgeID *)edgeId;
-		int edgeCount = array_len(edgeIds);
+		// entry is the ID of a list within the relation multi-edge store
+		uint32_t edgeCount;
+		const EdgeID *edgeIds = MultiEdgeStore_GetList(g->multi_edges[r],
+				edgeId, &edgeCount);
 
-		for(int i = 0; i < edgeCount; i++) {
+		for(uint32_t i = 0; i < edgeCount; i++) {
 			edgeId = edgeIds[i];
 			e.entity = DataBlock_GetItem(g->edges, edgeId);
 			e.id = edgeId;
@@ -236,9 +261,10 @@ void _Graph_GetEdgesConnectingNodes
 	ASSERT(dest < Graph_RequiredMatrixDim(g));
 
 	// relation map, maps (src, dest, r) to edge IDs.
-	EdgeID      id    =  INVALID_ENTITY_ID;
-	GrB_Matrix  M     =  Graph_GetRelationMatrix(g, r);
-	GrB_Info    res   =  GrB_Matrix_extractElement_UINT64(&id, M, src, dest);
+	EdgeID     id  =  INVALID_ENTITY_ID;
+	RG_Matrix  M   =  g->relations[r];
+	_MatrixResize(g, M);
+	GrB_Info   res =  _Graph_GetConnection(g, r, src, dest, &id, NULL);
 
 	// no entry at [dest, src], src is not connected to dest with relation R
 	if(res == GrB_NO_VALUE) return;
@@ -275,10 +301,42 @@ static inline void _Graph_SetRelationMatrixDirty(const Graph *g, int relation_id
 }
 
 /* Resize given matrix, such that its number of row and columns
- * matches the number of nodes in the graph. Also, synchronize
- * matrix to execute any pending operations. */
+ * matches the number of nodes in the graph.
+ * Matrix deltas are left untouched, which makes this routine suitable for
+ * point lookups and updates. */
+static void _MatrixResize(const Graph *g, RG_Matrix rg_matrix) {
+	GrB_Matrix m = RG_Matrix_Get_GrB_Matrix(rg_matrix);
+	GrB_Index n_rows;
+	GrB_Matrix_nrows(&n_rows, m);
+	GrB_Index dims = Graph_RequiredMatrixDim(g);
+
+	// matrices are square, checking rows count is sufficient
+	if(n_rows == dims) return;
+
+	// if the graph belongs to one thread, we don't need to lock the mutex
+	if(g->_writelocked) {
+		GrB_Info res = RG_Matrix_Resize(rg_matrix, dims);
+		ASSERT(res == GrB_SUCCESS);
+		return;
+	}
+
+	RG_Matrix_Lock(rg_matrix);
+
+	// recheck, some other thread might have performed the resize
+	GrB_Matrix_nrows(&n_rows, m);
+	dims = Graph_RequiredMatrixDim(g);
+	if(n_rows != dims) {
+		GrB_Info res = RG_Matrix_Resize(rg_matrix, dims);
+		ASSERT(res == GrB_SUCCESS);
+	}
+
+	RG_Matrix_Unlock(rg_matrix);
+}
+
+/* Resize given matrix, such that its number of row and columns
+ * matches the number of nodes in the graph. Also, fold matrix deltas
+ * and execute any pending operations. */
 void _MatrixSynchronize(const Graph *g, RG_Matrix rg_matrix) {
-	bool dirty = RG_Matrix_IsDirty(rg_matrix);
 	GrB_Matrix m = RG_Matrix_Get_GrB_Matrix(rg_matrix);
 	GrB_Index n_rows;
 	GrB_Index n_cols;
@@ -299,11 +357,13 @@ void _MatrixSynchronize(const Graph *g, RG_Matrix rg_matrix) {
 	// if the graph belongs to one thread, we don't need to lock the mutex
 	if(g->_writelocked) {
 		if(require_resize) {
-			GrB_Info res = GxB_Matrix_resize(m, dims, dims);
+			GrB_Info res = RG_Matrix_Resize(rg_matrix, dims);
 			ASSERT(res == GrB_SUCCESS);
 		}
 
-		// writer under write lock, no need to flush pending changes
+		// writer is about to use the matrix as a whole,
+		// fold pending deltas into the main matrix
+		if(RG_Matrix_IsDirty(rg_matrix)) RG_Matrix_Sync(rg_matrix);
 		return;
 	}
 
@@ -311,6 +371,10 @@ void _MatrixSynchronize(const Graph *g, RG_Matrix rg_matrix) {
 	// sync under READ
 	//--------------------------------------------------------------------------
 
+	// writers sync every matrix they've modified before releasing
+	// the write lock, readers should only get here if the graph
+	// was modified without holding the write lock, e.g. while decoding
+
 	// lock the matrix
 	RG_Matrix_Lock(rg_matrix);
 
@@ -325,18 +389,16 @@ void _MatrixSynchronize(const Graph *g, RG_Matrix rg_matrix) {
 
 	// resize if required
 	if(require_resize) {
-		GrB_Info res = GxB_Matrix_resize(m, dims, dims);
+		GrB_Info res = RG_Matrix_Resize(rg_matrix, dims);
 		ASSERT(res == GrB_SUCCESS);
 	}
 
-	// flush pending changes if dirty
-	if(RG_Matrix_IsDirty(rg_matrix)) _Graph_ApplyPending(m);
-
-	RG_Matrix_SetUnDirty(rg_matrix);
+	// fold deltas and flush pending changes if dirty
+	if(RG_Matrix_IsDirty(rg_matrix)) RG_Matrix_Sync(rg_matrix);
 
 cleanup:
 	// Unlock matrix mutex.
-	_RG_Matrix_Unlock(rg_matrix);
+	RG_Matrix_Unlock(rg_matrix);
 }
 
 /* Resize matrix to node capacity. */
@@ -350,7 +412,7 @@ void _MatrixResizeToCapacity(const Graph *g, RG_Matrix matrix) {
 
 	// This policy should only be used in a thread-safe context, so no locking is required.
 	if(nrows != cap || ncols != cap) {
-		GrB_Info res = GxB_Matrix_resize(m, cap, cap);
+		GrB_Info res = RG_Matrix_Resize(matrix, cap);
 		ASSERT(res == GrB_SUCCESS);
 	}
 }
@@ -386,6 +448,9 @@ void Graph_SetMatrixPolicy(Graph *g, MATRIX_POLICY policy) {
 void Graph_ApplyAllPending(Graph *g) {
 	RG_Matrix M;
 
+	g->SynchronizeMatrix(g, g->adjacency_matrix);
+	g->SynchronizeMatrix(g, g->_t_adjacency_matrix);
+
 	for(int i = 0; i < array_len(g->labels); i ++) {
 		M = g->labels[i];
 		g->SynchronizeMatrix(g, M);
@@ -405,6 +470,9 @@ void Graph_ApplyAllPending(Graph *g) {
 			g->SynchronizeMatrix(g, M);
 		}
 	}
+
+	// staged relation entries are now part of the main matrices
+	_Graph_ClearStagedConnections(g);
 }
 
 /* ================================ Graph API ================================ */
@@ -418,9 +486,12 @@ Graph *Graph_New(size_t node_cap, size_t edge_cap) {
 	g->edges                =  DataBlock_New(edge_cap, sizeof(Entity), (fpDestructor)FreeEntity);
 	g->labels               =  array_new(RG_Matrix, GRAPH_DEFAULT_LABEL_CAP);
 	g->relations            =  array_new(RG_Matrix, GRAPH_DEFAULT_RELATION_TYPE_CAP);
-	g->adjacency_matrix     =  RG_Matrix_New(g, GrB_BOOL);
-	g->_t_adjacency_matrix  =  RG_Matrix_New(g, GrB_BOOL);
-	g->_zero_matrix         =  RG_Matrix_New(g, GrB_BOOL);
+	g->multi_edges          =  array_new(MultiEdgeStore *, GRAPH_DEFAULT_RELATION_TYPE_CAP);
+	g->_staged_connections  =  raxNew();
+	GrB_Index n             =  Graph_RequiredMatrixDim(g);
+	g->adjacency_matrix     =  RG_Matrix_New(GrB_BOOL, n);
+	g->_t_adjacency_matrix  =  RG_Matrix_New(GrB_BOOL, n);
+	g->_zero_matrix         =  RG_Matrix_New(GrB_BOOL, n);
 
 	// init graph statistics
 	GraphStatistics_init(&g->stats);
@@ -431,12 +502,19 @@ Graph *Graph_New(size_t node_cap, size_t edge_cap) {
 	g->t_relations = maintain_transpose ?
 					 array_new(RG_Matrix, GRAPH_DEFAULT_RELATION_TYPE_CAP) : NULL;
 
+	// If labeled node properties are stored in columns, allocate a columns array per label.
+	bool node_property_columns;
+	Config_Option_get(Config_NODE_PROPERTY_COLUMNS, &node_property_columns);
+	g->node_columns = node_property_columns ?
+					  array_new(PropertyColumns *, GRAPH_DEFAULT_LABEL_CAP) : NULL;
+
 	// Initialize a read-write lock scoped to the individual graph
 	int res;
 	UNUSED(res);
 	res = pthread_rwlock_init(&g->_rwlock, NULL);
 	ASSERT(res == 0);
 	g->_writelocked = false;
+	g->_epoch = 0;
 
 	// Force GraphBLAS updates and resize matrices to node count by default
 	Graph_SetMatrixPolicy(g, SYNC_AND_MINIMIZE_SPACE);
@@ -445,14 +523,6 @@ Graph *Graph_New(size_t node_cap, size_t edge_cap) {
 	res = pthread_mutex_init(&g->_writers_mutex, NULL);
 	ASSERT(res == 0);
 
-	// Create edge accumulator binary function
-	if(!_graph_edge_accum) {
-		GrB_Info info;
-		UNUSED(info);
-		info = GrB_BinaryOp_new(&_graph_edge_accum, _edge_accum, GrB_UINT64, GrB_UINT64, GrB_UINT64);
-		ASSERT(info == GrB_SUCCESS);
-	}
-
 	return g;
 }
 
@@ -492,6 +562,95 @@ uint64_t Graph_RelationEdgeCount(const Graph *g, int relation_idx) {
 	return GraphStatistics_EdgeCount(&g->stats, relation_idx);
 }
 
+double Graph_RelationAvgDegree(const Graph *g, int relation_idx,
+		GRAPH_EDGE_DIR dir) {
+	ASSERT(g);
+	switch(dir) {
+		case GRAPH_EDGE_DIR_OUTGOING:
+			return GraphStatistics_AvgOutDegree(&g->stats, relation_idx);
+		case GRAPH_EDGE_DIR_INCOMING:
+			return GraphStatistics_AvgInDegree(&g->stats, relation_idx);
+		default:
+			return GraphStatistics_AvgOutDegree(&g->stats, relation_idx) +
+				   GraphStatistics_AvgInDegree(&g->stats, relation_idx);
+	}
+}
+
+uint32_t Graph_RelationMaxDegree(const Graph *g, int relation_idx,
+		GRAPH_EDGE_DIR dir) {
+	ASSERT(g);
+	switch(dir) {
+		case GRAPH_EDGE_DIR_OUTGOING:
+			return GraphStatistics_MaxOutDegree(&g->stats, relation_idx);
+		case GRAPH_EDGE_DIR_INCOMING:
+			return GraphStatistics_MaxInDegree(&g->stats, relation_idx);
+		default:
+			return GraphStatistics_MaxOutDegree(&g->stats, relation_idx) +
+				   GraphStatistics_MaxInDegree(&g->stats, relation_idx);
+	}
+}
+
+// degree of node over a single relationship type
+static uint64_t _Graph_RelationNodeDegree(const Graph *g, NodeID id,
+		GRAPH_EDGE_DIR dir, int r) {
+	uint64_t degree = 0;
+	if(dir == GRAPH_EDGE_DIR_OUTGOING || dir == GRAPH_EDGE_DIR_BOTH) {
+		degree += GraphStatistics_OutDegree(&g->stats, r, id);
+	}
+	if(dir == GRAPH_EDGE_DIR_INCOMING || dir == GRAPH_EDGE_DIR_BOTH) {
+		degree += GraphStatistics_InDegree(&g->stats, r, id);
+	}
+	return degree;
+}
+
+uint64_t Graph_GetNodeDegree(const Graph *g, NodeID id, GRAPH_EDGE_DIR dir,
+		int edgeType) {
+	ASSERT(g);
+
+	// relationship type doesn't exist, no edges carry it
+	if(edgeType == GRAPH_UNKNOWN_RELATION) return 0;
+	if(edgeType != GRAPH_NO_RELATION) {
+		return _Graph_RelationNodeDegree(g, id, dir, edgeType);
+	}
+
+	// sum up degree over all relationship types
+	uint64_t degree = 0;
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int r = 0; r < relation_count; r++) {
+		degree += _Graph_RelationNodeDegree(g, id, dir, r);
+	}
+	return degree;
+}
+
+void Graph_RecountDegrees(Graph *g) {
+	ASSERT(g);
+
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int r = 0; r < relation_count; r++) {
+		GraphStatistics_ResetDegrees(&g->stats, r);
+
+		GxB_MatrixTupleIter *it;
+		MultiEdgeStore *store = g->multi_edges[r];
+		GxB_MatrixTupleIter_new(&it, Graph_GetRelationMatrix(g, r));
+		while(true) {
+			EdgeID id;
+			GrB_Index src;
+			GrB_Index dest;
+			bool depleted = false;
+			GxB_MatrixTupleIter_next(it, &src, &dest, &id, &depleted);
+			if(depleted) break;
+
+			// entry is either a single edge or a list of edges
+			uint32_t edge_count = 1;
+			if(!(SINGLE_EDGE(id))) {
+				MultiEdgeStore_GetList(store, id, &edge_count);
+			}
+			GraphStatistics_IncDegree(&g->stats, r, src, dest, edge_count);
+		}
+		GxB_MatrixTupleIter_free(it);
+	}
+}
+
 uint Graph_DeletedEdgeCount(const Graph *g) {
 	ASSERT(g);
 	return DataBlock_DeletedItemsCount(g->edges);
@@ -534,8 +693,9 @@ int Graph_GetNodeLabel(const Graph *g, NodeID nodeID) {
 	int label = GRAPH_NO_LABEL;
 	for(int i = 0; i < array_len(g->labels); i++) {
 		bool x = false;
-		GrB_Matrix M = Graph_GetLabelMatrix(g, i);
-		GrB_Info res = GrB_Matrix_extractElement_BOOL(&x, M, nodeID, nodeID);
+		RG_Matrix M = g->labels[i];
+		_MatrixResize(g, M);
+		GrB_Info res = RG_Matrix_extractElement_BOOL(&x, M, nodeID, nodeID);
 		if(res == GrB_SUCCESS && x == true) {
 			label = i;
 			break;
@@ -556,8 +716,10 @@ int Graph_GetEdgeRelation(const Graph *g, Edge *e) {
 	uint relationship_count = array_len(g->relations);
 	for(uint i = 0; i < relationship_count; i++) {
 		EdgeID edgeId = 0;
-		GrB_Matrix M = Graph_GetRelationMatrix(g, i);
-		GrB_Info res = GrB_Matrix_extractElement_UINT64(&edgeId, M, srcNodeID, destNodeID);
+		RG_Matrix M = g->relations[i];
+		_MatrixResize(g, M);
+		GrB_Info res = _Graph_GetConnection(g, i, srcNodeID, destNodeID,
+				&edgeId, NULL);
 		if(res != GrB_SUCCESS) continue;
 
 		if(SINGLE_EDGE(edgeId)) {
@@ -569,9 +731,10 @@ int Graph_GetEdgeRelation(const Graph *g, Edge *e) {
 		} else {
 			/* Multiple edges exists between src and dest
 			 * see if given edge is one of them. */
-			EdgeID *edges = (EdgeID *)edgeId;
-			int edge_count = array_len(edges);
-			for(int j = 0; j < edge_count; j++) {
+			uint32_t edge_count;
+			const EdgeID *edges = MultiEdgeStore_GetList(g->multi_edges[i],
+					edgeId, &edge_count);
+			for(uint32_t j = 0; j < edge_count; j++) {
 				if(edges[j] == id) {
 					Edge_SetRelationID(e, i);
 					return i;
@@ -620,7 +783,42 @@ void Graph_GetEdgesConnectingNodes
 	}
 }
 
-void Graph_CreateNode(Graph *g, int label, Node *n) {
+const EdgeID *Graph_GetMultiEdgeList
+(
+	const Graph *g,
+	int r,
+	uint64_t list_id,
+	uint32_t *len
+) {
+	ASSERT(g);
+	ASSERT(len);
+	ASSERT(r >= 0 && r < Graph_RelationTypeCount(g));
+	ASSERT(!(SINGLE_EDGE(list_id)));
+
+	return MultiEdgeStore_GetList(g->multi_edges[r], list_id, len);
+}
+
+// initialize a newly allocated node entity
+// labeled nodes keep their properties in their label's columns if enabled
+void Graph_InitNodeEntity(const Graph *g, Entity *en, int label) {
+	if(g->node_columns != NULL && label != GRAPH_NO_LABEL) {
+		en->prop_count = ENTITY_COLUMNAR;
+		en->columns = g->node_columns[label];
+	} else {
+		en->prop_count = 0;
+		en->properties = NULL;
+	}
+}
+
+// clear columnar node properties
+// property bags are released by the node datablock destructor
+static inline void _Graph_ClearNodeColumns(Node *n) {
+	if(n->entity != NULL && ENTITY_IS_COLUMNAR(n->entity)) {
+		PropertyColumns_ClearRow(n->entity->columns, ENTITY_GET_ID(n));
+	}
+}
+
+void Graph_CreateNodeEntity(Graph *g, int label, Node *n) {
 	ASSERT(g);
 
 	NodeID id;
@@ -628,99 +826,101 @@ void Graph_CreateNode(Graph *g, int label, Node *n) {
 	n->id = id;
 	n->entity = en;
 	n->labelID = label;
-	en->prop_count = 0;
-	en->properties = NULL;
+	Graph_InitNodeEntity(g, en, label);
+}
+
+void Graph_CreateNode(Graph *g, int label, Node *n) {
+	ASSERT(g);
+
+	Graph_CreateNodeEntity(g, label, n);
+	NodeID id = ENTITY_GET_ID(n);
 
 	if(label != GRAPH_NO_LABEL) {
 		// Try to set matrix at position [id, id]
 		// incase of a failure, scale matrix.
 		RG_Matrix matrix = g->labels[label];
-		GrB_Matrix m = RG_Matrix_Get_GrB_Matrix(matrix);
-		GrB_Info res = GrB_Matrix_setElement_BOOL(m, true, id, id);
+		GrB_Info res = RG_Matrix_setElement_BOOL(matrix, id, id);
 		if(res != GrB_SUCCESS) {
 			_MatrixResizeToCapacity(g, matrix);
-			res = GrB_Matrix_setElement_BOOL(m, true, id, id);
+			res = RG_Matrix_setElement_BOOL(matrix, id, id);
 			ASSERT(res == GrB_SUCCESS);
 		}
-		_Graph_SetLabelMatrixDirty(g, label);
 	}
 }
 
 void Graph_FormConnection(Graph *g, NodeID src, NodeID dest, EdgeID edge_id, int r) {
 	GrB_Info info;
 	UNUSED(info);
-	RG_Matrix M = g->relations[r];
-	GrB_Matrix t_relationMat = NULL;
-	GrB_Matrix adj = Graph_GetAdjacencyMatrix(g);
-	GrB_Matrix tadj = Graph_GetTransposedAdjacencyMatrix(g);
-	GrB_Matrix relationMat = Graph_GetRelationMatrix(g, r);
+	RG_Matrix  M     =  g->relations[r];
+	RG_Matrix  TM    =  NULL;
+	RG_Matrix  adj   =  g->adjacency_matrix;
+	RG_Matrix  tadj  =  g->_t_adjacency_matrix;
 
 	bool maintain_transpose;
 	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
-	if(maintain_transpose) {
-		t_relationMat = Graph_GetTransposedRelationMatrix(g, r);
-	}
+	if(maintain_transpose) TM = g->t_relations[r];
 
-	// Rows represent source nodes, columns represent destination nodes.
-	edge_id = SET_MSB(edge_id);
-	GrB_Matrix_setElement_BOOL(adj, true, src, dest);
-	GrB_Matrix_setElement_BOOL(tadj, true, dest, src);
+	// make sure matrices dimensions are sufficient,
+	// new connections are staged within each matrix delta-plus
+	// and are folded once the writer is done
+	_MatrixResize(g, M);
+	_MatrixResize(g, adj);
+	_MatrixResize(g, tadj);
+	if(TM != NULL) _MatrixResize(g, TM);
 
-	// set matrices as dirty
-	_Graph_SetRelationMatrixDirty(g, r);
-	_Graph_SetAdjacencyMatrixDirty(g);
+	// Rows represent source nodes, columns represent destination nodes.
+	info = RG_Matrix_setElement_BOOL(adj, src, dest);
+	ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_setElement_BOOL(tadj, dest, src);
+	ASSERT(info == GrB_SUCCESS);
 
 	// An edge of type r has just been created, update statistics.
 	GraphStatistics_IncEdgeCount(&g->stats, r, 1);
+	GraphStatistics_IncDegree(&g->stats, r, src, dest, 1);
 
-	// Matrix multi-edge is enable for this matrix, use GxB_Matrix_subassign.
-	if(_RG_Matrix_MultiEdgeEnabled(M)) {
-		GrB_Index I = src;
-		GrB_Index J = dest;
-		info = GxB_Matrix_subassign_UINT64   // C(I,J)<Mask> = accum (C(I,J),x)
-			   (
-				   relationMat,          // input/output matrix for results
-				   GrB_NULL,             // optional mask for C(I,J), unused if NULL
-				   _graph_edge_accum,    // optional accum for Z=accum(C(I,J),x)
-				   edge_id,              // scalar to assign to C(I,J)
-				   &I,                   // row indices
-				   1,                    // number of row indices
-				   &J,                   // column indices
-				   1,                    // number of column indices
-				   GrB_NULL              // descriptor for C(I,J) and Mask
-			   );
-		ASSERT(info == GrB_SUCCESS);
+	// Multi-edge is disabled, override entry.
+	if(!RG_Matrix_MultiEdgeEnabled(M)) {
+		_Graph_SetConnection(g, r, src, dest, SET_MSB(edge_id), false);
+		return;
+	}
 
-		// Update the transposed matrix if one is present.
-		if(t_relationMat != NULL) {
-			// Perform the same update to the J,I coordinates of the transposed matrix.
-			info = GxB_Matrix_subassign_UINT64   // C(I,J)<Mask> = accum (C(I,J),x)
-				   (
-					   t_relationMat,       // input/output matrix for results
-					   GrB_NULL,            // optional mask for C(J,I), unused if NULL
-					   _graph_edge_accum,   // optional accum for Z=accum(C(J,I),x)
-					   edge_id,             // scalar to assign to C(J,I)
-					   &J,                  // row indices
-					   1,                   // number of row indices
-					   &I,                  // column indices
-					   1,                   // number of column indices
-					   GrB_NULL             // descriptor for C(J,I) and Mask
-				   );
-			ASSERT(info == GrB_SUCCESS);
-		}
-	} else {
-		// Multi-edge is disabled, use GrB_Matrix_setElement.
-		info = GrB_Matrix_setElement_UINT64(relationMat, edge_id, src, dest);
-		ASSERT(info == GrB_SUCCESS);
+	bool staged;
+	EdgeID current;
+	info = _Graph_GetConnection(g, r, src, dest, &current, &staged);
 
-		// Update the transposed matrix if one is present.
-		if(t_relationMat != NULL) {
-			info = GrB_Matrix_setElement_UINT64(t_relationMat, edge_id, dest, src);
-			ASSERT(info == GrB_SUCCESS);
+	if(info != GrB_SUCCESS) {
+		// first edge connecting src to dest
+		_Graph_SetConnection(g, r, src, dest, SET_MSB(edge_id), true);
+		if(raxSize(g->_staged_connections) >= GRAPH_STAGED_CONNECTIONS_CAP) {
+			_Graph_FlushStagedConnections(g);
 		}
+	} else if(SINGLE_EDGE(current)) {
+		// switching from a single edge ID to a list of edge IDs
+		// the list is shared by both the relation matrix and its transpose
+		uint64_t list_id = MultiEdgeStore_NewList(g->multi_edges[r],
+				SINGLE_EDGE_ID(current), edge_id);
+		_Graph_SetConnection(g, r, src, dest, list_id, staged);
+	} else {
+		// multiple edges, append edge to list, matrices remain intact
+		MultiEdgeStore_Append(g->multi_edges[r], current, edge_id);
 	}
 }
 
+void Graph_CreateEdgeEntity(Graph *g, NodeID src, NodeID dest, int r,
+		Edge *e) {
+	ASSERT(g && r < Graph_RelationTypeCount(g));
+
+	EdgeID id;
+	Entity *en = DataBlock_AllocateItem(g->edges, &id);
+	en->prop_count = 0;
+	en->properties = NULL;
+	e->id = id;
+	e->entity = en;
+	e->relationID = r;
+	e->srcNodeID = src;
+	e->destNodeID = dest;
+}
+
 int Graph_ConnectNodes(Graph *g, NodeID src, NodeID dest, int r, Edge *e) {
 	Node srcNode = GE_NEW_NODE();
 	Node destNode = GE_NEW_NODE();
@@ -733,19 +933,194 @@ int Graph_ConnectNodes(Graph *g, NodeID src, NodeID dest, int r, Edge *e) {
 	ASSERT(res == 1);
 	ASSERT(g && r < Graph_RelationTypeCount(g));
 
-	EdgeID id;
-	Entity *en = DataBlock_AllocateItem(g->edges, &id);
-	en->prop_count = 0;
-	en->properties = NULL;
-	e->id = id;
-	e->entity = en;
-	e->relationID = r;
-	e->srcNodeID = src;
-	e->destNodeID = dest;
-	Graph_FormConnection(g, src, dest, id, r);
+	Graph_CreateEdgeEntity(g, src, dest, r, e);
+	Graph_FormConnection(g, src, dest, ENTITY_GET_ID(e), r);
 	return 1;
 }
 
+// builds a boolean matrix of the graph's dimensions holding entries I[k], J[k]
+static GrB_Matrix _Graph_BuildBoolMatrix
+(
+	const Graph *g,
+	const GrB_Index *I,
+	const GrB_Index *J,
+	uint64_t n
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	bool *X = rm_malloc(sizeof(bool) * n);
+	memset(X, true, sizeof(bool) * n);
+
+	GrB_Matrix A;
+	GrB_Index dim = Graph_RequiredMatrixDim(g);
+	info = GrB_Matrix_new(&A, GrB_BOOL, dim, dim);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_build_BOOL(A, I, J, X, n, GrB_LOR);
+	ASSERT(info == GrB_SUCCESS);
+
+	rm_free(X);
+	return A;
+}
+
+void Graph_LabelNodes(Graph *g, int label, const NodeID *ids, uint64_t n) {
+	ASSERT(g && ids);
+	ASSERT(label >= 0 && label < Graph_LabelTypeCount(g));
+
+	if(n == 0) return;
+
+	GrB_Info info;
+	UNUSED(info);
+
+	RG_Matrix L = g->labels[label];
+	_MatrixResize(g, L);
+
+	GrB_Matrix A = _Graph_BuildBoolMatrix(g, ids, ids, n);
+	info = RG_Matrix_stageMatrix(L, A);
+	ASSERT(info == GrB_SUCCESS);
+	GrB_Matrix_free(&A);
+}
+
+void Graph_ConnectEdges(Graph *g, int r, EdgeTriplet *edges, uint64_t n) {
+	ASSERT(g && edges);
+	ASSERT(r >= 0 && r < Graph_RelationTypeCount(g));
+	ASSERT(RG_Matrix_MultiEdgeEnabled(g->relations[r]));
+
+	if(n == 0) return;
+
+	GrB_Info info;
+	UNUSED(info);
+
+	bool maintain_transpose;
+	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
+
+	RG_Matrix  R     =  g->relations[r];
+	RG_Matrix  TR    =  (maintain_transpose) ? g->t_relations[r] : NULL;
+	RG_Matrix  adj   =  g->adjacency_matrix;
+	RG_Matrix  tadj  =  g->_t_adjacency_matrix;
+	MultiEdgeStore *store = g->multi_edges[r];
+
+	_MatrixResize(g, R);
+	_MatrixResize(g, adj);
+	_MatrixResize(g, tadj);
+	if(TR != NULL) _MatrixResize(g, TR);
+
+	// fold staged connections, such that existing entries
+	// are looked up in the main matrix only
+	_Graph_FlushStagedConnections(g);
+	if(RG_Matrix_IsDirty(R)) RG_Matrix_Sync(R);
+	if(TR != NULL && RG_Matrix_IsDirty(TR)) RG_Matrix_Sync(TR);
+
+	GrB_Index existing;
+	info = GrB_Matrix_nvals(&existing, RG_Matrix_Get_GrB_Matrix(R));
+	ASSERT(info == GrB_SUCCESS);
+
+	// group edges by their endpoints, edges sharing endpoints
+	// are listed by creation order
+#define is_triplet_lt(a, b) ((a)->src < (b)->src ||                         \
+		((a)->src == (b)->src && ((a)->dest < (b)->dest ||                  \
+		((a)->dest == (b)->dest && (a)->id < (b)->id))))
+	QSORT(EdgeTriplet, edges, n, is_triplet_lt);
+
+	// tuples of connections missing from the relation matrix
+	GrB_Index  *I  =  rm_malloc(sizeof(GrB_Index) * n);
+	GrB_Index  *J  =  rm_malloc(sizeof(GrB_Index) * n);
+	uint64_t   *X  =  rm_malloc(sizeof(uint64_t) * n);
+	uint64_t   new_count = 0;
+
+	for(uint64_t i = 0; i < n;) {
+		NodeID src = edges[i].src;
+		NodeID dest = edges[i].dest;
+		ASSERT(src < Graph_RequiredMatrixDim(g));
+		ASSERT(dest < Graph_RequiredMatrixDim(g));
+
+		// edges [i, end) connect src to dest
+		uint64_t end = i + 1;
+		while(end < n && edges[end].src == src && edges[end].dest == dest) end++;
+
+		EdgeID current;
+		bool connected = existing > 0 &&
+			_Graph_GetConnection(g, r, src, dest, &current, NULL) == GrB_SUCCESS;
+
+		if(!connected) {
+			I[new_count] = src;
+			J[new_count] = dest;
+			if(end - i == 1) {
+				X[new_count] = SET_MSB(edges[i].id);
+			} else {
+				uint64_t list_id = MultiEdgeStore_NewList(store, edges[i].id,
+						edges[i + 1].id);
+				for(uint64_t j = i + 2; j < end; j++) {
+					MultiEdgeStore_Append(store, list_id, edges[j].id);
+				}
+				X[new_count] = list_id;
+			}
+			new_count++;
+		} else if(SINGLE_EDGE(current)) {
+			// switching from a single edge ID to a list of edge IDs
+			uint64_t list_id = MultiEdgeStore_NewList(store,
+					SINGLE_EDGE_ID(current), edges[i].id);
+			for(uint64_t j = i + 1; j < end; j++) {
+				MultiEdgeStore_Append(store, list_id, edges[j].id);
+			}
+			// entry is part of the main matrix, updated in place
+			_Graph_SetConnection(g, r, src, dest, list_id, false);
+		} else {
+			// multiple edges, append edges to list, matrices remain intact
+			for(uint64_t j = i; j < end; j++) {
+				MultiEdgeStore_Append(store, current, edges[j].id);
+			}
+		}
+
+		i = end;
+	}
+
+	// introduce new connections in a single pass per matrix
+	if(new_count > 0) {
+		GrB_Matrix A;
+		GrB_Index dim = Graph_RequiredMatrixDim(g);
+
+		info = GrB_Matrix_new(&A, GrB_UINT64, dim, dim);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_build_UINT64(A, I, J, X, new_count, GrB_FIRST_UINT64);
+		ASSERT(info == GrB_SUCCESS);
+		info = RG_Matrix_stageMatrix(R, A);
+		ASSERT(info == GrB_SUCCESS);
+		GrB_Matrix_free(&A);
+
+		if(TR != NULL) {
+			info = GrB_Matrix_new(&A, GrB_UINT64, dim, dim);
+			ASSERT(info == GrB_SUCCESS);
+			info = GrB_Matrix_build_UINT64(A, J, I, X, new_count, GrB_FIRST_UINT64);
+			ASSERT(info == GrB_SUCCESS);
+			info = RG_Matrix_stageMatrix(TR, A);
+			ASSERT(info == GrB_SUCCESS);
+			GrB_Matrix_free(&A);
+		}
+
+		// connections missing from the relation matrix are a superset of
+		// the connections missing from the adjacency matrix
+		A = _Graph_BuildBoolMatrix(g, I, J, new_count);
+		info = RG_Matrix_stageMatrix(adj, A);
+		ASSERT(info == GrB_SUCCESS);
+		GrB_Matrix_free(&A);
+
+		A = _Graph_BuildBoolMatrix(g, J, I, new_count);
+		info = RG_Matrix_stageMatrix(tadj, A);
+		ASSERT(info == GrB_SUCCESS);
+		GrB_Matrix_free(&A);
+	}
+
+	GraphStatistics_IncEdgeCount(&g->stats, r, n);
+	for(uint64_t i = 0; i < n; i++) {
+		GraphStatistics_IncDegree(&g->stats, r, edges[i].src, edges[i].dest, 1);
+	}
+
+	rm_free(I);
+	rm_free(J);
+	rm_free(X);
+}
+
 // retrieves all either incoming or outgoing edges
 // to/from given node N, depending on given direction
 void Graph_GetNodeEdges
@@ -829,43 +1204,31 @@ int Graph_DeleteEdge(Graph *g, Edge *e) {
 	ASSERT(e != NULL);
 
 	uint64_t    x;
-	GrB_Matrix  R;
-	GrB_Matrix  M;
+	bool        staged;
 	GrB_Info    info;
 	EdgeID      edge_id;
-	GrB_Matrix  TR        =  GrB_NULL;
 	int         r         =  Edge_GetRelationID(e);
 	NodeID      src_id    =  Edge_GetSrcNodeID(e);
 	NodeID      dest_id   =  Edge_GetDestNodeID(e);
 
-	R = Graph_GetRelationMatrix(g, r);
-	bool maintain_transpose;
-	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
-	if(maintain_transpose) TR = Graph_GetTransposedRelationMatrix(g, r);
-
 	// test to see if edge exists
-	info = GrB_Matrix_extractElement(&edge_id, R, src_id, dest_id);
+	info = _Graph_GetConnection(g, r, src_id, dest_id, &edge_id, &staged);
 	if(info != GrB_SUCCESS) return 0;
 
 	// an edge of type r has just been deleted, update statistics
 	GraphStatistics_DecEdgeCount(&g->stats, r, 1);
+	GraphStatistics_DecDegree(&g->stats, r, src_id, dest_id, 1);
 
 	if(SINGLE_EDGE(edge_id)) {
 		// single edge of type R connecting src to dest, delete entry
-		info = GxB_Matrix_Delete(R, src_id, dest_id);
-		ASSERT(info == GrB_SUCCESS);
-		if(TR) {
-			info = GxB_Matrix_Delete(TR, dest_id, src_id);
-			ASSERT(info == GrB_SUCCESS);
-		}
+		_Graph_RemoveConnection(g, r, src_id, dest_id);
 
 		// see if source is connected to destination with additional edges
 		bool connected = false;
 		int relationCount = Graph_RelationTypeCount(g);
 		for(int i = 0; i < relationCount; i++) {
 			if(i == r) continue;
-			M = Graph_GetRelationMatrix(g, i);
-			info = GrB_Matrix_extractElement(&x, M, src_id, dest_id);
+			info = _Graph_GetConnection(g, i, src_id, dest_id, &x, NULL);
 			if(info == GrB_SUCCESS) {
 				connected = true;
 				break;
@@ -875,62 +1238,30 @@ int Graph_DeleteEdge(Graph *g, Edge *e) {
 		// there are no additional edges connecting source to destination
 		// remove edge from THE adjacency matrix
 		if(!connected) {
-			M = Graph_GetAdjacencyMatrix(g);
-			info = GxB_Matrix_Delete(M, src_id, dest_id);
+			info = RG_Matrix_removeElement(g->adjacency_matrix, src_id, dest_id);
 			ASSERT(info == GrB_SUCCESS);
 
-			M = Graph_GetTransposedAdjacencyMatrix(g);
-			info = GxB_Matrix_Delete(M, dest_id, src_id);
+			info = RG_Matrix_removeElement(g->_t_adjacency_matrix, dest_id, src_id);
 			ASSERT(info == GrB_SUCCESS);
 		}
 	} else {
 		// multiple edges connecting src to dest
-		// locate specific edge and remove it
-		// revert back from array representation to edge ID
-		// incase we're left with a single edge connecting src to dest
-
-		int i = 0;
-		EdgeID id = ENTITY_GET_ID(e);
-		EdgeID *edges = (EdgeID *)edge_id;
-		int edge_count = array_len(edges);
-
-		// locate edge within edge array
-		for(; i < edge_count; i++) if(edges[i] == id) break;
-		ASSERT(i < edge_count);
-
-		// remove edge from edge array
-		// migrate last edge ID and reduce array size
-		// TODO: reallocate array of size / capacity ratio is high
-		array_del_fast(edges, i);
+		// remove edge from list, the list is shared by the relation matrix
+		// and its transpose
+		MultiEdgeStore *store = g->multi_edges[r];
+		uint32_t remaining = MultiEdgeStore_Remove(store, edge_id,
+				ENTITY_GET_ID(e));
 
 		// incase we're left with a single edge connecting src to dest
-		// revert back from array to scalar
-		if(array_len(edges) == 1) {
-			edge_id = edges[0];
-			array_free(edges);
-			GrB_Matrix_setElement(R, SET_MSB(edge_id), src_id, dest_id);
-		}
-
-		if(TR) {
-			// we must make the matching updates to the transposed matrix
-			// first, extract the element that is known to be an edge array
-			info = GrB_Matrix_extractElement(&edge_id, TR, dest_id, src_id);
-			ASSERT(info == GrB_SUCCESS);
-			edges = (EdgeID *)edge_id;
-			// replace the deleted edge with the last edge in the matrix
-			array_del_fast(edges, i);
-			// free and replace the array if it now has 1 element
-			if(array_len(edges) == 1) {
-				edge_id = edges[0];
-				array_free(edges);
-				GrB_Matrix_setElement(TR, SET_MSB(edge_id), dest_id, src_id);
-			}
+		// revert back from list to scalar
+		if(remaining == 1) {
+			const EdgeID *ids = MultiEdgeStore_GetList(store, edge_id, &remaining);
+			EdgeID id = ids[0];
+			MultiEdgeStore_FreeList(store, edge_id);
+			_Graph_SetConnection(g, r, src_id, dest_id, SET_MSB(id), staged);
 		}
 	}
 
-	_Graph_SetAdjacencyMatrixDirty(g);
-	_Graph_SetRelationMatrixDirty(g, r);
-
 	// free and remove edges from datablock.
 	DataBlock_DeleteItem(g->edges, ENTITY_GET_ID(e));
 	return 1;
@@ -949,60 +1280,63 @@ void Graph_DeleteNode(Graph *g, Node *n) {
 	// Clear label matrix at position node ID.
 	uint32_t label_count = array_len(g->labels);
 	for(int i = 0; i < label_count; i++) {
-		GrB_Matrix M = Graph_GetLabelMatrix(g, i);
-		GxB_Matrix_Delete(M, ENTITY_GET_ID(n), ENTITY_GET_ID(n));
+		RG_Matrix M = g->labels[i];
+		RG_Matrix_removeElement(M, ENTITY_GET_ID(n), ENTITY_GET_ID(n));
 	}
 
+	_Graph_ClearNodeColumns(n);
 	DataBlock_DeleteItem(g->nodes, ENTITY_GET_ID(n));
 }
 
 static void _Graph_FreeRelationMatrices(Graph *g) {
-	// TODO: disable datablock deleted items array
-	// there's no need to keep track after deleted items as the graph
-	// is being removed we won't be reusing items
-
-	if(!_binary_op_delete_edges) {
-		// The binary operator has not yet been constructed; build it now.
-		GrB_Info res;
-		UNUSED(res);
-		res = GrB_BinaryOp_new(&_binary_op_delete_edges, _binary_op_free_edge,
-							   GrB_UINT64, GrB_UINT64, GrB_UINT64);
-		ASSERT(res == GrB_SUCCESS);
-	}
-
-	GxB_Scalar thunk;
-	GxB_Scalar_new(&thunk, GrB_UINT64);
-	GxB_Scalar_setElement_UINT64(thunk, (uint64_t)g);
-
+	// edge entities are freed by Graph_Free, multi-edge lists are owned
+	// by the relation multi-edge store, no need to visit matrix entries
 	bool maintain_transpose;
 	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
 	uint relationCount = Graph_RelationTypeCount(g);
-	/* use the edge deletion binary operation to free all edge arrays within
-	 * the adjacency matrix */
 
 	for(uint i = 0; i < relationCount; i++) {
-		RG_Matrix  M = g->relations[i];
-		GrB_Matrix C = M->grb_matrix;
-
-		GxB_Matrix_apply_BinaryOp1st(C, GrB_NULL, GrB_NULL,
-									 _binary_op_delete_edges, thunk, C, GrB_NULL);
-
-		// free the matrix itself
-		RG_Matrix_Free(M);
-
-		// perform the same update to transposed matrices
-		if(maintain_transpose) {
-			RG_Matrix TM = g->t_relations[i];
-			C = TM->grb_matrix;
-
-			GxB_Matrix_apply_BinaryOp1st(C, GrB_NULL, GrB_NULL,
-										 _binary_op_delete_edges, thunk, C, GrB_NULL);
+		RG_Matrix_Free(g->relations[i]);
+		if(maintain_transpose) RG_Matrix_Free(g->t_relations[i]);
+		MultiEdgeStore_Free(g->multi_edges[i]);
+	}
+}
 
-			// free the matrix itself
-			RG_Matrix_Free(TM);
+// deletes every edge referenced by the entries of A
+// where A is a sub-matrix of relation r, multi-edge lists are released
+// returns the number of deleted edges
+static uint64_t _Graph_DeleteEntriesEdges(Graph *g, int r, GrB_Matrix A) {
+	EdgeID               id;
+	GrB_Index            src;
+	GrB_Index            dest;
+	bool                 depleted  =  false;
+	uint64_t             deleted   =  0;
+	GxB_MatrixTupleIter  *it       =  NULL;
+	MultiEdgeStore       *store    =  g->multi_edges[r];
+
+	GxB_MatrixTupleIter_new(&it, A);
+	while(true) {
+		GxB_MatrixTupleIter_next(it, &src, &dest, &id, &depleted);
+		if(depleted) break;
+
+		if(SINGLE_EDGE(id)) {
+			DataBlock_DeleteItem(g->edges, SINGLE_EDGE_ID(id));
+			GraphStatistics_DecDegree(&g->stats, r, src, dest, 1);
+			deleted++;
+		} else {
+			uint32_t edge_count;
+			const EdgeID *ids = MultiEdgeStore_GetList(store, id, &edge_count);
+			for(uint32_t i = 0; i < edge_count; i++) {
+				DataBlock_DeleteItem(g->edges, ids[i]);
+			}
+			GraphStatistics_DecDegree(&g->stats, r, src, dest, edge_count);
+			deleted += edge_count;
+			MultiEdgeStore_FreeList(store, id);
 		}
 	}
-	GrB_free(&thunk);
+	GxB_MatrixTupleIter_free(it);
+
+	return deleted;
 }
 
 static void _BulkDeleteImplicitEdges(Graph *g, GrB_Matrix Mask) {
@@ -1019,17 +1353,8 @@ static void _BulkDeleteImplicitEdges(Graph *g, GrB_Matrix Mask) {
 	adj = Graph_GetAdjacencyMatrix(g);
 	tadj = Graph_GetTransposedAdjacencyMatrix(g);
 	GrB_Matrix_new(&A, GrB_UINT64, nrows, ncols);
-
-	/* For user-defined select operators,
-	 * If Thunk is not NULL, it must be a valid GxB_Scalar. If it has no entry,
-	 * it is treated as if it had a single entry equal to zero, for built-in types (not
-	 * user-defined types).
-	 * For user-defined select operators, the entry is passed to the user-defined
-	 * select operator, with no typecasting. Its type must be identical to 'ttype' of
-	 * the select operator. */
-	GxB_Scalar thunk;
-	GxB_Scalar_new(&thunk, GrB_UINT64);
-	GxB_Scalar_setElement_UINT64(thunk, (uint64_t)g);
+	// A is iterated over, iterator requires a sparse or hypersparse matrix
+	GxB_Matrix_Option_set(A, GxB_SPARSITY_CONTROL, GxB_HYPERSPARSE);
 
 	// clear updated output matrix before assignment
 	GrB_Descriptor_set(desc, GrB_OUTP, GrB_REPLACE);
@@ -1046,13 +1371,8 @@ static void _BulkDeleteImplicitEdges(Graph *g, GrB_Matrix Mask) {
 		 * A will contain all implicitly deleted edges from R */
 		GrB_Matrix_apply(A, Mask, GrB_NULL, GrB_IDENTITY_UINT64, R, desc);
 
-		uint64_t edges_before_deletion = Graph_EdgeCount(g);
-		// The number of deleted edges is equals the diff in the number of items in the DataBlock
-		uint64_t n_deleted_edges = edges_before_deletion - Graph_EdgeCount(g);
-
-		// free each multi edge array entry in A
-		GxB_Matrix_apply_BinaryOp1st(A, GrB_NULL, GrB_NULL,
-									 _binary_op_delete_edges, thunk, A, GrB_NULL);
+		// delete each edge in A, releasing multi-edge lists
+		uint64_t n_deleted_edges = _Graph_DeleteEntriesEdges(g, i, A);
 
 		// Multiple edges of type r has just been deleted, update statistics
 		GraphStatistics_DecEdgeCount(&g->stats, i, n_deleted_edges);
@@ -1078,36 +1398,22 @@ static void _BulkDeleteImplicitEdges(Graph *g, GrB_Matrix Mask) {
 	// update the transposed adjacency matrix
 	GrB_Matrix_apply(tadj, Mask, GrB_NULL, GrB_IDENTITY_BOOL, tadj, desc);
 
-	/* if we have individual transposed matrices, repeat all the above steps
-	 * with the transposed Mask */
+	/* if we have individual transposed matrices, remove entries marked by
+	 * the transposed Mask, transposed entries share the multi-edge lists
+	 * released above */
 	bool maintain_transpose;
 	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
 	if(maintain_transpose) {
 		for(int i = 0; i < relation_count; i++) {
 			GrB_Matrix TR = Graph_GetTransposedRelationMatrix(g, i);
 
-			// reset mask descriptor
-			GrB_Descriptor_set(desc, GrB_MASK, GxB_DEFAULT);
-
-			/* isolate implicit edges
-			 * A will contain all implicitly deleted edges from TR */
-			GrB_Matrix_apply(A, Mask, GrB_NULL, GrB_IDENTITY_UINT64, TR, desc);
-
-			// free each multi edge array entry in A
-			GxB_Matrix_apply_BinaryOp1st(A, GrB_NULL, GrB_NULL,
-										 _binary_op_delete_edges, thunk, A, GrB_NULL);
-
-			// clear the relation matrix
-			GrB_Descriptor_set(desc, GrB_MASK, GrB_COMP);
-			GrB_Descriptor_set(desc, GrB_MASK, GrB_STRUCTURE);
-
 			// remove every entry of TR marked by Mask
+			// Desc: GrB_MASK = GrB_COMP | GrB_STRUCTURE, GrB_OUTP = GrB_REPLACE
 			GrB_Matrix_apply(TR, Mask, GrB_NULL, GrB_IDENTITY_UINT64, TR, desc);
 		}
 	}
 	// Clean up.
 	GrB_free(&A);
-	GrB_free(&thunk);
 	GrB_Descriptor_free(&desc);
 }
 
@@ -1115,14 +1421,8 @@ static void _BulkDeleteNodes(Graph *g, Node *nodes, uint node_count,
 							 uint *node_deleted, uint *edge_deleted) {
 	ASSERT(g && g->_writelocked && nodes && node_count > 0);
 
-	if(!_binary_op_delete_edges) {
-		// The binary operator has not yet been constructed; build it now.
-		GrB_Info res;
-		UNUSED(res);
-		res = GrB_BinaryOp_new(&_binary_op_delete_edges, _binary_op_free_edge,
-							   GrB_UINT64, GrB_UINT64, GrB_UINT64);
-		ASSERT(res == GrB_SUCCESS);
-	}
+	// relation matrices are modified as a whole, fold staged entries
+	_Graph_FlushStagedConnections(g);
 
 	/* Create a matrix M where M[j,i] = 1 if:
 	 * Node i is connected to node j. */
@@ -1273,6 +1573,7 @@ static void _BulkDeleteNodes(Graph *g, Node *nodes, uint node_count,
 		int label_id = NODE_GET_LABEL_ID(n, g);
 		if(label_id != GRAPH_NO_LABEL) deleted_labels[label_id] = true;
 
+		_Graph_ClearNodeColumns(n);
 		DataBlock_DeleteItem(g->nodes, ENTITY_GET_ID(n));
 	}
 
@@ -1295,6 +1596,9 @@ static void _BulkDeleteNodes(Graph *g, Node *nodes, uint node_count,
 static void _BulkDeleteEdges(Graph *g, Edge *edges, size_t edge_count) {
 	ASSERT(g && g->_writelocked && edges && edge_count > 0);
 
+	// relation matrices are modified as a whole, fold staged entries
+	_Graph_FlushStagedConnections(g);
+
 	int relationCount = Graph_RelationTypeCount(g);
 	GrB_Matrix masks[relationCount];
 	for(int i = 0; i < relationCount; i++) masks[i] = NULL;
@@ -1317,6 +1621,7 @@ static void _BulkDeleteEdges(Graph *g, Edge *edges, size_t edge_count) {
 
 		// An edge of type r has just been deleted, update statistics.
 		GraphStatistics_DecEdgeCount(&g->stats, r, 1);
+		GraphStatistics_DecDegree(&g->stats, r, src_id, dest_id, 1);
 
 		if(SINGLE_EDGE(edge_id)) {
 			update_adj_matrices = true;
@@ -1330,47 +1635,20 @@ static void _BulkDeleteEdges(Graph *g, Edge *edges, size_t edge_count) {
 			GrB_Matrix_setElement_BOOL(mask, true, src_id, dest_id);
 		} else {
 			/* Multiple edges connecting src to dest
-			 * locate specific edge and remove it
-			 * revert back from array representation to edge ID
+			 * remove edge from list, list is shared by R and TR
+			 * revert back from list representation to edge ID
 			 * incase we're left with a single edge connecting src to dest. */
-
-			int i = 0;
-			EdgeID id = ENTITY_GET_ID(e);
-			EdgeID *multi_edges = (EdgeID *)edge_id;
-			int multi_edge_count = array_len(multi_edges);
-
-			// Locate edge within edge array.
-			for(; i < multi_edge_count; i++) if(multi_edges[i] == id) break;
-			ASSERT(i < multi_edge_count);
-
-			/* Remove edge from edge array
-			 * migrate last edge ID and reduce array size.
-			 * TODO: reallocate array of size / capacity ratio is high. */
-			multi_edges[i] = multi_edges[multi_edge_count - 1];
-			array_pop(multi_edges);
-
-			/* Incase we're left with a single edge connecting src to dest
-			 * revert back from array to scalar. */
-			if(array_len(multi_edges) == 1) {
-				edge_id = multi_edges[0];
-				array_free(multi_edges);
-				GrB_Matrix_setElement(R, SET_MSB(edge_id), src_id, dest_id);
-			}
-
-			if(TR) {
-				/* We must make the matching updates to the transposed matrix.
-				 * First, extract the element that is known to be an edge array. */
-				GrB_Matrix_extractElement(&edge_id, TR, dest_id, src_id);
-				multi_edges = (EdgeID *)edge_id;
-				int multi_edge_count = array_len(multi_edges);
-				multi_edges[i] = multi_edges[multi_edge_count - 1];
-				array_pop(multi_edges);
-				// Free and replace the array if it now has 1 element.
-				if(array_len(multi_edges) == 1) {
-					edge_id = multi_edges[0];
-					array_free(multi_edges);
-					GrB_Matrix_setElement(TR, SET_MSB(edge_id), dest_id, src_id);
-				}
+			MultiEdgeStore *store = g->multi_edges[r];
+			uint32_t remaining = MultiEdgeStore_Remove(store, edge_id,
+					ENTITY_GET_ID(e));
+
+			if(remaining == 1) {
+				const EdgeID *ids = MultiEdgeStore_GetList(store, edge_id,
+						&remaining);
+				EdgeID id = ids[0];
+				MultiEdgeStore_FreeList(store, edge_id);
+				GrB_Matrix_setElement(R, SET_MSB(id), src_id, dest_id);
+				if(TR) GrB_Matrix_setElement(TR, SET_MSB(id), dest_id, src_id);
 			}
 		}
 
@@ -1493,6 +1771,11 @@ DataBlockIterator *Graph_ScanNodes(const Graph *g) {
 	return DataBlock_Scan(g->nodes);
 }
 
+DataBlockIterator *Graph_ScanNodesRange(const Graph *g, NodeID start, NodeID end) {
+	ASSERT(g);
+	return DataBlock_ScanRange(g->nodes, start, end);
+}
+
 DataBlockIterator *Graph_ScanEdges(const Graph *g) {
 	ASSERT(g);
 	return DataBlock_Scan(g->edges);
@@ -1502,24 +1785,26 @@ int Graph_AddLabel(Graph *g) {
 	ASSERT(g != NULL);
 
 	GrB_Info info;
-	RG_Matrix m = RG_Matrix_New(g, GrB_BOOL);
+	RG_Matrix m = RG_Matrix_New(GrB_BOOL, Graph_RequiredMatrixDim(g));
 
 	array_append(g->labels, m);
+	if(g->node_columns) array_append(g->node_columns, PropertyColumns_New());
 	return array_len(g->labels) - 1;
 }
 
 int Graph_AddRelationType(Graph *g) {
 	ASSERT(g);
 
-	RG_Matrix m = RG_Matrix_New(g, GrB_UINT64);
+	RG_Matrix m = RG_Matrix_New(GrB_UINT64, Graph_RequiredMatrixDim(g));
 	array_append(g->relations, m);
+	array_append(g->multi_edges, MultiEdgeStore_New());
 	// Adding a new relationship type, update the stats structures to support it.
 	GraphStatistics_IntroduceRelationship(&g->stats);
 	bool maintain_transpose;
 	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
 
 	if(maintain_transpose) {
-		RG_Matrix tm = RG_Matrix_New(g, GrB_UINT64);
+		RG_Matrix tm = RG_Matrix_New(GrB_UINT64, Graph_RequiredMatrixDim(g));
 		array_append(g->t_relations, tm);
 	}
 
@@ -1620,6 +1905,8 @@ void Graph_Free(Graph *g) {
 	_Graph_FreeRelationMatrices(g);
 	array_free(g->relations);
 	array_free(g->t_relations);
+	array_free(g->multi_edges);
+	raxFree(g->_staged_connections);
 	GraphStatistics_FreeInternals(&g->stats);
 
 	uint32_t labelCount = array_len(g->labels);
@@ -1628,6 +1915,13 @@ void Graph_Free(Graph *g) {
 	}
 	array_free(g->labels);
 
+	if(g->node_columns) {
+		for(int i = 0; i < labelCount; i++) {
+			PropertyColumns_Free(g->node_columns[i]);
+		}
+		array_free(g->node_columns);
+	}
+
 	it = Graph_ScanNodes(g);
 	while((en = (Entity *)DataBlockIterator_Next(it, NULL)) != NULL)
 		FreeEntity(en);
@@ -13,6 +13,9 @@
 #include "entities/edge.h"
 #include "../redismodule.h"
 #include "graph_statistics.h"
+#include "multi_edge_store.h"
+#include "rg_matrix/rg_matrix.h"
+#include "entities/property_columns.h"
 #include "../util/datablock/datablock.h"
 #include "../util/datablock/datablock_iterator.h"
 #include "../../deps/GraphBLAS/Include/GraphBLAS.h"
@@ -30,13 +33,13 @@
 // Mask with most significat bit on 10000...
 #define MSB_MASK (1UL << (sizeof(EntityID) * 8 - 1))
 // Mask complement 01111...
-#define MSB_MASK_CMP ~MSB_MASK
+#define MSB_MASK_CMP (~MSB_MASK)
 // Set X's most significat bit on.
-#define SET_MSB(x) (x) | MSB_MASK
+#define SET_MSB(x) ((x) | MSB_MASK)
 // Clear X's most significat bit on.
-#define CLEAR_MSB(x) (x) & MSB_MASK_CMP
+#define CLEAR_MSB(x) ((x) & MSB_MASK_CMP)
 // Checks if X represents edge ID.
-#define SINGLE_EDGE(x) (x) & MSB_MASK
+#define SINGLE_EDGE(x) ((x) & MSB_MASK)
 // Returns edge ID.
 #define SINGLE_EDGE_ID(x) CLEAR_MSB(x)
 
@@ -52,14 +55,12 @@ typedef enum {
 	DISABLED,
 } MATRIX_POLICY;
 
-// Forward declaration of RG_Matrix type. Internal to graph.
+// Connection formed by an edge, see Graph_ConnectEdges.
 typedef struct {
-	bool dirty;                         // Indicates if matrix requires sync
-	bool allow_multi_edge;              // Entry i,j can contain multiple edges
-	GrB_Matrix grb_matrix;              // Underlying GrB_Matrix.
-	pthread_mutex_t mutex;              // Lock.
-} _RG_Matrix;
-typedef _RG_Matrix *RG_Matrix;
+	NodeID src;     // Source node ID.
+	NodeID dest;    // Destination node ID.
+	EdgeID id;      // Edge ID.
+} EdgeTriplet;
 
 // Forward declaration of Graph struct
 typedef struct Graph Graph;
@@ -74,10 +75,14 @@ struct Graph {
 	RG_Matrix *labels;                  // Label matrices.
 	RG_Matrix *relations;               // Relation matrices.
 	RG_Matrix *t_relations;             // Transposed relation matrices.
+	MultiEdgeStore **multi_edges;       // Per relation multi-edge lists.
+	rax *_staged_connections;           // Relation entries staged by the current writer.
+	PropertyColumns **node_columns;     // Per label node property columns, NULL if disabled.
 	RG_Matrix _zero_matrix;             // Zero matrix.
 	pthread_rwlock_t _rwlock;           // Read-write lock scoped to this specific graph
 	pthread_mutex_t _writers_mutex;     // Mutex restrict single writer.
 	bool _writelocked;                  // true if the read-write lock was acquired by a writer
+	uint64_t _epoch;                    // Number of times the write lock was acquired.
 	SyncMatrixFunc SynchronizeMatrix;   // Function pointer to matrix synchronization routine.
 	GraphStatistics stats;              // Graph related statistics.
 };
@@ -94,6 +99,10 @@ void Graph_AcquireWriteLock(Graph *g);
 /* Release the held lock */
 void Graph_ReleaseLock(Graph *g);
 
+/* Returns the graph's epoch, which advances each time the write lock is acquired.
+ * Data read under the same epoch was not modified in between. */
+uint64_t Graph_GetEpoch(const Graph *g);
+
 /* Writer request access to graph. */
 void Graph_WriterEnter(Graph *g);
 
@@ -142,6 +151,41 @@ void Graph_CreateNode(
 	Node *n
 );
 
+// Create a single node without introducing it to its label matrix,
+// see Graph_LabelNodes.
+void Graph_CreateNodeEntity(
+	Graph *g,
+	int label,
+	Node *n
+);
+
+// Introduce nodes to a label matrix in a single pass.
+void Graph_LabelNodes(
+	Graph *g,
+	int label,          // Label matrix to update.
+	const NodeID *ids,  // Nodes to label.
+	uint64_t n          // Number of nodes.
+);
+
+// Create a single edge without forming its connection,
+// see Graph_ConnectEdges.
+void Graph_CreateEdgeEntity(
+	Graph *g,
+	NodeID src,         // Source node ID.
+	NodeID dest,        // Destination node ID.
+	int r,              // Edge type.
+	Edge *e
+);
+
+// Form the connections of edges of type r in a single pass,
+// edges are sorted in place.
+void Graph_ConnectEdges(
+	Graph *g,
+	int r,              // Edge type.
+	EdgeTriplet *edges, // Edges to connect.
+	uint64_t n          // Number of edges.
+);
+
 // Connects source node to destination node.
 // Returns 1 if connection is formed, 0 otherwise.
 int Graph_ConnectNodes(
@@ -192,6 +236,14 @@ DataBlockIterator *Graph_ScanNodes(
 	const Graph *g
 );
 
+// Retrieves a node iterator which can be used to access
+// every node with an ID in the range [start, end).
+DataBlockIterator *Graph_ScanNodesRange(
+	const Graph *g,
+	NodeID start,
+	NodeID end
+);
+
 // Retrieves an edge iterator which can be used to access
 // every edge in the graph.
 DataBlockIterator *Graph_ScanEdges(
@@ -230,6 +282,28 @@ uint64_t Graph_RelationEdgeCount(
 	int relation_idx
 );
 
+// Returns the average number of edges of a specific relation type
+// connected to a node in the given direction, over nodes having any.
+double Graph_RelationAvgDegree(
+	const Graph *g,
+	int relation_idx,
+	GRAPH_EDGE_DIR dir
+);
+
+// Returns the maximum number of edges of a specific relation type
+// connected to a single node in the given direction.
+uint32_t Graph_RelationMaxDegree(
+	const Graph *g,
+	int relation_idx,
+	GRAPH_EDGE_DIR dir
+);
+
+// Recount relation degree statistics out of the relation matrices,
+// required once matrices are populated directly, e.g. by a decoder.
+void Graph_RecountDegrees(
+	Graph *g
+);
+
 // Returns number of deleted edges in the graph.
 uint Graph_DeletedEdgeCount(
 	const Graph *g
@@ -286,6 +360,14 @@ void Graph_GetEdgesConnectingNodes(
 	Edge **edges        // array_t of edges connecting src to dest of type r.
 );
 
+// Retrieves the edge IDs of a multi-edge relation matrix entry.
+const EdgeID *Graph_GetMultiEdgeList(
+	const Graph *g,     // Graph to get edges from.
+	int r,              // Edge type.
+	uint64_t list_id,   // Relation matrix entry, MSB off.
+	uint32_t *len       // [output] number of edge IDs.
+);
+
 // Get node edges.
 void Graph_GetNodeEdges(
 	const Graph *g,         // Graph to get edges from.
@@ -295,6 +377,16 @@ void Graph_GetNodeEdges(
 	Edge **edges            // array_t incoming/outgoing edges.
 );
 
+// Returns number of edges connected to node in the given direction,
+// edges of both directions are summed up for GRAPH_EDGE_DIR_BOTH,
+// GRAPH_NO_RELATION counts edges of any relationship type.
+uint64_t Graph_GetNodeDegree(
+	const Graph *g,         // Graph to get degree from.
+	NodeID id,              // Node ID.
+	GRAPH_EDGE_DIR dir,     // Edge direction.
+	int edgeType            // Relation type.
+);
+
 // Retrieves the adjacency matrix.
 // Matrix is resized if its size doesn't match graph's node count.
 GrB_Matrix Graph_GetAdjacencyMatrix(
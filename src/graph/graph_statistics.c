@@ -5,16 +5,60 @@
 */
 
 #include "graph_statistics.h"
+#include "../util/rmalloc.h"
+#include <string.h>
+
+// Minimal number of entries allocated for a degree vector
+#define DEGREE_VECTOR_MIN_CAP 1024
+
+static void _DegreeVector_Inc(DegreeVector *v, NodeID id, uint32_t amount) {
+    if(id >= v->cap) {
+        // Grow geometrically, new entries have no edges
+        uint64_t cap = (v->cap == 0) ? DEGREE_VECTOR_MIN_CAP : v->cap;
+        while(cap <= id) cap *= 2;
+        v->degree = rm_realloc(v->degree, cap * sizeof(uint32_t));
+        memset(v->degree + v->cap, 0, (cap - v->cap) * sizeof(uint32_t));
+        v->cap = cap;
+    }
+
+    if(v->degree[id] == 0) v->nodes++;
+    v->degree[id] += amount;
+    if(v->degree[id] > v->max) v->max = v->degree[id];
+}
+
+static void _DegreeVector_Dec(DegreeVector *v, NodeID id, uint32_t amount) {
+    ASSERT(id < v->cap && v->degree[id] >= amount);
+    v->degree[id] -= amount;
+    if(v->degree[id] == 0) v->nodes--;
+}
+
+static inline uint32_t _DegreeVector_Get(const DegreeVector *v, NodeID id) {
+    return (id < v->cap) ? v->degree[id] : 0;
+}
+
+static void _DegreeVector_Reset(DegreeVector *v) {
+    if(v->degree) rm_free(v->degree);
+    *v = (DegreeVector) {0};
+}
+
+static double _DegreeVector_Avg(const DegreeVector *v, uint64_t edge_count) {
+    if(v->nodes == 0) return 0;
+    return (double)edge_count / v->nodes;
+}
 
 // Initialize the edge_count array
 void GraphStatistics_init(GraphStatistics *stats) {
     ASSERT(stats);
     stats->edge_count = array_new(uint64_t, 0);
+    stats->out_degree = array_new(DegreeVector, 0);
+    stats->in_degree = array_new(DegreeVector, 0);
 }
 
 void GraphStatistics_IntroduceRelationship(GraphStatistics *stats) {
     ASSERT(stats && stats->edge_count);
     array_append(stats->edge_count, 0);
+    array_append(stats->out_degree, (DegreeVector) {0});
+    array_append(stats->in_degree, (DegreeVector) {0});
 }
 
 uint64_t GraphStatistics_EdgeCount(const GraphStatistics *stats, int relation_idx) {
@@ -22,7 +66,68 @@ uint64_t GraphStatistics_EdgeCount(const GraphStatistics *stats, int relation_id
     return stats->edge_count[relation_idx];
 }
 
+void GraphStatistics_IncDegree(GraphStatistics *stats, int relation_idx, NodeID src,
+        NodeID dest, uint32_t amount) {
+    ASSERT(relation_idx < array_len(stats->out_degree));
+    _DegreeVector_Inc(stats->out_degree + relation_idx, src, amount);
+    _DegreeVector_Inc(stats->in_degree + relation_idx, dest, amount);
+}
+
+void GraphStatistics_DecDegree(GraphStatistics *stats, int relation_idx, NodeID src,
+        NodeID dest, uint32_t amount) {
+    ASSERT(relation_idx < array_len(stats->out_degree));
+    _DegreeVector_Dec(stats->out_degree + relation_idx, src, amount);
+    _DegreeVector_Dec(stats->in_degree + relation_idx, dest, amount);
+}
+
+void GraphStatistics_ResetDegrees(GraphStatistics *stats, int relation_idx) {
+    ASSERT(relation_idx < array_len(stats->out_degree));
+    _DegreeVector_Reset(stats->out_degree + relation_idx);
+    _DegreeVector_Reset(stats->in_degree + relation_idx);
+}
+
+double GraphStatistics_AvgOutDegree(const GraphStatistics *stats, int relation_idx) {
+    ASSERT(relation_idx < array_len(stats->out_degree));
+    return _DegreeVector_Avg(stats->out_degree + relation_idx,
+            stats->edge_count[relation_idx]);
+}
+
+double GraphStatistics_AvgInDegree(const GraphStatistics *stats, int relation_idx) {
+    ASSERT(relation_idx < array_len(stats->in_degree));
+    return _DegreeVector_Avg(stats->in_degree + relation_idx,
+            stats->edge_count[relation_idx]);
+}
+
+uint32_t GraphStatistics_MaxOutDegree(const GraphStatistics *stats, int relation_idx) {
+    ASSERT(relation_idx < array_len(stats->out_degree));
+    return stats->out_degree[relation_idx].max;
+}
+
+uint32_t GraphStatistics_MaxInDegree(const GraphStatistics *stats, int relation_idx) {
+    ASSERT(relation_idx < array_len(stats->in_degree));
+    return stats->in_degree[relation_idx].max;
+}
+
+uint32_t GraphStatistics_OutDegree(const GraphStatistics *stats, int relation_idx, NodeID id) {
+    ASSERT(relation_idx < array_len(stats->out_degree));
+    return _DegreeVector_Get(stats->out_degree + relation_idx, id);
+}
+
+uint32_t GraphStatistics_InDegree(const GraphStatistics *stats, int relation_idx, NodeID id) {
+    ASSERT(relation_idx < array_len(stats->in_degree));
+    return _DegreeVector_Get(stats->in_degree + relation_idx, id);
+}
+
 void GraphStatistics_FreeInternals(GraphStatistics *stats) {
     ASSERT(stats);
     if(stats->edge_count) array_free(stats->edge_count);
+    if(stats->out_degree) {
+        uint count = array_len(stats->out_degree);
+        for(uint i = 0; i < count; i++) {
+            _DegreeVector_Reset(stats->out_degree + i);
+            _DegreeVector_Reset(stats->in_degree + i);
+        }
+        array_free(stats->out_degree);
+        array_free(stats->in_degree);
+    }
 }
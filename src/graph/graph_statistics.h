@@ -8,11 +8,23 @@
 
 #include <stdint.h>
 #include "../util/arr.h"
+#include "entities/graph_entity.h"
 
 // Graph related statistics
 
+// Number of edges of a single relationship type each node is connected by
+// in a single direction, indexed by node ID
 typedef struct {
-	uint64_t *edge_count; // Array of edge count per relationship matrix
+	uint32_t *degree;   // Per node degree, nodes beyond 'cap' have no edges
+	uint64_t cap;       // Number of allocated entries
+	uint64_t nodes;     // Number of nodes with a non-zero degree
+	uint32_t max;       // Maximum degree, an upper bound once edges are removed
+} DegreeVector;
+
+typedef struct {
+	uint64_t *edge_count;       // Array of edge count per relationship matrix
+	DegreeVector *out_degree;   // Array of out-degree vectors per relationship matrix
+	DegreeVector *in_degree;    // Array of in-degree vectors per relationship matrix
 } GraphStatistics;
 
 // Initialize the edge_count array
@@ -36,5 +48,34 @@ static inline void GraphStatistics_DecEdgeCount(GraphStatistics *stats, int rela
 // Retrieves edge count for given relationship type
 uint64_t GraphStatistics_EdgeCount(const GraphStatistics *stats, int relation_idx);
 
+// 'amount' edges of given relationship type now connect src to dest
+void GraphStatistics_IncDegree(GraphStatistics *stats, int relation_idx, NodeID src,
+        NodeID dest, uint32_t amount);
+
+// 'amount' edges of given relationship type connecting src to dest were removed
+void GraphStatistics_DecDegree(GraphStatistics *stats, int relation_idx, NodeID src,
+        NodeID dest, uint32_t amount);
+
+// Clear degree vectors of given relationship type, used prior to recounting
+void GraphStatistics_ResetDegrees(GraphStatistics *stats, int relation_idx);
+
+// Average number of outgoing edges of given type, over nodes having any
+double GraphStatistics_AvgOutDegree(const GraphStatistics *stats, int relation_idx);
+
+// Average number of incoming edges of given type, over nodes having any
+double GraphStatistics_AvgInDegree(const GraphStatistics *stats, int relation_idx);
+
+// Maximum number of outgoing edges of given type connected to a single node
+uint32_t GraphStatistics_MaxOutDegree(const GraphStatistics *stats, int relation_idx);
+
+// Maximum number of incoming edges of given type connected to a single node
+uint32_t GraphStatistics_MaxInDegree(const GraphStatistics *stats, int relation_idx);
+
+// Number of outgoing edges of given type connected to node
+uint32_t GraphStatistics_OutDegree(const GraphStatistics *stats, int relation_idx, NodeID id);
+
+// Number of incoming edges of given type connected to node
+uint32_t GraphStatistics_InDegree(const GraphStatistics *stats, int relation_idx, NodeID id);
+
 // Free the internal structures.
 void GraphStatistics_FreeInternals(GraphStatistics *stats);
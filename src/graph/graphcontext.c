@@ -57,7 +57,9 @@ GraphContext *GraphContext_New(const char *graph_name, size_t node_cap, size_t e
 	GraphContext *gc = rm_malloc(sizeof(GraphContext));
 
 	gc->version          = 0;  // initial graph version
-	gc->slowlog          = SlowLog_New();
+	gc->slowlog          = NULL;
+	gc->plan_stats       = PlanStats_New();
+	gc->latency_stats    = LatencyStats_New();
 	gc->ref_count        = 0;  // no refences
 	gc->attributes       = raxNew();
 	gc->index_count      = 0;  // no indicies
@@ -76,6 +78,11 @@ GraphContext *GraphContext_New(const char *graph_name, size_t node_cap, size_t e
 	// initialize the read-write lock to protect access to the attributes rax
 	assert(pthread_rwlock_init(&gc->_attribute_rwlock, NULL) == 0);
 
+	// build the slowlog
+	uint64_t slowlog_max_len;
+	Config_Option_get(Config_SLOWLOG_MAX_LEN, &slowlog_max_len);
+	gc->slowlog = SlowLog_New(slowlog_max_len);
+
 	// build the execution plans cache
 	uint64_t cache_size;
 	Config_Option_get(Config_CACHE_SIZE, &cache_size);
@@ -154,6 +161,11 @@ void GraphContext_Release(GraphContext *gc) {
 	_GraphContext_DecreaseRefCount(gc);
 }
 
+void GraphContext_Retain(GraphContext *gc) {
+	ASSERT(gc);
+	_GraphContext_IncreaseRefCount(gc);
+}
+
 void GraphContext_MarkWriter(RedisModuleCtx *ctx, GraphContext *gc) {
 	RedisModuleString *graphID = RedisModule_CreateString(ctx, gc->graph_name, strlen(gc->graph_name));
 
@@ -256,11 +268,11 @@ Schema *GraphContext_AddSchema(GraphContext *gc, const char *label, SchemaType t
 
 	if(t == SCHEMA_NODE) {
 		label_id = Graph_AddLabel(gc->g);
-		schema = Schema_New(label, label_id);
+		schema = Schema_New(label, label_id, SCHEMA_NODE);
 		array_append(gc->node_schemas, schema);
 	} else {
 		label_id = Graph_AddRelationType(gc->g);
-		schema = Schema_New(label, label_id);
+		schema = Schema_New(label, label_id, SCHEMA_EDGE);
 		array_append(gc->relation_schemas, schema);
 	}
 
@@ -356,41 +368,46 @@ bool GraphContext_HasIndices(GraphContext *gc) {
 	for(uint i = 0; i < schema_count; i++) {
 		if(Schema_HasIndices(gc->node_schemas[i])) return true;
 	}
+
+	schema_count = array_len(gc->relation_schemas);
+	for(uint i = 0; i < schema_count; i++) {
+		if(Schema_HasIndices(gc->relation_schemas[i])) return true;
+	}
 	return false;
 }
 Index *GraphContext_GetIndexByID(const GraphContext *gc, int id,
-		Attribute_ID *attribute_id, IndexType type) {
+		Attribute_ID *attribute_id, IndexType type, SchemaType t) {
 
 	ASSERT(gc     !=  NULL);
 
 	// Retrieve the schema for given id
-	Schema *s= GraphContext_GetSchemaByID(gc, id, SCHEMA_NODE);
+	Schema *s= GraphContext_GetSchemaByID(gc, id, t);
 	if(s == NULL) return NULL;
 
 	return Schema_GetIndex(s, attribute_id, type);
 }
 
 Index *GraphContext_GetIndex(const GraphContext *gc, const char *label,
-							 Attribute_ID *attribute_id, IndexType type) {
+							 Attribute_ID *attribute_id, IndexType type, SchemaType t) {
 
 	ASSERT(gc != NULL);
 	ASSERT(label != NULL);
 
 	// Retrieve the schema for this label
-	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	Schema *s = GraphContext_GetSchema(gc, label, t);
 	if(s == NULL) return NULL;
 
 	return Schema_GetIndex(s, attribute_id, type);
 }
 
 int GraphContext_AddIndex(Index **idx, GraphContext *gc, const char *label,
-						  const char *field, IndexType type) {
+						  const char *field, IndexType type, SchemaType t) {
 
 	ASSERT(idx && gc && label && field);
 
 	// Retrieve the schema for this label
-	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
-	if(s == NULL) s = GraphContext_AddSchema(gc, label, SCHEMA_NODE);
+	Schema *s = GraphContext_GetSchema(gc, label, t);
+	if(s == NULL) s = GraphContext_AddSchema(gc, label, t);
 
 	int res = Schema_AddIndex(idx, s, field, type);
 	ResultSet *result_set = QueryCtx_GetResultSet();
@@ -400,13 +417,13 @@ int GraphContext_AddIndex(Index **idx, GraphContext *gc, const char *label,
 }
 
 int GraphContext_DeleteIndex(GraphContext *gc, const char *label,
-							 const char *field, IndexType type) {
+							 const char *field, IndexType type, SchemaType t) {
 	ASSERT(gc != NULL);
 	ASSERT(label != NULL);
 
 	// Retrieve the schema for this label
 	int res = INDEX_FAIL;
-	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	Schema *s = GraphContext_GetSchema(gc, label, t);
 
 	if(s != NULL) {
 		res = Schema_RemoveIndex(s, field, type);
@@ -420,6 +437,44 @@ int GraphContext_DeleteIndex(GraphContext *gc, const char *label,
 	return res;
 }
 
+int GraphContext_AddCompositeIndex(CompositeIndex **idx, GraphContext *gc, const char *label,
+		const char **fields, uint fields_count, const char **included, uint included_count) {
+
+	ASSERT(idx && gc && label && fields);
+
+	// Retrieve the schema for this label
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	if(s == NULL) s = GraphContext_AddSchema(gc, label, SCHEMA_NODE);
+
+	int res = Schema_AddCompositeIndex(idx, s, fields, fields_count, included,
+			included_count);
+	ResultSet *result_set = QueryCtx_GetResultSet();
+	ResultSet_IndexCreated(result_set, res);
+
+	return res;
+}
+
+int GraphContext_DeleteCompositeIndex(GraphContext *gc, const char *label, const char **fields,
+		uint fields_count) {
+	ASSERT(gc != NULL);
+	ASSERT(label != NULL);
+
+	// Retrieve the schema for this label
+	int res = INDEX_FAIL;
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+
+	if(s != NULL) {
+		res = Schema_RemoveCompositeIndex(s, fields, fields_count);
+		if(res != INDEX_FAIL) {
+			// update resultset statistics
+			ResultSet *result_set = QueryCtx_GetResultSet();
+			ResultSet_IndexDeleted(result_set, res);
+		}
+	}
+
+	return res;
+}
+
 // Delete all references to a node from any indices built upon its properties
 void GraphContext_DeleteNodeFromIndices(GraphContext *gc, Node *n) {
 	Schema *s = NULL;
@@ -441,6 +496,21 @@ void GraphContext_DeleteNodeFromIndices(GraphContext *gc, Node *n) {
 	if(idx) Index_RemoveNode(idx, n);
 	idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
 	if(idx) Index_RemoveNode(idx, n);
+
+	uint composite_count = array_len(s->composite_indices);
+	for(uint i = 0; i < composite_count; i++) {
+		CompositeIndex_RemoveNode(s->composite_indices[i], n);
+	}
+}
+
+// Delete all references to an edge from any indices built upon its properties
+void GraphContext_DeleteEdgeFromIndices(GraphContext *gc, Edge *e) {
+	int relation_id = Edge_GetRelationID(e);
+	if(relation_id < 0) relation_id = Graph_GetEdgeRelation(gc->g, e);
+	Schema *s = GraphContext_GetSchemaByID(gc, relation_id, SCHEMA_EDGE);
+	if(s == NULL) return;
+
+	Schema_RemoveEdgeFromIndices(s, e);
 }
 
 //------------------------------------------------------------------------------
@@ -490,6 +560,18 @@ SlowLog *GraphContext_GetSlowLog(const GraphContext *gc) {
 	return gc->slowlog;
 }
 
+// Return operation statistics of sampled query executions.
+PlanStats *GraphContext_GetPlanStats(const GraphContext *gc) {
+	ASSERT(gc);
+	return gc->plan_stats;
+}
+
+// Return latency statistics of queries issued against graph.
+LatencyStats *GraphContext_GetLatencyStats(const GraphContext *gc) {
+	ASSERT(gc);
+	return gc->latency_stats;
+}
+
 //------------------------------------------------------------------------------
 // Cache API
 //------------------------------------------------------------------------------
@@ -555,6 +637,8 @@ static void _GraphContext_Free(void *arg) {
 	ASSERT(res == 0);
 
 	if(gc->slowlog) SlowLog_Free(gc->slowlog);
+	if(gc->plan_stats) PlanStats_Free(gc->plan_stats);
+	if(gc->latency_stats) LatencyStats_Free(gc->latency_stats);
 
 	//--------------------------------------------------------------------------
 	// Clear cache
@@ -11,6 +11,8 @@
 #include "../index/index.h"
 #include "../schema/schema.h"
 #include "../slow_log/slow_log.h"
+#include "../plan_stats/plan_stats.h"
+#include "../latency_stats/latency_stats.h"
 #include "graph.h"
 #include "../serializers/encode_context.h"
 #include "../serializers/decode_context.h"
@@ -37,6 +39,8 @@ typedef struct {
 	Schema **relation_schemas;              // Array of schemas for each relation type
 	unsigned short index_count;             // Number of indicies.
 	SlowLog *slowlog;                       // Slowlog associated with graph.
+	PlanStats *plan_stats;                  // Statistics of sampled executions.
+	LatencyStats *latency_stats;            // Query latency per processing stage.
 	GraphEncodeContext *encoding_context;   // Encode context of the graph.
 	GraphDecodeContext *decoding_context;   // Decode context of the graph.
 	Cache *cache;                           // Global cache of execution plans.
@@ -55,6 +59,9 @@ GraphContext *GraphContext_Retrieve(RedisModuleCtx *ctx, RedisModuleString *grap
 									bool shouldCreate);
 // GraphContext_Retrieve counterpart, releases a retrieved GraphContext.
 void GraphContext_Release(GraphContext *gc);
+// Retain an already retrieved GraphContext, e.g. for background work.
+// Must be matched by a call to GraphContext_Release.
+void GraphContext_Retain(GraphContext *gc);
 // Mark graph key as "dirty" for Redis to pick up on.
 void GraphContext_MarkWriter(RedisModuleCtx *ctx, GraphContext *gc);
 
@@ -101,25 +108,36 @@ Attribute_ID GraphContext_GetAttributeID(GraphContext *gc, const char *str);
 
 bool GraphContext_HasIndices(GraphContext *gc);
 
-// Attempt to retrieve an index on the given label and attribute IDs
+// Attempt to retrieve an index on the given label or relationship type and attribute IDs
 Index *GraphContext_GetIndexByID(const GraphContext *gc, int id,
-		Attribute_ID *attribute_id, IndexType type);
+		Attribute_ID *attribute_id, IndexType type, SchemaType t);
 
-// Attempt to retrieve an index on the given label and attribute
+// Attempt to retrieve an index on the given label or relationship type and attribute
 Index *GraphContext_GetIndex(const GraphContext *gc, const char *label, Attribute_ID *attribute_id,
-							 IndexType type);
+							 IndexType type, SchemaType t);
 
-// Create an index for the given label and attribute
+// Create an index for the given label or relationship type and attribute
 int GraphContext_AddIndex(Index **idx, GraphContext *gc, const char *label, const char *field,
-						  IndexType type);
+						  IndexType type, SchemaType t);
 
 // Remove and free an index
 int GraphContext_DeleteIndex(GraphContext *gc, const char *label, const char *field,
-							 IndexType type);
+							 IndexType type, SchemaType t);
+
+// Create a composite index for the given label over key fields, storing included fields
+int GraphContext_AddCompositeIndex(CompositeIndex **idx, GraphContext *gc, const char *label,
+		const char **fields, uint fields_count, const char **included, uint included_count);
+
+// Remove and free a composite index, identified by its key fields
+int GraphContext_DeleteCompositeIndex(GraphContext *gc, const char *label, const char **fields,
+		uint fields_count);
 
 // Remove a single node from all indices that refer to it
 void GraphContext_DeleteNodeFromIndices(GraphContext *gc, Node *n);
 
+// Remove a single edge from all indices that refer to it
+void GraphContext_DeleteEdgeFromIndices(GraphContext *gc, Edge *e);
+
 // Add GraphContext to global array
 void GraphContext_RegisterWithModule(GraphContext *gc);
 
@@ -135,6 +153,12 @@ void GraphContext_RemoveFromRegistry(GraphContext *gc);
 
 SlowLog *GraphContext_GetSlowLog(const GraphContext *gc);
 
+// Return operation statistics of sampled query executions.
+PlanStats *GraphContext_GetPlanStats(const GraphContext *gc);
+
+// Return latency statistics of queries issued against graph.
+LatencyStats *GraphContext_GetLatencyStats(const GraphContext *gc);
+
 /* Cache API - Return cache associated with graph context and current thread id. */
 Cache *GraphContext_GetCache(const GraphContext *gc);
 
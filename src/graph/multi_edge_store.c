@@ -0,0 +1,186 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "multi_edge_store.h"
+#include "RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include <string.h>
+
+// initial number of positions allocated for the packed buffer
+#define MULTI_EDGE_STORE_INITIAL_CAP 64
+// buffers smaller than this are never compacted
+#define MULTI_EDGE_STORE_COMPACT_MIN 4096
+
+// make sure buffer can accommodate an additional 'n' positions
+static void _MultiEdgeStore_Reserve(MultiEdgeStore *store, uint64_t n) {
+	if(store->size + n <= store->cap) return;
+
+	uint64_t cap = store->cap;
+	while(cap < store->size + n) cap *= 2;
+	store->ids = rm_realloc(store->ids, sizeof(EdgeID) * cap);
+	store->cap = cap;
+}
+
+// repack all lists back to back, discarding holes
+// list IDs are unaffected
+static void _MultiEdgeStore_Compact(MultiEdgeStore *store) {
+	uint64_t live = store->size - store->holes;
+	uint64_t cap = MULTI_EDGE_STORE_INITIAL_CAP;
+	while(cap < live) cap *= 2;
+
+	EdgeID *ids = rm_malloc(sizeof(EdgeID) * cap);
+	uint64_t offset = 0;
+	uint64_t list_count = array_len(store->lists);
+
+	for(uint64_t i = 0; i < list_count; i++) {
+		MultiEdgeList *l = store->lists + i;
+		if(l->cap == 0) continue; // freed list
+
+		memcpy(ids + offset, store->ids + l->offset, sizeof(EdgeID) * l->len);
+		l->offset = offset;
+		l->cap = l->len;
+		offset += l->len;
+	}
+
+	rm_free(store->ids);
+	store->ids = ids;
+	store->cap = cap;
+	store->size = offset;
+	store->holes = 0;
+}
+
+static inline void _MultiEdgeStore_CompactIfSparse(MultiEdgeStore *store) {
+	if(store->size < MULTI_EDGE_STORE_COMPACT_MIN) return;
+	if(store->holes * 2 < store->size) return;
+	_MultiEdgeStore_Compact(store);
+}
+
+MultiEdgeStore *MultiEdgeStore_New(void) {
+	MultiEdgeStore *store = rm_malloc(sizeof(MultiEdgeStore));
+
+	store->ids         =  rm_malloc(sizeof(EdgeID) * MULTI_EDGE_STORE_INITIAL_CAP);
+	store->cap         =  MULTI_EDGE_STORE_INITIAL_CAP;
+	store->size        =  0;
+	store->holes       =  0;
+	store->lists       =  array_new(MultiEdgeList, 0);
+	store->free_lists  =  array_new(uint64_t, 0);
+
+	return store;
+}
+
+uint64_t MultiEdgeStore_NewList(MultiEdgeStore *store, EdgeID a, EdgeID b) {
+	ASSERT(store != NULL);
+
+	_MultiEdgeStore_Reserve(store, 2);
+
+	MultiEdgeList l = {.offset = store->size, .len = 2, .cap = 2};
+	store->ids[store->size++] = a;
+	store->ids[store->size++] = b;
+
+	// reuse a freed list ID if one is available
+	uint64_t list_id;
+	if(array_len(store->free_lists) > 0) {
+		list_id = array_pop(store->free_lists);
+		store->lists[list_id] = l;
+	} else {
+		list_id = array_len(store->lists);
+		array_append(store->lists, l);
+	}
+
+	return list_id;
+}
+
+void MultiEdgeStore_Append(MultiEdgeStore *store, uint64_t list_id, EdgeID id) {
+	ASSERT(store != NULL);
+	ASSERT(list_id < array_len(store->lists));
+
+	MultiEdgeList *l = store->lists + list_id;
+	ASSERT(l->cap > 0);
+
+	if(l->len == l->cap) {
+		// list is full, double its capacity
+		uint32_t cap = l->cap * 2;
+		if(l->offset + l->cap == store->size) {
+			// list is the last segment, extend it in place
+			_MultiEdgeStore_Reserve(store, cap - l->cap);
+			store->size += cap - l->cap;
+		} else {
+			// relocate list to the end of the buffer
+			_MultiEdgeStore_Reserve(store, cap);
+			memcpy(store->ids + store->size, store->ids + l->offset,
+					sizeof(EdgeID) * l->len);
+			store->holes += l->cap;
+			l->offset = store->size;
+			store->size += cap;
+		}
+		l->cap = cap;
+	}
+
+	store->ids[l->offset + l->len++] = id;
+
+	_MultiEdgeStore_CompactIfSparse(store);
+}
+
+uint32_t MultiEdgeStore_Remove(MultiEdgeStore *store, uint64_t list_id,
+		EdgeID id) {
+	ASSERT(store != NULL);
+	ASSERT(list_id < array_len(store->lists));
+
+	MultiEdgeList *l = store->lists + list_id;
+	EdgeID *ids = store->ids + l->offset;
+
+	uint32_t i = 0;
+	for(; i < l->len; i++) if(ids[i] == id) break;
+	ASSERT(i < l->len);
+
+	// migrate last edge ID into the removed position
+	ids[i] = ids[--l->len];
+
+	return l->len;
+}
+
+const EdgeID *MultiEdgeStore_GetList(const MultiEdgeStore *store,
+		uint64_t list_id, uint32_t *len) {
+	ASSERT(len != NULL);
+	ASSERT(store != NULL);
+	ASSERT(list_id < array_len(store->lists));
+
+	const MultiEdgeList *l = store->lists + list_id;
+	*len = l->len;
+	return store->ids + l->offset;
+}
+
+void MultiEdgeStore_FreeList(MultiEdgeStore *store, uint64_t list_id) {
+	ASSERT(store != NULL);
+	ASSERT(list_id < array_len(store->lists));
+
+	MultiEdgeList *l = store->lists + list_id;
+	ASSERT(l->cap > 0);
+
+	if(l->offset + l->cap == store->size) {
+		// list is the last segment, shrink buffer
+		store->size -= l->cap;
+	} else {
+		store->holes += l->cap;
+	}
+
+	l->len = 0;
+	l->cap = 0;
+	array_append(store->free_lists, list_id);
+
+	_MultiEdgeStore_CompactIfSparse(store);
+}
+
+void MultiEdgeStore_Free(MultiEdgeStore *store) {
+	ASSERT(store != NULL);
+
+	rm_free(store->ids);
+	array_free(store->lists);
+	array_free(store->free_lists);
+	rm_free(store);
+}
+
@@ -0,0 +1,89 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "entities/graph_entity.h"
+
+// MultiEdgeStore holds the edge IDs of every (src, dest) pair connected by
+// more than a single edge of a specific relationship type
+//
+// edge IDs are packed into one contiguous buffer, each list occupies a
+// segment of that buffer described by its offset, length and capacity
+// a relation matrix entry representing multiple edges holds the ID of the
+// list within the store (MSB off), lists IDs are stable for the lifetime
+// of the list, such that both a relation matrix and its transpose can
+// refer to the same list
+//
+// the buffer is append only, a list which outgrows its segment is relocated
+// to the end of the buffer leaving a hole behind, once holes account for
+// most of the buffer the store is compacted
+
+typedef struct {
+	uint64_t offset;          // position of the list's first edge ID
+	uint32_t len;             // number of edge IDs in list
+	uint32_t cap;             // number of positions reserved for list
+} MultiEdgeList;
+
+typedef struct {
+	EdgeID *ids;              // packed edge IDs
+	uint64_t size;            // number of positions in use, including holes
+	uint64_t cap;             // number of allocated positions
+	uint64_t holes;           // number of positions not owned by any list
+	MultiEdgeList *lists;     // list ID to list segment
+	uint64_t *free_lists;     // IDs of freed lists, available for reuse
+} MultiEdgeStore;
+
+// create a new empty store
+MultiEdgeStore *MultiEdgeStore_New(void);
+
+// create a new list holding edges 'a' and 'b', returns list ID
+uint64_t MultiEdgeStore_NewList
+(
+	MultiEdgeStore *store,
+	EdgeID a,
+	EdgeID b
+);
+
+// append edge 'id' to list
+void MultiEdgeStore_Append
+(
+	MultiEdgeStore *store,
+	uint64_t list_id,
+	EdgeID id
+);
+
+// remove edge 'id' from list, the last edge in the list takes its place
+// returns the number of edges remaining in the list
+uint32_t MultiEdgeStore_Remove
+(
+	MultiEdgeStore *store,
+	uint64_t list_id,
+	EdgeID id
+);
+
+// returns a pointer to the list's edge IDs and sets 'len' to their count
+// pointer is valid until the store is modified
+const EdgeID *MultiEdgeStore_GetList
+(
+	const MultiEdgeStore *store,
+	uint64_t list_id,
+	uint32_t *len
+);
+
+// release list, its ID might be reused
+void MultiEdgeStore_FreeList
+(
+	MultiEdgeStore *store,
+	uint64_t list_id
+);
+
+void MultiEdgeStore_Free
+(
+	MultiEdgeStore *store
+);
+
@@ -0,0 +1,316 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "rg_matrix.h"
+#include "../../RG.h"
+#include "../../util/rmalloc.h"
+
+// creates a delta matrix
+// deltas are expected to be small, hence stored as hypersparse
+static GrB_Matrix _RG_Matrix_NewDelta(GrB_Type type, GrB_Index n) {
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Matrix D;
+	info = GrB_Matrix_new(&D, type, n, n);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_set(D, GxB_SPARSITY_CONTROL, GxB_HYPERSPARSE);
+	ASSERT(info == GrB_SUCCESS);
+
+	return D;
+}
+
+// returns true if the main matrix holds an entry at position i,j
+// entry might be marked for deletion by delta-minus
+static inline bool _RG_Matrix_MainContains(const RG_Matrix C, GrB_Index i,
+		GrB_Index j) {
+	bool x;
+	return (GrB_Matrix_extractElement_BOOL(&x, C->grb_matrix, i, j) ==
+			GrB_SUCCESS);
+}
+
+// returns true if entry i,j is marked for deletion
+static inline bool _RG_Matrix_DeltaMinusContains(const RG_Matrix C,
+		GrB_Index i, GrB_Index j) {
+	// delta-minus is only populated while the matrix is dirty
+	if(!C->dirty) return false;
+
+	bool x;
+	return (GrB_Matrix_extractElement_BOOL(&x, C->delta_minus, i, j) ==
+			GrB_SUCCESS);
+}
+
+// entry i,j exists in the main matrix and is marked for deletion
+// unmark it, the caller is about to override the entry's value
+static inline void _RG_Matrix_Revive(RG_Matrix C, GrB_Index i, GrB_Index j) {
+	GrB_Info info = GrB_Matrix_removeElement(C->delta_minus, i, j);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+}
+
+RG_Matrix RG_Matrix_New(GrB_Type data_type, GrB_Index n) {
+	GrB_Info info;
+	UNUSED(info);
+
+	RG_Matrix matrix = rm_calloc(1, sizeof(_RG_Matrix));
+	matrix->dirty             =  true;
+	matrix->allow_multi_edge  =  true;
+
+	info = GrB_Matrix_new(&matrix->grb_matrix, data_type, n, n);
+	ASSERT(info == GrB_SUCCESS);
+
+	// matrix iterator requires matrix format to be sparse
+	// to avoid future conversion from HYPER-SPARSE, BITMAP, FULL to SPARSE
+	// we set matrix format at creation time
+	info = GxB_set(matrix->grb_matrix, GxB_SPARSITY_CONTROL, GxB_SPARSE);
+	ASSERT(info == GrB_SUCCESS);
+
+	matrix->delta_plus   =  _RG_Matrix_NewDelta(data_type, n);
+	matrix->delta_minus  =  _RG_Matrix_NewDelta(GrB_BOOL, n);
+
+	int mutex_res = pthread_mutex_init(&matrix->mutex, NULL);
+	ASSERT(mutex_res == 0);
+
+	return matrix;
+}
+
+inline GrB_Matrix RG_Matrix_Get_GrB_Matrix(RG_Matrix C) {
+	ASSERT(C);
+	return C->grb_matrix;
+}
+
+inline bool RG_Matrix_IsDirty(const RG_Matrix C) {
+	ASSERT(C);
+	return C->dirty;
+}
+
+inline void RG_Matrix_SetDirty(RG_Matrix C) {
+	ASSERT(C);
+	C->dirty = true;
+}
+
+inline void RG_Matrix_Lock(RG_Matrix C) {
+	pthread_mutex_lock(&C->mutex);
+}
+
+inline void RG_Matrix_Unlock(RG_Matrix C) {
+	pthread_mutex_unlock(&C->mutex);
+}
+
+inline bool RG_Matrix_MultiEdgeEnabled(const RG_Matrix C) {
+	return C->allow_multi_edge;
+}
+
+GrB_Info RG_Matrix_Resize(RG_Matrix C, GrB_Index n) {
+	ASSERT(C);
+
+	GrB_Info info = GxB_Matrix_resize(C->grb_matrix, n, n);
+	if(info != GrB_SUCCESS) return info;
+
+	info = GxB_Matrix_resize(C->delta_plus, n, n);
+	if(info != GrB_SUCCESS) return info;
+
+	return GxB_Matrix_resize(C->delta_minus, n, n);
+}
+
+GrB_Info RG_Matrix_setElement_BOOL(RG_Matrix C, GrB_Index i, GrB_Index j) {
+	ASSERT(C);
+
+	if(_RG_Matrix_MainContains(C, i, j)) {
+		// entry already exists, revive it in case it was marked for deletion
+		if(_RG_Matrix_DeltaMinusContains(C, i, j)) _RG_Matrix_Revive(C, i, j);
+		return GrB_SUCCESS;
+	}
+
+	// stage new entry in delta-plus
+	C->dirty = true;
+	return GrB_Matrix_setElement_BOOL(C->delta_plus, true, i, j);
+}
+
+GrB_Info RG_Matrix_setElement_UINT64(RG_Matrix C, uint64_t x, GrB_Index i,
+		GrB_Index j) {
+	ASSERT(C);
+
+	if(_RG_Matrix_MainContains(C, i, j)) {
+		if(_RG_Matrix_DeltaMinusContains(C, i, j)) _RG_Matrix_Revive(C, i, j);
+		// entry exists, value is updated in place without introducing
+		// pending work to the main matrix
+		return GrB_Matrix_setElement_UINT64(C->grb_matrix, x, i, j);
+	}
+
+	// stage new entry in delta-plus
+	C->dirty = true;
+	return GrB_Matrix_setElement_UINT64(C->delta_plus, x, i, j);
+}
+
+GrB_Info RG_Matrix_accumElement_UINT64(RG_Matrix C, GrB_BinaryOp accum,
+		uint64_t x, GrB_Index i, GrB_Index j) {
+	ASSERT(C);
+	ASSERT(accum);
+
+	GrB_Matrix M = C->delta_plus;
+
+	if(_RG_Matrix_MainContains(C, i, j)) {
+		if(_RG_Matrix_DeltaMinusContains(C, i, j)) {
+			// entry was removed, override its value
+			_RG_Matrix_Revive(C, i, j);
+			return GrB_Matrix_setElement_UINT64(C->grb_matrix, x, i, j);
+		}
+		// accumulate into existing entry, updated in place
+		M = C->grb_matrix;
+	} else {
+		C->dirty = true;
+	}
+
+	// M(i,j) = accum(M(i,j), x)
+	// in delta-plus multiple additions to the same entry are kept as
+	// pending tuples and reduced using 'accum' once delta-plus is flushed
+	return GxB_Matrix_subassign_UINT64(M, GrB_NULL, accum, x, &i, 1, &j, 1,
+			GrB_NULL);
+}
+
+GrB_Info RG_Matrix_stageMatrix(RG_Matrix C, const GrB_Matrix A) {
+	ASSERT(C);
+	ASSERT(A);
+
+	GrB_Info   info;
+	GrB_Type   t;
+	GrB_Index  nvals;
+	UNUSED(info);
+
+	// an entry of A might be marked for deletion, fold deletions first
+	// such that the entry is staged rather than left deleted
+	info = GrB_Matrix_nvals(&nvals, C->delta_minus);
+	ASSERT(info == GrB_SUCCESS);
+	if(nvals > 0) RG_Matrix_Sync(C);
+
+	GxB_Matrix_type(&t, C->grb_matrix);
+	GrB_BinaryOp op = (t == GrB_BOOL) ? GrB_LOR : GrB_FIRST_UINT64;
+
+	// DP<!M> = DP + A, keeps delta-plus disjoint from the main matrix
+	info = GrB_Matrix_eWiseAdd_BinaryOp(C->delta_plus, C->grb_matrix, GrB_NULL,
+			op, C->delta_plus, A, GrB_DESC_SC);
+	if(info != GrB_SUCCESS) return info;
+
+	C->dirty = true;
+	return GrB_SUCCESS;
+}
+
+GrB_Info RG_Matrix_extractElement_BOOL(bool *x, const RG_Matrix C, GrB_Index i,
+		GrB_Index j) {
+	ASSERT(C);
+	ASSERT(x);
+
+	GrB_Info info = GrB_Matrix_extractElement_BOOL(x, C->grb_matrix, i, j);
+	if(info == GrB_SUCCESS) {
+		return (_RG_Matrix_DeltaMinusContains(C, i, j)) ? GrB_NO_VALUE : info;
+	}
+
+	if(!C->dirty) return info;
+	return GrB_Matrix_extractElement_BOOL(x, C->delta_plus, i, j);
+}
+
+GrB_Info RG_Matrix_extractElement_UINT64(uint64_t *x, const RG_Matrix C,
+		GrB_Index i, GrB_Index j) {
+	ASSERT(C);
+	ASSERT(x);
+
+	GrB_Info info = GrB_Matrix_extractElement_UINT64(x, C->grb_matrix, i, j);
+	if(info == GrB_SUCCESS) {
+		return (_RG_Matrix_DeltaMinusContains(C, i, j)) ? GrB_NO_VALUE : info;
+	}
+
+	if(!C->dirty) return info;
+	return GrB_Matrix_extractElement_UINT64(x, C->delta_plus, i, j);
+}
+
+GrB_Info RG_Matrix_extractMainElement_UINT64(uint64_t *x, const RG_Matrix C,
+		GrB_Index i, GrB_Index j) {
+	ASSERT(C);
+	ASSERT(x);
+
+	GrB_Info info = GrB_Matrix_extractElement_UINT64(x, C->grb_matrix, i, j);
+	if(info != GrB_SUCCESS) return info;
+
+	return (_RG_Matrix_DeltaMinusContains(C, i, j)) ? GrB_NO_VALUE : info;
+}
+
+GrB_Info RG_Matrix_removeElement(RG_Matrix C, GrB_Index i, GrB_Index j) {
+	ASSERT(C);
+
+	if(_RG_Matrix_MainContains(C, i, j)) {
+		if(_RG_Matrix_DeltaMinusContains(C, i, j)) return GrB_NO_VALUE;
+		// mark entry for deletion
+		C->dirty = true;
+		return GrB_Matrix_setElement_BOOL(C->delta_minus, true, i, j);
+	}
+
+	if(!C->dirty) return GrB_NO_VALUE;
+
+	// entry might be staged in delta-plus
+	bool x;
+	GrB_Info info = GrB_Matrix_extractElement_BOOL(&x, C->delta_plus, i, j);
+	if(info != GrB_SUCCESS) return info;
+
+	return GrB_Matrix_removeElement(C->delta_plus, i, j);
+}
+
+void RG_Matrix_Sync(RG_Matrix C) {
+	ASSERT(C);
+
+	GrB_Info    info;
+	GrB_Type    t;
+	GrB_Index   nvals;
+	GrB_Matrix  M   =  C->grb_matrix;
+	GrB_Matrix  DP  =  C->delta_plus;
+	GrB_Matrix  DM  =  C->delta_minus;
+	UNUSED(info);
+
+	GxB_Matrix_type(&t, M);
+	bool boolean = (t == GrB_BOOL);
+
+	// remove entries marked for deletion, M<!DM> = M
+	info = GrB_Matrix_nvals(&nvals, DM);
+	ASSERT(info == GrB_SUCCESS);
+	if(nvals > 0) {
+		GrB_UnaryOp identity = (boolean) ? GrB_IDENTITY_BOOL : GrB_IDENTITY_UINT64;
+		info = GrB_Matrix_apply(M, DM, GrB_NULL, identity, M, GrB_DESC_RSC);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_clear(DM);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	// introduce additions, M = M + DP
+	// computing nvals assembles delta-plus pending tuples
+	info = GrB_Matrix_nvals(&nvals, DP);
+	ASSERT(info == GrB_SUCCESS);
+	if(nvals > 0) {
+		// delta-plus and M are disjoint, operator is never applied
+		GrB_BinaryOp op = (boolean) ? GrB_LOR : GrB_FIRST_UINT64;
+		info = GrB_Matrix_eWiseAdd_BinaryOp(M, GrB_NULL, GrB_NULL, op, M, DP,
+				GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_clear(DP);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	// flush any remaining pending work
+	info = GrB_wait(&M);
+	ASSERT(info == GrB_SUCCESS);
+
+	C->dirty = false;
+}
+
+void RG_Matrix_Free(RG_Matrix C) {
+	ASSERT(C);
+
+	GrB_Matrix_free(&C->grb_matrix);
+	GrB_Matrix_free(&C->delta_plus);
+	GrB_Matrix_free(&C->delta_minus);
+	pthread_mutex_destroy(&C->mutex);
+	rm_free(C);
+}
+
@@ -0,0 +1,177 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include "../../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// RG_Matrix is a GrB_Matrix accompanied by two delta matrices:
+//
+// delta_plus  - entries added to the matrix which are not yet part of it
+// delta_minus - entries of the matrix which had been removed
+//
+// writers never modify the structure of the main matrix directly,
+// new entries are staged in delta-plus and removed entries are marked in
+// delta-minus, entries which already exist within the main matrix are
+// updated in place
+//
+// the logical content of the matrix is: (M - DM) + DP
+// point lookups (RG_Matrix_extractElement_*) combine all three on the fly
+// RG_Matrix_Sync folds both deltas into the main matrix, leaving it free of
+// any pending GraphBLAS work such that readers can use it as is
+
+typedef struct {
+	bool dirty;                         // Indicates if matrix requires sync
+	bool allow_multi_edge;              // Entry i,j can contain multiple edges
+	GrB_Matrix grb_matrix;              // Underlying GrB_Matrix.
+	GrB_Matrix delta_plus;              // Pending additions.
+	GrB_Matrix delta_minus;             // Pending deletions.
+	pthread_mutex_t mutex;              // Lock.
+} _RG_Matrix;
+typedef _RG_Matrix *RG_Matrix;
+
+// creates a new NxN matrix of the given type
+RG_Matrix RG_Matrix_New
+(
+	GrB_Type data_type,     // matrix element type
+	GrB_Index n             // number of rows and columns
+);
+
+// returns the main GraphBLAS matrix
+// the returned matrix does not reflect pending deltas
+// see RG_Matrix_Sync
+GrB_Matrix RG_Matrix_Get_GrB_Matrix
+(
+	RG_Matrix C
+);
+
+// returns true if the matrix holds changes which have yet to be
+// folded into its main matrix
+bool RG_Matrix_IsDirty
+(
+	const RG_Matrix C
+);
+
+// marks the matrix as dirty
+void RG_Matrix_SetDirty
+(
+	RG_Matrix C
+);
+
+// locks the matrix
+void RG_Matrix_Lock
+(
+	RG_Matrix C
+);
+
+// unlocks the matrix
+void RG_Matrix_Unlock
+(
+	RG_Matrix C
+);
+
+bool RG_Matrix_MultiEdgeEnabled
+(
+	const RG_Matrix C
+);
+
+// resize matrix and its deltas to NxN
+GrB_Info RG_Matrix_Resize
+(
+	RG_Matrix C,
+	GrB_Index n
+);
+
+// sets C(i,j) = true
+GrB_Info RG_Matrix_setElement_BOOL
+(
+	RG_Matrix C,
+	GrB_Index i,
+	GrB_Index j
+);
+
+// sets C(i,j) = x, overriding any previous value
+GrB_Info RG_Matrix_setElement_UINT64
+(
+	RG_Matrix C,
+	uint64_t x,
+	GrB_Index i,
+	GrB_Index j
+);
+
+// C(i,j) = accum(C(i,j), x)
+// in case C(i,j) is missing, C(i,j) = x
+GrB_Info RG_Matrix_accumElement_UINT64
+(
+	RG_Matrix C,
+	GrB_BinaryOp accum,
+	uint64_t x,
+	GrB_Index i,
+	GrB_Index j
+);
+
+// stages every entry of A which is missing from C's main matrix in
+// delta-plus, entries already present in C's main matrix are left as is
+// C is synced beforehand in case it holds pending deletions
+GrB_Info RG_Matrix_stageMatrix
+(
+	RG_Matrix C,
+	const GrB_Matrix A
+);
+
+// x = C(i,j), taking both deltas into account
+GrB_Info RG_Matrix_extractElement_BOOL
+(
+	bool *x,
+	const RG_Matrix C,
+	GrB_Index i,
+	GrB_Index j
+);
+
+// x = C(i,j), taking both deltas into account
+GrB_Info RG_Matrix_extractElement_UINT64
+(
+	uint64_t *x,
+	const RG_Matrix C,
+	GrB_Index i,
+	GrB_Index j
+);
+
+// x = C(i,j), ignoring entries staged in delta-plus
+// unlike RG_Matrix_extractElement_UINT64 this never forces delta-plus
+// to assemble its pending additions, callers are expected to keep track
+// of the entries they've staged
+GrB_Info RG_Matrix_extractMainElement_UINT64
+(
+	uint64_t *x,
+	const RG_Matrix C,
+	GrB_Index i,
+	GrB_Index j
+);
+
+// removes entry C(i,j)
+// returns GrB_NO_VALUE if C(i,j) does not exist
+GrB_Info RG_Matrix_removeElement
+(
+	RG_Matrix C,
+	GrB_Index i,
+	GrB_Index j
+);
+
+// fold both deltas into the main matrix and flush any pending work
+// once done the matrix is no longer dirty
+void RG_Matrix_Sync
+(
+	RG_Matrix C
+);
+
+void RG_Matrix_Free
+(
+	RG_Matrix C
+);
+
@@ -0,0 +1,112 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "aggregate_state.h"
+#include "RG.h"
+#include <strings.h>
+#include "../arithmetic/aggregate_funcs/agg_funcs.h"
+
+AggregateStateType AggregateState_TypeOf(const AR_ExpNode *exp) {
+	if(exp->type != AR_EXP_OP || exp->op.f->aggregate != true) return AGG_STATE_NONE;
+	if(exp->op.child_count != 1) return AGG_STATE_NONE;
+	if(Aggregate_PerformsDistinct(exp->op.f->privdata)) return AGG_STATE_NONE;
+
+	const char *name = exp->op.func_name;
+	if(strcasecmp(name, "count") == 0) return AGG_STATE_COUNT;
+	if(strcasecmp(name, "sum") == 0) return AGG_STATE_SUM;
+	if(strcasecmp(name, "avg") == 0) return AGG_STATE_AVG;
+	if(strcasecmp(name, "min") == 0) return AGG_STATE_MIN;
+	if(strcasecmp(name, "max") == 0) return AGG_STATE_MAX;
+	return AGG_STATE_NONE;
+}
+
+void AggregateState_Init(AggregateState *state) {
+	state->sum = 0;
+	state->count = 0;
+	state->value = SI_NullVal();
+}
+
+// replace current extremum with v if v is lesser (min) or greater (max)
+static void _UpdateExtremum(AggregateState *state, AggregateStateType type, SIValue v) {
+	int compared_null;
+	int res = SIValue_Compare(state->value, v, &compared_null);
+	bool replace = (compared_null == COMPARED_NULL) ||
+				   (type == AGG_STATE_MIN && res > 0) ||
+				   (type == AGG_STATE_MAX && res < 0);
+	if(!replace) return;
+
+	SIValue_Free(state->value);
+	state->value = SI_CloneValue(v);
+}
+
+void AggregateState_Update(AggregateState *state, AggregateStateType type, SIValue v) {
+	if(SI_TYPE(v) == T_NULL) return;
+
+	switch(type) {
+		case AGG_STATE_COUNT:
+			state->count++;
+			break;
+		case AGG_STATE_SUM:
+			state->sum += SI_GET_NUMERIC(v);
+			break;
+		case AGG_STATE_AVG:
+			state->count++;
+			state->sum += SI_GET_NUMERIC(v);
+			break;
+		case AGG_STATE_MIN:
+		case AGG_STATE_MAX:
+			_UpdateExtremum(state, type, v);
+			break;
+		default:
+			ASSERT(false);
+			break;
+	}
+}
+
+void AggregateState_Merge(AggregateState *dest, AggregateState *src, AggregateStateType type) {
+	switch(type) {
+		case AGG_STATE_COUNT:
+		case AGG_STATE_SUM:
+		case AGG_STATE_AVG:
+			dest->count += src->count;
+			dest->sum += src->sum;
+			break;
+		case AGG_STATE_MIN:
+		case AGG_STATE_MAX:
+			if(SI_TYPE(src->value) == T_NULL) break;
+			_UpdateExtremum(dest, type, src->value);
+			break;
+		default:
+			ASSERT(false);
+			break;
+	}
+
+	AggregateState_Free(src);
+	AggregateState_Init(src);
+}
+
+SIValue AggregateState_Finalize(AggregateState *state, AggregateStateType type) {
+	switch(type) {
+		case AGG_STATE_COUNT:
+			return SI_LongVal(state->count);
+		case AGG_STATE_SUM:
+			return SI_DoubleVal(state->sum);
+		case AGG_STATE_AVG:
+			if(state->count == 0) return SI_DoubleVal(0);
+			return SI_DoubleVal(state->sum / state->count);
+		case AGG_STATE_MIN:
+		case AGG_STATE_MAX:
+			return SI_TransferOwnership(&state->value);
+		default:
+			ASSERT(false);
+			return SI_NullVal();
+	}
+}
+
+void AggregateState_Free(AggregateState *state) {
+	SIValue_Free(state->value);
+}
+
@@ -0,0 +1,69 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../value.h"
+#include "../arithmetic/arithmetic_expression.h"
+
+/* Non-distinct count, sum, avg, min and max aggregations are maintained
+ * as a flat per-group state rather than by a cloned expression tree,
+ * flat states of the same aggregation can be merged. */
+typedef enum {
+	AGG_STATE_NONE = 0,     // Aggregation is evaluated by its expression tree.
+	AGG_STATE_COUNT,
+	AGG_STATE_SUM,
+	AGG_STATE_AVG,
+	AGG_STATE_MIN,
+	AGG_STATE_MAX,
+} AggregateStateType;
+
+typedef struct {
+	SIValue value;          // Minimum or maximum encountered so far.
+	double sum;             // Sum of aggregated values.
+	int64_t count;          // Number of aggregated values.
+} AggregateState;
+
+// Determine the kind of flat state able to maintain the aggregation,
+// AGG_STATE_NONE if expression can't be maintained as a flat state.
+AggregateStateType AggregateState_TypeOf
+(
+	const AR_ExpNode *exp
+);
+
+void AggregateState_Init
+(
+	AggregateState *state
+);
+
+// aggregate v, v is cloned if retained by the state
+void AggregateState_Update
+(
+	AggregateState *state,
+	AggregateStateType type,
+	SIValue v
+);
+
+// combine src into dest, src is left empty
+void AggregateState_Merge
+(
+	AggregateState *dest,
+	AggregateState *src,
+	AggregateStateType type
+);
+
+// compute the aggregation's final value, ownership is passed to the caller
+SIValue AggregateState_Finalize
+(
+	AggregateState *state,
+	AggregateStateType type
+);
+
+void AggregateState_Free
+(
+	AggregateState *state
+);
+
@@ -19,6 +19,11 @@ Group *NewGroup(SIValue *keys, uint key_count, AR_ExpNode **funcs, uint func_cou
 	g->aggregationFunctions = funcs;
 	g->key_count = key_count;
 	g->func_count = func_count;
+	g->states = NULL;
+	if(func_count > 0) {
+		g->states = rm_malloc(sizeof(AggregateState) * func_count);
+		for(uint i = 0; i < func_count; i++) AggregateState_Init(g->states + i);
+	}
 	g->r = (r) ? OpBase_CloneRecord(r) : NULL;
 	return g;
 }
@@ -31,8 +36,18 @@ void FreeGroup(Group *g) {
 		rm_free(g->keys);
 	}
 
-	for(uint i = 0; i < g->func_count; i++) AR_EXP_Free(g->aggregationFunctions[i]);
-	rm_free(g->aggregationFunctions);
+	if(g->aggregationFunctions) {
+		for(uint i = 0; i < g->func_count; i++) {
+			if(g->aggregationFunctions[i]) AR_EXP_Free(g->aggregationFunctions[i]);
+		}
+		rm_free(g->aggregationFunctions);
+	}
+
+	if(g->states) {
+		for(uint i = 0; i < g->func_count; i++) AggregateState_Free(g->states + i);
+		rm_free(g->states);
+	}
+
 	rm_free(g);
 }
 
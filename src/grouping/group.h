@@ -7,11 +7,13 @@
 #pragma once
 
 #include "../value.h"
+#include "aggregate_state.h"
 #include "../arithmetic/arithmetic_expression.h"
 
 typedef struct {
 	SIValue *keys;                       // SIValues that form the key associated with each group
-	AR_ExpNode **aggregationFunctions;   // Nodes containing aggregate functions to be evaluated
+	AR_ExpNode **aggregationFunctions;   // Nodes containing aggregate functions to be evaluated, NULL for flat aggregations
+	AggregateState *states;              // Flat aggregation states
 	uint key_count;                      // Number of SIValues in the key
 	uint func_count;                     // Number of aggregation function values
 	Record r;                            // Representative record for all aggregated records in group
@@ -0,0 +1,169 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "group_table.h"
+#include "RG.h"
+#include "../util/rmalloc.h"
+
+#define PARTITION_OF(hash) ((hash) >> (64 - GROUP_TABLE_PARTITION_BITS))
+
+static bool _KeysEqual(const SIValue *a, const SIValue *b, uint n) {
+	for(uint i = 0; i < n; i++) {
+		if(SIValue_Compare(a[i], b[i], NULL) != 0) return false;
+	}
+	return true;
+}
+
+static void _Partition_Init(GroupTablePartition *p, uint64_t cap) {
+	p->count = 0;
+	p->mask = cap - 1;
+	p->hashes = rm_malloc(sizeof(XXH64_hash_t) * cap);
+	p->groups = rm_calloc(cap, sizeof(Group *));
+}
+
+static void _Partition_Release(GroupTablePartition *p) {
+	rm_free(p->hashes);
+	rm_free(p->groups);
+	p->hashes = NULL;
+	p->groups = NULL;
+	p->count = 0;
+	p->mask = 0;
+}
+
+// place group in the first unoccupied slot of its probe sequence
+static void _Partition_Insert(GroupTablePartition *p, XXH64_hash_t hash, Group *group) {
+	uint64_t slot = hash & p->mask;
+	while(p->groups[slot] != NULL) slot = (slot + 1) & p->mask;
+	p->hashes[slot] = hash;
+	p->groups[slot] = group;
+	p->count++;
+}
+
+// double partition capacity once it is three quarters full
+static void _Partition_Accommodate(GroupTablePartition *p) {
+	if(p->groups == NULL) {
+		_Partition_Init(p, GROUP_TABLE_PARTITION_CAP);
+		return;
+	}
+
+	uint64_t cap = p->mask + 1;
+	if((p->count + 1) * 4 <= cap * 3) return;
+
+	GroupTablePartition grown;
+	_Partition_Init(&grown, cap * 2);
+	for(uint64_t i = 0; i < cap; i++) {
+		if(p->groups[i]) _Partition_Insert(&grown, p->hashes[i], p->groups[i]);
+	}
+	_Partition_Release(p);
+	*p = grown;
+}
+
+static Group *_Partition_Get(const GroupTablePartition *p, XXH64_hash_t hash,
+							 const SIValue *keys) {
+	if(p->groups == NULL) return NULL;
+
+	uint64_t slot = hash & p->mask;
+	Group *group;
+	while((group = p->groups[slot]) != NULL) {
+		if(p->hashes[slot] == hash && _KeysEqual(group->keys, keys, group->key_count)) {
+			return group;
+		}
+		slot = (slot + 1) & p->mask;
+	}
+	return NULL;
+}
+
+GroupTable *GroupTable_New(void) {
+	GroupTable *table = rm_malloc(sizeof(GroupTable));
+	for(uint i = 0; i < GROUP_TABLE_PARTITION_COUNT; i++) {
+		GroupTablePartition *p = table->partitions + i;
+		p->hashes = NULL;
+		p->groups = NULL;
+		p->count = 0;
+		p->mask = 0;
+	}
+	return table;
+}
+
+Group *GroupTable_Get(const GroupTable *table, XXH64_hash_t hash, const SIValue *keys) {
+	return _Partition_Get(table->partitions + PARTITION_OF(hash), hash, keys);
+}
+
+void GroupTable_Add(GroupTable *table, XXH64_hash_t hash, Group *group) {
+	GroupTablePartition *p = table->partitions + PARTITION_OF(hash);
+	_Partition_Accommodate(p);
+	_Partition_Insert(p, hash, group);
+}
+
+uint64_t GroupTable_Count(const GroupTable *table) {
+	uint64_t count = 0;
+	for(uint i = 0; i < GROUP_TABLE_PARTITION_COUNT; i++) {
+		count += table->partitions[i].count;
+	}
+	return count;
+}
+
+void GroupTable_MergePartition(GroupTable *dest, GroupTable *src, uint partition,
+							   GroupMergeFunc merge, void *ctx) {
+	ASSERT(partition < GROUP_TABLE_PARTITION_COUNT);
+
+	GroupTablePartition *from = src->partitions + partition;
+	GroupTablePartition *to = dest->partitions + partition;
+	if(from->groups == NULL) return;
+
+	uint64_t cap = from->mask + 1;
+	for(uint64_t i = 0; i < cap; i++) {
+		Group *group = from->groups[i];
+		if(group == NULL) continue;
+
+		XXH64_hash_t hash = from->hashes[i];
+		Group *existing = _Partition_Get(to, hash, group->keys);
+		if(existing) {
+			merge(existing, group, ctx);
+			FreeGroup(group);
+		} else {
+			_Partition_Accommodate(to);
+			_Partition_Insert(to, hash, group);
+		}
+	}
+
+	// groups have been either moved or freed
+	_Partition_Release(from);
+}
+
+void GroupTable_Iter(GroupTable *table, GroupTableIterator *iter) {
+	iter->table = table;
+	iter->partition = 0;
+	iter->slot = 0;
+}
+
+Group *GroupTableIterator_Next(GroupTableIterator *iter) {
+	while(iter->partition < GROUP_TABLE_PARTITION_COUNT) {
+		GroupTablePartition *p = iter->table->partitions + iter->partition;
+		uint64_t cap = (p->groups) ? p->mask + 1 : 0;
+		while(iter->slot < cap) {
+			Group *group = p->groups[iter->slot++];
+			if(group) return group;
+		}
+		iter->partition++;
+		iter->slot = 0;
+	}
+	return NULL;
+}
+
+void GroupTable_Free(GroupTable *table) {
+	for(uint i = 0; i < GROUP_TABLE_PARTITION_COUNT; i++) {
+		GroupTablePartition *p = table->partitions + i;
+		if(p->groups == NULL) continue;
+		uint64_t cap = p->mask + 1;
+		for(uint64_t j = 0; j < cap; j++) {
+			if(p->groups[j]) FreeGroup(p->groups[j]);
+		}
+		_Partition_Release(p);
+	}
+	rm_free(table);
+}
+
@@ -0,0 +1,98 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "group.h"
+#include "../../deps/xxHash/xxhash.h"
+
+/* GroupTable maps group keys to groups.
+ * The table is split into partitions by the top bits of the key's hash,
+ * each partition is an open-addressing table keyed by the hash's low bits,
+ * colliding hashes are told apart by comparing keys.
+ * Tables built independently can be merged partition by partition. */
+
+// Number of hash bits selecting a partition.
+#define GROUP_TABLE_PARTITION_BITS 4
+#define GROUP_TABLE_PARTITION_COUNT (1 << GROUP_TABLE_PARTITION_BITS)
+
+// Initial number of slots in a partition.
+#define GROUP_TABLE_PARTITION_CAP 16
+
+typedef struct {
+	XXH64_hash_t *hashes;       // Hash of the group occupying each slot.
+	Group **groups;             // Slots, NULL if unoccupied.
+	uint64_t mask;              // Number of slots - 1.
+	uint64_t count;             // Number of groups within partition.
+} GroupTablePartition;
+
+typedef struct {
+	GroupTablePartition partitions[GROUP_TABLE_PARTITION_COUNT];
+} GroupTable;
+
+typedef struct {
+	GroupTable *table;          // Iterated table.
+	uint partition;             // Current partition.
+	uint64_t slot;              // Next slot to visit.
+} GroupTableIterator;
+
+// combines src into dest, both groups share the same key
+typedef void (*GroupMergeFunc)(Group *dest, Group *src, void *ctx);
+
+GroupTable *GroupTable_New(void);
+
+// retrieves group by key, NULL if key is missing
+Group *GroupTable_Get
+(
+	const GroupTable *table,
+	XXH64_hash_t hash,
+	const SIValue *keys
+);
+
+// adds group under hash, group's key must not be in table
+void GroupTable_Add
+(
+	GroupTable *table,
+	XXH64_hash_t hash,
+	Group *group
+);
+
+// number of groups in table
+uint64_t GroupTable_Count
+(
+	const GroupTable *table
+);
+
+// moves groups of src partition into dest, groups sharing a key
+// are combined by merge after which src's group is freed
+void GroupTable_MergePartition
+(
+	GroupTable *dest,
+	GroupTable *src,
+	uint partition,
+	GroupMergeFunc merge,
+	void *ctx
+);
+
+// populates an iterator to scan table
+void GroupTable_Iter
+(
+	GroupTable *table,
+	GroupTableIterator *iter
+);
+
+// advance iterator and returns group in current position, NULL when depleted
+Group *GroupTableIterator_Next
+(
+	GroupTableIterator *iter
+);
+
+// frees table along with its groups
+void GroupTable_Free
+(
+	GroupTable *table
+);
+
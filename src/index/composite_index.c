@@ -0,0 +1,575 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "composite_index.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+#include <math.h>
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+// Key encoding
+//------------------------------------------------------------------------------
+
+// a composite key is the concatenation of its fields encodings
+// each field is encoded as a kind tag, followed by an order preserving
+// encoding of the value and a field terminator
+//
+// keys are stored as NULL terminated strings compared via strcmp
+// as such bytes 0x00 and 0x01 are escaped within values:
+// 0x00 -> 0x01 0x02, 0x01 -> 0x01 0x03 while the terminator is 0x01 0x01
+// the terminator sorts before any value byte, hence a value sorts before
+// all values it prefixes
+//
+// byte 0xFF never follows a terminator, it is used to bound scans
+// to all keys sharing a prefix
+
+#define CK_ESCAPE   0x01  // escape byte
+#define CK_MISSING  0x02  // field is missing
+#define CK_BOOL     0x03  // boolean value
+#define CK_NUMERIC  0x04  // numeric value
+#define CK_STRING   0x05  // string value
+#define CK_OTHER    0x06  // value can't be looked up, e.g. array or NaN
+#define CK_MAX      0xFF  // sorts after any field encoding
+
+// document of an indexed node
+typedef struct {
+	Entity entity;  // copy of the node's key and included properties
+	char key[];     // encoded key, referenced by the keys ordered index
+} CompositeIndexDoc;
+
+struct _CompositeIndexIter {
+	const CompositeIndex *idx;  // scanned index
+	bool empty;                 // no node can match the scan
+	char *min;                  // inclusive lower bound
+	char *max;                  // exclusive upper bound
+	OrderedIndexIterator it;    // keys iterator
+};
+
+static inline void _AppendRaw(char **buf, unsigned char c) {
+	array_append(*buf, (char)c);
+}
+
+static inline void _AppendByte(char **buf, unsigned char c) {
+	if(c <= CK_ESCAPE) {
+		_AppendRaw(buf, CK_ESCAPE);
+		c += 2;
+	}
+	_AppendRaw(buf, c);
+}
+
+static inline void _AppendTerminator(char **buf) {
+	_AppendRaw(buf, CK_ESCAPE);
+	_AppendRaw(buf, CK_ESCAPE);
+}
+
+// doubles are encoded big-endian, with their sign bit flipped
+// negative values have all their bits flipped, reversing their order
+static void _AppendDouble(char **buf, double d) {
+	if(d == 0) d = 0; // -0.0 equals 0.0
+
+	uint64_t u;
+	memcpy(&u, &d, sizeof(uint64_t));
+	u = (u & (1ULL << 63)) ? ~u : (u | (1ULL << 63));
+
+	for(int i = 7; i >= 0; i--) _AppendByte(buf, (u >> (i * 8)) & 0xFF);
+}
+
+// classify value, 'v' might be PROPERTY_NOTFOUND
+static unsigned char _ValueKind(const SIValue *v) {
+	if(v == PROPERTY_NOTFOUND) return CK_MISSING;
+
+	SIType t = SI_TYPE(*v);
+	if(t == T_BOOL) return CK_BOOL;
+	if(t == T_STRING) return CK_STRING;
+	if(t & SI_NUMERIC) {
+		// NaN doesn't equal anything, including itself
+		return isnan(SI_GET_NUMERIC(*v)) ? CK_OTHER : CK_NUMERIC;
+	}
+
+	return CK_OTHER;
+}
+
+// encode value of kind 'kind' without its terminator
+static void _AppendValue(char **buf, unsigned char kind, const SIValue *v) {
+	_AppendRaw(buf, kind);
+
+	switch(kind) {
+		case CK_BOOL:
+			_AppendByte(buf, v->longval ? 1 : 0);
+			break;
+		case CK_NUMERIC:
+			_AppendDouble(buf, SI_GET_NUMERIC(*v));
+			break;
+		case CK_STRING:
+			for(const char *c = v->stringval; *c != '\0'; c++) {
+				_AppendByte(buf, *c);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+static inline void _AppendField(char **buf, const SIValue *v) {
+	_AppendValue(buf, _ValueKind(v), v);
+	_AppendTerminator(buf);
+}
+
+//------------------------------------------------------------------------------
+// Documents
+//------------------------------------------------------------------------------
+
+static CompositeIndexDoc *_Doc_New(const CompositeIndex *idx, const Node *n) {
+	char *key = array_new(char, 64);
+	for(uint i = 0; i < idx->fields_count; i++) {
+		_AppendField(&key,
+				GraphEntity_GetProperty((GraphEntity *)n, idx->fields_ids[i]));
+	}
+	array_append(key, '\0');
+
+	uint key_len = array_len(key);
+	CompositeIndexDoc *doc = rm_malloc(sizeof(CompositeIndexDoc) + key_len);
+	memcpy(doc->key, key, key_len);
+	array_free(key);
+
+	// copy covered properties, key fields followed by included fields
+	uint covered_count = idx->fields_count + idx->included_count;
+	EntityProperty *props = rm_malloc(sizeof(EntityProperty) * covered_count);
+	int prop_count = 0;
+
+	for(uint i = 0; i < covered_count; i++) {
+		Attribute_ID attr_id = (i < idx->fields_count) ? idx->fields_ids[i] :
+			idx->included_ids[i - idx->fields_count];
+		SIValue *v = GraphEntity_GetProperty((GraphEntity *)n, attr_id);
+		if(v == PROPERTY_NOTFOUND) continue;
+
+		props[prop_count].id = attr_id;
+		props[prop_count].value = SI_CloneValue(*v);
+		prop_count++;
+	}
+
+	if(prop_count == 0) {
+		rm_free(props);
+		props = NULL;
+	}
+
+	doc->entity.prop_count = prop_count;
+	doc->entity.properties = props;
+
+	return doc;
+}
+
+static void _Doc_Free(void *doc) {
+	CompositeIndexDoc *d = doc;
+	FreeEntity(&d->entity);
+	rm_free(d);
+}
+
+// recover a document from its key, as returned by the keys ordered index
+static inline CompositeIndexDoc *_Doc_FromKey(const char *key) {
+	return (CompositeIndexDoc *)(key - offsetof(CompositeIndexDoc, key));
+}
+
+static void _CompositeIndex_RemoveEntity(CompositeIndex *idx, NodeID id) {
+	CompositeIndexDoc *doc = raxFind(idx->docs, (unsigned char *)&id,
+			sizeof(NodeID));
+	if(doc == raxNotFound) return;
+
+	IndexKey key = {.s = doc->key};
+	OrderedIndex_Delete(idx->keys, key, id);
+	raxRemove(idx->docs, (unsigned char *)&id, sizeof(NodeID), NULL);
+	_Doc_Free(doc);
+}
+
+//------------------------------------------------------------------------------
+// Index API
+//------------------------------------------------------------------------------
+
+static bool _ContainsID(const Attribute_ID *ids, uint count, Attribute_ID id) {
+	for(uint i = 0; i < count; i++) {
+		if(ids[i] == id) return true;
+	}
+	return false;
+}
+
+CompositeIndex *CompositeIndex_New
+(
+	const char *label,
+	const char **fields,
+	uint fields_count,
+	const char **included,
+	uint included_count
+) {
+	ASSERT(label != NULL);
+	ASSERT(fields != NULL);
+	ASSERT(fields_count > 0);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	CompositeIndex *idx = rm_malloc(sizeof(CompositeIndex));
+
+	idx->label          =  rm_strdup(label);
+	idx->fields         =  array_new(char *, fields_count);
+	idx->fields_ids     =  array_new(Attribute_ID, fields_count);
+	idx->included       =  array_new(char *, included_count);
+	idx->included_ids   =  array_new(Attribute_ID, included_count);
+	idx->fields_count   =  0;
+	idx->included_count =  0;
+	idx->keys           =  OrderedIndex_New(OI_STRING);
+	idx->docs           =  raxNew();
+
+	for(uint i = 0; i < fields_count; i++) {
+		Attribute_ID id = GraphContext_FindOrAddAttribute(gc, fields[i]);
+		if(_ContainsID(idx->fields_ids, idx->fields_count, id)) continue;
+
+		array_append(idx->fields, rm_strdup(fields[i]));
+		array_append(idx->fields_ids, id);
+		idx->fields_count++;
+	}
+
+	for(uint i = 0; i < included_count; i++) {
+		Attribute_ID id = GraphContext_FindOrAddAttribute(gc, included[i]);
+		if(_ContainsID(idx->fields_ids, idx->fields_count, id)) continue;
+		if(_ContainsID(idx->included_ids, idx->included_count, id)) continue;
+
+		array_append(idx->included, rm_strdup(included[i]));
+		array_append(idx->included_ids, id);
+		idx->included_count++;
+	}
+
+	return idx;
+}
+
+bool CompositeIndex_HasFields
+(
+	const CompositeIndex *idx,
+	const char **fields,
+	uint fields_count
+) {
+	ASSERT(idx != NULL);
+
+	if(idx->fields_count != fields_count) return false;
+	for(uint i = 0; i < fields_count; i++) {
+		if(strcmp(idx->fields[i], fields[i]) != 0) return false;
+	}
+	return true;
+}
+
+int CompositeIndex_FieldPosition
+(
+	const CompositeIndex *idx,
+	Attribute_ID attr_id
+) {
+	ASSERT(idx != NULL);
+
+	for(uint i = 0; i < idx->fields_count; i++) {
+		if(idx->fields_ids[i] == attr_id) return i;
+	}
+	return -1;
+}
+
+bool CompositeIndex_Covers
+(
+	const CompositeIndex *idx,
+	Attribute_ID attr_id
+) {
+	ASSERT(idx != NULL);
+
+	return (_ContainsID(idx->fields_ids, idx->fields_count, attr_id) ||
+			_ContainsID(idx->included_ids, idx->included_count, attr_id));
+}
+
+void CompositeIndex_IndexNode
+(
+	CompositeIndex *idx,
+	const Node *n
+) {
+	ASSERT(idx != NULL);
+	ASSERT(n != NULL);
+
+	NodeID id = ENTITY_GET_ID(n);
+
+	// the node's values might have changed since it was last indexed
+	_CompositeIndex_RemoveEntity(idx, id);
+
+	// every labeled node is indexed, even if it is missing all key fields
+	// such that a scan constrained on none of the key fields
+	// visits all labeled nodes
+	CompositeIndexDoc *doc = _Doc_New(idx, n);
+	raxInsert(idx->docs, (unsigned char *)&id, sizeof(NodeID), doc, NULL);
+
+	IndexKey key = {.s = doc->key};
+	OrderedIndex_Insert(idx->keys, key, id);
+}
+
+void CompositeIndex_RemoveNode
+(
+	CompositeIndex *idx,
+	const Node *n
+) {
+	ASSERT(idx != NULL);
+	ASSERT(n != NULL);
+
+	_CompositeIndex_RemoveEntity(idx, ENTITY_GET_ID(n));
+}
+
+void CompositeIndex_Construct
+(
+	CompositeIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_NODE);
+
+	// label doesn't exists
+	if(s == NULL) return;
+
+	NodeID  node_id;
+	GxB_MatrixTupleIter *it;
+
+	Node   node  =  GE_NEW_NODE();
+	Graph  *g    =  gc->g;
+
+	const GrB_Matrix label_matrix = Graph_GetLabelMatrix(g, s->id);
+	GxB_MatrixTupleIter_new(&it, label_matrix);
+
+	// iterate over each labeled node
+	while(true) {
+		bool depleted = false;
+		GxB_MatrixTupleIter_next(it, NULL, &node_id, NULL, &depleted);
+		if(depleted) break;
+
+		Graph_GetNode(g, node_id, &node);
+		CompositeIndex_IndexNode(idx, &node);
+	}
+	GxB_MatrixTupleIter_free(it);
+}
+
+uint64_t CompositeIndex_Count
+(
+	const CompositeIndex *idx
+) {
+	ASSERT(idx != NULL);
+	return OrderedIndex_Count(idx->keys);
+}
+
+//------------------------------------------------------------------------------
+// Index scan
+//------------------------------------------------------------------------------
+
+// compute scan bounds, returns false if no node can match the scan
+static bool _CompositeIndex_Bounds
+(
+	CompositeIndexIter *it,
+	const SIValue *eq,
+	uint eq_count,
+	const SIValue *min,
+	bool include_min,
+	const SIValue *max,
+	bool include_max,
+	bool *supported
+) {
+	char *prefix = array_new(char, 64);
+	bool matchable = true;
+
+	// encode leading key fields
+	for(uint i = 0; i < eq_count && *supported; i++) {
+		// nothing equals NULL
+		if(SIValue_IsNull(eq[i])) {
+			matchable = false;
+			break;
+		}
+
+		unsigned char kind = _ValueKind(eq + i);
+		if(kind == CK_OTHER) {
+			if(SI_TYPE(eq[i]) & SI_NUMERIC) {
+				// nothing equals NaN
+				matchable = false;
+			} else {
+				// widen scan to the preceding key fields
+				*supported = false;
+			}
+			break;
+		}
+
+		_AppendValue(&prefix, kind, eq + i);
+		_AppendTerminator(&prefix);
+	}
+
+	if(!matchable) {
+		array_free(prefix);
+		return false;
+	}
+
+	// range over the next key field
+	unsigned char kind = CK_MAX;
+	if(*supported && (min != NULL || max != NULL)) {
+		unsigned char min_kind = (min) ? _ValueKind(min) : CK_MAX;
+		unsigned char max_kind = (max) ? _ValueKind(max) : CK_MAX;
+
+		// nothing compares to NULL or NaN
+		// values of different kinds aren't comparable
+		if((min && (SIValue_IsNull(*min) || (SI_TYPE(*min) & SI_NUMERIC &&
+				min_kind == CK_OTHER))) ||
+		   (max && (SIValue_IsNull(*max) || (SI_TYPE(*max) & SI_NUMERIC &&
+				max_kind == CK_OTHER))) ||
+		   (min && max && min_kind != max_kind)) {
+			array_free(prefix);
+			return false;
+		}
+
+		kind = (min) ? min_kind : max_kind;
+		if(kind == CK_OTHER) {
+			// e.g. points, can't be ranged over
+			*supported = false;
+			kind = CK_MAX;
+		}
+	}
+
+	uint prefix_len = array_len(prefix);
+	it->min = array_new(char, prefix_len + 32);
+	it->max = array_new(char, prefix_len + 32);
+	for(uint i = 0; i < prefix_len; i++) {
+		array_append(it->min, prefix[i]);
+		array_append(it->max, prefix[i]);
+	}
+	array_free(prefix);
+
+	if(kind == CK_MAX) {
+		// all keys sharing prefix
+		_AppendRaw(&it->max, CK_MAX);
+	} else {
+		// lower bound
+		if(min) {
+			_AppendValue(&it->min, kind, min);
+			if(!include_min) {
+				// skip past all keys holding 'min'
+				_AppendTerminator(&it->min);
+				_AppendRaw(&it->min, CK_MAX);
+			}
+		} else {
+			_AppendRaw(&it->min, kind);
+		}
+
+		// upper bound
+		if(max) {
+			_AppendValue(&it->max, kind, max);
+			_AppendTerminator(&it->max);
+			// include all keys holding 'max'
+			if(include_max) _AppendRaw(&it->max, CK_MAX);
+		} else {
+			_AppendRaw(&it->max, kind + 1);
+		}
+	}
+
+	array_append(it->min, '\0');
+	array_append(it->max, '\0');
+
+	return true;
+}
+
+static void _CompositeIndexIter_Seek(CompositeIndexIter *it) {
+	if(it->empty) return;
+
+	IndexKey min = {.s = it->min};
+	IndexKey max = {.s = it->max};
+	OrderedIndex_Seek(it->idx->keys, &it->it, &min, true, &max, false);
+}
+
+CompositeIndexIter *CompositeIndex_Scan
+(
+	const CompositeIndex *idx,
+	const SIValue *eq,
+	uint eq_count,
+	const SIValue *min,
+	bool include_min,
+	const SIValue *max,
+	bool include_max,
+	bool *supported
+) {
+	ASSERT(idx != NULL);
+	ASSERT(supported != NULL);
+	ASSERT(eq_count <= idx->fields_count);
+	ASSERT(eq_count < idx->fields_count || (min == NULL && max == NULL));
+
+	CompositeIndexIter *it = rm_malloc(sizeof(CompositeIndexIter));
+	it->idx = idx;
+	it->min = NULL;
+	it->max = NULL;
+
+	*supported = true;
+	it->empty = !_CompositeIndex_Bounds(it, eq, eq_count, min, include_min,
+			max, include_max, supported);
+
+	_CompositeIndexIter_Seek(it);
+
+	return it;
+}
+
+bool CompositeIndexIter_Next
+(
+	CompositeIndexIter *it,
+	NodeID *id,
+	Entity **covered
+) {
+	ASSERT(it != NULL);
+	ASSERT(id != NULL);
+
+	if(it->empty) return false;
+
+	IndexKey key;
+	if(!OrderedIndexIterator_Next(&it->it, &key, id)) return false;
+
+	if(covered) *covered = &_Doc_FromKey(key.s)->entity;
+	return true;
+}
+
+void CompositeIndexIter_Reset
+(
+	CompositeIndexIter *it
+) {
+	ASSERT(it != NULL);
+	_CompositeIndexIter_Seek(it);
+}
+
+void CompositeIndexIter_Free
+(
+	CompositeIndexIter *it
+) {
+	ASSERT(it != NULL);
+
+	if(it->min) array_free(it->min);
+	if(it->max) array_free(it->max);
+	rm_free(it);
+}
+
+void CompositeIndex_Free
+(
+	CompositeIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	for(uint i = 0; i < idx->fields_count; i++) rm_free(idx->fields[i]);
+	for(uint i = 0; i < idx->included_count; i++) rm_free(idx->included[i]);
+
+	array_free(idx->fields);
+	array_free(idx->fields_ids);
+	array_free(idx->included);
+	array_free(idx->included_ids);
+
+	OrderedIndex_Free(idx->keys);
+	raxFreeWithCallback(idx->docs, _Doc_Free);
+
+	rm_free(idx->label);
+	rm_free(idx);
+}
+
@@ -0,0 +1,147 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "rax.h"
+#include "ordered_index.h"
+#include "../graph/entities/node.h"
+#include "../graph/entities/graph_entity.h"
+
+// CompositeIndex indexes nodes of a label by an ordered tuple of properties
+// (key fields), e.g. (country, age), and additionally stores a copy of a set
+// of included properties
+//
+// each indexed node is represented by a single entry in an OI_STRING ordered
+// index whose key is an order preserving encoding of the node's key fields
+// values, such that all nodes sharing a prefix of key values are stored
+// consecutively, sorted by the value of the next key field
+// this allows scanning for equality on leading key fields followed by an
+// optional range on the next key field
+//
+// in addition every indexed node holds a copy of its key and included
+// properties, queries which only access these properties are answered
+// by the index without consulting the node's own properties
+typedef struct {
+	char *label;                  // indexed label
+	char **fields;                // key fields, in key order
+	Attribute_ID *fields_ids;     // key fields IDs
+	uint fields_count;            // number of key fields
+	char **included;              // included fields
+	Attribute_ID *included_ids;   // included fields IDs
+	uint included_count;          // number of included fields
+	OrderedIndex *keys;           // encoded keys
+	rax *docs;                    // indexed document of each node
+} CompositeIndex;
+
+// iterator over the nodes matching a composite index scan
+typedef struct _CompositeIndexIter CompositeIndexIter;
+
+// create a new composite index
+// 'included' may overlap 'fields', duplicates are ignored
+CompositeIndex *CompositeIndex_New
+(
+	const char *label,       // indexed label
+	const char **fields,     // key fields
+	uint fields_count,       // number of key fields
+	const char **included,   // included fields
+	uint included_count      // number of included fields
+);
+
+// checks if index key fields are exactly 'fields', in order
+bool CompositeIndex_HasFields
+(
+	const CompositeIndex *idx,
+	const char **fields,
+	uint fields_count
+);
+
+// returns position of attribute within index key fields, -1 if not a key field
+int CompositeIndex_FieldPosition
+(
+	const CompositeIndex *idx,
+	Attribute_ID attr_id
+);
+
+// checks if index holds a copy of attribute, either as a key or included field
+bool CompositeIndex_Covers
+(
+	const CompositeIndex *idx,
+	Attribute_ID attr_id
+);
+
+// index node, replacing any previously indexed values of the node
+void CompositeIndex_IndexNode
+(
+	CompositeIndex *idx,
+	const Node *n
+);
+
+// remove node from index
+void CompositeIndex_RemoveNode
+(
+	CompositeIndex *idx,
+	const Node *n
+);
+
+// index all nodes of the indexed label
+void CompositeIndex_Construct
+(
+	CompositeIndex *idx
+);
+
+// returns number of indexed nodes
+uint64_t CompositeIndex_Count
+(
+	const CompositeIndex *idx
+);
+
+// scan for nodes whose first 'eq_count' key fields equal 'eq'
+// and whose next key field is within [min, max], a NULL bound is unbounded
+//
+// only boolean, numeric and string values can be looked up
+// '*supported' is set to false if any of the values is of another type,
+// in which case the scan is widened to the leading key fields preceding it
+// and the caller is expected to verify matches
+CompositeIndexIter *CompositeIndex_Scan
+(
+	const CompositeIndex *idx,  // index to scan
+	const SIValue *eq,          // leading key fields values
+	uint eq_count,              // number of leading key fields values
+	const SIValue *min,         // lower bound of next key field
+	bool include_min,           // lower bound is inclusive
+	const SIValue *max,         // upper bound of next key field
+	bool include_max,           // upper bound is inclusive
+	bool *supported             // [output] scan is exact
+);
+
+// advance iterator, returns false once depleted
+// 'covered' is set to an entity holding the node's key and included properties
+bool CompositeIndexIter_Next
+(
+	CompositeIndexIter *it,   // iterator
+	NodeID *id,               // [output] matching node ID
+	Entity **covered          // [optional output] node's covered properties
+);
+
+// rewind iterator to its first match
+void CompositeIndexIter_Reset
+(
+	CompositeIndexIter *it
+);
+
+// free iterator
+void CompositeIndexIter_Free
+(
+	CompositeIndexIter *it
+);
+
+// free index
+void CompositeIndex_Free
+(
+	CompositeIndex *idx
+);
+
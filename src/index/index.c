@@ -6,14 +6,34 @@
 
 #include "RG.h"
 #include "index.h"
+#include "index_build.h"
 #include "../value.h"
 #include "../util/arr.h"
 #include "../query_ctx.h"
+#include "../util/qsort.h"
 #include "../util/rmalloc.h"
+#include "../util/thpool/pools.h"
 #include "../datatypes/point.h"
 #include "../graph/graphcontext.h"
 #include "../graph/entities/node.h"
 
+#include <math.h>
+
+// endpoints of an indexed edge
+typedef struct {
+	NodeID src;   // source node ID
+	NodeID dest;  // destination node ID
+} EdgeEndpoints;
+
+struct _IndexIter {
+	const Index *idx;         // scanned index
+	IndexQuery *q;            // evaluated query
+	bool streaming;           // scan a single ordered index directly
+	OrderedIndexIterator it;  // ordered index iterator, streaming only
+	NodeID *ids;              // sorted matches, none streaming only
+	uint pos;                 // position within ids
+};
+
 static int _getNodeAttribute(void *ctx, const char *fieldName, const void *id, char **strVal,
 							 double *doubleVal) {
 	Node n = GE_NEW_NODE();
@@ -43,6 +63,411 @@ static int _getNodeAttribute(void *ctx, const char *fieldName, const void *id, c
 	return ret;
 }
 
+//------------------------------------------------------------------------------
+// Exact-match index
+//------------------------------------------------------------------------------
+
+static void _IndexField_Init(IndexField *field) {
+	field->numeric       =  OrderedIndex_New(OI_NUMERIC);
+	field->boolean       =  OrderedIndex_New(OI_NUMERIC);
+	field->string        =  OrderedIndex_New(OI_STRING);
+	field->point         =  OrderedIndex_New(OI_POINT);
+	field->none_indexed  =  OrderedIndex_New(OI_NUMERIC);
+}
+
+static void _IndexField_Free(IndexField *field) {
+	OrderedIndex_Free(field->numeric);
+	OrderedIndex_Free(field->boolean);
+	OrderedIndex_Free(field->string);
+	OrderedIndex_Free(field->point);
+	OrderedIndex_Free(field->none_indexed);
+}
+
+void IndexedValue_Init(IndexedValue *iv, const SIValue *v) {
+	ASSERT(iv != NULL);
+
+	iv->type = IV_MISSING;
+	if(v == PROPERTY_NOTFOUND) return;
+
+	SIType t = SI_TYPE(*v);
+	if(t == T_STRING) {
+		iv->type = IV_STRING;
+		iv->key.s = rm_strdup(v->stringval);
+	} else if(t & SI_NUMERIC) {
+		// NaN isn't comparable, no range can contain it
+		double d = SI_GET_NUMERIC(*v);
+		if(isnan(d)) return;
+		iv->type = IV_NUMERIC;
+		iv->key.d = d;
+	} else if(t == T_BOOL) {
+		// kept apart from numbers, true and 1 are different values
+		iv->type = IV_BOOLEAN;
+		iv->key.d = SI_GET_NUMERIC(*v);
+	} else if(t == T_POINT) {
+		iv->type = IV_POINT;
+		iv->key.p.lat = Point_lat(*v);
+		iv->key.p.lon = Point_lon(*v);
+	} else {
+		// none indexable value, track node for runtime comparisons
+		iv->type = IV_NONE_INDEXED;
+		iv->key.d = 0;
+	}
+}
+
+void IndexedValue_Free(IndexedValue *iv) {
+	ASSERT(iv != NULL);
+	if(iv->type == IV_STRING) rm_free((char *)iv->key.s);
+	iv->type = IV_MISSING;
+}
+
+OrderedIndex *IndexField_GetTree(const IndexField *field, IndexedValueType type) {
+	ASSERT(field != NULL);
+
+	switch(type) {
+		case IV_NUMERIC:
+			return field->numeric;
+		case IV_BOOLEAN:
+			return field->boolean;
+		case IV_STRING:
+			return field->string;
+		case IV_POINT:
+			return field->point;
+		case IV_NONE_INDEXED:
+			return field->none_indexed;
+		default:
+			ASSERT(false && "value isn't indexed");
+			return NULL;
+	}
+}
+
+static void _IndexedValues_Free(void *values) {
+	IndexedValue *v = (IndexedValue *)values;
+	for(uint i = 0; i < array_len(v); i++) IndexedValue_Free(v + i);
+	array_free(v);
+}
+
+// position of attribute within index fields, -1 if attribute isn't indexed
+static int _Index_FieldPosition(const Index *idx, Attribute_ID attr) {
+	for(uint i = 0; i < idx->fields_count; i++) {
+		if(idx->fields_ids[i] == attr) return i;
+	}
+	return -1;
+}
+
+// drop all exact-match indexed values
+static void _Index_ClearExactMatch(Index *idx) {
+	for(uint i = 0; i < array_len(idx->field_indices); i++) {
+		_IndexField_Free(idx->field_indices + i);
+		_IndexField_Init(idx->field_indices + i);
+	}
+
+	raxFreeWithCallback(idx->entities, _IndexedValues_Free);
+	idx->entities = raxNew();
+
+	if(idx->endpoints != NULL) {
+		raxFreeWithCallback(idx->endpoints, rm_free);
+		idx->endpoints = raxNew();
+	}
+}
+
+// forget the endpoints of an edge which is no longer indexed
+static void _Index_RemoveEndpoints(Index *idx, EntityID id) {
+	if(idx->endpoints == NULL) return;
+
+	EdgeEndpoints *endpoints;
+	if(raxRemove(idx->endpoints, (unsigned char *)&id, sizeof(EntityID),
+				(void **)&endpoints)) {
+		rm_free(endpoints);
+	}
+}
+
+// remove entity's previously indexed values from the exact-match index
+static void _Index_RemoveEntity(Index *idx, NodeID id) {
+	IndexedValue *values = raxFind(idx->entities, (unsigned char *)&id,
+			sizeof(NodeID));
+	if(values == raxNotFound) return;
+
+	for(uint i = 0; i < array_len(values); i++) {
+		IndexedValue *v = values + i;
+		if(v->type == IV_MISSING) continue;
+		OrderedIndex *tree = IndexField_GetTree(idx->field_indices + i, v->type);
+		bool deleted = OrderedIndex_Delete(tree, v->key, id);
+		UNUSED(deleted);
+		ASSERT(deleted);
+	}
+
+	raxRemove(idx->entities, (unsigned char *)&id, sizeof(NodeID), NULL);
+	_IndexedValues_Free(values);
+	_Index_RemoveEndpoints(idx, id);
+}
+
+// index entity's values, returns false if entity holds none of the fields
+static bool _Index_IndexEntityExactMatch(Index *idx, const GraphEntity *ge) {
+	EntityID entity_id = ENTITY_GET_ID(ge);
+	bool indexed = false;
+
+	// the entity's values might have changed since it was last indexed
+	_Index_RemoveEntity(idx, entity_id);
+
+	IndexedValue *values = array_newlen(IndexedValue, idx->fields_count);
+	for(uint i = 0; i < idx->fields_count; i++) {
+		IndexedValue *iv = values + i;
+		SIValue *v = GraphEntity_GetProperty(ge, idx->fields_ids[i]);
+		IndexedValue_Init(iv, v);
+		if(iv->type == IV_MISSING) continue;
+
+		OrderedIndex *tree = IndexField_GetTree(idx->field_indices + i, iv->type);
+		OrderedIndex_Insert(tree, iv->key, entity_id);
+		indexed = true;
+	}
+
+	if(indexed) {
+		raxInsert(idx->entities, (unsigned char *)&entity_id, sizeof(EntityID),
+				values, NULL);
+	} else {
+		// entity doesn't poses any attributes which are indexed
+		array_free(values);
+	}
+
+	return indexed;
+}
+
+static inline void _Index_IndexNodeExactMatch(Index *idx, const Node *n) {
+	_Index_IndexEntityExactMatch(idx, (const GraphEntity *)n);
+}
+
+static void _Index_IndexEdgeExactMatch(Index *idx, const Edge *e) {
+	if(!_Index_IndexEntityExactMatch(idx, (const GraphEntity *)e)) return;
+
+	// remember edge endpoints, used to seed traversals from matching edges
+	EdgeID edge_id = ENTITY_GET_ID(e);
+	EdgeEndpoints *endpoints = rm_malloc(sizeof(EdgeEndpoints));
+	endpoints->src = Edge_GetSrcNodeID(e);
+	endpoints->dest = Edge_GetDestNodeID(e);
+	raxInsert(idx->endpoints, (unsigned char *)&edge_id, sizeof(EdgeID),
+			endpoints, NULL);
+}
+
+//------------------------------------------------------------------------------
+// Exact-match index scan
+//------------------------------------------------------------------------------
+
+// position 'it' at the start of a leaf query's scan
+// returns false if the queried attribute isn't indexed
+static bool _Index_SeekLeaf(const Index *idx, const IndexQuery *q,
+		OrderedIndexIterator *it) {
+	int pos = _Index_FieldPosition(idx, q->attr);
+	if(pos == -1) return false;
+
+	IndexKey min;
+	IndexKey max;
+	IndexField *field = idx->field_indices + pos;
+
+	switch(q->type) {
+		case IQ_NUMERIC_RANGE:
+			min.d = q->numeric.min;
+			max.d = q->numeric.max;
+			OrderedIndex_Seek(field->numeric, it,
+					(min.d == -INFINITY) ? NULL : &min, q->numeric.include_min,
+					(max.d == INFINITY)  ? NULL : &max, q->numeric.include_max);
+			break;
+		case IQ_BOOLEAN_RANGE:
+			min.d = q->numeric.min;
+			max.d = q->numeric.max;
+			OrderedIndex_Seek(field->boolean, it,
+					(min.d == -INFINITY) ? NULL : &min, q->numeric.include_min,
+					(max.d == INFINITY)  ? NULL : &max, q->numeric.include_max);
+			break;
+		case IQ_STRING_RANGE:
+			min.s = q->string.min;
+			max.s = q->string.max;
+			OrderedIndex_Seek(field->string, it,
+					(min.s == NULL) ? NULL : &min, q->string.include_min,
+					(max.s == NULL) ? NULL : &max, q->string.include_max);
+			break;
+		case IQ_DISTANCE: {
+			// the great-circle distance between two points is at least
+			// their latitude difference, scan a slightly widened latitude band
+			// candidates are verified against the actual distance
+			float lat = Point_lat(q->distance.origin);
+			double delta = (q->distance.radius / EARTH_RADIUS) * (180.0 / M_PI);
+			delta *= 1.01;
+			min.p.lat = lat - delta;
+			min.p.lon = -INFINITY;
+			max.p.lat = lat + delta;
+			max.p.lon = INFINITY;
+			OrderedIndex_Seek(field->point, it, &min, true, &max, true);
+			break;
+		}
+		case IQ_NONE_INDEXED:
+			OrderedIndex_Seek(field->none_indexed, it, NULL, false, NULL, false);
+			break;
+		default:
+			ASSERT(false && "unexpected index query type");
+			return false;
+	}
+
+	return true;
+}
+
+// advance a leaf query's scan
+static bool _Index_NextLeaf(const IndexQuery *q, OrderedIndexIterator *it,
+		NodeID *id) {
+	IndexKey key;
+	while(OrderedIndexIterator_Next(it, &key, id)) {
+		if(q->type != IQ_DISTANCE) return true;
+
+		SIValue p = SI_Point(key.p.lat, key.p.lon);
+		double d = Point_Distance(q->distance.origin, p);
+		if(d < q->distance.radius) return true;
+		if(q->distance.include_radius && d == q->distance.radius) return true;
+	}
+
+	return false;
+}
+
+// merge two sorted ID arrays, frees both inputs
+static NodeID *_Index_Union(NodeID *a, NodeID *b) {
+	uint i = 0;
+	uint j = 0;
+	uint a_len = array_len(a);
+	uint b_len = array_len(b);
+	NodeID *ids = array_new(NodeID, a_len + b_len);
+
+	while(i < a_len && j < b_len) {
+		if(a[i] < b[j]) {
+			array_append(ids, a[i++]);
+		} else if(b[j] < a[i]) {
+			array_append(ids, b[j++]);
+		} else {
+			array_append(ids, a[i]);
+			i++;
+			j++;
+		}
+	}
+	for(; i < a_len; i++) array_append(ids, a[i]);
+	for(; j < b_len; j++) array_append(ids, b[j]);
+
+	array_free(a);
+	array_free(b);
+	return ids;
+}
+
+// intersect two sorted ID arrays in place of 'a', frees 'b'
+static NodeID *_Index_Intersect(NodeID *a, NodeID *b) {
+	uint i = 0;
+	uint j = 0;
+	uint n = 0;
+	uint a_len = array_len(a);
+	uint b_len = array_len(b);
+
+	while(i < a_len && j < b_len) {
+		if(a[i] < b[j]) {
+			i++;
+		} else if(b[j] < a[i]) {
+			j++;
+		} else {
+			a[n++] = a[i];
+			i++;
+			j++;
+		}
+	}
+
+	a = array_trimm_len(a, n);
+	array_free(b);
+	return a;
+}
+
+// evaluate query into a sorted array of matching node IDs
+static NodeID *_Index_Evaluate(const Index *idx, const IndexQuery *q) {
+	NodeID *ids = NULL;
+
+	switch(q->type) {
+		case IQ_EMPTY:
+			return array_new(NodeID, 0);
+		case IQ_UNION:
+		case IQ_INTERSECTION: {
+			uint n = array_len(q->children);
+			if(n == 0) return array_new(NodeID, 0);
+
+			ids = _Index_Evaluate(idx, q->children[0]);
+			for(uint i = 1; i < n; i++) {
+				// intersection is empty, skip remaining children
+				if(q->type == IQ_INTERSECTION && array_len(ids) == 0) break;
+
+				NodeID *child = _Index_Evaluate(idx, q->children[i]);
+				if(q->type == IQ_UNION) ids = _Index_Union(ids, child);
+				else ids = _Index_Intersect(ids, child);
+			}
+			return ids;
+		}
+		default: {
+			// leaf, scan is ordered by value, sort by ID
+			NodeID id;
+			OrderedIndexIterator it;
+			ids = array_new(NodeID, 0);
+			if(_Index_SeekLeaf(idx, q, &it)) {
+				while(_Index_NextLeaf(q, &it, &id)) array_append(ids, id);
+			}
+#define is_id_lt(a, b) (*(a) < *(b))
+			QSORT(NodeID, ids, array_len(ids), is_id_lt);
+			return ids;
+		}
+	}
+}
+
+IndexIter *Index_Scan(const Index *idx, IndexQuery *q) {
+	ASSERT(q   != NULL);
+	ASSERT(idx != NULL);
+	ASSERT(idx->type == IDX_EXACT_MATCH);
+
+	IndexIter *it = rm_malloc(sizeof(IndexIter));
+	it->q    =  q;
+	it->idx  =  idx;
+	it->ids  =  NULL;
+	it->pos  =  0;
+
+	// a single range is streamed directly out of its ordered index
+	// composite queries are materialized
+	it->streaming = (q->type != IQ_EMPTY && q->type != IQ_UNION &&
+			q->type != IQ_INTERSECTION);
+
+	if(it->streaming && !_Index_SeekLeaf(idx, q, &it->it)) {
+		it->streaming = false;
+		it->ids = array_new(NodeID, 0);
+	} else if(!it->streaming) {
+		it->ids = _Index_Evaluate(idx, q);
+	}
+
+	return it;
+}
+
+bool IndexIter_Next(IndexIter *it, NodeID *id) {
+	ASSERT(it != NULL && id != NULL);
+
+	if(it->streaming) return _Index_NextLeaf(it->q, &it->it, id);
+
+	if(it->pos >= array_len(it->ids)) return false;
+	*id = it->ids[it->pos++];
+	return true;
+}
+
+void IndexIter_Reset(IndexIter *it) {
+	ASSERT(it != NULL);
+
+	if(it->streaming) _Index_SeekLeaf(it->idx, it->q, &it->it);
+	else it->pos = 0;
+}
+
+void IndexIter_Free(IndexIter *it) {
+	ASSERT(it != NULL);
+
+	if(it->ids) array_free(it->ids);
+	IndexQuery_Free(it->q);
+	rm_free(it);
+}
+
+// populate a full-text index, one node at a time
 static void _populateIndex(Index *idx) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_NODE);
@@ -72,15 +497,177 @@ static void _populateIndex(Index *idx) {
 	GxB_MatrixTupleIter_free(it);
 }
 
+//------------------------------------------------------------------------------
+// Exact-match index construction
+//------------------------------------------------------------------------------
+
+// number of label matrix rows scanned while holding the graph's read lock
+// during a concurrent construction
+#define CONSTRUCTION_CHUNK_ROWS 262144
+
+struct _IndexConstruction {
+	Index *idx;          // index under construction, NULL once abandoned
+	GraphContext *gc;    // graph context, retained until construction ends
+	IndexBuild *build;   // runs scanned so far
+	int label_id;        // indexed label
+	NodeID end;          // scan end, nodes created later are logged
+	NodeID *log;         // nodes indexed or removed since construction began
+};
+
+// populate exact-match edge index out of its relationship type's edges
+static void _Index_PopulateEdges(Index *idx) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_EDGE);
+
+	// Relationship type doesn't exists.
+	if(s == NULL) return;
+
+	Graph *g = gc->g;
+	Edge *edges = array_new(Edge, 1);
+	GxB_MatrixTupleIter *it;
+	GxB_MatrixTupleIter_new(&it, Graph_GetRelationMatrix(g, s->id));
+
+	// Iterate over each connected pair of nodes.
+	while(true) {
+		NodeID src;
+		NodeID dest;
+		bool depleted = false;
+		GxB_MatrixTupleIter_next(it, &src, &dest, NULL, &depleted);
+		if(depleted) break;
+
+		Graph_GetEdgesConnectingNodes(g, src, dest, s->id, &edges);
+		uint edge_count = array_len(edges);
+		for(uint i = 0; i < edge_count; i++) {
+			_Index_IndexEdgeExactMatch(idx, edges + i);
+		}
+		array_clear(edges);
+	}
+
+	GxB_MatrixTupleIter_free(it);
+	array_free(edges);
+}
+
+// populate exact-match index out of its label's nodes
+// label matrix rows are scanned in parallel into sorted runs
+static void _Index_PopulateExactMatch(Index *idx) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_NODE);
+
+	// Label doesn't exists.
+	if(s == NULL) return;
+
+	IndexBuild *build = IndexBuild_New(idx, s->id);
+	IndexBuild_Scan(build, gc->g, 0, Graph_RequiredMatrixDim(gc->g));
+	IndexBuild_Finalize(build, idx->field_indices, idx->entities);
+	IndexBuild_Free(build);
+}
+
+// record node as modified while index is constructed concurrently
+static inline void _Index_LogModification(Index *idx, NodeID id) {
+	if(idx->construction != NULL) array_append(idx->construction->log, id);
+}
+
+// detach index from its pending construction, if any
+// the construction's job discards its work once it notices
+static void _Index_AbandonConstruction(Index *idx) {
+	if(idx->construction == NULL) return;
+	idx->construction->idx = NULL;
+	idx->construction = NULL;
+}
+
+// reindex nodes modified while the index was constructed
+static void _Index_ReplayLog(Index *idx, Graph *g, int label_id, NodeID *log) {
+	uint n = array_len(log);
+	QSORT(NodeID, log, n, is_id_lt);
+
+	Node node = GE_NEW_NODE();
+	for(uint i = 0; i < n; i++) {
+		NodeID id = log[i];
+		if(i > 0 && log[i - 1] == id) continue;
+
+		// the scan might have captured an outdated value
+		_Index_RemoveEntity(idx, id);
+
+		// node might have been deleted since, its ID might have been reused
+		if(!Graph_GetNode(g, id, &node)) continue;
+		if(Graph_GetNodeLabel(g, id) != label_id) continue;
+		_Index_IndexNodeExactMatch(idx, &node);
+	}
+}
+
+// scan an index's label in chunks, holding the graph's read lock per chunk
+// once scanned, install the index under the graph's write lock
+// and reindex nodes modified in the meantime
+static void _Index_ConstructionRun(void *arg) {
+	IndexConstruction *c = (IndexConstruction *)arg;
+	GraphContext *gc = c->gc;
+	Graph *g = gc->g;
+
+	for(NodeID from = 0; from < c->end; from += CONSTRUCTION_CHUNK_ROWS) {
+		rm_reset_n_alloced();
+		Graph_AcquireReadLock(g);
+
+		// index was dropped or reconstructed, discard work
+		bool abandoned = (c->idx == NULL);
+		if(!abandoned) {
+			NodeID to = from + CONSTRUCTION_CHUNK_ROWS;
+			if(to > c->end) to = c->end;
+			IndexBuild_Scan(c->build, g, from, to);
+		}
+
+		Graph_ReleaseLock(g);
+		if(abandoned) break;
+	}
+
+	// lock as a committing writer would
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	Graph_WriterEnter(g);
+	RedisModule_ThreadSafeContextLock(ctx);
+	Graph_AcquireWriteLock(g);
+
+	Index *idx = c->idx;
+	if(idx != NULL) {
+		_Index_ClearExactMatch(idx);
+		IndexBuild_Finalize(c->build, idx->field_indices, idx->entities);
+		idx->construction = NULL;
+		_Index_ReplayLog(idx, g, c->label_id, c->log);
+	}
+
+	Graph_ReleaseLock(g);
+	RedisModule_ThreadSafeContextUnlock(ctx);
+	Graph_WriterLeave(g);
+	RedisModule_FreeThreadSafeContext(ctx);
+
+	IndexBuild_Free(c->build);
+	array_free(c->log);
+	rm_free(c);
+	GraphContext_Release(gc);
+}
+
 // Create a new index.
-Index *Index_New(const char *label, IndexType type) {
+Index *Index_New(const char *label, IndexType type, GraphEntityType entity_type) {
+	ASSERT(entity_type == GETYPE_NODE || type == IDX_EXACT_MATCH);
+
 	Index *idx = rm_malloc(sizeof(Index));
 	idx->idx = NULL;
 	idx->fields_count = 0;
 	idx->type = type;
+	idx->entity_type = entity_type;
 	idx->label = rm_strdup(label);
 	idx->fields = array_new(char *, 0);
 	idx->fields_ids = array_new(Attribute_ID, 0);
+	idx->field_indices = NULL;
+	idx->entities = NULL;
+	idx->endpoints = NULL;
+	idx->construction = NULL;
+
+	if(type == IDX_EXACT_MATCH) {
+		idx->field_indices = array_new(IndexField, 0);
+		idx->entities = raxNew();
+	}
+
+	if(entity_type == GETYPE_EDGE) idx->endpoints = raxNew();
+
 	return idx;
 }
 
@@ -94,6 +681,48 @@ void Index_AddField(Index *idx, const char *field) {
 	idx->fields_count++;
 	array_append(idx->fields, rm_strdup(field));
 	array_append(idx->fields_ids, fieldID);
+
+	if(idx->type == IDX_EXACT_MATCH) {
+		IndexField f;
+		_IndexField_Init(&f);
+		array_append(idx->field_indices, f);
+	}
+}
+
+// drop the field at position 'pos' from all indexed nodes
+// the field's values are dropped along with its ordered indices
+static void _Index_RemoveExactMatchField(Index *idx, uint pos) {
+	raxIterator it;
+	NodeID *emptied = array_new(NodeID, 0);
+
+	raxStart(&it, idx->entities);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		IndexedValue *values = it.data;
+		if(pos >= array_len(values)) continue;
+
+		IndexedValue_Free(values + pos);
+		array_del_fast(values, pos);
+
+		bool indexed = false;
+		for(uint i = 0; i < array_len(values) && !indexed; i++) {
+			indexed = (values[i].type != IV_MISSING);
+		}
+		if(!indexed) array_append(emptied, *(NodeID *)it.key);
+	}
+	raxStop(&it);
+
+	for(uint i = 0; i < array_len(emptied); i++) {
+		IndexedValue *values;
+		raxRemove(idx->entities, (unsigned char *)(emptied + i), sizeof(NodeID),
+				(void **)&values);
+		_IndexedValues_Free(values);
+		_Index_RemoveEndpoints(idx, emptied[i]);
+	}
+	array_free(emptied);
+
+	_IndexField_Free(idx->field_indices + pos);
+	array_del_fast(idx->field_indices, pos);
 }
 
 // Removes fields from index.
@@ -109,95 +738,47 @@ void Index_RemoveField(Index *idx, const char *field) {
 			rm_free(idx->fields[i]);
 			array_del_fast(idx->fields, i);
 			array_del_fast(idx->fields_ids, i);
+			if(idx->type == IDX_EXACT_MATCH) _Index_RemoveExactMatchField(idx, i);
 			break;
 		}
 	}
+
+	// pending construction scans the removed field, start over
+	if(idx->construction != NULL) {
+		_Index_AbandonConstruction(idx);
+		if(idx->fields_count > 0) Index_ConstructAsync(idx);
+	}
 }
 
 void Index_IndexNode(Index *idx, const Node *n) {
+	if(idx->type == IDX_EXACT_MATCH) {
+		_Index_IndexNodeExactMatch(idx, n);
+		_Index_LogModification(idx, ENTITY_GET_ID(n));
+		return;
+	}
+
 	double      score            = 1;     // default score
 	const char  *lang            = NULL;  // default language
-	const char  *field_name      = NULL;  // name of current indexed field
 	SIValue     *v               = NULL;  // current indexed value
 	RSIndex     *rsIdx           = idx->idx;
 	NodeID      node_id          = ENTITY_GET_ID(n);
 	uint        doc_field_count  = 0;
 
-	// list of none indexable fields
-	uint none_indexable_fields_count = 0; // number of none indexed fields
-	const char *none_indexable_fields[idx->fields_count]; // none indexed fields
-
 	// create a document out of node
 	RSDoc *doc = RediSearch_CreateDocument(&node_id, sizeof(EntityID), score, lang);
 
 	// add document field for each indexed property
-	if(idx->type == IDX_FULLTEXT) {
-		for(uint i = 0; i < idx->fields_count; i++) {
-			field_name = idx->fields[i];
-			v = GraphEntity_GetProperty((GraphEntity *)n, idx->fields_ids[i]);
-			if(v == PROPERTY_NOTFOUND) continue;
-
-			SIType t = SI_TYPE(*v);
-
-			// value must be of type string
-			if(t == T_STRING) {
-				doc_field_count++;
-				RediSearch_DocumentAddFieldString(doc, idx->fields[i], 
-						v->stringval, strlen(v->stringval), RSFLDTYPE_FULLTEXT);
-			}
-		}
-	} else {
-		for(uint i = 0; i < idx->fields_count; i++) {
-			field_name = idx->fields[i];
-			v = GraphEntity_GetProperty((GraphEntity *)n, idx->fields_ids[i]);
-			if(v == PROPERTY_NOTFOUND) continue;
+	for(uint i = 0; i < idx->fields_count; i++) {
+		v = GraphEntity_GetProperty((GraphEntity *)n, idx->fields_ids[i]);
+		if(v == PROPERTY_NOTFOUND) continue;
 
-			SIType t = SI_TYPE(*v);
+		SIType t = SI_TYPE(*v);
 
+		// value must be of type string
+		if(t == T_STRING) {
 			doc_field_count++;
-			if(t == T_STRING) {
-				RediSearch_DocumentAddFieldString(doc, idx->fields[i],
-						v->stringval, strlen(v->stringval), RSFLDTYPE_TAG);
-			} else if(t & (SI_NUMERIC | T_BOOL)) {
-				double d = SI_GET_NUMERIC(*v);
-				RediSearch_DocumentAddFieldNumber(doc, field_name, d,
-						RSFLDTYPE_NUMERIC);
-			} else if(t == T_POINT) {
-				double lat = (double)Point_lat(*v);
-				double lon = (double)Point_lon(*v);
-				RediSearch_DocumentAddFieldGeo(doc, field_name, lat, lon,
-						RSFLDTYPE_GEO);
-			} else {
-				// none indexable field
-				none_indexable_fields[none_indexable_fields_count++] =
-					field_name;
-			}
-		}
-
-		// index name of none index fields
-		if(none_indexable_fields_count > 0) {
-			// concat all none indexable field names
-			size_t len = none_indexable_fields_count - 1; // seperators
-			for(uint i = 0; i < none_indexable_fields_count; i++) {
-				len += strlen(none_indexable_fields[i]);
-			}
-
-			char *s = NULL;
-			char stack_fields[len];
-			if(len < 512) s = stack_fields; // stack base
-			else s = rm_malloc(sizeof(char) * len); // heap base
-
-			// concat
-			len = sprintf(s, "%s", none_indexable_fields[0]);
-			for(uint i = 1; i < none_indexable_fields_count; i++) {
-				len += sprintf(s + len, "%c%s", INDEX_SEPARATOR, none_indexable_fields[i]);
-			}
-
-			RediSearch_DocumentAddFieldString(doc, INDEX_FIELD_NONE_INDEXED,
-						s, len, RSFLDTYPE_TAG);
-
-			// free if heap based
-			if(s != stack_fields) rm_free(s);
+			RediSearch_DocumentAddFieldString(doc, idx->fields[i],
+					v->stringval, strlen(v->stringval), RSFLDTYPE_FULLTEXT);
 		}
 	}
 
@@ -214,13 +795,55 @@ void Index_IndexNode(Index *idx, const Node *n) {
 void Index_RemoveNode(Index *idx, const Node *n) {
 	ASSERT(idx != NULL && n != NULL);
 	NodeID node_id = ENTITY_GET_ID(n);
-	RediSearch_DeleteDocument(idx->idx, &node_id, sizeof(EntityID));
+	if(idx->type == IDX_EXACT_MATCH) {
+		_Index_RemoveEntity(idx, node_id);
+		_Index_LogModification(idx, node_id);
+	} else {
+		RediSearch_DeleteDocument(idx->idx, &node_id, sizeof(EntityID));
+	}
+}
+
+void Index_IndexEdge(Index *idx, const Edge *e) {
+	ASSERT(idx != NULL && e != NULL);
+	ASSERT(idx->entity_type == GETYPE_EDGE);
+
+	_Index_IndexEdgeExactMatch(idx, e);
+}
+
+void Index_RemoveEdge(Index *idx, const Edge *e) {
+	ASSERT(idx != NULL && e != NULL);
+	ASSERT(idx->entity_type == GETYPE_EDGE);
+
+	_Index_RemoveEntity(idx, ENTITY_GET_ID(e));
+}
+
+bool Index_GetEdgeEndpoints(const Index *idx, EdgeID id, NodeID *src,
+		NodeID *dest) {
+	ASSERT(idx != NULL && src != NULL && dest != NULL);
+	ASSERT(idx->entity_type == GETYPE_EDGE);
+
+	EdgeEndpoints *endpoints = raxFind(idx->endpoints, (unsigned char *)&id,
+			sizeof(EdgeID));
+	if(endpoints == raxNotFound) return false;
+
+	*src = endpoints->src;
+	*dest = endpoints->dest;
+	return true;
 }
 
 // Constructs index.
 void Index_Construct(Index *idx) {
 	ASSERT(idx != NULL);
 
+	if(idx->type == IDX_EXACT_MATCH) {
+		// drop previously indexed values, re-construct
+		_Index_AbandonConstruction(idx);
+		_Index_ClearExactMatch(idx);
+		if(idx->entity_type == GETYPE_EDGE) _Index_PopulateEdges(idx);
+		else _Index_PopulateExactMatch(idx);
+		return;
+	}
+
 	// RediSearch index already exists, re-construct
 	if(idx->idx) {
 		RediSearch_DropIndex(idx->idx);
@@ -239,39 +862,63 @@ void Index_Construct(Index *idx) {
 	RediSearch_FreeIndexOptions(idx_options);
 
 	// create indexed fields
-	if(idx->type == IDX_FULLTEXT) {
-		for(uint i = 0; i < idx->fields_count; i++) {
-			// introduce text field
-			RediSearch_CreateTextField(rsIdx, idx->fields[i]);
-		}
-	} else {
-		for(uint i = 0; i < idx->fields_count; i++) {
-			// introduce both text, numeric and geo fields
-			unsigned types = RSFLDTYPE_NUMERIC | RSFLDTYPE_GEO | RSFLDTYPE_TAG;
-			RSFieldID fieldID = RediSearch_CreateField(rsIdx, idx->fields[i],
-					types, RSFLDOPT_NONE);
-
-			RediSearch_TagFieldSetSeparator(rsIdx, fieldID, INDEX_SEPARATOR);
-			RediSearch_TagFieldSetCaseSensitive(rsIdx, fieldID, 1);
-		}
-
-		// for none indexable types e.g. Array introduce an additional field
-		// "none_indexable_fields" which will hold a list of attribute names
-		// that were not indexed
-		RSFieldID fieldID = RediSearch_CreateField(rsIdx,
-				INDEX_FIELD_NONE_INDEXED, RSFLDTYPE_TAG, RSFLDOPT_NONE);
-
-		RediSearch_TagFieldSetSeparator(rsIdx, fieldID, INDEX_SEPARATOR);
-		RediSearch_TagFieldSetCaseSensitive(rsIdx, fieldID, 1);
+	for(uint i = 0; i < idx->fields_count; i++) {
+		// introduce text field
+		RediSearch_CreateTextField(rsIdx, idx->fields[i]);
 	}
 
 	idx->idx = rsIdx;
 	_populateIndex(idx);
 }
 
+void Index_ConstructAsync(Index *idx) {
+	ASSERT(idx != NULL);
+
+	if(idx->type != IDX_EXACT_MATCH || idx->entity_type == GETYPE_EDGE) {
+		Index_Construct(idx);
+		return;
+	}
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_NODE);
+	ASSERT(s != NULL);
+
+	// a previous construction is based on outdated fields
+	_Index_AbandonConstruction(idx);
+
+	// until the construction completes, the index keeps being maintained
+	// as usual, serving existing execution plans
+	IndexConstruction *c = rm_malloc(sizeof(IndexConstruction));
+	c->idx = idx;
+	c->gc = gc;
+	c->build = IndexBuild_New(idx, s->id);
+	c->label_id = s->id;
+	c->end = Graph_RequiredMatrixDim(gc->g);
+	c->log = array_new(NodeID, 0);
+
+	idx->construction = c;
+	GraphContext_Retain(gc);
+
+	if(ThreadPools_AddWorkReader(_Index_ConstructionRun, c) != 0) {
+		// failed to schedule construction, construct synchronously
+		_Index_AbandonConstruction(idx);
+		IndexBuild_Free(c->build);
+		array_free(c->log);
+		rm_free(c);
+		GraphContext_Release(gc);
+		Index_Construct(idx);
+	}
+}
+
+bool Index_Operational(const Index *idx) {
+	ASSERT(idx != NULL);
+	return idx->construction == NULL;
+}
+
 // Query index.
 RSResultsIterator *Index_Query(const Index *idx, const char *query, char **err) {
 	ASSERT(idx != NULL && query != NULL);
+	ASSERT(idx->type == IDX_FULLTEXT);
 	return RediSearch_IterateQuery(idx->idx, query, strlen(query), err);
 }
 
@@ -303,11 +950,35 @@ bool Index_ContainsAttribute(const Index *idx, Attribute_ID attribute_id) {
 	return false;
 }
 
+uint64_t Index_EntityCount(const Index *idx) {
+	ASSERT(idx != NULL);
+	if(idx->type != IDX_EXACT_MATCH || !Index_Operational(idx)) return 0;
+	return raxSize(idx->entities);
+}
+
+uint64_t Index_DistinctValues(const Index *idx, Attribute_ID attribute_id) {
+	ASSERT(idx != NULL);
+	if(idx->type != IDX_EXACT_MATCH || !Index_Operational(idx)) return 0;
+
+	int pos = _Index_FieldPosition(idx, attribute_id);
+	if(pos < 0) return 0;
+
+	const IndexField *field = idx->field_indices + pos;
+	return OrderedIndex_DistinctCount(field->numeric) +
+		   OrderedIndex_DistinctCount(field->boolean) +
+		   OrderedIndex_DistinctCount(field->string)  +
+		   OrderedIndex_DistinctCount(field->point)   +
+		   OrderedIndex_DistinctCount(field->none_indexed);
+}
+
 // Free index.
 void Index_Free(Index *idx) {
 	ASSERT(idx != NULL);
 	if(idx->idx) RediSearch_DropIndex(idx->idx);
 
+	// pending construction discards its work
+	_Index_AbandonConstruction(idx);
+
 	rm_free(idx->label);
 
 	for(uint i = 0; i < idx->fields_count; i++) {
@@ -317,5 +988,15 @@ void Index_Free(Index *idx) {
 	array_free(idx->fields);
 	array_free(idx->fields_ids);
 
+	if(idx->type == IDX_EXACT_MATCH) {
+		for(uint i = 0; i < array_len(idx->field_indices); i++) {
+			_IndexField_Free(idx->field_indices + i);
+		}
+		array_free(idx->field_indices);
+		raxFreeWithCallback(idx->entities, _IndexedValues_Free);
+	}
+
+	if(idx->endpoints) raxFreeWithCallback(idx->endpoints, rm_free);
+
 	rm_free(idx);
 }
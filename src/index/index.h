@@ -6,14 +6,16 @@
 
 #pragma once
 
+#include "index_query.h"
+#include "ordered_index.h"
 #include "../graph/entities/node.h"
+#include "../graph/entities/edge.h"
 #include "../graph/entities/graph_entity.h"
+#include "rax.h"
 #include "redisearch_api.h"
 
 #define INDEX_OK 1
 #define INDEX_FAIL 0
-#define INDEX_SEPARATOR '\1'  // can't use '\0', RediSearch will terminate on \0
-#define INDEX_FIELD_NONE_INDEXED "NONE_INDEXABLE_FIELDS"
 
 typedef enum {
 	IDX_ANY = 0,
@@ -21,22 +23,62 @@ typedef enum {
 	IDX_FULLTEXT = 2,
 } IndexType;
 
+// ordered indices of a single exact-match indexed field
+// one per value type
+typedef struct {
+	OrderedIndex *numeric;       // numeric values
+	OrderedIndex *boolean;       // boolean values, false = 0, true = 1
+	OrderedIndex *string;        // string values
+	OrderedIndex *point;         // point values
+	OrderedIndex *none_indexed;  // nodes holding a none indexable value
+} IndexField;
+
+// kind of value a node holds for an exact-match indexed field
+// determines which of the field's ordered indices holds the value
+typedef enum {
+	IV_MISSING = 0,   // field is missing or holds NaN, not indexed
+	IV_NUMERIC,       // numeric values
+	IV_BOOLEAN,       // boolean values
+	IV_STRING,        // string values
+	IV_POINT,         // point values
+	IV_NONE_INDEXED,  // none indexable values
+	IV_TYPE_COUNT,
+} IndexedValueType;
+
+// value a node holds for an exact-match indexed field
+typedef struct {
+	IndexedValueType type;  // value kind
+	IndexKey key;           // indexed key, string keys are owned
+} IndexedValue;
+
+// state of an index constructed concurrently with writers
+typedef struct _IndexConstruction IndexConstruction;
+
 typedef struct {
 	char *label;                // Indexed label.
 	char **fields;              // Indexed fields.
 	Attribute_ID *fields_ids;   // Indexed field IDs.
 	uint fields_count;          // Number of fields.
-	RSIndex *idx;               // RediSearch index.
+	RSIndex *idx;               // RediSearch index, fulltext only.
+	IndexField *field_indices;  // Per field ordered indices, exact-match only.
+	rax *entities;              // Indexed values of each node, exact-match only.
+	IndexConstruction *construction;  // Pending concurrent construction, NULL if none.
 	IndexType type;             // Index type exact-match / fulltext.
+	GraphEntityType entity_type;  // Indexed entity type, node or edge.
+	rax *endpoints;             // Endpoints of each indexed edge, edge indices only.
 } Index;
 
+// iterator over the entity IDs matching an exact-match index query
+typedef struct _IndexIter IndexIter;
+
 /**
  * @brief  Create a new index.
- * @param  *label: Indexed label
+ * @param  *label: Indexed label or relationship type.
  * @param  type: Index type - exact match or full text.
+ * @param  entity_type: Indexed entity type, edges only support exact match.
  * @retval New constructed index for the label.
  */
-Index *Index_New(const char *label, IndexType type);
+Index *Index_New(const char *label, IndexType type, GraphEntityType entity_type);
 
 /**
  * @brief  Adds field to index.
@@ -66,12 +108,52 @@ void Index_IndexNode(Index *idx, const Node *n);
  */
 void Index_RemoveNode(Index *idx, const Node *n);
 
+/**
+ * @brief  Index edge.
+ * @param  *idx: Exact-match edge index.
+ * @param  *e: Edge, its source and destination node IDs must be set.
+ */
+void Index_IndexEdge(Index *idx, const Edge *e);
+
+/**
+ * @brief  Remove edge from index.
+ * @param  *idx: Exact-match edge index.
+ * @param  *e: Edge to remove.
+ */
+void Index_RemoveEdge(Index *idx, const Edge *e);
+
+/**
+ * @brief  Retrieve the endpoints of an indexed edge.
+ * @param  *idx: Exact-match edge index.
+ * @param  id: Indexed edge ID.
+ * @param  *src: [output] Edge source node ID.
+ * @param  *dest: [output] Edge destination node ID.
+ * @retval False if the edge isn't indexed.
+ */
+bool Index_GetEdgeEndpoints(const Index *idx, EdgeID id, NodeID *src, NodeID *dest);
+
 /**
  * @brief  Constructs index.
  * @param  *idx:
  */
 void Index_Construct(Index *idx);
 
+/**
+ * @brief  Constructs index concurrently with writers.
+ * @note   Caller must hold the graph's write lock, the index is populated
+ *         in the background and becomes operational once populated.
+ *         Full-text and edge indices are constructed synchronously.
+ * @param  *idx: Index to construct.
+ */
+void Index_ConstructAsync(Index *idx);
+
+/**
+ * @brief  Checks if index is fully populated.
+ * @param  *idx: Index.
+ * @retval False while the index is constructed in the background.
+ */
+bool Index_Operational(const Index *idx);
+
 /**
  * @brief  Query an index.
  * @param  *idx: Index.
@@ -81,6 +163,34 @@ void Index_Construct(Index *idx);
  */
 RSResultsIterator *Index_Query(const Index *idx, const char *query, char **err);
 
+/**
+ * @brief  Scan an exact-match index.
+ * @param  *idx: Exact-match index.
+ * @param  *q: Query to evaluate, ownership is transferred to the iterator.
+ * @retval Iterator over matching node or edge IDs.
+ */
+IndexIter *Index_Scan(const Index *idx, IndexQuery *q);
+
+/**
+ * @brief  Advance index iterator.
+ * @param  *it: Iterator.
+ * @param  *id: [output] Matching node or edge ID.
+ * @retval False once the iterator is depleted.
+ */
+bool IndexIter_Next(IndexIter *it, NodeID *id);
+
+/**
+ * @brief  Rewind index iterator to its first match.
+ * @param  *it: Iterator.
+ */
+void IndexIter_Reset(IndexIter *it);
+
+/**
+ * @brief  Free index iterator.
+ * @param  *it: Iterator.
+ */
+void IndexIter_Free(IndexIter *it);
+
 /**
  * @brief Return indexed label.
  * @param  *idx: Index.
@@ -111,6 +221,42 @@ const char **Index_GetFields(const Index *idx);
  */
 bool Index_ContainsAttribute(const Index *idx, Attribute_ID attribute_id);
 
+/**
+ * @brief  Returns number of entities held by an exact-match index.
+ * @param  *idx: Index.
+ * @retval Number of indexed entities, 0 for fulltext or unpopulated indices.
+ */
+uint64_t Index_EntityCount(const Index *idx);
+
+/**
+ * @brief  Returns number of distinct values held for an indexed field.
+ * @param  *idx: Exact-match index.
+ * @param  attribute_id: Indexed attribute ID.
+ * @retval Number of distinct values, 0 if unknown.
+ */
+uint64_t Index_DistinctValues(const Index *idx, Attribute_ID attribute_id);
+
+/**
+ * @brief  Classify a property value as an exact-match indexed value.
+ * @param  *iv: [output] Indexed value, string keys are copied.
+ * @param  *v: Property value, might be PROPERTY_NOTFOUND.
+ */
+void IndexedValue_Init(IndexedValue *iv, const SIValue *v);
+
+/**
+ * @brief  Free indexed value.
+ * @param  *iv: Indexed value.
+ */
+void IndexedValue_Free(IndexedValue *iv);
+
+/**
+ * @brief  Returns the ordered index holding field values of a given kind.
+ * @param  *field: Exact-match indexed field.
+ * @param  type: Value kind, other than IV_MISSING.
+ * @retval Ordered index.
+ */
+OrderedIndex *IndexField_GetTree(const IndexField *field, IndexedValueType type);
+
 /**
  * @brief  Free fulltext index.
  * @param  *idx: Index to drop.
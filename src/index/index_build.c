@@ -0,0 +1,327 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "index_build.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include "../util/thpool/pools.h"
+#include "../graph/entities/node.h"
+
+#include <string.h>
+
+// number of tasks per participating thread, evens out uneven ranges
+#define TASKS_PER_THREAD 4
+
+// minimum number of rows scanned by a single task
+#define ROWS_PER_TASK 16384
+
+// sorted output of a single scanned row range
+typedef struct {
+	OrderedIndexEntry **entries;  // sorted entries, per (field, value kind)
+	NodeID *ids;                  // indexed node IDs
+	IndexedValue **values;        // indexed values of each node in 'ids'
+} IndexBuildRun;
+
+struct _IndexBuild {
+	int label_id;          // indexed label
+	uint fields_count;     // number of indexed fields
+	Attribute_ID *attrs;   // indexed fields
+	IndexBuildRun *runs;   // runs scanned so far
+};
+
+// position of (field, value kind) within a run's entries
+static inline uint _Slot(uint field, IndexedValueType type) {
+	return field * IV_TYPE_COUNT + type;
+}
+
+//------------------------------------------------------------------------------
+// Scan
+//------------------------------------------------------------------------------
+
+typedef struct {
+	IndexBuild *build;  // build
+	Graph *g;           // scanned graph
+	GrB_Matrix L;       // label matrix
+	NodeID from;        // first scanned row
+	NodeID to;          // scan end, exclusive
+	uint task_count;    // number of tasks
+	uint first_run;     // position of the first task's run
+} ScanCtx;
+
+#define _numeric_lt(a, b) ((a)->key.d < (b)->key.d ||                   \
+		((a)->key.d == (b)->key.d && (a)->id < (b)->id))
+
+#define _string_lt(a, b) (strcmp((a)->key.s, (b)->key.s) < 0 ||          \
+		(strcmp((a)->key.s, (b)->key.s) == 0 && (a)->id < (b)->id))
+
+#define _point_lt(a, b) ((a)->key.p.lat < (b)->key.p.lat ||              \
+		((a)->key.p.lat == (b)->key.p.lat &&                             \
+		 ((a)->key.p.lon < (b)->key.p.lon ||                             \
+		  ((a)->key.p.lon == (b)->key.p.lon && (a)->id < (b)->id))))
+
+// none indexed entries share the same key and are scanned in ID order
+static void _SortEntries(OrderedIndexEntry *entries, IndexedValueType type) {
+	uint n = array_len(entries);
+	switch(type) {
+		case IV_NUMERIC:
+		case IV_BOOLEAN:
+			QSORT(OrderedIndexEntry, entries, n, _numeric_lt);
+			break;
+		case IV_STRING:
+			QSORT(OrderedIndexEntry, entries, n, _string_lt);
+			break;
+		case IV_POINT:
+			QSORT(OrderedIndexEntry, entries, n, _point_lt);
+			break;
+		default:
+			break;
+	}
+}
+
+static void _ScanTask(void *arg, uint task) {
+	ScanCtx *ctx = (ScanCtx *)arg;
+	IndexBuild *build = ctx->build;
+	IndexBuildRun *run = build->runs + ctx->first_run + task;
+
+	uint fields_count = build->fields_count;
+	uint slots = fields_count * IV_TYPE_COUNT;
+
+	run->ids = array_new(NodeID, 0);
+	run->values = array_new(IndexedValue *, 0);
+	run->entries = rm_malloc(sizeof(OrderedIndexEntry *) * slots);
+	for(uint i = 0; i < slots; i++) {
+		run->entries[i] = array_new(OrderedIndexEntry, 0);
+	}
+
+	NodeID span = ctx->to - ctx->from;
+	NodeID from = ctx->from + span * task / ctx->task_count;
+	NodeID to = ctx->from + span * (task + 1) / ctx->task_count;
+	if(from == to) return;
+
+	GrB_Index id;
+	GxB_MatrixTupleIter *it;
+	Node node = GE_NEW_NODE();
+	GxB_MatrixTupleIter_new(&it, ctx->L);
+	GxB_MatrixTupleIter_iterate_range(it, from, to - 1);
+
+	while(true) {
+		bool depleted = false;
+		GxB_MatrixTupleIter_next(it, NULL, &id, NULL, &depleted);
+		if(depleted) break;
+
+		Graph_GetNode(ctx->g, id, &node);
+
+		bool indexed = false;
+		IndexedValue *values = array_newlen(IndexedValue, fields_count);
+		for(uint i = 0; i < fields_count; i++) {
+			SIValue *v = GraphEntity_GetProperty((GraphEntity *)&node,
+					build->attrs[i]);
+			IndexedValue_Init(values + i, v);
+			if(values[i].type == IV_MISSING) continue;
+
+			OrderedIndexEntry e = {.key = values[i].key, .id = id};
+			array_append(run->entries[_Slot(i, values[i].type)], e);
+			indexed = true;
+		}
+
+		if(indexed) {
+			array_append(run->ids, id);
+			array_append(run->values, values);
+		} else {
+			// node doesn't poses any attributes which are indexed
+			array_free(values);
+		}
+	}
+	GxB_MatrixTupleIter_free(it);
+
+	// rows are scanned in ascending order, sort by value
+	for(uint i = 0; i < fields_count; i++) {
+		for(uint t = IV_NUMERIC; t < IV_TYPE_COUNT; t++) {
+			_SortEntries(run->entries[_Slot(i, t)], t);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Merge
+//------------------------------------------------------------------------------
+
+typedef struct {
+	IndexBuild *build;   // build
+	IndexField *fields;  // built fields
+} MergeCtx;
+
+// merge two sorted runs, frees both inputs
+static OrderedIndexEntry *_MergeRuns(OrderedIndexType type,
+		OrderedIndexEntry *a, OrderedIndexEntry *b) {
+	uint64_t i = 0;
+	uint64_t j = 0;
+	uint64_t a_len = array_len(a);
+	uint64_t b_len = array_len(b);
+	OrderedIndexEntry *merged = array_new(OrderedIndexEntry, a_len + b_len);
+
+	// runs cover disjoint node IDs, entries are never equal
+	while(i < a_len && j < b_len) {
+		int c = OrderedIndex_CompareKeys(type, &a[i].key, &b[j].key);
+		if(c < 0 || (c == 0 && a[i].id < b[j].id)) {
+			array_append(merged, a[i++]);
+		} else {
+			array_append(merged, b[j++]);
+		}
+	}
+	for(; i < a_len; i++) array_append(merged, a[i]);
+	for(; j < b_len; j++) array_append(merged, b[j]);
+
+	array_free(a);
+	array_free(b);
+	return merged;
+}
+
+// merge all runs of a single (field, value kind) and load its ordered index
+static void _MergeTask(void *arg, uint slot) {
+	MergeCtx *ctx = (MergeCtx *)arg;
+	IndexBuild *build = ctx->build;
+	IndexedValueType type = slot % IV_TYPE_COUNT;
+	if(type == IV_MISSING) return;
+
+	IndexField *field = ctx->fields + slot / IV_TYPE_COUNT;
+	OrderedIndex **tree;
+	switch(type) {
+		case IV_NUMERIC:  tree = &field->numeric;       break;
+		case IV_BOOLEAN:  tree = &field->boolean;       break;
+		case IV_STRING:   tree = &field->string;        break;
+		case IV_POINT:    tree = &field->point;         break;
+		default:          tree = &field->none_indexed;  break;
+	}
+	OrderedIndexType tree_type = (*tree)->type;
+
+	// merge runs pairwise, halving their number on every round
+	uint n = array_len(build->runs);
+	OrderedIndexEntry **runs = rm_malloc(sizeof(OrderedIndexEntry *) * n);
+	for(uint i = 0; i < n; i++) {
+		runs[i] = build->runs[i].entries[slot];
+		build->runs[i].entries[slot] = NULL;
+	}
+
+	while(n > 1) {
+		uint merged = 0;
+		for(uint i = 0; i < n; i += 2) {
+			if(i + 1 < n) runs[merged++] = _MergeRuns(tree_type, runs[i], runs[i + 1]);
+			else runs[merged++] = runs[i];
+		}
+		n = merged;
+	}
+
+	OrderedIndex_Free(*tree);
+	if(n == 0) {
+		*tree = OrderedIndex_New(tree_type);
+	} else {
+		*tree = OrderedIndex_Load(tree_type, runs[0], array_len(runs[0]));
+		array_free(runs[0]);
+	}
+	rm_free(runs);
+}
+
+//------------------------------------------------------------------------------
+// Build API
+//------------------------------------------------------------------------------
+
+IndexBuild *IndexBuild_New(const Index *idx, int label_id) {
+	ASSERT(idx != NULL);
+	ASSERT(idx->type == IDX_EXACT_MATCH);
+
+	IndexBuild *build = rm_malloc(sizeof(IndexBuild));
+	build->label_id = label_id;
+	build->fields_count = idx->fields_count;
+	build->attrs = array_new(Attribute_ID, idx->fields_count);
+	build->runs = array_new(IndexBuildRun, 0);
+	for(uint i = 0; i < idx->fields_count; i++) {
+		array_append(build->attrs, idx->fields_ids[i]);
+	}
+
+	return build;
+}
+
+void IndexBuild_Scan(IndexBuild *build, Graph *g, NodeID from, NodeID to) {
+	ASSERT(g != NULL);
+	ASSERT(build != NULL);
+	if(from >= to) return;
+
+	// split rows evenly across tasks
+	// avoid tasks too small to make up for their runs' merge
+	uint task_count = (ThreadPools_TaskCount() + 1) * TASKS_PER_THREAD;
+	uint64_t max_tasks = (to - from + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+	if(task_count > max_tasks) task_count = max_tasks;
+
+	ScanCtx ctx;
+	ctx.build = build;
+	ctx.g = g;
+	ctx.L = Graph_GetLabelMatrix(g, build->label_id);
+	ctx.from = from;
+	ctx.to = to;
+	ctx.task_count = task_count;
+	ctx.first_run = array_len(build->runs);
+
+	// each task fills its own run
+	for(uint i = 0; i < task_count; i++) {
+		IndexBuildRun run = {0};
+		array_append(build->runs, run);
+	}
+
+	ThreadPools_RunTasks(_ScanTask, &ctx, task_count);
+}
+
+void IndexBuild_Finalize(IndexBuild *build, IndexField *fields, rax *entities) {
+	ASSERT(build != NULL);
+	ASSERT(fields != NULL);
+	ASSERT(entities != NULL);
+
+	uint n = array_len(build->runs);
+
+	// merge each (field, value kind) on its own
+	MergeCtx ctx = {.build = build, .fields = fields};
+	ThreadPools_RunTasks(_MergeTask, &ctx, build->fields_count * IV_TYPE_COUNT);
+
+	// hand over node values, trees borrow their string keys
+	for(uint i = 0; i < n; i++) {
+		IndexBuildRun *run = build->runs + i;
+		uint count = array_len(run->ids);
+		for(uint j = 0; j < count; j++) {
+			raxInsert(entities, (unsigned char *)(run->ids + j), sizeof(NodeID),
+					run->values[j], NULL);
+		}
+		array_clear(run->values);
+	}
+}
+
+void IndexBuild_Free(IndexBuild *build) {
+	ASSERT(build != NULL);
+
+	uint slots = build->fields_count * IV_TYPE_COUNT;
+	for(uint i = 0; i < array_len(build->runs); i++) {
+		IndexBuildRun *run = build->runs + i;
+		for(uint j = 0; j < slots; j++) {
+			if(run->entries[j] != NULL) array_free(run->entries[j]);
+		}
+		for(uint j = 0; j < array_len(run->values); j++) {
+			IndexedValue *values = run->values[j];
+			for(uint k = 0; k < build->fields_count; k++) {
+				IndexedValue_Free(values + k);
+			}
+			array_free(values);
+		}
+		rm_free(run->entries);
+		array_free(run->ids);
+		array_free(run->values);
+	}
+
+	array_free(build->runs);
+	array_free(build->attrs);
+	rm_free(build);
+}
+
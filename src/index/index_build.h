@@ -0,0 +1,54 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "index.h"
+#include "../graph/graph.h"
+
+// IndexBuild populates an exact-match index out of its label matrix
+//
+// label matrix rows are partitioned into ranges which are scanned
+// concurrently by the task pool threads and the calling thread
+// each range produces a sorted run of entries per (field, value kind)
+// once scanning is done, runs are merged and bulk loaded into ordered indices
+//
+// a build may be scanned in several steps, e.g. releasing the graph's lock
+// in between, as long as rows are scanned at most once
+typedef struct _IndexBuild IndexBuild;
+
+// create a new build of 'idx' current fields over nodes labeled 'label_id'
+IndexBuild *IndexBuild_New
+(
+	const Index *idx,  // index to build
+	int label_id       // indexed label
+);
+
+// scan label matrix rows [from, to) into sorted runs
+// the graph must not be modified for the duration of the call
+void IndexBuild_Scan
+(
+	IndexBuild *build,  // build
+	Graph *g,           // graph to scan
+	NodeID from,        // first row to scan
+	NodeID to           // scan end, exclusive
+);
+
+// merge runs into the build fields' ordered indices and node values
+// 'fields' ordered indices are replaced and 'entities' is expected to be empty
+void IndexBuild_Finalize
+(
+	IndexBuild *build,   // build
+	IndexField *fields,  // fields of the built index, same order as on creation
+	rax *entities        // [output] indexed values of each node
+);
+
+// free build, releasing any values which weren't handed over
+void IndexBuild_Free
+(
+	IndexBuild *build
+);
+
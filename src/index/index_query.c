@@ -0,0 +1,141 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "index_query.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+static IndexQuery *_IndexQuery_New(IndexQueryType type, Attribute_ID attr) {
+	IndexQuery *q = rm_calloc(1, sizeof(IndexQuery));
+	q->type = type;
+	q->attr = attr;
+	return q;
+}
+
+IndexQuery *IndexQuery_NewEmpty(void) {
+	return _IndexQuery_New(IQ_EMPTY, ATTRIBUTE_NOTFOUND);
+}
+
+IndexQuery *IndexQuery_NewNumericRange
+(
+	Attribute_ID attr,
+	double min,
+	bool include_min,
+	double max,
+	bool include_max
+) {
+	IndexQuery *q = _IndexQuery_New(IQ_NUMERIC_RANGE, attr);
+	q->numeric.min          =  min;
+	q->numeric.max          =  max;
+	q->numeric.include_min  =  include_min;
+	q->numeric.include_max  =  include_max;
+	return q;
+}
+
+IndexQuery *IndexQuery_NewBooleanRange
+(
+	Attribute_ID attr,
+	double min,
+	bool include_min,
+	double max,
+	bool include_max
+) {
+	IndexQuery *q = _IndexQuery_New(IQ_BOOLEAN_RANGE, attr);
+	q->numeric.min          =  min;
+	q->numeric.max          =  max;
+	q->numeric.include_min  =  include_min;
+	q->numeric.include_max  =  include_max;
+	return q;
+}
+
+IndexQuery *IndexQuery_NewStringRange
+(
+	Attribute_ID attr,
+	const char *min,
+	bool include_min,
+	const char *max,
+	bool include_max
+) {
+	IndexQuery *q = _IndexQuery_New(IQ_STRING_RANGE, attr);
+	q->string.min          =  (min) ? rm_strdup(min) : NULL;
+	q->string.max          =  (max) ? rm_strdup(max) : NULL;
+	q->string.include_min  =  include_min;
+	q->string.include_max  =  include_max;
+	return q;
+}
+
+IndexQuery *IndexQuery_NewDistance
+(
+	Attribute_ID attr,
+	SIValue origin,
+	double radius,
+	bool include_radius
+) {
+	ASSERT(SI_TYPE(origin) == T_POINT);
+
+	IndexQuery *q = _IndexQuery_New(IQ_DISTANCE, attr);
+	q->distance.origin          =  origin;
+	q->distance.radius          =  radius;
+	q->distance.include_radius  =  include_radius;
+	return q;
+}
+
+IndexQuery *IndexQuery_NewNoneIndexed
+(
+	Attribute_ID attr
+) {
+	return _IndexQuery_New(IQ_NONE_INDEXED, attr);
+}
+
+IndexQuery *IndexQuery_NewUnion(void) {
+	IndexQuery *q = _IndexQuery_New(IQ_UNION, ATTRIBUTE_NOTFOUND);
+	q->children = array_new(IndexQuery *, 2);
+	return q;
+}
+
+IndexQuery *IndexQuery_NewIntersection(void) {
+	IndexQuery *q = _IndexQuery_New(IQ_INTERSECTION, ATTRIBUTE_NOTFOUND);
+	q->children = array_new(IndexQuery *, 2);
+	return q;
+}
+
+void IndexQuery_AddChild
+(
+	IndexQuery *q,
+	IndexQuery *child
+) {
+	ASSERT(q != NULL && child != NULL);
+	ASSERT(q->type == IQ_UNION || q->type == IQ_INTERSECTION);
+
+	array_append(q->children, child);
+}
+
+void IndexQuery_Free
+(
+	IndexQuery *q
+) {
+	ASSERT(q != NULL);
+
+	switch(q->type) {
+		case IQ_STRING_RANGE:
+			if(q->string.min) rm_free(q->string.min);
+			if(q->string.max) rm_free(q->string.max);
+			break;
+		case IQ_UNION:
+		case IQ_INTERSECTION:
+			for(uint i = 0; i < array_len(q->children); i++) {
+				IndexQuery_Free(q->children[i]);
+			}
+			array_free(q->children);
+			break;
+		default:
+			break;
+	}
+
+	rm_free(q);
+}
+
@@ -0,0 +1,121 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../value.h"
+#include "../graph/entities/graph_entity.h"
+
+// exact-match index query tree
+// leaves scan a single indexed attribute
+// inner nodes combine their children's results
+typedef enum {
+	IQ_EMPTY,          // matches nothing
+	IQ_NUMERIC_RANGE,  // numeric values within range
+	IQ_BOOLEAN_RANGE,  // boolean values within range, false = 0, true = 1
+	IQ_STRING_RANGE,   // string values within range
+	IQ_DISTANCE,       // points within distance from origin
+	IQ_NONE_INDEXED,   // entities holding a none indexable value
+	IQ_UNION,          // entities matching any child
+	IQ_INTERSECTION,   // entities matching all children
+} IndexQueryType;
+
+typedef struct _IndexQuery IndexQuery;
+
+struct _IndexQuery {
+	IndexQueryType type;  // query type
+	Attribute_ID attr;    // queried attribute, leaves only
+	union {
+		struct {
+			double min;
+			double max;
+			bool include_min;
+			bool include_max;
+		} numeric;              // IQ_NUMERIC_RANGE, IQ_BOOLEAN_RANGE
+		struct {
+			char *min;          // NULL if unbounded
+			char *max;          // NULL if unbounded
+			bool include_min;
+			bool include_max;
+		} string;               // IQ_STRING_RANGE
+		struct {
+			SIValue origin;     // circle center
+			double radius;      // circle radius in meters
+			bool include_radius;
+		} distance;             // IQ_DISTANCE
+		IndexQuery **children;  // IQ_UNION, IQ_INTERSECTION
+	};
+};
+
+// create a query matching nothing
+IndexQuery *IndexQuery_NewEmpty(void);
+
+// create a numeric range query, use -/+INFINITY for unbounded ends
+IndexQuery *IndexQuery_NewNumericRange
+(
+	Attribute_ID attr,
+	double min,
+	bool include_min,
+	double max,
+	bool include_max
+);
+
+// create a boolean range query, use -/+INFINITY for unbounded ends
+// false is represented as 0, true as 1
+IndexQuery *IndexQuery_NewBooleanRange
+(
+	Attribute_ID attr,
+	double min,
+	bool include_min,
+	double max,
+	bool include_max
+);
+
+// create a string range query, use NULL for unbounded ends
+// bounds are copied
+IndexQuery *IndexQuery_NewStringRange
+(
+	Attribute_ID attr,
+	const char *min,
+	bool include_min,
+	const char *max,
+	bool include_max
+);
+
+// create a query matching points within 'radius' meters from 'origin'
+IndexQuery *IndexQuery_NewDistance
+(
+	Attribute_ID attr,
+	SIValue origin,
+	double radius,
+	bool include_radius
+);
+
+// create a query matching entities holding a none indexable value
+IndexQuery *IndexQuery_NewNoneIndexed
+(
+	Attribute_ID attr
+);
+
+// create a union query
+IndexQuery *IndexQuery_NewUnion(void);
+
+// create an intersection query
+IndexQuery *IndexQuery_NewIntersection(void);
+
+// add child to either a union or an intersection query
+void IndexQuery_AddChild
+(
+	IndexQuery *q,
+	IndexQuery *child
+);
+
+// free query
+void IndexQuery_Free
+(
+	IndexQuery *q
+);
+
@@ -0,0 +1,611 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "ordered_index.h"
+#include "../util/rmalloc.h"
+
+#include <string.h>
+
+// bulk loaded nodes are filled to 3/4 of their capacity
+// leaving room for subsequent inserts before nodes split
+#define OI_LOAD_FILL (OI_NODE_CAPACITY * 3 / 4)
+
+// common header of both leaf and inner nodes
+struct _OrderedIndexNode {
+	bool leaf;       // node is a leaf
+	uint16_t count;  // number of entries (leaf) or children (inner)
+};
+
+struct _OrderedIndexLeaf {
+	OrderedIndexNode node;
+	OrderedIndexLeaf *prev;                         // previous leaf
+	OrderedIndexLeaf *next;                         // next leaf
+	OrderedIndexEntry entries[OI_NODE_CAPACITY];    // sorted entries
+};
+
+// keys[i] is a lower bound for all entries under children[i]
+// keys[0] is never used, separators of string trees are owned by the node
+typedef struct {
+	OrderedIndexNode node;
+	OrderedIndexEntry keys[OI_NODE_CAPACITY];       // separators
+	OrderedIndexNode *children[OI_NODE_CAPACITY];   // child nodes
+} OrderedIndexInner;
+
+int OrderedIndex_CompareKeys
+(
+	OrderedIndexType type,
+	const IndexKey *a,
+	const IndexKey *b
+) {
+	switch(type) {
+		case OI_NUMERIC:
+			return (a->d > b->d) - (a->d < b->d);
+		case OI_STRING:
+			return strcmp(a->s, b->s);
+		case OI_POINT:
+			if(a->p.lat != b->p.lat) return (a->p.lat > b->p.lat) ? 1 : -1;
+			return (a->p.lon > b->p.lon) - (a->p.lon < b->p.lon);
+		default:
+			ASSERT(false);
+			return 0;
+	}
+}
+
+static inline int _CompareEntries
+(
+	OrderedIndexType type,
+	const OrderedIndexEntry *a,
+	const OrderedIndexEntry *b
+) {
+	int c = OrderedIndex_CompareKeys(type, &a->key, &b->key);
+	if(c != 0) return c;
+	return (a->id > b->id) - (a->id < b->id);
+}
+
+// separators of string trees outlive the entries they were copied from
+static inline void _CopySeparator
+(
+	OrderedIndexType type,
+	OrderedIndexEntry *dest,
+	const OrderedIndexEntry *src
+) {
+	*dest = *src;
+	if(type == OI_STRING) dest->key.s = rm_strdup(src->key.s);
+}
+
+static inline void _FreeSeparator
+(
+	OrderedIndexType type,
+	OrderedIndexEntry *sep
+) {
+	if(type == OI_STRING) rm_free((char *)sep->key.s);
+}
+
+static OrderedIndexLeaf *_NewLeaf(void) {
+	OrderedIndexLeaf *leaf = rm_malloc(sizeof(OrderedIndexLeaf));
+	leaf->node.leaf = true;
+	leaf->node.count = 0;
+	leaf->prev = NULL;
+	leaf->next = NULL;
+	return leaf;
+}
+
+static OrderedIndexInner *_NewInner(void) {
+	OrderedIndexInner *inner = rm_malloc(sizeof(OrderedIndexInner));
+	inner->node.leaf = false;
+	inner->node.count = 0;
+	return inner;
+}
+
+// position of the first entry in leaf which is >= e
+static uint16_t _LeafLowerBound
+(
+	OrderedIndexType type,
+	const OrderedIndexLeaf *leaf,
+	const OrderedIndexEntry *e
+) {
+	uint16_t lo = 0;
+	uint16_t hi = leaf->node.count;
+	while(lo < hi) {
+		uint16_t mid = (lo + hi) / 2;
+		if(_CompareEntries(type, leaf->entries + mid, e) < 0) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+// index of the child whose range covers e
+static uint16_t _InnerChild
+(
+	OrderedIndexType type,
+	const OrderedIndexInner *inner,
+	const OrderedIndexEntry *e
+) {
+	// find the first separator > e, skipping unused keys[0]
+	uint16_t lo = 1;
+	uint16_t hi = inner->node.count;
+	while(lo < hi) {
+		uint16_t mid = (lo + hi) / 2;
+		if(_CompareEntries(type, inner->keys + mid, e) <= 0) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo - 1;
+}
+
+static void _LeafInsertAt
+(
+	OrderedIndexLeaf *leaf,
+	uint16_t pos,
+	const OrderedIndexEntry *e
+) {
+	ASSERT(leaf->node.count < OI_NODE_CAPACITY);
+	memmove(leaf->entries + pos + 1, leaf->entries + pos,
+			(leaf->node.count - pos) * sizeof(OrderedIndexEntry));
+	leaf->entries[pos] = *e;
+	leaf->node.count++;
+}
+
+static void _InnerInsertAt
+(
+	OrderedIndexInner *inner,
+	uint16_t pos,
+	const OrderedIndexEntry *sep,
+	OrderedIndexNode *child
+) {
+	ASSERT(pos > 0);
+	ASSERT(inner->node.count < OI_NODE_CAPACITY);
+	uint16_t n = inner->node.count - pos;
+	memmove(inner->keys + pos + 1, inner->keys + pos,
+			n * sizeof(OrderedIndexEntry));
+	memmove(inner->children + pos + 1, inner->children + pos,
+			n * sizeof(OrderedIndexNode *));
+	inner->keys[pos] = *sep;
+	inner->children[pos] = child;
+	inner->node.count++;
+}
+
+// insert e under node
+// returns a new right sibling if node had to be split, in which case
+// 'sep' is set to the sibling's lower bound
+static OrderedIndexNode *_Insert
+(
+	OrderedIndex *idx,
+	OrderedIndexNode *node,
+	const OrderedIndexEntry *e,
+	OrderedIndexEntry *sep,
+	bool *inserted
+) {
+	OrderedIndexType type = idx->type;
+	uint16_t half = OI_NODE_CAPACITY / 2;
+
+	if(node->leaf) {
+		OrderedIndexLeaf *leaf = (OrderedIndexLeaf *)node;
+		uint16_t pos = _LeafLowerBound(type, leaf, e);
+
+		// entry already indexed
+		if(pos < node->count && _CompareEntries(type, leaf->entries + pos, e) == 0) {
+			*inserted = false;
+			return NULL;
+		}
+
+		*inserted = true;
+		if(node->count < OI_NODE_CAPACITY) {
+			_LeafInsertAt(leaf, pos, e);
+			return NULL;
+		}
+
+		// leaf is full, move upper half into a new right sibling
+		OrderedIndexLeaf *right = _NewLeaf();
+		memcpy(right->entries, leaf->entries + half,
+				(OI_NODE_CAPACITY - half) * sizeof(OrderedIndexEntry));
+		right->node.count = OI_NODE_CAPACITY - half;
+		leaf->node.count = half;
+
+		right->prev = leaf;
+		right->next = leaf->next;
+		if(leaf->next) leaf->next->prev = right;
+		leaf->next = right;
+
+		if(pos <= half) _LeafInsertAt(leaf, pos, e);
+		else _LeafInsertAt(right, pos - half, e);
+
+		_CopySeparator(type, sep, right->entries);
+		return (OrderedIndexNode *)right;
+	}
+
+	OrderedIndexInner *inner = (OrderedIndexInner *)node;
+	uint16_t i = _InnerChild(type, inner, e);
+
+	OrderedIndexEntry child_sep;
+	OrderedIndexNode *child = _Insert(idx, inner->children[i], e, &child_sep,
+			inserted);
+	if(child == NULL) return NULL;
+
+	// child split, introduce its new sibling at position i + 1
+	if(node->count < OI_NODE_CAPACITY) {
+		_InnerInsertAt(inner, i + 1, &child_sep, child);
+		return NULL;
+	}
+
+	// inner node is full, move upper half into a new right sibling
+	// the first separator moved is handed over to the parent
+	OrderedIndexInner *right = _NewInner();
+	memcpy(right->keys, inner->keys + half,
+			(OI_NODE_CAPACITY - half) * sizeof(OrderedIndexEntry));
+	memcpy(right->children, inner->children + half,
+			(OI_NODE_CAPACITY - half) * sizeof(OrderedIndexNode *));
+	right->node.count = OI_NODE_CAPACITY - half;
+	inner->node.count = half;
+
+	*sep = right->keys[0];
+	memset(right->keys, 0, sizeof(OrderedIndexEntry));
+
+	if(i + 1 <= half) _InnerInsertAt(inner, i + 1, &child_sep, child);
+	else _InnerInsertAt(right, i + 1 - half, &child_sep, child);
+
+	return (OrderedIndexNode *)right;
+}
+
+static void _FreeNode
+(
+	OrderedIndexType type,
+	OrderedIndexNode *node
+) {
+	if(!node->leaf) {
+		OrderedIndexInner *inner = (OrderedIndexInner *)node;
+		for(uint16_t i = 0; i < node->count; i++) {
+			if(i > 0) _FreeSeparator(type, inner->keys + i);
+			_FreeNode(type, inner->children[i]);
+		}
+	}
+	rm_free(node);
+}
+
+// remove e from under node
+// returns true if node is left empty
+static bool _Delete
+(
+	OrderedIndex *idx,
+	OrderedIndexNode *node,
+	const OrderedIndexEntry *e,
+	bool *deleted
+) {
+	OrderedIndexType type = idx->type;
+
+	if(node->leaf) {
+		OrderedIndexLeaf *leaf = (OrderedIndexLeaf *)node;
+		uint16_t pos = _LeafLowerBound(type, leaf, e);
+		if(pos == node->count ||
+		   _CompareEntries(type, leaf->entries + pos, e) != 0) {
+			*deleted = false;
+			return false;
+		}
+
+		*deleted = true;
+		node->count--;
+		memmove(leaf->entries + pos, leaf->entries + pos + 1,
+				(node->count - pos) * sizeof(OrderedIndexEntry));
+		return node->count == 0;
+	}
+
+	OrderedIndexInner *inner = (OrderedIndexInner *)node;
+	uint16_t i = _InnerChild(type, inner, e);
+	OrderedIndexNode *child = inner->children[i];
+	if(!_Delete(idx, child, e, deleted)) return false;
+
+	// child is empty, detach it
+	// nodes aren't rebalanced, separators remain valid lower bounds
+	if(child->leaf) {
+		OrderedIndexLeaf *leaf = (OrderedIndexLeaf *)child;
+		if(leaf->prev) leaf->prev->next = leaf->next;
+		if(leaf->next) leaf->next->prev = leaf->prev;
+	}
+	rm_free(child);
+
+	if(i > 0) _FreeSeparator(type, inner->keys + i);
+	else if(node->count > 1) _FreeSeparator(type, inner->keys + 1);
+
+	node->count--;
+	uint16_t n = node->count - i;
+	memmove(inner->keys + i, inner->keys + i + 1,
+			n * sizeof(OrderedIndexEntry));
+	memmove(inner->children + i, inner->children + i + 1,
+			n * sizeof(OrderedIndexNode *));
+	memset(inner->keys, 0, sizeof(OrderedIndexEntry));
+
+	return node->count == 0;
+}
+
+OrderedIndex *OrderedIndex_New
+(
+	OrderedIndexType type
+) {
+	OrderedIndex *idx = rm_malloc(sizeof(OrderedIndex));
+	idx->root  = (OrderedIndexNode *)_NewLeaf();
+	idx->type  = type;
+	idx->count = 0;
+	idx->distinct = 0;
+	return idx;
+}
+
+// returns true if any entry holds 'key'
+static bool _ContainsKey
+(
+	const OrderedIndex *idx,
+	const IndexKey *key
+) {
+	OrderedIndexIterator it;
+	OrderedIndex_Seek(idx, &it, key, true, key, true);
+	return OrderedIndexIterator_Next(&it, NULL, NULL);
+}
+
+bool OrderedIndex_Insert
+(
+	OrderedIndex *idx,
+	IndexKey key,
+	NodeID id
+) {
+	ASSERT(idx != NULL);
+
+	bool inserted;
+	bool new_key = !_ContainsKey(idx, &key);
+	OrderedIndexEntry sep;
+	OrderedIndexEntry e = {.key = key, .id = id};
+	OrderedIndexNode *right = _Insert(idx, idx->root, &e, &sep, &inserted);
+
+	// root split, grow tree
+	if(right != NULL) {
+		OrderedIndexInner *root = _NewInner();
+		memset(root->keys, 0, sizeof(OrderedIndexEntry));
+		root->children[0] = idx->root;
+		root->children[1] = right;
+		root->keys[1] = sep;
+		root->node.count = 2;
+		idx->root = (OrderedIndexNode *)root;
+	}
+
+	if(inserted) {
+		idx->count++;
+		if(new_key) idx->distinct++;
+	}
+	return inserted;
+}
+
+bool OrderedIndex_Delete
+(
+	OrderedIndex *idx,
+	IndexKey key,
+	NodeID id
+) {
+	ASSERT(idx != NULL);
+
+	bool deleted;
+	OrderedIndexEntry e = {.key = key, .id = id};
+	bool empty = _Delete(idx, idx->root, &e, &deleted);
+
+	if(empty && !idx->root->leaf) {
+		rm_free(idx->root);
+		idx->root = (OrderedIndexNode *)_NewLeaf();
+	}
+
+	// shrink tree while root has a single child
+	while(!idx->root->leaf && idx->root->count == 1) {
+		OrderedIndexInner *root = (OrderedIndexInner *)idx->root;
+		idx->root = root->children[0];
+		rm_free(root);
+	}
+
+	if(deleted) {
+		idx->count--;
+		if(!_ContainsKey(idx, &key)) idx->distinct--;
+	}
+	return deleted;
+}
+
+// group 'n' nodes under ceil(n / OI_LOAD_FILL) new inner nodes
+// 'lower' holds the lower bound of each node and is updated in place
+// to hold the lower bounds of the new level, returns the new level's size
+static uint64_t _LoadInnerLevel
+(
+	OrderedIndexType type,
+	OrderedIndexNode **level,
+	OrderedIndexEntry *lower,
+	uint64_t n
+) {
+	uint64_t parents = (n + OI_LOAD_FILL - 1) / OI_LOAD_FILL;
+
+	for(uint64_t i = 0; i < parents; i++) {
+		// spread children evenly, every parent gets at least two
+		// as long as there are at least two children
+		uint64_t from = n * i / parents;
+		uint64_t to = n * (i + 1) / parents;
+
+		OrderedIndexInner *inner = _NewInner();
+		memset(inner->keys, 0, sizeof(OrderedIndexEntry));
+		for(uint64_t j = from; j < to; j++) {
+			uint16_t k = j - from;
+			inner->children[k] = level[j];
+			if(k > 0) _CopySeparator(type, inner->keys + k, lower + j);
+		}
+		inner->node.count = to - from;
+
+		// 'from' >= i, entries aren't overwritten before they're consumed
+		level[i] = (OrderedIndexNode *)inner;
+		lower[i] = lower[from];
+	}
+
+	return parents;
+}
+
+OrderedIndex *OrderedIndex_Load
+(
+	OrderedIndexType type,
+	const OrderedIndexEntry *entries,
+	uint64_t n
+) {
+	ASSERT(entries != NULL || n == 0);
+
+	OrderedIndex *idx = OrderedIndex_New(type);
+	if(n == 0) return idx;
+
+	// fill leaves up to OI_LOAD_FILL entries, linking them left to right
+	uint64_t count = (n + OI_LOAD_FILL - 1) / OI_LOAD_FILL;
+	OrderedIndexNode **level = rm_malloc(sizeof(OrderedIndexNode *) * count);
+	OrderedIndexEntry *lower = rm_malloc(sizeof(OrderedIndexEntry) * count);
+
+	OrderedIndexLeaf *prev = NULL;
+	for(uint64_t i = 0; i < count; i++) {
+		uint64_t from = n * i / count;
+		uint64_t to = n * (i + 1) / count;
+
+		OrderedIndexLeaf *leaf = (i == 0) ? (OrderedIndexLeaf *)idx->root :
+			_NewLeaf();
+		memcpy(leaf->entries, entries + from,
+				(to - from) * sizeof(OrderedIndexEntry));
+		leaf->node.count = to - from;
+
+		leaf->prev = prev;
+		if(prev) prev->next = leaf;
+		prev = leaf;
+
+		level[i] = (OrderedIndexNode *)leaf;
+		lower[i] = entries[from];
+	}
+
+	// build inner levels bottom-up until a single root remains
+	while(count > 1) count = _LoadInnerLevel(type, level, lower, count);
+
+	idx->root = level[0];
+	idx->count = n;
+
+	// entries are sorted, count key transitions
+	idx->distinct = 1;
+	for(uint64_t i = 1; i < n; i++) {
+		if(OrderedIndex_CompareKeys(type, &entries[i - 1].key,
+					&entries[i].key) != 0) {
+			idx->distinct++;
+		}
+	}
+
+	rm_free(level);
+	rm_free(lower);
+	return idx;
+}
+
+uint64_t OrderedIndex_Count
+(
+	const OrderedIndex *idx
+) {
+	ASSERT(idx != NULL);
+	return idx->count;
+}
+
+uint64_t OrderedIndex_DistinctCount
+(
+	const OrderedIndex *idx
+) {
+	ASSERT(idx != NULL);
+	return idx->distinct;
+}
+
+// returns current iterator entry without advancing, NULL if depleted
+static const OrderedIndexEntry *_Iterator_Peek
+(
+	OrderedIndexIterator *it
+) {
+	while(it->leaf != NULL && it->pos >= it->leaf->node.count) {
+		it->leaf = it->leaf->next;
+		it->pos = 0;
+	}
+
+	if(it->leaf == NULL) return NULL;
+
+	const OrderedIndexEntry *e = it->leaf->entries + it->pos;
+	if(it->bounded) {
+		int c = OrderedIndex_CompareKeys(it->idx->type, &e->key, &it->max);
+		if(c > 0 || (c == 0 && !it->include_max)) {
+			it->leaf = NULL;
+			return NULL;
+		}
+	}
+
+	return e;
+}
+
+void OrderedIndex_Seek
+(
+	const OrderedIndex *idx,
+	OrderedIndexIterator *it,
+	const IndexKey *min,
+	bool include_min,
+	const IndexKey *max,
+	bool include_max
+) {
+	ASSERT(it  != NULL);
+	ASSERT(idx != NULL);
+
+	it->idx = idx;
+	it->pos = 0;
+	it->bounded = (max != NULL);
+	it->include_max = include_max;
+	if(max != NULL) it->max = *max;
+
+	OrderedIndexNode *node = idx->root;
+	if(min == NULL) {
+		// unbounded, start at the leftmost leaf
+		while(!node->leaf) node = ((OrderedIndexInner *)node)->children[0];
+		it->leaf = (OrderedIndexLeaf *)node;
+		return;
+	}
+
+	// descend towards the smallest entry holding 'min'
+	OrderedIndexEntry e = {.key = *min, .id = 0};
+	while(!node->leaf) {
+		OrderedIndexInner *inner = (OrderedIndexInner *)node;
+		node = inner->children[_InnerChild(idx->type, inner, &e)];
+	}
+
+	it->leaf = (OrderedIndexLeaf *)node;
+	it->pos = _LeafLowerBound(idx->type, it->leaf, &e);
+
+	if(include_min) return;
+
+	// skip entries equal to an exclusive lower bound
+	const OrderedIndexEntry *current;
+	while((current = _Iterator_Peek(it)) != NULL &&
+		  OrderedIndex_CompareKeys(idx->type, &current->key, min) == 0) {
+		it->pos++;
+	}
+}
+
+bool OrderedIndexIterator_Next
+(
+	OrderedIndexIterator *it,
+	IndexKey *key,
+	NodeID *id
+) {
+	ASSERT(it != NULL);
+
+	const OrderedIndexEntry *e = _Iterator_Peek(it);
+	if(e == NULL) return false;
+
+	if(key) *key = e->key;
+	if(id) *id = e->id;
+	it->pos++;
+
+	return true;
+}
+
+void OrderedIndex_Free
+(
+	OrderedIndex *idx
+) {
+	ASSERT(idx != NULL);
+	_FreeNode(idx->type, idx->root);
+	rm_free(idx);
+}
+
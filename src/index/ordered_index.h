@@ -0,0 +1,146 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../graph/entities/graph_entity.h"
+
+// OrderedIndex is an in-memory B+tree mapping (key, NodeID) pairs
+// entries are kept sorted by key and then by node ID within leaves of
+// OI_NODE_CAPACITY entries, leaves are linked to allow range scans
+// without revisiting inner nodes
+//
+// each tree is specialized to a single key type:
+// OI_NUMERIC - double keys, used for numeric and boolean values
+// OI_STRING  - NULL terminated string keys, compared via strcmp
+// OI_POINT   - (latitude, longitude) keys, ordered by latitude first
+
+#define OI_NODE_CAPACITY 64
+
+typedef enum {
+	OI_NUMERIC = 0,
+	OI_STRING  = 1,
+	OI_POINT   = 2,
+} OrderedIndexType;
+
+typedef union {
+	double d;       // numeric key
+	const char *s;  // string key
+	struct {
+		float lat;  // point latitude
+		float lon;  // point longitude
+	} p;            // point key
+} IndexKey;
+
+typedef struct {
+	IndexKey key;   // indexed value
+	NodeID id;      // indexed entity
+} OrderedIndexEntry;
+
+typedef struct _OrderedIndexNode OrderedIndexNode;
+typedef struct _OrderedIndexLeaf OrderedIndexLeaf;
+
+typedef struct {
+	OrderedIndexNode *root;  // tree root
+	OrderedIndexType type;   // key type
+	uint64_t count;          // number of entries
+	uint64_t distinct;       // number of distinct keys
+} OrderedIndex;
+
+typedef struct {
+	const OrderedIndex *idx;  // scanned index
+	OrderedIndexLeaf *leaf;   // current leaf
+	uint16_t pos;             // position within current leaf
+	bool bounded;             // scan has an upper bound
+	bool include_max;         // upper bound is inclusive
+	IndexKey max;             // upper bound
+} OrderedIndexIterator;
+
+// create a new empty index of given key type
+OrderedIndex *OrderedIndex_New
+(
+	OrderedIndexType type
+);
+
+// create an index out of 'n' entries sorted by key and then by node ID
+// entries must be unique, string keys are borrowed as in OrderedIndex_Insert
+// nodes are built bottom-up, which is considerably cheaper than inserting
+// entries one by one
+OrderedIndex *OrderedIndex_Load
+(
+	OrderedIndexType type,
+	const OrderedIndexEntry *entries,
+	uint64_t n
+);
+
+// insert (key, id) into index
+// string keys are borrowed, the caller must keep the string alive
+// until the entry is deleted from the index
+// returns false if the entry is already indexed
+bool OrderedIndex_Insert
+(
+	OrderedIndex *idx,
+	IndexKey key,
+	NodeID id
+);
+
+// remove (key, id) from index
+// returns false if the entry isn't indexed
+bool OrderedIndex_Delete
+(
+	OrderedIndex *idx,
+	IndexKey key,
+	NodeID id
+);
+
+// returns number of entries in index
+uint64_t OrderedIndex_Count
+(
+	const OrderedIndex *idx
+);
+
+// returns number of distinct keys in index
+uint64_t OrderedIndex_DistinctCount
+(
+	const OrderedIndex *idx
+);
+
+// position iterator at the first entry with key within [min, max]
+// a NULL bound is treated as unbounded
+void OrderedIndex_Seek
+(
+	const OrderedIndex *idx,     // index to scan
+	OrderedIndexIterator *it,    // iterator to initialize
+	const IndexKey *min,         // lower bound
+	bool include_min,            // lower bound is inclusive
+	const IndexKey *max,         // upper bound
+	bool include_max             // upper bound is inclusive
+);
+
+// advance iterator, returns false once the range is depleted
+bool OrderedIndexIterator_Next
+(
+	OrderedIndexIterator *it,  // iterator
+	IndexKey *key,             // [optional out] entry key
+	NodeID *id                 // [optional out] entry node ID
+);
+
+// compare two keys of the given type
+int OrderedIndex_CompareKeys
+(
+	OrderedIndexType type,
+	const IndexKey *a,
+	const IndexKey *b
+);
+
+// free index
+void OrderedIndex_Free
+(
+	OrderedIndex *idx
+);
+
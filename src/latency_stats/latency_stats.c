@@ -0,0 +1,119 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "latency_stats.h"
+#include "RG.h"
+#include "../util/rmalloc.h"
+#include <stdio.h>
+
+// reported percentiles
+static const double percentiles[] = {50, 90, 99, 99.9};
+static const char *percentile_names[] = {"p50", "p90", "p99", "p999"};
+#define PERCENTILE_COUNT (sizeof(percentiles) / sizeof(percentiles[0]))
+
+static const char *class_names[QUERY_CLASS_COUNT] = {"read", "write"};
+static const char *stage_names[LATENCY_STAGE_COUNT] = {"queue", "lock",
+	"execution", "reply"};
+
+// reply with a duration given in microseconds, in milliseconds
+static void _ReplyWithMs(RedisModuleCtx *ctx, double us) {
+	char str[32];
+	int len = snprintf(str, sizeof(str), "%.3f", us / 1000);
+	RedisModule_ReplyWithStringBuffer(ctx, str, len);
+}
+
+LatencyStats *LatencyStats_New(void) {
+	LatencyStats *stats = rm_malloc(sizeof(LatencyStats));
+	for(uint i = 0; i < QUERY_CLASS_COUNT; i++) {
+		for(uint j = 0; j < LATENCY_STAGE_COUNT; j++) {
+			Histogram_Init(&stats->histograms[i][j]);
+		}
+	}
+	return stats;
+}
+
+void LatencyStats_Record(LatencyStats *stats, QueryClass query_class,
+		LatencyStage stage, double ms) {
+	ASSERT(stats != NULL);
+	ASSERT(query_class < QUERY_CLASS_COUNT);
+	ASSERT(stage < LATENCY_STAGE_COUNT);
+
+	if(ms < 0) ms = 0;
+	Histogram_Record(&stats->histograms[query_class][stage], ms * 1000);
+}
+
+void LatencyStats_Merge(LatencyStats *total, const LatencyStats *stats) {
+	ASSERT(total != NULL);
+	ASSERT(stats != NULL);
+
+	for(uint i = 0; i < QUERY_CLASS_COUNT; i++) {
+		for(uint j = 0; j < LATENCY_STAGE_COUNT; j++) {
+			Histogram *dest = &total->histograms[i][j];
+			const Histogram *src = &stats->histograms[i][j];
+			dest->count += __atomic_load_n(&src->count, __ATOMIC_RELAXED);
+			dest->sum += __atomic_load_n(&src->sum, __ATOMIC_RELAXED);
+			uint64_t max = Histogram_Max(src);
+			if(max > dest->max) dest->max = max;
+			for(uint k = 0; k < HISTOGRAM_BUCKET_COUNT; k++) {
+				dest->buckets[k] += __atomic_load_n(src->buckets + k,
+						__ATOMIC_RELAXED);
+			}
+		}
+	}
+}
+
+void LatencyStats_Replay(const LatencyStats *stats, RedisModuleCtx *ctx) {
+	ASSERT(stats != NULL);
+
+	RedisModule_ReplyWithArray(ctx, QUERY_CLASS_COUNT * LATENCY_STAGE_COUNT);
+	for(uint i = 0; i < QUERY_CLASS_COUNT; i++) {
+		for(uint j = 0; j < LATENCY_STAGE_COUNT; j++) {
+			const Histogram *h = &stats->histograms[i][j];
+
+			// class, stage, count, mean, percentiles, max
+			RedisModule_ReplyWithArray(ctx, 5 + PERCENTILE_COUNT);
+			RedisModule_ReplyWithCString(ctx, class_names[i]);
+			RedisModule_ReplyWithCString(ctx, stage_names[j]);
+			RedisModule_ReplyWithLongLong(ctx, Histogram_Count(h));
+			_ReplyWithMs(ctx, Histogram_Mean(h));
+			for(uint k = 0; k < PERCENTILE_COUNT; k++) {
+				_ReplyWithMs(ctx, Histogram_Percentile(h, percentiles[k]));
+			}
+			_ReplyWithMs(ctx, Histogram_Max(h));
+		}
+	}
+}
+
+void LatencyStats_AddInfoFields(const LatencyStats *stats,
+		RedisModuleInfoCtx *ctx) {
+	ASSERT(stats != NULL);
+
+	char name[64];
+	for(uint i = 0; i < QUERY_CLASS_COUNT; i++) {
+		for(uint j = 0; j < LATENCY_STAGE_COUNT; j++) {
+			const Histogram *h = &stats->histograms[i][j];
+
+			// e.g. read_queue_usec:count=10,mean=2.5,p50=2,...,max=9
+			snprintf(name, sizeof(name), "%s_%s_usec", class_names[i],
+					stage_names[j]);
+			RedisModule_InfoBeginDictField(ctx, name);
+			RedisModule_InfoAddFieldULongLong(ctx, "count", Histogram_Count(h));
+			RedisModule_InfoAddFieldDouble(ctx, "mean", Histogram_Mean(h));
+			for(uint k = 0; k < PERCENTILE_COUNT; k++) {
+				RedisModule_InfoAddFieldULongLong(ctx,
+						(char *)percentile_names[k],
+						Histogram_Percentile(h, percentiles[k]));
+			}
+			RedisModule_InfoAddFieldULongLong(ctx, "max", Histogram_Max(h));
+			RedisModule_InfoEndDictField(ctx);
+		}
+	}
+}
+
+void LatencyStats_Free(LatencyStats *stats) {
+	if(stats == NULL) return;
+	rm_free(stats);
+}
@@ -0,0 +1,71 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../redismodule.h"
+#include "../util/histogram.h"
+
+// query classes, each scheduled on its own thread pool
+typedef enum {
+	QUERY_CLASS_READ,          // read-only queries
+	QUERY_CLASS_WRITE,         // write queries
+	QUERY_CLASS_COUNT
+} QueryClass;
+
+// stages of query processing
+typedef enum {
+	LATENCY_STAGE_QUEUE,       // enqueued until a worker thread picked the query
+	LATENCY_STAGE_LOCK,        // waiting for the graph lock
+	LATENCY_STAGE_EXECUTION,   // executing the query
+	LATENCY_STAGE_REPLY,       // replying with the result-set
+	LATENCY_STAGE_COUNT
+} LatencyStage;
+
+// latency histograms, in microseconds, per query class and stage
+typedef struct {
+	Histogram histograms[QUERY_CLASS_COUNT][LATENCY_STAGE_COUNT];
+} LatencyStats;
+
+// create latency statistics
+LatencyStats *LatencyStats_New(void);
+
+// record the time spent in a processing stage by a query
+void LatencyStats_Record
+(
+	LatencyStats *stats,       // statistics to update
+	QueryClass query_class,    // class of query
+	LatencyStage stage,        // processing stage
+	double ms                  // time spent in stage, in milliseconds
+);
+
+// accumulate 'stats' into 'total'
+void LatencyStats_Merge
+(
+	LatencyStats *total,
+	const LatencyStats *stats
+);
+
+// replies with latency statistics
+void LatencyStats_Replay
+(
+	const LatencyStats *stats,
+	RedisModuleCtx *ctx
+);
+
+// adds latency statistics as fields of a module INFO section
+void LatencyStats_AddInfoFields
+(
+	const LatencyStats *stats,
+	RedisModuleInfoCtx *ctx
+);
+
+// free latency statistics
+void LatencyStats_Free
+(
+	LatencyStats *stats
+);
+
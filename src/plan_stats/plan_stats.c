@@ -0,0 +1,197 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "plan_stats.h"
+#include "RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../execution_plan/execution_plan.h"
+#include <inttypes.h>
+
+// collect profiled operations in pre-order
+static void _CollectOps(const OpBase *op, const OpBase ***ops) {
+	array_append(*ops, op);
+	for(int i = 0; i < op->childCount; i++) {
+		_CollectOps(op->children[i], ops);
+	}
+}
+
+// checks if entry describes the operations 'ops'
+static bool _SameShape(const PlanStatsEntry *entry, const OpBase **ops) {
+	uint op_count = array_len(ops);
+	if(array_len(entry->ops) != op_count) return false;
+	for(uint i = 0; i < op_count; i++) {
+		if(strcmp(entry->ops[i].name, ops[i]->name) != 0) return false;
+	}
+	return true;
+}
+
+// reset entry to describe the operations 'ops'
+// a query might be planned differently once its cached plan is evicted
+static void _ResetEntry(PlanStatsEntry *entry, const OpBase **ops) {
+	uint op_count = array_len(ops);
+	array_clear(entry->ops);
+	for(uint i = 0; i < op_count; i++) {
+		PlanStatsOp op = {0};
+		op.name = ops[i]->name;
+		array_append(entry->ops, op);
+	}
+	entry->samples = 0;
+}
+
+static void _ReplyWithDouble(RedisModuleCtx *ctx, double d) {
+	char str[32];
+	int len = snprintf(str, sizeof(str), "%.3f", d);
+	RedisModule_ReplyWithStringBuffer(ctx, str, len);
+}
+
+PlanStats *PlanStats_New(void) {
+	PlanStats *stats = rm_malloc(sizeof(PlanStats));
+	stats->plans = raxNew();
+	int res = pthread_mutex_init(&stats->lock, NULL);
+	UNUSED(res);
+	ASSERT(res == 0);
+	return stats;
+}
+
+void PlanStats_Add(PlanStats *stats, uint64_t fingerprint,
+		const ExecutionPlan *plan) {
+	ASSERT(plan != NULL);
+	ASSERT(stats != NULL);
+
+	const OpBase **ops = array_new(const OpBase *, 8);
+	_CollectOps(plan->root, &ops);
+	uint op_count = array_len(ops);
+
+	pthread_mutex_lock(&stats->lock);
+
+	PlanStatsEntry *entry = raxFind(stats->plans, (unsigned char *)&fingerprint,
+			sizeof(fingerprint));
+
+	if(entry == raxNotFound) {
+		// drop new plans once cap is reached
+		if(raxSize(stats->plans) >= PLAN_STATS_CAP) goto cleanup;
+		entry = rm_malloc(sizeof(PlanStatsEntry));
+		entry->ops = array_new(PlanStatsOp, op_count);
+		_ResetEntry(entry, ops);
+		raxInsert(stats->plans, (unsigned char *)&fingerprint,
+				sizeof(fingerprint), entry, NULL);
+	} else if(!_SameShape(entry, ops)) {
+		_ResetEntry(entry, ops);
+	}
+
+	entry->samples++;
+	for(uint i = 0; i < op_count; i++) {
+		const OpStats *op_stats = ops[i]->stats;
+		if(op_stats == NULL) continue;
+
+		PlanStatsOp *op = entry->ops + i;
+		op->records          +=  op_stats->profileRecordCount;
+		op->batches          +=  op_stats->profileBatchCount;
+		op->records_created  +=  op_stats->profileRecordsCreated;
+		op->bytes            +=  op_stats->profileBytesAllocated;
+		op->exec_time        +=  op_stats->profileExecTime;
+		op->matrix_time      +=  op_stats->profileMatrixTime;
+		op->matrix_nnz       +=  op_stats->profileMatrixNNZ;
+	}
+
+cleanup:
+	pthread_mutex_unlock(&stats->lock);
+	array_free(ops);
+}
+
+uint PlanStats_TopOps(PlanStats *stats, uint64_t fingerprint, uint k,
+		const char **names, double *exec_times) {
+	ASSERT(stats != NULL);
+	ASSERT(names != NULL);
+	ASSERT(exec_times != NULL);
+
+	uint count = 0;
+	pthread_mutex_lock(&stats->lock);
+
+	PlanStatsEntry *entry = raxFind(stats->plans, (unsigned char *)&fingerprint,
+			sizeof(fingerprint));
+	if(entry == raxNotFound || entry->samples == 0) goto cleanup;
+
+	// insertion sort into the k slots, k is small
+	uint op_count = array_len(entry->ops);
+	for(uint i = 0; i < op_count; i++) {
+		double t = entry->ops[i].exec_time / entry->samples;
+		uint j = count;
+		while(j > 0 && exec_times[j - 1] < t) {
+			if(j < k) {
+				names[j] = names[j - 1];
+				exec_times[j] = exec_times[j - 1];
+			}
+			j--;
+		}
+		if(j < k) {
+			names[j] = entry->ops[i].name;
+			exec_times[j] = t;
+			if(count < k) count++;
+		}
+	}
+
+cleanup:
+	pthread_mutex_unlock(&stats->lock);
+	return count;
+}
+
+void PlanStats_Replay(PlanStats *stats, RedisModuleCtx *ctx) {
+	ASSERT(stats != NULL);
+
+	pthread_mutex_lock(&stats->lock);
+
+	RedisModule_ReplyWithArray(ctx, raxSize(stats->plans));
+
+	raxIterator iter;
+	raxStart(&iter, stats->plans);
+	raxSeek(&iter, "^", NULL, 0);
+	while(raxNext(&iter)) {
+		PlanStatsEntry *entry = iter.data;
+		uint64_t fingerprint;
+		memcpy(&fingerprint, iter.key, sizeof(fingerprint));
+
+		// fingerprint, samples, operations
+		RedisModule_ReplyWithArray(ctx, 3);
+		char hex[17];
+		snprintf(hex, sizeof(hex), "%016" PRIx64, fingerprint);
+		RedisModule_ReplyWithStringBuffer(ctx, hex, 16);
+		RedisModule_ReplyWithLongLong(ctx, entry->samples);
+
+		uint op_count = array_len(entry->ops);
+		RedisModule_ReplyWithArray(ctx, op_count);
+		for(uint i = 0; i < op_count; i++) {
+			PlanStatsOp *op = entry->ops + i;
+			RedisModule_ReplyWithArray(ctx, 8);
+			RedisModule_ReplyWithCString(ctx, op->name);
+			RedisModule_ReplyWithLongLong(ctx, op->records);
+			RedisModule_ReplyWithLongLong(ctx, op->batches);
+			RedisModule_ReplyWithLongLong(ctx, op->records_created);
+			RedisModule_ReplyWithLongLong(ctx, op->bytes);
+			_ReplyWithDouble(ctx, op->exec_time);
+			_ReplyWithDouble(ctx, op->matrix_time);
+			RedisModule_ReplyWithLongLong(ctx, op->matrix_nnz);
+		}
+	}
+	raxStop(&iter);
+
+	pthread_mutex_unlock(&stats->lock);
+}
+
+static void _PlanStatsEntry_Free(void *e) {
+	PlanStatsEntry *entry = e;
+	array_free(entry->ops);
+	rm_free(entry);
+}
+
+void PlanStats_Free(PlanStats *stats) {
+	if(stats == NULL) return;
+	raxFreeWithCallback(stats->plans, _PlanStatsEntry_Free);
+	pthread_mutex_destroy(&stats->lock);
+	rm_free(stats);
+}
+
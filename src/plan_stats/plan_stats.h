@@ -0,0 +1,78 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <pthread.h>
+
+#include "../redismodule.h"
+#include "../../deps/rax/rax.h"
+
+struct ExecutionPlan;
+
+// maximum number of distinct plans tracked per graph
+#define PLAN_STATS_CAP 256
+
+// statistics of a single operation, accumulated over sampled executions
+typedef struct {
+	const char *name;          // operation name
+	uint64_t records;          // records produced
+	uint64_t batches;          // batches produced
+	uint64_t records_created;  // records borrowed from the record pool
+	int64_t bytes;             // bytes allocated
+	double exec_time;          // execution time in ms, excluding child operations
+	double matrix_time;        // time spent evaluating matrices in ms
+	uint64_t matrix_nnz;       // entries in evaluated matrices
+} PlanStatsOp;
+
+// statistics of an execution plan, identified by its query fingerprint
+typedef struct {
+	uint64_t samples;          // number of sampled executions
+	PlanStatsOp *ops;          // per operation statistics, in plan pre-order
+} PlanStatsEntry;
+
+// collects operation statistics of sampled query executions
+typedef struct {
+	rax *plans;                // query fingerprint to PlanStatsEntry
+	pthread_mutex_t lock;      // guards plans
+} PlanStats;
+
+// create a new plan statistics store
+PlanStats *PlanStats_New(void);
+
+// accumulate the statistics of a profiled execution plan
+void PlanStats_Add
+(
+	PlanStats *stats,          // store to add statistics to
+	uint64_t fingerprint,      // fingerprint of the executed query
+	const struct ExecutionPlan *plan  // profiled execution plan
+);
+
+// retrieves up to 'k' operations with the highest average execution time
+// of the plan identified by 'fingerprint', in descending order
+// returns the number of retrieved operations
+uint PlanStats_TopOps
+(
+	PlanStats *stats,          // store to search
+	uint64_t fingerprint,      // fingerprint of the executed query
+	uint k,                    // maximum number of operations to retrieve
+	const char **names,        // [output] operation names
+	double *exec_times         // [output] average execution times in ms
+);
+
+// replies with collected statistics
+void PlanStats_Replay
+(
+	PlanStats *stats,
+	RedisModuleCtx *ctx
+);
+
+// free plan statistics store
+void PlanStats_Free
+(
+	PlanStats *stats
+);
+
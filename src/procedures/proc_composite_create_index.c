@@ -0,0 +1,98 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_composite_create_index.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "../graph/graphcontext.h"
+#include "../index/composite_index.h"
+
+//------------------------------------------------------------------------------
+// composite createNodeIndex
+//------------------------------------------------------------------------------
+
+// collect property names out of an array of strings
+// returns NULL if 'list' isn't an array of strings
+static const char **_PropertyNames(SIValue list) {
+	if(!(SI_TYPE(list) & T_ARRAY)) return NULL;
+
+	uint count = SIArray_Length(list);
+	const char **names = array_new(const char *, count);
+	for(uint i = 0; i < count; i++) {
+		SIValue name = SIArray_Get(list, i);
+		if(!(SI_TYPE(name) & T_STRING)) {
+			array_free(names);
+			return NULL;
+		}
+		array_append(names, name.stringval);
+	}
+
+	return names;
+}
+
+// CALL db.idx.composite.createNodeIndex(label, [properties] [, [included]])
+// CALL db.idx.composite.createNodeIndex('User', ['country', 'age'], ['name'])
+ProcedureResult Proc_CompositeCreateNodeIdxInvoke(ProcedureCtx *ctx,
+		const SIValue *args, const char **yield) {
+	uint arg_count = array_len((SIValue *)args);
+	if(arg_count < 2 || arg_count > 3) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING)) return PROCEDURE_ERR;
+
+	ProcedureResult res    = PROCEDURE_ERR;
+	CompositeIndex *idx    = NULL;
+	GraphContext *gc       = QueryCtx_GetGraphCtx();
+	const char *label      = args[0].stringval;
+	const char **fields    = _PropertyNames(args[1]);
+	const char **included  = (arg_count == 3) ? _PropertyNames(args[2]) :
+		array_new(const char *, 0);
+
+	// validation, key properties should be a none empty list of strings
+	// included properties should be a list of strings
+	if(fields == NULL || included == NULL || array_len(fields) == 0) {
+		goto cleanup;
+	}
+
+	// create and build composite index
+	if(GraphContext_AddCompositeIndex(&idx, gc, label, fields,
+				array_len(fields), included, array_len(included)) == INDEX_OK) {
+		CompositeIndex_Construct(idx);
+	}
+
+	res = PROCEDURE_OK;
+
+cleanup:
+	if(fields) array_free(fields);
+	if(included) array_free(included);
+	return res;
+}
+
+SIValue *Proc_CompositeCreateNodeIdxStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_CompositeCreateNodeIdxFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_CompositeCreateNodeIdxGen() {
+	void *privateData = NULL;
+	ProcedureOutput *output = array_new(ProcedureOutput, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.idx.composite.createNodeIndex",
+								   PROCEDURE_VARIABLE_ARG_COUNT,
+								   output,
+								   Proc_CompositeCreateNodeIdxStep,
+								   Proc_CompositeCreateNodeIdxInvoke,
+								   Proc_CompositeCreateNodeIdxFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
+
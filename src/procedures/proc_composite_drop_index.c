@@ -0,0 +1,66 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_composite_drop_index.h"
+#include "../query_ctx.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// composite dropNodeIndex
+//------------------------------------------------------------------------------
+
+// CALL db.idx.composite.drop(label, [properties])
+// CALL db.idx.composite.drop('User', ['country', 'age'])
+
+ProcedureResult Proc_CompositeDropIndexInvoke(ProcedureCtx *ctx,
+		const SIValue *args, const char **yield) {
+	if(array_len((SIValue *)args) != 2) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[1]) & T_ARRAY)) return PROCEDURE_ERR;
+
+	uint fields_count = SIArray_Length(args[1]);
+	const char *fields[fields_count + 1];
+	for(uint i = 0; i < fields_count; i++) {
+		SIValue field = SIArray_Get(args[1], i);
+		if(!(SI_TYPE(field) & T_STRING)) return PROCEDURE_ERR;
+		fields[i] = field.stringval;
+	}
+
+	const char *label = args[0].stringval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	GraphContext_DeleteCompositeIndex(gc, label, fields, fields_count);
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_CompositeDropIndexStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_CompositeDropIndexFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_CompositeDropIdxGen() {
+	void *privateData = NULL;
+	ProcedureOutput *output = array_new(ProcedureOutput, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.idx.composite.drop",
+								   2,
+								   output,
+								   Proc_CompositeDropIndexStep,
+								   Proc_CompositeDropIndexInvoke,
+								   Proc_CompositeDropIndexFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
+
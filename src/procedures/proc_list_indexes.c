@@ -16,7 +16,10 @@
 typedef struct {
 	SIValue *out;               // outputs
 	int schema_id;              // current schema ID
+	SchemaType schema_type;     // current schema type, labels then relationship types
 	IndexType type;             // current index type to retrieve
+	bool composite;             // retrieving current schema composite indices
+	uint composite_pos;         // next composite index to retrieve
 	GraphContext *gc;           // graph context
 	SIValue *yield_type;        // yield index type
 	SIValue *yield_label;       // yield index label
@@ -40,7 +43,10 @@ ProcedureResult Proc_IndexesInvoke(ProcedureCtx *ctx, const SIValue *args,
 	pdata->gc               = gc;
 	pdata->out              = array_new(SIValue, 6);
 	pdata->type             = IDX_EXACT_MATCH;
+	pdata->composite        = false;
+	pdata->composite_pos    = 0;
 	pdata->schema_id        = GraphContext_SchemaCount(gc, SCHEMA_NODE) - 1;
+	pdata->schema_type      = SCHEMA_NODE;
 	pdata->yield_type       = NULL;
 	pdata->yield_label      = NULL;
 	pdata->yield_properties = NULL;
@@ -102,6 +108,25 @@ static bool _EmitIndex(IndexesContext *ctx, const Schema *s, IndexType type) {
 	return true;
 }
 
+static void _EmitCompositeIndex(IndexesContext *ctx, const CompositeIndex *idx) {
+	if(ctx->yield_type != NULL) {
+		*ctx->yield_type = SI_ConstStringVal("composite");
+	}
+
+	if(ctx->yield_label) {
+		*ctx->yield_label = SI_ConstStringVal(idx->label);
+	}
+
+	// key properties, in key order
+	if(ctx->yield_properties) {
+		*ctx->yield_properties = SI_Array(idx->fields_count);
+		for(uint i = 0; i < idx->fields_count; i++) {
+			SIArray_Append(ctx->yield_properties,
+					SI_ConstStringVal(idx->fields[i]));
+		}
+	}
+}
+
 SIValue *Proc_IndexesStep(ProcedureCtx *ctx) {
 	ASSERT(ctx->privateData != NULL);
 
@@ -109,20 +134,47 @@ SIValue *Proc_IndexesStep(ProcedureCtx *ctx) {
 	IndexesContext *pdata = ctx->privateData;
 
 	// loop over all schemas from last to first
-	while(pdata->schema_id >= 0) {
-		s = GraphContext_GetSchemaByID(pdata->gc, pdata->schema_id, SCHEMA_NODE);
+	while(true) {
+		if(pdata->schema_id < 0) {
+			// done with relationship types
+			if(pdata->schema_type == SCHEMA_EDGE) break;
+
+			// done with labels, continue to relationship types
+			pdata->schema_type = SCHEMA_EDGE;
+			pdata->schema_id = GraphContext_SchemaCount(pdata->gc,
+					SCHEMA_EDGE) - 1;
+			continue;
+		}
+
+		s = GraphContext_GetSchemaByID(pdata->gc, pdata->schema_id,
+				pdata->schema_type);
 		if(!Schema_HasIndices(s)) {
 			// no indexes found, continue to the next schema
 			pdata->schema_id--;
 			continue;
 		}
 
+		if(pdata->composite) {
+			// emit the schema's composite indices one at a time
+			if(pdata->composite_pos < array_len(s->composite_indices)) {
+				_EmitCompositeIndex(pdata,
+						s->composite_indices[pdata->composite_pos++]);
+				return pdata->out;
+			}
+
+			// all indexes retrieved; update schema_id, reset schema type
+			pdata->schema_id--;
+			pdata->composite = false;
+			pdata->composite_pos = 0;
+			continue;
+		}
+
 		// populate index data if one is found
 		bool found = _EmitIndex(pdata, s, pdata->type);
 
 		if(pdata->type == IDX_FULLTEXT) {
-			// all indexes retrieved; update schema_id, reset schema type
-			pdata->schema_id--;
+			// next iterations will check the same schema for composite indexes
+			pdata->composite = true;
 			pdata->type = IDX_EXACT_MATCH;
 		} else {
 			// next iteration will check the same schema for a full-text index
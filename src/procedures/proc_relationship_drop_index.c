@@ -0,0 +1,57 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_relationship_drop_index.h"
+#include "../query_ctx.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// relationship drop index
+//------------------------------------------------------------------------------
+
+// CALL db.idx.relationship.drop(relationshipType, property)
+// CALL db.idx.relationship.drop('TRANSFER', 'tx_id')
+
+ProcedureResult Proc_RelationshipDropIndexInvoke(ProcedureCtx *ctx,
+		const SIValue *args, const char **yield) {
+	if(array_len((SIValue *)args) != 2) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[1]) & T_STRING)) return PROCEDURE_ERR;
+
+	const char *relation = args[0].stringval;
+	const char *field = args[1].stringval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	GraphContext_DeleteIndex(gc, relation, field, IDX_EXACT_MATCH, SCHEMA_EDGE);
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_RelationshipDropIndexStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_RelationshipDropIndexFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_RelationshipDropIdxGen() {
+	void *privateData = NULL;
+	ProcedureOutput *output = array_new(ProcedureOutput, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.idx.relationship.drop",
+								   2,
+								   output,
+								   Proc_RelationshipDropIndexStep,
+								   Proc_RelationshipDropIndexInvoke,
+								   Proc_RelationshipDropIndexFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
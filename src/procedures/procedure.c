@@ -40,6 +40,14 @@ void Proc_Register() {
 	_procRegister("db.idx.fulltext.drop", Proc_FulltextDropIdxGen);
 	_procRegister("db.idx.fulltext.queryNodes", Proc_FulltextQueryNodeGen);
 	_procRegister("db.idx.fulltext.createNodeIndex", Proc_FulltextCreateNodeIdxGen);
+
+	// Register composite index generators.
+	_procRegister("db.idx.composite.drop", Proc_CompositeDropIdxGen);
+	_procRegister("db.idx.composite.createNodeIndex", Proc_CompositeCreateNodeIdxGen);
+
+	// Register relationship index generators.
+	_procRegister("db.idx.relationship.drop", Proc_RelationshipDropIdxGen);
+	_procRegister("db.idx.relationship.createIndex", Proc_RelationshipCreateIdxGen);
 }
 
 ProcedureCtx *ProcCtxNew(const char *name,
@@ -16,4 +16,8 @@
 #include "proc_fulltext_query.h"
 #include "proc_fulltext_drop_index.h"
 #include "proc_fulltext_create_index.h"
+#include "proc_composite_drop_index.h"
+#include "proc_composite_create_index.h"
+#include "proc_relationship_drop_index.h"
+#include "proc_relationship_create_index.h"
 
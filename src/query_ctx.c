@@ -81,6 +81,21 @@ void QueryCtx_SetLastWriter(OpBase *last_writer) {
 	ctx->internal_exec_ctx.last_writer = last_writer;
 }
 
+void QueryCtx_SetParams(rax *params) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(ctx->query_data.params) {
+		raxFreeWithCallback(ctx->query_data.params, _ParameterFreeCallback);
+	}
+	ctx->query_data.params = params;
+}
+
+rax *QueryCtx_DetachParams(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	rax *params = ctx->query_data.params;
+	ctx->query_data.params = NULL;
+	return params;
+}
+
 AST *QueryCtx_GetAST(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	return ctx->query_data.ast;
@@ -187,6 +202,9 @@ static void _QueryCtx_UnlockCommit(QueryCtx *ctx) {
 	}
 
 	ctx->internal_exec_ctx.locked_for_commit = false;
+	// Fold pending changes into the graph matrices while holding the
+	// write lock, such that readers will never have to.
+	Graph_ApplyAllPending(gc->g);
 	// Release graph R/W lock.
 	Graph_ReleaseLock(gc->g);
 
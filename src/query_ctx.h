@@ -70,6 +70,10 @@ void QueryCtx_SetGraphCtx(GraphContext *gc);
 void QueryCtx_SetResultSet(ResultSet *result_set);
 /* Set the last writer which needs to commit */
 void QueryCtx_SetLastWriter(OpBase *op);
+/* Set the query parameters values map, freeing the current one. */
+void QueryCtx_SetParams(rax *params);
+/* Detach the query parameters values map, the caller takes ownership of it. */
+rax *QueryCtx_DetachParams(void);
 
 /* Getters */
 /* Retrieve the AST. */
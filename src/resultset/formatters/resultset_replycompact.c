@@ -100,15 +100,17 @@ static void _ResultSet_CompactReplyWithProperties(RedisModuleCtx *ctx, GraphCont
 												  const GraphEntity *e) {
 	int prop_count = ENTITY_PROP_COUNT(e);
 	RedisModule_ReplyWithArray(ctx, prop_count);
+	uint cursor = 0;
+	SIValue *value;
+	Attribute_ID attr_id;
 	// Iterate over all properties stored on entity
-	for(int i = 0; i < prop_count; i ++) {
+	while(GraphEntity_NextProperty(e, &cursor, &attr_id, &value)) {
 		// Compact replies include the value's type; verbose replies do not
 		RedisModule_ReplyWithArray(ctx, 3);
-		EntityProperty prop = ENTITY_PROPS(e)[i];
 		// Emit the string index
-		RedisModule_ReplyWithLongLong(ctx, prop.id);
+		RedisModule_ReplyWithLongLong(ctx, attr_id);
 		// Emit the value
-		_ResultSet_CompactReplyWithSIValue(ctx, gc, prop.value);
+		_ResultSet_CompactReplyWithSIValue(ctx, gc, *value);
 	}
 }
 
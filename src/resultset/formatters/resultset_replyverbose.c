@@ -65,15 +65,17 @@ static void _ResultSet_VerboseReplyWithProperties(RedisModuleCtx *ctx, GraphCont
 												  const GraphEntity *e) {
 	int prop_count = ENTITY_PROP_COUNT(e);
 	RedisModule_ReplyWithArray(ctx, prop_count);
+	uint cursor = 0;
+	SIValue *value;
+	Attribute_ID attr_id;
 	// Iterate over all properties stored on entity
-	for(int i = 0; i < prop_count; i ++) {
+	while(GraphEntity_NextProperty(e, &cursor, &attr_id, &value)) {
 		RedisModule_ReplyWithArray(ctx, 2);
-		EntityProperty prop = ENTITY_PROPS(e)[i];
 		// Emit the actual string
-		const char *prop_str = GraphContext_GetAttributeString(gc, prop.id);
+		const char *prop_str = GraphContext_GetAttributeString(gc, attr_id);
 		RedisModule_ReplyWithStringBuffer(ctx, prop_str, strlen(prop_str));
 		// Emit the value
-		_ResultSet_VerboseReplyWithSIValue(ctx, gc, prop.value);
+		_ResultSet_VerboseReplyWithSIValue(ctx, gc, *value);
 	}
 }
 
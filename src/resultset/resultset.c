@@ -11,7 +11,6 @@
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
-#include "../grouping/group_cache.h"
 
 static void _ResultSet_ReplayStats(RedisModuleCtx *ctx, ResultSet *set) {
 	char buff[512] = {0};
@@ -216,6 +215,11 @@ void ResultSet_Reply(ResultSet *set) {
 	/* Check to see if we've encountered a run-time error.
 	 * If so, emit it as the only response. */
 	if(ErrorCtx_EncounteredError()) {
+		// release the cells which will not be replied
+		uint64_t cells = DataBlock_ItemCount(set->cells);
+		for(uint64_t i = 0; i < cells; i++) {
+			SIValue_Free(*(SIValue *)DataBlock_GetItem(set->cells, i));
+		}
 		ErrorCtx_EmitException();
 		return;
 	}
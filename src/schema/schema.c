@@ -10,11 +10,13 @@
 #include "../util/rmalloc.h"
 #include "../graph/graphcontext.h"
 
-Schema *Schema_New(const char *name, int id) {
+Schema *Schema_New(const char *name, int id, SchemaType type) {
 	Schema *schema = rm_malloc(sizeof(Schema));
 	schema->id = id;
+	schema->type = type;
 	schema->index = NULL;
 	schema->fulltextIdx = NULL;
+	schema->composite_indices = array_new(CompositeIndex *, 0);
 	schema->name = rm_strdup(name);
 	return schema;
 }
@@ -26,7 +28,7 @@ const char *Schema_GetName(const Schema *s) {
 
 bool Schema_HasIndices(const Schema *s) {
 	ASSERT(s);
-	return (s->fulltextIdx || s->index);
+	return (s->fulltextIdx || s->index || array_len(s->composite_indices) > 0);
 }
 
 unsigned short Schema_IndexCount(const Schema *s) {
@@ -72,8 +74,12 @@ int Schema_AddIndex(Index **idx, Schema *s, const char *field, IndexType type) {
 		Attribute_ID fieldID = GraphContext_FindOrAddAttribute(gc, field);
 		if(Index_ContainsAttribute(_idx, fieldID)) return INDEX_FAIL;
 	} else {
+		// Relationship types are only indexed by exact-match indices.
+		if(s->type == SCHEMA_EDGE && type != IDX_EXACT_MATCH) return INDEX_FAIL;
+
 		// Index doesn't exist, create it.
-		_idx = Index_New(s->name, type);
+		GraphEntityType entity_type = (s->type == SCHEMA_NODE) ? GETYPE_NODE : GETYPE_EDGE;
+		_idx = Index_New(s->name, type, entity_type);
 		if(type == IDX_FULLTEXT) s->fulltextIdx = _idx;
 		else s->index = _idx;
 	}
@@ -126,6 +132,68 @@ int Schema_RemoveIndex(Schema *s, const char *field, IndexType type) {
 	}
 }
 
+CompositeIndex *Schema_GetCompositeIndex(const Schema *s, const char **fields,
+		uint fields_count) {
+	ASSERT(s);
+
+	uint count = array_len(s->composite_indices);
+	for(uint i = 0; i < count; i++) {
+		CompositeIndex *idx = s->composite_indices[i];
+		if(CompositeIndex_HasFields(idx, fields, fields_count)) return idx;
+	}
+
+	return NULL;
+}
+
+int Schema_AddCompositeIndex(CompositeIndex **idx, Schema *s, const char **fields,
+		uint fields_count, const char **included, uint included_count) {
+	ASSERT(s);
+	ASSERT(fields && fields_count > 0);
+
+	CompositeIndex *_idx = CompositeIndex_New(s->name, fields, fields_count,
+			included, included_count);
+
+	// composite index over the same (deduplicated) key fields already exists
+	if(Schema_GetCompositeIndex(s, (const char **)_idx->fields,
+				_idx->fields_count)) {
+		CompositeIndex_Free(_idx);
+		return INDEX_FAIL;
+	}
+
+	array_append(s->composite_indices, _idx);
+
+	*idx = _idx;
+	return INDEX_OK;
+}
+
+int Schema_RemoveCompositeIndex(Schema *s, const char **fields, uint fields_count) {
+	ASSERT(s);
+
+	uint count = array_len(s->composite_indices);
+	for(uint i = 0; i < count; i++) {
+		CompositeIndex *idx = s->composite_indices[i];
+		if(!CompositeIndex_HasFields(idx, fields, fields_count)) continue;
+
+		CompositeIndex_Free(idx);
+		// keep indices in creation order
+		array_del(s->composite_indices, i);
+		return INDEX_OK;
+	}
+
+	return INDEX_FAIL;
+}
+
+bool Schema_CompositeIndexCovers(const Schema *s, Attribute_ID attr_id) {
+	ASSERT(s);
+
+	uint count = array_len(s->composite_indices);
+	for(uint i = 0; i < count; i++) {
+		if(CompositeIndex_Covers(s->composite_indices[i], attr_id)) return true;
+	}
+
+	return false;
+}
+
 // Index node under all schema indices.
 void Schema_AddNodeToIndices(const Schema *s, const Node *n) {
 	if(!s) return;
@@ -136,6 +204,27 @@ void Schema_AddNodeToIndices(const Schema *s, const Node *n) {
 
 	idx = s->index;
 	if(idx) Index_IndexNode(idx, n);
+
+	uint composite_count = array_len(s->composite_indices);
+	for(uint i = 0; i < composite_count; i++) {
+		CompositeIndex_IndexNode(s->composite_indices[i], n);
+	}
+}
+
+// Index edge under all schema indices.
+void Schema_AddEdgeToIndices(const Schema *s, const Edge *e) {
+	if(!s) return;
+	ASSERT(s->type == SCHEMA_EDGE);
+
+	if(s->index) Index_IndexEdge(s->index, e);
+}
+
+// Remove edge from all schema indices.
+void Schema_RemoveEdgeFromIndices(const Schema *s, const Edge *e) {
+	if(!s) return;
+	ASSERT(s->type == SCHEMA_EDGE);
+
+	if(s->index) Index_RemoveEdge(s->index, e);
 }
 
 void Schema_Free(Schema *schema) {
@@ -144,6 +233,12 @@ void Schema_Free(Schema *schema) {
 	// Free indicies.
 	if(schema->index) Index_Free(schema->index);
 	if(schema->fulltextIdx) Index_Free(schema->fulltextIdx);
+
+	uint composite_count = array_len(schema->composite_indices);
+	for(uint i = 0; i < composite_count; i++) {
+		CompositeIndex_Free(schema->composite_indices[i]);
+	}
+	array_free(schema->composite_indices);
 	rm_free(schema);
 }
 
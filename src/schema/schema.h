@@ -8,8 +8,10 @@
 
 #include "../redismodule.h"
 #include "../index/index.h"
+#include "../index/composite_index.h"
 #include "rax.h"
 #include "redisearch_api.h"
+#include "../graph/entities/edge.h"
 #include "../graph/entities/graph_entity.h"
 
 typedef enum {
@@ -23,12 +25,14 @@ typedef enum {
 typedef struct {
 	int id;               // Internal ID to a matrix within the graph.
 	char *name;           // Schema name.
+	SchemaType type;      // Schema type, node label or relationship type.
 	Index *index;         // Exact match index.
 	Index *fulltextIdx;   // Full-text index.
+	CompositeIndex **composite_indices;  // Composite indices.
 } Schema;
 
 /* Creates a new schema. */
-Schema *Schema_New(const char *label, int id);
+Schema *Schema_New(const char *label, int id, SchemaType type);
 
 const char *Schema_GetName(const Schema *s);
 
@@ -43,15 +47,38 @@ unsigned short Schema_IndexCount(const Schema *s);
 Index *Schema_GetIndex(const Schema *s, Attribute_ID *attribute_id, IndexType type);
 
 /* Assign a new index to attribute
- * attribute must already exists and not associated with an index. */
+ * attribute must already exists and not associated with an index
+ * relationship types only support exact-match indices. */
 int Schema_AddIndex(Index **idx, Schema *s, const char *field, IndexType type);
 
 /* Removes index. */
 int Schema_RemoveIndex(Schema *s, const char *field, IndexType type);
 
+/* Retrieves composite index by its key fields.
+ * Returns NULL if index wasn't found. */
+CompositeIndex *Schema_GetCompositeIndex(const Schema *s, const char **fields,
+		uint fields_count);
+
+/* Adds a composite index over key fields, storing included fields
+ * fails if a composite index over the same key fields exists. */
+int Schema_AddCompositeIndex(CompositeIndex **idx, Schema *s, const char **fields,
+		uint fields_count, const char **included, uint included_count);
+
+/* Removes composite index by its key fields. */
+int Schema_RemoveCompositeIndex(Schema *s, const char **fields, uint fields_count);
+
+/* Returns true if attribute is stored by any of the schema composite indices. */
+bool Schema_CompositeIndexCovers(const Schema *s, Attribute_ID attr_id);
+
 /* Introduce node schema indicies */
 void Schema_AddNodeToIndices(const Schema *s, const Node *n);
 
+/* Introduce edge to relationship type schema indicies */
+void Schema_AddEdgeToIndices(const Schema *s, const Edge *e);
+
+/* Remove edge from relationship type schema indicies */
+void Schema_RemoveEdgeFromIndices(const Schema *s, const Edge *e);
+
 /* Free schema. */
 void Schema_Free(Schema *s);
 
@@ -0,0 +1,226 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "decode_v10.h"
+#include "../../../../util/thpool/pools.h"
+
+// number of tasks per participating thread, evens out uneven tasks
+#define TASKS_PER_THREAD 4
+
+// entities below this count are decoded on the loading thread
+#define PARALLEL_DECODE_MIN 8192
+
+// a payload is loaded as a single buffer, see RdbSaveNodes_v10
+// entities are allocated by the loading thread, their properties are
+// decoded concurrently on the task thread pool
+typedef struct {
+	const char *pos;  // current position
+	const char *end;  // buffer end
+} EntityReader;
+
+typedef struct {
+	GraphEntity e;      // allocated entity
+	const char *props;  // entity's encoded properties
+	const char *end;    // end of entity's encoding
+	uint partition;     // columns partition, columnar entities only
+} EncodedEntity;
+
+typedef struct {
+	EncodedEntity *plain;     // entities holding their own properties
+	EncodedEntity *columnar;  // entities whose properties reside in columns
+	uint task_count;          // number of tasks
+} DecodeCtx;
+
+static uint64_t _ReadUnsigned(EntityReader *r) {
+	ASSERT(r->pos + sizeof(uint64_t) <= r->end);
+	uint64_t v;
+	memcpy(&v, r->pos, sizeof(v));
+	Serializer_SwapLittleEndian(&v, 1);
+	r->pos += sizeof(v);
+	return v;
+}
+
+static double _ReadDouble(EntityReader *r) {
+	double d;
+	uint64_t bits = _ReadUnsigned(r);
+	memcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+static SIValue _LoadSIValue(EntityReader *r) {
+	/* Format:
+	 * SIType
+	 * Value */
+	SIType t = _ReadUnsigned(r);
+	switch(t) {
+		case T_INT64:
+			return SI_LongVal(_ReadUnsigned(r));
+		case T_DOUBLE:
+			return SI_DoubleVal(_ReadDouble(r));
+		case T_STRING: {
+			// strings are duplicated, the buffer is released once decoded
+			uint64_t len = _ReadUnsigned(r);
+			ASSERT(r->pos + len <= r->end);
+			char *str = rm_strndup(r->pos, len);
+			r->pos += len;
+			return SI_TransferStringVal(str);
+		}
+		case T_BOOL:
+			return SI_BoolVal(_ReadUnsigned(r));
+		case T_ARRAY: {
+			uint64_t len = _ReadUnsigned(r);
+			SIValue list = SI_Array(len);
+			for(uint64_t i = 0; i < len; i++) {
+				SIValue elem = _LoadSIValue(r);
+				SIArray_Append(&list, elem);
+				SIValue_Free(elem);
+			}
+			return list;
+		}
+		case T_POINT: {
+			double lat = _ReadDouble(r);
+			double lon = _ReadDouble(r);
+			return SI_Point(lat, lon);
+		}
+		case T_NULL:
+		default: // currently impossible
+			return SI_NullVal();
+	}
+}
+
+static void _LoadProperties(EncodedEntity *ee) {
+	/* Format:
+	 * #properties N
+	 * (name, value type, value) X N
+	 * decoded values are moved into the entity, not cloned
+	*/
+	EntityReader r = {.pos = ee->props, .end = ee->end};
+	uint64_t prop_count = _ReadUnsigned(&r);
+
+	for(uint64_t i = 0; i < prop_count; i++) {
+		Attribute_ID attr_id = _ReadUnsigned(&r);
+		SIValue attr_value = _LoadSIValue(&r);
+		GraphEntity_MoveProperty(&ee->e, attr_id, &attr_value);
+		SIValue_Free(attr_value);
+	}
+}
+
+// decode the properties of a task's share of entities
+// plain entities are split into contiguous ranges, columnar entities are
+// split by partition as property columns are not thread-safe
+static void _DecodeTask(void *arg, uint task) {
+	DecodeCtx *ctx = (DecodeCtx *)arg;
+
+	uint64_t n = array_len(ctx->plain);
+	uint64_t from = n * task / ctx->task_count;
+	uint64_t to = n * (task + 1) / ctx->task_count;
+	for(uint64_t i = from; i < to; i++) _LoadProperties(ctx->plain + i);
+
+	n = array_len(ctx->columnar);
+	for(uint64_t i = 0; i < n; i++) {
+		EncodedEntity *ee = ctx->columnar + i;
+		if(ee->partition % ctx->task_count != task) continue;
+		_LoadProperties(ee);
+	}
+}
+
+// load a payload of 'count' entities
+static void _RdbLoadEntities(RedisModuleIO *rdb, GraphContext *gc,
+		uint64_t count, bool nodes) {
+	size_t len;
+	char *buf = RedisModule_LoadStringBuffer(rdb, &len);
+	EntityReader r = {.pos = buf, .end = buf + len};
+
+	DecodeCtx ctx;
+	ctx.plain = array_new(EncodedEntity, count);
+	ctx.columnar = array_new(EncodedEntity, 0);
+
+	for(uint64_t i = 0; i < count; i++) {
+		EncodedEntity ee;
+		uint64_t entity_len = _ReadUnsigned(&r);
+		ee.end = r.pos + entity_len;
+		ASSERT(ee.end <= r.end);
+
+		EntityID id = _ReadUnsigned(&r);
+		if(nodes) {
+			// label matrices are loaded as a whole, see RdbLoadMatrices_v10
+			Node n;
+			int label = (int64_t)_ReadUnsigned(&r);
+			Serializer_Graph_AllocateNode(gc->g, id, label, &n);
+			ee.e = *(GraphEntity *)&n;
+			ee.partition = (label == GRAPH_NO_LABEL) ? 0 : label;
+		} else {
+			// connections are loaded as a whole, see RdbLoadMatrices_v10
+			Edge e;
+			Serializer_Graph_AllocateEdge(gc->g, id, &e);
+			ee.e = *(GraphEntity *)&e;
+			ee.partition = 0;
+		}
+		ee.props = r.pos;
+		r.pos = ee.end;
+
+		if(ENTITY_IS_COLUMNAR(ee.e.entity)) array_append(ctx.columnar, ee);
+		else array_append(ctx.plain, ee);
+	}
+
+	ctx.task_count = 1;
+	if(count >= PARALLEL_DECODE_MIN) {
+		ctx.task_count = (ThreadPools_TaskCount() + 1) * TASKS_PER_THREAD;
+	}
+	ThreadPools_RunTasks(_DecodeTask, &ctx, ctx.task_count);
+
+	array_free(ctx.plain);
+	array_free(ctx.columnar);
+	RedisModule_Free(buf);
+}
+
+void RdbLoadNodes_v10(RedisModuleIO *rdb, GraphContext *gc, uint64_t node_count) {
+	/* Format:
+	 * a single buffer holding node_count nodes:
+	 *  #bytes following
+	 *  ID
+	 *  label
+	 *  #properties N
+	 *  (name, value type, value) X N
+	 */
+
+	if(node_count == 0) return;
+	_RdbLoadEntities(rdb, gc, node_count, true);
+}
+
+void RdbLoadDeletedNodes_v10(RedisModuleIO *rdb, GraphContext *gc, uint64_t deleted_node_count) {
+	/* Format:
+	 * node id X N */
+	Graph_AllocateNodes(gc->g, deleted_node_count);
+	for(uint64_t i = 0; i < deleted_node_count; i++) {
+		NodeID id = RedisModule_LoadUnsigned(rdb);
+		Serializer_Graph_MarkNodeDeleted(gc->g, id);
+	}
+}
+
+void RdbLoadEdges_v10(RedisModuleIO *rdb, GraphContext *gc, uint64_t edge_count) {
+	/* Format:
+	 * a single buffer holding edge_count edges:
+	 *  #bytes following
+	 *  edge ID
+	 *  #properties N
+	 *  (name, value type, value) X N
+	 * connections are loaded as a whole, see RdbLoadMatrices_v10 */
+
+	if(edge_count == 0) return;
+	_RdbLoadEntities(rdb, gc, edge_count, false);
+}
+
+void RdbLoadDeletedEdges_v10(RedisModuleIO *rdb, GraphContext *gc, uint64_t deleted_edge_count) {
+	/* Format:
+	 * edge id X N */
+	Graph_AllocateEdges(gc->g, deleted_edge_count);
+	for(uint64_t i = 0; i < deleted_edge_count; i++) {
+		EdgeID id = RedisModule_LoadUnsigned(rdb);
+		Serializer_Graph_MarkEdgeDeleted(gc->g, id);
+	}
+}
+
@@ -0,0 +1,181 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "decode_v10.h"
+
+// loads an array of elements of 'elem_size' bytes, sets 'n' to its length
+// 64-bit elements are saved little-endian and converted to host order
+// GraphBLAS does not accept empty arrays, an empty array is loaded as
+// a single zeroed element
+static void *_RdbLoadArray(RedisModuleIO *rdb, size_t elem_size, GrB_Index *n) {
+	size_t len;
+	char *arr = RedisModule_LoadStringBuffer(rdb, &len);
+	if(len == 0) {
+		RedisModule_Free(arr);
+		arr = rm_calloc(1, elem_size);
+		len = elem_size;
+	}
+	*n = len / elem_size;
+	if(elem_size == sizeof(uint64_t)) {
+		Serializer_SwapLittleEndian((uint64_t *)arr, *n);
+	}
+	return arr;
+}
+
+static GrB_Matrix _RdbLoadMatrix(RedisModuleIO *rdb, GrB_Type type) {
+	/* Format:
+	 *  #rows
+	 *  #columns
+	 *  hypersparse
+	 *  #vectors (hypersparse only)
+	 *  jumbled
+	 *  Ap
+	 *  Ah (hypersparse only)
+	 *  Aj
+	 *  Ax
+	 * loaded arrays are handed over to GraphBLAS as is */
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index  nrows    =  RedisModule_LoadUnsigned(rdb);
+	GrB_Index  ncols    =  RedisModule_LoadUnsigned(rdb);
+	bool       hyper    =  RedisModule_LoadUnsigned(rdb);
+	GrB_Index  nvec     =  (hyper) ? RedisModule_LoadUnsigned(rdb) : nrows;
+	bool       jumbled  =  RedisModule_LoadUnsigned(rdb);
+
+	size_t type_size;
+	GxB_Type_size(&type_size, type);
+
+	GrB_Index  Ap_size;
+	GrB_Index  Ah_size;
+	GrB_Index  Aj_size;
+	GrB_Index  Ax_size;
+	GrB_Index  *Ap  =  _RdbLoadArray(rdb, sizeof(GrB_Index), &Ap_size);
+	GrB_Index  *Ah  =  (hyper) ? _RdbLoadArray(rdb, sizeof(GrB_Index), &Ah_size) : NULL;
+	GrB_Index  *Aj  =  _RdbLoadArray(rdb, sizeof(GrB_Index), &Aj_size);
+	void       *Ax  =  _RdbLoadArray(rdb, type_size, &Ax_size);
+
+	GrB_Matrix A;
+	if(hyper) {
+		info = GxB_Matrix_import_HyperCSR(&A, type, nrows, ncols, &Ap, &Ah, &Aj,
+				&Ax, Ap_size, Ah_size, Aj_size, Ax_size, nvec, jumbled, NULL);
+	} else {
+		info = GxB_Matrix_import_CSR(&A, type, nrows, ncols, &Ap, &Aj, &Ax,
+				Ap_size, Aj_size, Ax_size, jumbled, NULL);
+	}
+	ASSERT(info == GrB_SUCCESS);
+
+	return A;
+}
+
+static MultiEdgeStore *_RdbLoadMultiEdgeStore(RedisModuleIO *rdb) {
+	/* Format:
+	 *  #holes
+	 *  packed edge IDs
+	 *  lists, (offset, len | cap << 32) per list
+	 *  free lists IDs
+	 * all buffers hold little-endian 64-bit words */
+
+	size_t len;
+	MultiEdgeStore *store = MultiEdgeStore_New();
+	store->holes = RedisModule_LoadUnsigned(rdb);
+
+	// packed edge IDs, an empty buffer keeps the store's initial allocation
+	EdgeID *ids = (EdgeID *)RedisModule_LoadStringBuffer(rdb, &len);
+	if(len > 0) {
+		rm_free(store->ids);
+		store->ids = ids;
+		store->size = len / sizeof(EdgeID);
+		store->cap = store->size;
+		Serializer_SwapLittleEndian(store->ids, store->size);
+	} else {
+		RedisModule_Free(ids);
+	}
+
+	uint64_t *lists = (uint64_t *)RedisModule_LoadStringBuffer(rdb, &len);
+	uint64_t list_count = len / (sizeof(uint64_t) * 2);
+	Serializer_SwapLittleEndian(lists, list_count * 2);
+	array_free(store->lists);
+	store->lists = array_newlen(MultiEdgeList, list_count);
+	for(uint64_t i = 0; i < list_count; i++) {
+		MultiEdgeList *l = store->lists + i;
+		l->offset = lists[i * 2];
+		l->len    = (uint32_t)lists[i * 2 + 1];
+		l->cap    = (uint32_t)(lists[i * 2 + 1] >> 32);
+	}
+	RedisModule_Free(lists);
+
+	uint64_t *free_lists = (uint64_t *)RedisModule_LoadStringBuffer(rdb, &len);
+	uint64_t free_count = len / sizeof(uint64_t);
+	Serializer_SwapLittleEndian(free_lists, free_count);
+	array_free(store->free_lists);
+	store->free_lists = array_newlen(uint64_t, free_count);
+	memcpy(store->free_lists, free_lists, len);
+	RedisModule_Free(free_lists);
+
+	return store;
+}
+
+static void _RdbLoadRelation(RedisModuleIO *rdb, Graph *g, int r) {
+	/* Format:
+	 *  #edges
+	 *  relation matrix
+	 *  has transposed matrix
+	 *  transposed relation matrix (if saved)
+	 *  multi-edge store */
+
+	uint64_t edge_count = RedisModule_LoadUnsigned(rdb);
+	GrB_Matrix R = _RdbLoadMatrix(rdb, GrB_UINT64);
+	Serializer_Graph_SetMatrix(g->relations[r], R);
+
+	bool saved_transpose = RedisModule_LoadUnsigned(rdb);
+	GrB_Matrix TR = (saved_transpose) ? _RdbLoadMatrix(rdb, GrB_UINT64) : NULL;
+
+	// the graph might have been saved under a different transpose configuration
+	bool maintain_transpose;
+	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
+	if(maintain_transpose) {
+		if(TR == NULL) {
+			GrB_Index n;
+			GrB_Matrix_nrows(&n, R);
+			GrB_Matrix_new(&TR, GrB_UINT64, n, n);
+			GrB_transpose(TR, NULL, NULL, R, NULL);
+		}
+		Serializer_Graph_SetMatrix(g->t_relations[r], TR);
+	} else if(TR != NULL) {
+		GrB_Matrix_free(&TR);
+	}
+
+	MultiEdgeStore *store = _RdbLoadMultiEdgeStore(rdb);
+	Serializer_Graph_SetRelationEdges(g, r, store, edge_count);
+}
+
+void RdbLoadMatrices_v10(RedisModuleIO *rdb, GraphContext *gc, uint64_t matrix_count) {
+	/* Format:
+	 * (unit ID, unit) X matrix_count
+	 * unit 0 is the adjacency matrix followed by its transpose
+	 * units 1 to L are label matrices
+	 * units L + 1 to L + R are relations */
+
+	Graph *g = gc->g;
+	uint64_t label_count = Graph_LabelTypeCount(g);
+
+	for(uint64_t i = 0; i < matrix_count; i++) {
+		uint64_t unit = RedisModule_LoadUnsigned(rdb);
+		if(unit == 0) {
+			Serializer_Graph_SetMatrix(g->adjacency_matrix,
+					_RdbLoadMatrix(rdb, GrB_BOOL));
+			Serializer_Graph_SetMatrix(g->_t_adjacency_matrix,
+					_RdbLoadMatrix(rdb, GrB_BOOL));
+		} else if(unit <= label_count) {
+			Serializer_Graph_SetMatrix(g->labels[unit - 1],
+					_RdbLoadMatrix(rdb, GrB_BOOL));
+		} else {
+			_RdbLoadRelation(rdb, g, unit - 1 - label_count);
+		}
+	}
+}
@@ -0,0 +1,119 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "decode_v10.h"
+
+// load a list of strings, strings are allocated by RedisModule_LoadStringBuffer
+static char **_RdbLoadStrings(RedisModuleIO *rdb) {
+	uint count = RedisModule_LoadUnsigned(rdb);
+	char **strings = array_new(char *, count);
+	for(uint i = 0; i < count; i++) {
+		array_append(strings, RedisModule_LoadStringBuffer(rdb, NULL));
+	}
+	return strings;
+}
+
+static void _FreeStrings(char **strings) {
+	uint count = array_len(strings);
+	for(uint i = 0; i < count; i++) RedisModule_Free(strings[i]);
+	array_free(strings);
+}
+
+static void _RdbLoadCompositeIndex(RedisModuleIO *rdb, Schema *s) {
+	/* Format:
+	 * #key fields
+	 * key field X #key fields
+	 * #included fields
+	 * included field X #included fields */
+
+	char **fields = _RdbLoadStrings(rdb);
+	char **included = _RdbLoadStrings(rdb);
+
+	CompositeIndex *idx = NULL;
+	Schema_AddCompositeIndex(&idx, s, (const char **)fields, array_len(fields),
+			(const char **)included, array_len(included));
+
+	_FreeStrings(fields);
+	_FreeStrings(included);
+}
+
+static Schema *_RdbLoadSchema(RedisModuleIO *rdb, SchemaType type) {
+	/* Format:
+	 * id
+	 * name
+	 * #indices
+	 * (index type, indexed property) X M
+	 * #composite indices
+	 * composite index X #composite indices */
+
+	int id = RedisModule_LoadUnsigned(rdb);
+	char *name = RedisModule_LoadStringBuffer(rdb, NULL);
+	Schema *s = Schema_New(name, id, type);
+	RedisModule_Free(name);
+
+	Index *idx = NULL;
+	uint index_count = RedisModule_LoadUnsigned(rdb);
+	for(uint i = 0; i < index_count; i++) {
+		IndexType type = RedisModule_LoadUnsigned(rdb);
+		char *field = RedisModule_LoadStringBuffer(rdb, NULL);
+
+		Schema_AddIndex(&idx, s, field, type);
+		RedisModule_Free(field);
+	}
+
+	uint composite_count = RedisModule_LoadUnsigned(rdb);
+	for(uint i = 0; i < composite_count; i++) {
+		_RdbLoadCompositeIndex(rdb, s);
+	}
+
+	return s;
+}
+
+static void _RdbLoadAttributeKeys(RedisModuleIO *rdb, GraphContext *gc) {
+	/* Format:
+	 * #attribute keys
+	 * attribute keys
+	 */
+
+	uint count = RedisModule_LoadUnsigned(rdb);
+	for(uint i = 0; i < count; i ++) {
+		char *attr = RedisModule_LoadStringBuffer(rdb, NULL);
+		GraphContext_FindOrAddAttribute(gc, attr);
+		RedisModule_Free(attr);
+	}
+}
+
+void RdbLoadGraphSchema_v10(RedisModuleIO *rdb, GraphContext *gc) {
+	/* Format:
+	 * attribute keys (unified schema)
+	 * #node schemas
+	 * node schema X #node schemas
+	 * #relation schemas
+	 * unified relation schema
+	 * relation schema X #relation schemas
+	 */
+
+	// Attributes, Load the full attribute mapping.
+	_RdbLoadAttributeKeys(rdb, gc);
+
+	// #Node schemas
+	uint schema_count = RedisModule_LoadUnsigned(rdb);
+
+	// Load each node schema
+	gc->node_schemas = array_ensure_cap(gc->node_schemas, schema_count);
+	for(uint i = 0; i < schema_count; i ++) {
+		array_append(gc->node_schemas, _RdbLoadSchema(rdb, SCHEMA_NODE));
+	}
+
+	// #Edge schemas
+	schema_count = RedisModule_LoadUnsigned(rdb);
+
+	// Load each edge schema
+	gc->relation_schemas = array_ensure_cap(gc->relation_schemas, schema_count);
+	for(uint i = 0; i < schema_count; i ++) {
+		array_append(gc->relation_schemas, _RdbLoadSchema(rdb, SCHEMA_EDGE));
+	}
+}
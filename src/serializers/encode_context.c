@@ -45,6 +45,7 @@ void GraphEncodeContext_Reset(GraphEncodeContext *ctx) {
 	ctx->multiple_edges_src_id = 0;
 	ctx->multiple_edges_dest_id = 0;
 	ctx->multiple_edges_array = NULL;
+	ctx->multiple_edges_count = 0;
 	ctx->current_relation_matrix_id = 0;
 	ctx->multiple_edges_current_index = 0;
 
@@ -72,8 +73,8 @@ static bool _MultiEdgeMatrix(GrB_Matrix R, GrB_Monoid min_monoid) {
 	// To determine if matrix R contains an entry which represents
 	// multiple edges, we need to find the minimum value entry
 	// as a single-edge entry has its MSB turned on, by searching for the
-	// minimum value entry we'll get an entry with a pointer value in
-	// it (if such exists) as these have thier MSB turned off
+	// minimum value entry we'll get an entry holding a multi-edge list ID
+	// (if such exists) as these have thier MSB turned off
 	info = GrB_Matrix_reduce_UINT64(&edgeID, NULL, min_monoid, R, NULL);
 	ASSERT(info == GrB_SUCCESS);
 	multi_edge = !(SINGLE_EDGE(edgeID));
@@ -197,20 +198,26 @@ void GraphEncodeContext_SetMatrixTupleIterator(GraphEncodeContext *ctx,
 	ctx->matrix_tuple_iterator = iter;
 }
 
-void GraphEncodeContext_SetMutipleEdgesArray(GraphEncodeContext *ctx, EdgeID *edges,
-											 uint current_index, NodeID src, NodeID dest) {
+void GraphEncodeContext_SetMutipleEdgesArray(GraphEncodeContext *ctx, const EdgeID *edges,
+											 uint edge_count, uint current_index, NodeID src, NodeID dest) {
 	ASSERT(ctx);
 	ctx->multiple_edges_array = edges;
+	ctx->multiple_edges_count = edge_count;
 	ctx->multiple_edges_current_index = current_index;
 	ctx->multiple_edges_src_id = src;
 	ctx->multiple_edges_dest_id = dest;
 }
 
-EdgeID *GraphEncodeContext_GetMultipleEdgesArray(const GraphEncodeContext *ctx) {
+const EdgeID *GraphEncodeContext_GetMultipleEdgesArray(const GraphEncodeContext *ctx) {
 	ASSERT(ctx);
 	return ctx->multiple_edges_array;
 }
 
+uint GraphEncodeContext_GetMultipleEdgesCount(const GraphEncodeContext *ctx) {
+	ASSERT(ctx);
+	return ctx->multiple_edges_count;
+}
+
 uint GraphEncodeContext_GetMultipleEdgesCurrentIndex(const GraphEncodeContext *ctx) {
 	ASSERT(ctx);
 	return ctx->multiple_edges_current_index;
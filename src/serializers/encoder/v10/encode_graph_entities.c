@@ -0,0 +1,225 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "encode_v10.h"
+#include "../../../datatypes/datatypes.h"
+
+// entities are encoded into an in-memory buffer, saved as a single string
+// buffer per payload, such that decoding can be spread across threads
+// all fields are little-endian 64-bit words, strings are length prefixed
+typedef struct {
+	char *data;    // encoded entities
+	size_t len;    // number of bytes in use
+	size_t cap;    // number of bytes allocated
+} EntityBuffer;
+
+static void _BufferWrite(EntityBuffer *b, const void *data, size_t n) {
+	if(b->len + n > b->cap) {
+		b->cap = MAX(b->cap * 2, b->len + n);
+		b->data = rm_realloc(b->data, b->cap);
+	}
+	memcpy(b->data + b->len, data, n);
+	b->len += n;
+}
+
+static void _BufferWriteUnsigned(EntityBuffer *b, uint64_t v) {
+	Serializer_SwapLittleEndian(&v, 1);
+	_BufferWrite(b, &v, sizeof(v));
+}
+
+static void _BufferWriteDouble(EntityBuffer *b, double d) {
+	uint64_t bits;
+	memcpy(&bits, &d, sizeof(bits));
+	_BufferWriteUnsigned(b, bits);
+}
+
+// overwrite the word at 'offset'
+static void _BufferSetUnsigned(EntityBuffer *b, size_t offset, uint64_t v) {
+	Serializer_SwapLittleEndian(&v, 1);
+	memcpy(b->data + offset, &v, sizeof(v));
+}
+
+static void _SaveSIValue(EntityBuffer *b, const SIValue *v) {
+	/* Format:
+	 * SIType
+	 * Value */
+	_BufferWriteUnsigned(b, v->type);
+	switch(v->type) {
+	case T_BOOL:
+	case T_INT64:
+		_BufferWriteUnsigned(b, v->longval);
+		return;
+	case T_DOUBLE:
+		_BufferWriteDouble(b, v->doubleval);
+		return;
+	case T_STRING: {
+		size_t len = strlen(v->stringval);
+		_BufferWriteUnsigned(b, len);
+		_BufferWrite(b, v->stringval, len);
+		return;
+	}
+	case T_ARRAY: {
+		uint len = SIArray_Length(*v);
+		_BufferWriteUnsigned(b, len);
+		for(uint i = 0; i < len; i++) {
+			SIValue elem = SIArray_Get(*v, i);
+			_SaveSIValue(b, &elem);
+		}
+		return;
+	}
+	case T_POINT:
+		_BufferWriteDouble(b, Point_lat(*v));
+		_BufferWriteDouble(b, Point_lon(*v));
+		return;
+	case T_NULL:
+		return; // No data beyond the type needs to be encoded for a NULL value.
+	default:
+		ASSERT(0 && "Attempted to serialize value of invalid type.");
+	}
+}
+
+static void _SaveEntity(EntityBuffer *b, const GraphEntity *e, int label,
+		bool node) {
+	/* Format:
+	 *  #bytes following
+	 *  ID
+	 *  label (nodes only), GRAPH_NO_LABEL if unlabeled
+	 *  #properties N
+	 *  (name, value type, value) X N
+	 * the length prefix allows the decoder to allocate entities
+	 * without decoding their properties */
+
+	size_t len_offset = b->len;
+	_BufferWriteUnsigned(b, 0);
+
+	_BufferWriteUnsigned(b, ENTITY_GET_ID(e));
+	if(node) _BufferWriteUnsigned(b, (int64_t)label);
+	_BufferWriteUnsigned(b, ENTITY_PROP_COUNT(e));
+
+	uint cursor = 0;
+	SIValue *value;
+	Attribute_ID attr_id;
+	while(GraphEntity_NextProperty(e, &cursor, &attr_id, &value)) {
+		_BufferWriteUnsigned(b, attr_id);
+		_SaveSIValue(b, value);
+	}
+
+	_BufferSetUnsigned(b, len_offset, b->len - len_offset - sizeof(uint64_t));
+}
+
+static void _RdbSaveDeletedEntities_v10(RedisModuleIO *rdb, GraphContext *gc,
+									   uint64_t deleted_entities_to_encode, uint64_t *deleted_id_list) {
+	// Get the number of deleted entities already encoded.
+	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
+
+	// Iterated over the required range in the datablock deleted items.
+	for(uint64_t i = offset; i < offset + deleted_entities_to_encode; i++) {
+		RedisModule_SaveUnsigned(rdb, deleted_id_list[i]);
+	}
+}
+
+void RdbSaveDeletedNodes_v10(RedisModuleIO *rdb, GraphContext *gc,
+							uint64_t deleted_nodes_to_encode) {
+	/* Format:
+	 * node id X N */
+
+	if(deleted_nodes_to_encode == 0) return;
+	// Get deleted nodes list.
+	uint64_t *deleted_nodes_list = Serializer_Graph_GetDeletedNodesList(gc->g);
+	_RdbSaveDeletedEntities_v10(rdb, gc, deleted_nodes_to_encode, deleted_nodes_list);
+}
+
+void RdbSaveDeletedEdges_v10(RedisModuleIO *rdb, GraphContext *gc,
+							uint64_t deleted_edges_to_encode) {
+	/* Format:
+	 * edge id X N */
+
+	if(deleted_edges_to_encode == 0) return;
+	// Get deleted edges list.
+	uint64_t *deleted_edges_list = Serializer_Graph_GetDeletedEdgesList(gc->g);
+	_RdbSaveDeletedEntities_v10(rdb, gc, deleted_edges_to_encode, deleted_edges_list);
+}
+
+void RdbSaveNodes_v10(RedisModuleIO *rdb, GraphContext *gc, uint64_t nodes_to_encode) {
+	/* Format:
+	 * a single buffer holding nodes_to_encode nodes:
+	 *  #bytes following
+	 *  ID
+	 *  label
+	 *  #properties N
+	 *  (name, value type, value) X N
+	 */
+
+	if(nodes_to_encode == 0) return;
+	// Get graph's node count.
+	uint64_t graph_nodes = Graph_NodeCount(gc->g);
+	// Get the number of nodes already encoded.
+	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
+
+	// Get datablock iterator from context, already set to offset by a previous encodeing of nodes, or create new one.
+	DataBlockIterator *iter = GraphEncodeContext_GetDatablockIterator(gc->encoding_context);
+	if(!iter) {
+		iter = Graph_ScanNodes(gc->g);
+		GraphEncodeContext_SetDatablockIterator(gc->encoding_context, iter);
+	}
+
+	EntityBuffer b = {.data = NULL, .len = 0, .cap = 0};
+	for(uint64_t i = 0; i < nodes_to_encode; i++) {
+		GraphEntity e;
+		e.entity = (Entity *)DataBlockIterator_Next(iter, &e.id);
+		_SaveEntity(&b, &e, Graph_GetNodeLabel(gc->g, e.id), true);
+	}
+	RedisModule_SaveStringBuffer(rdb, b.data, b.len);
+	rm_free(b.data);
+
+	// Check if done encodeing nodes.
+	if(offset + nodes_to_encode == graph_nodes) {
+		DataBlockIterator_Free(iter);
+		iter = NULL;
+		GraphEncodeContext_SetDatablockIterator(gc->encoding_context, iter);
+	}
+}
+
+void RdbSaveEdges_v10(RedisModuleIO *rdb, GraphContext *gc, uint64_t edges_to_encode) {
+	/* Format:
+	 * a single buffer holding edges_to_encode edges:
+	 *  #bytes following
+	 *  edge ID
+	 *  #properties N
+	 *  (name, value type, value) X N
+	 * edge endpoints and relation type are captured by the relation matrices
+	 * */
+
+	if(edges_to_encode == 0) return;
+	// Get graph's edge count.
+	uint64_t graph_edges = Graph_EdgeCount(gc->g);
+	// Get the number of edges already encoded.
+	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
+
+	// Get datablock iterator from context, already set to offset by a previous encodeing of edges, or create new one.
+	DataBlockIterator *iter = GraphEncodeContext_GetDatablockIterator(gc->encoding_context);
+	if(!iter) {
+		iter = Graph_ScanEdges(gc->g);
+		GraphEncodeContext_SetDatablockIterator(gc->encoding_context, iter);
+	}
+
+	EntityBuffer b = {.data = NULL, .len = 0, .cap = 0};
+	for(uint64_t i = 0; i < edges_to_encode; i++) {
+		GraphEntity e;
+		e.entity = (Entity *)DataBlockIterator_Next(iter, &e.id);
+		_SaveEntity(&b, &e, GRAPH_NO_LABEL, false);
+	}
+	RedisModule_SaveStringBuffer(rdb, b.data, b.len);
+	rm_free(b.data);
+
+	// Check if done encodeing edges.
+	if(offset + edges_to_encode == graph_edges) {
+		DataBlockIterator_Free(iter);
+		iter = NULL;
+		GraphEncodeContext_SetDatablockIterator(gc->encoding_context, iter);
+	}
+}
+
@@ -0,0 +1,138 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "encode_v10.h"
+
+// saves 'n' 64-bit words as a single little-endian buffer
+// 'words' is converted in place and left in little-endian order
+static void _RdbSaveWords(RedisModuleIO *rdb, uint64_t *words, uint64_t n) {
+	Serializer_SwapLittleEndian(words, n);
+	RedisModule_SaveStringBuffer(rdb, (const char *)words, sizeof(uint64_t) * n);
+}
+
+static void _RdbSaveMatrix(RedisModuleIO *rdb, GrB_Matrix M) {
+	/* Format:
+	 *  #rows
+	 *  #columns
+	 *  hypersparse
+	 *  #vectors (hypersparse only)
+	 *  jumbled
+	 *  Ap
+	 *  Ah (hypersparse only)
+	 *  Aj
+	 *  Ax
+	 * the arrays are the matrix CSR / HyperCSR representation
+	 * as exported by GraphBLAS, 64-bit words are saved little-endian */
+
+	ExportedMatrix A;
+	Serializer_ExportMatrix(M, &A);
+
+	RedisModule_SaveUnsigned(rdb, A.nrows);
+	RedisModule_SaveUnsigned(rdb, A.ncols);
+	RedisModule_SaveUnsigned(rdb, A.hyper);
+	if(A.hyper) RedisModule_SaveUnsigned(rdb, A.nvec);
+	RedisModule_SaveUnsigned(rdb, A.jumbled);
+
+	// only the populated prefix of each array is saved
+	// the exported arrays are a copy, converting them in place is safe
+	_RdbSaveWords(rdb, A.Ap, A.nvec + 1);
+	if(A.hyper) _RdbSaveWords(rdb, A.Ah, A.nvec);
+	_RdbSaveWords(rdb, A.Aj, A.nvals);
+	if(A.type_size == sizeof(uint64_t)) {
+		_RdbSaveWords(rdb, A.Ax, A.nvals);
+	} else {
+		// boolean values, single bytes
+		RedisModule_SaveStringBuffer(rdb, (const char *)A.Ax,
+				A.type_size * A.nvals);
+	}
+
+	Serializer_FreeExportedMatrix(&A);
+}
+
+static void _RdbSaveMultiEdgeStore(RedisModuleIO *rdb, const MultiEdgeStore *store) {
+	/* Format:
+	 *  #holes
+	 *  packed edge IDs
+	 *  lists, (offset, len | cap << 32) per list
+	 *  free lists IDs
+	 * list IDs are kept as is, as relation matrices entries refer to them
+	 * all buffers hold little-endian 64-bit words */
+
+	RedisModule_SaveUnsigned(rdb, store->holes);
+
+	// the store is shared with the live graph, convert copies
+	uint64_t ids_count = store->size;
+	uint64_t list_count = array_len(store->lists);
+	uint64_t free_count = array_len(store->free_lists);
+	uint64_t *words = rm_malloc(sizeof(uint64_t) *
+			(ids_count + list_count * 2 + free_count + 1));
+
+	memcpy(words, store->ids, sizeof(EdgeID) * ids_count);
+	_RdbSaveWords(rdb, words, ids_count);
+
+	for(uint64_t i = 0; i < list_count; i++) {
+		const MultiEdgeList *l = store->lists + i;
+		words[i * 2]     = l->offset;
+		words[i * 2 + 1] = (uint64_t)l->len | ((uint64_t)l->cap << 32);
+	}
+	_RdbSaveWords(rdb, words, list_count * 2);
+
+	memcpy(words, store->free_lists, sizeof(uint64_t) * free_count);
+	_RdbSaveWords(rdb, words, free_count);
+
+	rm_free(words);
+}
+
+static void _RdbSaveRelation(RedisModuleIO *rdb, Graph *g, int r) {
+	/* Format:
+	 *  #edges
+	 *  relation matrix
+	 *  has transposed matrix
+	 *  transposed relation matrix (if maintained)
+	 *  multi-edge store */
+
+	RedisModule_SaveUnsigned(rdb, Graph_RelationEdgeCount(g, r));
+	_RdbSaveMatrix(rdb, Graph_GetRelationMatrix(g, r));
+
+	bool maintain_transpose;
+	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
+	RedisModule_SaveUnsigned(rdb, maintain_transpose);
+	if(maintain_transpose) {
+		_RdbSaveMatrix(rdb, Graph_GetTransposedRelationMatrix(g, r));
+	}
+
+	_RdbSaveMultiEdgeStore(rdb, g->multi_edges[r]);
+}
+
+uint64_t RdbMatricesCount_v10(const Graph *g) {
+	// adjacency matrices, label matrices and relations
+	return 1 + Graph_LabelTypeCount(g) + Graph_RelationTypeCount(g);
+}
+
+void RdbSaveMatrices_v10(RedisModuleIO *rdb, GraphContext *gc,
+						 uint64_t matrices_to_encode) {
+	/* Format:
+	 * (unit ID, unit) X matrices_to_encode
+	 * unit 0 is the adjacency matrix followed by its transpose
+	 * units 1 to L are label matrices
+	 * units L + 1 to L + R are relations */
+
+	Graph *g = gc->g;
+	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
+	uint64_t label_count = Graph_LabelTypeCount(g);
+
+	for(uint64_t i = offset; i < offset + matrices_to_encode; i++) {
+		RedisModule_SaveUnsigned(rdb, i);
+		if(i == 0) {
+			_RdbSaveMatrix(rdb, Graph_GetAdjacencyMatrix(g));
+			_RdbSaveMatrix(rdb, Graph_GetTransposedAdjacencyMatrix(g));
+		} else if(i <= label_count) {
+			_RdbSaveMatrix(rdb, Graph_GetLabelMatrix(g, i - 1));
+		} else {
+			_RdbSaveRelation(rdb, g, i - 1 - label_count);
+		}
+	}
+}
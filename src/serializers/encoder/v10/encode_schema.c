@@ -4,7 +4,7 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
-#include "encode_v9.h"
+#include "encode_v10.h"
 
 static void _RdbSaveAttributeKeys(RedisModuleIO *rdb, GraphContext *gc) {
 	/* Format:
@@ -31,12 +31,32 @@ static inline void _RdbSaveIndexData(RedisModuleIO *rdb, Index *idx) {
 	}
 }
 
+static void _RdbSaveCompositeIndex(RedisModuleIO *rdb, CompositeIndex *idx) {
+	/* Format:
+	 * #key fields
+	 * key field X #key fields
+	 * #included fields
+	 * included field X #included fields */
+
+	RedisModule_SaveUnsigned(rdb, idx->fields_count);
+	for(uint i = 0; i < idx->fields_count; i++) {
+		RedisModule_SaveStringBuffer(rdb, idx->fields[i], strlen(idx->fields[i]) + 1);
+	}
+
+	RedisModule_SaveUnsigned(rdb, idx->included_count);
+	for(uint i = 0; i < idx->included_count; i++) {
+		RedisModule_SaveStringBuffer(rdb, idx->included[i], strlen(idx->included[i]) + 1);
+	}
+}
+
 static void _RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
 	/* Format:
 	 * id
 	 * name
 	 * #indices
-	 * (index type, indexed property) X M */
+	 * (index type, indexed property) X M
+	 * #composite indices
+	 * composite index X #composite indices */
 
 	// Schema ID.
 	RedisModule_SaveUnsigned(rdb, s->id);
@@ -52,9 +72,16 @@ static void _RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
 
 	// Fulltext indices.
 	_RdbSaveIndexData(rdb, s->fulltextIdx);
+
+	// Composite indices.
+	uint composite_count = array_len(s->composite_indices);
+	RedisModule_SaveUnsigned(rdb, composite_count);
+	for(uint i = 0; i < composite_count; i++) {
+		_RdbSaveCompositeIndex(rdb, s->composite_indices[i]);
+	}
 }
 
-void RdbSaveGraphSchema_v9(RedisModuleIO *rdb, GraphContext *gc) {
+void RdbSaveGraphSchema_v10(RedisModuleIO *rdb, GraphContext *gc) {
 	/* Format:
 	 * attribute keys (unified schema)
 	 * #node schemas
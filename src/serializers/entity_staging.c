@@ -0,0 +1,121 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "entity_staging.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../util/thpool/pools.h"
+
+// number of tasks per participating thread, evens out uneven tasks
+#define TASKS_PER_THREAD 4
+
+// context of a flush, shared by the threads attaching staged properties
+typedef struct {
+	EntityStaging *staging;  // staging being flushed
+	uint task_count;         // number of tasks
+} StagingFlush;
+
+static void _AttachProperties(EntityStaging *staging, StagedEntity *se) {
+	for(uint i = 0; i < se->prop_count; i++) {
+		uint64_t idx = se->offset + i;
+		GraphEntity_MoveProperty(&se->e, staging->attrs[idx], staging->values + idx);
+		SIValue_Free(staging->values[idx]);
+	}
+}
+
+// attach the properties of a task's share of entities
+// plain entities are split into contiguous ranges, columnar entities are
+// split by partition as property columns are not thread-safe
+static void _RunTask(EntityStaging *staging, uint task, uint task_count) {
+	uint64_t n = array_len(staging->plain);
+	uint64_t from = n * task / task_count;
+	uint64_t to = n * (task + 1) / task_count;
+	for(uint64_t i = from; i < to; i++) {
+		_AttachProperties(staging, staging->plain + i);
+	}
+
+	n = array_len(staging->columnar);
+	for(uint64_t i = 0; i < n; i++) {
+		StagedEntity *se = staging->columnar + i;
+		if(se->partition % task_count != task) continue;
+		_AttachProperties(staging, se);
+	}
+}
+
+static void _FlushTask(void *ctx, uint task) {
+	StagingFlush *flush = (StagingFlush *)ctx;
+	_RunTask(flush->staging, task, flush->task_count);
+}
+
+EntityStaging *EntityStaging_New(uint64_t entity_count) {
+	EntityStaging *staging = rm_malloc(sizeof(EntityStaging));
+	staging->plain     =  array_new(StagedEntity, entity_count);
+	staging->columnar  =  array_new(StagedEntity, 0);
+	staging->current   =  NULL;
+	staging->attrs     =  array_new(Attribute_ID, entity_count);
+	staging->values    =  array_new(SIValue, entity_count);
+	return staging;
+}
+
+void EntityStaging_AddEntity(EntityStaging *staging, const GraphEntity *e,
+							 uint partition) {
+	ASSERT(staging != NULL && e != NULL);
+
+	StagedEntity se;
+	se.e = *e;
+	se.offset = array_len(staging->attrs);
+	se.prop_count = 0;
+	se.partition = partition;
+
+	if(ENTITY_IS_COLUMNAR(e->entity)) {
+		array_append(staging->columnar, se);
+		staging->current = &array_tail(staging->columnar);
+	} else {
+		array_append(staging->plain, se);
+		staging->current = &array_tail(staging->plain);
+	}
+}
+
+void EntityStaging_AddProperty(EntityStaging *staging, Attribute_ID attr_id,
+							   SIValue v) {
+	ASSERT(staging != NULL && staging->current != NULL);
+
+	array_append(staging->attrs, attr_id);
+	array_append(staging->values, v);
+	staging->current->prop_count++;
+}
+
+void EntityStaging_Flush(EntityStaging *staging) {
+	ASSERT(staging != NULL);
+
+	// small flushes are attached on the calling thread
+	StagingFlush flush = {.staging = staging, .task_count = 1};
+	if(array_len(staging->values) >= ENTITY_STAGING_PARALLEL_MIN) {
+		flush.task_count = (ThreadPools_TaskCount() + 1) * TASKS_PER_THREAD;
+	}
+	ThreadPools_RunTasks(_FlushTask, &flush, flush.task_count);
+
+	array_clear(staging->plain);
+	array_clear(staging->columnar);
+	array_clear(staging->attrs);
+	array_clear(staging->values);
+	staging->current = NULL;
+}
+
+void EntityStaging_Free(EntityStaging *staging) {
+	ASSERT(staging != NULL);
+
+	// release properties which were never attached
+	uint64_t n = array_len(staging->values);
+	for(uint64_t i = 0; i < n; i++) SIValue_Free(staging->values[i]);
+
+	array_free(staging->plain);
+	array_free(staging->columnar);
+	array_free(staging->attrs);
+	array_free(staging->values);
+	rm_free(staging);
+}
@@ -0,0 +1,68 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../value.h"
+#include "../graph/entities/graph_entity.h"
+
+// EntityStaging buffers the properties of entities read from a buffer
+// staged values may refer to the buffer, e.g. strings of a mapped snapshot
+// or of a bulk insert batch, once read, staged properties are attached to
+// their entities concurrently on the task thread pool, duplicating
+// referred values and moving owned values without cloning them
+
+// Staged properties below this count are attached on the calling thread.
+#define ENTITY_STAGING_PARALLEL_MIN 8192
+
+typedef struct {
+	GraphEntity e;          // Allocated entity.
+	uint64_t offset;        // Position of entity's first staged property.
+	uint prop_count;        // Number of staged properties.
+	uint partition;         // Columns partition, columnar entities only.
+} StagedEntity;
+
+typedef struct {
+	StagedEntity *plain;    // Entities holding their own properties.
+	StagedEntity *columnar; // Entities whose properties reside in columns.
+	StagedEntity *current;  // Entity receiving staged properties.
+	Attribute_ID *attrs;    // Staged properties attribute IDs.
+	SIValue *values;        // Staged properties values.
+} EntityStaging;
+
+EntityStaging *EntityStaging_New
+(
+	uint64_t entity_count   // expected number of entities
+);
+
+// stage entity, properties staged next belong to it
+// columnar entities of the same label must share a partition
+void EntityStaging_AddEntity
+(
+	EntityStaging *staging,
+	const GraphEntity *e,
+	uint partition
+);
+
+// stage a property of the last staged entity, staging takes ownership of v
+// v may refer to memory which outlives the flush rather than own it
+void EntityStaging_AddProperty
+(
+	EntityStaging *staging,
+	Attribute_ID attr_id,
+	SIValue v
+);
+
+// attach staged properties to their entities and clear staging
+void EntityStaging_Flush
+(
+	EntityStaging *staging
+);
+
+void EntityStaging_Free
+(
+	EntityStaging *staging
+);
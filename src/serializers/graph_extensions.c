@@ -6,10 +6,12 @@
 
 #include "graph_extensions.h"
 #include "../RG.h"
+#include "../util/rmalloc.h"
 #include "../util/datablock/oo_datablock.h"
 
 // Functions declerations - implemented in graph.c
 void Graph_FormConnection(Graph *g, NodeID src, NodeID dest, EdgeID edge_id, int r);
+void Graph_InitNodeEntity(const Graph *g, Entity *en, int label);
 
 inline void Serializer_Graph_MarkEdgeDeleted(Graph *g, EdgeID id) {
 	DataBlock_MarkAsDeletedOutOfOrder(g->edges, id);
@@ -19,34 +21,134 @@ inline void Serializer_Graph_MarkNodeDeleted(Graph *g, NodeID id) {
 	DataBlock_MarkAsDeletedOutOfOrder(g->nodes, id);
 }
 
-void Serializer_Graph_SetNode(Graph *g, NodeID id, int label, Node *n) {
+void Serializer_Graph_AllocateNode(Graph *g, NodeID id, int label, Node *n) {
 	ASSERT(g);
 
 	Entity *en = DataBlock_AllocateItemOutOfOrder(g->nodes, id);
-	en->prop_count = 0;
-	en->properties = NULL;
+	Graph_InitNodeEntity(g, en, label);
 	n->id = id;
 	n->entity = en;
+}
+
+void Serializer_Graph_SetNode(Graph *g, NodeID id, int label, Node *n) {
+	Serializer_Graph_AllocateNode(g, id, label, n);
 	if(label != GRAPH_NO_LABEL) {
 		// Set matrix at position [id, id]
-		GrB_Matrix m = Graph_GetLabelMatrix(g, label);
-		GrB_Matrix_setElement_BOOL(m, true, id, id);
+		RG_Matrix m = g->labels[label];
+		g->SynchronizeMatrix(g, m);
+		RG_Matrix_setElement_BOOL(m, id, id);
 	}
 }
 
 // Set a given edge in the graph - Used for deserialization of graph.
 void Serializer_Graph_SetEdge(Graph *g, EdgeID edge_id, NodeID src, NodeID dest, int r, Edge *e) {
-	GrB_Info info;
+	Serializer_Graph_AllocateEdge(g, edge_id, e);
+	e->relationID = r;
+	e->srcNodeID = src;
+	e->destNodeID = dest;
+	Graph_FormConnection(g, src, dest, edge_id, r);
+}
 
+void Serializer_Graph_AllocateEdge(Graph *g, EdgeID edge_id, Edge *e) {
 	Entity *en = DataBlock_AllocateItemOutOfOrder(g->edges, edge_id);
 	en->prop_count = 0;
 	en->properties = NULL;
 	e->id = edge_id;
 	e->entity = en;
-	e->relationID = r;
-	e->srcNodeID = src;
-	e->destNodeID = dest;
-	Graph_FormConnection(g, src, dest, edge_id, r);
+}
+
+void Serializer_Graph_SetMatrix(RG_Matrix m, GrB_Matrix A) {
+	ASSERT(m && A);
+
+	// matrix is expected to be pristine, no pending changes to discard
+	// note: new matrices are marked dirty, check deltas instead
+	GrB_Index nvals;
+	GrB_Matrix_nvals(&nvals, m->delta_plus);
+	ASSERT(nvals == 0);
+	GrB_Matrix_nvals(&nvals, m->delta_minus);
+	ASSERT(nvals == 0);
+
+	GrB_Matrix_free(&m->grb_matrix);
+	m->grb_matrix = A;
+
+	// matrix iterator requires matrix format to be sparse
+	// as guaranteed by RG_Matrix_New
+	GrB_Info info = GxB_set(A, GxB_SPARSITY_CONTROL, GxB_SPARSE);
+	ASSERT(info == GrB_SUCCESS);
+
+	// keep delta matrices dimensions in line with the imported matrix
+	GrB_Index n;
+	GrB_Matrix_nrows(&n, A);
+	info = RG_Matrix_Resize(m, n);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+}
+
+void Serializer_ExportMatrix(GrB_Matrix M, ExportedMatrix *exported) {
+	ASSERT(M && exported);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	// exporting a matrix frees it, export a copy
+	GrB_Matrix A;
+	info = GrB_Matrix_dup(&A, M);
+	ASSERT(info == GrB_SUCCESS);
+
+	int sparsity;
+	GxB_Matrix_Option_get(A, GxB_SPARSITY_STATUS, &sparsity);
+	exported->hyper = (sparsity == GxB_HYPERSPARSE);
+	exported->Ah = NULL;
+
+	GrB_Index Ap_size;
+	GrB_Index Ah_size;
+	GrB_Index Aj_size;
+	GrB_Index Ax_size;
+	if(exported->hyper) {
+		info = GxB_Matrix_export_HyperCSR(&A, &exported->type,
+				&exported->nrows, &exported->ncols, &exported->Ap,
+				&exported->Ah, &exported->Aj, &exported->Ax, &Ap_size,
+				&Ah_size, &Aj_size, &Ax_size, &exported->nvec,
+				&exported->jumbled, NULL);
+	} else {
+		info = GxB_Matrix_export_CSR(&A, &exported->type, &exported->nrows,
+				&exported->ncols, &exported->Ap, &exported->Aj, &exported->Ax,
+				&Ap_size, &Aj_size, &Ax_size, &exported->jumbled, NULL);
+		exported->nvec = exported->nrows;
+	}
+	ASSERT(info == GrB_SUCCESS);
+
+	GxB_Type_size(&exported->type_size, exported->type);
+	exported->nvals = exported->Ap[exported->nvec];
+}
+
+void Serializer_FreeExportedMatrix(ExportedMatrix *exported) {
+	ASSERT(exported);
+
+	// exported arrays are owned by the caller
+	rm_free(exported->Ap);
+	rm_free(exported->Ah);
+	rm_free(exported->Aj);
+	rm_free(exported->Ax);
+}
+
+void Serializer_SwapLittleEndian(uint64_t *words, uint64_t n) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	for(uint64_t i = 0; i < n; i++) words[i] = __builtin_bswap64(words[i]);
+#else
+	UNUSED(words);
+	UNUSED(n);
+#endif
+}
+
+void Serializer_Graph_SetRelationEdges(Graph *g, int r, MultiEdgeStore *store,
+									   uint64_t edge_count) {
+	ASSERT(g && store);
+	ASSERT(r < Graph_RelationTypeCount(g));
+
+	MultiEdgeStore_Free(g->multi_edges[r]);
+	g->multi_edges[r] = store;
+	g->stats.edge_count[r] = edge_count;
 }
 
 
@@ -8,9 +8,48 @@
 
 #include "../graph/graph.h"
 
+// CSR / HyperCSR arrays exported from a GraphBLAS matrix
+typedef struct {
+	GrB_Type type;      // Matrix element type.
+	size_t type_size;   // Size of a single element.
+	GrB_Index nrows;    // Number of rows.
+	GrB_Index ncols;    // Number of columns.
+	GrB_Index nvec;     // Number of row vectors, nrows unless hypersparse.
+	GrB_Index nvals;    // Number of entries.
+	bool hyper;         // Matrix is hypersparse.
+	bool jumbled;       // Column indices within a row may be unsorted.
+	GrB_Index *Ap;      // Row pointers, nvec + 1 entries.
+	GrB_Index *Ah;      // Row indices, hypersparse only.
+	GrB_Index *Aj;      // Column indices, nvals entries.
+	void *Ax;           // Values, nvals entries.
+} ExportedMatrix;
+
 // Sets a node in the graph
 void Serializer_Graph_SetNode(Graph *g, NodeID id, int label, Node *n);
 
+// Allocates a node entity without updating the label matrix.
+void Serializer_Graph_AllocateNode(Graph *g, NodeID id, int label, Node *n);
+
+// Allocates an edge entity without forming its connection.
+void Serializer_Graph_AllocateEdge(Graph *g, EdgeID edge_id, Edge *e);
+
+// Replaces the matrix underlying m with A, m takes ownership of A.
+void Serializer_Graph_SetMatrix(RG_Matrix m, GrB_Matrix A);
+
+// Exports a copy of M, M is left intact.
+void Serializer_ExportMatrix(GrB_Matrix M, ExportedMatrix *exported);
+
+// Releases exported matrix arrays.
+void Serializer_FreeExportedMatrix(ExportedMatrix *exported);
+
+// Converts n 64-bit words between host and little-endian byte order, in place.
+// A no-op on little-endian hosts.
+void Serializer_SwapLittleEndian(uint64_t *words, uint64_t n);
+
+// Replaces relation r multi-edge store and sets its edge count.
+void Serializer_Graph_SetRelationEdges(Graph *g, int r, MultiEdgeStore *store,
+									   uint64_t edge_count);
+
 // Set a given edge in the graph.
 void Serializer_Graph_SetEdge(Graph *g, EdgeID edge_id, NodeID src, NodeID dest, int r, Edge *e);
 
@@ -0,0 +1,794 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "graph_snapshot.h"
+#include "serializers_include.h"
+#include "entity_staging.h"
+#include "../datatypes/point.h"
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Snapshot format:
+ *  magic
+ *  version
+ *  #nodes, #deleted nodes, #edges, #deleted edges, #labels, #relations
+ *  attribute keys
+ *  node schemas
+ *  relation schemas
+ *  nodes
+ *  deleted node IDs
+ *  edges
+ *  deleted edge IDs
+ *  adjacency matrix, transposed adjacency matrix
+ *  label matrices
+ *  relations
+ *
+ * all fields are 8 bytes wide, buffers are length prefixed and padded to
+ * 8 bytes, matrix arrays start on a page boundary */
+
+#define SNAPSHOT_MAGIC "RGSNAP\0\0"
+#define SNAPSHOT_PAGE_SIZE 4096
+
+//------------------------------------------------------------------------------
+// Writer
+//------------------------------------------------------------------------------
+
+typedef struct {
+	FILE *f;          // Snapshot file.
+	uint64_t offset;  // Number of bytes written.
+} SnapshotWriter;
+
+static void _WriteBytes(SnapshotWriter *w, const void *data, uint64_t n) {
+	// write errors are detected once the file is closed
+	if(n > 0) fwrite(data, 1, n, w->f);
+	w->offset += n;
+}
+
+static void _WriteUnsigned(SnapshotWriter *w, uint64_t v) {
+	_WriteBytes(w, &v, sizeof(v));
+}
+
+static void _WritePadding(SnapshotWriter *w, uint64_t alignment) {
+	static const char zeros[SNAPSHOT_PAGE_SIZE] = {0};
+	_WriteBytes(w, zeros, (alignment - w->offset % alignment) % alignment);
+}
+
+static void _WriteBuffer(SnapshotWriter *w, const void *data, uint64_t n) {
+	_WriteUnsigned(w, n);
+	_WriteBytes(w, data, n);
+	_WritePadding(w, sizeof(uint64_t));
+}
+
+static void _WriteString(SnapshotWriter *w, const char *s) {
+	_WriteBuffer(w, s, strlen(s) + 1);
+}
+
+// page aligned buffer
+static void _WriteArray(SnapshotWriter *w, const void *data, uint64_t n) {
+	_WriteUnsigned(w, n);
+	_WritePadding(w, SNAPSHOT_PAGE_SIZE);
+	_WriteBytes(w, data, n);
+	_WritePadding(w, sizeof(uint64_t));
+}
+
+static void _SaveSIValue(SnapshotWriter *w, const SIValue *v) {
+	/* Format:
+	 * SIType
+	 * Value */
+
+	_WriteUnsigned(w, v->type);
+	switch(v->type) {
+	case T_BOOL:
+	case T_INT64:
+		_WriteUnsigned(w, v->longval);
+		return;
+	case T_DOUBLE: {
+		uint64_t bits;
+		memcpy(&bits, &v->doubleval, sizeof(bits));
+		_WriteUnsigned(w, bits);
+		return;
+	}
+	case T_STRING:
+		_WriteString(w, v->stringval);
+		return;
+	case T_ARRAY: {
+		uint len = SIArray_Length(*v);
+		_WriteUnsigned(w, len);
+		for(uint i = 0; i < len; i++) {
+			SIValue elem = SIArray_Get(*v, i);
+			_SaveSIValue(w, &elem);
+		}
+		return;
+	}
+	case T_POINT: {
+		double coords[2] = {Point_lat(*v), Point_lon(*v)};
+		_WriteBytes(w, coords, sizeof(coords));
+		return;
+	}
+	case T_NULL:
+		return;
+	default:
+		ASSERT(0 && "Attempted to serialize value of invalid type.");
+	}
+}
+
+static void _SaveEntity(SnapshotWriter *w, const GraphEntity *e) {
+	/* Format:
+	 * ID
+	 * #properties N
+	 * (attribute ID, value) X N */
+
+	_WriteUnsigned(w, ENTITY_GET_ID(e));
+	_WriteUnsigned(w, ENTITY_PROP_COUNT(e));
+
+	uint cursor = 0;
+	SIValue *value;
+	Attribute_ID attr_id;
+	while(GraphEntity_NextProperty(e, &cursor, &attr_id, &value)) {
+		_WriteUnsigned(w, attr_id);
+		_SaveSIValue(w, value);
+	}
+}
+
+static void _SaveCompositeIndex(SnapshotWriter *w, CompositeIndex *idx) {
+	/* Format:
+	 * #key fields
+	 * key field X #key fields
+	 * #included fields
+	 * included field X #included fields */
+
+	_WriteUnsigned(w, idx->fields_count);
+	for(uint i = 0; i < idx->fields_count; i++) _WriteString(w, idx->fields[i]);
+
+	_WriteUnsigned(w, idx->included_count);
+	for(uint i = 0; i < idx->included_count; i++) _WriteString(w, idx->included[i]);
+}
+
+static void _SaveSchema(SnapshotWriter *w, Schema *s) {
+	/* Format:
+	 * id
+	 * name
+	 * #indices
+	 * (index type, indexed property) X M
+	 * #composite indices
+	 * composite index X #composite indices */
+
+	_WriteUnsigned(w, s->id);
+	_WriteString(w, s->name);
+	_WriteUnsigned(w, Schema_IndexCount(s));
+
+	Index *indices[2] = {s->index, s->fulltextIdx};
+	for(int i = 0; i < 2; i++) {
+		Index *idx = indices[i];
+		if(!idx) continue;
+		for(uint j = 0; j < idx->fields_count; j++) {
+			_WriteUnsigned(w, idx->type);
+			_WriteString(w, idx->fields[j]);
+		}
+	}
+
+	uint composite_count = array_len(s->composite_indices);
+	_WriteUnsigned(w, composite_count);
+	for(uint i = 0; i < composite_count; i++) {
+		_SaveCompositeIndex(w, s->composite_indices[i]);
+	}
+}
+
+static void _SaveMatrix(SnapshotWriter *w, GrB_Matrix M) {
+	/* Format:
+	 *  #rows
+	 *  #columns
+	 *  hypersparse
+	 *  #vectors
+	 *  jumbled
+	 *  Ap
+	 *  Ah (hypersparse only)
+	 *  Aj
+	 *  Ax */
+
+	ExportedMatrix A;
+	Serializer_ExportMatrix(M, &A);
+
+	_WriteUnsigned(w, A.nrows);
+	_WriteUnsigned(w, A.ncols);
+	_WriteUnsigned(w, A.hyper);
+	_WriteUnsigned(w, A.nvec);
+	_WriteUnsigned(w, A.jumbled);
+
+	_WriteArray(w, A.Ap, sizeof(GrB_Index) * (A.nvec + 1));
+	if(A.hyper) _WriteArray(w, A.Ah, sizeof(GrB_Index) * A.nvec);
+	_WriteArray(w, A.Aj, sizeof(GrB_Index) * A.nvals);
+	_WriteArray(w, A.Ax, A.type_size * A.nvals);
+
+	Serializer_FreeExportedMatrix(&A);
+}
+
+static void _SaveRelation(SnapshotWriter *w, Graph *g, int r) {
+	/* Format:
+	 *  #edges
+	 *  relation matrix
+	 *  has transposed matrix
+	 *  transposed relation matrix (if maintained)
+	 *  multi-edge store */
+
+	_WriteUnsigned(w, Graph_RelationEdgeCount(g, r));
+	_SaveMatrix(w, Graph_GetRelationMatrix(g, r));
+
+	bool maintain_transpose;
+	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
+	_WriteUnsigned(w, maintain_transpose);
+	if(maintain_transpose) _SaveMatrix(w, Graph_GetTransposedRelationMatrix(g, r));
+
+	MultiEdgeStore *store = g->multi_edges[r];
+	_WriteUnsigned(w, store->holes);
+	_WriteArray(w, store->ids, sizeof(EdgeID) * store->size);
+	_WriteArray(w, store->lists, sizeof(MultiEdgeList) * array_len(store->lists));
+	_WriteArray(w, store->free_lists, sizeof(uint64_t) * array_len(store->free_lists));
+}
+
+static void _SaveEntities(SnapshotWriter *w, GraphContext *gc, bool nodes) {
+	Graph *g = gc->g;
+	DataBlockIterator *iter = (nodes) ? Graph_ScanNodes(g) : Graph_ScanEdges(g);
+	uint64_t count = (nodes) ? Graph_NodeCount(g) : Graph_EdgeCount(g);
+
+	for(uint64_t i = 0; i < count; i++) {
+		GraphEntity e;
+		e.entity = (Entity *)DataBlockIterator_Next(iter, &e.id);
+		// node label, offset by one such that 0 stands for no label
+		if(nodes) _WriteUnsigned(w, Graph_GetNodeLabel(g, e.id) + 1);
+		_SaveEntity(w, &e);
+	}
+
+	DataBlockIterator_Free(iter);
+}
+
+static void _SaveIDs(SnapshotWriter *w, const uint64_t *ids, uint64_t count) {
+	for(uint64_t i = 0; i < count; i++) _WriteUnsigned(w, ids[i]);
+}
+
+bool GraphSnapshot_Save(GraphContext *gc, const char *path, char **err) {
+	ASSERT(gc && path && err);
+
+	SnapshotWriter w = {.f = fopen(path, "wb"), .offset = 0};
+	if(w.f == NULL) {
+		asprintf(err, "Failed to open snapshot file '%s': %s", path, strerror(errno));
+		return false;
+	}
+
+	Graph *g = gc->g;
+	uint label_count = Graph_LabelTypeCount(g);
+	uint relation_count = Graph_RelationTypeCount(g);
+
+	// header
+	_WriteBytes(&w, SNAPSHOT_MAGIC, sizeof(uint64_t));
+	_WriteUnsigned(&w, GRAPH_SNAPSHOT_VERSION);
+	_WriteUnsigned(&w, Graph_NodeCount(g));
+	_WriteUnsigned(&w, Graph_DeletedNodeCount(g));
+	_WriteUnsigned(&w, Graph_EdgeCount(g));
+	_WriteUnsigned(&w, Graph_DeletedEdgeCount(g));
+	_WriteUnsigned(&w, label_count);
+	_WriteUnsigned(&w, relation_count);
+
+	// schema
+	uint attr_count = GraphContext_AttributeCount(gc);
+	_WriteUnsigned(&w, attr_count);
+	for(uint i = 0; i < attr_count; i++) _WriteString(&w, gc->string_mapping[i]);
+
+	uint schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+	_WriteUnsigned(&w, schema_count);
+	for(uint i = 0; i < schema_count; i++) _SaveSchema(&w, gc->node_schemas[i]);
+
+	schema_count = GraphContext_SchemaCount(gc, SCHEMA_EDGE);
+	_WriteUnsigned(&w, schema_count);
+	for(uint i = 0; i < schema_count; i++) _SaveSchema(&w, gc->relation_schemas[i]);
+
+	// entities
+	_SaveEntities(&w, gc, true);
+	_SaveIDs(&w, Serializer_Graph_GetDeletedNodesList(g), Graph_DeletedNodeCount(g));
+	_SaveEntities(&w, gc, false);
+	_SaveIDs(&w, Serializer_Graph_GetDeletedEdgesList(g), Graph_DeletedEdgeCount(g));
+
+	// matrices
+	_SaveMatrix(&w, Graph_GetAdjacencyMatrix(g));
+	_SaveMatrix(&w, Graph_GetTransposedAdjacencyMatrix(g));
+	for(uint i = 0; i < label_count; i++) _SaveMatrix(&w, Graph_GetLabelMatrix(g, i));
+	for(uint i = 0; i < relation_count; i++) _SaveRelation(&w, g, i);
+
+	bool failed = ferror(w.f);
+	if(fclose(w.f) != 0) failed = true;
+	if(failed) {
+		asprintf(err, "Failed to write snapshot file '%s'", path);
+		unlink(path);
+		return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Reader
+//------------------------------------------------------------------------------
+
+typedef struct {
+	const char *base;  // Mapped snapshot.
+	uint64_t size;     // Snapshot size.
+	uint64_t offset;   // Number of bytes read.
+	bool failed;       // Snapshot is truncated or malformed.
+} SnapshotReader;
+
+static const void *_ReadBytes(SnapshotReader *r, uint64_t n) {
+	if(r->failed || n > r->size - r->offset) {
+		r->failed = true;
+		return NULL;
+	}
+	const void *p = r->base + r->offset;
+	r->offset += n;
+	return p;
+}
+
+static uint64_t _ReadUnsigned(SnapshotReader *r) {
+	uint64_t v = 0;
+	const void *p = _ReadBytes(r, sizeof(v));
+	if(p) memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static void _SkipPadding(SnapshotReader *r, uint64_t alignment) {
+	_ReadBytes(r, (alignment - r->offset % alignment) % alignment);
+}
+
+static const void *_ReadBuffer(SnapshotReader *r, uint64_t *n) {
+	*n = _ReadUnsigned(r);
+	const void *p = _ReadBytes(r, *n);
+	_SkipPadding(r, sizeof(uint64_t));
+	return p;
+}
+
+// returns a pointer into the mapping, NULL if the string is malformed
+static const char *_ReadString(SnapshotReader *r) {
+	uint64_t n;
+	const char *s = _ReadBuffer(r, &n);
+	if(s == NULL || n == 0 || s[n - 1] != '\0') {
+		r->failed = true;
+		return NULL;
+	}
+	return s;
+}
+
+// returns a pointer to a page aligned array within the mapping
+static const void *_ReadAlignedBuffer(SnapshotReader *r, uint64_t *n) {
+	*n = _ReadUnsigned(r);
+	_SkipPadding(r, SNAPSHOT_PAGE_SIZE);
+	const void *p = _ReadBytes(r, *n);
+	_SkipPadding(r, sizeof(uint64_t));
+	return p;
+}
+
+// copies a page aligned array out of the mapping
+// GraphBLAS does not accept empty arrays, an empty array is loaded as
+// a single zeroed element
+static void *_ReadArray(SnapshotReader *r, size_t elem_size, GrB_Index *n) {
+	uint64_t len;
+	const void *p = _ReadAlignedBuffer(r, &len);
+	if(p == NULL) return NULL;
+
+	void *arr = rm_calloc(1, MAX(len, elem_size));
+	memcpy(arr, p, len);
+	*n = MAX(len / elem_size, 1);
+	return arr;
+}
+
+static SIValue _LoadSIValue(SnapshotReader *r) {
+	SIType t = _ReadUnsigned(r);
+	switch(t) {
+	case T_INT64:
+		return SI_LongVal(_ReadUnsigned(r));
+	case T_BOOL:
+		return SI_BoolVal(_ReadUnsigned(r));
+	case T_DOUBLE: {
+		uint64_t bits = _ReadUnsigned(r);
+		double d;
+		memcpy(&d, &bits, sizeof(d));
+		return SI_DoubleVal(d);
+	}
+	case T_STRING: {
+		// the string is cloned once attached to its entity,
+		// while the snapshot is still mapped
+		const char *s = _ReadString(r);
+		return (s) ? SI_ConstStringVal((char *)s) : SI_NullVal();
+	}
+	case T_ARRAY: {
+		uint64_t len = _ReadUnsigned(r);
+		SIValue list = SI_Array(MIN(len, r->size - r->offset));
+		for(uint64_t i = 0; i < len && !r->failed; i++) {
+			SIValue elem = _LoadSIValue(r);
+			SIArray_Append(&list, elem);
+			SIValue_Free(elem);
+		}
+		return list;
+	}
+	case T_POINT: {
+		double coords[2] = {0};
+		const void *p = _ReadBytes(r, sizeof(coords));
+		if(p) memcpy(coords, p, sizeof(coords));
+		return SI_Point(coords[0], coords[1]);
+	}
+	case T_NULL:
+		return SI_NullVal();
+	default:
+		r->failed = true;
+		return SI_NullVal();
+	}
+}
+
+static void _LoadProperties(SnapshotReader *r, EntityStaging *staging) {
+	uint64_t prop_count = _ReadUnsigned(r);
+	for(uint64_t i = 0; i < prop_count && !r->failed; i++) {
+		Attribute_ID attr_id = _ReadUnsigned(r);
+		EntityStaging_AddProperty(staging, attr_id, _LoadSIValue(r));
+	}
+}
+
+// reads a list of strings pointing into the mapping, NULL if malformed
+static const char **_ReadStrings(SnapshotReader *r) {
+	uint64_t count = _ReadUnsigned(r);
+	const char **strings = array_new(const char *, 0);
+	for(uint64_t i = 0; i < count && !r->failed; i++) {
+		const char *str = _ReadString(r);
+		if(str == NULL) break;
+		array_append(strings, str);
+	}
+
+	if(r->failed) {
+		array_free(strings);
+		return NULL;
+	}
+
+	return strings;
+}
+
+static void _LoadCompositeIndex(SnapshotReader *r, Schema *s) {
+	const char **fields = _ReadStrings(r);
+	const char **included = (fields) ? _ReadStrings(r) : NULL;
+
+	if(included != NULL && array_len(fields) > 0) {
+		CompositeIndex *idx = NULL;
+		Schema_AddCompositeIndex(&idx, s, fields, array_len(fields), included,
+				array_len(included));
+	}
+
+	if(fields) array_free(fields);
+	if(included) array_free(included);
+}
+
+static Schema *_LoadSchema(SnapshotReader *r, SchemaType type) {
+	int id = _ReadUnsigned(r);
+	const char *name = _ReadString(r);
+	if(name == NULL) return NULL;
+	Schema *s = Schema_New(name, id, type);
+
+	Index *idx = NULL;
+	uint64_t index_count = _ReadUnsigned(r);
+	for(uint64_t i = 0; i < index_count && !r->failed; i++) {
+		IndexType idx_type = _ReadUnsigned(r);
+		const char *field = _ReadString(r);
+		if(field) Schema_AddIndex(&idx, s, field, idx_type);
+	}
+
+	uint64_t composite_count = _ReadUnsigned(r);
+	for(uint64_t i = 0; i < composite_count && !r->failed; i++) {
+		_LoadCompositeIndex(r, s);
+	}
+
+	return s;
+}
+
+// loads the next matrix in the snapshot, expected to be of dimension dim
+static GrB_Matrix _LoadMatrix(SnapshotReader *r, GrB_Type type, GrB_Index dim) {
+	GrB_Index  nrows    =  _ReadUnsigned(r);
+	GrB_Index  ncols    =  _ReadUnsigned(r);
+	bool       hyper    =  _ReadUnsigned(r);
+	GrB_Index  nvec     =  _ReadUnsigned(r);
+	bool       jumbled  =  _ReadUnsigned(r);
+
+	size_t type_size;
+	GxB_Type_size(&type_size, type);
+
+	GrB_Index  Ap_size;
+	GrB_Index  Ah_size;
+	GrB_Index  Aj_size;
+	GrB_Index  Ax_size;
+	GrB_Index  *Ap  =  _ReadArray(r, sizeof(GrB_Index), &Ap_size);
+	GrB_Index  *Ah  =  (hyper) ? _ReadArray(r, sizeof(GrB_Index), &Ah_size) : NULL;
+	GrB_Index  *Aj  =  _ReadArray(r, sizeof(GrB_Index), &Aj_size);
+	void       *Ax  =  _ReadArray(r, type_size, &Ax_size);
+
+	GrB_Matrix A = NULL;
+	GrB_Info info = GrB_INVALID_VALUE;
+	// matrices are sized by the graph's node capacity
+	if(nrows != dim || ncols != dim) r->failed = true;
+	if(!r->failed) {
+		if(hyper) {
+			info = GxB_Matrix_import_HyperCSR(&A, type, nrows, ncols, &Ap, &Ah,
+					&Aj, &Ax, Ap_size, Ah_size, Aj_size, Ax_size, nvec, jumbled,
+					NULL);
+		} else {
+			info = GxB_Matrix_import_CSR(&A, type, nrows, ncols, &Ap, &Aj, &Ax,
+					Ap_size, Aj_size, Ax_size, jumbled, NULL);
+		}
+	}
+
+	if(info != GrB_SUCCESS) {
+		// arrays are left untouched by a failed import
+		r->failed = true;
+		rm_free(Ap);
+		rm_free(Ah);
+		rm_free(Aj);
+		rm_free(Ax);
+		return NULL;
+	}
+
+	return A;
+}
+
+// replaces m's matrix with the next matrix in the snapshot
+static void _LoadMatrixInto(SnapshotReader *r, Graph *g, RG_Matrix m,
+		GrB_Type type) {
+	GrB_Matrix A = _LoadMatrix(r, type, Graph_RequiredMatrixDim(g));
+	if(A) Serializer_Graph_SetMatrix(m, A);
+}
+
+static void _LoadRelation(SnapshotReader *r, Graph *g, int r_id) {
+	uint64_t edge_count = _ReadUnsigned(r);
+	_LoadMatrixInto(r, g, g->relations[r_id], GrB_UINT64);
+
+	bool saved_transpose = _ReadUnsigned(r);
+	GrB_Matrix TR = (saved_transpose) ?
+		_LoadMatrix(r, GrB_UINT64, Graph_RequiredMatrixDim(g)) : NULL;
+
+	// the graph might have been saved under a different transpose configuration
+	bool maintain_transpose;
+	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
+	if(maintain_transpose && !r->failed) {
+		if(TR == NULL) {
+			GrB_Matrix R = Graph_GetRelationMatrix(g, r_id);
+			GrB_Index n;
+			GrB_Matrix_nrows(&n, R);
+			GrB_Matrix_new(&TR, GrB_UINT64, n, n);
+			GrB_transpose(TR, NULL, NULL, R, NULL);
+		}
+		Serializer_Graph_SetMatrix(g->t_relations[r_id], TR);
+	} else if(TR != NULL) {
+		GrB_Matrix_free(&TR);
+	}
+
+	MultiEdgeStore *store = MultiEdgeStore_New();
+	store->holes = _ReadUnsigned(r);
+
+	// packed edge IDs, an empty buffer keeps the store's initial allocation
+	uint64_t len;
+	const void *ids = _ReadAlignedBuffer(r, &len);
+	if(ids && len > 0) {
+		rm_free(store->ids);
+		store->ids = rm_malloc(len);
+		memcpy(store->ids, ids, len);
+		store->size = len / sizeof(EdgeID);
+		store->cap = store->size;
+	}
+
+	const void *lists = _ReadAlignedBuffer(r, &len);
+	if(lists) {
+		array_free(store->lists);
+		store->lists = array_newlen(MultiEdgeList, len / sizeof(MultiEdgeList));
+		memcpy(store->lists, lists, len);
+	}
+
+	const void *free_lists = _ReadAlignedBuffer(r, &len);
+	if(free_lists) {
+		array_free(store->free_lists);
+		store->free_lists = array_newlen(uint64_t, len / sizeof(uint64_t));
+		memcpy(store->free_lists, free_lists, len);
+	}
+
+	Serializer_Graph_SetRelationEdges(g, r_id, store, edge_count);
+}
+
+// loads count entities, whose IDs are below id_limit
+static void _LoadEntities(SnapshotReader *r, GraphContext *gc, uint64_t count,
+						  uint64_t id_limit, bool nodes) {
+	EntityStaging *staging = EntityStaging_New(count);
+
+	for(uint64_t i = 0; i < count && !r->failed; i++) {
+		if(nodes) {
+			Node n;
+			int l = (int)_ReadUnsigned(r) - 1;
+			NodeID id = _ReadUnsigned(r);
+			if(id >= id_limit || l >= (int)Graph_LabelTypeCount(gc->g)) {
+				r->failed = true;
+				break;
+			}
+			// label matrices are loaded as a whole
+			Serializer_Graph_AllocateNode(gc->g, id, l, &n);
+			// nodes sharing a label share property columns
+			EntityStaging_AddEntity(staging, (GraphEntity *)&n, l);
+		} else {
+			Edge edge;
+			EdgeID id = _ReadUnsigned(r);
+			if(id >= id_limit) {
+				r->failed = true;
+				break;
+			}
+			// connections are loaded as a whole
+			Serializer_Graph_AllocateEdge(gc->g, id, &edge);
+			EntityStaging_AddEntity(staging, (GraphEntity *)&edge, 0);
+		}
+		_LoadProperties(r, staging);
+	}
+
+	// string properties refer to the mapping, flush while it is still mapped
+	EntityStaging_Flush(staging);
+	EntityStaging_Free(staging);
+}
+
+static void _LoadSnapshot(SnapshotReader *r, GraphContext *gc) {
+	Graph *g = gc->g;
+
+	// header
+	const void *magic = _ReadBytes(r, sizeof(uint64_t));
+	if(magic == NULL || memcmp(magic, SNAPSHOT_MAGIC, sizeof(uint64_t)) != 0 ||
+	   _ReadUnsigned(r) != GRAPH_SNAPSHOT_VERSION) {
+		r->failed = true;
+		return;
+	}
+
+	uint64_t node_count          =  _ReadUnsigned(r);
+	uint64_t deleted_node_count  =  _ReadUnsigned(r);
+	uint64_t edge_count          =  _ReadUnsigned(r);
+	uint64_t deleted_edge_count  =  _ReadUnsigned(r);
+	uint64_t label_count         =  _ReadUnsigned(r);
+	uint64_t relation_count      =  _ReadUnsigned(r);
+
+	// every entity occupies at least two fields, guard against
+	// allocating storage for a malformed snapshot
+	uint64_t max_entities = r->size / (2 * sizeof(uint64_t));
+	if(node_count + deleted_node_count > max_entities ||
+	   edge_count + deleted_edge_count > max_entities ||
+	   label_count > max_entities || relation_count > max_entities) {
+		r->failed = true;
+		return;
+	}
+
+	Graph_AllocateNodes(g, node_count + deleted_node_count);
+	Graph_AllocateEdges(g, edge_count + deleted_edge_count);
+	for(uint64_t i = 0; i < label_count; i++) Graph_AddLabel(g);
+	for(uint64_t i = 0; i < relation_count; i++) Graph_AddRelationType(g);
+
+	// schema
+	uint64_t attr_count = _ReadUnsigned(r);
+	for(uint64_t i = 0; i < attr_count && !r->failed; i++) {
+		const char *attr = _ReadString(r);
+		if(attr) GraphContext_FindOrAddAttribute(gc, attr);
+	}
+
+	uint64_t schema_count = _ReadUnsigned(r);
+	for(uint64_t i = 0; i < schema_count && !r->failed; i++) {
+		Schema *s = _LoadSchema(r, SCHEMA_NODE);
+		if(s) array_append(gc->node_schemas, s);
+	}
+
+	schema_count = _ReadUnsigned(r);
+	for(uint64_t i = 0; i < schema_count && !r->failed; i++) {
+		Schema *s = _LoadSchema(r, SCHEMA_EDGE);
+		if(s) array_append(gc->relation_schemas, s);
+	}
+
+	// entities, IDs are bound by the number of entities and deleted entities
+	uint64_t node_id_limit = node_count + deleted_node_count;
+	uint64_t edge_id_limit = edge_count + deleted_edge_count;
+	_LoadEntities(r, gc, node_count, node_id_limit, true);
+	for(uint64_t i = 0; i < deleted_node_count && !r->failed; i++) {
+		NodeID id = _ReadUnsigned(r);
+		if(id >= node_id_limit) r->failed = true;
+		else Serializer_Graph_MarkNodeDeleted(g, id);
+	}
+	_LoadEntities(r, gc, edge_count, edge_id_limit, false);
+	for(uint64_t i = 0; i < deleted_edge_count && !r->failed; i++) {
+		EdgeID id = _ReadUnsigned(r);
+		if(id >= edge_id_limit) r->failed = true;
+		else Serializer_Graph_MarkEdgeDeleted(g, id);
+	}
+
+	// matrices
+	_LoadMatrixInto(r, g, g->adjacency_matrix, GrB_BOOL);
+	_LoadMatrixInto(r, g, g->_t_adjacency_matrix, GrB_BOOL);
+	for(uint64_t i = 0; i < label_count && !r->failed; i++) {
+		_LoadMatrixInto(r, g, g->labels[i], GrB_BOOL);
+	}
+	for(uint64_t i = 0; i < relation_count && !r->failed; i++) {
+		_LoadRelation(r, g, i);
+	}
+}
+
+GraphContext *GraphSnapshot_Load(const char *graph_name, const char *path,
+								 char **err) {
+	ASSERT(graph_name && path && err);
+
+	int fd = open(path, O_RDONLY);
+	if(fd == -1) {
+		asprintf(err, "Failed to open snapshot file '%s': %s", path, strerror(errno));
+		return NULL;
+	}
+
+	struct stat st;
+	void *base = MAP_FAILED;
+	if(fstat(fd, &st) == 0 && st.st_size > 0) {
+		// a private read-only mapping, pages are faulted in
+		// as arrays are copied out of it
+		base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	close(fd);
+
+	if(base == MAP_FAILED) {
+		asprintf(err, "Failed to map snapshot file '%s'", path);
+		return NULL;
+	}
+	madvise(base, st.st_size, MADV_SEQUENTIAL);
+
+	GraphContext *gc = GraphContext_New(graph_name, GRAPH_DEFAULT_NODE_CAP,
+										GRAPH_DEFAULT_EDGE_CAP);
+	// while loading the graph, minimize matrix realloc and synchronization calls
+	Graph_SetMatrixPolicy(gc->g, RESIZE_TO_CAPACITY);
+	QueryCtx_SetGraphCtx(gc);
+
+	SnapshotReader r = {.base = base, .size = st.st_size, .offset = 0,
+						.failed = false};
+	_LoadSnapshot(&r, gc);
+	munmap(base, st.st_size);
+
+	if(r.failed) {
+		asprintf(err, "Snapshot file '%s' is malformed", path);
+		QueryCtx_Free();
+		GraphContext_Delete(gc);
+		return NULL;
+	}
+
+	// revert to default synchronization behavior
+	Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
+	Graph_ApplyAllPending(gc->g);
+
+	// relation matrices were loaded as a whole, count relation degrees
+	Graph_RecountDegrees(gc->g);
+
+	// indices are not part of the snapshot, build them
+	uint schema_count = array_len(gc->node_schemas);
+	for(uint i = 0; i < schema_count; i++) {
+		Schema *s = gc->node_schemas[i];
+		if(s->index) Index_Construct(s->index);
+		if(s->fulltextIdx) Index_Construct(s->fulltextIdx);
+		for(uint j = 0; j < array_len(s->composite_indices); j++) {
+			CompositeIndex_Construct(s->composite_indices[j]);
+		}
+	}
+
+	// enable support for multi edge on all relationship matrices
+	uint relation_count = Graph_RelationTypeCount(gc->g);
+	for(uint i = 0; i < relation_count; i++) {
+		gc->g->relations[i]->allow_multi_edge = true;
+	}
+
+	// relationship-type indices are built once multi edges are resolved
+	schema_count = array_len(gc->relation_schemas);
+	for(uint i = 0; i < schema_count; i++) {
+		Schema *s = gc->relation_schemas[i];
+		if(s->index) Index_Construct(s->index);
+	}
+
+	QueryCtx_Free();
+	return gc;
+}
@@ -0,0 +1,36 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../graph/graphcontext.h"
+
+// A graph snapshot is a standalone file holding a single graph
+// matrices are stored as the CSR / HyperCSR arrays GraphBLAS holds in memory,
+// each array starts on a page boundary, such that loading a snapshot
+// maps the file and copies arrays out of it page by page
+// rather than re-inserting entries one at a time
+
+#define GRAPH_SNAPSHOT_VERSION 1  // Latest snapshot format version.
+
+// writes a snapshot of gc to path
+// returns false on failure, setting err to a heap-allocated error message
+bool GraphSnapshot_Save
+(
+	GraphContext *gc,
+	const char *path,
+	char **err
+);
+
+// builds a graph named graph_name from the snapshot at path
+// the returned graph context is not yet associated with a key
+// returns NULL on failure, setting err to a heap-allocated error message
+GraphContext *GraphSnapshot_Load
+(
+	const char *graph_name,
+	const char *path,
+	char **err
+);
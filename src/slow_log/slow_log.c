@@ -5,13 +5,11 @@
 */
 
 #include <stdio.h>
-#include <unistd.h>
+#include <inttypes.h>
 
+#include "RG.h"
 #include "./slow_log.h"
-#include "../util/arr.h"
-#include "../query_ctx.h"
 #include "../util/rmalloc.h"
-#include "../util/thpool/pools.h"
 
 /* Redis prints doubles with up to 17 digits of precision, which captures
  * the inaccuracy of many floating-point numbers (such as 0.1).
@@ -27,19 +25,18 @@ static inline void _ReplyWithRoundedDouble(RedisModuleCtx *ctx, double d) {
 	RedisModule_ReplyWithStringBuffer(ctx, str, len);
 }
 
-static SlowLogItem *_SlowLogItem_New
-(
-	const char *cmd,
-	const char *query,
-	double latency,
-	time_t t
-) {
-	SlowLogItem *item = rm_malloc(sizeof(SlowLogItem));
-	item->time = t;
-	item->latency = latency;
-	item->cmd = rm_strdup(cmd);
-	item->query = rm_strdup(query);
-	return item;
+static inline void _ReplyWithHash(RedisModuleCtx *ctx, uint64_t h) {
+	char str[17];
+	snprintf(str, sizeof(str), "%016" PRIx64, h);
+	RedisModule_ReplyWithStringBuffer(ctx, str, 16);
+}
+
+static SlowLogItem *_SlowLogItem_Clone(const SlowLogItem *item) {
+	SlowLogItem *clone = rm_malloc(sizeof(SlowLogItem));
+	*clone = *item;
+	clone->cmd = rm_strdup(item->cmd);
+	clone->query = rm_strdup(item->query);
+	return clone;
 }
 
 static void _SlowLog_Item_Free(SlowLogItem *item) {
@@ -49,188 +46,101 @@ static void _SlowLog_Item_Free(SlowLogItem *item) {
 	rm_free(item);
 }
 
-// Compares two heap record nodes.
-static int _slowlog_elem_compare(const void *A, const void *B, const void *udata) {
-	SlowLogItem *a = (SlowLogItem *)A;
-	SlowLogItem *b = (SlowLogItem *)B;
-	return b->latency - a->latency;
-}
+SlowLog *SlowLog_New(uint64_t cap) {
+	ASSERT(cap > 0);
 
-static inline size_t _compute_key(char **s, const char *cmd, const char *query) {
-	return asprintf(s, "%s %s", cmd, query);
-}
+	SlowLog *slowlog = rm_malloc(sizeof(SlowLog));
+	slowlog->cap = cap;
+	slowlog->head = 0;
+	slowlog->entries = rm_calloc(cap, sizeof(SlowLogItem *));
 
-static size_t _SlowLogItem_ToString(const SlowLogItem *item, char **s) {
-	ASSERT(item);
-	return _compute_key(s, item->cmd, item->query);
+	return slowlog;
 }
 
-static void _SlowLog_RemoveItemFromLookup(SlowLog *slowlog, int t_id, const SlowLogItem *item) {
-	char *key;
-	rax *lookup = slowlog->lookup[t_id];
-	size_t key_len = _SlowLogItem_ToString(item, &key);
-	int removed = raxRemove(lookup, (unsigned char *)key, key_len, NULL);
-	ASSERT(removed == 1);
-	free(key);
-}
+void SlowLog_Add(SlowLog *slowlog, const SlowLogItem *item) {
+	ASSERT(slowlog && item && item->cmd && item->query && item->latency >= 0);
 
-static bool _SlowLog_Contains(const SlowLog *slowlog, int t_id, const char *cmd, const char *query,
-							  char **key, SlowLogItem **item) {
-	size_t len = _compute_key(key, cmd, query);
-	rax *lookup = slowlog->lookup[t_id];
-	*item = (SlowLogItem *)raxFind(lookup, (unsigned char *)*key, len);
-	if(*item == raxNotFound) *item = NULL;
-	return (*item != NULL);
-}
+	SlowLogItem *clone = _SlowLogItem_Clone(item);
+	if(clone->time == 0) time(&clone->time);
 
-SlowLog *SlowLog_New() {
-	SlowLog *slowlog = rm_malloc(sizeof(SlowLog));
+	// claim the next slot, overwriting its previous item
+	uint64_t idx = __atomic_fetch_add(&slowlog->head, 1, __ATOMIC_RELAXED);
+	SlowLogItem **slot = slowlog->entries + (idx % slowlog->cap);
+	SlowLogItem *prev = __atomic_exchange_n(slot, clone, __ATOMIC_ACQ_REL);
 
-	// Redis main thread + writer threads + reader threads.
-	int thread_count = ThreadPools_ThreadCount() + 1;
+	// whoever removes an item from its slot owns it
+	if(prev != NULL) _SlowLog_Item_Free(prev);
+}
 
-	slowlog->count = thread_count;
-	slowlog->lookup = rm_malloc(sizeof(rax *) * thread_count);
-	slowlog->min_heap = rm_malloc(sizeof(heap_t *) * thread_count);
-	slowlog->locks = rm_malloc(sizeof(pthread_mutex_t) * thread_count);
+// copy the item stored in slot, NULL if slot is empty
+static SlowLogItem *_SlowLog_CopySlot(SlowLogItem **slot) {
+	/* take the item out of its slot, such that a concurrent writer
+	 * overwriting the slot will not free it while it is being copied */
+	SlowLogItem *item = __atomic_exchange_n(slot, NULL, __ATOMIC_ACQ_REL);
+	if(item == NULL) return NULL;
 
-	for(int i = 0; i < thread_count; i++) {
-		slowlog->lookup[i] = raxNew();
-		slowlog->min_heap[i] = Heap_new(_slowlog_elem_compare, NULL);
-		int res = pthread_mutex_init(slowlog->locks + i, NULL);
-		ASSERT(res == 0);
-	}
+	SlowLogItem *copy = _SlowLogItem_Clone(item);
 
-	return slowlog;
-}
-
-void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query,
-				 double latency, time_t *t) {
-	ASSERT(slowlog && cmd && query && latency >= 0);
-
-	int res;
-	UNUSED(res);
-	char *key;
-	time_t _time;
-	SlowLogItem *existing_item;
-	int t_id = ThreadPools_GetThreadID();
-	rax *lookup = slowlog->lookup[t_id];
-	heap_t *heap = slowlog->min_heap[t_id];
-	pthread_mutex_t *lock = slowlog->locks + t_id;
-
-	// initialise time
-	(t) ? _time = *t : time(&_time);
-
-	if(pthread_mutex_lock(lock) != 0) {
-		// Failed to lock, skip logging.
-		return;
+	// return the item to its slot, unless it was overwritten in the meantime
+	SlowLogItem *expected = NULL;
+	if(!__atomic_compare_exchange_n(slot, &expected, item, false,
+				__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		_SlowLog_Item_Free(item);
 	}
 
-	{
-		// In critical section..
-		bool exists = _SlowLog_Contains(slowlog, t_id, cmd, query, &key, &existing_item);
-		size_t key_len = strlen(key);
-
-		if(exists) {
-			// A similar item already exists, see if we need to update its latency.
-			if(existing_item->latency < latency) {
-				existing_item->time = _time;
-				existing_item->latency = latency;
-			}
-			goto cleanup;
-		}
-
-		/* Similar item does not exist in the log.
-		 * Check if there's enough room to store item. */
-		int introduce_item = 0;
-		if(Heap_count(heap) < SLOW_LOG_SIZE) {
-			introduce_item = 1;
-		} else {
-			// Not enough room, see if item should be tracked.
-			SlowLogItem *top = Heap_peek(heap);
-			if(top->latency < latency) {
-				top = Heap_poll(heap);
-				_SlowLog_RemoveItemFromLookup(slowlog, t_id, top);
-				_SlowLog_Item_Free(top);
-				introduce_item = 1;
-			}
-		}
+	return copy;
+}
 
-		if(introduce_item) {
-			SlowLogItem *item = _SlowLogItem_New(cmd, query, latency, _time);
-			Heap_offer(slowlog->min_heap + t_id, item);
-			raxInsert(lookup, (unsigned char *)key, key_len, item, NULL);
-		}
-	}   // End of critical section.
-cleanup:
+void SlowLog_Replay(SlowLog *slowlog, RedisModuleCtx *ctx) {
+	ASSERT(slowlog != NULL);
 
-	res = pthread_mutex_unlock(lock);
-	ASSERT(res == 0);
-	free(key);
-}
+	uint64_t head = __atomic_load_n(&slowlog->head, __ATOMIC_ACQUIRE);
+	uint64_t n = (head < slowlog->cap) ? head : slowlog->cap;
 
-void SlowLog_Replay(const SlowLog *slowlog, RedisModuleCtx *ctx) {
-	SlowLog *aggregated_slowlog = SlowLog_New();
-	int my_t_id = ThreadPools_GetThreadID();
-
-	for(int t_id = 0; t_id < slowlog->count; t_id++) {
-		// Don't lock ourselves.
-		if(my_t_id != t_id) pthread_mutex_lock(slowlog->locks + t_id);
-		{
-			// Critical section.
-			rax *lookup = slowlog->lookup[t_id];
-			raxIterator iter;
-			raxStart(&iter, lookup);
-			raxSeek(&iter, "^", NULL, 0);
-			while(raxNext(&iter)) {
-				SlowLogItem *item = iter.data;
-				SlowLog_Add(aggregated_slowlog, item->cmd, item->query,
-							item->latency, &item->time);
-			}
-			raxStop(&iter);
-			// End of critical section.
-		}
-		if(my_t_id != t_id) pthread_mutex_unlock(slowlog->locks + t_id);
+	// copy items from the most recent to the oldest
+	uint count = 0;
+	SlowLogItem **items = rm_malloc(sizeof(SlowLogItem *) * n);
+	for(uint64_t i = 0; i < n; i++) {
+		uint64_t idx = (head - 1 - i) % slowlog->cap;
+		SlowLogItem *item = _SlowLog_CopySlot(slowlog->entries + idx);
+		if(item != NULL) items[count++] = item;
 	}
 
-	heap_t *heap = aggregated_slowlog->min_heap[my_t_id];
-	RedisModule_ReplyWithArray(ctx, Heap_count(heap));
-
-	while(Heap_count(heap)) {
-		SlowLogItem *item = Heap_poll(heap);
-		RedisModule_ReplyWithArray(ctx, 4);
+	RedisModule_ReplyWithArray(ctx, count);
+	for(uint i = 0; i < count; i++) {
+		SlowLogItem *item = items[i];
+		RedisModule_ReplyWithArray(ctx, 10);
 		RedisModule_ReplyWithDouble(ctx, item->time);
 		RedisModule_ReplyWithStringBuffer(ctx, (const char *)item->cmd, strlen(item->cmd));
 		RedisModule_ReplyWithStringBuffer(ctx, (const char *)item->query, strlen(item->query));
 		_ReplyWithRoundedDouble(ctx, item->latency);
+		_ReplyWithHash(ctx, item->fingerprint);
+		_ReplyWithHash(ctx, item->params_hash);
+		RedisModule_ReplyWithLongLong(ctx, item->rows);
+		if(item->peak_memory < 0) RedisModule_ReplyWithNull(ctx);
+		else RedisModule_ReplyWithLongLong(ctx, item->peak_memory);
+		_ReplyWithRoundedDouble(ctx, item->lock_wait);
+
+		RedisModule_ReplyWithArray(ctx, item->op_count);
+		for(uint j = 0; j < item->op_count; j++) {
+			RedisModule_ReplyWithArray(ctx, 2);
+			RedisModule_ReplyWithCString(ctx, item->ops[j].name);
+			_ReplyWithRoundedDouble(ctx, item->ops[j].exec_time);
+		}
+
+		_SlowLog_Item_Free(item);
 	}
 
-	SlowLog_Free(aggregated_slowlog);
+	rm_free(items);
 }
 
 void SlowLog_Free(SlowLog *slowlog) {
-	for(int i = 0; i < slowlog->count; i++) {
-		rax *lookup = slowlog->lookup[i];
-		heap_t *heap = slowlog->min_heap[i];
-
-		raxIterator iter;
-		raxStart(&iter, lookup);
-		raxSeek(&iter, "^", NULL, 0);
-		while(raxNext(&iter)) {
-			SlowLogItem *item = iter.data;
-			_SlowLog_Item_Free(item);
-		}
-		raxStop(&iter);
-
-		raxFree(lookup);
-		Heap_free(heap);
-		int res = pthread_mutex_destroy(slowlog->locks + i);
-		ASSERT(res == 0);
+	for(uint64_t i = 0; i < slowlog->cap; i++) {
+		SlowLogItem *item = slowlog->entries[i];
+		if(item != NULL) _SlowLog_Item_Free(item);
 	}
 
-	rm_free(slowlog->locks);
-	rm_free(slowlog->lookup);
-	rm_free(slowlog->min_heap);
+	rm_free(slowlog->entries);
 	rm_free(slowlog);
 }
 
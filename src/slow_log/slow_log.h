@@ -6,47 +6,60 @@
 
 #pragma once
 
-#define SLOW_LOG_SIZE 10
+#define SLOWLOG_TOP_OPS 3  // number of operations reported per item
 
-#include <pthread.h>
+#include <time.h>
+#include <stdint.h>
 
-#include "../util/heap.h"
 #include "../redismodule.h"
-#include "../../deps/rax/rax.h"
+
+// Operation execution time, as reported by a slowlog item.
+typedef struct {
+	const char *name;   // Operation name.
+	double exec_time;   // Average execution time in milliseconds.
+} SlowLogOp;
 
 // Slowlog item.
 typedef struct {
-    char *cmd;          // Redis command.
-    time_t time;        // Item creation time.
-	char *query;        // Query.
-	double latency;     // How much time query was processed.
+	char *cmd;                       // Redis command.
+	time_t time;                     // Item creation time.
+	char *query;                     // Query.
+	double latency;                  // How much time query was processed.
+	uint64_t fingerprint;            // Fingerprint of the parsed query.
+	uint64_t params_hash;            // Hash of query parameters, 0 if there are none.
+	uint64_t rows;                   // Number of rows produced.
+	int64_t peak_memory;             // Highest number of bytes held by the query, -1 if unknown.
+	double lock_wait;                // Time spent acquiring the graph lock, in milliseconds.
+	uint op_count;                   // Number of reported operations.
+	SlowLogOp ops[SLOWLOG_TOP_OPS];  // Most expensive operations.
 } SlowLogItem;
 
-// Slowlog, maintains N slowest queries.
+// Slowlog, maintains the N most recent slow queries.
+// Items are kept in a lock-free ring buffer, the oldest item is overwritten.
 typedef struct {
-     uint count;                // Length of lookup, min_heap and locks arrays.
-     rax **lookup;              // Array of item lookup table.
-     heap_t **min_heap;         // Array of minimum heap of items.
-     pthread_mutex_t *locks;    // Array of locks.
+	uint64_t cap;               // Number of slots.
+	uint64_t head;              // Number of items ever added.
+	SlowLogItem **entries;      // Ring buffer slots.
 } SlowLog;
 
-// Create a new slowlog.
-SlowLog *SlowLog_New();
+// Create a new slowlog holding up to 'cap' items.
+SlowLog *SlowLog_New
+(
+	uint64_t cap
+);
 
 // Introduce item to slow log.
+// item's strings are copied, 'time' is set if it is 0
 void SlowLog_Add
 (
-	SlowLog *slowlog,			// slowlog to add entry to
-	const char *cmd,			// command being logged
-	const char *query,			// query being logged
-	double latency,				// command latency
-	time_t *time				// optional time command was issued
+	SlowLog *slowlog,           // slowlog to add entry to
+	const SlowLogItem *item     // item to log
 );
 
-// Replies with slow log content.
+// Replies with slow log content, most recent items first.
 void SlowLog_Replay
 (
-	const SlowLog *slowlog,
+	SlowLog *slowlog,
 	RedisModuleCtx *ctx
 );
 
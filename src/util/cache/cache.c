@@ -8,99 +8,302 @@
 #include "RG.h"
 #include "../rmalloc.h"
 #include "cache_array.h"
+#include "xxhash.h"
 #include <pthread.h>
 
-static CacheEntry *_CacheEvictLRU(Cache *cache) {
-	CacheEntry *entry = CacheArray_FindMinLRU(cache->arr, cache->cap);
-	// Remove evicted element from the rax.
-	raxRemove(cache->lookup, (unsigned  char *)entry->key,
-	  strlen(entry->key), NULL);
-	CacheArray_CleanEntry(entry, cache->free_item);
+/* a copy of a cached value, handed back to the cache
+ * such that a later lookup can reuse it rather than copying the value again */
+typedef struct {
+	void *copy;    // recycled copy
+	uint64_t tag;  // tag the copy was recycled under
+} CacheRecycled;
+
+/* cached values are reference counted, allowing callers to copy a value
+ * outside of the shard lock while a concurrent writer evicts it
+ * the value and its recycled copies are freed once the value is evicted
+ * and all references to it are dropped */
+typedef struct {
+	void *value;                                 // cached value
+	int ref_count;                               // number of references to value
+	CacheEntryFreeFunc free_item;                // callback function that frees value
+	CacheRecycled recycled[CACHE_RECYCLED_CAP];  // recycled copies, oldest first
+	uint recycled_count;                         // number of recycled copies
+	pthread_mutex_t recycled_lock;               // guards recycled copies
+} CacheItem;
+
+static CacheItem *_CacheItem_New(void *value, CacheEntryFreeFunc free_item) {
+	CacheItem *item      = rm_malloc(sizeof(CacheItem));
+	item->value          = value;
+	item->ref_count      = 1;  // reference held by the cache
+	item->free_item      = free_item;
+	item->recycled_count = 0;
+
+	int res = pthread_mutex_init(&item->recycled_lock, NULL);
+	UNUSED(res);
+	ASSERT(res == 0);
 
-	return entry;
+	return item;
 }
 
-static bool _Cache_SetValue(Cache *cache, const char *key, void *value,
-  		size_t key_len) {
-	ASSERT(key != NULL);
-	ASSERT(cache != NULL);
+static inline void _CacheItem_Retain(CacheItem *item) {
+	__atomic_fetch_add(&item->ref_count, 1, __ATOMIC_RELAXED);
+}
 
-	/* in case that another working thread had already inserted the item to the
-	 * cache, no need to re-insert it */
-	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, key_len);
-	if(entry != raxNotFound) {
-		return false;
+static void _CacheItem_Release(CacheItem *item) {
+	if(__atomic_sub_fetch(&item->ref_count, 1, __ATOMIC_ACQ_REL) > 0) return;
+
+	for(uint i = 0; i < item->recycled_count; i++) {
+		item->free_item(item->recycled[i].copy);
 	}
+	item->free_item(item->value);
+
+	int res = pthread_mutex_destroy(&item->recycled_lock);
+	UNUSED(res);
+	ASSERT(res == 0);
+
+	rm_free(item);
+}
+
+// removes and returns the most recent copy recycled under tag, NULL if none
+static void *_CacheItem_PopRecycled(CacheItem *item, uint64_t tag) {
+	void *copy = NULL;
+
+	pthread_mutex_lock(&item->recycled_lock);
+	for(int i = (int)item->recycled_count - 1; i >= 0; i--) {
+		if(item->recycled[i].tag != tag) continue;
+		copy = item->recycled[i].copy;
+		item->recycled_count--;
+		memmove(item->recycled + i, item->recycled + i + 1,
+				sizeof(CacheRecycled) * (item->recycled_count - i));
+		break;
+	}
+	pthread_mutex_unlock(&item->recycled_lock);
+
+	return copy;
+}
+
+// keeps copy for reuse, once full the oldest recycled copy is freed
+static void _CacheItem_PushRecycled(CacheItem *item, uint64_t tag, void *copy) {
+	void *dropped = NULL;
+
+	pthread_mutex_lock(&item->recycled_lock);
+	if(item->recycled_count == CACHE_RECYCLED_CAP) {
+		dropped = item->recycled[0].copy;
+		item->recycled_count--;
+		memmove(item->recycled, item->recycled + 1,
+				sizeof(CacheRecycled) * item->recycled_count);
+	}
+	item->recycled[item->recycled_count].copy = copy;
+	item->recycled[item->recycled_count].tag  = tag;
+	item->recycled_count++;
+	pthread_mutex_unlock(&item->recycled_lock);
+
+	if(dropped != NULL) item->free_item(dropped);
+}
+
+static inline void _CacheShard_Lock(CacheShard *shard, bool write) {
+	int res = write ? pthread_rwlock_wrlock(&shard->_shard_rwlock) :
+		pthread_rwlock_rdlock(&shard->_shard_rwlock);
+	UNUSED(res);
+	ASSERT(res == 0);
+}
 
-	// key is not in cache! test to see if cache is full?
-	if(cache->size == cache->cap) {
-		/* the cache is full, evict the least-recently-used element
+static inline void _CacheShard_Unlock(CacheShard *shard) {
+	int res = pthread_rwlock_unlock(&shard->_shard_rwlock);
+	UNUSED(res);
+	ASSERT(res == 0);
+}
+
+// returns the shard responsible for key
+static inline CacheShard *_Cache_GetShard(const Cache *cache, const char *key,
+		size_t key_len) {
+	if(cache->shard_count == 1) return cache->shards;
+	XXH64_hash_t h = XXH64(key, key_len, 0);
+	return cache->shards + (h % cache->shard_count);
+}
+
+// returns the item cached under key, NULL if key isn't cached
+// the returned item is retained, it might get evicted once the lock is released
+// the shard lock must be held
+static CacheItem *_CacheShard_Retain(Cache *cache, CacheShard *shard,
+		const char *key, size_t key_len) {
+	CacheEntry *entry = raxFind(shard->lookup, (unsigned char *)key, key_len);
+	if(entry == raxNotFound) return NULL;
+
+	/* element is now the most recently used; update its LRU
+	 * note that multiple threads can be here simultaneously */
+	long long LRU = __atomic_add_fetch(&cache->counter, 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&entry->LRU, LRU, __ATOMIC_RELAXED);
+
+	CacheItem *item = entry->value;
+	_CacheItem_Retain(item);
+	return item;
+}
+
+// returns a copy of the key aliased by alias, NULL if alias isn't known
+// the shard lock must be held
+static char *_CacheShard_ResolveAlias(CacheShard *shard, const char *alias,
+		size_t alias_len) {
+	char *key = raxFind(shard->aliases, (unsigned char *)alias, alias_len);
+	if(key == raxNotFound) return NULL;
+	return rm_strdup(key);
+}
+
+static CacheEntry *_CacheEvictLRU(Cache *cache, CacheShard *shard) {
+	CacheEntry *entry = CacheArray_FindMinLRU(shard->arr, shard->cap);
+	// Remove evicted element from the rax.
+	raxRemove(shard->lookup, (unsigned  char *)entry->key,
+	  strlen(entry->key), NULL);
+	// evicted value is freed once its ongoing lookups are done
+	CacheArray_CleanEntry(entry, (CacheEntryFreeFunc)_CacheItem_Release);
+	__atomic_fetch_add(&cache->stats.evictions, 1, __ATOMIC_RELAXED);
+
+	return entry;
+}
+
+// stores value under key, assumes key isn't cached
+// returns the item holding value
+// the shard write lock must be held
+static CacheItem *_CacheShard_Insert(Cache *cache, CacheShard *shard,
+		const char *key, size_t key_len, void *value) {
+	CacheEntry *entry;
+	if(shard->size == shard->cap) {
+		/* the shard is full, evict the least-recently-used element
 		 * and reuse its space for the new element */
-		entry = _CacheEvictLRU(cache);
+		entry = _CacheEvictLRU(cache, shard);
 	} else {
 		// the array has space left in it, use the next available entry
-		entry = cache->arr + cache->size++;
+		entry = shard->arr + shard->size++;
 	}
 
 	// populate the entry
 	char *k = rm_strdup(key);
-	cache->counter++;
-	CacheArray_PopulateEntry(cache->counter, entry, k, value);
-
+	CacheItem *item = _CacheItem_New(value, cache->free_item);
+	long long LRU = __atomic_add_fetch(&cache->counter, 1, __ATOMIC_RELAXED);
+	CacheArray_PopulateEntry(LRU, entry, k, item);
 
 	// Add the new entry to the rax.
-	raxInsert(cache->lookup, (unsigned char *)key, key_len, entry, NULL);
+	raxInsert(shard->lookup, (unsigned char *)key, key_len, entry, NULL);
 
-	return true;
+	return item;
+}
+
+// returns the item holding value, NULL if key was already cached
+static CacheItem *_Cache_SetValue(Cache *cache, CacheShard *shard,
+		const char *key, void *value, size_t key_len) {
+	ASSERT(key != NULL);
+	ASSERT(cache != NULL);
+
+	/* in case that another working thread had already inserted the item to the
+	 * cache, no need to re-insert it */
+	CacheEntry *entry = raxFind(shard->lookup, (unsigned char *)key, key_len);
+	if(entry != raxNotFound) {
+		return NULL;
+	}
+
+	return _CacheShard_Insert(cache, shard, key, key_len, value);
 }
 
 Cache *Cache_New(uint cap, CacheEntryFreeFunc freeFunc, CacheEntryCopyFunc copyFunc) {
 	ASSERT(cap > 0);
 	ASSERT(copyFunc != NULL);
 
-	Cache *cache     = rm_malloc(sizeof(Cache));
+	Cache *cache     = rm_calloc(1, sizeof(Cache));
 	cache->cap       = cap;
-	cache->size      = 0;
-	cache->lookup    = raxNew();       // Instantiate key entry mapping.
 	cache->counter   = 0;             // Initialize counter to zero.
 	cache->copy_item = copyFunc;
 	cache->free_item = freeFunc;
-	cache->arr = rm_calloc(cap, sizeof(CacheEntry)); // Array of cached values.
 
-	// Initialize the read-write lock to protect access to the cache.
-	int res = pthread_rwlock_init(&cache->_cache_rwlock, NULL);
-	UNUSED(res);
-	ASSERT(res == 0);
+	// small caches are not sharded, as each shard maintains its own LRU
+	cache->shard_count = cap / CACHE_SHARD_MIN_CAP;
+	if(cache->shard_count > CACHE_SHARD_COUNT) cache->shard_count = CACHE_SHARD_COUNT;
+	if(cache->shard_count == 0) cache->shard_count = 1;
+	cache->shards = rm_malloc(sizeof(CacheShard) * cache->shard_count);
+
+	for(uint i = 0; i < cache->shard_count; i++) {
+		CacheShard *shard = cache->shards + i;
+		// spread capacity evenly across shards
+		shard->cap    = cap / cache->shard_count +
+			(i < cap % cache->shard_count);
+		shard->size   = 0;
+		shard->lookup = raxNew();  // Instantiate key entry mapping.
+		shard->arr    = rm_calloc(shard->cap, sizeof(CacheEntry));
+		shard->aliases     = raxNew();
+		shard->alias_count = 0;
+
+		// Initialize the read-write lock to protect access to the shard.
+		int res = pthread_rwlock_init(&shard->_shard_rwlock, NULL);
+		UNUSED(res);
+		ASSERT(res == 0);
+	}
 
 	return cache;
 }
 
+// returns the retained item cached under key or alias, NULL if not cached
+static CacheItem *_Cache_Retain(Cache *cache, const char *key) {
+	size_t key_len = strlen(key);
+	CacheShard *shard = _Cache_GetShard(cache, key, key_len);
+
+	_CacheShard_Lock(shard, false);
+	CacheItem *item = _CacheShard_Retain(cache, shard, key, key_len);
+	// key isn't cached, see if it is an alias
+	char *aliased = (item == NULL) ?
+		_CacheShard_ResolveAlias(shard, key, key_len) : NULL;
+	_CacheShard_Unlock(shard);
+
+	if(aliased != NULL) {
+		// aliased key might reside on a different shard
+		size_t aliased_len = strlen(aliased);
+		shard = _Cache_GetShard(cache, aliased, aliased_len);
+		_CacheShard_Lock(shard, false);
+		item = _CacheShard_Retain(cache, shard, aliased, aliased_len);
+		_CacheShard_Unlock(shard);
+		rm_free(aliased);
+	}
+
+	return item;
+}
+
 void *Cache_GetValue(Cache *cache, const char *key) {
-	void *item = NULL;
+	ASSERT(cache != NULL);
+
+	CacheItem *item = _Cache_Retain(cache, key);
+	if(item == NULL) return NULL;
+
+	// copy outside of the shard lock, to avoid blocking writers
+	void *copy = cache->copy_item(item->value);
+	_CacheItem_Release(item);
+
+	return copy;
+}
 
+void *Cache_GetRecycledValue(Cache *cache, const char *key, uint64_t tag) {
 	ASSERT(cache != NULL);
 
-	int res = pthread_rwlock_rdlock(&cache->_cache_rwlock);
-	UNUSED(res);
-	ASSERT(res == 0);
+	CacheItem *item = _Cache_Retain(cache, key);
+	if(item == NULL) return NULL;
 
-	size_t key_len = strlen(key);
-	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, key_len);
+	void *copy = _CacheItem_PopRecycled(item, tag);
+	_CacheItem_Release(item);
 
-	if(entry == raxNotFound) goto cleanup;
+	return copy;
+}
 
-	/* element is now the most recently used; update its LRU
-	 * note that multiple threads can be here simultaneously */
-	cache->counter++;
-	entry->LRU = cache->counter;
+void Cache_Recycle(Cache *cache, const char *key, uint64_t tag, void *copy) {
+	ASSERT(key != NULL);
+	ASSERT(copy != NULL);
+	ASSERT(cache != NULL);
 
-	// return a copy of element
-	item = cache->copy_item(entry->value);
+	CacheItem *item = _Cache_Retain(cache, key);
+	if(item == NULL) {
+		// value is no longer cached, nothing to recycle copy for
+		cache->free_item(copy);
+		return;
+	}
 
-cleanup:
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
-	ASSERT(res == 0);
-	return item;
+	_CacheItem_PushRecycled(item, tag, copy);
+	_CacheItem_Release(item);
 }
 
 void Cache_SetValue(Cache *cache, const char *key, void *value) {
@@ -108,17 +311,15 @@ void Cache_SetValue(Cache *cache, const char *key, void *value) {
 	ASSERT(cache != NULL);
 
 	size_t key_len = strlen(key);
+	CacheShard *shard = _Cache_GetShard(cache, key, key_len);
 
 	// Acquire WRITE lock
-	int res = pthread_rwlock_wrlock(&cache->_cache_rwlock);
-	UNUSED(res);
-	ASSERT(res == 0);
+	_CacheShard_Lock(shard, true);
 
 	// Insert the value to the cache.
-	_Cache_SetValue(cache, key, value, key_len);
+	_Cache_SetValue(cache, shard, key, value, key_len);
 
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
-	ASSERT(res == 0);
+	_CacheShard_Unlock(shard);
 }
 
 void *Cache_SetGetValue(Cache *cache, const char *key, void *value) {
@@ -126,42 +327,103 @@ void *Cache_SetGetValue(Cache *cache, const char *key, void *value) {
 	ASSERT(cache != NULL);
 
 	size_t key_len = strlen(key);
-	void *value_to_return = value;
+	CacheShard *shard = _Cache_GetShard(cache, key, key_len);
 
 	// acquire WRITE lock
-	int res = pthread_rwlock_wrlock(&cache->_cache_rwlock);
-	UNUSED(res);
-	ASSERT(res == 0);
+	_CacheShard_Lock(shard, true);
+
+	// returns NULL if value already in cache
+	CacheItem *item = _Cache_SetValue(cache, shard, key, value, key_len);
+	if(item != NULL) _CacheItem_Retain(item);
+
+	_CacheShard_Unlock(shard);
+
+	// value is already cached, return original value
+	if(item == NULL) return value;
 
-	// return true if value was added, false if value already in cache
-	if(_Cache_SetValue(cache, key, value, key_len)) {
-		// return a copy of original value
-		value_to_return = cache->copy_item(value);
+	// return a copy of original value, copying outside of the shard lock
+	void *copy = cache->copy_item(value);
+	_CacheItem_Release(item);
+
+	return copy;
+}
+
+void Cache_SetAlias(Cache *cache, const char *key, const char *alias) {
+	ASSERT(key != NULL);
+	ASSERT(alias != NULL);
+	ASSERT(cache != NULL);
+
+	if(strcmp(key, alias) == 0) return;
+
+	// aliases are kept by the shard responsible for them
+	size_t alias_len = strlen(alias);
+	CacheShard *shard = _Cache_GetShard(cache, alias, alias_len);
+	_CacheShard_Lock(shard, true);
+
+	// aliases are cheap to recreate, drop them all rather than
+	// tracking their usage once the shard holds too many of them
+	if(shard->alias_count >= shard->cap * CACHE_ALIASES_PER_ENTRY) {
+		raxFreeWithCallback(shard->aliases, rm_free);
+		shard->aliases = raxNew();
+		shard->alias_count = 0;
 	}
 
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
-	ASSERT(res == 0);
+	// alias might already refer to a previously evicted key, replace it
+	void *old = NULL;
+	if(raxInsert(shard->aliases, (unsigned char *)alias, alias_len,
+				rm_strdup(key), &old)) {
+		shard->alias_count++;
+	} else {
+		rm_free(old);
+	}
 
-	return value_to_return;
+	_CacheShard_Unlock(shard);
+}
+
+void Cache_CountHit(Cache *cache, double saved) {
+	ASSERT(cache != NULL);
+	__atomic_fetch_add(&cache->stats.hits, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&cache->stats.saved_us, (uint64_t)(saved * 1000),
+			__ATOMIC_RELAXED);
+}
+
+void Cache_CountMiss(Cache *cache) {
+	ASSERT(cache != NULL);
+	__atomic_fetch_add(&cache->stats.misses, 1, __ATOMIC_RELAXED);
+}
+
+void Cache_GetStats(const Cache *cache, CacheStats *stats) {
+	ASSERT(cache != NULL);
+	ASSERT(stats != NULL);
+
+	stats->hits      = __atomic_load_n(&cache->stats.hits, __ATOMIC_RELAXED);
+	stats->misses    = __atomic_load_n(&cache->stats.misses, __ATOMIC_RELAXED);
+	stats->evictions = __atomic_load_n(&cache->stats.evictions, __ATOMIC_RELAXED);
+	stats->saved_us  = __atomic_load_n(&cache->stats.saved_us, __ATOMIC_RELAXED);
 }
 
 void Cache_Free(Cache *cache) {
 	ASSERT(cache != NULL);
 
-	// free cache entries
-	for(size_t i = 0; i < cache->size; i++) {
-		CacheEntry *entry = cache->arr + i;
-		rm_free(entry->key);
-		cache->free_item(entry->value);
-	}
+	for(uint i = 0; i < cache->shard_count; i++) {
+		CacheShard *shard = cache->shards + i;
 
-	rm_free(cache->arr);
-	raxFree(cache->lookup);
+		for(uint j = 0; j < shard->size; j++) {
+			CacheEntry *entry = shard->arr + j;
+			rm_free(entry->key);
+			_CacheItem_Release(entry->value);
+		}
 
-	int res = pthread_rwlock_destroy(&cache->_cache_rwlock);
-	UNUSED(res);
-	ASSERT(res == 0);
+		rm_free(shard->arr);
+		raxFree(shard->lookup);
+		raxFreeWithCallback(shard->aliases, rm_free);
+
+		int res = pthread_rwlock_destroy(&shard->_shard_rwlock);
+		UNUSED(res);
+		ASSERT(res == 0);
+	}
 
+	rm_free(cache->shards);
 	rm_free(cache);
 }
 
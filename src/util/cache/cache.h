@@ -8,20 +8,50 @@
 
 #include "cache_array.h"
 #include "rax.h"
+#include <pthread.h>
+
+#define CACHE_SHARD_COUNT 8    // Maximum number of cache shards.
+#define CACHE_SHARD_MIN_CAP 4  // Minimum number of entries per shard.
+#define CACHE_ALIASES_PER_ENTRY 4  // Number of aliases kept per shard entry.
+#define CACHE_RECYCLED_CAP 4       // Number of recycled copies kept per entry.
+
+/**
+ * @brief A cache partition, guarded by its own lock.
+ */
+typedef struct {
+	uint cap;                          // Shard capacity.
+	uint size;                         // Shard current size.
+	rax *lookup;                       // Mapping between keys to entries, for fast lookups.
+	CacheEntry *arr;                   // Array of cache elements.
+	rax *aliases;                      // Mapping between aliases and keys.
+	uint alias_count;                  // Number of aliases.
+	pthread_rwlock_t _shard_rwlock;    // Read-write lock to protect access to the shard.
+} CacheShard;
+
+/**
+ * @brief Cache usage statistics.
+ */
+typedef struct {
+	uint64_t hits;         // Number of lookups served by the cache.
+	uint64_t misses;       // Number of lookups not served by the cache.
+	uint64_t evictions;    // Number of evicted entries.
+	uint64_t saved_us;     // Time saved by cache hits, in microseconds.
+} CacheStats;
 
 /**
  * @brief Key-value cache, uses LRU policy for eviction.
  * Assumes owership over stored objects.
+ * Keys are spread across shards, each with its own LRU and lock,
+ * such that readers of different keys do not contend on a single lock.
  */
 typedef struct Cache {
 	uint cap;                          // Cache capacity.
-	uint size;                         // Cache current size.
+	uint shard_count;                  // Number of shards.
 	long long counter;                 // Atomic counter for number of reads.
-	rax *lookup;                       // Mapping between keys to entries, for fast lookups.
-	CacheEntry *arr;                   // Array of cache elements.
+	CacheShard *shards;                // Cache partitions.
+	CacheStats stats;                  // Usage statistics.
 	CacheEntryFreeFunc free_item;      // Callback function that free cached value.
 	CacheEntryCopyFunc copy_item;      // Callback function that copies cached value.
-	pthread_rwlock_t _cache_rwlock;    // Read-write lock to protect access to the cache.
 } Cache;
 
 /**
@@ -35,12 +65,37 @@ Cache *Cache_New(uint size, CacheEntryFreeFunc freeFunc, CacheEntryCopyFunc copy
 
 /**
  * @brief  Returns a copy of value if it is cached, NULL otherwise.
+ * @note   The copy is made outside of the cache lock, an entry evicted
+ *         while being copied is freed once the copy is done.
  * @param  *cache: cache pointer.
- * @param  *key: Key to look for.
+ * @param  *key: Key or alias to look for.
  * @retval  pointer with the cached answer, NULL if the key isn't cached.
  */
 void *Cache_GetValue(Cache *cache, const char *key);
 
+/**
+ * @brief  Returns a copy of value previously handed back by Cache_Recycle.
+ * @note   Recycled copies are owned by the caller, as with Cache_GetValue.
+ * @param  *cache: cache pointer.
+ * @param  *key: Key or alias to look for.
+ * @param  tag: Tag the copy was recycled under.
+ * @retval  pointer to a recycled copy, NULL if there is none.
+ */
+void *Cache_GetRecycledValue(Cache *cache, const char *key, uint64_t tag);
+
+/**
+ * @brief  Hands a copy of the value cached under key back to the cache,
+ *         for a later Cache_GetRecycledValue with the same tag to reuse.
+ * @note   Up to CACHE_RECYCLED_CAP copies are kept per entry, the oldest
+ *         copy is freed first. Copies are freed along with their entry,
+ *         and immediately if key isn't cached.
+ * @param  *cache: cache pointer.
+ * @param  *key: Key of the cached value.
+ * @param  tag: Tag to recycle copy under.
+ * @param  *copy: Copy of the cached value, the cache takes ownership of it.
+ */
+void Cache_Recycle(Cache *cache, const char *key, uint64_t tag, void *copy);
+
 /**
  * @brief  Stores value under key within the cache.
  * @note   In case the cache is full, this operation causes a cache eviction.
@@ -60,6 +115,38 @@ void Cache_SetValue(Cache *cache, const char *key, void *item);
  */
 void *Cache_SetGetValue(Cache *cache, const char *key, void *value);
 
+/**
+ * @brief  Associates an additional key with key.
+ * @note   Aliases refer to keys rather than values, they don't count against
+ *         the cache capacity and are never evicted as values are. An alias of
+ *         an evicted key resolves to nothing. Once a shard holds
+ *         CACHE_ALIASES_PER_ENTRY aliases per entry, its aliases are dropped.
+ * @param  *cache: cache pointer.
+ * @param  *key: Key of the cached value.
+ * @param  *alias: Additional key for associating with value.
+ */
+void Cache_SetAlias(Cache *cache, const char *key, const char *alias);
+
+/**
+ * @brief  Records a lookup served by the cache.
+ * @param  *cache: cache pointer.
+ * @param  saved: Time saved by the cache hit, in milliseconds.
+ */
+void Cache_CountHit(Cache *cache, double saved);
+
+/**
+ * @brief  Records a lookup not served by the cache.
+ * @param  *cache: cache pointer.
+ */
+void Cache_CountMiss(Cache *cache);
+
+/**
+ * @brief  Retrieves cache usage statistics.
+ * @param  *cache: cache pointer.
+ * @param  *stats: Output statistics.
+ */
+void Cache_GetStats(const Cache *cache, CacheStats *stats);
+
 /**
  * @brief  Destroys the cache and free all stored items.
  * @param  *cache: cache pointer
@@ -96,6 +96,20 @@ DataBlockIterator *DataBlock_Scan(const DataBlock *dataBlock) {
 	return DataBlockIterator_New(startBlock, 0, endPos, 1);
 }
 
+DataBlockIterator *DataBlock_ScanRange(const DataBlock *dataBlock, uint64_t start,
+									   uint64_t end) {
+	ASSERT(dataBlock != NULL);
+
+	// Clamp range to the datablock's used positions.
+	uint64_t maxPos = dataBlock->itemCount + array_len(dataBlock->deletedIdx);
+	if(end > maxPos) end = maxPos;
+	// Empty range, an iterator with no positions to visit.
+	if(start >= end) return DataBlockIterator_New(dataBlock->blocks[0], 0, 0, 1);
+
+	Block *startBlock = dataBlock->blocks[start / DATABLOCK_BLOCK_CAP];
+	return DataBlockIterator_New(startBlock, start, end, 1);
+}
+
 // Make sure datablock can accommodate at least k items.
 void DataBlock_Accommodate(DataBlock *dataBlock, int64_t k) {
 	// Compute number of free slots.
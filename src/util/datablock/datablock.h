@@ -75,6 +75,10 @@ void DataBlock_Ensure(DataBlock *dataBlock, uint64_t idx);
 // Returns an iterator which scans entire datablock.
 DataBlockIterator *DataBlock_Scan(const DataBlock *dataBlock);
 
+// Returns an iterator which scans positions [start, end) of datablock.
+DataBlockIterator *DataBlock_ScanRange(const DataBlock *dataBlock, uint64_t start,
+									   uint64_t end);
+
 // Get item at position idx
 void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx);
 
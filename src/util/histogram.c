@@ -0,0 +1,102 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "histogram.h"
+#include "RG.h"
+#include <math.h>
+#include <string.h>
+
+#define SUB_BUCKET_COUNT (1ULL << HISTOGRAM_PRECISION_BITS)
+#define MAX_VALUE ((1ULL << HISTOGRAM_MAX_BITS) - 1)
+
+// index of the bucket holding 'value'
+static inline uint _BucketIndex(uint64_t value) {
+	if(value < SUB_BUCKET_COUNT) return value;
+	if(value > MAX_VALUE) value = MAX_VALUE;
+
+	// split the power of two range [2^msb, 2^(msb+1)) into sub buckets
+	uint msb = 63 - __builtin_clzll(value);
+	uint shift = msb - HISTOGRAM_PRECISION_BITS;
+	return ((shift + 1) << HISTOGRAM_PRECISION_BITS) +
+		((value >> shift) - SUB_BUCKET_COUNT);
+}
+
+// highest value held by bucket 'idx'
+static inline uint64_t _BucketMax(uint idx) {
+	if(idx < SUB_BUCKET_COUNT) return idx;
+
+	uint shift = (idx >> HISTOGRAM_PRECISION_BITS) - 1;
+	uint64_t sub = idx & (SUB_BUCKET_COUNT - 1);
+	uint64_t lower = (SUB_BUCKET_COUNT + sub) << shift;
+	return lower + (1ULL << shift) - 1;
+}
+
+void Histogram_Init(Histogram *h) {
+	ASSERT(h != NULL);
+	memset(h, 0, sizeof(Histogram));
+}
+
+void Histogram_Record(Histogram *h, uint64_t value) {
+	ASSERT(h != NULL);
+
+	__atomic_fetch_add(h->buckets + _BucketIndex(value), 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&h->count, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&h->sum, value, __ATOMIC_RELAXED);
+
+	// raise max
+	uint64_t max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+	while(value > max && !__atomic_compare_exchange_n(&h->max, &max, value,
+				true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+uint64_t Histogram_Count(const Histogram *h) {
+	ASSERT(h != NULL);
+	return __atomic_load_n(&h->count, __ATOMIC_RELAXED);
+}
+
+double Histogram_Mean(const Histogram *h) {
+	ASSERT(h != NULL);
+	uint64_t count = __atomic_load_n(&h->count, __ATOMIC_RELAXED);
+	if(count == 0) return 0;
+	return (double)__atomic_load_n(&h->sum, __ATOMIC_RELAXED) / count;
+}
+
+uint64_t Histogram_Max(const Histogram *h) {
+	ASSERT(h != NULL);
+	return __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+}
+
+uint64_t Histogram_Percentile(const Histogram *h, double percentile) {
+	ASSERT(h != NULL);
+	ASSERT(percentile >= 0 && percentile <= 100);
+
+	// take a snapshot, values might be recorded concurrently
+	uint64_t total = 0;
+	uint64_t buckets[HISTOGRAM_BUCKET_COUNT];
+	for(uint i = 0; i < HISTOGRAM_BUCKET_COUNT; i++) {
+		buckets[i] = __atomic_load_n(h->buckets + i, __ATOMIC_RELAXED);
+		total += buckets[i];
+	}
+	if(total == 0) return 0;
+
+	// rank of the requested value
+	uint64_t rank = ceil(total * percentile / 100);
+	if(rank == 0) rank = 1;
+
+	uint64_t seen = 0;
+	for(uint i = 0; i < HISTOGRAM_BUCKET_COUNT; i++) {
+		seen += buckets[i];
+		if(seen < rank) continue;
+		// bucket's bound might exceed the largest recorded value
+		uint64_t value = _BucketMax(i);
+		uint64_t max = Histogram_Max(h);
+		return (value < max) ? value : max;
+	}
+
+	ASSERT(false);
+	return 0;
+}
+
@@ -0,0 +1,68 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/* Histogram records non-negative integer values in log-linear buckets,
+ * similar to an HDR histogram: each power of two range is split into
+ * 2^HISTOGRAM_PRECISION_BITS equal buckets, such that a recorded value is
+ * reported with a relative error below 1/2^HISTOGRAM_PRECISION_BITS.
+ * values below 2^HISTOGRAM_PRECISION_BITS are recorded exactly.
+ * recording is lock-free and can be done concurrently from multiple threads */
+
+#define HISTOGRAM_PRECISION_BITS 3   // log2 of number of buckets per power of two
+#define HISTOGRAM_MAX_BITS 40        // values are capped at 2^HISTOGRAM_MAX_BITS - 1
+#define HISTOGRAM_BUCKET_COUNT \
+	((HISTOGRAM_MAX_BITS - HISTOGRAM_PRECISION_BITS + 1) << HISTOGRAM_PRECISION_BITS)
+
+typedef struct {
+	uint64_t count;                            // number of recorded values
+	uint64_t sum;                              // sum of recorded values
+	uint64_t max;                              // largest recorded value
+	uint64_t buckets[HISTOGRAM_BUCKET_COUNT];  // number of values per bucket
+} Histogram;
+
+// reset histogram
+void Histogram_Init
+(
+	Histogram *h
+);
+
+// record a single value
+void Histogram_Record
+(
+	Histogram *h,
+	uint64_t value
+);
+
+// number of recorded values
+uint64_t Histogram_Count
+(
+	const Histogram *h
+);
+
+// mean of recorded values, 0 if histogram is empty
+double Histogram_Mean
+(
+	const Histogram *h
+);
+
+// largest recorded value
+uint64_t Histogram_Max
+(
+	const Histogram *h
+);
+
+// value below or equal to which 'percentile' percent of the values fall
+// reported as the highest value of its bucket, 0 if histogram is empty
+uint64_t Histogram_Percentile
+(
+	const Histogram *h,
+	double percentile  // [0-100]
+);
+
@@ -26,12 +26,14 @@ static inline sds _JsonEncoder_String(SIValue v, sds s) {
 static sds _JsonEncoder_Properties(const GraphEntity *ge, sds s) {
 	s = sdscat(s, "\"properties\": {");
 	uint prop_count = ENTITY_PROP_COUNT(ge);
-	EntityProperty *properties = ENTITY_PROPS(ge);
+	uint cursor = 0;
+	SIValue *value;
+	Attribute_ID attr_id;
 	GraphContext *gc = QueryCtx_GetGraphCtx();
-	for(uint i = 0; i < prop_count; i ++) {
-		const char *key = GraphContext_GetAttributeString(gc, properties[i].id);
+	for(uint i = 0; GraphEntity_NextProperty(ge, &cursor, &attr_id, &value); i ++) {
+		const char *key = GraphContext_GetAttributeString(gc, attr_id);
 		s = sdscatfmt(s, "\"%s\": ", key);
-		s = _JsonEncoder_SIValue(properties[i].value, s);
+		s = _JsonEncoder_SIValue(*value, s);
 		if(i < prop_count - 1) s = sdscat(s, ", ");
 	}
 	s = sdscat(s, "}");
@@ -18,8 +18,14 @@
 // in which case when the allocation is freed we will deduct
 // actual allocated size from 'n_alloced' which can lead to negative values if
 // bytes requested < bytes allocated
-static __thread int64_t n_alloced; 
+static __thread rm_mem_counter n_alloced;
+// counter charged for the thread's allocations, NULL for 'n_alloced'
+// set while the thread allocates on behalf of a query executed by another thread
+static __thread rm_mem_counter *charged;
 static int64_t mem_capacity;  // maximum memory consumption for thread
+static __thread uint64_t n_alloced_total;  // bytes requested by thread
+static bool track_alloc;      // track allocations regardless of capacity
+static bool tracking;         // tracking allocator is installed
  
 // function pointers which hold the original address of RedisModule_Alloc*
 static void (*RedisModule_Free_Orig)(void *ptr);
@@ -28,23 +34,55 @@ static char * (*RedisModule_Strdup_Orig)(const char *str);
 static void * (*RedisModule_Realloc_Orig)(void *ptr, size_t bytes);
 static void * (*RedisModule_Calloc_Orig)(size_t nmemb, size_t size);
 
+// counter charged for the current thread's allocations
+static inline rm_mem_counter *_counter(void) {
+	return (charged != NULL) ? charged : &n_alloced;
+}
+
 void rm_reset_n_alloced() {
-	n_alloced = 0;
+	n_alloced.alloced = 0;
+	n_alloced.peak = 0;
+}
+
+rm_mem_counter *rm_thread_mem_counter() {
+	return _counter();
+}
+
+void rm_charge_mem_counter(rm_mem_counter *counter) {
+	charged = (counter == &n_alloced) ? NULL : counter;
 }
 
 // removes n_bytes from thread memory consumption
+// counters might be shared, updates are atomic
 static inline void _nmalloc_decrement(int64_t n_bytes) {
-	n_alloced -= n_bytes;
+	__atomic_sub_fetch(&_counter()->alloced, n_bytes, __ATOMIC_RELAXED);
+}
+
+uint64_t rm_thread_alloced() {
+	return n_alloced_total;
+}
+
+int64_t rm_thread_peak_alloced() {
+	if(!tracking) return -1;
+	return __atomic_load_n(&_counter()->peak, __ATOMIC_RELAXED);
 }
 
 // adds nbytes to thread memory consumption
 static inline void _nmalloc_increment(int64_t n_bytes) {
-	n_alloced += n_bytes;
+	rm_mem_counter *c = _counter();
+	n_alloced_total += n_bytes;
+	int64_t alloced = __atomic_add_fetch(&c->alloced, n_bytes, __ATOMIC_RELAXED);
+
+	// raise peak
+	int64_t peak = __atomic_load_n(&c->peak, __ATOMIC_RELAXED);
+	while(alloced > peak && !__atomic_compare_exchange_n(&c->peak, &peak,
+				alloced, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
 	// check if capacity exceeded
-	if(unlikely(n_alloced > mem_capacity)) {
+	if(unlikely(mem_capacity > 0 && alloced > mem_capacity)) {
 		// set n_alloced to MIN to avoid further out of memory exceptions
 		// TODO: consider switching to double -inf
-		n_alloced = INT64_MIN;
+		__atomic_store_n(&c->alloced, INT64_MIN, __ATOMIC_RELAXED);
 		
 		// throw exception cause memory limit exceeded
 		ErrorCtx_SetError("Query's mem consumption exceeded capacity");
@@ -84,18 +122,14 @@ void rm_free_with_capacity(void *ptr) {
 	RedisModule_Free_Orig(ptr);
 }
 
-void rm_set_mem_capacity(int64_t cap) {
-	bool is_capped = (mem_capacity > 0); // current allocator applies memory cap
-	bool should_cap = (cap > 0); // should we use a memory capped allocator
-	
-	// The local enforced capacity should be set
-	// before resetting function pointers
-	// for instance if we're switching to capped allocator
-	// we want the memory cap to be set
-	mem_capacity = cap; 
-	if(should_cap && !is_capped) {
+// install the tracking allocator if memory is capped or tracked
+// restore the original allocator otherwise
+static void _rm_update_allocator(void) {
+	bool should_track = (mem_capacity > 0 || track_alloc);
+
+	if(should_track && !tracking) {
 		// store the function pointer original values and change them
-		// to the capped version
+		// to the tracking version
 		RedisModule_Free_Orig     =  RedisModule_Free;
 		RedisModule_Alloc_Orig    =  RedisModule_Alloc;
 		RedisModule_Calloc_Orig   =  RedisModule_Calloc;
@@ -106,7 +140,7 @@ void rm_set_mem_capacity(int64_t cap) {
 		RedisModule_Calloc        =  rm_calloc_with_capacity;
 		RedisModule_Strdup        =  rm_strdup_with_capacity;
 		RedisModule_Realloc       =  rm_realloc_with_capacity;
-	} else if(!should_cap && is_capped) {
+	} else if(!should_track && tracking) {
 		// restore all function pointers to their original values
 		RedisModule_Free     =  RedisModule_Free_Orig;
 		RedisModule_Alloc    =  RedisModule_Alloc_Orig;
@@ -114,6 +148,42 @@ void rm_set_mem_capacity(int64_t cap) {
 		RedisModule_Strdup   =  RedisModule_Strdup_Orig;
 		RedisModule_Realloc  =  RedisModule_Realloc_Orig;
 	}
+
+	tracking = should_track;
+}
+
+void rm_set_mem_capacity(int64_t cap) {
+	// The local enforced capacity should be set
+	// before resetting function pointers
+	// for instance if we're switching to capped allocator
+	// we want the memory cap to be set
+	mem_capacity = cap; 
+	_rm_update_allocator();
+}
+
+void rm_track_allocations(bool track) {
+	track_alloc = track;
+	_rm_update_allocator();
+}
+
+#else
+
+rm_mem_counter *rm_thread_mem_counter() {
+	return NULL;
+}
+
+void rm_charge_mem_counter(rm_mem_counter *counter) {
+}
+
+uint64_t rm_thread_alloced() {
+	return 0;
+}
+
+int64_t rm_thread_peak_alloced() {
+	return -1;
+}
+
+void rm_track_allocations(bool track) {
 }
 
 #endif
@@ -3,8 +3,16 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include "../redismodule.h"
 
+// memory consumption counter
+typedef struct {
+	int64_t alloced;  // bytes currently held, might be negative
+	int64_t peak;     // highest value of 'alloced' since last reset
+} rm_mem_counter;
+
 #ifdef REDIS_MODULE_TARGET /* Set this when compiling your code as a module */
 
 // called when mem_capacity configuration changes
@@ -57,6 +65,28 @@ static inline char *rm_strndup(const char *s, size_t n) {
 
 #define rm_new(x) rm_malloc(sizeof(x))
 
+// track allocations made by each thread even when memory isn't capped
+// see rm_thread_alloced
+void rm_track_allocations(bool track);
+
+// number of bytes requested by the current thread
+// only counted while memory is capped or allocations are tracked
+uint64_t rm_thread_alloced();
+
+// highest memory consumption of the current thread since its last reset
+// only counted while memory is capped or allocations are tracked
+// returns -1 otherwise
+int64_t rm_thread_peak_alloced();
+
+// memory counter charged for the current thread's allocations
+rm_mem_counter *rm_thread_mem_counter();
+
+// charge the current thread's allocations to 'counter'
+// used by threads allocating on behalf of a query executed by another thread
+// such that the query's memory consumption is capped as a whole
+// NULL charges the current thread's own counter
+void rm_charge_mem_counter(rm_mem_counter *counter);
+
 /* Revert the allocator patches so that
  * the stdlib malloc functions will be used
  * for use when executing code from non-Redis
@@ -7,6 +7,7 @@
 #include <pthread.h>
 #include "RG.h"
 #include "pools.h"
+#include "../rmalloc.h"
 #include "../../configuration/config.h"
 
 //------------------------------------------------------------------------------
@@ -16,6 +17,20 @@
 static threadpool _bulk_thpool = NULL;     // bulk loader workers
 static threadpool _readers_thpool = NULL;  // readers
 static threadpool _writers_thpool = NULL;  // writers
+static threadpool _parallel_thpool = NULL; // parallel scan workers
+static threadpool _task_thpool = NULL;     // internal parallel tasks workers
+
+// parallel execution of a fixed number of tasks, see ThreadPools_RunTasks
+typedef struct {
+	void (*task)(void *ctx, uint i);  // task function
+	void *ctx;                        // task context
+	uint task_count;                  // number of tasks
+	uint next;                        // next unclaimed task
+	uint done;                        // number of completed tasks
+	uint refcount;                    // number of threads referring to group
+	pthread_mutex_t lock;             // guards task claims and counters
+	pthread_cond_t cond;              // signaled once all tasks are done
+} TaskGroup;
 
 int ThreadPools_Init
 (
@@ -24,6 +39,7 @@ int ThreadPools_Init
 	int       reader_count    =  1;
 	int       bulk_count      =  1;
 	int       writer_count    =  1;
+	uint      parallel_count  =  0;
 	uint64_t  max_queue_size  =  UINT64_MAX;
 
 	// get thread pool size and thread pool internal queue length from config
@@ -33,8 +49,17 @@ int ThreadPools_Init
 	config_read = Config_Option_get(Config_MAX_QUEUED_QUERIES, &max_queue_size);
 	ASSERT(config_read == true);
 
-	return ThreadPools_CreatePools(reader_count, writer_count, bulk_count,
-			max_queue_size);
+	config_read = Config_Option_get(Config_PARALLEL_SCAN_THREADS, &parallel_count);
+	ASSERT(config_read == true);
+
+	if(!ThreadPools_CreatePools(reader_count, writer_count, bulk_count,
+			max_queue_size)) return 0;
+
+	// internal tasks are spread across as many threads as readers,
+	// which defaults to the number of cores
+	if(!ThreadPools_CreateTaskPool(reader_count)) return 0;
+
+	return ThreadPools_CreateParallelPool(parallel_count);
 }
 
 // set up thread pools  (readers and writers)
@@ -63,6 +88,36 @@ int ThreadPools_CreatePools
 	return 1;
 }
 
+// set up parallel scan thread pool
+// a pool of size 0 disables parallel scans
+// returns 1 if thread pool initialized, 0 otherwise
+int ThreadPools_CreateParallelPool
+(
+	uint parallel_count
+) {
+	ASSERT(_parallel_thpool == NULL);
+
+	if(parallel_count == 0) return 1;
+
+	_parallel_thpool = thpool_init(parallel_count, "parallel_scan");
+	return (_parallel_thpool != NULL);
+}
+
+// set up task thread pool
+// a pool of size 0 runs tasks on the calling thread
+// returns 1 if thread pool initialized, 0 otherwise
+int ThreadPools_CreateTaskPool
+(
+	uint task_count
+) {
+	ASSERT(_task_thpool == NULL);
+
+	if(task_count == 0) return 1;
+
+	_task_thpool = thpool_init(task_count, "task");
+	return (_task_thpool != NULL);
+}
+
 // return number of threads in both the readers and writers pools
 uint ThreadPools_ThreadCount
 (
@@ -86,6 +141,30 @@ uint ThreadPools_ReadersCount
 	return thpool_num_threads(_readers_thpool);
 }
 
+uint ThreadPools_BulkLoaderCount
+(
+	void
+) {
+	ASSERT(_bulk_thpool != NULL);
+	return thpool_num_threads(_bulk_thpool);
+}
+
+uint ThreadPools_ParallelCount
+(
+	void
+) {
+	if(_parallel_thpool == NULL) return 0;
+	return thpool_num_threads(_parallel_thpool);
+}
+
+uint ThreadPools_TaskCount
+(
+	void
+) {
+	if(_task_thpool == NULL) return 0;
+	return thpool_num_threads(_task_thpool);
+}
+
 // retrieve current thread id
 // 0         redis-main
 // 1..N + 1  readers
@@ -128,6 +207,8 @@ void ThreadPools_Pause
 	thpool_pause(_bulk_thpool);
 	thpool_pause(_readers_thpool);
 	thpool_pause(_writers_thpool);
+	if(_parallel_thpool != NULL) thpool_pause(_parallel_thpool);
+	if(_task_thpool != NULL) thpool_pause(_task_thpool);
 }
 
 void ThreadPools_Resume
@@ -142,6 +223,8 @@ void ThreadPools_Resume
 	thpool_resume(_bulk_thpool);
 	thpool_resume(_readers_thpool);
 	thpool_resume(_writers_thpool);
+	if(_parallel_thpool != NULL) thpool_resume(_parallel_thpool);
+	if(_task_thpool != NULL) thpool_resume(_task_thpool);
 }
 
 // add task for reader thread
@@ -183,6 +266,112 @@ int ThreadPools_AddWorkBulkLoader
 	return thpool_add_work(_bulk_thpool, function_p, arg_p);
 }
 
+// add task for parallel scan thread
+int ThreadPools_AddWorkParallel
+(
+	void (*function_p)(void *),
+	void *arg_p
+) {
+	ASSERT(_parallel_thpool != NULL);
+
+	return thpool_add_work(_parallel_thpool, function_p, arg_p);
+}
+
+// claim and run tasks until none are left
+static void _TaskGroup_Run(TaskGroup *group) {
+	while(true) {
+		pthread_mutex_lock(&group->lock);
+		if(group->next == group->task_count) {
+			pthread_mutex_unlock(&group->lock);
+			return;
+		}
+		uint i = group->next++;
+		pthread_mutex_unlock(&group->lock);
+
+		group->task(group->ctx, i);
+
+		pthread_mutex_lock(&group->lock);
+		group->done++;
+		if(group->done == group->task_count) pthread_cond_signal(&group->cond);
+		pthread_mutex_unlock(&group->lock);
+	}
+}
+
+static void _TaskGroup_Release(TaskGroup *group) {
+	pthread_mutex_lock(&group->lock);
+	bool last = (--group->refcount == 0);
+	pthread_mutex_unlock(&group->lock);
+
+	if(!last) return;
+	pthread_mutex_destroy(&group->lock);
+	pthread_cond_destroy(&group->cond);
+	rm_free(group);
+}
+
+static void _TaskWork(void *arg) {
+	TaskGroup *group = (TaskGroup *)arg;
+	rm_reset_n_alloced();
+	_TaskGroup_Run(group);
+	_TaskGroup_Release(group);
+}
+
+void ThreadPools_RunTasks
+(
+	void (*task)(void *ctx, uint i),
+	void *ctx,
+	uint task_count
+) {
+	ASSERT(task != NULL);
+	if(task_count == 0) return;
+
+	uint workers = ThreadPools_TaskCount();
+	if(workers > task_count - 1) workers = task_count - 1;
+
+	if(workers == 0) {
+		for(uint i = 0; i < task_count; i++) task(ctx, i);
+		return;
+	}
+
+	TaskGroup *group = rm_malloc(sizeof(TaskGroup));
+	group->task = task;
+	group->ctx = ctx;
+	group->task_count = task_count;
+	group->next = 0;
+	group->done = 0;
+	group->refcount = workers + 1;
+	pthread_mutex_init(&group->lock, NULL);
+	pthread_cond_init(&group->cond, NULL);
+
+	for(uint i = 0; i < workers; i++) {
+		thpool_add_work(_task_thpool, _TaskWork, group);
+	}
+
+	// participate, then wait for tasks claimed by pool threads
+	_TaskGroup_Run(group);
+	pthread_mutex_lock(&group->lock);
+	while(group->done < group->task_count) {
+		pthread_cond_wait(&group->cond, &group->lock);
+	}
+	pthread_mutex_unlock(&group->lock);
+	_TaskGroup_Release(group);
+}
+
+uint ThreadPools_ReadersQueueLength
+(
+	void
+) {
+	ASSERT(_readers_thpool != NULL);
+	return thpool_queue_len(_readers_thpool);
+}
+
+uint ThreadPools_WritersQueueLength
+(
+	void
+) {
+	ASSERT(_writers_thpool != NULL);
+	return thpool_queue_len(_writers_thpool);
+}
+
 void ThreadPools_SetMaxPendingWork(uint64_t val) {
 	if(_readers_thpool != NULL) thpool_set_jobqueue_cap(_readers_thpool, val);
 	if(_writers_thpool != NULL) thpool_set_jobqueue_cap(_writers_thpool, val);
@@ -25,6 +25,18 @@ int ThreadPools_CreatePools
 	uint64_t max_pending_work
 );
 
+// create parallel scan thread pool, no pool is created if count is 0
+int ThreadPools_CreateParallelPool
+(
+	uint parallel_count
+);
+
+// create task thread pool, no pool is created if count is 0
+int ThreadPools_CreateTaskPool
+(
+	uint task_count
+);
+
 // return number of threads in both the readers and writers pools
 uint ThreadPools_ThreadCount
 (
@@ -37,6 +49,24 @@ uint ThreadPools_ReadersCount
 	void
 );
 
+// return size of bulk loader thread-pool
+uint ThreadPools_BulkLoaderCount
+(
+	void
+);
+
+// return size of parallel scan thread-pool, 0 if disabled
+uint ThreadPools_ParallelCount
+(
+	void
+);
+
+// return size of task thread-pool, 0 if no pool was created
+uint ThreadPools_TaskCount
+(
+	void
+);
+
 // retrieve current thread id
 // 0         redis-main
 // 1..N + 1  readers
@@ -79,6 +109,36 @@ int ThreadPools_AddWorkBulkLoader
 	void *arg_p
 );
 
+// add a parallel scan task
+int ThreadPools_AddWorkParallel
+(
+	void (*function_p)(void *),
+	void *arg_p
+);
+
+// run 'task_count' tasks, each invoked as task(ctx, i)
+// tasks are claimed by both the task pool threads and the calling thread
+// such that work completes even if no pool thread is available
+// returns once all tasks are done
+void ThreadPools_RunTasks
+(
+	void (*task)(void *ctx, uint i),
+	void *ctx,
+	uint task_count
+);
+
+// return number of tasks waiting in the READERS thread-pool queue
+uint ThreadPools_ReadersQueueLength
+(
+	void
+);
+
+// return number of tasks waiting in the WRITERS thread-pool queue
+uint ThreadPools_WritersQueueLength
+(
+	void
+);
+
 // sets the limit on max queued queries in each thread pool
 void ThreadPools_SetMaxPendingWork
 (
@@ -282,6 +282,13 @@ bool thpool_queue_full(thpool_* thpool_p) {
 	return (thpool_p->jobqueue.len >= thpool_p->jobqueue.cap);
 }
 
+int thpool_queue_len(thpool_* thpool_p) {
+	ASSERT(thpool_p != NULL);
+
+	// read without the queue lock, the value might be momentarily stale
+	return __atomic_load_n(&thpool_p->jobqueue.len, __ATOMIC_RELAXED);
+}
+
 void thpool_set_jobqueue_cap(thpool_* thpool_p, uint64_t val) {
 	ASSERT(thpool_p);
 	thpool_p->jobqueue.cap = val;
@@ -212,6 +212,14 @@ int thpool_get_thread_id(threadpool, pthread_t);
  */
 bool thpool_queue_full(threadpool);
 
+/**
+ * @brief Returns the number of jobs waiting in the thread pool internal queue
+ *
+ * @param threadpool    the threadpool of interest
+ * @return int          number of pending jobs
+ */
+int thpool_queue_len(threadpool);
+
 /**
  * @brief Sets jobqueue capacity.
  *
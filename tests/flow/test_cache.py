@@ -245,3 +245,39 @@ class testCache(FlowTestsBase):
         cached_result = graph.query(query, params)
         self.env.assertEqual(expected_result, cached_result.result_set)
         self.env.assertTrue(cached_result.cached_execution)
+
+    def test13_test_recycled_executions(self):
+        # Repeating a read-only query with the exact same parameters
+        # executes a previously executed plan again, it should produce
+        # the same results as long as the graph is unchanged, and reflect
+        # modifications once the graph changes.
+        graph = Graph('Cache_Test_Recycled', redis_con)
+        graph.query("UNWIND range(1, 10) AS x CREATE (:N {v: x, s: toString(x % 3)})")
+
+        queries = [
+            ("MATCH (n:N) WHERE n.v > $v RETURN n.v ORDER BY n.v", {'v': 5}),
+            ("MATCH (n:N) WHERE n.s IN $s RETURN DISTINCT n.s ORDER BY n.s", {'s': ['0', '1']}),
+            ("MATCH (n:N) WHERE n.s = $s RETURN n.v ORDER BY n.v DESC LIMIT 2", {'s': '1'}),
+            ("MATCH (n:N {v: $v}) RETURN n.v UNION MATCH (n:N {v: $w}) RETURN n.v", {'v': 1, 'w': 2}),
+            ("MATCH (n:N) WHERE id(n) = $id RETURN n.v", {'id': 0}),
+            ("MATCH (n:N) RETURN count(n), collect(DISTINCT n.s)", {}),
+        ]
+
+        expected = [graph.query(q, p).result_set for q, p in queries]
+        for i in range(3):
+            for (q, p), e in zip(queries, expected):
+                result = graph.query(q, p)
+                self.env.assertTrue(result.cached_execution)
+                self.env.assertEqual(result.result_set, e)
+
+        # Modify the graph, previously executed plans reflect the change.
+        graph.query("MATCH (n:N {v: 10}) DELETE n")
+        graph.query("CREATE INDEX ON :N(v)")
+        graph.query("CREATE (:N {v: 11, s: '2'})")
+        for i in range(2):
+            result = graph.query(queries[0][0], queries[0][1])
+            self.env.assertEqual(result.result_set, [[6], [7], [8], [9], [11]])
+            result = graph.query(queries[5][0], queries[5][1])
+            self.env.assertEqual(result.result_set[0][0], 10)
+
+        graph.delete()
@@ -0,0 +1,102 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "composite_index"
+redis_graph = None
+
+class testCompositeIndexFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # 40 people, even ages live in Peru, odd ages in Chile
+        redis_graph.query("""UNWIND range(0, 39) AS i
+                             CREATE (:Person {country: CASE WHEN i % 2 = 0 THEN 'Peru' ELSE 'Chile' END,
+                                              age: 20 + i, name: 'p' + toString(i)})""")
+
+    def composite_indices(self):
+        query = """CALL db.indexes() YIELD type, label, properties RETURN type, label, properties"""
+        result = redis_graph.query(query)
+        return [row[1:] for row in result.result_set if row[0] == 'composite']
+
+    def test01_create_composite_index(self):
+        redis_graph.query("""CALL db.idx.composite.createNodeIndex('Person', ['country', 'age'], ['name'])""")
+
+        self.env.assertEquals(self.composite_indices(), [['Person', ['country', 'age']]])
+
+        # key properties must be a non empty list of strings
+        # invalid calls don't create an index
+        for q in ["""CALL db.idx.composite.createNodeIndex('Person', 'country')""",
+                  """CALL db.idx.composite.createNodeIndex('Person', [])""",
+                  """CALL db.idx.composite.createNodeIndex('Person', [1, 2])"""]:
+            redis_graph.query(q)
+        self.env.assertEquals(self.composite_indices(), [['Person', ['country', 'age']]])
+
+    def test02_composite_index_scan(self):
+        # returning the node requires visiting it
+        query = """MATCH (p:Person) WHERE p.country = 'Peru' AND p.age > 50 RETURN p.name ORDER BY p.name"""
+        plan = redis_graph.execution_plan("""MATCH (p:Person) WHERE p.country = 'Peru' AND p.age > 50 RETURN p""")
+        self.env.assertIn("Composite Index Scan", plan)
+        self.env.assertNotIn("Label Scan", plan)
+
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [['p32'], ['p34'], ['p36'], ['p38']])
+
+    def test03_covering_index_scan(self):
+        # every accessed property is stored by the index
+        query = """MATCH (p:Person) WHERE p.country = 'Peru' AND p.age > 50 RETURN p.name, p.age ORDER BY p.age"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Covering Index Scan", plan)
+
+        result = redis_graph.query(query)
+        expected = [['p32', 52], ['p34', 54], ['p36', 56], ['p38', 58]]
+        self.env.assertEquals(result.result_set, expected)
+
+    def test04_index_updated_on_set(self):
+        # move p32 out of range and p30 into it
+        redis_graph.query("""MATCH (p:Person {name: 'p32'}) SET p.age = 10""")
+        redis_graph.query("""MATCH (p:Person {name: 'p30'}) SET p.age = 60, p.name = 'p30b'""")
+
+        query = """MATCH (p:Person) WHERE p.country = 'Peru' AND p.age > 50 RETURN p.name, p.age ORDER BY p.age"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Covering Index Scan", plan)
+
+        # included property is served from the index's updated copy
+        result = redis_graph.query(query)
+        expected = [['p34', 54], ['p36', 56], ['p38', 58], ['p30b', 60]]
+        self.env.assertEquals(result.result_set, expected)
+
+        # moving a node to a different leading key value
+        redis_graph.query("""MATCH (p:Person {name: 'p34'}) SET p.country = 'Chile'""")
+        result = redis_graph.query(query)
+        expected = [['p36', 56], ['p38', 58], ['p30b', 60]]
+        self.env.assertEquals(result.result_set, expected)
+
+    def test05_index_updated_on_delete(self):
+        redis_graph.query("""MATCH (p:Person {name: 'p36'}) DELETE p""")
+
+        query = """MATCH (p:Person) WHERE p.country = 'Peru' AND p.age > 50 RETURN p.name, p.age ORDER BY p.age"""
+        result = redis_graph.query(query)
+        expected = [['p38', 58], ['p30b', 60]]
+        self.env.assertEquals(result.result_set, expected)
+
+    def test06_drop_composite_index(self):
+        redis_graph.query("""CALL db.idx.composite.drop('Person', ['country', 'age'])""")
+
+        self.env.assertEquals(self.composite_indices(), [])
+
+        # queries fall back to a label scan, results are unchanged
+        query = """MATCH (p:Person) WHERE p.country = 'Peru' AND p.age > 50 RETURN p.name, p.age ORDER BY p.age"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertNotIn("Composite Index Scan", plan)
+        self.env.assertNotIn("Covering Index Scan", plan)
+        self.env.assertIn("Label Scan", plan)
+
+        result = redis_graph.query(query)
+        expected = [['p38', 58], ['p30b', 60]]
+        self.env.assertEquals(result.result_set, expected)
@@ -0,0 +1,94 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "conditional_traverse_batch"
+SRC_COUNT = 4000
+DST_COUNT = 64
+redis_con = None
+redis_graph = None
+
+class testConditionalTraverseBatch(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+        # Sample every query, operation statistics count evaluations as batches.
+        redis_con.execute_command("GRAPH.CONFIG SET OP_STATS_SAMPLE_RATE 100")
+
+    def populate_graph(self):
+        # Source nodes are created first, such that they're scanned by ID.
+        redis_graph.query("UNWIND range(0, %d) AS x CREATE (:Src {v: x})" % (SRC_COUNT - 1))
+        redis_graph.query("UNWIND range(0, %d) AS x CREATE (:Dst {v: x})" % (DST_COUNT - 1))
+
+        # The first half of the sources have a single outgoing edge,
+        # the second half is connected to every destination.
+        redis_graph.query("""MATCH (s:Src), (d:Dst {v: 0}) WHERE s.v < %d
+                             CREATE (s)-[:R]->(d)""" % (SRC_COUNT / 2))
+        redis_graph.query("""MATCH (s:Src), (d:Dst) WHERE s.v >= %d
+                             CREATE (s)-[:R]->(d)""" % (SRC_COUNT / 2))
+
+    def op_stats(self):
+        stats = redis_con.execute_command("GRAPH.INFO", GRAPH_ID, "OPSTATS")
+        return {fingerprint: ops for fingerprint, samples, ops in stats}
+
+    # Number of evaluations performed by Conditional Traverse running query.
+    def traverse_batches(self, query):
+        before = self.op_stats()
+        redis_graph.query(query)
+        for fingerprint, ops in self.op_stats().items():
+            prev = before.get(fingerprint)
+            if prev == ops:
+                continue
+            for i, op in enumerate(ops):
+                if op[0] == "Conditional Traverse":
+                    return op[2] - (prev[i][2] if prev else 0)
+        return None
+
+    def test_adaptive_batch_matches_fixed_batch(self):
+        # Conditional Traverse starts with a batch of SRC_COUNT / 64 sources.
+        # A fan-out of 1 over the first half doubles the batch after every
+        # evaluation, the batch straddling into the second half then
+        # observes a fan-out near DST_COUNT and shrinks the next batch.
+        adaptive = """MATCH (s:Src)-[:R]->(d)
+                      RETURN sum(s.v), sum(d.v), sum(1)"""
+        plan = redis_graph.execution_plan(adaptive)
+        self.env.assertIn("Conditional Traverse", plan)
+
+        # Expand Into always accumulates a fixed number of records.
+        fixed = """MATCH (s:Src), (d:Dst) MATCH (s)-[:R]->(d)
+                   RETURN sum(s.v), sum(d.v), sum(1)"""
+        plan = redis_graph.execution_plan(fixed)
+        self.env.assertIn("Expand Into", plan)
+        self.env.assertNotIn("Conditional Traverse", plan)
+
+        half = SRC_COUNT // 2
+        low_src_sum = sum(range(0, half))
+        high_src_sum = sum(range(half, SRC_COUNT)) * DST_COUNT
+        high_dst_sum = sum(range(0, DST_COUNT)) * half
+        expected = [[low_src_sum + high_src_sum, high_dst_sum,
+                     half + half * DST_COUNT]]
+
+        self.env.assertEquals(redis_graph.query(adaptive).result_set, expected)
+        self.env.assertEquals(redis_graph.query(fixed).result_set, expected)
+
+    def test_adaptive_batch_evaluations(self):
+        # Sources are estimated from the Src label, the first batch covers
+        # SRC_COUNT / 64 = 62 sources, bounded by the estimated fan-out:
+        # 65536 / ceil(130000 / 4000) = 1985.
+        # Batches over the first half double: 62, 124, 248, 496, 992
+        # covering 1922 sources, the next 1984 sources observe a fan-out
+        # of 62, such that the next batch is 65536 / 62 = 1057 sources,
+        # covering the remaining 94.
+        query = """MATCH (s:Src)-[:R]->(d) RETURN sum(s.v), sum(d.v)"""
+        self.env.assertEquals(self.traverse_batches(query), 7)
+
+    def test_limited_batch_evaluations(self):
+        # A limit keeps the first batch at 16 sources, growing from the
+        # observed fan-out of 1: 16, 32, 64 sources produce 112 records.
+        query = """MATCH (s:Src)-[:R]->(d) RETURN s.v, d.v LIMIT 100"""
+        self.env.assertEquals(self.traverse_batches(query), 3)
@@ -0,0 +1,77 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "degree_count"
+redis_graph = None
+
+class testDegreeCountFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # n1 has 3 outgoing R edges to 2 distinct neighbours, n2 has 1
+        # n1 is reached by 2 X edges
+        redis_graph.query("""CREATE (n1:N {v: 1}), (n2:N {v: 2}), (m1:M), (m2:M), (a1:A), (a2:A),
+                                    (n1)-[:R]->(m1), (n1)-[:R]->(m1), (n1)-[:R]->(m2), (n2)-[:R]->(m1),
+                                    (a1)-[:X]->(n1), (a2)-[:X]->(n1)""")
+
+    # sorted [n.v, count] pairs
+    def counts(self, query):
+        result = redis_graph.query(query)
+        return sorted([row[0].properties['v'], row[1]] for row in result.result_set)
+
+    def test01_reduced_plan(self):
+        query = """MATCH (n:N)-[e:R]->() RETURN n, count(e)"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertNotIn("Conditional Traverse", plan)
+        self.env.assertNotIn("Aggregate", plan)
+
+        # degree counts every edge, including multi-edges
+        self.env.assertEquals(self.counts(query), [[1, 3], [2, 1]])
+
+        # same result when the traversal isn't reduced
+        query = """MATCH (n:N)-[e:R]->() WHERE e.w IS NULL RETURN n, count(e)"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Conditional Traverse", plan)
+        self.env.assertEquals(self.counts(query), [[1, 3], [2, 1]])
+
+    def test02_unreferenced_edge(self):
+        # an anonymous edge is traversed once per distinct neighbour
+        # the plan isn't reduced, as degrees count edges
+        query = """MATCH (n:N)-[:R]->() RETURN n, count(*)"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Conditional Traverse", plan)
+        self.env.assertIn("Aggregate", plan)
+
+    def test03_repeated_source_rows(self):
+        # n1 reaches the aggregation once per incoming X edge
+        query = """MATCH (a)-[:X]->(n)-[e:R]->() RETURN n, count(e)"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Aggregate", plan)
+        self.env.assertEquals(self.counts(query), [[1, 6]])
+
+        # every node is scanned once per unwound element
+        query = """UNWIND [1, 2] AS x MATCH (n:N)-[e:R]->() RETURN n, count(e)"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Aggregate", plan)
+        self.env.assertEquals(self.counts(query), [[1, 6], [2, 2]])
+
+    def test04_size_of_pattern(self):
+        query = """MATCH (n:N) RETURN n.v, size((n)-[:R]->()) ORDER BY n.v"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[1, 3], [2, 1]])
+
+        query = """MATCH (m:M) RETURN size((m)<-[:R]-()) AS d ORDER BY d"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[1], [3]])
+
+        # pattern size reflects deleted edges
+        redis_graph.query("""MATCH (:N {v: 2})-[e:R]->() DELETE e""")
+        query = """MATCH (n:N) RETURN n.v, size((n)-[:R]->()) ORDER BY n.v"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[1, 3], [2, 0]])
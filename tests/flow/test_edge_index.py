@@ -0,0 +1,96 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "edge_index"
+redis_graph = None
+
+EQ_QUERY = """MATCH (a:Account)-[t:TRANSFER {tx_id: $id}]->(b:Account) RETURN a.name, t.tx_id, b.name"""
+RANGE_QUERY = """MATCH (a:Account)-[t:TRANSFER]->(b:Account) WHERE t.tx_id >= $min AND t.tx_id < $max
+                 RETURN a.name, t.tx_id, b.name ORDER BY t.tx_id"""
+
+class testEdgeIndexFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # 10 accounts, transfer i goes from a<i % 10> to a<(i + 1) % 10>
+        redis_graph.query("""UNWIND range(0, 9) AS i CREATE (:Account {name: 'a' + toString(i)})""")
+        redis_graph.query("""UNWIND range(0, 19) AS i
+                             MATCH (a:Account {name: 'a' + toString(i % 10)}), (b:Account {name: 'a' + toString((i + 1) % 10)})
+                             CREATE (a)-[:TRANSFER {tx_id: i}]->(b)""")
+
+    def explain(self, query, params):
+        prefix = "CYPHER " + " ".join("%s=%s" % (k, v) for k, v in params.items())
+        plan = redis_graph.redis_con.execute_command("GRAPH.EXPLAIN", GRAPH_ID, prefix + " " + query)
+        return "\n".join(plan)
+
+    def lookup(self, tx_id):
+        return redis_graph.query(EQ_QUERY, {'id': tx_id}).result_set
+
+    def range(self, min, max):
+        return redis_graph.query(RANGE_QUERY, {'min': min, 'max': max}).result_set
+
+    def test01_create_edge_index(self):
+        redis_graph.query("""CALL db.idx.relationship.createIndex('TRANSFER', 'tx_id')""")
+
+        query = """CALL db.indexes() YIELD label, properties RETURN label, properties"""
+        result = redis_graph.query(query)
+        self.env.assertIn(['TRANSFER', ['tx_id']], result.result_set)
+
+    def test02_equality_lookup(self):
+        plan = self.explain(EQ_QUERY, {'id': 13})
+        self.env.assertIn("Edge Index Scan", plan)
+        self.env.assertNotIn("Conditional Traverse", plan)
+
+        self.env.assertEquals(self.lookup(13), [['a3', 13, 'a4']])
+        self.env.assertEquals(self.lookup(20), [])
+
+    def test03_range_lookup(self):
+        plan = self.explain(RANGE_QUERY, {'min': 5, 'max': 8})
+        self.env.assertIn("Edge Index Scan", plan)
+
+        expected = [['a5', 5, 'a6'], ['a6', 6, 'a7'], ['a7', 7, 'a8']]
+        self.env.assertEquals(self.range(5, 8), expected)
+
+    def test04_lookup_after_update(self):
+        redis_graph.query("""MATCH ()-[t:TRANSFER {tx_id: 13}]->() SET t.tx_id = 100""")
+
+        self.env.assertEquals(self.lookup(13), [])
+        self.env.assertEquals(self.lookup(100), [['a3', 100, 'a4']])
+
+    def test05_lookup_after_edge_deletion(self):
+        redis_graph.query("""MATCH ()-[t:TRANSFER {tx_id: 5}]->() DELETE t""")
+
+        self.env.assertEquals(self.lookup(5), [])
+        expected = [['a6', 6, 'a7'], ['a7', 7, 'a8']]
+        self.env.assertEquals(self.range(5, 8), expected)
+
+    def test06_lookup_after_node_deletion(self):
+        # deleting a4 implicitly deletes transfers 3, 4, 14 and 100
+        result = redis_graph.query("""MATCH (a:Account {name: 'a4'}) DELETE a""")
+        self.env.assertEquals(result.nodes_deleted, 1)
+        self.env.assertEquals(result.relationships_deleted, 4)
+
+        for tx_id in [3, 4, 14, 100]:
+            self.env.assertEquals(self.lookup(tx_id), [])
+
+        self.env.assertEquals(self.range(2, 5), [['a2', 2, 'a3']])
+        self.env.assertEquals(len(self.range(0, 200)), 15)
+
+        # remaining transfers are still found
+        self.env.assertEquals(self.lookup(15), [['a5', 15, 'a6']])
+
+    def test07_drop_edge_index(self):
+        indexed = self.range(0, 200)
+        redis_graph.query("""CALL db.idx.relationship.drop('TRANSFER', 'tx_id')""")
+
+        plan = self.explain(RANGE_QUERY, {'min': 0, 'max': 200})
+        self.env.assertNotIn("Edge Index Scan", plan)
+
+        # results are unchanged without the index
+        self.env.assertEquals(self.range(0, 200), indexed)
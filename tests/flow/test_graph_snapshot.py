@@ -0,0 +1,83 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "snapshot_test"
+SNAPSHOT_PATH = "snapshot_test.snap"
+redis_con = None
+redis_graph = None
+
+class testGraphSnapshot(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        # LOAD is refused when writes are propagated.
+        if self.env.useAof or self.env.useSlaves:
+            self.env.skip()
+
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+        # Populate graph.
+        redis_graph.query("""UNWIND range(0, 99) AS x
+                             CREATE (:L {v: x})-[:R {w: x}]->(:M {name: 'm' + toString(x)})""")
+        redis_graph.query("""CREATE INDEX ON :L(v)""")
+
+    def snapshot(self, action, graph, path):
+        return redis_con.execute_command("GRAPH.SNAPSHOT", action, graph, path)
+
+    def expect_error(self, action, graph, path, msg):
+        try:
+            self.snapshot(action, graph, path)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn(msg, str(e))
+
+    def test01_save_load_round_trip(self):
+        self.env.assertEquals(self.snapshot("SAVE", GRAPH_ID, SNAPSHOT_PATH), "OK")
+        self.env.assertEquals(self.snapshot("LOAD", "snapshot_copy", SNAPSHOT_PATH), "OK")
+
+        copy = Graph("snapshot_copy", redis_con)
+        queries = ["""MATCH (l:L)-[r:R]->(m:M) RETURN l.v, r.w, m.name ORDER BY l.v""",
+                   """MATCH (l:L) WHERE l.v = 42 RETURN l.v"""]
+        for q in queries:
+            expected = redis_graph.query(q).result_set
+            actual = copy.query(q).result_set
+            self.env.assertEquals(expected, actual)
+
+        # Index is rebuilt once the graph is loaded.
+        plan = copy.execution_plan("""MATCH (l:L) WHERE l.v = 42 RETURN l.v""")
+        self.env.assertIn("Index Scan", plan)
+
+        # Loaded graph accepts writes.
+        result = copy.query("""CREATE (:L {v: 100})""")
+        self.env.assertEquals(result.nodes_created, 1)
+
+    def test02_load_existing_key(self):
+        self.expect_error("LOAD", GRAPH_ID, SNAPSHOT_PATH, "already exists")
+
+    def test03_load_missing_file(self):
+        self.expect_error("LOAD", "snapshot_missing", "no_such_file.snap", "Failed to open")
+        self.env.assertFalse(redis_con.exists("snapshot_missing"))
+
+    def test04_reject_unsafe_paths(self):
+        for path in ["/tmp/snapshot_test.snap", "../snapshot_test.snap",
+                     "snapshots/../../snapshot_test.snap", "..", ""]:
+            self.expect_error("SAVE", GRAPH_ID, path, "must be relative")
+            self.expect_error("LOAD", "snapshot_unsafe", path, "must be relative")
+        self.env.assertFalse(redis_con.exists("snapshot_unsafe"))
+
+        # '..' is only rejected as a path component.
+        self.env.assertEquals(self.snapshot("SAVE", GRAPH_ID, "snapshot..test.snap"), "OK")
+
+    def test05_load_refused_with_aof(self):
+        redis_con.config_set("appendonly", "yes")
+        try:
+            self.expect_error("LOAD", "snapshot_aof", SNAPSHOT_PATH, "AOF is enabled")
+            self.env.assertFalse(redis_con.exists("snapshot_aof"))
+        finally:
+            redis_con.config_set("appendonly", "no")
+
+        # SAVE doesn't modify the keyspace and is allowed.
+        self.env.assertEquals(self.snapshot("SAVE", GRAPH_ID, SNAPSHOT_PATH), "OK")
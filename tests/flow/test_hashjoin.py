@@ -3,6 +3,7 @@ from redisgraph import Graph, Node, Edge
 from base import FlowTestsBase
 
 GRAPH_ID = "G"
+BUILD_SIDE_GRAPH_ID = "hashjoin_build_side"
 
 class testHashJoin(FlowTestsBase):
     def __init__(self):
@@ -36,3 +37,37 @@ class testHashJoin(FlowTestsBase):
 
         self.env.assertEquals(actual_result.result_set, expected_result)
 
+
+
+    # Returns the expression whose records the Value Hash Join cached.
+    def _cached_exp(self, q):
+        redis_con = self.env.getConnection()
+        profile = redis_con.execute_command("GRAPH.PROFILE", BUILD_SIDE_GRAPH_ID, q)
+        join = [op for op in profile if "Value Hash Join" in op]
+        self.env.assertEquals(len(join), 1)
+        # Value Hash Join | lhs = rhs | Cached: exp | Records produced: ...
+        return join[0].split("|")[2].strip()
+
+    def test_build_side(self):
+        graph = Graph(BUILD_SIDE_GRAPH_ID, self.env.getConnection())
+        # 2 :A nodes and 20 :B nodes, :B nodes 1 and 2 have a self loop.
+        graph.query("UNWIND range(1, 2) AS x CREATE (:A {v: x})")
+        graph.query("UNWIND range(1, 20) AS x CREATE (:B {v: x})")
+        graph.query("MATCH (b:B) WHERE b.v <= 2 CREATE (b)-[:R]->(b)")
+
+        expected_result = [[1, 1], [2, 2]]
+
+        # Smaller side is the left hand side.
+        q = "MATCH (a:A), (b:B) WHERE a.v = b.v RETURN a.v, b.v ORDER BY a.v"
+        self.env.assertEquals(self._cached_exp(q), "Cached: a.v")
+        self.env.assertEquals(graph.query(q).result_set, expected_result)
+
+        # Smaller side is the right hand side.
+        q = "MATCH (b:B), (a:A) WHERE b.v = a.v RETURN a.v, b.v ORDER BY a.v"
+        self.env.assertEquals(self._cached_exp(q), "Cached: a.v")
+        self.env.assertEquals(graph.query(q).result_set, expected_result)
+
+        # Left hand side can't be estimated, it is cached.
+        q = "MATCH (b:B)-[:R]->(b), (a:A) WHERE b.v = a.v RETURN a.v, b.v ORDER BY a.v"
+        self.env.assertEquals(self._cached_exp(q), "Cached: b.v")
+        self.env.assertEquals(graph.query(q).result_set, expected_result)
@@ -0,0 +1,67 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "op_stats_test"
+NODE_COUNT = 100000
+QUERY = """MATCH (n:N) WHERE n.v % 2 = 0 RETURN n.v"""
+redis_con = None
+redis_graph = None
+
+class testOpStats(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+        redis_graph.query("UNWIND range(1, %d) AS x CREATE (:N {v: x})" % NODE_COUNT)
+
+        # Log every query, slowlog entries report peak memory.
+        redis_con.execute_command("GRAPH.CONFIG SET SLOWLOG_LOG_SLOWER_THAN 0")
+
+    def op_stats(self):
+        return redis_con.execute_command("GRAPH.INFO", GRAPH_ID, "OPSTATS")
+
+    def peak_memory(self):
+        slowlog = redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID)
+        return slowlog[0][7]
+
+    def test01_sample_every_query(self):
+        redis_con.execute_command("GRAPH.CONFIG SET OP_STATS_SAMPLE_RATE 100")
+        for i in range(3):
+            redis_graph.query(QUERY)
+
+        stats = self.op_stats()
+        self.env.assertEquals(len(stats), 1)
+        fingerprint, samples, ops = stats[0]
+        self.env.assertEquals(samples, 3)
+
+        # Operations are reported in plan order.
+        names = [op[0] for op in ops]
+        self.env.assertEquals(names, ["Results", "Project", "Filter", "Node By Label Scan"])
+        for op in ops:
+            # Records produced.
+            self.env.assertGreater(op[1], 0)
+            # Execution time.
+            self.env.assertGreater(float(op[5]), 0)
+
+        # Results produced half of the scanned nodes, in each execution.
+        self.env.assertEquals(ops[0][1], 3 * NODE_COUNT / 2)
+        self.env.assertEquals(ops[3][1], 3 * NODE_COUNT)
+
+        # Sampled executions track their allocations.
+        self.env.assertGreater(self.peak_memory(), 0)
+
+    def test02_disable_sampling(self):
+        redis_con.execute_command("GRAPH.CONFIG SET OP_STATS_SAMPLE_RATE 0")
+        before = self.op_stats()
+
+        # Neither a new query nor a previously sampled one are recorded.
+        redis_graph.query(QUERY)
+        redis_graph.query("""MATCH (n:N) WHERE n.v < 10 RETURN count(n)""")
+        self.env.assertEquals(self.op_stats(), before)
+
+        # Tracking allocator is uninstalled, peak memory is unknown.
+        self.env.assertEquals(self.peak_memory(), None)
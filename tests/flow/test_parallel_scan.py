@@ -0,0 +1,66 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "parallel_scan"
+
+# exceeds GATHER_MIN_SCAN_SIZE
+NODE_COUNT = 100000
+
+QUERIES = ["""MATCH (n:N) RETURN count(n), sum(n.v), min(n.v), max(n.v)""",
+           """MATCH (n:N) WHERE n.v % 7 = 0 RETURN n.v % 10 AS k, count(*) ORDER BY k""",
+           """MATCH (n:N) RETURN DISTINCT n.v % 100 AS k ORDER BY k""",
+           """MATCH (n:N) RETURN n.v ORDER BY n.v DESC LIMIT 10""",
+           """MATCH (n) WHERE n.v >= 99990 RETURN n.v ORDER BY n.v"""]
+
+class testParallelScanFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+
+    def populate_graph(self, graph):
+        graph.query("""UNWIND range(0, %d) AS x CREATE (:N {v: x})""" % (NODE_COUNT - 1))
+
+    def test01_parallel_matches_serial(self):
+        # parallel scans are disabled by default
+        graph = Graph(GRAPH_ID, self.env.getConnection())
+        self.populate_graph(graph)
+
+        serial = []
+        for q in QUERIES:
+            self.env.assertNotIn("Gather", graph.execution_plan(q))
+            serial.append(graph.query(q).result_set)
+
+        self.env.flush()
+        self.env.stop()
+
+        # instantiate a new server with a parallel scan pool
+        self.env = Env(decodeResponses=True, moduleArgs="PARALLEL_SCAN_THREAD_COUNT 4")
+        graph = Graph(GRAPH_ID, self.env.getConnection())
+        self.populate_graph(graph)
+
+        for q, expected in zip(QUERIES, serial):
+            self.env.assertIn("Gather", graph.execution_plan(q))
+            self.env.assertEquals(graph.query(q).result_set, expected)
+
+    def test02_parallel_scan_memory_capacity(self):
+        conn = self.env.getConnection()
+        graph = Graph(GRAPH_ID, conn)
+
+        # workers' allocations are charged to the query and released with it
+        # repeated queries don't accumulate memory consumption
+        conn.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 64 * 1024 * 1024)
+        for i in range(50):
+            result = graph.query(QUERIES[2])
+            self.env.assertEquals(len(result.result_set), 100)
+
+        # memory allocated by workers counts towards the query's capacity
+        conn.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 1024 * 1024)
+        query = """MATCH (n:N) RETURN DISTINCT n.v"""
+        self.env.assertIn("Gather", graph.execution_plan(query))
+        try:
+            graph.query(query)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Query's mem consumption exceeded capacity", str(e))
+
+        conn.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 0)
@@ -203,3 +203,28 @@ class testGraphPersistency(FlowTestsBase):
             actual_result = graph.query(q)
             self.env.assertEquals(actual_result.result_set, expected_result)
 
+
+    # Payloads of many entities are decoded concurrently,
+    # verify every property of every entity is restored.
+    def test05_large_payload_properties(self):
+        graph_name = "large_payload"
+        graph = Graph(graph_name, redis_con)
+        entity_count = 20000
+
+        query = """UNWIND range(0, %d) AS x
+                   CREATE (a:A {v: x, s: toString(x), arr: [x, toString(x), [x]], p: point({latitude: x / 1000.0, longitude: 1.5})})
+                   -[:R {v: x, d: x / 3.0, b: x %%2 = 0}]->
+                   (:B {v: x})""" % (entity_count - 1)
+        graph.query(query)
+
+        queries = ["""MATCH (a:A)-[e:R]->(b:B)
+                      RETURN a.v, a.s, a.arr, a.p, e.v, e.d, e.b, b.v
+                      ORDER BY a.v""",
+                   """MATCH (n) RETURN count(n)"""]
+        expected = [graph.query(q).result_set for q in queries]
+
+        # Save RDB & Load from RDB
+        redis_con.execute_command("DEBUG", "RELOAD")
+
+        actual = [graph.query(q).result_set for q in queries]
+        self.env.assertEquals(actual, expected)
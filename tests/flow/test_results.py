@@ -1,5 +1,6 @@
 import os
 import sys
+import redis
 from RLTest import Env
 from redisgraph import Graph, Node, Edge
 
@@ -196,3 +197,16 @@ class testResultSetFlow(FlowTestsBase):
         unlimited_record_count = len(result.result_set)
         assert(unlimited_record_count == record_count)
 
+
+    # Test a run-time error raised after records were buffered
+    def test10_error_after_records(self):
+        # the first 9000 records are valid, toUpper fails on the first integer
+        query = """UNWIND range(0, 9999) AS x
+                   RETURN toUpper(CASE WHEN x < 9000 THEN 'a' ELSE x END) AS v"""
+
+        # buffered records are discarded, the error is the only response
+        try:
+            redis_con.execute_command("GRAPH.RO_QUERY", "G", query)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("Type mismatch", str(e))
@@ -4,6 +4,7 @@ from redisgraph import Graph
 from base import FlowTestsBase
 
 GRAPH_ID = "slowlog_test"
+SLOWLOG_MAX_LEN = 128
 redis_con = None
 redis_graph = None
 
@@ -16,14 +17,20 @@ class testSlowLog(FlowTestsBase):
         redis_con = self.env.getConnection()
         redis_graph = Graph(GRAPH_ID, redis_con)
 
+        # Log every query.
+        redis_con.execute_command("GRAPH.CONFIG SET SLOWLOG_LOG_SLOWER_THAN 0")
+
     def test_slowlog(self):
         # Issue create query twice.
         redis_graph.query("""CREATE ()""")
         redis_graph.query("""CREATE ()""")
 
-        # Slow log should contain a single entry, no duplicates.
+        # Slow log should contain both executions.
         slowlog = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
-        self.env.assertEquals(len(slowlog), 1)
+        self.env.assertEquals(len(slowlog), 2)
+        self.env.assertEquals(slowlog[0][2], "CREATE ()")
+        # Entries share the query's fingerprint.
+        self.env.assertEquals(slowlog[0][4], slowlog[1][4])
 
         # Saturate slowlog.
         for i in range(1024):
@@ -32,12 +39,47 @@ class testSlowLog(FlowTestsBase):
         A = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
         B = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
 
+        # Slowlog keeps the most recent entries.
+        self.env.assertEquals(len(A), SLOWLOG_MAX_LEN)
+        self.env.assertEquals(A[0][2], "CREATE ({v:1023})")
+
         # Calling slowlog multiple times should preduce the same result.
         self.env.assertEquals(A, B)
 
-        # Issue a long running query, this should replace an existing entry in the slowlog.
+        # Issue a long running query, this should replace the oldest entry in the slowlog.
         q = """MATCH (n), (m) WHERE n.v > 0 AND n.v < 500 SET m.v = rand() WITH n, m RETURN SUM(n.v + m.v)"""
         redis_graph.query(q)
         B = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
 
         self.env.assertNotEqual(A, B)
+        self.env.assertEquals(len(B), SLOWLOG_MAX_LEN)
+        self.env.assertEquals(B[0][2], q)
+        self.env.assertEquals(B[1:], A[:-1])
+
+        # Rows produced by the query.
+        self.env.assertEquals(B[0][6], 1)
+
+    def test_slowlog_peak_memory(self):
+        # Peak memory is unknown while allocations aren't tracked.
+        q = """UNWIND range(0, 1000) AS x RETURN collect(x)"""
+        redis_graph.query(q)
+        slowlog = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
+        self.env.assertEquals(slowlog[0][7], None)
+
+        # Capping query memory tracks allocations.
+        redis_con.execute_command("GRAPH.CONFIG SET QUERY_MEM_CAPACITY 1073741824")
+        redis_graph.query(q)
+        slowlog = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
+        self.env.assertGreater(slowlog[0][7], 0)
+        redis_con.execute_command("GRAPH.CONFIG SET QUERY_MEM_CAPACITY 0")
+
+    def test_slowlog_threshold(self):
+        A = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
+
+        # Queries faster than threshold are not logged.
+        redis_con.execute_command("GRAPH.CONFIG SET SLOWLOG_LOG_SLOWER_THAN 10000000")
+        redis_graph.query("""MATCH (n) RETURN count(n)""")
+        B = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
+        self.env.assertEquals(A, B)
+
+        redis_con.execute_command("GRAPH.CONFIG SET SLOWLOG_LOG_SLOWER_THAN 0")
@@ -0,0 +1,136 @@
+from base import FlowTestsBase
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+GRAPH_ID = "v10_encode_decode"
+redis_con = None
+redis_graph = None
+
+# Every edge ordered by ID, incoming traversals read the transposed relations.
+EDGES_QUERY = """MATCH (a)-[e]->(b) RETURN id(a), id(e), e.v, id(b) ORDER BY id(e)"""
+INCOMING_QUERY = """MATCH (b)<-[e:R]-(a) RETURN id(b), id(e), id(a) ORDER BY id(b), id(e)"""
+NODES_QUERY = """MATCH (n) RETURN id(n), labels(n), n.v ORDER BY id(n)"""
+
+# A connection which does not decode replies, DUMP payloads are binary.
+def binary_connection(con):
+    kwargs = dict(con.connection_pool.connection_kwargs)
+    kwargs['decode_responses'] = False
+    return redis.Redis(**kwargs)
+
+class test_v10_encode_decode(FlowTestsBase):
+    def __init__(self):
+        # Small virtual keys, such that entities are spread over multiple keys.
+        self.env = Env(decodeResponses=True, moduleArgs='VKEY_MAX_ENTITY_COUNT 10')
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def populate_graph(self, graph):
+        # 10 sources and 10 destinations, every pair is connected by
+        # 3 edges of type R, such that each pair holds a multi-edge list.
+        graph.query("""UNWIND range(0, 9) AS x
+                       CREATE (s:Src {v: x}), (d:Dst {v: x})
+                       CREATE (s)-[:R {v: x}]->(d), (s)-[:R {v: x + 10}]->(d),
+                              (s)-[:R {v: x + 20}]->(d), (s)-[:S {v: x}]->(d)""")
+
+        # Shrink some multi-edge lists back to a single edge
+        # and drop others altogether, leaving holes in the store.
+        graph.query("""MATCH (:Src)-[e:R]->(:Dst) WHERE e.v >= 10 AND e.v < 13 DELETE e""")
+        graph.query("""MATCH (:Src)-[e:R]->(:Dst) WHERE e.v >= 23 AND e.v < 26 DELETE e""")
+        graph.query("""MATCH (s:Src)-[e:R]->(:Dst) WHERE s.v = 9 DELETE e""")
+
+        # Delete nodes, detaching their edges.
+        graph.query("""MATCH (n:Src) WHERE n.v IN [4, 7] DETACH DELETE n""")
+        graph.query("""MATCH (n:Dst) WHERE n.v = 5 DETACH DELETE n""")
+
+    def snapshot(self, graph):
+        return [graph.query(q).result_set for q in [NODES_QUERY, EDGES_QUERY, INCOMING_QUERY]]
+
+    def test01_multi_edges_and_deletions(self):
+        self.populate_graph(redis_graph)
+        expected = self.snapshot(redis_graph)
+
+        # Save RDB & Load from RDB
+        redis_con.execute_command("DEBUG", "RELOAD")
+        self.env.assertEquals(self.snapshot(redis_graph), expected)
+
+        # Multi-edge lists remain mutable after load.
+        redis_graph.query("""MATCH (s:Src {v: 0}), (d:Dst {v: 0})
+                             CREATE (s)-[:R {v: 100}]->(d)""")
+        redis_graph.query("""MATCH (s:Src {v: 1})-[e:R {v: 1}]->(:Dst) DELETE e""")
+        result = redis_graph.query("""MATCH (:Src {v: 0})-[e:R]->(:Dst {v: 0})
+                                      RETURN e.v ORDER BY e.v""")
+        self.env.assertEquals(result.result_set, [[0], [20], [100]])
+        result = redis_graph.query("""MATCH (:Src {v: 1})-[e:R]->(:Dst {v: 1})
+                                      RETURN e.v ORDER BY e.v""")
+        self.env.assertEquals(result.result_set, [[11], [21]])
+
+        expected = self.snapshot(redis_graph)
+        redis_con.execute_command("DEBUG", "RELOAD")
+        self.env.assertEquals(self.snapshot(redis_graph), expected)
+
+    def test02_id_reuse(self):
+        # Deleted IDs are persisted and handed out again after load.
+        node_ids = redis_graph.query("""MATCH (n) RETURN collect(id(n))""").result_set[0][0]
+        edge_ids = redis_graph.query("""MATCH ()-[e]->() RETURN collect(id(e))""").result_set[0][0]
+        max_node_id = max(node_ids)
+        max_edge_id = max(edge_ids)
+        deleted_nodes = set(range(max_node_id + 1)) - set(node_ids)
+        deleted_edges = set(range(max_edge_id + 1)) - set(edge_ids)
+        self.env.assertGreater(len(deleted_nodes), 0)
+        self.env.assertGreater(len(deleted_edges), 0)
+
+        redis_con.execute_command("DEBUG", "RELOAD")
+
+        query = """UNWIND range(1, %d) AS x CREATE (a:New)-[e:N]->(b:New)
+                   RETURN id(a), id(e), id(b)"""
+        # Enough new entities to exhaust the deleted IDs.
+        result = redis_graph.query(query % 100).result_set
+        new_nodes = set([r[0] for r in result] + [r[2] for r in result])
+        new_edges = set([r[1] for r in result])
+        self.env.assertTrue(deleted_nodes.issubset(new_nodes))
+        self.env.assertTrue(deleted_edges.issubset(new_edges))
+
+        expected = self.snapshot(redis_graph)
+        redis_con.execute_command("DEBUG", "RELOAD")
+        self.env.assertEquals(self.snapshot(redis_graph), expected)
+
+    def test03_toggle_transpose(self):
+        # Transposed relation matrices are saved only when maintained,
+        # a graph saved under one configuration loads under the other.
+        self.env.flush()
+        self.env.stop()
+
+        default_env = Env(decodeResponses=True)
+        con = default_env.getConnection()
+        graph = Graph(GRAPH_ID, con)
+        self.populate_graph(graph)
+        expected = self.snapshot(graph)
+        payload = binary_connection(con).dump(GRAPH_ID)
+        default_env.flush()
+        default_env.stop()
+
+        # Saved with transposed matrices, loaded without.
+        configured_env = Env(decodeResponses=True, moduleArgs="MAINTAIN_TRANSPOSED_MATRICES no")
+        con = configured_env.getConnection()
+        binary_connection(con).restore(GRAPH_ID, 0, payload)
+        graph = Graph(GRAPH_ID, con)
+        configured_env.assertEquals(self.snapshot(graph), expected)
+        con.execute_command("DEBUG", "RELOAD")
+        configured_env.assertEquals(self.snapshot(graph), expected)
+        payload = binary_connection(con).dump(GRAPH_ID)
+        configured_env.flush()
+        configured_env.stop()
+
+        # Saved without transposed matrices, loaded with.
+        default_env = Env(decodeResponses=True)
+        con = default_env.getConnection()
+        binary_connection(con).restore(GRAPH_ID, 0, payload)
+        graph = Graph(GRAPH_ID, con)
+        default_env.assertEquals(self.snapshot(graph), expected)
+        con.execute_command("DEBUG", "RELOAD")
+        default_env.assertEquals(self.snapshot(graph), expected)
+        default_env.flush()
+        default_env.stop()
@@ -102,3 +102,126 @@ TEST_F(CacheTest, ExecutionPlanCache) {
 	ASSERT_EQ(free_count, 9);
 }
 
+
+TEST_F(CacheTest, AliasAndStats) {
+	free_count = 0;
+	// large enough to be sharded
+	Cache *cache = Cache_New(32, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+	ASSERT_GT(cache->shard_count, 1);
+
+	const char *key = "MATCH (a) RETURN a";
+	const char *alias = "MATCH (a)  RETURN a";
+	Cache_SetValue(cache, key, CacheObj_New("1"));
+
+	// aliasing a missing key is a no-op
+	Cache_SetAlias(cache, "None existing", alias);
+	ASSERT_TRUE(Cache_GetValue(cache, alias) == NULL);
+
+	// alias resolves to the value cached under key
+	Cache_SetAlias(cache, key, alias);
+	CacheObj *from_cache = (CacheObj *)Cache_GetValue(cache, alias);
+	ASSERT_STREQ(from_cache->str, "1");
+	CacheObj_Free(from_cache);
+
+	Cache_CountMiss(cache);
+	Cache_CountHit(cache, 1.5);
+	Cache_CountHit(cache, 0.5);
+
+	CacheStats stats;
+	Cache_GetStats(cache, &stats);
+	ASSERT_EQ(stats.hits, 2);
+	ASSERT_EQ(stats.misses, 1);
+	ASSERT_EQ(stats.evictions, 0);
+	ASSERT_EQ(stats.saved_us, 2000);
+
+	// shared value is freed once
+	Cache_Free(cache);
+	ASSERT_EQ(free_count, 2);
+}
+
+TEST_F(CacheTest, AliasCapacity) {
+	free_count = 0;
+	Cache *cache = Cache_New(1, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	const char *key1 = "MATCH (a) RETURN a";
+	const char *key2 = "MATCH (b) RETURN b";
+	const char *alias = "MATCH (a)  RETURN a";
+	Cache_SetValue(cache, key1, CacheObj_New("1"));
+
+	// aliases do not take up cache capacity
+	Cache_SetAlias(cache, key1, alias);
+	CacheObj *from_cache = (CacheObj *)Cache_GetValue(cache, key1);
+	ASSERT_STREQ(from_cache->str, "1");
+	CacheObj_Free(from_cache);
+
+	CacheStats stats;
+	Cache_GetStats(cache, &stats);
+	ASSERT_EQ(stats.evictions, 0);
+
+	// evicting key evicts a single value, its alias no longer resolves
+	Cache_SetValue(cache, key2, CacheObj_New("2"));
+	Cache_GetStats(cache, &stats);
+	ASSERT_EQ(stats.evictions, 1);
+	ASSERT_TRUE(Cache_GetValue(cache, alias) == NULL);
+
+	// alias is re-pointed at a new key
+	Cache_SetAlias(cache, key2, alias);
+	from_cache = (CacheObj *)Cache_GetValue(cache, alias);
+	ASSERT_STREQ(from_cache->str, "2");
+	CacheObj_Free(from_cache);
+
+	Cache_Free(cache);
+	ASSERT_EQ(free_count, 4);
+}
+
+TEST_F(CacheTest, Recycle) {
+	free_count = 0;
+	Cache *cache = Cache_New(1, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	const char *key1 = "MATCH (a) RETURN a";
+	const char *key2 = "MATCH (b) RETURN b";
+	const char *alias = "MATCH (a)  RETURN a";
+	Cache_SetValue(cache, key1, CacheObj_New("1"));
+	Cache_SetAlias(cache, key1, alias);
+
+	// nothing recycled yet
+	ASSERT_TRUE(Cache_GetRecycledValue(cache, key1, 1) == NULL);
+
+	// a recycled copy is handed out as is, once, and only under its tag
+	CacheObj *copy = (CacheObj *)Cache_GetValue(cache, key1);
+	Cache_Recycle(cache, key1, 1, copy);
+	ASSERT_TRUE(Cache_GetRecycledValue(cache, key1, 2) == NULL);
+	ASSERT_EQ(Cache_GetRecycledValue(cache, alias, 1), copy);
+	ASSERT_TRUE(Cache_GetRecycledValue(cache, key1, 1) == NULL);
+
+	// once full, the oldest copy is freed
+	CacheObj *copies[CACHE_RECYCLED_CAP + 1];
+	copies[0] = copy;
+	for(int i = 1; i < CACHE_RECYCLED_CAP + 1; i++) {
+		copies[i] = (CacheObj *)Cache_GetValue(cache, key1);
+	}
+	for(int i = 0; i < CACHE_RECYCLED_CAP + 1; i++) {
+		Cache_Recycle(cache, key1, 1, copies[i]);
+	}
+	ASSERT_EQ(free_count, 1);
+
+	// newest copy is handed out first
+	copy = (CacheObj *)Cache_GetRecycledValue(cache, key1, 1);
+	ASSERT_EQ(copy, copies[CACHE_RECYCLED_CAP]);
+
+	// evicting key frees its value along with the remaining copies
+	Cache_SetValue(cache, key2, CacheObj_New("2"));
+	ASSERT_EQ(free_count, CACHE_RECYCLED_CAP + 1);
+
+	// recycling a copy of an evicted value frees it
+	Cache_Recycle(cache, key1, 1, copy);
+	ASSERT_EQ(free_count, CACHE_RECYCLED_CAP + 2);
+
+	// copies are freed along with the cache
+	Cache_Recycle(cache, key2, 1, Cache_GetValue(cache, key2));
+	Cache_Free(cache);
+	ASSERT_EQ(free_count, CACHE_RECYCLED_CAP + 4);
+}
@@ -0,0 +1,286 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/arr.h"
+#include "../../src/query_ctx.h"
+#include "../../src/graph/graph.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/graphcontext.h"
+#include "../../src/index/composite_index.h"
+#include <math.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+class CompositeIndexTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+		ASSERT_EQ(GrB_init(GrB_NONBLOCKING), GrB_SUCCESS);
+		GxB_Global_Option_set(GxB_FORMAT, GxB_BY_ROW); // all matrices in CSR format
+		GxB_Global_Option_set(GxB_HYPER_SWITCH, GxB_NEVER_HYPER); // matrices are never hypersparse
+
+		_fake_graph_context();
+	}
+
+	static void TearDownTestCase() {
+		GrB_finalize();
+	}
+
+	static void _fake_graph_context() {
+		GraphContext *gc = (GraphContext *)malloc(sizeof(GraphContext));
+
+		gc->g = Graph_New(16, 16);
+		gc->index_count = 0;
+		gc->graph_name = strdup("G");
+		gc->attributes = raxNew();
+		pthread_rwlock_init(&gc->_attribute_rwlock, NULL);
+		gc->string_mapping = (char **)array_new(char *, 64);
+		gc->node_schemas = (Schema **)array_new(Schema *, GRAPH_DEFAULT_LABEL_CAP);
+		gc->relation_schemas = (Schema **)array_new(Schema *, GRAPH_DEFAULT_RELATION_TYPE_CAP);
+
+		Graph_AcquireWriteLock(gc->g);
+		Graph_AddLabel(gc->g);
+		Graph_ReleaseLock(gc->g);
+		GraphContext_AddSchema(gc, "User", SCHEMA_NODE);
+
+		ASSERT_TRUE(QueryCtx_Init());
+		QueryCtx_SetGraphCtx(gc);
+	}
+};
+
+// count scan matches, validating the scan is exact and resettable
+static uint64_t _ScanCount(const CompositeIndex *idx, const SIValue *eq,
+		uint eq_count, const SIValue *min, bool include_min,
+		const SIValue *max, bool include_max) {
+	NodeID id;
+	bool supported;
+	uint64_t count = 0;
+	uint64_t recount = 0;
+
+	CompositeIndexIter *it = CompositeIndex_Scan(idx, eq, eq_count, min,
+			include_min, max, include_max, &supported);
+	EXPECT_TRUE(supported);
+
+	while(CompositeIndexIter_Next(it, &id, NULL)) count++;
+	CompositeIndexIter_Reset(it);
+	while(CompositeIndexIter_Next(it, &id, NULL)) recount++;
+	EXPECT_EQ(count, recount);
+
+	CompositeIndexIter_Free(it);
+	return count;
+}
+
+static uint64_t _PrefixCount(const CompositeIndex *idx, const SIValue *eq,
+		uint eq_count) {
+	return _ScanCount(idx, eq, eq_count, NULL, false, NULL, false);
+}
+
+TEST_F(CompositeIndexTest, PrefixAndRange) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Graph *g = gc->g;
+	Attribute_ID country = GraphContext_FindOrAddAttribute(gc, "country");
+	Attribute_ID age = GraphContext_FindOrAddAttribute(gc, "age");
+	Attribute_ID name = GraphContext_FindOrAddAttribute(gc, "name");
+	Attribute_ID email = GraphContext_FindOrAddAttribute(gc, "email");
+	const char *countries[3] = {"DE", "FR", "US"};
+
+	// create 300 users: (country: DE / FR / US, age: 0..99, name, email)
+	// the last user of every country is missing its age
+	Graph_AcquireWriteLock(g);
+	for(int i = 0; i < 300; i++) {
+		Node n = GE_NEW_NODE();
+		Graph_CreateNode(g, 0, &n);
+		GraphEntity_AddProperty((GraphEntity *)&n, country,
+				SI_ConstStringVal((char *)countries[i / 100]));
+		if(i % 100 != 99) {
+			GraphEntity_AddProperty((GraphEntity *)&n, age, SI_LongVal(i % 100));
+		}
+		GraphEntity_AddProperty((GraphEntity *)&n, name, SI_LongVal(i));
+		GraphEntity_AddProperty((GraphEntity *)&n, email, SI_LongVal(i));
+	}
+	Graph_ReleaseLock(g);
+
+	const char *fields[2] = {"country", "age"};
+	const char *included[2] = {"name", "age"};
+	CompositeIndex *idx = CompositeIndex_New("User", fields, 2, included, 2);
+	ASSERT_EQ(idx->fields_count, 2);
+	// age is already a key field
+	ASSERT_EQ(idx->included_count, 1);
+	ASSERT_TRUE(CompositeIndex_HasFields(idx, fields, 2));
+	ASSERT_FALSE(CompositeIndex_HasFields(idx, fields, 1));
+	ASSERT_EQ(CompositeIndex_FieldPosition(idx, age), 1);
+	ASSERT_EQ(CompositeIndex_FieldPosition(idx, name), -1);
+	ASSERT_TRUE(CompositeIndex_Covers(idx, name));
+	ASSERT_FALSE(CompositeIndex_Covers(idx, email));
+
+	CompositeIndex_Construct(idx);
+	ASSERT_EQ(CompositeIndex_Count(idx), 300);
+
+	SIValue de[2] = {SI_ConstStringVal((char *)"DE"), SI_LongVal(10)};
+	SIValue lo = SI_LongVal(10);
+	SIValue hi = SI_DoubleVal(20);
+	SIValue fr = SI_ConstStringVal((char *)"FR");
+
+	// no constraints, all users
+	ASSERT_EQ(_PrefixCount(idx, NULL, 0), 300);
+
+	// country = 'DE'
+	ASSERT_EQ(_PrefixCount(idx, de, 1), 100);
+
+	// country = 'DE' AND age = 10
+	ASSERT_EQ(_PrefixCount(idx, de, 2), 1);
+
+	// country = 'DE' AND age = 10.0
+	SIValue de_double[2] = {de[0], SI_DoubleVal(10)};
+	ASSERT_EQ(_PrefixCount(idx, de_double, 2), 1);
+
+	// country = 'DE' AND age = '10'
+	SIValue de_string[2] = {de[0], SI_ConstStringVal((char *)"10")};
+	ASSERT_EQ(_PrefixCount(idx, de_string, 2), 0);
+
+	// country = 'DE' AND 10 <= age <= 20
+	ASSERT_EQ(_ScanCount(idx, de, 1, &lo, true, &hi, true), 11);
+	ASSERT_EQ(_ScanCount(idx, de, 1, &lo, false, &hi, true), 10);
+	ASSERT_EQ(_ScanCount(idx, de, 1, &lo, false, &hi, false), 9);
+
+	// country = 'DE' AND age > 10, users missing age aren't included
+	ASSERT_EQ(_ScanCount(idx, de, 1, &lo, false, NULL, false), 88);
+
+	// country = 'DE' AND age < 10
+	ASSERT_EQ(_ScanCount(idx, de, 1, NULL, false, &lo, false), 10);
+
+	// country >= 'FR'
+	ASSERT_EQ(_ScanCount(idx, NULL, 0, &fr, true, NULL, false), 200);
+	ASSERT_EQ(_ScanCount(idx, NULL, 0, &fr, false, NULL, false), 100);
+
+	// country < 'FR'
+	ASSERT_EQ(_ScanCount(idx, NULL, 0, NULL, false, &fr, false), 100);
+
+	// nothing equals or compares to NULL and NaN
+	SIValue de_null[2] = {de[0], SI_NullVal()};
+	SIValue de_nan[2] = {de[0], SI_DoubleVal(NAN)};
+	ASSERT_EQ(_PrefixCount(idx, de_null, 2), 0);
+	ASSERT_EQ(_PrefixCount(idx, de_nan, 2), 0);
+	ASSERT_EQ(_ScanCount(idx, de, 1, &lo, true, de_null + 1, true), 0);
+
+	// values of different kinds aren't comparable
+	ASSERT_EQ(_ScanCount(idx, de, 1, &lo, true, &fr, true), 0);
+
+	// covered properties are read from the index
+	NodeID id;
+	Entity *covered;
+	bool supported;
+	CompositeIndexIter *it = CompositeIndex_Scan(idx, de, 2, NULL, false,
+			NULL, false, &supported);
+	ASSERT_TRUE(CompositeIndexIter_Next(it, &id, &covered));
+	ASSERT_EQ(id, 10);
+
+	GraphEntity ge = {.entity = covered, .id = id};
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, age)->longval, 10);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, name)->longval, 10);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, email), PROPERTY_NOTFOUND);
+	ASSERT_FALSE(CompositeIndexIter_Next(it, &id, NULL));
+	CompositeIndexIter_Free(it);
+
+	// updated nodes are reindexed, age 10 -> 50
+	Node n = GE_NEW_NODE();
+	Graph_GetNode(g, 10, &n);
+	GraphEntity_SetProperty((GraphEntity *)&n, age, SI_LongVal(50));
+	CompositeIndex_IndexNode(idx, &n);
+	ASSERT_EQ(CompositeIndex_Count(idx), 300);
+	ASSERT_EQ(_PrefixCount(idx, de, 2), 0);
+	ASSERT_EQ(_ScanCount(idx, de, 1, &lo, true, &hi, true), 10);
+
+	// removed nodes are no longer matched
+	CompositeIndex_RemoveNode(idx, &n);
+	ASSERT_EQ(CompositeIndex_Count(idx), 299);
+	ASSERT_EQ(_PrefixCount(idx, de, 1), 99);
+
+	CompositeIndex_Free(idx);
+}
+
+TEST_F(CompositeIndexTest, UnsupportedValues) {
+	const char *fields[2] = {"country", "age"};
+	CompositeIndex *idx = CompositeIndex_New("User", fields, 2, NULL, 0);
+	CompositeIndex_Construct(idx);
+
+	NodeID id;
+	bool supported;
+	uint64_t count = 0;
+
+	// arrays can't be looked up, scan is widened to country = 'DE'
+	SIValue eq[2] = {SI_ConstStringVal((char *)"DE"), SI_Array(1)};
+	CompositeIndexIter *it = CompositeIndex_Scan(idx, eq, 2, NULL, false,
+			NULL, false, &supported);
+	ASSERT_FALSE(supported);
+	while(CompositeIndexIter_Next(it, &id, NULL)) count++;
+	ASSERT_EQ(count, 100);
+
+	CompositeIndexIter_Free(it);
+	SIValue_Free(eq[1]);
+	CompositeIndex_Free(idx);
+}
+
+TEST_F(CompositeIndexTest, StringOrder) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Attribute_ID a = GraphContext_FindOrAddAttribute(gc, "a");
+	Attribute_ID b = GraphContext_FindOrAddAttribute(gc, "b");
+
+	// strings prefixing one another and holding escaped bytes
+	const char *values[6] = {"", "\x01", "\x01\x01", "a", "a\x01", "ab"};
+
+	const char *fields[2] = {"a", "b"};
+	CompositeIndex *idx = CompositeIndex_New("User", fields, 2, NULL, 0);
+
+	Entity entities[6];
+	for(int i = 0; i < 6; i++) {
+		entities[i].prop_count = 0;
+		entities[i].properties = NULL;
+
+		Node n = GE_NEW_NODE();
+		n.entity = entities + i;
+		n.id = 1000 + i;
+		GraphEntity_AddProperty((GraphEntity *)&n, a,
+				SI_ConstStringVal((char *)values[i]));
+		GraphEntity_AddProperty((GraphEntity *)&n, b, SI_BoolVal(i % 2));
+		CompositeIndex_IndexNode(idx, &n);
+	}
+
+	for(int i = 0; i < 6; i++) {
+		SIValue v = SI_ConstStringVal((char *)values[i]);
+		// a = v
+		ASSERT_EQ(_PrefixCount(idx, &v, 1), 1);
+		// a < v
+		ASSERT_EQ(_ScanCount(idx, NULL, 0, NULL, false, &v, false), i);
+		// a <= v
+		ASSERT_EQ(_ScanCount(idx, NULL, 0, NULL, false, &v, true), i + 1);
+		// a > v
+		ASSERT_EQ(_ScanCount(idx, NULL, 0, &v, false, NULL, false), 5 - i);
+	}
+
+	// a = 'a' AND b = true
+	SIValue eq[2] = {SI_ConstStringVal((char *)"a"), SI_BoolVal(true)};
+	ASSERT_EQ(_PrefixCount(idx, eq, 2), 1);
+	eq[1] = SI_BoolVal(false);
+	ASSERT_EQ(_PrefixCount(idx, eq, 2), 0);
+
+	// booleans aren't numbers
+	eq[1] = SI_LongVal(1);
+	ASSERT_EQ(_PrefixCount(idx, eq, 2), 0);
+
+	CompositeIndex_Free(idx);
+	for(int i = 0; i < 6; i++) FreeEntity(entities + i);
+}
+
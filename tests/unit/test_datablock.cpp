@@ -138,6 +138,48 @@ TEST_F(DataBlockTest, Scan) {
 	DataBlockIterator_Free(it);
 }
 
+TEST_F(DataBlockTest, ScanRange) {
+	DataBlock *dataBlock = DataBlock_New(1024, sizeof(int), NULL);
+	size_t itemCount = DATABLOCK_BLOCK_CAP * 2 + 10;
+	DataBlock_Accommodate(dataBlock, itemCount);
+
+	// Set items.
+	for(int i = 0 ; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// Scan a range crossing a block boundary.
+	int *item = NULL;
+	uint64_t idx = 0;
+	uint64_t start = DATABLOCK_BLOCK_CAP - 5;
+	uint64_t end = DATABLOCK_BLOCK_CAP + 5;
+	uint64_t expected = start;
+
+	DataBlockIterator *it = DataBlock_ScanRange(dataBlock, start, end);
+	while((item = (int *)DataBlockIterator_Next(it, &idx))) {
+		ASSERT_EQ(idx, expected);
+		ASSERT_EQ(*item, expected);
+		expected++;
+	}
+	ASSERT_EQ(expected, end);
+	DataBlockIterator_Free(it);
+
+	// Range end is clamped to the number of items.
+	expected = DATABLOCK_BLOCK_CAP * 2;
+	it = DataBlock_ScanRange(dataBlock, expected, UINT64_MAX);
+	while((item = (int *)DataBlockIterator_Next(it, &idx))) expected++;
+	ASSERT_EQ(expected, itemCount);
+	DataBlockIterator_Free(it);
+
+	// Range beyond the last item is empty.
+	it = DataBlock_ScanRange(dataBlock, itemCount + 1, itemCount + 100);
+	ASSERT_TRUE(DataBlockIterator_Next(it, NULL) == NULL);
+	DataBlockIterator_Free(it);
+
+	DataBlock_Free(dataBlock);
+}
+
 TEST_F(DataBlockTest, RemoveItem) {
 	DataBlock *dataBlock = DataBlock_New(1024, sizeof(int), NULL);
 	uint itemCount = 32;
@@ -0,0 +1,125 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/thpool/pools.h"
+#include "../../src/serializers/entity_staging.h"
+#include "../../src/graph/entities/property_columns.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#define BULK_COUNT   1
+#define READER_COUNT 1
+#define WRITER_COUNT 1
+#define TASK_COUNT   3
+
+class EntityStagingTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+		ThreadPools_CreatePools(READER_COUNT, WRITER_COUNT, BULK_COUNT, UINT64_MAX);
+		ThreadPools_CreateTaskPool(TASK_COUNT);
+	}
+};
+
+// stage 'n' plain entities and 'n' columnar entities split between two
+// property columns, each entity is staged with two properties
+static void _StageAndFlush(uint64_t n) {
+	Entity *plain = (Entity *)rm_calloc(n, sizeof(Entity));
+	Entity *columnar = (Entity *)rm_calloc(n, sizeof(Entity));
+	PropertyColumns *columns[2] = {PropertyColumns_New(), PropertyColumns_New()};
+
+	EntityStaging *staging = EntityStaging_New(n);
+	for(uint64_t i = 0; i < n; i++) {
+		GraphEntity e = {.entity = plain + i, .id = i};
+		EntityStaging_AddEntity(staging, &e, 0);
+		EntityStaging_AddProperty(staging, 0, SI_LongVal(i));
+		EntityStaging_AddProperty(staging, 1, SI_DuplicateStringVal("plain"));
+
+		uint label = i % 2;
+		columnar[i].prop_count = ENTITY_COLUMNAR;
+		columnar[i].columns = columns[label];
+		e = {.entity = columnar + i, .id = i};
+		EntityStaging_AddEntity(staging, &e, label);
+		EntityStaging_AddProperty(staging, 0, SI_LongVal(i));
+		EntityStaging_AddProperty(staging, 1, SI_DuplicateStringVal("columnar"));
+	}
+	EntityStaging_Flush(staging);
+
+	for(uint64_t i = 0; i < n; i++) {
+		GraphEntity e = {.entity = plain + i, .id = i};
+		ASSERT_EQ(plain[i].prop_count, 2);
+		ASSERT_EQ(GraphEntity_GetProperty(&e, 0)->longval, i);
+		ASSERT_STREQ(GraphEntity_GetProperty(&e, 1)->stringval, "plain");
+
+		e = {.entity = columnar + i, .id = i};
+		ASSERT_EQ(GraphEntity_GetProperty(&e, 0)->longval, i);
+		ASSERT_STREQ(GraphEntity_GetProperty(&e, 1)->stringval, "columnar");
+		ASSERT_EQ(PropertyColumns_RowPropertyCount(columns[i % 2], i), 2);
+	}
+
+	EntityStaging_Free(staging);
+	for(uint64_t i = 0; i < n; i++) FreeEntity(plain + i);
+	PropertyColumns_Free(columns[0]);
+	PropertyColumns_Free(columns[1]);
+	rm_free(plain);
+	rm_free(columnar);
+}
+
+TEST_F(EntityStagingTest, FlushInline) {
+	// too few properties to involve the task pool
+	_StageAndFlush(16);
+}
+
+TEST_F(EntityStagingTest, FlushConcurrently) {
+	_StageAndFlush(ENTITY_STAGING_PARALLEL_MIN);
+}
+
+TEST_F(EntityStagingTest, FreeUnflushed) {
+	Entity en = {0};
+	GraphEntity e = {.entity = &en, .id = 0};
+
+	// staged values are released along with the staging
+	EntityStaging *staging = EntityStaging_New(1);
+	EntityStaging_AddEntity(staging, &e, 0);
+	EntityStaging_AddProperty(staging, 0, SI_DuplicateStringVal("value"));
+	EntityStaging_Free(staging);
+
+	ASSERT_EQ(en.prop_count, 0);
+}
+
+TEST_F(EntityStagingTest, FlushDuplicatesReferredValues) {
+	Entity en = {0};
+	GraphEntity e = {.entity = &en, .id = 0};
+	char buffer[] = "referred";
+
+	// values referring to a buffer are duplicated, owned values are moved
+	EntityStaging *staging = EntityStaging_New(1);
+	EntityStaging_AddEntity(staging, &e, 0);
+	EntityStaging_AddProperty(staging, 0, SI_ConstStringVal(buffer));
+	EntityStaging_AddProperty(staging, 1, SI_DuplicateStringVal("owned"));
+	EntityStaging_Flush(staging);
+	EntityStaging_Free(staging);
+
+	buffer[0] = 'R';
+	ASSERT_EQ(en.prop_count, 2);
+	ASSERT_STREQ(GraphEntity_GetProperty(&e, 0)->stringval, "referred");
+	ASSERT_EQ(GraphEntity_GetProperty(&e, 0)->allocation, M_SELF);
+	ASSERT_STREQ(GraphEntity_GetProperty(&e, 1)->stringval, "owned");
+	ASSERT_EQ(GraphEntity_GetProperty(&e, 1)->allocation, M_SELF);
+
+	FreeEntity(&en);
+}
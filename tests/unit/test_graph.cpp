@@ -976,6 +976,13 @@ TEST_F(GraphTest, GraphStatistics) {
 	// 9. Verify r0 multi edge (True)
 	ASSERT_TRUE(Graph_RelationshipContainsMultiEdge(g, r0, transpose));
 
+	// Validate degrees.
+	ASSERT_EQ(Graph_GetNodeDegree(g, 0, GRAPH_EDGE_DIR_OUTGOING, r0), 2);
+	ASSERT_EQ(Graph_GetNodeDegree(g, 1, GRAPH_EDGE_DIR_INCOMING, r0), 2);
+	ASSERT_EQ(Graph_GetNodeDegree(g, 2, GRAPH_EDGE_DIR_OUTGOING, r1), 2);
+	ASSERT_EQ(Graph_GetNodeDegree(g, 1, GRAPH_EDGE_DIR_INCOMING, GRAPH_NO_RELATION), 5);
+	ASSERT_EQ(Graph_RelationMaxDegree(g, r1, GRAPH_EDGE_DIR_INCOMING), 3);
+
 	Graph_ReleaseLock(g);
 	/* Delete edges:
 	 * Implicit deleted edges:
@@ -998,6 +1005,129 @@ TEST_F(GraphTest, GraphStatistics) {
 	ASSERT_EQ(node_deleted, 1);
 	ASSERT_EQ(edge_deleted, 2);
 
+	// Validate degrees are updated by deletions.
+	ASSERT_EQ(Graph_GetNodeDegree(g, 0, GRAPH_EDGE_DIR_OUTGOING, r0), 1);
+	ASSERT_EQ(Graph_GetNodeDegree(g, 2, GRAPH_EDGE_DIR_OUTGOING, r1), 0);
+	ASSERT_EQ(Graph_GetNodeDegree(g, 0, GRAPH_EDGE_DIR_OUTGOING, GRAPH_NO_RELATION), 2);
+	ASSERT_EQ(Graph_GetNodeDegree(g, 1, GRAPH_EDGE_DIR_BOTH, GRAPH_NO_RELATION), 3);
+	ASSERT_EQ(Graph_GetNodeDegree(g, 1, GRAPH_EDGE_DIR_BOTH, GRAPH_UNKNOWN_RELATION), 0);
+	ASSERT_EQ(Graph_RelationAvgDegree(g, r1, GRAPH_EDGE_DIR_OUTGOING), 1);
+
 	// Clean up.
 	Graph_Free(g);
 }
+
+TEST_F(GraphTest, RecountDegrees) {
+	Node n;
+	Edge e[6];
+	int node_count = 4;
+	Graph *g = Graph_New(16, 16);
+
+	Graph_AcquireWriteLock(g);
+
+	int l = Graph_AddLabel(g);
+	int r = Graph_AddRelationType(g);
+	for(int i = 0; i < node_count; i++) Graph_CreateNode(g, l, &n);
+
+	/* multi-edge cells:
+	 * (0)-[r]->(1) X 3
+	 * (1)-[r]->(2) X 2
+	 * (2)-[r]->(3) */
+	NodeID src[6]   =  {0, 0, 0, 1, 1, 2};
+	NodeID dest[6]  =  {1, 1, 1, 2, 2, 3};
+	for(int i = 0; i < 6; i++) Graph_ConnectNodes(g, src[i], dest[i], r, e + i);
+	ASSERT_TRUE(Graph_RelationshipContainsMultiEdge(g, r, false));
+
+	// recount degrees from the relation matrix, as done when loading a graph
+	Graph_RecountDegrees(g);
+
+	uint64_t out_degree[4] = {3, 2, 1, 0};
+	uint64_t in_degree[4]  = {0, 3, 2, 1};
+	for(int i = 0; i < node_count; i++) {
+		ASSERT_EQ(Graph_GetNodeDegree(g, i, GRAPH_EDGE_DIR_OUTGOING, r), out_degree[i]);
+		ASSERT_EQ(Graph_GetNodeDegree(g, i, GRAPH_EDGE_DIR_INCOMING, r), in_degree[i]);
+	}
+	ASSERT_EQ(Graph_RelationMaxDegree(g, r, GRAPH_EDGE_DIR_OUTGOING), 3);
+	ASSERT_EQ(Graph_RelationMaxDegree(g, r, GRAPH_EDGE_DIR_INCOMING), 3);
+
+	Graph_ReleaseLock(g);
+
+	// deleting a multi-edge after a recount decrements by a single edge
+	uint node_deleted = 0;
+	uint edge_deleted = 0;
+	Graph_AcquireWriteLock(g);
+	Graph_BulkDelete(g, NULL, 0, e, 1, &node_deleted, &edge_deleted);
+	Graph_ReleaseLock(g);
+
+	ASSERT_EQ(edge_deleted, 1);
+	ASSERT_EQ(Graph_GetNodeDegree(g, 0, GRAPH_EDGE_DIR_OUTGOING, r), 2);
+	ASSERT_EQ(Graph_GetNodeDegree(g, 1, GRAPH_EDGE_DIR_INCOMING, r), 2);
+
+	Graph_Free(g);
+}
+
+TEST_F(GraphTest, BulkConnect) {
+	Node n;
+	Edge e;
+	int node_count = 4;
+	Graph *g = Graph_New(16, 16);
+
+	Graph_AcquireWriteLock(g);
+
+	int l = Graph_AddLabel(g);
+	int r = Graph_AddRelationType(g);
+
+	// create nodes, labeling them in a single pass
+	NodeID ids[node_count];
+	for(int i = 0; i < node_count; i++) {
+		Graph_CreateNodeEntity(g, l, &n);
+		ids[i] = ENTITY_GET_ID(&n);
+	}
+	Graph_LabelNodes(g, l, ids, node_count);
+
+	// (0)-[r]->(1) exists prior to the bulk connection
+	Graph_ConnectNodes(g, 0, 1, r, &e);
+	Graph_ApplyAllPending(g);
+
+	/* Connect in bulk:
+	 * (0)-[r]->(1) X 2, joins the existing edge
+	 * (1)-[r]->(2) X 2
+	 * (2)-[r]->(3) */
+	NodeID src[5]   =  {1, 0, 2, 1, 0};
+	NodeID dest[5]  =  {2, 1, 3, 2, 1};
+	EdgeTriplet edges[5];
+	for(int i = 0; i < 5; i++) {
+		Graph_CreateEdgeEntity(g, src[i], dest[i], r, &e);
+		edges[i] = {.src = src[i], .dest = dest[i], .id = ENTITY_GET_ID(&e)};
+	}
+	Graph_ConnectEdges(g, r, edges, 5);
+	Graph_ApplyAllPending(g);
+
+	GrB_Index nvals;
+	GrB_Matrix_nvals(&nvals, Graph_GetLabelMatrix(g, l));
+	ASSERT_EQ(nvals, node_count);
+	GrB_Matrix_nvals(&nvals, Graph_GetRelationMatrix(g, r));
+	ASSERT_EQ(nvals, 3);
+	GrB_Matrix_nvals(&nvals, Graph_GetTransposedRelationMatrix(g, r));
+	ASSERT_EQ(nvals, 3);
+	GrB_Matrix_nvals(&nvals, Graph_GetAdjacencyMatrix(g));
+	ASSERT_EQ(nvals, 3);
+	ASSERT_EQ(Graph_RelationEdgeCount(g, r), 6);
+
+	NodeID pairs[3][2] = {{0, 1}, {1, 2}, {2, 3}};
+	uint expected[3] = {3, 2, 1};
+	Edge *connecting = (Edge *)array_new(Edge, 3);
+	for(int i = 0; i < 3; i++) {
+		Graph_GetEdgesConnectingNodes(g, pairs[i][0], pairs[i][1], r, &connecting);
+		ASSERT_EQ(array_len(connecting), expected[i]);
+		for(uint j = 0; j < expected[i]; j++) {
+			ASSERT_EQ(Edge_GetSrcNodeID(connecting + j), pairs[i][0]);
+			ASSERT_EQ(Edge_GetDestNodeID(connecting + j), pairs[i][1]);
+		}
+		array_clear(connecting);
+	}
+
+	array_free(connecting);
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
@@ -0,0 +1,172 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/grouping/group_table.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class GroupTableTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+// create a group keyed by a single integer, holding a single flat state
+static Group *_NewGroup(int64_t key) {
+	SIValue *keys = (SIValue *)rm_malloc(sizeof(SIValue));
+	keys[0] = SI_LongVal(key);
+	return NewGroup(keys, 1, NULL, 1, NULL);
+}
+
+static void _MergeCounts(Group *dest, Group *src, void *ctx) {
+	AggregateState_Merge(dest->states, src->states, AGG_STATE_COUNT);
+}
+
+TEST_F(GroupTableTest, CollidingHashes) {
+	GroupTable *table = GroupTable_New();
+
+	// distinct keys sharing a hash are told apart
+	XXH64_hash_t hash = 42;
+	Group *a = _NewGroup(1);
+	Group *b = _NewGroup(2);
+	GroupTable_Add(table, hash, a);
+	GroupTable_Add(table, hash, b);
+
+	SIValue key = SI_LongVal(1);
+	ASSERT_EQ(GroupTable_Get(table, hash, &key), a);
+	key = SI_LongVal(2);
+	ASSERT_EQ(GroupTable_Get(table, hash, &key), b);
+	key = SI_LongVal(3);
+	ASSERT_TRUE(GroupTable_Get(table, hash, &key) == NULL);
+
+	// numeric keys of different types compare equal
+	key = SI_DoubleVal(2);
+	ASSERT_EQ(GroupTable_Get(table, hash, &key), b);
+
+	ASSERT_EQ(GroupTable_Count(table), 2);
+	GroupTable_Free(table);
+}
+
+TEST_F(GroupTableTest, GrowAndIterate) {
+	GroupTable *table = GroupTable_New();
+	uint64_t n = GROUP_TABLE_PARTITION_CAP * GROUP_TABLE_PARTITION_COUNT * 8;
+
+	// spread hashes across all partitions
+	for(uint64_t i = 0; i < n; i++) {
+		XXH64_hash_t hash = (i << (64 - GROUP_TABLE_PARTITION_BITS)) | i;
+		GroupTable_Add(table, hash, _NewGroup(i));
+	}
+	ASSERT_EQ(GroupTable_Count(table), n);
+
+	for(uint64_t i = 0; i < n; i++) {
+		XXH64_hash_t hash = (i << (64 - GROUP_TABLE_PARTITION_BITS)) | i;
+		SIValue key = SI_LongVal(i);
+		Group *g = GroupTable_Get(table, hash, &key);
+		ASSERT_TRUE(g != NULL);
+		ASSERT_EQ(g->keys[0].longval, i);
+	}
+
+	// every group is visited once
+	uint64_t visited = 0;
+	uint64_t key_sum = 0;
+	GroupTableIterator iter;
+	GroupTable_Iter(table, &iter);
+	Group *g;
+	while((g = GroupTableIterator_Next(&iter))) {
+		visited++;
+		key_sum += g->keys[0].longval;
+	}
+	ASSERT_EQ(visited, n);
+	ASSERT_EQ(key_sum, n * (n - 1) / 2);
+
+	GroupTable_Free(table);
+}
+
+TEST_F(GroupTableTest, MergePartitions) {
+	GroupTable *a = GroupTable_New();
+	GroupTable *b = GroupTable_New();
+
+	// keys [0, 10) in a, keys [5, 15) in b, each group counted once
+	for(int64_t i = 0; i < 15; i++) {
+		XXH64_hash_t hash = (XXH64_hash_t)i << (64 - GROUP_TABLE_PARTITION_BITS);
+		if(i < 10) {
+			Group *g = _NewGroup(i);
+			AggregateState_Update(g->states, AGG_STATE_COUNT, SI_LongVal(i));
+			GroupTable_Add(a, hash, g);
+		}
+		if(i >= 5) {
+			Group *g = _NewGroup(i);
+			AggregateState_Update(g->states, AGG_STATE_COUNT, SI_LongVal(i));
+			GroupTable_Add(b, hash, g);
+		}
+	}
+
+	for(uint p = 0; p < GROUP_TABLE_PARTITION_COUNT; p++) {
+		GroupTable_MergePartition(a, b, p, _MergeCounts, NULL);
+	}
+	ASSERT_EQ(GroupTable_Count(a), 15);
+	ASSERT_EQ(GroupTable_Count(b), 0);
+
+	for(int64_t i = 0; i < 15; i++) {
+		XXH64_hash_t hash = (XXH64_hash_t)i << (64 - GROUP_TABLE_PARTITION_BITS);
+		SIValue key = SI_LongVal(i);
+		Group *g = GroupTable_Get(a, hash, &key);
+		ASSERT_TRUE(g != NULL);
+		int64_t expected = (i >= 5 && i < 10) ? 2 : 1;
+		ASSERT_EQ(AggregateState_Finalize(g->states, AGG_STATE_COUNT).longval, expected);
+	}
+
+	GroupTable_Free(a);
+	GroupTable_Free(b);
+}
+
+TEST_F(GroupTableTest, FlatStates) {
+	AggregateState a;
+	AggregateState b;
+	AggregateState_Init(&a);
+	AggregateState_Init(&b);
+
+	// nulls are skipped
+	AggregateState_Update(&a, AGG_STATE_AVG, SI_LongVal(1));
+	AggregateState_Update(&a, AGG_STATE_AVG, SI_NullVal());
+	AggregateState_Update(&b, AGG_STATE_AVG, SI_DoubleVal(4));
+	AggregateState_Update(&b, AGG_STATE_AVG, SI_LongVal(4));
+	AggregateState_Merge(&a, &b, AGG_STATE_AVG);
+	ASSERT_EQ(AggregateState_Finalize(&a, AGG_STATE_AVG).doubleval, 3);
+
+	// avg of no values is 0
+	ASSERT_EQ(AggregateState_Finalize(&b, AGG_STATE_AVG).doubleval, 0);
+
+	// extremum retains a copy of the value
+	AggregateState_Init(&a);
+	AggregateState_Init(&b);
+	AggregateState_Update(&a, AGG_STATE_MAX, SI_ConstStringVal((char *)"b"));
+	AggregateState_Update(&b, AGG_STATE_MAX, SI_ConstStringVal((char *)"c"));
+	AggregateState_Update(&b, AGG_STATE_MAX, SI_ConstStringVal((char *)"a"));
+	AggregateState_Merge(&a, &b, AGG_STATE_MAX);
+	SIValue max = AggregateState_Finalize(&a, AGG_STATE_MAX);
+	ASSERT_STREQ(max.stringval, "c");
+	SIValue_Free(max);
+
+	// min of no values is null
+	ASSERT_EQ(SI_TYPE(AggregateState_Finalize(&b, AGG_STATE_MIN)), T_NULL);
+
+	AggregateState_Free(&a);
+	AggregateState_Free(&b);
+}
+
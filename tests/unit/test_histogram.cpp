@@ -0,0 +1,99 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/histogram.h"
+#ifdef __cplusplus
+}
+#endif
+
+class HistogramTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(HistogramTest, Empty) {
+	Histogram h;
+	Histogram_Init(&h);
+
+	ASSERT_EQ(Histogram_Count(&h), 0);
+	ASSERT_EQ(Histogram_Mean(&h), 0);
+	ASSERT_EQ(Histogram_Max(&h), 0);
+	ASSERT_EQ(Histogram_Percentile(&h, 50), 0);
+}
+
+TEST_F(HistogramTest, SmallValuesAreExact) {
+	Histogram h;
+	Histogram_Init(&h);
+
+	// values below the number of sub buckets are recorded exactly
+	for(uint64_t v = 1; v <= 4; v++) Histogram_Record(&h, v);
+
+	ASSERT_EQ(Histogram_Count(&h), 4);
+	ASSERT_EQ(Histogram_Mean(&h), 2.5);
+	ASSERT_EQ(Histogram_Max(&h), 4);
+	ASSERT_EQ(Histogram_Percentile(&h, 25), 1);
+	ASSERT_EQ(Histogram_Percentile(&h, 50), 2);
+	ASSERT_EQ(Histogram_Percentile(&h, 75), 3);
+	ASSERT_EQ(Histogram_Percentile(&h, 100), 4);
+}
+
+TEST_F(HistogramTest, RelativeError) {
+	Histogram h;
+
+	// a single recorded value is reported within the histogram's precision
+	uint64_t values[] = {9, 100, 1000, 12345, 1000000, 987654321};
+	for(uint i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+		Histogram_Init(&h);
+		Histogram_Record(&h, values[i]);
+		Histogram_Record(&h, values[i] * 4);
+
+		uint64_t p50 = Histogram_Percentile(&h, 50);
+		ASSERT_GE(p50, values[i]);
+		ASSERT_LE(p50 - values[i], values[i] >> HISTOGRAM_PRECISION_BITS);
+
+		// the highest percentile never exceeds the recorded maximum
+		ASSERT_EQ(Histogram_Percentile(&h, 100), values[i] * 4);
+	}
+}
+
+TEST_F(HistogramTest, Percentiles) {
+	Histogram h;
+	Histogram_Init(&h);
+
+	// 1..1000
+	for(uint64_t v = 1; v <= 1000; v++) Histogram_Record(&h, v);
+
+	ASSERT_EQ(Histogram_Count(&h), 1000);
+	ASSERT_EQ(Histogram_Max(&h), 1000);
+
+	double percentiles[] = {10, 50, 90, 99};
+	for(uint i = 0; i < 4; i++) {
+		uint64_t expected = percentiles[i] * 10;
+		uint64_t p = Histogram_Percentile(&h, percentiles[i]);
+		ASSERT_GE(p, expected);
+		ASSERT_LE(p - expected, expected >> HISTOGRAM_PRECISION_BITS);
+	}
+}
+
+TEST_F(HistogramTest, LargeValuesAreCapped) {
+	Histogram h;
+	Histogram_Init(&h);
+
+	Histogram_Record(&h, UINT64_MAX);
+	ASSERT_EQ(Histogram_Count(&h), 1);
+	ASSERT_EQ(Histogram_Max(&h), UINT64_MAX);
+	ASSERT_GE(Histogram_Percentile(&h, 50),
+			(1ULL << (HISTOGRAM_MAX_BITS - 1)));
+}
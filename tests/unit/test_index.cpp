@@ -15,12 +15,19 @@ extern "C" {
 #include "../../src/graph/graph.h"
 #include "../../src/index/index.h"
 #include "../../src/util/rmalloc.h"
+#include "../../src/util/thpool/pools.h"
 #include "../../src/graph/graphcontext.h"
+#include <math.h>
 
 #ifdef __cplusplus
 }
 #endif
 
+#define BULK_COUNT   1
+#define READER_COUNT 1
+#define WRITER_COUNT 1
+#define TASK_COUNT   3
+
 class IndexTest: public ::testing::Test {
   protected:
 	static void SetUpTestCase() {
@@ -30,6 +37,10 @@ class IndexTest: public ::testing::Test {
 		GxB_Global_Option_set(GxB_FORMAT, GxB_BY_ROW); // all matrices in CSR format
 		GxB_Global_Option_set(GxB_HYPER_SWITCH, GxB_NEVER_HYPER); // matrices are never hypersparse
 
+		// index construction is split across the task pool
+		ThreadPools_CreatePools(READER_COUNT, WRITER_COUNT, BULK_COUNT, UINT64_MAX);
+		ThreadPools_CreateTaskPool(TASK_COUNT);
+
 		_fake_graph_context();
 	}
 
@@ -73,7 +84,7 @@ class IndexTest: public ::testing::Test {
 TEST_F(IndexTest, Index_New) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	const char *l = "Person";
-	Index *idx = Index_New(l, IDX_EXACT_MATCH);
+	Index *idx = Index_New(l, IDX_EXACT_MATCH, GETYPE_NODE);
 
 	// Return indexed label.
 	const char *label = Index_GetLabel(idx);
@@ -117,3 +128,295 @@ TEST_F(IndexTest, Index_New) {
 	Index_Free(idx);
 }
 
+
+// count number of nodes matching query
+static uint _ScanCount(Index *idx, IndexQuery *q) {
+	uint count = 0;
+	NodeID id;
+	IndexIter *it = Index_Scan(idx, q);
+
+	while(IndexIter_Next(it, &id)) count++;
+
+	// rewinding the iterator should produce the same matches
+	uint recount = 0;
+	IndexIter_Reset(it);
+	while(IndexIter_Next(it, &id)) recount++;
+	EXPECT_EQ(count, recount);
+
+	IndexIter_Free(it);
+	return count;
+}
+
+TEST_F(IndexTest, Index_Scan) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Graph *g = gc->g;
+	Attribute_ID age = GraphContext_FindOrAddAttribute(gc, "age");
+	Attribute_ID name = GraphContext_FindOrAddAttribute(gc, "name");
+
+	// create labeled nodes: (age: i, name: 'a' / 'b')
+	Graph_AcquireWriteLock(g);
+	for(int i = 0; i < 10; i++) {
+		Node n = GE_NEW_NODE();
+		Graph_CreateNode(g, 0, &n);
+		GraphEntity_AddProperty((GraphEntity *)&n, age, SI_LongVal(i));
+		GraphEntity_AddProperty((GraphEntity *)&n, name,
+				SI_ConstStringVal((char *)((i % 2) ? "b" : "a")));
+	}
+	Graph_ReleaseLock(g);
+
+	Index *idx = Index_New("Person", IDX_EXACT_MATCH, GETYPE_NODE);
+	Index_AddField(idx, "age");
+	Index_AddField(idx, "name");
+	Index_Construct(idx);
+
+	// age >= 3 AND age < 7
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(age, 3, true, 7, false)), 4);
+
+	// name = 'a'
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewStringRange(name, "a", true, "a", true)), 5);
+
+	// age < 4 AND name = 'b'
+	IndexQuery *q = IndexQuery_NewIntersection();
+	IndexQuery_AddChild(q, IndexQuery_NewNumericRange(age, -INFINITY, false,
+				4, false));
+	IndexQuery_AddChild(q, IndexQuery_NewStringRange(name, "b", true, "b",
+				true));
+	ASSERT_EQ(_ScanCount(idx, q), 2);
+
+	// age IN [0, 9] OR name = 'b'
+	q = IndexQuery_NewUnion();
+	IndexQuery_AddChild(q, IndexQuery_NewNumericRange(age, 0, true, 0, true));
+	IndexQuery_AddChild(q, IndexQuery_NewNumericRange(age, 9, true, 9, true));
+	IndexQuery_AddChild(q, IndexQuery_NewStringRange(name, "b", true, "b",
+				true));
+	ASSERT_EQ(_ScanCount(idx, q), 6);
+
+	// nothing is matched by an empty query
+	ASSERT_EQ(_ScanCount(idx, IndexQuery_NewEmpty()), 0);
+
+	// reindex an updated node, its previous value is dropped
+	Node n = GE_NEW_NODE();
+	Graph_GetNode(g, 0, &n);
+	GraphEntity_SetProperty((GraphEntity *)&n, age, SI_LongVal(100));
+	Index_IndexNode(idx, &n);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(age, 0, true, 0, true)), 0);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(age, 100, true, 100, true)), 1);
+
+	// remove node from index
+	Graph_GetNode(g, 1, &n);
+	Index_RemoveNode(idx, &n);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewStringRange(name, "b", true, "b", true)), 4);
+
+	// removing an indexed field drops its values
+	Index_RemoveField(idx, "name");
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewStringRange(name, "b", true, "b", true)), 0);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(age, 3, true, 7, false)), 4);
+
+	Index_Free(idx);
+}
+
+TEST_F(IndexTest, Index_ParallelConstruct) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Graph *g = gc->g;
+	Attribute_ID score = GraphContext_FindOrAddAttribute(gc, "score");
+	Attribute_ID tag = GraphContext_FindOrAddAttribute(gc, "tag");
+
+	// enough nodes for the label to be scanned by multiple threads
+	// create labeled nodes: (score: i % 1000, tag: 't<i % 10>')
+	// every third node is missing its tag
+	int n = 100000;
+	char tag_values[10][3];
+	Graph_AcquireWriteLock(g);
+	for(int i = 0; i < n; i++) {
+		Node node = GE_NEW_NODE();
+		Graph_CreateNode(g, 0, &node);
+		GraphEntity_AddProperty((GraphEntity *)&node, score,
+				SI_LongVal(i % 1000));
+		if(i % 3 == 0) continue;
+		sprintf(tag_values[i % 10], "t%d", i % 10);
+		GraphEntity_AddProperty((GraphEntity *)&node, tag,
+				SI_ConstStringVal(tag_values[i % 10]));
+	}
+	Graph_ReleaseLock(g);
+
+	Index *idx = Index_New("Person", IDX_EXACT_MATCH, GETYPE_NODE);
+	Index_AddField(idx, "score");
+	Index_AddField(idx, "tag");
+	Index_Construct(idx);
+
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(score, -INFINITY, false, INFINITY,
+					false)), n);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(score, 10, true, 19, true)), 1000);
+
+	// i % 10 == 1 and i % 3 != 0
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewStringRange(tag, "t1", true, "t1", true)), 6667);
+
+	// constructed index is maintained as usual
+	// first node created by this test holds score 0
+	Node node = GE_NEW_NODE();
+	Graph_GetNode(g, 10, &node);
+	GraphEntity_SetProperty((GraphEntity *)&node, score, SI_LongVal(10));
+	Index_IndexNode(idx, &node);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(score, 0, true, 0, true)), 99);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(score, 10, true, 19, true)), 1001);
+
+	Index_RemoveField(idx, "tag");
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewStringRange(tag, "t1", true, "t1", true)), 0);
+
+	// re-construction drops previously indexed values
+	Index_Construct(idx);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(score, 10, true, 19, true)), 1001);
+
+	Index_Free(idx);
+}
+
+TEST_F(IndexTest, Index_EdgeIndex) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Graph *g = gc->g;
+	Attribute_ID tx = GraphContext_FindOrAddAttribute(gc, "tx_id");
+	int relation = GraphContext_AddSchema(gc, "TRANSFER", SCHEMA_EDGE)->id;
+
+	// (a)-[tx_id: 0]->(b), (a)-[tx_id: 1]->(b), (b)-[tx_id: 2]->(c), (c)-[]->(a)
+	Node nodes[3];
+	Edge edges[4];
+	Graph_AcquireWriteLock(g);
+	for(int i = 0; i < 3; i++) {
+		nodes[i] = GE_NEW_NODE();
+		Graph_CreateNode(g, GRAPH_NO_LABEL, nodes + i);
+	}
+	NodeID a = ENTITY_GET_ID(nodes);
+	NodeID b = ENTITY_GET_ID(nodes + 1);
+	NodeID c = ENTITY_GET_ID(nodes + 2);
+
+	Graph_ConnectNodes(g, a, b, relation, edges);
+	Graph_ConnectNodes(g, a, b, relation, edges + 1);
+	Graph_ConnectNodes(g, b, c, relation, edges + 2);
+	Graph_ConnectNodes(g, c, a, relation, edges + 3);
+	for(int i = 0; i < 3; i++) {
+		GraphEntity_AddProperty((GraphEntity *)(edges + i), tx, SI_LongVal(i));
+	}
+	Graph_ReleaseLock(g);
+
+	Index *idx = Index_New("TRANSFER", IDX_EXACT_MATCH, GETYPE_EDGE);
+	Index_AddField(idx, "tx_id");
+	Index_Construct(idx);
+
+	// edges lacking an indexed property aren't indexed
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(tx, -INFINITY, false, INFINITY,
+					false)), 3);
+
+	// tx_id = 1, one of two edges connecting a to b
+	EdgeID id;
+	NodeID src;
+	NodeID dest;
+	IndexIter *it = Index_Scan(idx,
+			IndexQuery_NewNumericRange(tx, 1, true, 1, true));
+	ASSERT_TRUE(IndexIter_Next(it, &id));
+	ASSERT_EQ(id, ENTITY_GET_ID(edges + 1));
+	ASSERT_FALSE(IndexIter_Next(it, &id));
+	IndexIter_Free(it);
+
+	ASSERT_TRUE(Index_GetEdgeEndpoints(idx, id, &src, &dest));
+	ASSERT_EQ(src, a);
+	ASSERT_EQ(dest, b);
+	ASSERT_FALSE(Index_GetEdgeEndpoints(idx, ENTITY_GET_ID(edges + 3), &src,
+				&dest));
+
+	// reindex an updated edge, its previous value is dropped
+	GraphEntity_SetProperty((GraphEntity *)(edges + 2), tx, SI_LongVal(10));
+	Index_IndexEdge(idx, edges + 2);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(tx, 2, true, 2, true)), 0);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(tx, 10, true, 10, true)), 1);
+	ASSERT_TRUE(Index_GetEdgeEndpoints(idx, ENTITY_GET_ID(edges + 2), &src,
+				&dest));
+	ASSERT_EQ(src, b);
+	ASSERT_EQ(dest, c);
+
+	// remove edge from index
+	Index_RemoveEdge(idx, edges);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(tx, 0, true, 0, true)), 0);
+	ASSERT_FALSE(Index_GetEdgeEndpoints(idx, ENTITY_GET_ID(edges), &src,
+				&dest));
+
+	Index_Free(idx);
+}
+
+TEST_F(IndexTest, Index_BooleanValues) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Graph *g = gc->g;
+	Attribute_ID v = GraphContext_FindOrAddAttribute(gc, "v");
+
+	// create labeled nodes: (v: 1), (v: true), (v: 0), (v: false), (v: 1.0)
+	SIValue values[5] = {SI_LongVal(1), SI_BoolVal(true), SI_LongVal(0),
+		SI_BoolVal(false), SI_DoubleVal(1.0)};
+	NodeID ids[5];
+	Graph_AcquireWriteLock(g);
+	for(int i = 0; i < 5; i++) {
+		Node n = GE_NEW_NODE();
+		Graph_CreateNode(g, 0, &n);
+		GraphEntity_AddProperty((GraphEntity *)&n, v, values[i]);
+		ids[i] = ENTITY_GET_ID(&n);
+	}
+	Graph_ReleaseLock(g);
+
+	Index *idx = Index_New("Person", IDX_EXACT_MATCH, GETYPE_NODE);
+	Index_AddField(idx, "v");
+	Index_Construct(idx);
+
+	// booleans are kept apart from numbers
+	IndexedValue iv;
+	IndexedValue_Init(&iv, values + 1);
+	ASSERT_EQ(iv.type, IV_BOOLEAN);
+	IndexedValue_Free(&iv);
+
+	// v = 1 doesn't match true
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(v, 1, true, 1, true)), 2);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(v, 0, true, 1, true)), 3);
+
+	// v = true doesn't match 1
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewBooleanRange(v, 1, true, 1, true)), 1);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewBooleanRange(v, 0, true, 0, true)), 1);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewBooleanRange(v, -INFINITY, false, INFINITY,
+					false)), 2);
+
+	// v = 1 AND v = true matches nothing
+	IndexQuery *q = IndexQuery_NewIntersection();
+	IndexQuery_AddChild(q, IndexQuery_NewNumericRange(v, 1, true, 1, true));
+	IndexQuery_AddChild(q, IndexQuery_NewBooleanRange(v, 1, true, 1, true));
+	ASSERT_EQ(_ScanCount(idx, q), 0);
+
+	// updating a node from 1 to true moves it between trees
+	Node n = GE_NEW_NODE();
+	Graph_GetNode(g, ids[0], &n);
+	GraphEntity_SetProperty((GraphEntity *)&n, v, SI_BoolVal(true));
+	Index_IndexNode(idx, &n);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewNumericRange(v, 1, true, 1, true)), 1);
+	ASSERT_EQ(_ScanCount(idx,
+				IndexQuery_NewBooleanRange(v, 1, true, 1, true)), 2);
+
+	Index_Free(idx);
+}
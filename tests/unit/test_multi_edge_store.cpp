@@ -0,0 +1,94 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/arr.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/multi_edge_store.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class MultiEdgeStoreTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(MultiEdgeStoreTest, AppendRemove) {
+	uint32_t len;
+	const EdgeID *ids;
+	MultiEdgeStore *store = MultiEdgeStore_New();
+
+	uint64_t a = MultiEdgeStore_NewList(store, 0, 1);
+	uint64_t b = MultiEdgeStore_NewList(store, 10, 11);
+	ASSERT_NE(a, b);
+
+	// grow list 'a', forcing it to relocate past list 'b'
+	for(EdgeID i = 2; i < 100; i++) MultiEdgeStore_Append(store, a, i);
+
+	ids = MultiEdgeStore_GetList(store, a, &len);
+	ASSERT_EQ(len, 100);
+	for(uint32_t i = 0; i < len; i++) ASSERT_EQ(ids[i], i);
+
+	// list 'b' is unaffected
+	ids = MultiEdgeStore_GetList(store, b, &len);
+	ASSERT_EQ(len, 2);
+	ASSERT_EQ(ids[0], 10);
+	ASSERT_EQ(ids[1], 11);
+
+	// remove first edge, last edge takes its place
+	ASSERT_EQ(MultiEdgeStore_Remove(store, a, 0), 99);
+	ids = MultiEdgeStore_GetList(store, a, &len);
+	ASSERT_EQ(ids[0], 99);
+
+	// freed list IDs are reused
+	MultiEdgeStore_FreeList(store, b);
+	ASSERT_EQ(MultiEdgeStore_NewList(store, 20, 21), b);
+
+	MultiEdgeStore_Free(store);
+}
+
+TEST_F(MultiEdgeStoreTest, Compaction) {
+	uint32_t len;
+	const EdgeID *ids;
+	uint64_t n = 4096;
+	MultiEdgeStore *store = MultiEdgeStore_New();
+	uint64_t *lists = array_new(uint64_t, n);
+
+	for(uint64_t i = 0; i < n; i++) {
+		array_append(lists, MultiEdgeStore_NewList(store, i, i + 1));
+	}
+
+	// free every other list, leaving holes behind
+	for(uint64_t i = 0; i < n; i += 2) MultiEdgeStore_FreeList(store, lists[i]);
+	ASSERT_LT(store->holes * 2, store->size);
+
+	// relocate remaining lists, store is compacted along the way
+	for(uint64_t i = 1; i < n; i += 2) MultiEdgeStore_Append(store, lists[i], 0);
+	ASSERT_LT(store->holes * 2, store->size);
+
+	// list content survives compaction
+	for(uint64_t i = 1; i < n; i += 2) {
+		ids = MultiEdgeStore_GetList(store, lists[i], &len);
+		ASSERT_EQ(len, 3);
+		ASSERT_EQ(ids[0], i);
+		ASSERT_EQ(ids[1], i + 1);
+		ASSERT_EQ(ids[2], 0);
+	}
+
+	array_free(lists);
+	MultiEdgeStore_Free(store);
+}
+
@@ -0,0 +1,291 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/rmalloc.h"
+#include "../../src/index/ordered_index.h"
+#include <math.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+class OrderedIndexTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+static IndexKey _NumericKey(double d) {
+	IndexKey k;
+	k.d = d;
+	return k;
+}
+
+static IndexKey _StringKey(const char *s) {
+	IndexKey k;
+	k.s = s;
+	return k;
+}
+
+// count entries within range, validating scan order
+static uint64_t _CountRange(OrderedIndex *idx, const IndexKey *min,
+		bool include_min, const IndexKey *max, bool include_max) {
+	IndexKey  key;
+	IndexKey  prev_key;
+	NodeID    id;
+	NodeID    prev_id  =  0;
+	uint64_t  count    =  0;
+	OrderedIndexIterator it;
+
+	OrderedIndex_Seek(idx, &it, min, include_min, max, include_max);
+	while(OrderedIndexIterator_Next(&it, &key, &id)) {
+		if(count > 0) {
+			int c = OrderedIndex_CompareKeys(idx->type, &prev_key, &key);
+			EXPECT_TRUE(c < 0 || (c == 0 && prev_id < id));
+		}
+		prev_key = key;
+		prev_id = id;
+		count++;
+	}
+
+	return count;
+}
+
+TEST_F(OrderedIndexTest, NumericRange) {
+	OrderedIndex *idx = OrderedIndex_New(OI_NUMERIC);
+	uint64_t n = 10000;
+
+	// insert in a scattered order, each value is shared by two nodes
+	for(uint64_t i = 0; i < n; i++) {
+		uint64_t v = (i * 7919) % n;
+		ASSERT_TRUE(OrderedIndex_Insert(idx, _NumericKey(v / 2), v));
+	}
+	ASSERT_EQ(OrderedIndex_Count(idx), n);
+
+	// duplicate entries are rejected
+	ASSERT_FALSE(OrderedIndex_Insert(idx, _NumericKey(0), 0));
+	ASSERT_EQ(OrderedIndex_Count(idx), n);
+
+	IndexKey min = _NumericKey(10);
+	IndexKey max = _NumericKey(20);
+
+	ASSERT_EQ(_CountRange(idx, NULL, false, NULL, false), n);
+	ASSERT_EQ(_CountRange(idx, &min, true, &min, true), 2);
+	ASSERT_EQ(_CountRange(idx, &min, true, &max, true), 22);
+	ASSERT_EQ(_CountRange(idx, &min, false, &max, true), 20);
+	ASSERT_EQ(_CountRange(idx, &min, false, &max, false), 18);
+	ASSERT_EQ(_CountRange(idx, NULL, false, &min, false), 20);
+	ASSERT_EQ(_CountRange(idx, &max, false, NULL, false), n - 42);
+
+	// delete every odd node
+	for(uint64_t i = 1; i < n; i += 2) {
+		ASSERT_TRUE(OrderedIndex_Delete(idx, _NumericKey(i / 2), i));
+	}
+	ASSERT_FALSE(OrderedIndex_Delete(idx, _NumericKey(0), 1));
+	ASSERT_EQ(OrderedIndex_Count(idx), n / 2);
+	ASSERT_EQ(_CountRange(idx, &min, true, &max, true), 11);
+
+	// empty index
+	for(uint64_t i = 0; i < n; i += 2) {
+		ASSERT_TRUE(OrderedIndex_Delete(idx, _NumericKey(i / 2), i));
+	}
+	ASSERT_EQ(OrderedIndex_Count(idx), 0);
+	ASSERT_EQ(_CountRange(idx, NULL, false, NULL, false), 0);
+
+	// index is reusable once emptied
+	ASSERT_TRUE(OrderedIndex_Insert(idx, _NumericKey(1), 1));
+	ASSERT_EQ(_CountRange(idx, NULL, false, NULL, false), 1);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, StringRange) {
+	OrderedIndex *idx = OrderedIndex_New(OI_STRING);
+	uint64_t n = 1000;
+	char **values = (char **)malloc(sizeof(char *) * n);
+
+	for(uint64_t i = 0; i < n; i++) {
+		values[i] = (char *)malloc(8);
+		sprintf(values[i], "v%03lu", i);
+		ASSERT_TRUE(OrderedIndex_Insert(idx, _StringKey(values[i]), i));
+	}
+
+	IndexKey min = _StringKey("v100");
+	IndexKey max = _StringKey("v199");
+	IndexKey prefix = _StringKey("v1");
+
+	ASSERT_EQ(_CountRange(idx, &min, true, &min, true), 1);
+	ASSERT_EQ(_CountRange(idx, &min, true, &max, true), 100);
+	ASSERT_EQ(_CountRange(idx, &min, false, &max, false), 98);
+	ASSERT_EQ(_CountRange(idx, &prefix, true, &max, true), 100);
+
+	// separators must survive removal of the entries they were copied from
+	for(uint64_t i = 0; i < n; i++) {
+		ASSERT_TRUE(OrderedIndex_Delete(idx, _StringKey(values[i]), i));
+		free(values[i]);
+		values[i] = NULL;
+		if(i == n / 2) {
+			ASSERT_EQ(_CountRange(idx, NULL, false, NULL, false), n / 2 - 1);
+		}
+	}
+	ASSERT_EQ(OrderedIndex_Count(idx), 0);
+
+	free(values);
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, PointRange) {
+	OrderedIndex *idx = OrderedIndex_New(OI_POINT);
+
+	for(int lat = -90; lat <= 90; lat++) {
+		IndexKey k;
+		k.p.lat = lat;
+		k.p.lon = -lat;
+		ASSERT_TRUE(OrderedIndex_Insert(idx, k, lat + 90));
+	}
+
+	// points are ordered by latitude, scan a latitude band
+	IndexKey min;
+	IndexKey max;
+	min.p.lat = 10;
+	min.p.lon = -INFINITY;
+	max.p.lat = 20;
+	max.p.lon = INFINITY;
+	ASSERT_EQ(_CountRange(idx, &min, true, &max, true), 11);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, BulkLoad) {
+	uint64_t n = 10000;
+	OrderedIndexEntry *entries =
+		(OrderedIndexEntry *)malloc(sizeof(OrderedIndexEntry) * n);
+
+	// each value is shared by two nodes, entries are sorted
+	for(uint64_t i = 0; i < n; i++) {
+		entries[i].key = _NumericKey(i / 2);
+		entries[i].id = i;
+	}
+
+	// load an empty index and indices of every size up to a few leaves
+	OrderedIndex *idx = OrderedIndex_Load(OI_NUMERIC, entries, 0);
+	ASSERT_EQ(_CountRange(idx, NULL, false, NULL, false), 0);
+	OrderedIndex_Free(idx);
+
+	for(uint64_t i = 1; i < 200; i++) {
+		idx = OrderedIndex_Load(OI_NUMERIC, entries, i);
+		ASSERT_EQ(OrderedIndex_Count(idx), i);
+		ASSERT_EQ(_CountRange(idx, NULL, false, NULL, false), i);
+		OrderedIndex_Free(idx);
+	}
+
+	idx = OrderedIndex_Load(OI_NUMERIC, entries, n);
+	ASSERT_EQ(OrderedIndex_Count(idx), n);
+
+	IndexKey min = _NumericKey(10);
+	IndexKey max = _NumericKey(20);
+	ASSERT_EQ(_CountRange(idx, NULL, false, NULL, false), n);
+	ASSERT_EQ(_CountRange(idx, &min, true, &min, true), 2);
+	ASSERT_EQ(_CountRange(idx, &min, true, &max, true), 22);
+	ASSERT_EQ(_CountRange(idx, &min, false, &max, false), 18);
+
+	// loaded index supports further updates
+	ASSERT_FALSE(OrderedIndex_Insert(idx, _NumericKey(0), 0));
+	for(uint64_t i = 0; i < n; i++) {
+		ASSERT_TRUE(OrderedIndex_Insert(idx, _NumericKey(i / 2), n + i));
+	}
+	ASSERT_EQ(_CountRange(idx, &min, true, &max, true), 44);
+
+	for(uint64_t i = 0; i < 2 * n; i++) {
+		ASSERT_TRUE(OrderedIndex_Delete(idx, _NumericKey((i % n) / 2), i));
+	}
+	ASSERT_EQ(OrderedIndex_Count(idx), 0);
+	ASSERT_EQ(_CountRange(idx, NULL, false, NULL, false), 0);
+
+	OrderedIndex_Free(idx);
+	free(entries);
+
+	// string separators are owned by the loaded index
+	n = 1000;
+	char **values = (char **)malloc(sizeof(char *) * n);
+	entries = (OrderedIndexEntry *)malloc(sizeof(OrderedIndexEntry) * n);
+	for(uint64_t i = 0; i < n; i++) {
+		values[i] = (char *)malloc(8);
+		sprintf(values[i], "v%03lu", i);
+		entries[i].key = _StringKey(values[i]);
+		entries[i].id = i;
+	}
+
+	idx = OrderedIndex_Load(OI_STRING, entries, n);
+	free(entries);
+
+	IndexKey smin = _StringKey("v100");
+	IndexKey smax = _StringKey("v199");
+	ASSERT_EQ(_CountRange(idx, &smin, true, &smax, true), 100);
+
+	for(uint64_t i = 0; i < n; i++) {
+		ASSERT_TRUE(OrderedIndex_Delete(idx, _StringKey(values[i]), i));
+		free(values[i]);
+	}
+	ASSERT_EQ(OrderedIndex_Count(idx), 0);
+
+	free(values);
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, DistinctCount) {
+	uint64_t n = 1000;
+	OrderedIndex *idx = OrderedIndex_New(OI_NUMERIC);
+	ASSERT_EQ(OrderedIndex_DistinctCount(idx), 0);
+
+	// each value is shared by four nodes
+	for(uint64_t i = 0; i < n; i++) {
+		ASSERT_TRUE(OrderedIndex_Insert(idx, _NumericKey(i % 250), i));
+	}
+	ASSERT_EQ(OrderedIndex_DistinctCount(idx), 250);
+
+	// re-inserting an entry doesn't change the count
+	ASSERT_FALSE(OrderedIndex_Insert(idx, _NumericKey(0), 0));
+	ASSERT_EQ(OrderedIndex_DistinctCount(idx), 250);
+
+	// a value is counted until its last entry is deleted
+	for(uint64_t i = 0; i < 3; i++) {
+		ASSERT_TRUE(OrderedIndex_Delete(idx, _NumericKey(0), i * 250));
+		ASSERT_EQ(OrderedIndex_DistinctCount(idx), 250);
+	}
+	ASSERT_TRUE(OrderedIndex_Delete(idx, _NumericKey(0), 750));
+	ASSERT_EQ(OrderedIndex_DistinctCount(idx), 249);
+
+	// missing entries don't change the count
+	ASSERT_FALSE(OrderedIndex_Delete(idx, _NumericKey(0), 0));
+	ASSERT_FALSE(OrderedIndex_Delete(idx, _NumericKey(1), 2));
+	ASSERT_EQ(OrderedIndex_DistinctCount(idx), 249);
+	OrderedIndex_Free(idx);
+
+	// bulk loaded index counts transitions between sorted keys
+	OrderedIndexEntry *entries =
+		(OrderedIndexEntry *)malloc(sizeof(OrderedIndexEntry) * n);
+	for(uint64_t i = 0; i < n; i++) {
+		entries[i].key = _NumericKey(i / 4);
+		entries[i].id = i;
+	}
+
+	idx = OrderedIndex_Load(OI_NUMERIC, entries, n);
+	ASSERT_EQ(OrderedIndex_DistinctCount(idx), 250);
+	ASSERT_TRUE(OrderedIndex_Insert(idx, _NumericKey(n), n));
+	ASSERT_EQ(OrderedIndex_DistinctCount(idx), 251);
+
+	OrderedIndex_Free(idx);
+	free(entries);
+}
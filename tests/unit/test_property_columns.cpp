@@ -0,0 +1,92 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/entities/property_columns.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class PropertyColumnsTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(PropertyColumnsTest, SetGetRemove) {
+	PropertyColumns *pc = PropertyColumns_New();
+
+	// rows spanning multiple blocks
+	EntityID rows[3] = {0, 7, PROPERTY_COLUMN_BLOCK_CAP * 3 + 1};
+
+	for(int i = 0; i < 3; i++) {
+		PropertyColumns_Set(pc, 0, rows[i], SI_LongVal(rows[i]));
+		PropertyColumns_Set(pc, 2, rows[i], SI_DuplicateStringVal("value"));
+	}
+
+	for(int i = 0; i < 3; i++) {
+		SIValue *v = PropertyColumns_Get(pc, 0, rows[i]);
+		ASSERT_TRUE(v != NULL);
+		ASSERT_EQ(v->longval, rows[i]);
+		ASSERT_STREQ(PropertyColumns_Get(pc, 2, rows[i])->stringval, "value");
+		ASSERT_EQ(PropertyColumns_RowPropertyCount(pc, rows[i]), 2);
+	}
+
+	// missing attribute, missing row and unallocated block
+	ASSERT_TRUE(PropertyColumns_Get(pc, 1, 0) == NULL);
+	ASSERT_TRUE(PropertyColumns_Get(pc, 5, 0) == NULL);
+	ASSERT_TRUE(PropertyColumns_Get(pc, 0, 1) == NULL);
+	ASSERT_TRUE(PropertyColumns_Get(pc, 0, PROPERTY_COLUMN_BLOCK_CAP) == NULL);
+
+	// overriding a value keeps cell address
+	SIValue *cell = PropertyColumns_Get(pc, 2, 7);
+	PropertyColumns_Set(pc, 2, 7, SI_DuplicateStringVal("updated"));
+	ASSERT_EQ(PropertyColumns_Get(pc, 2, 7), cell);
+	ASSERT_STREQ(cell->stringval, "updated");
+
+	ASSERT_TRUE(PropertyColumns_Remove(pc, 0, 7));
+	ASSERT_FALSE(PropertyColumns_Remove(pc, 0, 7));
+	ASSERT_TRUE(PropertyColumns_Get(pc, 0, 7) == NULL);
+	ASSERT_EQ(PropertyColumns_RowPropertyCount(pc, 7), 1);
+
+	ASSERT_EQ(PropertyColumns_ClearRow(pc, 0), 2);
+	ASSERT_EQ(PropertyColumns_RowPropertyCount(pc, 0), 0);
+
+	PropertyColumns_Free(pc);
+}
+
+TEST_F(PropertyColumnsTest, NextProperty) {
+	uint cursor = 0;
+	SIValue *v;
+	Attribute_ID attr_id;
+	PropertyColumns *pc = PropertyColumns_New();
+
+	PropertyColumns_Set(pc, 3, 1, SI_LongVal(3));
+	PropertyColumns_Set(pc, 1, 1, SI_LongVal(1));
+	PropertyColumns_Set(pc, 2, 0, SI_LongVal(2));
+
+	// attributes are visited in attribute ID order
+	ASSERT_TRUE(PropertyColumns_NextProperty(pc, 1, &cursor, &attr_id, &v));
+	ASSERT_EQ(attr_id, 1);
+	ASSERT_EQ(v->longval, 1);
+	ASSERT_TRUE(PropertyColumns_NextProperty(pc, 1, &cursor, &attr_id, &v));
+	ASSERT_EQ(attr_id, 3);
+	ASSERT_EQ(v->longval, 3);
+	ASSERT_FALSE(PropertyColumns_NextProperty(pc, 1, &cursor, &attr_id, &v));
+
+	PropertyColumns_Free(pc);
+}
+
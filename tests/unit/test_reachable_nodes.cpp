@@ -0,0 +1,104 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/algorithms/reachable_nodes.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class ReachableNodesTest: public ::testing::Test {
+  protected:
+	void SetUp() override {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+
+		GrB_init(GrB_NONBLOCKING);
+		GxB_Global_Option_set(GxB_FORMAT, GxB_BY_ROW); // all matrices in CSR format
+	}
+
+	void TearDown() override {
+		GrB_finalize();
+	}
+
+	// (0)->(1)->(2)->(0)
+	// (2)->(3)
+	// (4)->(4)
+	GrB_Matrix BuildMatrix(bool transpose) {
+		GrB_Matrix A;
+		GrB_Index n = 5;
+		GrB_Index I[5] = {0, 1, 2, 2, 4};
+		GrB_Index J[5] = {1, 2, 0, 3, 4};
+		bool X[5] = {true, true, true, true, true};
+
+		GrB_Matrix_new(&A, GrB_BOOL, n, n);
+		if(transpose) GrB_Matrix_build_BOOL(A, J, I, X, 5, GrB_FIRST_BOOL);
+		else GrB_Matrix_build_BOOL(A, I, J, X, 5, GrB_FIRST_BOOL);
+		GrB_Matrix_wait(&A);
+
+		return A;
+	}
+
+	// collect reachable nodes into a bitmap of node IDs
+	uint Collect(ReachableNodesCtx *ctx) {
+		uint reached = 0;
+		EntityID id;
+		while((id = ReachableNodesCtx_NextNode(ctx)) != INVALID_ENTITY_ID) {
+			// each node is produced once
+			EXPECT_FALSE(reached & (1 << id));
+			reached |= (1 << id);
+		}
+		return reached;
+	}
+};
+
+TEST_F(ReachableNodesTest, ReachableWithinHops) {
+	GrB_Matrix A = BuildMatrix(false);
+	GrB_Matrix AT = BuildMatrix(true);
+
+	// push only and push-pull traversals agree
+	GrB_Matrix transposes[2] = {GrB_NULL, AT};
+
+	for(int i = 0; i < 2; i++) {
+		// [*0..1] from 0
+		ReachableNodesCtx *ctx = ReachableNodesCtx_New(0, A, transposes[i], 0, 1);
+		ASSERT_EQ(Collect(ctx), (uint)((1 << 0) | (1 << 1)));
+
+		// [*1..1] from 0
+		ReachableNodesCtx_Reset(ctx, 0, A, transposes[i], 1, 1);
+		ASSERT_EQ(Collect(ctx), (uint)(1 << 1));
+
+		// [*1..2] from 0, cycle of length 3 isn't closed
+		ReachableNodesCtx_Reset(ctx, 0, A, transposes[i], 1, 2);
+		ASSERT_EQ(Collect(ctx), (uint)((1 << 1) | (1 << 2)));
+
+		// [*1..3] from 0, cycle of length 3 is closed
+		ReachableNodesCtx_Reset(ctx, 0, A, transposes[i], 1, 3);
+		ASSERT_EQ(Collect(ctx), (uint)((1 << 0) | (1 << 1) | (1 << 2) | (1 << 3)));
+
+		// [*] from 3, no outgoing edges
+		ReachableNodesCtx_Reset(ctx, 3, A, transposes[i], 1, UINT_MAX - 2);
+		ASSERT_EQ(Collect(ctx), (uint)0);
+
+		// [*1..1] from 4, self loop
+		ReachableNodesCtx_Reset(ctx, 4, A, transposes[i], 1, 1);
+		ASSERT_EQ(Collect(ctx), (uint)(1 << 4));
+
+		ReachableNodesCtx_Free(ctx);
+	}
+
+	GrB_Matrix_free(&A);
+	GrB_Matrix_free(&AT);
+}
+
@@ -0,0 +1,126 @@
+/*
+* Copyright 2018-2021 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/rg_matrix/rg_matrix.h"
+#ifdef __cplusplus
+}
+#endif
+
+class RGMatrixTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+		ASSERT_EQ(GrB_init(GrB_NONBLOCKING), GrB_SUCCESS);
+		GxB_Global_Option_set(GxB_FORMAT, GxB_BY_ROW); // all matrices in CSR format
+		GxB_Global_Option_set(GxB_HYPER_SWITCH, GxB_NEVER_HYPER); // matrices are never hypersparse
+	}
+
+	static void TearDownTestCase() {
+		GrB_finalize();
+	}
+};
+
+TEST_F(RGMatrixTest, RGMatrix_Deltas) {
+	bool       x;
+	GrB_Index  nvals;
+	RG_Matrix  C  =  RG_Matrix_New(GrB_BOOL, 10);
+	GrB_Matrix M  =  RG_Matrix_Get_GrB_Matrix(C);
+
+	// 1's along the diagonal
+	for(GrB_Index i = 0; i < 10; i++) {
+		ASSERT_EQ(RG_Matrix_setElement_BOOL(C, i, i), GrB_SUCCESS);
+	}
+
+	// additions are staged, main matrix is untouched
+	GrB_Matrix_nvals(&nvals, M);
+	ASSERT_EQ(nvals, 0);
+	ASSERT_TRUE(RG_Matrix_IsDirty(C));
+
+	// staged entries are visible
+	for(GrB_Index i = 0; i < 10; i++) {
+		ASSERT_EQ(RG_Matrix_extractElement_BOOL(&x, C, i, i), GrB_SUCCESS);
+	}
+
+	// fold deltas
+	RG_Matrix_Sync(C);
+	ASSERT_FALSE(RG_Matrix_IsDirty(C));
+	GrB_Matrix_nvals(&nvals, M);
+	ASSERT_EQ(nvals, 10);
+
+	// remove even entries, removals are marked in delta-minus
+	for(GrB_Index i = 0; i < 10; i += 2) {
+		ASSERT_EQ(RG_Matrix_removeElement(C, i, i), GrB_SUCCESS);
+	}
+
+	GrB_Matrix_nvals(&nvals, M);
+	ASSERT_EQ(nvals, 10);
+
+	for(GrB_Index i = 0; i < 10; i++) {
+		GrB_Info expected = (i % 2 == 0) ? GrB_NO_VALUE : GrB_SUCCESS;
+		ASSERT_EQ(RG_Matrix_extractElement_BOOL(&x, C, i, i), expected);
+	}
+
+	// removing a removed entry
+	ASSERT_EQ(RG_Matrix_removeElement(C, 0, 0), GrB_NO_VALUE);
+
+	// revive a removed entry
+	ASSERT_EQ(RG_Matrix_setElement_BOOL(C, 0, 0), GrB_SUCCESS);
+	ASSERT_EQ(RG_Matrix_extractElement_BOOL(&x, C, 0, 0), GrB_SUCCESS);
+
+	RG_Matrix_Sync(C);
+	GrB_Matrix_nvals(&nvals, M);
+	ASSERT_EQ(nvals, 6);
+
+	RG_Matrix_Free(C);
+}
+
+TEST_F(RGMatrixTest, RGMatrix_UINT64) {
+	uint64_t   x;
+	GrB_Index  nvals;
+	RG_Matrix  C  =  RG_Matrix_New(GrB_UINT64, 10);
+	GrB_Matrix M  =  RG_Matrix_Get_GrB_Matrix(C);
+
+	ASSERT_EQ(RG_Matrix_setElement_UINT64(C, 1, 0, 1), GrB_SUCCESS);
+	ASSERT_EQ(RG_Matrix_setElement_UINT64(C, 2, 1, 2), GrB_SUCCESS);
+	RG_Matrix_Sync(C);
+
+	// override existing entry, updated in place
+	ASSERT_EQ(RG_Matrix_setElement_UINT64(C, 3, 0, 1), GrB_SUCCESS);
+	ASSERT_EQ(RG_Matrix_extractElement_UINT64(&x, C, 0, 1), GrB_SUCCESS);
+	ASSERT_EQ(x, 3);
+
+	// accumulate into a staged entry
+	ASSERT_EQ(RG_Matrix_accumElement_UINT64(C, GrB_PLUS_UINT64, 4, 2, 3),
+			GrB_SUCCESS);
+	ASSERT_EQ(RG_Matrix_accumElement_UINT64(C, GrB_PLUS_UINT64, 5, 2, 3),
+			GrB_SUCCESS);
+	ASSERT_EQ(RG_Matrix_extractElement_UINT64(&x, C, 2, 3), GrB_SUCCESS);
+	ASSERT_EQ(x, 9);
+
+	// accumulate into an existing entry
+	ASSERT_EQ(RG_Matrix_accumElement_UINT64(C, GrB_PLUS_UINT64, 1, 1, 2),
+			GrB_SUCCESS);
+	ASSERT_EQ(RG_Matrix_extractElement_UINT64(&x, C, 1, 2), GrB_SUCCESS);
+	ASSERT_EQ(x, 3);
+
+	// remove staged entry
+	ASSERT_EQ(RG_Matrix_removeElement(C, 2, 3), GrB_SUCCESS);
+	ASSERT_EQ(RG_Matrix_extractElement_UINT64(&x, C, 2, 3), GrB_NO_VALUE);
+
+	RG_Matrix_Sync(C);
+	GrB_Matrix_nvals(&nvals, M);
+	ASSERT_EQ(nvals, 2);
+
+	RG_Matrix_Free(C);
+}
+
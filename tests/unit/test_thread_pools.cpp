@@ -11,6 +11,8 @@ extern "C" {
 #endif
 
 #include "assert.h"
+#include <unistd.h>
+#include <pthread.h>
 #include "../../src/util/rmalloc.h"
 #include "../../src/util/thpool/pools.h"
 #include "../../src/configuration/config.h"
@@ -22,6 +24,15 @@ extern "C" {
 #define BULK_COUNT   1
 #define READER_COUNT 4
 #define WRITER_COUNT 1
+#define TASK_COUNT   3
+
+// tracks the number of tasks running at the same time
+typedef struct {
+	pthread_mutex_t lock;
+	uint running;      // number of tasks currently running
+	uint max_running;  // max number of tasks running at the same time
+	uint completed;    // number of completed tasks
+} TaskConcurrency;
 
 class ThreadPoolsTest: public ::testing::Test {
 	protected:
@@ -29,6 +40,24 @@ class ThreadPoolsTest: public ::testing::Test {
 	static void SetUpTestCase() {
 		Alloc_Reset();
 		ThreadPools_CreatePools(READER_COUNT, WRITER_COUNT, BULK_COUNT, UINT64_MAX);
+		ThreadPools_CreateTaskPool(TASK_COUNT);
+	}
+
+	static void concurrent_task(void *ctx, uint i) {
+		TaskConcurrency *c = (TaskConcurrency *)ctx;
+
+		pthread_mutex_lock(&c->lock);
+		c->running++;
+		if(c->running > c->max_running) c->max_running = c->running;
+		pthread_mutex_unlock(&c->lock);
+
+		// keep the task busy long enough for other tasks to start
+		usleep(10000);
+
+		pthread_mutex_lock(&c->lock);
+		c->running--;
+		c->completed++;
+		pthread_mutex_unlock(&c->lock);
 	}
 
 	static void get_thread_friendly_id(void *arg) {
@@ -84,3 +113,24 @@ TEST_F(ThreadPoolsTest, ThreadPools_ThreadID) {
 	}
 }
 
+TEST_F(ThreadPoolsTest, ThreadPools_RunTasks) {
+	ASSERT_EQ(TASK_COUNT, ThreadPools_TaskCount());
+
+	TaskConcurrency c;
+	pthread_mutex_init(&c.lock, NULL);
+	c.running = 0;
+	c.max_running = 0;
+	c.completed = 0;
+
+	// tasks are spread across the task pool and the calling thread
+	uint task_count = (TASK_COUNT + 1) * 4;
+	ThreadPools_RunTasks(concurrent_task, &c, task_count);
+
+	// all tasks are done once RunTasks returns
+	ASSERT_EQ(task_count, c.completed);
+	ASSERT_EQ(0, c.running);
+	ASSERT_GT(c.max_running, 1);
+	ASSERT_LE(c.max_running, TASK_COUNT + 1);
+
+	pthread_mutex_destroy(&c.lock);
+}